@@ -1,4 +1,6 @@
 import 'dart:io';
+import 'dart:ui' show PlatformDispatcher;
+import 'package:flutter/foundation.dart';
 import 'package:flutter/material.dart';
 import 'package:flutter_riverpod/flutter_riverpod.dart';
 import 'package:flutter_dotenv/flutter_dotenv.dart';
@@ -8,23 +10,35 @@ import 'core/theme/app_theme.dart';
 import 'services/storage_service.dart';
 import 'services/timer_service.dart';
 import 'services/logger_service.dart';
+import 'services/channel_metrics_service.dart';
 import 'services/auth_service.dart';
 import 'services/app_info_service.dart';
+import 'services/bench_driver.dart';
+import 'services/floating_view_service.dart';
 import 'providers/auth_provider.dart';
+import 'providers/window_provider.dart';
 import 'screens/login_screen.dart';
 import 'screens/dashboard_screen.dart';
+import 'widgets/floating_widget.dart';
 
 void main(List<String> args) async {
   WidgetsFlutterBinding.ensureInitialized();
+  await LoggerService.attachNativeSink();
+  // Development builds always collect platform-channel timings.
+  if (kDebugMode) {
+    await ChannelMetricsService().setEnabled(true);
+  }
 
   final logger = LoggerService();
+  final bench = BenchDriver.fromArguments(args);
 
   // Main window startup
   try {
     logger.info('Starting Work Tracker application...');
 
     // Load environment variables
-    await dotenv.load(fileName: '.env');
+    await dotenv.load(
+        fileName: '.env', mergeWith: bench?.environment ?? const {});
     logger.info('Environment variables loaded');
 
     // Initialize app info service (for version checks)
@@ -78,8 +92,27 @@ void main(List<String> args) async {
     await timerService.initialize();
     logger.info('Timer service initialized');
 
+    // On Linux the floating widget gets the runner's second view
+    final floatingView = await FloatingViewService().attach();
+    final app = floatingView == null
+        ? const MainApp()
+        : ViewCollection(views: [
+            View(
+              view: PlatformDispatcher.instance.implicitView!,
+              child: const MainApp(),
+            ),
+            View(view: floatingView, child: const FloatingApp()),
+          ]);
+    final run = floatingView == null ? runApp : runWidget;
+
     // Run main app
-    runApp(const ProviderScope(child: MainApp()));
+    if (bench != null) {
+      final container = ProviderContainer();
+      run(UncontrolledProviderScope(container: container, child: app));
+      bench.run(container);
+    } else {
+      run(ProviderScope(child: app));
+    }
   } catch (e, stackTrace) {
     logger.error(
       'Failed to start application',
@@ -106,3 +139,22 @@ class MainApp extends ConsumerWidget {
     );
   }
 }
+
+/// The floating widget in its own window (see [FloatingViewService]). The
+/// view stays empty until floating mode, so it costs nothing while hidden.
+class FloatingApp extends ConsumerWidget {
+  const FloatingApp({super.key});
+
+  @override
+  Widget build(BuildContext context, WidgetRef ref) {
+    final isFloating = ref.watch(windowModeProvider);
+
+    return MaterialApp(
+      title: AppConstants.appName,
+      debugShowCheckedModeBanner: false,
+      theme: AppTheme.lightTheme,
+      color: Colors.transparent,
+      home: isFloating ? const FloatingWidget() : const SizedBox.shrink(),
+    );
+  }
+}
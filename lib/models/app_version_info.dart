@@ -1,5 +1,24 @@
 import '../services/app_info_service.dart';
 
+/// A binary delta release asset that turns the installed Linux bundle into
+/// the latest one (see linux/native/update/bundle_patch.h).
+///
+/// Assets are named `silver_stone-linux-<from>-to-<to>.sspatch`.
+class BundlePatchAsset {
+  final String url;
+  final int size;
+
+  /// Lowercase hex SHA-256 from the asset's `digest`, when GitHub reports
+  /// one. Required for staging: the checksum inside the patch only catches
+  /// corruption, not a patch from someone else.
+  final String? sha256;
+
+  const BundlePatchAsset({required this.url, required this.size, this.sha256});
+
+  static String assetName(String from, String to) =>
+      'silver_stone-linux-$from-to-$to.sspatch';
+}
+
 /// Model for app version information from GitHub releases
 class AppVersionInfo {
   final String latestVersion;
@@ -9,6 +28,9 @@ class AppVersionInfo {
   final String? releaseName;
   final DateTime? releaseDate;
 
+  /// Delta from the running version, when the release has one.
+  final BundlePatchAsset? linuxPatch;
+
   AppVersionInfo({
     required this.latestVersion,
     this.minimumVersion,
@@ -16,6 +38,7 @@ class AppVersionInfo {
     this.releaseNotes,
     this.releaseName,
     this.releaseDate,
+    this.linuxPatch,
   });
 
   /// Get current app version from AppInfoService
@@ -67,6 +90,8 @@ class AppVersionInfo {
 
     // Try to get download URL from assets, fallback to release page
     String downloadUrl = htmlUrl;
+    final latestVersion = tagName.replaceFirst(RegExp(r'^v'), '');
+    BundlePatchAsset? linuxPatch;
     final assets = json['assets'] as List<dynamic>?;
     if (assets != null && assets.isNotEmpty) {
       // Look for Windows executable
@@ -77,9 +102,30 @@ class AppVersionInfo {
           break;
         }
       }
-      // If no Windows-specific asset found, use first asset or release page
-      if (downloadUrl == htmlUrl && assets.isNotEmpty) {
-        downloadUrl = assets.first['browser_download_url'] as String? ?? htmlUrl;
+      // If no Windows-specific asset found, use first installer asset or
+      // release page
+      final installers = assets
+          .where((asset) => !(asset['name'] as String? ?? '').endsWith('.sspatch'))
+          .toList();
+      if (downloadUrl == htmlUrl && installers.isNotEmpty) {
+        downloadUrl = installers.first['browser_download_url'] as String? ?? htmlUrl;
+      }
+
+      final patchName = BundlePatchAsset.assetName(
+          _currentVersion.replaceFirst(RegExp(r'^v'), ''), latestVersion);
+      for (final asset in assets) {
+        if (asset['name'] != patchName) continue;
+        final url = asset['browser_download_url'] as String?;
+        if (url == null) break;
+        final digest = asset['digest'] as String?;
+        linuxPatch = BundlePatchAsset(
+          url: url,
+          size: asset['size'] as int? ?? 0,
+          sha256: digest != null && digest.startsWith('sha256:')
+              ? digest.substring(7).toLowerCase()
+              : null,
+        );
+        break;
       }
     }
 
@@ -103,12 +149,13 @@ class AppVersionInfo {
     }
 
     return AppVersionInfo(
-      latestVersion: tagName.replaceFirst(RegExp(r'^v'), ''),
+      latestVersion: latestVersion,
       minimumVersion: minimumVersion,
       downloadUrl: downloadUrl,
       releaseNotes: body.isNotEmpty ? _cleanReleaseNotes(body) : null,
       releaseName: name,
       releaseDate: publishedAt != null ? DateTime.tryParse(publishedAt) : null,
+      linuxPatch: linuxPatch,
     );
   }
 
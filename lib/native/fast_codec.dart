@@ -0,0 +1,165 @@
+import 'dart:convert';
+import 'dart:typed_data';
+import 'package:flutter/services.dart';
+
+/// Binary message format of the fast-path platform channels; the Dart half
+/// of linux/native/codec/fast_codec.h, which describes the layout.
+///
+/// Channel clients are generated from linux/native/codec/fast_messages.schema
+/// into fast_messages.g.dart. Compared with StandardMethodCodec there are no
+/// method name strings, type tags or map lookups: arguments are written in
+/// schema order and read back the same way.
+const int fastCallMagic = 0xFA;
+const int fastReplySuccess = 0;
+const int fastReplyError = 1;
+
+/// Encodes one call, or with the unnamed constructor any other message made
+/// of the same primitives.
+class FastWriter {
+  Uint8List _bytes = Uint8List(64);
+  late ByteData _data = ByteData.view(_bytes.buffer);
+  int _length = 0;
+
+  FastWriter();
+
+  FastWriter.forCall(int version, int callId) {
+    writeUint8(fastCallMagic);
+    writeUint8(version);
+    writeUint8(callId);
+  }
+
+  void writeUint8(int value) {
+    _reserve(1);
+    _bytes[_length++] = value;
+  }
+
+  void writeBool(bool value) => writeUint8(value ? 1 : 0);
+
+  void writeInt32(int value) {
+    _reserve(4);
+    _data.setInt32(_length, value, Endian.little);
+    _length += 4;
+  }
+
+  void writeInt64(int value) {
+    _reserve(8);
+    _data.setInt64(_length, value, Endian.little);
+    _length += 8;
+  }
+
+  void writeFloat64(double value) {
+    _reserve(8);
+    _data.setFloat64(_length, value, Endian.little);
+    _length += 8;
+  }
+
+  void writeString(String value) => writeBytes(utf8.encode(value));
+
+  void writeBytes(Uint8List value) {
+    _reserve(4 + value.length);
+    _data.setUint32(_length, value.length, Endian.little);
+    _length += 4;
+    _bytes.setRange(_length, _length + value.length, value);
+    _length += value.length;
+  }
+
+  /// The encoded call, as a view of the writer's buffer.
+  ByteData done() => ByteData.sublistView(_bytes, 0, _length);
+
+  /// Same as [done], as bytes.
+  Uint8List doneBytes() => Uint8List.sublistView(_bytes, 0, _length);
+
+  void _reserve(int size) {
+    if (_length + size <= _bytes.length) return;
+    var capacity = _bytes.length * 2;
+    while (capacity < _length + size) {
+      capacity *= 2;
+    }
+    _bytes = Uint8List(capacity)..setRange(0, _length, _bytes);
+    _data = ByteData.view(_bytes.buffer);
+  }
+}
+
+/// Decodes a reply in place. Malformed input throws [FormatException].
+class FastReader {
+  final ByteData _data;
+  int _position = 0;
+
+  FastReader(this._data);
+
+  int readUint8() {
+    _need(1);
+    return _data.getUint8(_position++);
+  }
+
+  bool readBool() {
+    final value = readUint8();
+    if (value > 1) throw FormatException('Bad bool $value in fast reply');
+    return value == 1;
+  }
+
+  int readInt32() {
+    _need(4);
+    final value = _data.getInt32(_position, Endian.little);
+    _position += 4;
+    return value;
+  }
+
+  int readInt64() {
+    _need(8);
+    final value = _data.getInt64(_position, Endian.little);
+    _position += 8;
+    return value;
+  }
+
+  double readFloat64() {
+    _need(8);
+    final value = _data.getFloat64(_position, Endian.little);
+    _position += 8;
+    return value;
+  }
+
+  String readString() => utf8.decode(readBytes());
+
+  /// A view of the reply's bytes, not a copy; it stays valid as long as
+  /// the caller keeps it.
+  Uint8List readBytes() {
+    _need(4);
+    final length = _data.getUint32(_position, Endian.little);
+    _position += 4;
+    _need(length);
+    final bytes = Uint8List.sublistView(_data, _position, _position + length);
+    _position += length;
+    return bytes;
+  }
+
+  void expectEnd() {
+    if (_position != _data.lengthInBytes) {
+      throw FormatException('${_data.lengthInBytes - _position} extra bytes '
+          'in fast reply');
+    }
+  }
+
+  void _need(int size) {
+    if (_position + size > _data.lengthInBytes) {
+      throw const FormatException('Truncated fast reply');
+    }
+  }
+}
+
+/// Sends [call] on [channel] and returns a reader positioned at the
+/// results. Error replies throw [PlatformException], as on a MethodChannel;
+/// an empty reply means no handler knows the call.
+Future<FastReader> fastCall(
+    BinaryMessenger messenger, String channel, FastWriter call) async {
+  final reply = await messenger.send(channel, call.done());
+  if (reply == null || reply.lengthInBytes == 0) {
+    throw MissingPluginException('No fast-path handler for call on $channel');
+  }
+  final reader = FastReader(reply);
+  if (reader.readUint8() == fastReplyError) {
+    throw PlatformException(
+        code: reader.readString(), message: reader.readString());
+  }
+  return reader;
+}
@@ -0,0 +1,98 @@
+// Generated by linux/native/tools/ss_codec_gen.cc from
+// linux/native/codec/fast_messages.schema. Do not edit.
+
+import 'package:flutter/services.dart';
+import 'fast_codec.dart';
+
+const int fastMessagesVersion = 2;
+
+/// Client for `com.silverstone/fast/click_through`.
+class ClickThroughFastChannel {
+  static const name = 'com.silverstone/fast/click_through';
+
+  final BinaryMessenger? _messenger;
+
+  const ClickThroughFastChannel([this._messenger]);
+
+  BinaryMessenger get _binaryMessenger =>
+      _messenger ?? ServicesBinding.instance.defaultBinaryMessenger;
+
+  Future<void> setClickThroughEnabled(bool enabled) async {
+    final writer = FastWriter.forCall(fastMessagesVersion, 1)
+      ..writeBool(enabled);
+    final reader = await fastCall(_binaryMessenger, name, writer);
+    reader.expectEnd();
+  }
+
+  Future<void> restoreNormalWindowStyle() async {
+    final writer = FastWriter.forCall(fastMessagesVersion, 2);
+    final reader = await fastCall(_binaryMessenger, name, writer);
+    reader.expectEnd();
+  }
+
+  Future<void> setFrameless(bool frameless) async {
+    final writer = FastWriter.forCall(fastMessagesVersion, 3)
+      ..writeBool(frameless);
+    final reader = await fastCall(_binaryMessenger, name, writer);
+    reader.expectEnd();
+  }
+}
+
+/// Client for `com.silverstone/fast/audio_recorder`.
+class AudioRecorderFastChannel {
+  static const name = 'com.silverstone/fast/audio_recorder';
+
+  final BinaryMessenger? _messenger;
+
+  const AudioRecorderFastChannel([this._messenger]);
+
+  BinaryMessenger get _binaryMessenger =>
+      _messenger ?? ServicesBinding.instance.defaultBinaryMessenger;
+
+  Future<bool> hasPermission() async {
+    final writer = FastWriter.forCall(fastMessagesVersion, 1);
+    final reader = await fastCall(_binaryMessenger, name, writer);
+    final granted = reader.readBool();
+    reader.expectEnd();
+    return granted;
+  }
+
+  Future<bool> startRecording(String path) async {
+    final writer = FastWriter.forCall(fastMessagesVersion, 2)
+      ..writeString(path);
+    final reader = await fastCall(_binaryMessenger, name, writer);
+    final started = reader.readBool();
+    reader.expectEnd();
+    return started;
+  }
+
+  Future<({String path, int samples, int emptyReads, int xruns, int timestampGaps, int missingUs, int maxGapUs, int maxBacklogUs, int mediaUs, int writeP50Us, int writeP99Us, int writeMaxUs, int finishUs, int fileBytes, bool failed})> stopRecording() async {
+    final writer = FastWriter.forCall(fastMessagesVersion, 3);
+    final reader = await fastCall(_binaryMessenger, name, writer);
+    final path = reader.readString();
+    final samples = reader.readInt64();
+    final emptyReads = reader.readInt64();
+    final xruns = reader.readInt64();
+    final timestampGaps = reader.readInt64();
+    final missingUs = reader.readInt64();
+    final maxGapUs = reader.readInt64();
+    final maxBacklogUs = reader.readInt64();
+    final mediaUs = reader.readInt64();
+    final writeP50Us = reader.readInt64();
+    final writeP99Us = reader.readInt64();
+    final writeMaxUs = reader.readInt64();
+    final finishUs = reader.readInt64();
+    final fileBytes = reader.readInt64();
+    final failed = reader.readBool();
+    reader.expectEnd();
+    return (path: path, samples: samples, emptyReads: emptyReads, xruns: xruns, timestampGaps: timestampGaps, missingUs: missingUs, maxGapUs: maxGapUs, maxBacklogUs: maxBacklogUs, mediaUs: mediaUs, writeP50Us: writeP50Us, writeP99Us: writeP99Us, writeMaxUs: writeMaxUs, finishUs: finishUs, fileBytes: fileBytes, failed: failed);
+  }
+
+  Future<bool> isRecording() async {
+    final writer = FastWriter.forCall(fastMessagesVersion, 4);
+    final reader = await fastCall(_binaryMessenger, name, writer);
+    final recording = reader.readBool();
+    reader.expectEnd();
+    return recording;
+  }
+}
@@ -0,0 +1,90 @@
+import 'dart:ffi';
+import 'native_library.dart';
+
+/// Mirrors `SsCatalogRow` in linux/native/catalog/catalog_api.h.
+final class SsCatalogRow extends Struct {
+  external Pointer<Uint8> id;
+
+  external Pointer<Uint8> name;
+
+  external Pointer<Uint8> client;
+
+  external Pointer<Uint8> status;
+
+  @Int64()
+  external int lastActiveMs;
+
+  @Int32()
+  external int idSize;
+
+  @Int32()
+  external int nameSize;
+
+  @Int32()
+  external int clientSize;
+
+  @Int32()
+  external int statusSize;
+}
+
+/// dart:ffi bindings for the native project catalog. Snapshot handles are
+/// `Pointer<Void>`; lookups only read an immutable snapshot, so they are
+/// leaf calls.
+class NativeCatalogBindings {
+  NativeCatalogBindings._(DynamicLibrary library)
+      : applyDelta = library.lookupFunction<
+            Int64 Function(Pointer<Uint8>, Int64),
+            int Function(Pointer<Uint8>, int)>('ss_catalog_apply_delta'),
+        acquire = library.lookupFunction<Pointer<Void> Function(),
+            Pointer<Void> Function()>('ss_catalog_acquire', isLeaf: true),
+        release = library.lookupFunction<Void Function(Pointer<Void>),
+            void Function(Pointer<Void>)>('ss_catalog_release', isLeaf: true),
+        releasePointer = library
+            .lookup<NativeFunction<Void Function(Pointer<Void>)>>(
+                'ss_catalog_release'),
+        version = library.lookupFunction<Int64 Function(Pointer<Void>),
+            int Function(Pointer<Void>)>('ss_catalog_version', isLeaf: true),
+        size = library.lookupFunction<Int64 Function(Pointer<Void>),
+            int Function(Pointer<Void>)>('ss_catalog_size', isLeaf: true),
+        findId = library.lookupFunction<
+            Int64 Function(Pointer<Void>, Pointer<Uint8>, Int64),
+            int Function(Pointer<Void>, Pointer<Uint8>, int)>(
+          'ss_catalog_find_id',
+          isLeaf: true,
+        ),
+        findName = library.lookupFunction<
+            Int64 Function(Pointer<Void>, Pointer<Uint8>, Int64),
+            int Function(Pointer<Void>, Pointer<Uint8>, int)>(
+          'ss_catalog_find_name',
+          isLeaf: true,
+        ),
+        row = library.lookupFunction<
+            Bool Function(Pointer<Void>, Int64, Pointer<SsCatalogRow>),
+            bool Function(Pointer<Void>, int, Pointer<SsCatalogRow>)>(
+          'ss_catalog_row',
+          isLeaf: true,
+        );
+
+  static NativeCatalogBindings? _instance;
+
+  /// Bindings, or null when the native library is not available.
+  static NativeCatalogBindings? get instance {
+    if (_instance != null) return _instance;
+    final library = NativeLibrary.instance;
+    if (library == null) return null;
+    return _instance = NativeCatalogBindings._(library);
+  }
+
+  /// Returns the new version, or -1 for a malformed delta.
+  final int Function(Pointer<Uint8>, int) applyDelta;
+  final Pointer<Void> Function() acquire;
+  final void Function(Pointer<Void>) release;
+
+  /// `ss_catalog_release`, for a [NativeFinalizer].
+  final Pointer<NativeFunction<Void Function(Pointer<Void>)>> releasePointer;
+  final int Function(Pointer<Void>) version;
+  final int Function(Pointer<Void>) size;
+  final int Function(Pointer<Void>, Pointer<Uint8>, int) findId;
+  final int Function(Pointer<Void>, Pointer<Uint8>, int) findName;
+  final bool Function(Pointer<Void>, int, Pointer<SsCatalogRow>) row;
+}
@@ -0,0 +1,39 @@
+import 'dart:ffi';
+import 'dart:io';
+import '../services/logger_service.dart';
+
+/// Loads the runner's native services library (linux/native).
+///
+/// The library ships in the bundle's `lib/` directory next to the Flutter
+/// engine. On platforms without it every binding reports itself unavailable
+/// and callers fall back to their Dart implementation.
+class NativeLibrary {
+  static const _fileName = 'libsilver_stone_native.so';
+
+  static DynamicLibrary? _library;
+  static bool _loadAttempted = false;
+
+  /// The loaded library, or null when it is not available on this platform.
+  static DynamicLibrary? get instance {
+    if (_loadAttempted) return _library;
+    _loadAttempted = true;
+
+    if (!Platform.isLinux) return null;
+
+    final bundleLib =
+        '${File(Platform.resolvedExecutable).parent.path}/lib/$_fileName';
+    for (final candidate in [bundleLib, _fileName]) {
+      try {
+        _library = DynamicLibrary.open(candidate);
+        return _library;
+      } catch (_) {
+        // Try the next location.
+      }
+    }
+
+    LoggerService().warning('Native library $_fileName not found');
+    return null;
+  }
+
+  static bool get isAvailable => instance != null;
+}
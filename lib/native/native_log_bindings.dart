@@ -0,0 +1,182 @@
+import 'dart:ffi';
+import 'package:ffi/ffi.dart';
+import 'native_library.dart';
+
+/// Mirrors `SsLogConfig` in linux/native/logging/log_api.h.
+final class SsLogConfig extends Struct {
+  external Pointer<Char> directory;
+
+  @Uint64()
+  external int maxSegmentBytes;
+
+  @Uint64()
+  external int maxSegmentAgeSeconds;
+
+  @Uint32()
+  external int maxArchivedSegments;
+
+  @Uint64()
+  external int maxArchiveBytes;
+
+  @Uint32()
+  external int maxStringBytes;
+
+  @Uint32()
+  external int oversizedSampleEvery;
+
+  @Uint32()
+  external int flushIntervalMs;
+
+  @Int32()
+  external int minLevel;
+}
+
+/// Mirrors `SsLogStats` in linux/native/logging/log_api.h.
+final class SsLogStats extends Struct {
+  @Uint64()
+  external int recordsWritten;
+
+  @Uint64()
+  external int recordsDropped;
+
+  @Uint64()
+  external int recordsSampledOut;
+
+  @Uint64()
+  external int recordsTruncated;
+
+  @Uint64()
+  external int bytesWritten;
+
+  @Uint32()
+  external int segmentsRotated;
+}
+
+/// Mirrors `SsLogQueryFilter` in linux/native/logging/log_api.h.
+final class SsLogQueryFilter extends Struct {
+  @Int64()
+  external int fromUs;
+
+  @Int64()
+  external int toUs;
+
+  @Int32()
+  external int minLevel;
+
+  external Pointer<Char> subsystems;
+
+  external Pointer<Char> text;
+}
+
+/// Mirrors `SsLogEntry` in linux/native/logging/log_api.h.
+final class SsLogEntry extends Struct {
+  @Int64()
+  external int timestampUs;
+
+  @Int32()
+  external int level;
+
+  @Uint32()
+  external int threadId;
+
+  @Int32()
+  external int truncated;
+
+  external Pointer<Utf8> subsystem;
+
+  external Pointer<Utf8> message;
+}
+
+/// Mirrors `SsLogQueryStats` in linux/native/logging/log_api.h.
+final class SsLogQueryStats extends Struct {
+  @Uint32()
+  external int segments;
+
+  @Uint32()
+  external int segmentsSkipped;
+
+  @Uint32()
+  external int blocksInflated;
+
+  @Uint32()
+  external int blocksSkipped;
+
+  @Uint64()
+  external int recordsScanned;
+
+  @Uint64()
+  external int recordsMatched;
+}
+
+/// Native `LogLevel` values.
+abstract final class NativeLogLevel {
+  static const trace = 0;
+  static const debug = 1;
+  static const info = 2;
+  static const warning = 3;
+  static const error = 4;
+  static const fatal = 5;
+}
+
+/// dart:ffi bindings for the native structured logger.
+class NativeLogBindings {
+  NativeLogBindings._(DynamicLibrary library)
+      : open = library.lookupFunction<Bool Function(Pointer<SsLogConfig>),
+            bool Function(Pointer<SsLogConfig>)>('ss_log_open'),
+        close = library.lookupFunction<Void Function(), void Function()>(
+            'ss_log_close'),
+        intern = library.lookupFunction<Uint32 Function(Pointer<Char>),
+            int Function(Pointer<Char>)>('ss_log_intern'),
+        message = library.lookupFunction<
+            Void Function(Int32, Uint32, Pointer<Uint8>, Int32),
+            void Function(int, int, Pointer<Uint8>, int)>(
+          'ss_log_message',
+          isLeaf: true,
+        ),
+        setLevel = library.lookupFunction<Void Function(Int32),
+            void Function(int)>('ss_log_set_level'),
+        flush = library.lookupFunction<Void Function(), void Function()>(
+            'ss_log_flush'),
+        getStats = library.lookupFunction<Void Function(Pointer<SsLogStats>),
+            void Function(Pointer<SsLogStats>)>('ss_log_get_stats'),
+        queryOpen = library.lookupFunction<
+            Pointer<Void> Function(Pointer<Char>, Pointer<SsLogQueryFilter>),
+            Pointer<Void> Function(
+                Pointer<Char>, Pointer<SsLogQueryFilter>)>('ss_log_query_open'),
+        queryNext = library.lookupFunction<
+            Int32 Function(Pointer<Void>, Pointer<SsLogEntry>, Int32),
+            int Function(
+                Pointer<Void>, Pointer<SsLogEntry>, int)>('ss_log_query_next'),
+        queryGetStats = library.lookupFunction<
+            Void Function(Pointer<Void>, Pointer<SsLogQueryStats>),
+            void Function(Pointer<Void>,
+                Pointer<SsLogQueryStats>)>('ss_log_query_get_stats'),
+        queryClose = library.lookupFunction<Void Function(Pointer<Void>),
+            void Function(Pointer<Void>)>('ss_log_query_close');
+
+  static NativeLogBindings? _instance;
+
+  /// Bindings, or null when the native library is not available.
+  static NativeLogBindings? get instance {
+    if (_instance != null) return _instance;
+    final library = NativeLibrary.instance;
+    if (library == null) return null;
+    return _instance = NativeLogBindings._(library);
+  }
+
+  final bool Function(Pointer<SsLogConfig>) open;
+  final void Function() close;
+  final int Function(Pointer<Char>) intern;
+
+  /// Lock-free enqueue of one UTF-8 message; safe as a leaf call.
+  final void Function(int, int, Pointer<Uint8>, int) message;
+  final void Function(int) setLevel;
+  final void Function() flush;
+  final void Function(Pointer<SsLogStats>) getStats;
+
+  final Pointer<Void> Function(Pointer<Char>, Pointer<SsLogQueryFilter>)
+      queryOpen;
+  final int Function(Pointer<Void>, Pointer<SsLogEntry>, int) queryNext;
+  final void Function(Pointer<Void>, Pointer<SsLogQueryStats>) queryGetStats;
+  final void Function(Pointer<Void>) queryClose;
+}
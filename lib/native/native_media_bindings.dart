@@ -0,0 +1,72 @@
+import 'dart:ffi';
+import 'native_library.dart';
+
+/// Mirrors `SsMp4Info` in linux/native/media/media_api.h.
+final class SsMp4Info extends Struct {
+  @Int64()
+  external int durationUs;
+
+  @Uint64()
+  external int mdatBytes;
+
+  @Uint32()
+  external int majorBrand;
+
+  @Uint32()
+  external int trackCount;
+
+  @Uint32()
+  external int codec;
+
+  @Uint32()
+  external int sampleCount;
+
+  @Uint32()
+  external int sampleRate;
+
+  @Uint16()
+  external int channels;
+
+  @Uint16()
+  external int width;
+
+  @Uint16()
+  external int height;
+
+  @Bool()
+  external bool faststart;
+
+  @Bool()
+  external bool fragmented;
+}
+
+/// dart:ffi bindings for the native MP4 inspector and faststart rewriter.
+///
+/// Both calls read the file; run them off the UI isolate.
+class NativeMediaBindings {
+  NativeMediaBindings._(DynamicLibrary library)
+      : inspect = library.lookupFunction<
+            Bool Function(Pointer<Char>, Pointer<SsMp4Info>, Pointer<Char>,
+                Int32),
+            bool Function(Pointer<Char>, Pointer<SsMp4Info>, Pointer<Char>,
+                int)>('ss_mp4_inspect'),
+        faststart = library.lookupFunction<
+            Int32 Function(Pointer<Char>, Pointer<Char>, Int32),
+            int Function(Pointer<Char>, Pointer<Char>, int)>(
+          'ss_mp4_faststart',
+        );
+
+  static NativeMediaBindings? _instance;
+
+  /// Bindings, or null when the native library is not available.
+  static NativeMediaBindings? get instance {
+    if (_instance != null) return _instance;
+    final library = NativeLibrary.instance;
+    if (library == null) return null;
+    return _instance = NativeMediaBindings._(library);
+  }
+
+  final bool Function(Pointer<Char>, Pointer<SsMp4Info>, Pointer<Char>, int)
+      inspect;
+  final int Function(Pointer<Char>, Pointer<Char>, int) faststart;
+}
@@ -0,0 +1,81 @@
+import 'dart:ffi';
+import 'native_library.dart';
+
+/// Mirrors `SsMemoryStats` in linux/native/memory/memory_api.h.
+final class SsMemoryStats extends Struct {
+  @Uint64()
+  external int rssBytes;
+
+  @Uint64()
+  external int anonBytes;
+
+  @Uint64()
+  external int fileBytes;
+
+  @Uint64()
+  external int swapBytes;
+
+  @Double()
+  external double pressureSomeAvg10;
+
+  @Double()
+  external double pressureFullAvg10;
+
+  @Uint64()
+  external int cgroupCurrentBytes;
+
+  @Uint64()
+  external int cgroupLimitBytes;
+}
+
+/// Mirrors `SsMemoryTrimReport` in linux/native/memory/memory_api.h.
+final class SsMemoryTrimReport extends Struct {
+  @Uint64()
+  external int rssBeforeBytes;
+
+  @Uint64()
+  external int rssAfterBytes;
+
+  @Uint64()
+  external int nativeReleasedBytes;
+
+  @Int64()
+  external int durationUs;
+
+  @Int32()
+  external int reason;
+}
+
+/// dart:ffi bindings for the native memory manager. The runner decides when
+/// to trim; Dart only reports floating mode and reads the numbers.
+class NativeMemoryBindings {
+  NativeMemoryBindings._(DynamicLibrary library)
+      : readStats = library.lookupFunction<
+            Bool Function(Pointer<SsMemoryStats>),
+            bool Function(Pointer<SsMemoryStats>)>('ss_memory_read_stats'),
+        setIdle = library.lookupFunction<Void Function(Bool),
+            void Function(bool)>(
+          'ss_memory_set_idle',
+          isLeaf: true,
+        ),
+        lastTrim = library.lookupFunction<
+            Bool Function(Pointer<SsMemoryTrimReport>),
+            bool Function(Pointer<SsMemoryTrimReport>)>(
+          'ss_memory_last_trim',
+          isLeaf: true,
+        );
+
+  static NativeMemoryBindings? _instance;
+
+  /// Bindings, or null when the native library is not available.
+  static NativeMemoryBindings? get instance {
+    if (_instance != null) return _instance;
+    final library = NativeLibrary.instance;
+    if (library == null) return null;
+    return _instance = NativeMemoryBindings._(library);
+  }
+
+  final bool Function(Pointer<SsMemoryStats>) readStats;
+  final void Function(bool) setIdle;
+  final bool Function(Pointer<SsMemoryTrimReport>) lastTrim;
+}
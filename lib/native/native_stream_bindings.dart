@@ -0,0 +1,108 @@
+import 'dart:ffi';
+import 'native_library.dart';
+
+/// Mirrors `SsStreamLayout` in linux/native/stream/stream_api.h.
+final class SsStreamLayout extends Struct {
+  external Pointer<Uint8> records;
+
+  @Uint32()
+  external int recordSize;
+
+  @Uint32()
+  external int capacity;
+}
+
+/// Mirrors `SsChannelCallRecord` in linux/native/diagnostics/diagnostics_api.h.
+final class SsChannelCallRecord extends Struct {
+  @Int64()
+  external int timeUs;
+
+  @Int64()
+  external int handlerUs;
+
+  @Int64()
+  external int responseUs;
+
+  @Int32()
+  external int requestBytes;
+
+  @Int32()
+  external int responseBytes;
+
+  @Int32()
+  external int status;
+
+  @Uint32()
+  external int methodId;
+}
+
+typedef StreamDoorbellNative = Void Function(Pointer<Void>);
+
+/// dart:ffi bindings for the native record streams.
+///
+/// The reader calls run once per drain and are bound as leaf calls; the
+/// records themselves are read straight from native memory.
+class NativeStreamBindings {
+  NativeStreamBindings._(DynamicLibrary library)
+      : open = library.lookupFunction<
+            Pointer<Void> Function(Pointer<Char>, Uint32, Uint32),
+            Pointer<Void> Function(Pointer<Char>, int, int)>('ss_stream_open'),
+        layout = library.lookupFunction<
+            Void Function(Pointer<Void>, Pointer<SsStreamLayout>),
+            void Function(
+                Pointer<Void>, Pointer<SsStreamLayout>)>('ss_stream_layout'),
+        attach = library.lookupFunction<
+            Bool Function(Pointer<Void>,
+                Pointer<NativeFunction<StreamDoorbellNative>>, Pointer<Void>),
+            bool Function(
+                Pointer<Void>,
+                Pointer<NativeFunction<StreamDoorbellNative>>,
+                Pointer<Void>)>('ss_stream_attach'),
+        detach = library.lookupFunction<Void Function(Pointer<Void>),
+            void Function(Pointer<Void>)>('ss_stream_detach'),
+        acquire = library.lookupFunction<
+            Uint32 Function(Pointer<Void>, Pointer<Uint64>),
+            int Function(Pointer<Void>, Pointer<Uint64>)>(
+          'ss_stream_acquire',
+          isLeaf: true,
+        ),
+        release = library.lookupFunction<Void Function(Pointer<Void>, Uint32),
+            void Function(Pointer<Void>, int)>(
+          'ss_stream_release',
+          isLeaf: true,
+        ),
+        arm = library.lookupFunction<Bool Function(Pointer<Void>),
+            bool Function(Pointer<Void>)>(
+          'ss_stream_arm',
+          isLeaf: true,
+        ),
+        dropped = library.lookupFunction<Uint64 Function(Pointer<Void>),
+            int Function(Pointer<Void>)>(
+          'ss_stream_dropped',
+          isLeaf: true,
+        ),
+        channelMethodName = library.lookupFunction<
+            Int32 Function(Uint32, Pointer<Char>, Int32),
+            int Function(int, Pointer<Char>, int)>('ss_diag_method_name');
+
+  static NativeStreamBindings? _instance;
+
+  /// Bindings, or null when the native library is not available.
+  static NativeStreamBindings? get instance {
+    if (_instance != null) return _instance;
+    final library = NativeLibrary.instance;
+    if (library == null) return null;
+    return _instance = NativeStreamBindings._(library);
+  }
+
+  final Pointer<Void> Function(Pointer<Char>, int, int) open;
+  final void Function(Pointer<Void>, Pointer<SsStreamLayout>) layout;
+  final bool Function(Pointer<Void>,
+      Pointer<NativeFunction<StreamDoorbellNative>>, Pointer<Void>) attach;
+  final void Function(Pointer<Void>) detach;
+  final int Function(Pointer<Void>, Pointer<Uint64>) acquire;
+  final void Function(Pointer<Void>, int) release;
+  final bool Function(Pointer<Void>) arm;
+  final int Function(Pointer<Void>) dropped;
+  final int Function(int, Pointer<Char>, int) channelMethodName;
+}
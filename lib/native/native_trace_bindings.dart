@@ -0,0 +1,70 @@
+import 'dart:ffi';
+import 'native_library.dart';
+
+/// dart:ffi bindings for the native tracer (linux/native/tracing/trace_api.h).
+///
+/// The recording calls only append to a per-thread buffer and are bound as
+/// leaf calls.
+class NativeTraceBindings {
+  NativeTraceBindings._(DynamicLibrary library)
+      : enabled = library.lookupFunction<Bool Function(), bool Function()>(
+          'ss_trace_enabled',
+          isLeaf: true,
+        ),
+        intern = library.lookupFunction<Uint32 Function(Pointer<Char>),
+            int Function(Pointer<Char>)>('ss_trace_intern'),
+        begin = library.lookupFunction<Void Function(Uint32, Uint32),
+            void Function(int, int)>(
+          'ss_trace_begin',
+          isLeaf: true,
+        ),
+        end = library.lookupFunction<Void Function(Uint32, Uint32),
+            void Function(int, int)>(
+          'ss_trace_end',
+          isLeaf: true,
+        ),
+        counter = library.lookupFunction<Void Function(Uint32, Uint32, Double),
+            void Function(int, int, double)>(
+          'ss_trace_counter',
+          isLeaf: true,
+        ),
+        instant = library.lookupFunction<Void Function(Uint32, Uint32),
+            void Function(int, int)>(
+          'ss_trace_instant',
+          isLeaf: true,
+        ),
+        asyncBegin = library.lookupFunction<
+            Void Function(Uint32, Uint32, Uint64),
+            void Function(int, int, int)>(
+          'ss_trace_async_begin',
+          isLeaf: true,
+        ),
+        asyncEnd = library.lookupFunction<
+            Void Function(Uint32, Uint32, Uint64),
+            void Function(int, int, int)>(
+          'ss_trace_async_end',
+          isLeaf: true,
+        ),
+        setThreadName = library.lookupFunction<Void Function(Pointer<Char>),
+            void Function(Pointer<Char>)>('ss_trace_set_thread_name');
+
+  static NativeTraceBindings? _instance;
+
+  /// Bindings, or null when the native library is not available.
+  static NativeTraceBindings? get instance {
+    if (_instance != null) return _instance;
+    final library = NativeLibrary.instance;
+    if (library == null) return null;
+    return _instance = NativeTraceBindings._(library);
+  }
+
+  final bool Function() enabled;
+  final int Function(Pointer<Char>) intern;
+  final void Function(int, int) begin;
+  final void Function(int, int) end;
+  final void Function(int, int, double) counter;
+  final void Function(int, int) instant;
+  final void Function(int, int, int) asyncBegin;
+  final void Function(int, int, int) asyncEnd;
+  final void Function(Pointer<Char>) setThreadName;
+}
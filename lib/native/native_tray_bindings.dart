@@ -0,0 +1,36 @@
+import 'dart:ffi';
+import 'package:ffi/ffi.dart';
+import 'native_library.dart';
+
+/// dart:ffi bindings for the native tray state (linux/native/tray). Dart
+/// says whether the tray is up and which timer runs; the runner's indicator
+/// draws the icon and keeps the elapsed time current on its own.
+class NativeTrayBindings {
+  NativeTrayBindings._(DynamicLibrary library)
+      : setVisible = library.lookupFunction<Void Function(Bool),
+            void Function(bool)>('ss_tray_set_visible'),
+        setSession = library.lookupFunction<
+            Void Function(Pointer<Utf8>, Int64),
+            void Function(Pointer<Utf8>, int)>('ss_tray_set_session'),
+        hasIndicator = library.lookupFunction<Bool Function(),
+            bool Function()>(
+          'ss_tray_has_indicator',
+          isLeaf: true,
+        );
+
+  static NativeTrayBindings? _instance;
+
+  /// Bindings, or null when the native library is not available.
+  static NativeTrayBindings? get instance {
+    if (_instance != null) return _instance;
+    final library = NativeLibrary.instance;
+    if (library == null) return null;
+    return _instance = NativeTrayBindings._(library);
+  }
+
+  final void Function(bool) setVisible;
+
+  /// Null or an empty project means no timer runs.
+  final void Function(Pointer<Utf8>, int) setSession;
+  final bool Function() hasIndicator;
+}
@@ -0,0 +1,55 @@
+import 'dart:ffi';
+import 'native_library.dart';
+
+/// Mirrors `SsBundlePatchStats` in linux/native/update/update_api.h.
+final class SsBundlePatchStats extends Struct {
+  @Uint32()
+  external int files;
+
+  @Uint32()
+  external int kept;
+
+  @Uint32()
+  external int patched;
+
+  @Uint32()
+  external int added;
+
+  @Uint64()
+  external int targetBytes;
+
+  @Uint64()
+  external int patchBytes;
+}
+
+/// dart:ffi bindings for the native bundle updater.
+///
+/// Both calls block for as long as they read files; run them off the UI
+/// isolate.
+class NativeUpdateBindings {
+  NativeUpdateBindings._(DynamicLibrary library)
+      : hashFile = library.lookupFunction<
+            Bool Function(Pointer<Char>, Pointer<Char>),
+            bool Function(Pointer<Char>, Pointer<Char>)>('ss_update_hash_file'),
+        stagePatch = library.lookupFunction<
+            Bool Function(Pointer<Char>, Pointer<Char>, Pointer<Char>, Int32,
+                Pointer<SsBundlePatchStats>, Pointer<Char>, Int32),
+            bool Function(Pointer<Char>, Pointer<Char>, Pointer<Char>, int,
+                Pointer<SsBundlePatchStats>, Pointer<Char>, int)>(
+          'ss_update_stage_patch',
+        );
+
+  static NativeUpdateBindings? _instance;
+
+  /// Bindings, or null when the native library is not available.
+  static NativeUpdateBindings? get instance {
+    if (_instance != null) return _instance;
+    final library = NativeLibrary.instance;
+    if (library == null) return null;
+    return _instance = NativeUpdateBindings._(library);
+  }
+
+  final bool Function(Pointer<Char>, Pointer<Char>) hashFile;
+  final bool Function(Pointer<Char>, Pointer<Char>, Pointer<Char>, int,
+      Pointer<SsBundlePatchStats>, Pointer<Char>, int) stagePatch;
+}
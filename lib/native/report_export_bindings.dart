@@ -0,0 +1,78 @@
+import 'dart:ffi';
+import 'native_library.dart';
+
+/// Mirrors `SsExportRow` in linux/native/export/export_api.h.
+final class SsExportRow extends Struct {
+  external Pointer<Char> date;
+  external Pointer<Char> project;
+  external Pointer<Char> title;
+  external Pointer<Char> description;
+
+  @Int64()
+  external int startedAtMs;
+
+  @Int64()
+  external int endedAtMs;
+
+  @Int64()
+  external int durationSeconds;
+}
+
+/// Mirrors `SsExportProgress` in linux/native/export/export_api.h.
+final class SsExportProgress extends Struct {
+  @Int32()
+  external int state;
+
+  @Int64()
+  external int rowsWritten;
+
+  @Int64()
+  external int totalRows;
+
+  @Uint64()
+  external int bytesWritten;
+}
+
+/// dart:ffi bindings for the native report export engine.
+class ReportExportBindings {
+  ReportExportBindings._(DynamicLibrary library)
+      : open = library.lookupFunction<
+            Pointer<Void> Function(Pointer<Char>, Int32, Pointer<Char>, Int64),
+            Pointer<Void> Function(
+                Pointer<Char>, int, Pointer<Char>, int)>('ss_export_open'),
+        addRows = library.lookupFunction<
+            Int32 Function(Pointer<Void>, Pointer<SsExportRow>, Int32),
+            int Function(
+                Pointer<Void>, Pointer<SsExportRow>, int)>('ss_export_add_rows'),
+        finish = library.lookupFunction<Void Function(Pointer<Void>),
+            void Function(Pointer<Void>)>('ss_export_finish'),
+        cancel = library.lookupFunction<Void Function(Pointer<Void>),
+            void Function(Pointer<Void>)>('ss_export_cancel'),
+        getProgress = library.lookupFunction<
+            Void Function(Pointer<Void>, Pointer<SsExportProgress>),
+            void Function(
+                Pointer<Void>, Pointer<SsExportProgress>)>('ss_export_get_progress'),
+        getError = library.lookupFunction<
+            Int32 Function(Pointer<Void>, Pointer<Char>, Int32),
+            int Function(Pointer<Void>, Pointer<Char>, int)>('ss_export_get_error'),
+        close = library.lookupFunction<Void Function(Pointer<Void>),
+            void Function(Pointer<Void>)>('ss_export_close');
+
+  static ReportExportBindings? _instance;
+
+  /// Bindings, or null when the native library is not available.
+  static ReportExportBindings? get instance {
+    if (_instance != null) return _instance;
+    final library = NativeLibrary.instance;
+    if (library == null) return null;
+    return _instance = ReportExportBindings._(library);
+  }
+
+  final Pointer<Void> Function(Pointer<Char>, int, Pointer<Char>, int) open;
+  final int Function(Pointer<Void>, Pointer<SsExportRow>, int) addRows;
+  final void Function(Pointer<Void>) finish;
+  final void Function(Pointer<Void>) cancel;
+  final void Function(Pointer<Void>, Pointer<SsExportProgress>) getProgress;
+  final int Function(Pointer<Void>, Pointer<Char>, int) getError;
+  final void Function(Pointer<Void>) close;
+}
@@ -1,9 +1,14 @@
+import 'dart:async';
 import 'dart:io';
 import 'package:flutter_riverpod/flutter_riverpod.dart';
 import 'package:window_manager/window_manager.dart';
 import '../services/window_service.dart';
 import '../services/logger_service.dart';
+import '../services/memory_service.dart';
+import '../services/notification_service.dart';
 import '../services/system_tray_service.dart';
+import '../services/trace_service.dart';
+import 'timer_provider.dart';
 
 // Window service provider
 final windowServiceProvider = Provider<WindowService>((ref) {
@@ -23,6 +28,9 @@ class WindowModeNotifier extends StateNotifier<bool> {
   late final WindowService _windowService;
   late final LoggerService _logger;
   late final SystemTrayService _systemTray;
+  final _trace = TraceService();
+  final _memory = MemoryService();
+  StreamSubscription<NotificationAction>? _toastActions;
 
   // State: true = floating mode, false = main mode
   WindowModeNotifier(this._ref) : super(false) {
@@ -30,6 +38,28 @@ class WindowModeNotifier extends StateNotifier<bool> {
     _logger = LoggerService();
     _systemTray = SystemTrayService();
     _setupTrayCallbacks();
+    _ref.listen<ActiveSession?>(
+      currentTimerProvider,
+      (_, session) {
+        final running = session != null && session.isRunning;
+        _systemTray.updateSession(
+          running ? session.projectName : null,
+          running ? session.startedAt : null,
+        );
+      },
+      fireImmediately: true,
+    );
+    // The runner has already brought the window up; a toast clicked while
+    // floating opens the dashboard, where the notifications are.
+    _toastActions = NotificationService().actions.listen((_) {
+      if (state) switchToMain();
+    });
+  }
+
+  @override
+  void dispose() {
+    _toastActions?.cancel();
+    super.dispose();
   }
 
   void _setupTrayCallbacks() {
@@ -77,10 +107,14 @@ class WindowModeNotifier extends StateNotifier<bool> {
       state = true;
       _ref.read(floatingWindowOpenProvider.notifier).state = true;
 
-      await _windowService.switchToFloatingMode();
+      await _trace.traceAsync(
+        'window: switch to floating',
+        _windowService.switchToFloatingMode,
+      );
 
       // Show system tray icon (since app is hidden from taskbar in floating mode)
-      await _showSystemTray();
+      await _trace.traceAsync('tray: show', _showSystemTray);
+      _memory.setIdle(true);
 
       _logger.info('Switched to floating mode');
     } catch (e, stackTrace) {
@@ -100,14 +134,18 @@ class WindowModeNotifier extends StateNotifier<bool> {
       _logger.info('Switching to main mode...');
 
       // Hide system tray icon (app will be visible in taskbar)
-      await _hideSystemTray();
+      await _trace.traceAsync('tray: hide', _hideSystemTray);
 
       // First restore window size, then update state
       // This prevents FloatingWidget from rendering with large window during transition
-      await _windowService.switchToMainMode();
+      await _trace.traceAsync(
+        'window: switch to main',
+        _windowService.switchToMainMode,
+      );
 
       state = false;
       _ref.read(floatingWindowOpenProvider.notifier).state = false;
+      _memory.setIdle(false);
 
       _logger.info('Switched to main mode');
     } catch (e, stackTrace) {
@@ -1,10 +1,13 @@
 import 'dart:ui' as ui;
+import 'package:file_picker/file_picker.dart';
 import 'package:flutter/material.dart';
 import 'package:intl/intl.dart';
 import 'package:window_manager/window_manager.dart';
+import '../core/extensions/context_extensions.dart';
 import '../core/theme/app_theme.dart';
 import '../services/api_service.dart';
 import '../services/logger_service.dart';
+import '../services/report_export_service.dart';
 import '../widgets/window_controls.dart';
 
 class DailyReportsScreen extends StatefulWidget {
@@ -17,6 +20,7 @@ class DailyReportsScreen extends StatefulWidget {
 class _DailyReportsScreenState extends State<DailyReportsScreen> {
   final _api = ApiService();
   final _logger = LoggerService();
+  final _exportService = ReportExportService();
   final _scrollController = ScrollController();
 
   // Data
@@ -35,6 +39,10 @@ class _DailyReportsScreenState extends State<DailyReportsScreen> {
   // Expansion state for reports
   final Set<String> _expandedReports = {};
 
+  // Export state
+  bool _isExporting = false;
+  double _exportProgress = 0;
+
   @override
   void initState() {
     super.initState();
@@ -199,6 +207,66 @@ class _DailyReportsScreenState extends State<DailyReportsScreen> {
     return DateFormat('MMM d').format(date);
   }
 
+  String _exportRangeLabel() {
+    if (_fromDate == null || _toDate == null || _activeFilter == 'all') {
+      return 'all';
+    }
+    final format = DateFormat('yyyy-MM-dd');
+    return '${format.format(_fromDate!)}_to_'
+        '${format.format(_toDate!.subtract(const Duration(days: 1)))}';
+  }
+
+  Future<void> _exportReports(ReportExportFormat format) async {
+    if (_isExporting) return;
+
+    final rangeLabel = _exportRangeLabel();
+    final path = await FilePicker.platform.saveFile(
+      dialogTitle: 'Export reports',
+      fileName: 'timesheet_$rangeLabel.${format.extension}',
+      type: FileType.custom,
+      allowedExtensions: [format.extension],
+    );
+    if (path == null) return;
+
+    setState(() {
+      _isExporting = true;
+      _exportProgress = 0;
+    });
+
+    try {
+      ReportExportProgress? last;
+      await for (final progress in _exportService.exportReports(
+        reports: _reports,
+        path: path,
+        format: format,
+        title: 'Timesheet ($rangeLabel)',
+      )) {
+        last = progress;
+        if (mounted) {
+          setState(() => _exportProgress = progress.fraction);
+        }
+      }
+
+      if (!mounted) return;
+      if (last?.error != null) {
+        context.showErrorSnackBar('Export failed: ${last!.error}');
+      } else {
+        context.showSuccessSnackBar(
+            'Exported ${last?.rowsWritten ?? 0} tasks to $path');
+      }
+    } catch (e) {
+      _logger.error('Failed to export reports', e, null);
+      if (mounted) {
+        context.showErrorSnackBar(
+            'Export failed: ${e.toString().replaceFirst('Exception: ', '')}');
+      }
+    } finally {
+      if (mounted) {
+        setState(() => _isExporting = false);
+      }
+    }
+  }
+
   @override
   Widget build(BuildContext context) {
     return Scaffold(
@@ -255,6 +323,8 @@ class _DailyReportsScreenState extends State<DailyReportsScreen> {
                               ),
                             ),
                           ),
+                          if (_exportService.isSupported && _reports.isNotEmpty)
+                            _buildExportButton(),
                         ],
                       ),
                     ),
@@ -362,6 +432,53 @@ class _DailyReportsScreenState extends State<DailyReportsScreen> {
     );
   }
 
+  Widget _buildExportButton() {
+    final decoration = BoxDecoration(
+      color: Colors.white.withValues(alpha: 0.1),
+      borderRadius: BorderRadius.circular(10),
+    );
+
+    if (_isExporting) {
+      return Container(
+        width: 36,
+        height: 36,
+        padding: const EdgeInsets.all(9),
+        decoration: decoration,
+        child: CircularProgressIndicator(
+          value: _exportProgress > 0 ? _exportProgress : null,
+          strokeWidth: 2,
+          color: AppTheme.successColor,
+        ),
+      );
+    }
+
+    return PopupMenuButton<ReportExportFormat>(
+      tooltip: 'Export',
+      color: const Color(0xFF2A2A2A),
+      onSelected: _exportReports,
+      itemBuilder: (context) => [
+        for (final format in ReportExportFormat.values)
+          PopupMenuItem(
+            value: format,
+            child: Text(
+              'Export as ${format.label}',
+              style: const TextStyle(color: Colors.white, fontSize: 13),
+            ),
+          ),
+      ],
+      child: Container(
+        width: 36,
+        height: 36,
+        decoration: decoration,
+        child: const Icon(
+          Icons.file_download_outlined,
+          color: Colors.white,
+          size: 20,
+        ),
+      ),
+    );
+  }
+
   Widget _buildFilterChip(String label, String filter) {
     final isActive = _activeFilter == filter;
     return GestureDetector(
@@ -16,6 +16,7 @@ import '../providers/window_provider.dart';
 import '../providers/navigation_provider.dart';
 import '../providers/attendance_provider.dart';
 import '../services/api_service.dart';
+import '../services/log_query_service.dart';
 import '../services/logger_service.dart';
 import '../services/window_service.dart';
 import '../widgets/window_controls.dart';
@@ -32,6 +33,7 @@ import '../widgets/update_dialog.dart';
 import 'login_screen.dart';
 import 'submission_form_screen.dart';
 import 'daily_reports_screen.dart';
+import 'log_viewer_screen.dart';
 import 'pending_tasks_screen.dart';
 
 class DashboardScreen extends ConsumerStatefulWidget {
@@ -618,8 +620,9 @@ class _DashboardScreenState
       }
     });
 
-    // Show floating widget when in floating mode instead of dashboard
-    if (isFloatingMode) {
+    // Show floating widget when in floating mode instead of dashboard,
+    // unless it has a window of its own (FloatingApp in main.dart)
+    if (isFloatingMode && !WindowService().hasFloatingView) {
       return const FloatingWidget();
     }
 
@@ -686,6 +689,27 @@ class _DashboardScreenState
                             constraints: const BoxConstraints(),
                           ),
                           const SizedBox(width: 12),
+                          // App logs (support), when the native log is on
+                          if (LogQueryService().isAvailable) ...[
+                            IconButton(
+                              icon: const Icon(
+                                Icons.manage_search,
+                                size: 20,
+                              ),
+                              onPressed: () {
+                                Navigator.of(context).push(
+                                  MaterialPageRoute(
+                                    builder: (context) =>
+                                        const LogViewerScreen(),
+                                  ),
+                                );
+                              },
+                              tooltip: 'App Logs',
+                              padding: EdgeInsets.zero,
+                              constraints: const BoxConstraints(),
+                            ),
+                            const SizedBox(width: 12),
+                          ],
                           // Notification bell
                           const NotificationBell(),
                           const SizedBox(width: 12),
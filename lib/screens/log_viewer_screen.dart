@@ -0,0 +1,279 @@
+import 'dart:async';
+import 'package:flutter/material.dart';
+import 'package:window_manager/window_manager.dart';
+import '../core/theme/app_theme.dart';
+import '../services/log_query_service.dart';
+import '../widgets/window_controls.dart';
+
+/// Support screen for searching the app's persistent log.
+class LogViewerScreen extends StatefulWidget {
+  const LogViewerScreen({super.key});
+
+  @override
+  State<LogViewerScreen> createState() => _LogViewerScreenState();
+}
+
+class _LogViewerScreenState extends State<LogViewerScreen> {
+  static const _ranges = <String, Duration>{
+    'Last hour': Duration(hours: 1),
+    'Last 24 hours': Duration(hours: 24),
+    'Last 7 days': Duration(days: 7),
+    'Last 30 days': Duration(days: 30),
+  };
+
+  final _logQueryService = LogQueryService();
+  final _subsystemController = TextEditingController();
+  final _searchController = TextEditingController();
+
+  String _range = 'Last 24 hours';
+  LogEntryLevel _minLevel = LogEntryLevel.info;
+  final List<LogEntry> _entries = [];
+  StreamSubscription<List<LogEntry>>? _subscription;
+  bool _isLoading = false;
+  String? _error;
+
+  @override
+  void initState() {
+    super.initState();
+    _runQuery();
+  }
+
+  @override
+  void dispose() {
+    _subscription?.cancel();
+    _subsystemController.dispose();
+    _searchController.dispose();
+    super.dispose();
+  }
+
+  void _runQuery() {
+    _subscription?.cancel();
+    if (!_logQueryService.isAvailable) {
+      setState(() => _error = 'The persistent log is not available');
+      return;
+    }
+
+    final subsystems = _subsystemController.text
+        .split(',')
+        .map((s) => s.trim())
+        .where((s) => s.isNotEmpty)
+        .toList();
+    setState(() {
+      _entries.clear();
+      _isLoading = true;
+      _error = null;
+    });
+
+    _subscription = _logQueryService
+        .query(
+          from: DateTime.now().subtract(_ranges[_range]!),
+          minLevel: _minLevel,
+          subsystems: subsystems,
+          text: _searchController.text.trim(),
+        )
+        .listen(
+          (batch) => setState(() => _entries.addAll(batch)),
+          onError: (Object e) => setState(() {
+            _error = e.toString();
+            _isLoading = false;
+          }),
+          onDone: () => setState(() => _isLoading = false),
+        );
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    return Scaffold(
+      backgroundColor: Colors.transparent,
+      body: Container(
+        decoration: AppTheme.fullscreenBackgroundDecoration,
+        child: Stack(
+          children: [
+            Column(
+              children: [
+                _buildHeader(context),
+                _buildFilters(),
+                const SizedBox(height: 8),
+                Expanded(child: _buildContent()),
+              ],
+            ),
+
+            // Top bar with draggable area and window controls
+            Positioned(
+              top: 0,
+              left: 0,
+              right: 0,
+              height: 40,
+              child: Row(
+                children: [
+                  Expanded(
+                    child: GestureDetector(
+                      onPanStart: (_) => windowManager.startDragging(),
+                      child: Container(color: Colors.transparent),
+                    ),
+                  ),
+                  const Padding(
+                    padding: EdgeInsets.only(top: 8, right: 8),
+                    child: WindowControls(),
+                  ),
+                ],
+              ),
+            ),
+          ],
+        ),
+      ),
+    );
+  }
+
+  Widget _buildHeader(BuildContext context) {
+    return Padding(
+      padding: const EdgeInsets.fromLTRB(16, 40, 8, 12),
+      child: Row(
+        children: [
+          GestureDetector(
+            onTap: () => Navigator.of(context).pop(),
+            child: Container(
+              width: 36,
+              height: 36,
+              decoration: BoxDecoration(
+                color: Colors.white.withValues(alpha: 0.1),
+                borderRadius: BorderRadius.circular(10),
+              ),
+              child: const Icon(Icons.arrow_back, color: Colors.white, size: 20),
+            ),
+          ),
+          const SizedBox(width: 12),
+          const Text(
+            'APP LOGS',
+            style: TextStyle(
+              fontSize: 18,
+              fontWeight: FontWeight.bold,
+              color: Colors.white,
+              letterSpacing: 1,
+            ),
+          ),
+          const SizedBox(width: 12),
+          Text(
+            _isLoading ? 'Searching...' : '${_entries.length} entries',
+            style: const TextStyle(color: AppTheme.textSecondary, fontSize: 12),
+          ),
+          const Spacer(),
+          IconButton(
+            onPressed: _runQuery,
+            icon: const Icon(Icons.refresh),
+            color: Colors.white,
+            iconSize: 20,
+            tooltip: 'Run query',
+          ),
+        ],
+      ),
+    );
+  }
+
+  Widget _buildFilters() {
+    return Padding(
+      padding: const EdgeInsets.symmetric(horizontal: 16),
+      child: Wrap(
+        spacing: 12,
+        runSpacing: 8,
+        crossAxisAlignment: WrapCrossAlignment.center,
+        children: [
+          DropdownButton<String>(
+            value: _range,
+            dropdownColor: AppTheme.surfaceColor,
+            items: _ranges.keys
+                .map((r) => DropdownMenuItem(value: r, child: Text(r)))
+                .toList(),
+            onChanged: (value) {
+              if (value == null) return;
+              _range = value;
+              _runQuery();
+            },
+          ),
+          DropdownButton<LogEntryLevel>(
+            value: _minLevel,
+            dropdownColor: AppTheme.surfaceColor,
+            items: LogEntryLevel.values
+                .map((l) => DropdownMenuItem(value: l, child: Text(l.label)))
+                .toList(),
+            onChanged: (value) {
+              if (value == null) return;
+              _minLevel = value;
+              _runQuery();
+            },
+          ),
+          SizedBox(
+            width: 160,
+            child: TextField(
+              controller: _subsystemController,
+              decoration: const InputDecoration(
+                hintText: 'Subsystems (api,timer)',
+                isDense: true,
+              ),
+              onSubmitted: (_) => _runQuery(),
+            ),
+          ),
+          SizedBox(
+            width: 220,
+            child: TextField(
+              controller: _searchController,
+              decoration: const InputDecoration(
+                hintText: 'Search messages',
+                prefixIcon: Icon(Icons.search, size: 18),
+                isDense: true,
+              ),
+              onSubmitted: (_) => _runQuery(),
+            ),
+          ),
+        ],
+      ),
+    );
+  }
+
+  Widget _buildContent() {
+    if (_error != null) {
+      return Center(
+        child: Text(_error!, style: const TextStyle(color: Colors.white54)),
+      );
+    }
+    if (_entries.isEmpty) {
+      return Center(
+        child: _isLoading
+            ? const CircularProgressIndicator(color: AppTheme.primaryColor)
+            : const Text(
+                'No matching log entries',
+                style: TextStyle(color: Colors.white54),
+              ),
+      );
+    }
+    return ListView.builder(
+      padding: const EdgeInsets.symmetric(horizontal: 16, vertical: 4),
+      itemCount: _entries.length,
+      itemExtent: 20,
+      itemBuilder: (context, index) => _buildEntry(_entries[index]),
+    );
+  }
+
+  Widget _buildEntry(LogEntry entry) {
+    final time = entry.timestamp.toLocal();
+    final stamp = '${time.month.toString().padLeft(2, '0')}-'
+        '${time.day.toString().padLeft(2, '0')} '
+        '${time.hour.toString().padLeft(2, '0')}:'
+        '${time.minute.toString().padLeft(2, '0')}:'
+        '${time.second.toString().padLeft(2, '0')}.'
+        '${time.millisecond.toString().padLeft(3, '0')}';
+    final color = switch (entry.level) {
+      LogEntryLevel.error || LogEntryLevel.fatal => AppTheme.errorColor,
+      LogEntryLevel.warning => AppTheme.warningColor,
+      LogEntryLevel.info => AppTheme.textPrimary,
+      _ => AppTheme.textSecondary,
+    };
+    return Text(
+      '$stamp ${entry.level.label.padRight(5)} '
+      '${entry.subsystem.padRight(8)} ${entry.message}',
+      maxLines: 1,
+      overflow: TextOverflow.ellipsis,
+      style: TextStyle(fontFamily: 'monospace', fontSize: 12, color: color),
+    );
+  }
+}
@@ -3,9 +3,6 @@ import 'package:flutter/material.dart';
 import 'package:flutter_riverpod/flutter_riverpod.dart';
 import 'package:file_picker/file_picker.dart';
 import 'package:desktop_drop/desktop_drop.dart';
-import 'package:window_manager/window_manager.dart';
-import 'package:screen_capturer/screen_capturer.dart';
-import 'package:image/image.dart' as img;
 import '../core/extensions/context_extensions.dart';
 import '../core/theme/app_theme.dart';
 import '../core/utils/date_time_utils.dart';
@@ -15,7 +12,9 @@ import '../providers/auth_provider.dart';
 import '../providers/task_provider.dart';
 import '../providers/timer_provider.dart';
 import '../services/api_service.dart';
+import '../services/file_ingest_service.dart';
 import '../services/report_submission_service.dart';
+import '../services/screenshot_capture.dart';
 import '../services/window_service.dart';
 import '../widgets/gradient_button.dart';
 
@@ -280,68 +279,74 @@ class _SubmissionFormScreenState
     int attachmentIndex,
   ) {
     setState(() {
-      _projectTasks[projectId]![taskIndex].attachments
-          .removeAt(attachmentIndex);
+      final taskData = _projectTasks[projectId]![taskIndex];
+      taskData.ingested.remove(
+        taskData.attachments.removeAt(attachmentIndex),
+      );
     });
   }
 
+  /// Attaches dropped files as the ingest service accepts them, so a large
+  /// drop fills in one file at a time. Files already attached, by path or
+  /// by content, are skipped; rejected ones are listed once at the end.
+  Future<void> _ingestDrop(TaskFormData taskData, List<String> paths) async {
+    if (paths.isEmpty) return;
+    final rejected = <String>[];
+    await for (final file in FileIngestService().ingest(paths)) {
+      // Leaving the loop cancels the files not read yet.
+      if (!mounted) return;
+      if (!file.accepted) {
+        rejected.add('${file.name} (${_rejectionReason(file)})');
+        continue;
+      }
+      final duplicate = taskData.attachments.contains(file.path) ||
+          (file.sha256 != null &&
+              taskData.ingested.values.any((f) => f.sha256 == file.sha256));
+      if (duplicate) continue;
+      setState(() {
+        taskData.attachments.add(file.path);
+        taskData.ingested[file.path] = file;
+      });
+    }
+    if (rejected.isNotEmpty && mounted) {
+      context.showErrorSnackBar('Not attached: ${rejected.join(', ')}');
+    }
+  }
+
+  String _rejectionReason(IngestedFile file) {
+    switch (file.status) {
+      case IngestStatus.tooLarge:
+        final limit = file.isImage
+            ? FileIngestService.maxImageBytes
+            : FileIngestService.maxFileBytes;
+        return 'over ${limit ~/ (1024 * 1024)} MB';
+      case IngestStatus.notAFile:
+        return 'not a file';
+      case IngestStatus.missing:
+        return 'not found';
+      default:
+        return 'could not be read';
+    }
+  }
+
   Future<void> _takeScreenshot(
     String projectId,
     int taskIndex,
   ) async {
     try {
-      // Minimize the window before taking screenshot
-      await windowManager.minimize();
-
-      // Wait a moment for the window to minimize
-      await Future.delayed(
-        const Duration(milliseconds: 300),
-      );
-
-      // Use screen_capturer for cross-platform support (Windows, macOS, Linux)
-      CapturedData? capturedData = await screenCapturer
-          .capture(
-            mode: CaptureMode
-                .region, // Interactive region selection
-          );
-
-      // Restore the window after screenshot
-      await windowManager.restore();
-      await windowManager.focus();
-
-      if (capturedData != null &&
-          capturedData.imageBytes != null) {
-        // Convert PNG to JPEG for smaller file size
-        final image = img.decodeImage(capturedData.imageBytes!);
-        if (image == null) {
-          throw Exception('Failed to decode screenshot image');
-        }
-        final jpegBytes = img.encodeJpg(image, quality: 85);
-
-        // Save to temp file
-        final timestamp =
-            DateTime.now().millisecondsSinceEpoch;
-        final tempDir = Directory.systemTemp;
-        final screenshotPath =
-            '${tempDir.path}/screenshot_$timestamp.jpg';
-        final file = File(screenshotPath);
-        await file.writeAsBytes(jpegBytes);
+      final screenshot = await captureScreenshot();
+      if (screenshot == null) return;
 
-        setState(() {
-          _projectTasks[projectId]![taskIndex].attachments
-              .add(screenshotPath);
-        });
-        if (mounted) {
-          context.showSuccessSnackBar(
-            'Screenshot captured',
-          );
-        }
+      setState(() {
+        _projectTasks[projectId]![taskIndex].attachments
+            .add(screenshot.path);
+      });
+      if (mounted) {
+        context.showSuccessSnackBar(
+          'Screenshot captured',
+        );
       }
     } catch (e) {
-      // Make sure to restore window even if there's an error
-      await windowManager.restore();
-      await windowManager.focus();
-
       if (mounted) {
         context.showErrorSnackBar(
           'Error taking screenshot: $e',
@@ -934,17 +939,10 @@ class _SubmissionFormScreenState
     TaskFormData taskData,
   ) {
     return DropTarget(
-      onDragDone: (details) {
-        final List<String> filePaths = [];
-        for (var file in details.files) {
-          filePaths.add(file.path);
-        }
-        if (filePaths.isNotEmpty) {
-          setState(() {
-            taskData.attachments.addAll(filePaths);
-          });
-        }
-      },
+      onDragDone: (details) => _ingestDrop(
+        taskData,
+        details.files.map((file) => file.path).toList(),
+      ),
       onDragEntered: (details) {
         setState(() {
           taskData.isDragging = true;
@@ -1095,7 +1093,8 @@ class _SubmissionFormScreenState
                       final fileName = path
                           .split(Platform.pathSeparator)
                           .last;
-                      final isImage = _isImageFile(path);
+                      final info = taskData.ingested[path];
+                      final isImage = _isImageFile(path, info);
 
                       return MouseRegion(
                         onEnter: isImage
@@ -1138,6 +1137,14 @@ class _SubmissionFormScreenState
                                           fit: BoxFit.cover,
                                           width: 60,
                                           height: 60,
+                                          // Decoded at preview size, not
+                                          // at the photo's full size.
+                                          cacheWidth: _thumbnailDimension(
+                                            info?.thumbnailWidth,
+                                          ),
+                                          cacheHeight: _thumbnailDimension(
+                                            info?.thumbnailHeight,
+                                          ),
                                           errorBuilder:
                                               (
                                                 context,
@@ -1243,7 +1250,9 @@ class _SubmissionFormScreenState
     );
   }
 
-  bool _isImageFile(String path) {
+  /// Prefers what ingesting found in the file over its extension.
+  bool _isImageFile(String path, [IngestedFile? info]) {
+    if (info != null) return info.isImage;
     final extension = path.toLowerCase().split('.').last;
     return [
       'jpg',
@@ -1256,12 +1265,17 @@ class _SubmissionFormScreenState
       'heif',
     ].contains(extension);
   }
+
+  static int? _thumbnailDimension(int? pixels) =>
+      pixels != null && pixels > 0 ? pixels : null;
 }
 
 class TaskFormData {
   final TextEditingController taskNameController;
   final TextEditingController taskDescController;
   final List<String> attachments;
+  // What dropped attachments turned out to be, by path.
+  final Map<String, IngestedFile> ingested = {};
   final Duration duration;
   bool isDragging;
 
@@ -23,7 +23,7 @@ class ApiService {
       ApiService._internal();
   factory ApiService() => _instance;
 
-  final _logger = LoggerService();
+  final _logger = LoggerService.subsystem('api');
   final _storage = StorageService();
   final _tokenCoordinator = TokenRefreshCoordinator();
 
@@ -37,6 +37,12 @@ class ApiService {
     return IOClient(httpClient);
   }
 
+  // Response bodies can be hundreds of KB; only a prefix is worth logging
+  static String _preview(String body, [int maxChars = 512]) {
+    if (body.length <= maxChars) return body;
+    return '${body.substring(0, maxChars)}... (${body.length} chars)';
+  }
+
   // API Configuration - loaded from .env
   static String get baseUrl =>
       dotenv.env['API_BASE_URL'] ?? 'https://app.ssarchitects.ae/api/v1';
@@ -506,7 +512,7 @@ class ApiService {
       final response = await _makeRequest(method: 'GET', uri: uri);
 
       _logger.info('Open entry response status: ${response.statusCode}');
-      _logger.info('Open entry response body: ${response.body}');
+      _logger.debug('Open entry response body: ${_preview(response.body)}');
 
       if (response.statusCode == 200) {
         final data = json.decode(response.body) as Map<String, dynamic>;
@@ -598,7 +604,7 @@ class ApiService {
       final response = await _makeRequest(method: 'GET', uri: uri);
 
       _logger.info('Time entries response status: ${response.statusCode}');
-      _logger.info('Time entries response body: ${response.body}');
+      _logger.debug('Time entries response body: ${_preview(response.body)}');
 
       if (response.statusCode == 200) {
         final data = json.decode(response.body) as Map<String, dynamic>;
@@ -923,7 +929,7 @@ class ApiService {
       final response = await _makeRequest(method: 'POST', uri: uri);
 
       _logger.info('Record biometric response: ${response.statusCode}');
-      _logger.info('Record biometric body: ${response.body}');
+      _logger.debug('Record biometric body: ${_preview(response.body)}');
 
       if (response.statusCode == 200 || response.statusCode == 201) {
         final data = json.decode(response.body) as Map<String, dynamic>;
@@ -1024,7 +1030,7 @@ class ApiService {
       final response = await http.Response.fromStream(streamedResponse);
 
       _logger.info('Create daily report response: ${response.statusCode}');
-      _logger.info('Create daily report body: ${response.body}');
+      _logger.debug('Create daily report body: ${_preview(response.body)}');
 
       if (response.statusCode == 200 || response.statusCode == 201) {
         final data = json.decode(response.body) as Map<String, dynamic>;
@@ -1082,7 +1088,7 @@ class ApiService {
           .timeout(const Duration(seconds: 15));
 
       _logger.info('Pending entries response status: ${response.statusCode}');
-      _logger.info('Pending entries full body: ${response.body}');
+      _logger.debug('Pending entries full body: ${_preview(response.body)}');
 
       if (response.statusCode == 200) {
         final data = json.decode(response.body);
@@ -1555,7 +1561,7 @@ class ApiService {
 
       if (response.statusCode == 200) {
         // Log raw response for debugging
-        _logger.info('Raw API Response: ${response.body}');
+        _logger.debug('Raw API Response: ${_preview(response.body)}');
 
         final data = json.decode(response.body);
 
@@ -0,0 +1,154 @@
+import 'dart:io';
+import 'package:flutter/widgets.dart';
+import 'package:flutter_riverpod/flutter_riverpod.dart';
+import 'package:image/image.dart' as img;
+import 'package:screen_capturer/screen_capturer.dart';
+import 'package:window_manager/window_manager.dart';
+import '../providers/auth_provider.dart';
+import '../providers/window_provider.dart';
+import 'logger_service.dart';
+import 'native_audio_recorder.dart';
+import 'trace_service.dart';
+
+/// Runs the scripted scenarios of the headless Linux benchmark
+/// (scripts/linux_bench.dart), then quits.
+///
+/// Enabled with `--bench` on the command line, next to the runner's
+/// `--trace=PATH`. Every scenario is an async span named `bench: <scenario>`
+/// that ends once the frame showing its result has been drawn; the harness
+/// reads them back from the trace. A scenario that cannot run here leaves a
+/// `bench: <scenario> skipped` instant instead.
+class BenchDriver {
+  static const _flag = '--bench';
+  static const _apiFlag = '--bench-api=';
+  static const _switchesFlag = '--bench-switches=';
+
+  /// Origin of the stand-in API server, e.g. `http://127.0.0.1:8080`.
+  final String? apiOrigin;
+
+  /// Round trips between the main and floating windows.
+  final int modeSwitches;
+
+  final _logger = LoggerService.subsystem('bench');
+  final _trace = TraceService();
+
+  BenchDriver._({this.apiOrigin, this.modeSwitches = 5});
+
+  /// The driver asked for by [args], or null for a normal start.
+  static BenchDriver? fromArguments(List<String> args) {
+    if (!args.contains(_flag)) return null;
+    String? apiOrigin;
+    var modeSwitches = 5;
+    for (final arg in args) {
+      if (arg.startsWith(_apiFlag)) {
+        apiOrigin = arg.substring(_apiFlag.length);
+      } else if (arg.startsWith(_switchesFlag)) {
+        modeSwitches =
+            int.tryParse(arg.substring(_switchesFlag.length)) ?? modeSwitches;
+      }
+    }
+    return BenchDriver._(apiOrigin: apiOrigin, modeSwitches: modeSwitches);
+  }
+
+  /// Settings that replace the bundled `.env` ones, so a run talks only to
+  /// the stand-in server.
+  Map<String, String> get environment => {
+        if (apiOrigin != null) ...{
+          'API_BASE_URL': '$apiOrigin/api/v1',
+          'SOCKET_URL': apiOrigin!,
+        },
+        'GITHUB_REPO': '',
+      };
+
+  Future<void> run(ProviderContainer container) async {
+    _logger.info('Benchmark run started');
+    try {
+      await _settle();
+      await _scenario('login to dashboard', () => _login(container));
+
+      final window = container.read(windowModeProvider.notifier);
+      for (var i = 0; i < modeSwitches; i++) {
+        await _scenario('switch to floating', () async {
+          await window.switchToFloating();
+          return true;
+        });
+        await _scenario('switch to main', () async {
+          await window.switchToMain();
+          return true;
+        });
+      }
+
+      await _scenario('screenshot to attachment', _screenshot);
+      final recorder = NativeAudioRecorder();
+      await _scenario('record start', () async {
+        if (!recorder.isSupported) return false;
+        return recorder.startRecording();
+      });
+      if (recorder.isRecording) {
+        final path = await recorder.stopRecording();
+        if (path != null) await File(path).delete();
+      }
+      _logger.info('Benchmark run finished');
+    } catch (e, stackTrace) {
+      _logger.error('Benchmark run failed', e, stackTrace);
+      _trace.instant('bench: failed');
+    }
+    // Closing the window ends the application, which writes the trace.
+    await windowManager.destroy();
+  }
+
+  /// Times [body] up to the next frame. [body] returns false when the
+  /// scenario cannot run in this environment.
+  Future<void> _scenario(String name, Future<bool> Function() body) async {
+    final ran = await _trace.traceAsync('bench: $name', () async {
+      final ran = await body();
+      await WidgetsBinding.instance.endOfFrame;
+      return ran;
+    });
+    if (!ran) {
+      _logger.warning('Skipped $name');
+      _trace.instant('bench: $name skipped');
+    }
+    await _settle();
+  }
+
+  /// Gives requests, animations and window manager round trips started by
+  /// the last scenario time to finish before the next one is timed.
+  Future<void> _settle() =>
+      Future<void>.delayed(const Duration(milliseconds: 500));
+
+  Future<bool> _login(ProviderContainer container) async {
+    final user = container.read(currentUserProvider.notifier);
+    final token = await user.initiateLogin('bench@example.com');
+    await user.verifyLoginOTP(token, '000000');
+    return true;
+  }
+
+  /// The attachment path of the task forms, without the interactive region
+  /// selection: the whole screen is captured, converted and saved.
+  Future<bool> _screenshot() async {
+    final captured = await _trace.traceAsync(
+      'screenshot: capture',
+      () => screenCapturer.capture(
+        mode: CaptureMode.screen,
+        copyToClipboard: false,
+      ),
+    );
+    final pngBytes = captured?.imageBytes;
+    if (pngBytes == null) return false;
+
+    final image = _trace.traceSync(
+      'screenshot: decode',
+      () => img.decodeImage(pngBytes),
+    );
+    if (image == null) return false;
+    final jpegBytes = _trace.traceSync(
+      'screenshot: encode',
+      () => img.encodeJpg(image, quality: 85),
+    );
+    final file = File('${Directory.systemTemp.path}/bench_screenshot.jpg');
+    await file.writeAsBytes(jpegBytes);
+    await file.delete();
+    return true;
+  }
+}
@@ -0,0 +1,132 @@
+import 'dart:convert';
+import 'dart:ffi';
+import 'dart:io';
+import 'package:ffi/ffi.dart';
+import 'package:flutter/services.dart';
+import '../native/native_stream_bindings.dart';
+import 'logger_service.dart';
+import 'native_record_stream.dart';
+
+/// One finished platform-channel call, from [ChannelMetricsService.calls].
+class ChannelCallEvent {
+  /// `<channel>: <method>`.
+  final String method;
+
+  /// Monotonic clock time the reply was sent.
+  final Duration time;
+
+  final Duration handlerTime;
+  final Duration responseTime;
+  final int requestBytes;
+  final int responseBytes;
+
+  /// 0 success, 1 error, 2 not implemented.
+  final int status;
+
+  const ChannelCallEvent({
+    required this.method,
+    required this.time,
+    required this.handlerTime,
+    required this.responseTime,
+    required this.requestBytes,
+    required this.responseBytes,
+    required this.status,
+  });
+
+  bool get isError => status == 1;
+}
+
+/// Reads platform-channel call metrics collected by the runner (call
+/// counts, handler and response time histograms, payload sizes).
+///
+/// Collection is off by default; it can also be switched on before launch
+/// with the SS_CHANNEL_METRICS=1 environment variable.
+class ChannelMetricsService {
+  static const MethodChannel _channel = MethodChannel(
+    'com.silverstone/diagnostics',
+  );
+
+  static final ChannelMetricsService _instance =
+      ChannelMetricsService._internal();
+  factory ChannelMetricsService() => _instance;
+
+  final _logger = LoggerService.subsystem('channels');
+
+  // Must match SS_CHANNEL_CALL_STREAM in diagnostics_api.h.
+  late final _calls = NativeRecordStream<ChannelCallEvent>(
+    name: 'channel_calls',
+    recordSize: sizeOf<SsChannelCallRecord>(),
+    decode: _decodeCall,
+  );
+  final Map<int, String> _methodNames = {};
+
+  ChannelMetricsService._internal();
+
+  bool get isSupported => Platform.isLinux || Platform.isWindows;
+
+  Future<void> setEnabled(bool enabled) async {
+    if (!isSupported) return;
+
+    try {
+      await _channel.invokeMethod('setEnabled', enabled);
+    } catch (e) {
+      _logger.warning('Could not toggle channel metrics', e);
+    }
+  }
+
+  /// Current metrics, or null if the runner does not provide them. Each
+  /// entry of `methods` has `channel`, `method`, `calls`, `errors` and
+  /// `handler_us` / `response_us` / `request_bytes` / `response_bytes`
+  /// summaries (count, mean, p50, p90, p99, max).
+  Future<Map<String, dynamic>?> getMetrics() async {
+    if (!isSupported) return null;
+
+    try {
+      final json = await _channel.invokeMethod<String>('getChannelMetrics');
+      if (json == null) return null;
+      return jsonDecode(json) as Map<String, dynamic>;
+    } catch (e) {
+      _logger.warning('Could not read channel metrics', e);
+      return null;
+    }
+  }
+
+  Future<void> reset() async {
+    if (!isSupported) return;
+
+    try {
+      await _channel.invokeMethod('reset');
+    } catch (e) {
+      _logger.warning('Could not reset channel metrics', e);
+    }
+  }
+
+  /// Every call as it completes, while collection is enabled, in batches
+  /// of at most one per frame. Linux only; empty elsewhere.
+  Stream<List<ChannelCallEvent>> get calls => Platform.isLinux
+      ? _calls.batches
+      : const Stream<List<ChannelCallEvent>>.empty();
+
+  ChannelCallEvent _decodeCall(Pointer<Uint8> data) {
+    final record = data.cast<SsChannelCallRecord>().ref;
+    return ChannelCallEvent(
+      method: _methodName(record.methodId),
+      time: Duration(microseconds: record.timeUs),
+      handlerTime: Duration(microseconds: record.handlerUs),
+      responseTime: Duration(microseconds: record.responseUs),
+      requestBytes: record.requestBytes,
+      responseBytes: record.responseBytes,
+      status: record.status,
+    );
+  }
+
+  String _methodName(int id) => _methodNames.putIfAbsent(id, () {
+        final bindings = NativeStreamBindings.instance!;
+        return using((arena) {
+          const size = 256;
+          final buffer = arena<Char>(size);
+          final length = bindings.channelMethodName(id, buffer, size);
+          return length < 0 ? '?' : buffer.cast<Utf8>().toDartString();
+        });
+      });
+}
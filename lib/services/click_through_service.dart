@@ -1,21 +1,37 @@
 import 'dart:io';
-import 'package:flutter/services.dart';
+import '../native/fast_messages.g.dart';
+import '../widgets/floating_widget_constants.dart';
+import 'floating_view_service.dart';
 
 /// Service to control click-through behavior on Windows
 /// Uses WS_EX_TRANSPARENT window style to toggle click-through
+///
+/// The floating widget toggles this on every hover change, so it goes
+/// through the binary fast-path channel rather than
+/// `com.worktracker/click_through`, which the runner still serves.
 class ClickThroughService {
-  static const MethodChannel _channel = MethodChannel(
-    'com.worktracker/click_through',
-  );
+  static const _channel = ClickThroughFastChannel();
 
   /// Enable or disable click-through mode for the entire window
   /// When enabled, the window is transparent to mouse events
   /// When disabled, the window receives mouse events normally
   static Future<void> setClickThroughEnabled(bool enabled) async {
+    // On Linux only the floating view's own window can do it: the
+    // collapsed strip keeps the pointer so hovering still expands it.
+    if (Platform.isLinux && FloatingViewService().isAttached) {
+      try {
+        await FloatingViewService().setClickThrough(
+          enabled ? FloatingWidgetConstants.collapsedVisibleWidth : null,
+        );
+      } catch (e) {
+        // Silently ignore errors
+      }
+      return;
+    }
     if (!Platform.isWindows) return;
 
     try {
-      await _channel.invokeMethod('setClickThroughEnabled', enabled);
+      await _channel.setClickThroughEnabled(enabled);
     } catch (e) {
       // Silently ignore errors
     }
@@ -38,7 +54,7 @@ class ClickThroughService {
     if (!Platform.isWindows) return;
 
     try {
-      await _channel.invokeMethod('restoreNormalWindowStyle');
+      await _channel.restoreNormalWindowStyle();
     } catch (e) {
       // Silently ignore errors
     }
@@ -51,7 +67,7 @@ class ClickThroughService {
     if (!Platform.isWindows) return;
 
     try {
-      await _channel.invokeMethod('setFrameless', frameless);
+      await _channel.setFrameless(frameless);
     } catch (e) {
       // Silently ignore errors
     }
@@ -0,0 +1,171 @@
+import 'dart:ffi';
+import 'dart:io';
+import 'dart:isolate';
+import 'package:ffi/ffi.dart';
+import 'package:path_provider/path_provider.dart';
+import '../models/app_version_info.dart';
+import '../native/native_update_bindings.dart';
+import 'logger_service.dart';
+import 'resumable_download.dart';
+
+enum DeltaUpdatePhase { downloading, verifying, installing }
+
+/// Progress of [DeltaUpdateService.stage].
+class DeltaUpdateProgress {
+  final DeltaUpdatePhase phase;
+  final int received;
+  final int total;
+
+  const DeltaUpdateProgress(this.phase, {this.received = 0, this.total = 0});
+
+  /// Download fraction, or null while it cannot be known.
+  double? get fraction =>
+      phase == DeltaUpdatePhase.downloading && total > 0
+          ? (received / total).clamp(0.0, 1.0)
+          : null;
+}
+
+/// Updates the Linux bundle in place from a binary delta release asset.
+///
+/// The patch is downloaded in the background (resuming where a previous
+/// attempt stopped) and checked against the SHA-256 GitHub publishes for the
+/// asset. Native code then rebuilds the new bundle next to the installed one
+/// and checks every file against the digests in the patch.
+/// Nothing in the running bundle changes: the runner swaps the staged copy in
+/// when the app next starts (linux/runner/update_launcher.cc).
+class DeltaUpdateService {
+  static final DeltaUpdateService _instance = DeltaUpdateService._internal();
+  factory DeltaUpdateService() => _instance;
+
+  final _logger = LoggerService.subsystem('update');
+
+  DeltaUpdateService._internal();
+
+  bool get isSupported =>
+      Platform.isLinux && NativeUpdateBindings.instance != null;
+
+  /// Whether [info] can be installed with [stage] rather than the browser.
+  /// Patches without a published digest are left to the browser.
+  bool canStage(AppVersionInfo info) =>
+      isSupported && info.linuxPatch?.sha256 != null;
+
+  /// Downloads, verifies and stages the update described by [info]. Throws
+  /// if any step fails; the installed bundle is untouched either way.
+  Future<void> stage(
+    AppVersionInfo info, {
+    void Function(DeltaUpdateProgress progress)? onProgress,
+  }) async {
+    final patch = info.linuxPatch;
+    if (patch == null || !isSupported) {
+      throw UnsupportedError('No delta update for this installation');
+    }
+    final expected = patch.sha256;
+    if (expected == null) {
+      throw StateError('Update has no published SHA-256');
+    }
+
+    final supportDir = await getApplicationSupportDirectory();
+    final uri = Uri.parse(patch.url);
+    final file = File(
+        '${supportDir.path}/updates/${uri.pathSegments.last}');
+    final started = DateTime.now();
+    final download = ResumableDownload(
+      url: uri,
+      target: file,
+      expectedSize: patch.size > 0 ? patch.size : null,
+    );
+    final DateTime downloaded;
+    final ({String? error, int patchBytes, int targetBytes}) result;
+    try {
+      if (!await file.exists()) {
+        await download.run(
+          onProgress: (received, total) => onProgress?.call(
+            DeltaUpdateProgress(DeltaUpdatePhase.downloading,
+                received: received, total: total),
+          ),
+        );
+      }
+      downloaded = DateTime.now();
+      result = await _install(file, expected, info.latestVersion, onProgress);
+    } catch (_) {
+      // A patch that got this far fails the same way on every retry; fetch
+      // it again next time. An interrupted download is kept to resume.
+      if (await file.exists()) await download.discard();
+      rethrow;
+    } finally {
+      download.close();
+    }
+    await file.delete();
+
+    _logger.info('Staged ${info.latestVersion}: ${result.patchBytes} byte '
+        'patch, ${result.targetBytes} byte bundle; download '
+        '${downloaded.difference(started).inMilliseconds} ms, install '
+        '${DateTime.now().difference(downloaded).inMilliseconds} ms');
+  }
+
+  /// Checks the downloaded [file] against [expected], then stages it.
+  Future<({String? error, int patchBytes, int targetBytes})> _install(
+    File file,
+    String expected,
+    String version,
+    void Function(DeltaUpdateProgress progress)? onProgress,
+  ) async {
+    onProgress?.call(const DeltaUpdateProgress(DeltaUpdatePhase.verifying));
+    final patchPath = file.path;
+    final actual = await Isolate.run(() => _hashFile(patchPath));
+    if (actual != expected) {
+      throw StateError('Downloaded update is corrupt ($actual != $expected)');
+    }
+
+    onProgress?.call(const DeltaUpdateProgress(DeltaUpdatePhase.installing));
+    final bundleRoot = File(Platform.resolvedExecutable).parent.path;
+    final threads = Platform.numberOfProcessors;
+    final result = await Isolate.run(
+        () => _stagePatch(bundleRoot, patchPath, version, threads));
+    if (result.error != null) {
+      throw StateError('Could not install update: ${result.error}');
+    }
+    return result;
+  }
+
+  /// Starts a new instance, which applies the staged update, and exits.
+  Future<Never> restart() async {
+    await Process.start(Platform.resolvedExecutable, const [],
+        mode: ProcessStartMode.detached);
+    exit(0);
+  }
+
+  static String? _hashFile(String path) {
+    final bindings = NativeUpdateBindings.instance!;
+    return using((arena) {
+      final hex = arena<Char>(65);
+      final ok = bindings.hashFile(
+          path.toNativeUtf8(allocator: arena).cast(), hex);
+      return ok ? hex.cast<Utf8>().toDartString() : null;
+    });
+  }
+
+  static ({String? error, int patchBytes, int targetBytes}) _stagePatch(
+      String bundleRoot, String patchPath, String version, int threads) {
+    final bindings = NativeUpdateBindings.instance!;
+    return using((arena) {
+      final stats = arena<SsBundlePatchStats>();
+      const errorSize = 512;
+      final error = arena<Char>(errorSize);
+      final ok = bindings.stagePatch(
+        bundleRoot.toNativeUtf8(allocator: arena).cast(),
+        patchPath.toNativeUtf8(allocator: arena).cast(),
+        version.toNativeUtf8(allocator: arena).cast(),
+        threads,
+        stats,
+        error,
+        errorSize,
+      );
+      return (
+        error: ok ? null : error.cast<Utf8>().toDartString(),
+        patchBytes: stats.ref.patchBytes,
+        targetBytes: stats.ref.targetBytes,
+      );
+    });
+  }
+}
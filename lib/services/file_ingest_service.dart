@@ -0,0 +1,206 @@
+import 'dart:async';
+import 'dart:io';
+import 'dart:typed_data';
+import 'package:flutter/services.dart';
+import 'logger_service.dart';
+
+/// Why a dropped file was or was not accepted. Same values as IngestStatus
+/// in linux/native/ingest/file_ingest.h.
+enum IngestStatus { ok, missing, notAFile, tooLarge, unreadable, cancelled }
+
+/// What a dropped file turned out to be.
+class IngestedFile {
+  final String path;
+  final IngestStatus status;
+  final String mimeType;
+  final int size;
+
+  /// Pixels, when the image header could be read; 0 otherwise.
+  final int width;
+  final int height;
+
+  /// Size to decode the preview at (see [Image.file]'s cacheWidth), or 0
+  /// when there is none.
+  final int thumbnailWidth;
+  final int thumbnailHeight;
+
+  /// PDF pages, when they could be counted.
+  final int pages;
+
+  /// Lowercase hex SHA-256 of the content; null when it was not read.
+  final String? sha256;
+
+  const IngestedFile({
+    required this.path,
+    required this.status,
+    required this.mimeType,
+    required this.size,
+    this.width = 0,
+    this.height = 0,
+    this.thumbnailWidth = 0,
+    this.thumbnailHeight = 0,
+    this.pages = 0,
+    this.sha256,
+  });
+
+  bool get accepted => status == IngestStatus.ok;
+  bool get isImage => mimeType.startsWith('image/');
+  String get name => path.split(Platform.pathSeparator).last;
+}
+
+/// Works out what files dropped on the dialogs are before they are
+/// attached.
+///
+/// On Linux the runner does it (linux/runner/drop_ingest.h): each file is
+/// typed from its magic bytes, checked against the limit for that type,
+/// hashed and measured on the native worker pool, and results stream back
+/// as files finish, so a drop of large drawings shows its first files
+/// while the rest are still being read. Elsewhere, or without the runner
+/// channel, files are typed by extension from a stat and not hashed.
+class FileIngestService {
+  static final FileIngestService _instance = FileIngestService._internal();
+  factory FileIngestService() => _instance;
+
+  static const maxImageBytes = 20 * 1024 * 1024;
+  static const maxFileBytes = 50 * 1024 * 1024;
+
+  /// Previews are decoded to fit this square; twice the 60 px tiles so
+  /// they stay sharp on HiDPI screens.
+  static const thumbnailSize = 120;
+
+  static const _channel = MethodChannel('com.silverstone/ingest');
+  static const _imageTypes = {
+    'png': 'image/png',
+    'jpg': 'image/jpeg',
+    'jpeg': 'image/jpeg',
+    'gif': 'image/gif',
+    'bmp': 'image/bmp',
+    'webp': 'image/webp',
+    'heic': 'image/heif',
+    'heif': 'image/heif',
+  };
+
+  final _logger = LoggerService.subsystem('ingest');
+  bool _native = Platform.isLinux;
+  bool _handlerSet = false;
+  int _nextId = 0;
+  final _drops = <int, _Drop>{};
+
+  FileIngestService._internal();
+
+  /// Results for [paths] in the order they finish. Cancelling the
+  /// subscription stops reading the rest.
+  Stream<IngestedFile> ingest(List<String> paths) {
+    if (paths.isEmpty) return const Stream.empty();
+    if (!_native) return _ingestInDart(paths);
+
+    final id = _nextId++;
+    late final StreamController<IngestedFile> controller;
+    controller = StreamController<IngestedFile>(
+      onListen: () => _start(id, paths, controller),
+      onCancel: () {
+        if (_drops.remove(id) != null) {
+          _channel.invokeMethod('cancel', {'id': id}).ignore();
+        }
+      },
+    );
+    return controller.stream;
+  }
+
+  Future<void> _start(
+    int id,
+    List<String> paths,
+    StreamController<IngestedFile> controller,
+  ) async {
+    if (!_handlerSet) {
+      _channel.setMethodCallHandler(_onCall);
+      _handlerSet = true;
+    }
+    _drops[id] = _Drop(paths, controller);
+    try {
+      await _channel.invokeMethod('start', {
+        'id': id,
+        'paths': paths,
+        'maxImageBytes': maxImageBytes,
+        'maxFileBytes': maxFileBytes,
+        'thumbnailSize': thumbnailSize,
+      });
+      return;
+    } on MissingPluginException {
+      _native = false;
+    } on PlatformException catch (e) {
+      _native = false;
+      _logger.warning('Native ingest unavailable: ${e.message}');
+    }
+    if (_drops.remove(id) == null) return;
+    await controller.addStream(_ingestInDart(paths));
+    await controller.close();
+  }
+
+  Future<void> _onCall(MethodCall call) async {
+    if (call.method != 'results') return;
+    final args = call.arguments as Map;
+    final id = args['id'] as int;
+    final drop = _drops[id];
+    if (drop == null) return;
+    for (final result in (args['results'] as List).cast<Map>()) {
+      drop.controller.add(_fromNative(drop.paths, result));
+    }
+    if (args['done'] == true) {
+      _drops.remove(id);
+      drop.controller.close();
+    }
+  }
+
+  static IngestedFile _fromNative(List<String> paths, Map result) {
+    final digest = result['sha256'] as Uint8List?;
+    return IngestedFile(
+      path: paths[result['index'] as int],
+      status: IngestStatus.values[result['status'] as int],
+      mimeType: result['mime'] as String,
+      size: result['size'] as int,
+      width: result['width'] as int,
+      height: result['height'] as int,
+      thumbnailWidth: result['thumbnailWidth'] as int,
+      thumbnailHeight: result['thumbnailHeight'] as int,
+      pages: result['pages'] as int,
+      sha256: digest
+          ?.map((byte) => byte.toRadixString(16).padLeft(2, '0'))
+          .join(),
+    );
+  }
+
+  Stream<IngestedFile> _ingestInDart(List<String> paths) =>
+      Stream.fromFutures(paths.map(_statFile));
+
+  static Future<IngestedFile> _statFile(String path) async {
+    final extension = path.toLowerCase().split('.').last;
+    final mimeType = _imageTypes[extension] ??
+        (extension == 'pdf' ? 'application/pdf' : 'application/octet-stream');
+    final stat = await FileStat.stat(path);
+    final IngestStatus status;
+    if (stat.type == FileSystemEntityType.notFound) {
+      status = IngestStatus.missing;
+    } else if (stat.type != FileSystemEntityType.file) {
+      status = IngestStatus.notAFile;
+    } else if (stat.size >
+        (mimeType.startsWith('image/') ? maxImageBytes : maxFileBytes)) {
+      status = IngestStatus.tooLarge;
+    } else {
+      status = IngestStatus.ok;
+    }
+    return IngestedFile(
+      path: path,
+      status: status,
+      mimeType: mimeType,
+      size: stat.size < 0 ? 0 : stat.size,
+    );
+  }
+}
+
+class _Drop {
+  final List<String> paths;
+  final StreamController<IngestedFile> controller;
+
+  _Drop(this.paths, this.controller);
+}
@@ -0,0 +1,93 @@
+import 'dart:io';
+import 'dart:ui';
+import 'package:flutter/services.dart';
+import 'logger_service.dart';
+
+/// The runner's second view for the floating widget (Linux only; see
+/// linux/runner/floating_view.h).
+///
+/// The floating window exists from startup, hidden, on the same engine as
+/// the main one. Switching modes is then [show] or [hide], a single map and
+/// unmap in the runner, instead of the resize, restyle and reposition
+/// sequence [WindowService] runs on the one window elsewhere.
+class FloatingViewService {
+  static final FloatingViewService _instance = FloatingViewService._internal();
+  factory FloatingViewService() => _instance;
+
+  static const _channel = MethodChannel('com.silverstone/floating_view');
+
+  final _logger = LoggerService.subsystem('window');
+  FlutterView? _view;
+
+  FloatingViewService._internal();
+
+  /// Set once [attach] has found the view.
+  FlutterView? get view => _view;
+  bool get isAttached => _view != null;
+
+  /// Looks up the runner's floating view. Returns null when there is none,
+  /// in which case the floating widget shares the main window as before.
+  Future<FlutterView?> attach() async {
+    if (!Platform.isLinux) return null;
+    final int? id;
+    try {
+      id = await _channel.invokeMethod<int>('viewId');
+    } on MissingPluginException {
+      return null;
+    } on PlatformException catch (e) {
+      _logger.warning('No floating view: ${e.message}');
+      return null;
+    }
+    if (id == null) return null;
+    // The engine reports a new view with its first metrics, which can come
+    // a moment after the runner created it.
+    for (var i = 0; i < 40; i++) {
+      final view = PlatformDispatcher.instance.view(id: id);
+      if (view != null) {
+        _logger.info('Floating widget in view $id');
+        return _view = view;
+      }
+      await Future<void>.delayed(const Duration(milliseconds: 25));
+    }
+    _logger.warning('Floating view $id never appeared');
+    return null;
+  }
+
+  /// Maps the floating window, then hides the main one.
+  Future<void> show() => _channel.invokeMethod('show');
+
+  /// Shows and focuses the main window, then hides the floating one.
+  Future<void> hide() => _channel.invokeMethod('hide');
+
+  /// The floating window's position and size in logical pixels.
+  Future<Rect> getFrame() async {
+    final frame = (await _channel.invokeMapMethod<String, double>(
+      'getFrame',
+    ))!;
+    return Rect.fromLTWH(
+      frame['x']!,
+      frame['y']!,
+      frame['width']!,
+      frame['height']!,
+    );
+  }
+
+  Future<void> setSize(Size size) => _channel.invokeMethod('setSize', {
+        'width': size.width,
+        'height': size.height,
+      });
+
+  Future<void> setPosition(Offset position) =>
+      _channel.invokeMethod('setPosition', {
+        'x': position.dx,
+        'y': position.dy,
+      });
+
+  /// Lets pointer events through all but the rightmost [visibleWidth]
+  /// pixels of the floating window, or none of it when null. An input
+  /// region rather than per-event hit testing, so nothing has to poll.
+  Future<void> setClickThrough(double? visibleWidth) =>
+      _channel.invokeMethod('setClickThrough', {
+        if (visibleWidth != null) 'visibleWidth': visibleWidth,
+      });
+}
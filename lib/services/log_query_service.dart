@@ -0,0 +1,134 @@
+import 'dart:async';
+import 'dart:ffi';
+import 'package:ffi/ffi.dart';
+import '../native/native_log_bindings.dart';
+import 'logger_service.dart';
+
+/// Severity as stored in the native log. The index matches `LogLevel` in
+/// linux/native/logging/log_record.h.
+enum LogEntryLevel {
+  trace('TRACE'),
+  debug('DEBUG'),
+  info('INFO'),
+  warning('WARN'),
+  error('ERROR'),
+  fatal('FATAL');
+
+  const LogEntryLevel(this.label);
+
+  final String label;
+}
+
+/// One record read back from the persistent log.
+class LogEntry {
+  final DateTime timestamp;
+  final LogEntryLevel level;
+  final String subsystem;
+  final String message;
+  final int threadId;
+  final bool truncated;
+
+  const LogEntry({
+    required this.timestamp,
+    required this.level,
+    required this.subsystem,
+    required this.message,
+    required this.threadId,
+    required this.truncated,
+  });
+}
+
+/// Reads the persistent log archive through the native query engine.
+///
+/// The engine skips archived segments and blocks using their index, so a
+/// narrow query over weeks of logs only inflates what can match.
+class LogQueryService {
+  static final LogQueryService _instance = LogQueryService._internal();
+  factory LogQueryService() => _instance;
+
+  final _logger = LoggerService.subsystem('logs');
+
+  // Entries copied out of native memory per FFI call.
+  static const _batchSize = 256;
+
+  LogQueryService._internal();
+
+  bool get isAvailable =>
+      NativeLogBindings.instance != null &&
+      LoggerService.nativeLogDirectory != null;
+
+  /// Streams matching entries, oldest first, in batches. Cancelling the
+  /// subscription stops the query.
+  Stream<List<LogEntry>> query({
+    DateTime? from,
+    DateTime? to,
+    LogEntryLevel minLevel = LogEntryLevel.trace,
+    List<String> subsystems = const [],
+    String text = '',
+    int limit = 5000,
+  }) async* {
+    final bindings = NativeLogBindings.instance;
+    final directory = LoggerService.nativeLogDirectory;
+    if (bindings == null || directory == null) {
+      throw UnsupportedError('The native log is not available');
+    }
+
+    // Include whatever is still buffered in memory.
+    bindings.flush();
+
+    final handle = using((arena) {
+      final filter = arena<SsLogQueryFilter>();
+      filter.ref.fromUs = from?.microsecondsSinceEpoch ?? 0;
+      filter.ref.toUs = to?.microsecondsSinceEpoch ?? 0;
+      filter.ref.minLevel = minLevel.index;
+      filter.ref.subsystems =
+          subsystems.join(',').toNativeUtf8(allocator: arena).cast();
+      filter.ref.text = text.toNativeUtf8(allocator: arena).cast();
+      return bindings.queryOpen(
+          directory.toNativeUtf8(allocator: arena).cast(), filter);
+    });
+    if (handle == nullptr) {
+      throw StateError('Could not open the log directory');
+    }
+
+    final entries = malloc<SsLogEntry>(_batchSize);
+    final stopwatch = Stopwatch()..start();
+    var total = 0;
+    try {
+      while (total < limit) {
+        final count = bindings.queryNext(handle, entries, _batchSize);
+        if (count == 0) break;
+
+        final batch = <LogEntry>[];
+        for (var i = 0; i < count && total < limit; i++, total++) {
+          final entry = entries[i];
+          batch.add(LogEntry(
+            timestamp:
+                DateTime.fromMicrosecondsSinceEpoch(entry.timestampUs),
+            level: LogEntryLevel.values[entry.level],
+            subsystem: entry.subsystem.toDartString(),
+            message: entry.message.toDartString(),
+            threadId: entry.threadId,
+            truncated: entry.truncated != 0,
+          ));
+        }
+        yield batch;
+        // Let the UI paint between batches.
+        await Future<void>.delayed(Duration.zero);
+      }
+
+      final stats = calloc<SsLogQueryStats>();
+      bindings.queryGetStats(handle, stats);
+      _logger.debug(
+          'Log query matched ${stats.ref.recordsMatched} of '
+          '${stats.ref.recordsScanned} records in '
+          '${stopwatch.elapsedMilliseconds} ms '
+          '(${stats.ref.segmentsSkipped}/${stats.ref.segments} segments '
+          'skipped by index)');
+      calloc.free(stats);
+    } finally {
+      malloc.free(entries);
+      bindings.queryClose(handle);
+    }
+  }
+}
@@ -1,46 +1,167 @@
+import 'dart:convert';
+import 'dart:ffi';
+import 'package:ffi/ffi.dart';
+import 'package:flutter/foundation.dart';
 import 'package:logger/logger.dart';
+import 'package:path_provider/path_provider.dart';
+import '../native/native_log_bindings.dart';
 
 class LoggerService {
-  static final LoggerService _instance = LoggerService._internal();
+  static final LoggerService _instance = LoggerService._internal('app');
+  static final Map<String, LoggerService> _subsystems = {};
   factory LoggerService() => _instance;
 
-  late Logger _logger;
-
-  LoggerService._internal() {
-    _logger = Logger(
-      printer: PrettyPrinter(
-        methodCount: 2,
-        errorMethodCount: 8,
-        lineLength: 120,
-        colors: true,
-        printEmojis: true,
-        printTime: true,
-      ),
-    );
+  /// Logger whose records are tagged with [name] in the persistent log, so
+  /// support can filter by area (e.g. 'api', 'timer', 'window').
+  factory LoggerService.subsystem(String name) =>
+      _subsystems.putIfAbsent(name, () => LoggerService._internal(name));
+
+  // Console output for development. Release builds rely on the native sink.
+  static final Logger _logger = Logger(
+    printer: PrettyPrinter(
+      methodCount: 2,
+      errorMethodCount: 8,
+      lineLength: 120,
+      colors: true,
+      printEmojis: true,
+      printTime: true,
+    ),
+  );
+
+  // Persistent binary log (linux/native/logging), once attached.
+  static NativeLogBindings? _native;
+  static String? _nativeLogDirectory;
+
+  // The level the native log was opened with. Records below it would be
+  // dropped there, after all the formatting and encoding, so they are
+  // dropped here first.
+  static int _nativeMinLevel = NativeLogLevel.info;
+
+  /// Directory of the persistent log, or null when it is not attached.
+  static String? get nativeLogDirectory => _nativeLogDirectory;
+
+  // Messages are encoded into this buffer instead of allocating per call.
+  static const _scratchBytes = 2048;
+  static Pointer<Uint8>? _scratch;
+
+  final String _subsystem;
+  int _subsystemId = 0;
+
+  LoggerService._internal(this._subsystem);
+
+  /// Opens the rotating binary log under the app support directory. Safe to
+  /// call on platforms without the native library; logging then stays on
+  /// the console only.
+  static Future<void> attachNativeSink() async {
+    final bindings = NativeLogBindings.instance;
+    if (bindings == null || _native != null) return;
+
+    final supportDir = await getApplicationSupportDirectory();
+    final directory = '${supportDir.path}/logs';
+    final minLevel = kDebugMode ? NativeLogLevel.debug : NativeLogLevel.info;
+    final opened = using((arena) {
+      final config = arena<SsLogConfig>();
+      config.ref.directory = directory.toNativeUtf8(allocator: arena).cast();
+      config.ref.minLevel = minLevel;
+      // Remaining fields stay zero and take the native defaults.
+      return bindings.open(config);
+    });
+    if (!opened) {
+      _instance.warning('Could not open the native log in ${supportDir.path}');
+      return;
+    }
+
+    _scratch = malloc<Uint8>(_scratchBytes);
+    _nativeMinLevel = minLevel;
+    _native = bindings;
+    _nativeLogDirectory = directory;
+  }
+
+  /// Waits until everything logged so far has reached the log file.
+  static void flushNativeSink() => _native?.flush();
+
+  void _write(int level, dynamic message, dynamic error,
+      StackTrace? stackTrace) {
+    final native = _native;
+    if (native == null || level < _nativeMinLevel) return;
+
+    if (_subsystemId == 0) {
+      _subsystemId = using((arena) =>
+          native.intern(_subsystem.toNativeUtf8(allocator: arena).cast()));
+    }
+
+    var text = message.toString();
+    if (error != null) {
+      text = '$text | $error';
+    }
+    if (stackTrace != null) {
+      // The first frames identify the call site; the rest is noise on disk.
+      text = '$text\n${stackTrace.toString().split('\n').take(8).join('\n')}';
+    }
+    // The native side truncates long payloads anyway; avoid encoding them.
+    // Both cuts fall between characters, never inside a surrogate pair or
+    // a UTF-8 sequence.
+    var end = _scratchBytes ~/ 2;
+    if (text.length > end) {
+      final unit = text.codeUnitAt(end);
+      if (unit >= 0xDC00 && unit <= 0xDFFF) {
+        end--;
+      }
+      text = text.substring(0, end);
+    }
+
+    final bytes = utf8.encode(text);
+    var length = bytes.length;
+    if (length > _scratchBytes) {
+      length = _scratchBytes;
+      while (length > 0 && (bytes[length] & 0xC0) == 0x80) {
+        length--;
+      }
+    }
+    final scratch = _scratch!;
+    scratch.asTypedList(_scratchBytes).setRange(0, length, bytes);
+    native.message(level, _subsystemId, scratch, length);
   }
 
+  bool get _useConsole => kDebugMode || _native == null;
+
   // Debug log
   void debug(dynamic message, [dynamic error, StackTrace? stackTrace]) {
-    _logger.d(message, error: error, stackTrace: stackTrace);
+    _write(NativeLogLevel.debug, message, error, stackTrace);
+    if (_useConsole) {
+      _logger.d(message, error: error, stackTrace: stackTrace);
+    }
   }
 
   // Info log
   void info(dynamic message, [dynamic error, StackTrace? stackTrace]) {
-    _logger.i(message, error: error, stackTrace: stackTrace);
+    _write(NativeLogLevel.info, message, error, stackTrace);
+    if (_useConsole) {
+      _logger.i(message, error: error, stackTrace: stackTrace);
+    }
   }
 
   // Warning log
   void warning(dynamic message, [dynamic error, StackTrace? stackTrace]) {
-    _logger.w(message, error: error, stackTrace: stackTrace);
+    _write(NativeLogLevel.warning, message, error, stackTrace);
+    if (_useConsole) {
+      _logger.w(message, error: error, stackTrace: stackTrace);
+    }
   }
 
   // Error log
   void error(dynamic message, [dynamic error, StackTrace? stackTrace]) {
-    _logger.e(message, error: error, stackTrace: stackTrace);
+    _write(NativeLogLevel.error, message, error, stackTrace);
+    if (_useConsole) {
+      _logger.e(message, error: error, stackTrace: stackTrace);
+    }
   }
 
   // Fatal/critical log
   void fatal(dynamic message, [dynamic error, StackTrace? stackTrace]) {
-    _logger.f(message, error: error, stackTrace: stackTrace);
+    _write(NativeLogLevel.fatal, message, error, stackTrace);
+    if (_useConsole) {
+      _logger.f(message, error: error, stackTrace: stackTrace);
+    }
   }
 }
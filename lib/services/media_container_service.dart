@@ -0,0 +1,114 @@
+import 'dart:ffi';
+import 'dart:io';
+import 'dart:isolate';
+import 'package:ffi/ffi.dart';
+import '../native/native_media_bindings.dart';
+import 'logger_service.dart';
+
+/// What [MediaContainerService.prepareForUpload] found in a recording.
+class Mp4Summary {
+  final Duration duration;
+
+  /// Sample entry of the audio track, e.g. `mp4a`.
+  final String codec;
+  final int sampleRate;
+  final int channels;
+  final int sampleCount;
+
+  /// Whether the file had to be rewritten with its index first.
+  final bool rewritten;
+
+  const Mp4Summary({
+    required this.duration,
+    required this.codec,
+    required this.sampleRate,
+    required this.channels,
+    required this.sampleCount,
+    required this.rewritten,
+  });
+}
+
+/// Checks MP4/M4A recordings before they are uploaded.
+///
+/// On Linux native code (linux/native/media/) reads the container without
+/// decoding it: a recording cut short, with no index or with chunks past
+/// the end of the file, is refused here instead of by the server after the
+/// whole upload. Files with the index (moov) after the audio are rewritten
+/// in place with it first, so the server can start on them as they arrive.
+/// The Windows runner moves the index first itself when a recording stops
+/// (windows/runner/audio_recorder_plugin.cpp), with the same code; elsewhere
+/// files are uploaded as they are.
+class MediaContainerService {
+  static final MediaContainerService _instance =
+      MediaContainerService._internal();
+  factory MediaContainerService() => _instance;
+
+  final _logger = LoggerService.subsystem('media');
+
+  MediaContainerService._internal();
+
+  static const _extensions = {'m4a', 'mp4', 'mov'};
+
+  bool get isSupported =>
+      Platform.isLinux && NativeMediaBindings.instance != null;
+
+  /// Inspects [file] and moves its index first. Returns null for files it
+  /// does not handle; throws a [FormatException] for a damaged one.
+  Future<Mp4Summary?> prepareForUpload(File file) async {
+    final extension = file.path.split('.').last.toLowerCase();
+    if (!isSupported || !_extensions.contains(extension)) return null;
+
+    final path = file.path;
+    final started = DateTime.now();
+    final result = await Isolate.run(() => _prepare(path));
+    if (result.error != null) {
+      throw FormatException('Recording is damaged: ${result.error}');
+    }
+    final summary = result.summary!;
+    _logger.info('${file.path}: ${summary.duration.inMilliseconds} ms of '
+        '${summary.codec} at ${summary.sampleRate} Hz, '
+        '${summary.channels} ch, ${summary.sampleCount} samples; '
+        '${summary.rewritten ? 'moved index first' : 'index already first'} '
+        'in ${DateTime.now().difference(started).inMilliseconds} ms');
+    return summary;
+  }
+
+  // Same values as FaststartResult in linux/native/media/mp4_faststart.h.
+  static const _rewritten = 0;
+  static const _failed = 2;
+
+  static ({String? error, Mp4Summary? summary}) _prepare(String path) {
+    final bindings = NativeMediaBindings.instance!;
+    return using((arena) {
+      final nativePath = path.toNativeUtf8(allocator: arena).cast<Char>();
+      final info = arena<SsMp4Info>();
+      const errorSize = 256;
+      final error = arena<Char>(errorSize);
+      if (!bindings.inspect(nativePath, info, error, errorSize)) {
+        return (error: error.cast<Utf8>().toDartString(), summary: null);
+      }
+      var rewritten = false;
+      if (!info.ref.faststart && !info.ref.fragmented) {
+        final result = bindings.faststart(nativePath, error, errorSize);
+        if (result == _failed) {
+          return (error: error.cast<Utf8>().toDartString(), summary: null);
+        }
+        rewritten = result == _rewritten;
+      }
+      return (
+        error: null,
+        summary: Mp4Summary(
+          duration: Duration(microseconds: info.ref.durationUs),
+          codec: _fourcc(info.ref.codec),
+          sampleRate: info.ref.sampleRate,
+          channels: info.ref.channels,
+          sampleCount: info.ref.sampleCount,
+          rewritten: rewritten,
+        ),
+      );
+    });
+  }
+
+  static String _fourcc(int code) => String.fromCharCodes(
+      [for (var shift = 24; shift >= 0; shift -= 8) (code >> shift) & 0xff]);
+}
@@ -0,0 +1,28 @@
+import 'dart:io';
+import '../native/native_memory_bindings.dart';
+import 'logger_service.dart';
+
+/// Tells the runner's memory manager when the app sits idle in floating
+/// mode, which it treats like a hidden window: after a short grace period
+/// Flutter's image cache is cleared and native and heap memory is handed
+/// back (linux/runner/memory_control.cc).
+///
+/// Minimizing and hiding to the tray are seen by the runner itself. Linux
+/// only; elsewhere this does nothing.
+class MemoryService {
+  static final MemoryService _instance = MemoryService._internal();
+  factory MemoryService() => _instance;
+
+  final _logger = LoggerService.subsystem('memory');
+  final NativeMemoryBindings? _bindings =
+      Platform.isLinux ? NativeMemoryBindings.instance : null;
+
+  MemoryService._internal();
+
+  void setIdle(bool idle) {
+    final bindings = _bindings;
+    if (bindings == null) return;
+    bindings.setIdle(idle);
+    _logger.debug(idle ? 'Idle in floating mode' : 'Active again');
+  }
+}
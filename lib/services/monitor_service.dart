@@ -0,0 +1,153 @@
+import 'dart:async';
+import 'dart:io';
+import 'dart:ui';
+import 'package:flutter/services.dart';
+import 'package:screen_retriever/screen_retriever.dart';
+import 'logger_service.dart';
+
+/// One monitor, in logical pixels on the whole desktop.
+class MonitorInfo {
+  final Rect geometry;
+
+  /// The part not taken by panels and docks.
+  final Rect workArea;
+  final int scaleFactor;
+  final bool primary;
+  final String model;
+
+  const MonitorInfo({
+    required this.geometry,
+    required this.workArea,
+    this.scaleFactor = 1,
+    this.primary = false,
+    this.model = '',
+  });
+}
+
+/// Where the monitors are, for placing the floating widget.
+///
+/// On Linux the runner keeps the layout (linux/runner/display_monitors.h)
+/// and pushes it here when a monitor is plugged, unplugged or rearranged,
+/// so reading it costs nothing and [changes] fires without polling.
+/// Clamping and snapping are a single call into the runner. Elsewhere it
+/// asks screen_retriever each time, as before.
+class MonitorService {
+  static final MonitorService _instance = MonitorService._internal();
+  factory MonitorService() => _instance;
+
+  static const _channel = MethodChannel('com.silverstone/monitors');
+
+  final _logger = LoggerService.subsystem('window');
+  final _changes = StreamController<List<MonitorInfo>>.broadcast();
+  bool _native = Platform.isLinux;
+  Future<void>? _started;
+  List<MonitorInfo> _monitors = const [];
+  int _generation = -1;
+
+  MonitorService._internal();
+
+  /// The new layout, each time it changes. Only on Linux.
+  Stream<List<MonitorInfo>> get changes {
+    _start();
+    return _changes.stream;
+  }
+
+  Future<List<MonitorInfo>> monitors() async {
+    await _start();
+    if (_native) return _monitors;
+    final primary = await _primaryDisplaySize();
+    return [
+      MonitorInfo(
+        geometry: Offset.zero & primary,
+        workArea: Offset.zero & primary,
+        primary: true,
+      ),
+    ];
+  }
+
+  /// The primary monitor's work area.
+  Future<Rect> primaryWorkArea() async {
+    final all = await monitors();
+    if (all.isEmpty) return Offset.zero & await _primaryDisplaySize();
+    return all
+        .firstWhere((monitor) => monitor.primary, orElse: () => all.first)
+        .workArea;
+  }
+
+  /// Where [rect] goes to lie inside the work area of the monitor it is
+  /// mostly on.
+  Future<Offset> clamp(Rect rect) => _place('clamp', rect, snap: false);
+
+  /// [clamp], then against that work area's right edge.
+  Future<Offset> snapToRightEdge(Rect rect) =>
+      _place('snapToRightEdge', rect, snap: true);
+
+  Future<Offset> _place(String method, Rect rect, {required bool snap}) async {
+    await _start();
+    if (_native) {
+      final placed = (await _channel.invokeMapMethod<String, double>(method, {
+        'x': rect.left,
+        'y': rect.top,
+        'width': rect.width,
+        'height': rect.height,
+      }))!;
+      return Offset(placed['x']!, placed['y']!);
+    }
+    final screen = await _primaryDisplaySize();
+    final x = snap
+        ? screen.width - rect.width
+        : rect.left.clamp(0.0, screen.width - rect.width).toDouble();
+    final y = rect.top.clamp(0.0, screen.height - rect.height).toDouble();
+    return Offset(x, y);
+  }
+
+  Future<void> _start() => _started ??= _fetch();
+
+  Future<void> _fetch() async {
+    if (!_native) return;
+    _channel.setMethodCallHandler(_onCall);
+    try {
+      final value = await _channel.invokeMapMethod<String, dynamic>('get');
+      _apply(value!);
+    } on MissingPluginException {
+      _native = false;
+    } on PlatformException catch (e) {
+      _native = false;
+      _logger.warning('No native monitor layout: ${e.message}');
+    }
+  }
+
+  Future<void> _onCall(MethodCall call) async {
+    if (call.method != 'changed') return;
+    _apply((call.arguments as Map).cast<String, dynamic>());
+    _logger.info('Monitors changed: ${_monitors.length} connected');
+    _changes.add(_monitors);
+  }
+
+  void _apply(Map<String, dynamic> value) {
+    final generation = value['generation'] as int;
+    // A push can overtake the reply to the first "get".
+    if (generation <= _generation) return;
+    _generation = generation;
+    _monitors = [
+      for (final monitor in (value['monitors'] as List).cast<Map>())
+        MonitorInfo(
+          geometry: _rect(monitor['geometry'] as Map),
+          workArea: _rect(monitor['workarea'] as Map),
+          scaleFactor: monitor['scaleFactor'] as int,
+          primary: monitor['primary'] as bool,
+          model: monitor['model'] as String,
+        ),
+    ];
+  }
+
+  static Rect _rect(Map value) => Rect.fromLTWH(
+        value['x'] as double,
+        value['y'] as double,
+        value['width'] as double,
+        value['height'] as double,
+      );
+
+  static Future<Size> _primaryDisplaySize() async =>
+      (await screenRetriever.getPrimaryDisplay()).size;
+}
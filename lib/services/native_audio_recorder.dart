@@ -1,20 +1,90 @@
 import 'dart:io';
 import 'package:flutter/services.dart';
 import 'package:path_provider/path_provider.dart';
+import '../native/fast_messages.g.dart';
 import 'logger_service.dart';
 
+/// How a recording went, as the Windows recorder core measured it
+/// (AudioRecorderStats in linux/native/runner/audio_recorder.h).
+class RecordingHealth {
+  /// Blocks of audio written.
+  final int blocks;
+  final int emptyReads;
+
+  /// Blocks the capture API flagged as following lost audio.
+  final int xruns;
+
+  /// Places where a block started later than the previous one ended, and
+  /// the audio missing there.
+  final int timestampGaps;
+  final Duration missing;
+  final Duration longestGap;
+
+  /// The most audio that waited in the capture queue.
+  final Duration maxBacklog;
+  final Duration length;
+
+  /// Encoding and writing one block.
+  final Duration writeP50;
+  final Duration writeP99;
+  final Duration writeMax;
+
+  /// Finishing the file on stop.
+  final Duration finish;
+  final int fileBytes;
+  final bool failed;
+
+  const RecordingHealth({
+    required this.blocks,
+    required this.emptyReads,
+    required this.xruns,
+    required this.timestampGaps,
+    required this.missing,
+    required this.longestGap,
+    required this.maxBacklog,
+    required this.length,
+    required this.writeP50,
+    required this.writeP99,
+    required this.writeMax,
+    required this.finish,
+    required this.fileBytes,
+    required this.failed,
+  });
+
+  /// Whether any audio may be missing from the file.
+  bool get lostAudio => failed || xruns > 0 || timestampGaps > 0;
+
+  @override
+  String toString() =>
+      '$blocks blocks, ${length.inMilliseconds} ms, $fileBytes bytes; '
+      '$xruns xruns, $timestampGaps gaps (${missing.inMilliseconds} ms '
+      'missing, longest ${longestGap.inMilliseconds} ms), '
+      '$emptyReads empty reads; backlog up to '
+      '${maxBacklog.inMilliseconds} ms; write p50 '
+      '${writeP50.inMicroseconds} us, p99 ${writeP99.inMicroseconds} us, '
+      'max ${writeMax.inMicroseconds} us; finish '
+      '${finish.inMilliseconds} ms${failed ? '; ended with an error' : ''}';
+}
+
 /// Native audio recorder for macOS and Windows
 /// Uses AVFoundation on macOS and Media Foundation on Windows
 class NativeAudioRecorder {
   static const _channel = MethodChannel('com.silverstone.audio_recorder');
-  final _logger = LoggerService();
+  // The Windows runner also serves the calls on a binary fast-path channel.
+  static const _fast = AudioRecorderFastChannel();
+  final _logger = LoggerService.subsystem('audio');
 
   String? _currentPath;
   bool _isRecording = false;
+  RecordingHealth? _lastHealth;
 
   bool get isRecording => _isRecording;
   String? get currentPath => _currentPath;
 
+  /// Of the last recording stopped; null where the platform does not
+  /// measure it (macOS).
+  RecordingHealth? get lastHealth => _lastHealth;
+
   /// Check if the current platform is supported
   bool get isSupported => Platform.isMacOS || Platform.isWindows;
 
@@ -26,6 +96,7 @@ class NativeAudioRecorder {
     }
 
     try {
+      if (Platform.isWindows) return await _fast.hasPermission();
       final result = await _channel.invokeMethod<bool>('hasPermission');
       return result ?? false;
     } catch (e) {
@@ -53,9 +124,11 @@ class NativeAudioRecorder {
 
       _logger.info('Starting native recording to: $_currentPath');
 
-      final result = await _channel.invokeMethod<bool>('startRecording', {
-        'path': _currentPath,
-      });
+      final result = Platform.isWindows
+          ? await _fast.startRecording(_currentPath!)
+          : await _channel.invokeMethod<bool>('startRecording', {
+              'path': _currentPath,
+            });
 
       if (result == true) {
         _isRecording = true;
@@ -82,10 +155,42 @@ class NativeAudioRecorder {
     try {
       _logger.info('Stopping native recording...');
 
-      final result = await _channel.invokeMethod<String>('stopRecording');
+      _lastHealth = null;
+      final String? result;
+      if (Platform.isWindows) {
+        final stopped = await _fast.stopRecording();
+        result = stopped.path;
+        _lastHealth = RecordingHealth(
+          blocks: stopped.samples,
+          emptyReads: stopped.emptyReads,
+          xruns: stopped.xruns,
+          timestampGaps: stopped.timestampGaps,
+          missing: Duration(microseconds: stopped.missingUs),
+          longestGap: Duration(microseconds: stopped.maxGapUs),
+          maxBacklog: Duration(microseconds: stopped.maxBacklogUs),
+          length: Duration(microseconds: stopped.mediaUs),
+          writeP50: Duration(microseconds: stopped.writeP50Us),
+          writeP99: Duration(microseconds: stopped.writeP99Us),
+          writeMax: Duration(microseconds: stopped.writeMaxUs),
+          finish: Duration(microseconds: stopped.finishUs),
+          fileBytes: stopped.fileBytes,
+          failed: stopped.failed,
+        );
+      } else {
+        result = await _channel.invokeMethod<String>('stopRecording');
+      }
       _isRecording = false;
 
       _logger.info('Native recording stopped, path: $result');
+      final health = _lastHealth;
+      if (health != null) {
+        final message = 'Recording health: $health';
+        if (health.lostAudio) {
+          _logger.warning(message);
+        } else {
+          _logger.info(message);
+        }
+      }
 
       final path = result ?? _currentPath;
       _currentPath = null;
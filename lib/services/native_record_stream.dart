@@ -0,0 +1,139 @@
+import 'dart:async';
+import 'dart:ffi';
+import 'package:ffi/ffi.dart';
+import 'package:flutter/scheduler.dart';
+import '../native/native_stream_bindings.dart';
+import 'logger_service.dart';
+
+/// Reads a native record stream (linux/native/stream) in batches.
+///
+/// Native code writes fixed-size records into a ring that this reader
+/// decodes in place, instead of serializing and posting every event as an
+/// EventChannel does. The writer rings a doorbell once after each re-arm;
+/// the reader then drains everything waiting at the next frame and re-arms,
+/// so listeners get at most one batch per frame however fast records come.
+///
+/// The stream is attached while [batches] has listeners. A native stream
+/// has a single reader, so keep one instance per stream name.
+class NativeRecordStream<T> {
+  final String name;
+
+  /// Size of one record; must match the native writer's.
+  final int recordSize;
+
+  /// Ring size used if this reader creates the stream.
+  final int capacity;
+
+  /// Copies one record out of native memory. The bytes are reused by the
+  /// writer as soon as the batch has been decoded.
+  final T Function(Pointer<Uint8> record) decode;
+
+  /// Arranges for a drain to run; the next frame by default.
+  final void Function(void Function() drain) scheduleDrain;
+
+  final _logger = LoggerService.subsystem('stream');
+
+  late final StreamController<List<T>> _controller =
+      StreamController.broadcast(onListen: _attach, onCancel: _detach);
+
+  NativeStreamBindings? _bindings;
+  Pointer<Void> _stream = nullptr;
+  Pointer<Uint8> _records = nullptr;
+  int _mask = 0;
+  int _stride = 0;
+  Pointer<Uint64> _first = nullptr;
+  NativeCallable<StreamDoorbellNative>? _doorbell;
+  bool _drainScheduled = false;
+
+  NativeRecordStream({
+    required this.name,
+    required this.recordSize,
+    required this.decode,
+    this.capacity = 4096,
+    void Function(void Function() drain)? scheduleDrain,
+  }) : scheduleDrain = scheduleDrain ?? _atNextFrame;
+
+  static void _atNextFrame(void Function() drain) {
+    SchedulerBinding.instance.scheduleFrameCallback((_) => drain());
+  }
+
+  /// Decoded records, oldest first. Stays empty without the native library.
+  Stream<List<T>> get batches => _controller.stream;
+
+  /// Records the writer had to discard because this reader fell behind.
+  int get dropped =>
+      _stream == nullptr ? 0 : _bindings!.dropped(_stream);
+
+  void _attach() {
+    final bindings = _bindings ??= NativeStreamBindings.instance;
+    if (bindings == null) return;
+
+    final stream = using((arena) => bindings.open(
+        name.toNativeUtf8(allocator: arena).cast(), recordSize, capacity));
+    if (stream == nullptr) {
+      _logger.warning('Cannot open native stream $name');
+      return;
+    }
+    final doorbell =
+        NativeCallable<StreamDoorbellNative>.listener(_onDoorbell);
+    if (!bindings.attach(stream, doorbell.nativeFunction, nullptr)) {
+      doorbell.close();
+      _logger.warning('Native stream $name already has a reader');
+      return;
+    }
+
+    using((arena) {
+      final layout = arena<SsStreamLayout>();
+      bindings.layout(stream, layout);
+      _records = layout.ref.records;
+      _mask = layout.ref.capacity - 1;
+      _stride = layout.ref.recordSize;
+    });
+    _stream = stream;
+    _doorbell = doorbell;
+    _first = calloc<Uint64>();
+    _arm();
+  }
+
+  void _detach() {
+    if (_stream == nullptr) return;
+    // No doorbell can arrive once detach() returns.
+    _bindings!.detach(_stream);
+    _doorbell!.close();
+    _doorbell = null;
+    calloc.free(_first);
+    _first = nullptr;
+    _stream = nullptr;
+  }
+
+  void _arm() {
+    if (_bindings!.arm(_stream)) _schedule();
+  }
+
+  void _onDoorbell(Pointer<Void> data) => _schedule();
+
+  void _schedule() {
+    if (_drainScheduled) return;
+    _drainScheduled = true;
+    scheduleDrain(_drain);
+  }
+
+  void _drain() {
+    _drainScheduled = false;
+    if (_stream == nullptr) return;
+
+    final bindings = _bindings!;
+    final count = bindings.acquire(_stream, _first);
+    if (count > 0) {
+      final first = _first.value;
+      final batch = List<T>.generate(
+        count,
+        (i) => decode(_records + ((first + i) & _mask) * _stride),
+        growable: false,
+      );
+      bindings.release(_stream, count);
+      _controller.add(batch);
+    }
+    _arm();
+  }
+}
@@ -1,9 +1,23 @@
+import 'dart:async';
 import 'dart:io';
+import 'package:flutter/services.dart';
 import 'package:local_notifier/local_notifier.dart';
+import '../core/enums/notification_type.dart';
 import '../models/notification.dart';
 import 'api_service.dart';
 import 'logger_service.dart';
 
+/// A toast, or one of its buttons, was used.
+class NotificationAction {
+  /// 'default' for the toast itself, otherwise the button's key.
+  final String action;
+
+  /// Every notification the toast stood for.
+  final List<String> ids;
+
+  const NotificationAction(this.action, this.ids);
+}
+
 class NotificationService {
   static final NotificationService _instance = NotificationService._internal();
   factory NotificationService() => _instance;
@@ -12,12 +26,33 @@ class NotificationService {
   final _logger = LoggerService();
   bool _isInitialized = false;
 
+  /// On Linux toasts go through the runner's dispatcher
+  /// (linux/runner/desktop_notifications.h), which merges bursts into
+  /// digests and rate-limits popups. Cleared if the runner has none.
+  static const _channel = MethodChannel('com.silverstone/notifications');
+  bool _nativeToasts = Platform.isLinux;
+  final _actions = StreamController<NotificationAction>.broadcast();
+
   NotificationService._internal();
 
+  /// Toasts the user clicked; only the runner's toasts report them.
+  Stream<NotificationAction> get actions => _actions.stream;
+
   /// Initialize the notification service (for Windows toasts)
   Future<void> initialize() async {
     if (_isInitialized) return;
 
+    if (_nativeToasts) {
+      _channel.setMethodCallHandler((call) async {
+        if (call.method != 'action') return;
+        final args = call.arguments as Map;
+        _actions.add(NotificationAction(
+          args['action'] as String,
+          (args['ids'] as List).cast<String>(),
+        ));
+      });
+    }
+
     if (Platform.isWindows || Platform.isMacOS || Platform.isLinux) {
       await localNotifier.setup(
         appName: 'Work Tracker',
@@ -57,6 +92,27 @@ class NotificationService {
     if (!_isInitialized) return;
     if (!Platform.isWindows && !Platform.isMacOS && !Platform.isLinux) return;
 
+    if (_nativeToasts) {
+      try {
+        await _channel.invokeMethod('show', {
+          'id': notification.id,
+          'type': notification.type,
+          'title': notification.getDisplayTitle(),
+          'body': notification.body ?? '',
+          // What a digest of this type is called.
+          'groupTitle': notification.copyWith(title: '').getDisplayTitle(),
+          'priority': _priority(notification.notificationType),
+          'buttons': ['open', 'Open'],
+        });
+        return;
+      } on MissingPluginException {
+        _nativeToasts = false;
+      } on PlatformException catch (e) {
+        _nativeToasts = false;
+        _logger.warning('Runner toasts unavailable: ${e.message}');
+      }
+    }
+
     try {
       final localNotification = LocalNotification(
         title: notification.getDisplayTitle(),
@@ -69,4 +125,31 @@ class NotificationService {
       _logger.error('Failed to show toast notification', e, stackTrace);
     }
   }
+
+  /// The dispatcher's lane: 0 needs the user, 1 normal, 2 announcements.
+  static int _priority(NotificationType? type) {
+    switch (type) {
+      case NotificationType.REQUEST_APPROVAL:
+      case NotificationType.REQUEST_DECISION:
+      case NotificationType.STILL_WORKING:
+      case NotificationType.AUTO_CHECKOUT:
+      case NotificationType.MIDNIGHT_STILL_WORKING:
+      case NotificationType.NOON_STILL_WORKING:
+        return 0;
+      case NotificationType.NEWS_POSTED:
+      case NotificationType.WELCOME_MESSAGE:
+      case NotificationType.HAPPY_BIRTHDAY:
+      case NotificationType.EMPLOYEE_OF_THE_MONTH:
+      case NotificationType.CONGRATULATE_EMPLOYEE_OF_THE_MONTH:
+      case NotificationType.GOLDEN_BUZZ_ANNOUNCEMENT:
+      case NotificationType.GOLDEN_BUZZ_CONGRATULATION:
+      case NotificationType.COMPETITION_CREATED:
+      case NotificationType.COMPETITION_TEAM_CREATED:
+      case NotificationType.COMPETITION_VOTE_ENDED:
+      case NotificationType.COMPETITION_PHASE_CHANGED:
+        return 2;
+      default:
+        return 1;
+    }
+  }
 }
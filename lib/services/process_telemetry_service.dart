@@ -0,0 +1,172 @@
+import 'dart:convert';
+import 'dart:io';
+import 'package:flutter/services.dart';
+import 'logger_service.dart';
+
+/// One sample of the runner's process telemetry. Counters are totals since
+/// the process started; see [ProcessTelemetry] for rates.
+class ProcessSample {
+  /// Monotonic clock time of the sample.
+  final Duration time;
+  final int rssBytes;
+
+  /// Proportional set size; refreshed every few samples, 0 until the first.
+  final int pssBytes;
+  final Duration cpuUser;
+  final Duration cpuSystem;
+
+  /// Times a thread went to sleep, and so woke up again.
+  final int voluntarySwitches;
+  final int involuntarySwitches;
+  final int diskReadBytes;
+  final int diskWriteBytes;
+  final int fds;
+  final int threads;
+
+  const ProcessSample({
+    required this.time,
+    required this.rssBytes,
+    required this.pssBytes,
+    required this.cpuUser,
+    required this.cpuSystem,
+    required this.voluntarySwitches,
+    required this.involuntarySwitches,
+    required this.diskReadBytes,
+    required this.diskWriteBytes,
+    required this.fds,
+    required this.threads,
+  });
+
+  factory ProcessSample.fromJson(Map<String, dynamic> json) => ProcessSample(
+        time: Duration(microseconds: json['time_us'] as int),
+        rssBytes: json['rss_bytes'] as int,
+        pssBytes: json['pss_bytes'] as int,
+        cpuUser: Duration(microseconds: json['cpu_user_us'] as int),
+        cpuSystem: Duration(microseconds: json['cpu_system_us'] as int),
+        voluntarySwitches: json['voluntary_switches'] as int,
+        involuntarySwitches: json['involuntary_switches'] as int,
+        diskReadBytes: json['read_bytes'] as int,
+        diskWriteBytes: json['write_bytes'] as int,
+        fds: json['fds'] as int,
+        threads: json['threads'] as int,
+      );
+}
+
+/// A thread over the interval between the last two samples.
+class ThreadActivity {
+  final int threadId;
+  final String name;
+  final Duration cpu;
+  final Duration cpuDelta;
+  final int wakeupsDelta;
+
+  const ThreadActivity({
+    required this.threadId,
+    required this.name,
+    required this.cpu,
+    required this.cpuDelta,
+    required this.wakeupsDelta,
+  });
+
+  factory ThreadActivity.fromJson(Map<String, dynamic> json) =>
+      ThreadActivity(
+        threadId: json['thread_id'] as int,
+        name: json['name'] as String,
+        cpu: Duration(microseconds: json['cpu_us'] as int),
+        cpuDelta: Duration(microseconds: json['cpu_delta_us'] as int),
+        wakeupsDelta: json['wakeups_delta'] as int,
+      );
+}
+
+/// The runner's rolling telemetry window, oldest sample first, and its
+/// threads busiest first.
+class ProcessTelemetry {
+  final List<ProcessSample> samples;
+  final List<ThreadActivity> threads;
+
+  const ProcessTelemetry(this.samples, this.threads);
+
+  Duration get span => samples.length < 2
+      ? Duration.zero
+      : samples.last.time - samples.first.time;
+
+  /// Share of one core used over the window, in percent.
+  double get cpuPercent {
+    if (span == Duration.zero) return 0;
+    final first = samples.first;
+    final last = samples.last;
+    final cpu = (last.cpuUser + last.cpuSystem) -
+        (first.cpuUser + first.cpuSystem);
+    return cpu.inMicroseconds / span.inMicroseconds * 100;
+  }
+
+  double get wakeupsPerSecond => _rate((s) => s.voluntarySwitches);
+  double get diskReadBytesPerSecond => _rate((s) => s.diskReadBytes);
+  double get diskWriteBytesPerSecond => _rate((s) => s.diskWriteBytes);
+
+  /// Flat numbers for reporting, e.g. to the fleet dashboard.
+  Map<String, num> toSummary() => {
+        'window_s': span.inMilliseconds / 1000,
+        'cpu_percent': cpuPercent,
+        'wakeups_per_s': wakeupsPerSecond,
+        'disk_read_bytes_per_s': diskReadBytesPerSecond,
+        'disk_write_bytes_per_s': diskWriteBytesPerSecond,
+        if (samples.isNotEmpty) ...{
+          'rss_bytes': samples.last.rssBytes,
+          'pss_bytes': samples.last.pssBytes,
+          'fds': samples.last.fds,
+          'threads': samples.last.threads,
+        },
+      };
+
+  double _rate(int Function(ProcessSample) counter) {
+    if (span == Duration.zero) return 0;
+    final delta = counter(samples.last) - counter(samples.first);
+    // Thread counters drop when threads exit.
+    if (delta <= 0) return 0;
+    return delta / (span.inMicroseconds / 1e6);
+  }
+}
+
+/// Reads the process telemetry the Linux runner samples in the background
+/// (linux/runner/telemetry_sampler.h): memory, CPU per thread, wakeups,
+/// file descriptors and disk I/O over the last hour.
+class ProcessTelemetryService {
+  static const MethodChannel _channel = MethodChannel(
+    'com.silverstone/diagnostics',
+  );
+
+  static final ProcessTelemetryService _instance =
+      ProcessTelemetryService._internal();
+  factory ProcessTelemetryService() => _instance;
+
+  final _logger = LoggerService.subsystem('telemetry');
+
+  ProcessTelemetryService._internal();
+
+  bool get isSupported => Platform.isLinux;
+
+  /// The current window, or null if the runner does not provide one.
+  Future<ProcessTelemetry?> read() async {
+    if (!isSupported) return null;
+
+    try {
+      final json = await _channel.invokeMethod<String>('getProcessTelemetry');
+      if (json == null) return null;
+      final data = jsonDecode(json) as Map<String, dynamic>;
+      return ProcessTelemetry(
+        [
+          for (final sample in data['samples'] as List)
+            ProcessSample.fromJson(sample as Map<String, dynamic>),
+        ],
+        [
+          for (final thread in data['threads'] as List)
+            ThreadActivity.fromJson(thread as Map<String, dynamic>),
+        ],
+      );
+    } catch (e) {
+      _logger.warning('Could not read process telemetry', e);
+      return null;
+    }
+  }
+}
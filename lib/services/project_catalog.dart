@@ -0,0 +1,256 @@
+import 'dart:convert';
+import 'dart:ffi';
+import 'package:ffi/ffi.dart';
+import '../models/project.dart';
+import '../native/fast_codec.dart';
+import '../native/native_catalog_bindings.dart';
+import 'logger_service.dart';
+import 'storage_service.dart';
+
+/// One project as the catalog holds it.
+class CatalogEntry {
+  final String id;
+  final String name;
+  final String client;
+  final String status;
+  final DateTime? lastActiveAt;
+
+  const CatalogEntry({
+    required this.id,
+    required this.name,
+    this.client = '',
+    this.status = '',
+    this.lastActiveAt,
+  });
+}
+
+/// One version of the catalog. It never changes, however many syncs happen
+/// while it is held; [release] it when done.
+abstract class ProjectCatalogSnapshot {
+  int get version;
+  int get length;
+
+  CatalogEntry? byId(String id);
+
+  /// The first project whose name matches [name] ignoring case.
+  CatalogEntry? byName(String name);
+
+  void release();
+}
+
+/// The projects the signed-in user can log time against, with constant-time
+/// lookups by id and by case-insensitive name.
+///
+/// On Linux the catalog lives in the native library (linux/native/catalog),
+/// shared by every isolate and kept as flat columns with one copy of each
+/// string. Elsewhere an equivalent Dart catalog is used. Either way a sync
+/// builds a new version from a delta and readers keep the version they
+/// took. The catalog is filled from storage on first use and then follows
+/// [ProjectService]'s downloads and edits.
+class ProjectCatalog {
+  static final ProjectCatalog _instance = ProjectCatalog._internal();
+  factory ProjectCatalog() => _instance;
+
+  final _logger = LoggerService.subsystem('catalog');
+  final _native = NativeCatalogBindings.instance;
+  _DartSnapshot _dart = _DartSnapshot.empty;
+  bool _loaded = false;
+
+  ProjectCatalog._internal();
+
+  /// Replaces every project, after a full download.
+  void replaceAll(Iterable<Project> projects) {
+    _loaded = true;
+    _apply(reset: true, upserts: projects.toList());
+  }
+
+  void upsert(Project project) {
+    _ensureLoaded();
+    _apply(upserts: [project]);
+  }
+
+  void remove(String id) {
+    _ensureLoaded();
+    _apply(removals: [id]);
+  }
+
+  ProjectCatalogSnapshot snapshot() {
+    _ensureLoaded();
+    final native = _native;
+    if (native == null) return _dart;
+    return _NativeSnapshot(native, native.acquire());
+  }
+
+  /// Id of the project named [name] (ignoring case), or null.
+  String? idForName(String name) {
+    final catalog = snapshot();
+    try {
+      return catalog.byName(name)?.id;
+    } finally {
+      catalog.release();
+    }
+  }
+
+  void _ensureLoaded() {
+    if (_loaded) return;
+    _loaded = true;
+    final projects = StorageService().getAllProjects();
+    _apply(reset: true, upserts: projects);
+    _logger.debug('Loaded ${projects.length} projects from storage');
+  }
+
+  void _apply({
+    bool reset = false,
+    List<Project> upserts = const [],
+    List<String> removals = const [],
+  }) {
+    final native = _native;
+    if (native == null) {
+      _dart = _dart.apply(reset, upserts, removals);
+      return;
+    }
+    final writer = FastWriter()
+      ..writeBool(reset)
+      ..writeInt32(upserts.length);
+    for (final project in upserts) {
+      writer
+        ..writeString(project.id)
+        ..writeString(project.name)
+        ..writeString(project.client ?? '')
+        ..writeString(project.status)
+        ..writeInt64(project.lastActiveAt?.millisecondsSinceEpoch ?? 0);
+    }
+    writer.writeInt32(removals.length);
+    removals.forEach(writer.writeString);
+
+    final bytes = writer.doneBytes();
+    final version = using((arena) {
+      final delta = arena<Uint8>(bytes.length);
+      delta.asTypedList(bytes.length).setAll(0, bytes);
+      return native.applyDelta(delta, bytes.length);
+    });
+    if (version < 0) _logger.error('Native catalog rejected a delta');
+  }
+}
+
+class _NativeSnapshot implements ProjectCatalogSnapshot, Finalizable {
+  /// Releases snapshots that were dropped without [release].
+  static NativeFinalizer? _finalizer;
+
+  final NativeCatalogBindings _bindings;
+  Pointer<Void> _handle;
+
+  _NativeSnapshot(this._bindings, this._handle) {
+    (_finalizer ??= NativeFinalizer(_bindings.releasePointer))
+        .attach(this, _handle, detach: this);
+  }
+
+  @override
+  int get version => _bindings.version(_handle);
+
+  @override
+  int get length => _bindings.size(_handle);
+
+  @override
+  CatalogEntry? byId(String id) => _find(_bindings.findId, id);
+
+  @override
+  CatalogEntry? byName(String name) => _find(_bindings.findName, name);
+
+  @override
+  void release() {
+    if (_handle == nullptr) return;
+    _finalizer!.detach(this);
+    _bindings.release(_handle);
+    _handle = nullptr;
+  }
+
+  CatalogEntry? _find(
+      int Function(Pointer<Void>, Pointer<Uint8>, int) find, String key) {
+    return using((arena) {
+      final bytes = utf8.encode(key);
+      final native = arena<Uint8>(bytes.isEmpty ? 1 : bytes.length);
+      native.asTypedList(bytes.length).setAll(0, bytes);
+      final index = find(_handle, native, bytes.length);
+      if (index < 0) return null;
+      final row = arena<SsCatalogRow>();
+      if (!_bindings.row(_handle, index, row)) return null;
+      final ref = row.ref;
+      return CatalogEntry(
+        id: _string(ref.id, ref.idSize),
+        name: _string(ref.name, ref.nameSize),
+        client: _string(ref.client, ref.clientSize),
+        status: _string(ref.status, ref.statusSize),
+        lastActiveAt: ref.lastActiveMs == 0
+            ? null
+            : DateTime.fromMillisecondsSinceEpoch(ref.lastActiveMs),
+      );
+    });
+  }
+
+  static String _string(Pointer<Uint8> data, int size) =>
+      size == 0 ? '' : utf8.decode(data.asTypedList(size));
+}
+
+/// The Dart catalog: immutable maps, rebuilt on every delta.
+class _DartSnapshot implements ProjectCatalogSnapshot {
+  static final empty = _DartSnapshot(0, const [], const {}, const {});
+
+  @override
+  final int version;
+  final List<CatalogEntry> _entries;
+  final Map<String, CatalogEntry> _byId;
+  final Map<String, CatalogEntry> _byName;
+
+  _DartSnapshot(this.version, this._entries, this._byId, this._byName);
+
+  @override
+  int get length => _entries.length;
+
+  @override
+  CatalogEntry? byId(String id) => _byId[id];
+
+  @override
+  CatalogEntry? byName(String name) => _byName[name.toLowerCase()];
+
+  @override
+  void release() {}
+
+  /// Same rules as the native CatalogDelta: removals first, upserts of a
+  /// known id replace it in place, new ids go last.
+  _DartSnapshot apply(
+      bool reset, List<Project> upserts, List<String> removals) {
+    final updated = <String, CatalogEntry>{
+      for (final project in upserts)
+        project.id: CatalogEntry(
+          id: project.id,
+          name: project.name,
+          client: project.client ?? '',
+          status: project.status,
+          lastActiveAt: project.lastActiveAt,
+        ),
+    };
+    final removed = removals.toSet();
+    final entries = <CatalogEntry>[];
+    final byId = <String, CatalogEntry>{};
+    void add(CatalogEntry entry) {
+      entries.add(entry);
+      byId[entry.id] = entry;
+    }
+
+    if (!reset) {
+      for (final entry in _entries) {
+        if (removed.contains(entry.id)) continue;
+        add(updated.remove(entry.id) ?? entry);
+      }
+    }
+    updated.values.forEach(add);
+
+    final byName = <String, CatalogEntry>{};
+    for (final entry in entries) {
+      byName.putIfAbsent(entry.name.toLowerCase(), () => entry);
+    }
+    return _DartSnapshot(version + 1, List.unmodifiable(entries),
+        Map.unmodifiable(byId), Map.unmodifiable(byName));
+  }
+}
@@ -3,6 +3,7 @@ import '../core/constants/app_constants.dart';
 import 'storage_service.dart';
 import 'logger_service.dart';
 import 'api_service.dart';
+import 'project_catalog.dart';
 
 class ProjectService {
   static final ProjectService _instance = ProjectService._internal();
@@ -11,6 +12,7 @@ class ProjectService {
   final _storage = StorageService();
   final _logger = LoggerService();
   final _api = ApiService();
+  final _catalog = ProjectCatalog();
 
   ProjectService._internal();
 
@@ -55,6 +57,7 @@ class ProjectService {
       // Clear old cache and save fresh projects for offline access
       await _storage.clearProjects();
       await _storage.saveProjects(projects);
+      _catalog.replaceAll(projects);
       _logger.info('Loaded ${projects.length} projects from API');
 
       return projects;
@@ -90,6 +93,7 @@ class ProjectService {
   Future<void> updateProject(Project project) async {
     try {
       await _storage.saveProject(project);
+      _catalog.upsert(project);
       _logger.info('Project updated: ${project.name}');
     } catch (e, stackTrace) {
       _logger.error('Failed to update project', e, stackTrace);
@@ -137,6 +141,7 @@ class ProjectService {
       );
 
       await _storage.saveProject(project);
+      _catalog.upsert(project);
       _logger.info('Project created: $name');
 
       return project;
@@ -150,6 +155,7 @@ class ProjectService {
   Future<void> deleteProject(String id) async {
     try {
       await _storage.deleteProject(id);
+      _catalog.remove(id);
       _logger.info('Project deleted: $id');
     } catch (e, stackTrace) {
       _logger.error('Failed to delete project', e, stackTrace);
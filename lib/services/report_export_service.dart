@@ -0,0 +1,196 @@
+import 'dart:async';
+import 'dart:ffi';
+import 'package:ffi/ffi.dart';
+import '../native/report_export_bindings.dart';
+import 'logger_service.dart';
+
+/// Output formats supported by the native exporter. The index matches
+/// `ExportFormat` in linux/native/export/report_writer.h.
+enum ReportExportFormat {
+  csv('csv', 'CSV'),
+  xlsx('xlsx', 'Excel'),
+  pdf('pdf', 'PDF');
+
+  const ReportExportFormat(this.extension, this.label);
+
+  final String extension;
+  final String label;
+}
+
+/// Snapshot of a running export.
+class ReportExportProgress {
+  final int rowsWritten;
+  final int totalRows;
+  final int bytesWritten;
+  final bool isDone;
+  final String? error;
+
+  const ReportExportProgress({
+    required this.rowsWritten,
+    required this.totalRows,
+    required this.bytesWritten,
+    this.isDone = false,
+    this.error,
+  });
+
+  double get fraction =>
+      totalRows > 0 ? (rowsWritten / totalRows).clamp(0.0, 1.0) : 0.0;
+}
+
+/// Exports daily reports to CSV, XLSX or PDF through the native engine.
+///
+/// Rows are handed to native code in small batches and formatted on a worker
+/// thread, so neither side ever holds the whole rendered document.
+class ReportExportService {
+  static final ReportExportService _instance = ReportExportService._internal();
+  factory ReportExportService() => _instance;
+
+  final _logger = LoggerService.subsystem('export');
+
+  // Rows copied to native memory per FFI call.
+  static const _batchSize = 256;
+
+  // Native ExportState values.
+  static const _stateRunning = 0;
+  static const _stateDone = 1;
+
+  ReportExportService._internal();
+
+  bool get isSupported => ReportExportBindings.instance != null;
+
+  /// Exports the tasks of [reports] (as returned by
+  /// `ApiService.getMyDailyReports`) to [path], oldest day first.
+  Stream<ReportExportProgress> exportReports({
+    required List<Map<String, dynamic>> reports,
+    required String path,
+    required ReportExportFormat format,
+    required String title,
+  }) async* {
+    final bindings = ReportExportBindings.instance;
+    if (bindings == null) {
+      throw UnsupportedError('Report export is not available on this platform');
+    }
+
+    final totalRows = reports.fold<int>(
+      0,
+      (sum, report) => sum + ((report['tasks'] as List?)?.length ?? 0),
+    );
+
+    final job = using((arena) => bindings.open(
+          path.toNativeUtf8(allocator: arena).cast(),
+          format.index,
+          title.toNativeUtf8(allocator: arena).cast(),
+          totalRows,
+        ));
+    if (job == nullptr) {
+      throw Exception('Could not create $path');
+    }
+
+    _logger.info('Exporting $totalRows tasks to ${format.label}: $path');
+    final progress = calloc<SsExportProgress>();
+    try {
+      final pending = <Map<String, dynamic>>[];
+      var accepted = true;
+      // Reports arrive newest first; timesheets read top to bottom.
+      for (final report in reports.reversed) {
+        final date = (report['reportDate'] ?? '').toString().split('T')[0];
+        final tasks = (report['tasks'] as List?) ?? const [];
+        for (final task in tasks) {
+          if (task is! Map<String, dynamic>) continue;
+          pending.add({'date': date, 'task': task});
+          if (pending.length == _batchSize) {
+            accepted = _addBatch(bindings, job, pending);
+            pending.clear();
+            if (!accepted) break;
+            yield _readProgress(bindings, job, progress);
+            // Let the UI isolate render between batches.
+            await Future<void>.delayed(Duration.zero);
+          }
+        }
+        if (!accepted) break;
+      }
+      if (accepted && pending.isNotEmpty) {
+        _addBatch(bindings, job, pending);
+      }
+
+      bindings.finish(job);
+      var snapshot = _readProgress(bindings, job, progress);
+      while (!snapshot.isDone) {
+        yield snapshot;
+        await Future<void>.delayed(const Duration(milliseconds: 16));
+        snapshot = _readProgress(bindings, job, progress);
+      }
+
+      if (snapshot.error != null) {
+        _logger.error('Report export failed: ${snapshot.error}', null, null);
+      } else {
+        _logger.info('Report export finished: ${snapshot.rowsWritten} rows, '
+            '${snapshot.bytesWritten} bytes');
+      }
+      yield snapshot;
+    } finally {
+      calloc.free(progress);
+      // Cancels the job if the listener went away early.
+      bindings.close(job);
+    }
+  }
+
+  bool _addBatch(
+    ReportExportBindings bindings,
+    Pointer<Void> job,
+    List<Map<String, dynamic>> batch,
+  ) {
+    return using((arena) {
+      final rows = arena<SsExportRow>(batch.length);
+      for (var i = 0; i < batch.length; i++) {
+        final task = batch[i]['task'] as Map<String, dynamic>;
+        final project = task['project'] as Map<String, dynamic>?;
+        final timeEntry = task['timeEntry'] as Map<String, dynamic>?;
+        final duration = timeEntry?['duration'];
+
+        final row = rows[i];
+        row.date = _string(batch[i]['date'], arena);
+        row.project = _string(project?['name'] ?? 'Unknown Project', arena);
+        row.title = _string(task['title'], arena);
+        row.description = _string(task['description'], arena);
+        row.startedAtMs = _epochMs(timeEntry?['startedAt']);
+        row.endedAtMs = _epochMs(timeEntry?['endedAt']);
+        row.durationSeconds = duration is num ? duration.toInt() : 0;
+      }
+      return bindings.addRows(job, rows, batch.length) == batch.length;
+    });
+  }
+
+  Pointer<Char> _string(Object? value, Arena arena) =>
+      (value?.toString() ?? '').toNativeUtf8(allocator: arena).cast();
+
+  int _epochMs(Object? value) {
+    if (value is! String) return 0;
+    return DateTime.tryParse(value)?.millisecondsSinceEpoch ?? 0;
+  }
+
+  ReportExportProgress _readProgress(
+    ReportExportBindings bindings,
+    Pointer<Void> job,
+    Pointer<SsExportProgress> progress,
+  ) {
+    bindings.getProgress(job, progress);
+    final state = progress.ref.state;
+    String? error;
+    if (state != _stateRunning && state != _stateDone) {
+      error = using((arena) {
+        final buffer = arena<Char>(256);
+        bindings.getError(job, buffer, 256);
+        final message = buffer.cast<Utf8>().toDartString();
+        return message.isEmpty ? 'Export cancelled' : message;
+      });
+    }
+    return ReportExportProgress(
+      rowsWritten: progress.ref.rowsWritten,
+      totalRows: progress.ref.totalRows,
+      bytesWritten: progress.ref.bytesWritten,
+      isDone: state != _stateRunning,
+      error: error,
+    );
+  }
+}
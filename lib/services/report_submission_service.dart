@@ -2,8 +2,10 @@ import 'dart:convert';
 import 'dart:io';
 import 'package:flutter_dotenv/flutter_dotenv.dart';
 import 'package:http/http.dart' as http;
+import '../models/project.dart';
 import '../models/task_submission.dart';
 import 'logger_service.dart';
+import 'project_catalog.dart';
 import 'storage_service.dart';
 import 'api_service.dart';
 
@@ -15,6 +17,7 @@ class ReportSubmissionService {
   final _logger = LoggerService();
   final _storage = StorageService();
   final _api = ApiService();
+  final _catalog = ProjectCatalog();
 
   // API Configuration - loaded from .env
   static String get _apiUrl =>
@@ -22,38 +25,40 @@ class ReportSubmissionService {
 
   ReportSubmissionService._internal();
 
-  /// Get project ID by matching project name
-  /// First checks cached projects, then fetches from API if needed
-  Future<String?> _getProjectIdByName(String projectName) async {
+  /// Get project IDs for the given project names
+  /// Looks each name up in the project catalog; if any is missing, downloads
+  /// the project list once and looks the missing ones up again
+  Future<Map<String, String?>> _getProjectIdsByName(Iterable<String> projectNames) async {
+    final ids = <String, String?>{};
     try {
-      // First check cached projects in storage
-      final cachedProjects = _storage.getAllProjects();
-      for (final project in cachedProjects) {
-        if (project.name.toLowerCase() == projectName.toLowerCase()) {
-          return project.id;
-        }
+      for (final name in projectNames) {
+        ids[name] = _catalog.idForName(name);
       }
+      if (!ids.containsValue(null)) return ids;
 
-      // If not found in cache, fetch from API
-      _logger.info('Project "$projectName" not in cache, fetching from API...');
+      final missing = ids.keys.where((name) => ids[name] == null).toList();
+      _logger.info('Projects $missing not in catalog, fetching from API...');
       final projectsJson = await _api.getProjects();
-
+      final projects = <Project>[];
       for (final json in projectsJson) {
-        final name = (json['name'] ?? json['project_name'] ?? json['ProjectName'] ?? '') as String;
-        if (name.toLowerCase() == projectName.toLowerCase()) {
-          final id = (json['_id'] ?? json['id'] ?? json['project_id'] ?? json['ProjectID'] ?? '').toString();
-          if (id.isNotEmpty) {
-            return id;
-          }
+        try {
+          projects.add(Project.fromJson(json));
+        } catch (e) {
+          _logger.warning('Failed to parse project: $e');
         }
       }
+      if (projects.isNotEmpty) _catalog.replaceAll(projects);
 
-      _logger.warning('Could not find project ID for: $projectName');
-      return null;
+      for (final name in missing) {
+        ids[name] = _catalog.idForName(name);
+        if (ids[name] == null) {
+          _logger.warning('Could not find project ID for: $name');
+        }
+      }
     } catch (e) {
-      _logger.error('Error looking up project ID for: $projectName', e, null);
-      return null;
+      _logger.error('Error looking up project IDs for: ${ids.keys}', e, null);
     }
+    return ids;
   }
 
   /// Submit a session report to the API
@@ -85,12 +90,13 @@ class ReportSubmissionService {
 
       // Build tasks array with project IDs
       final tasksJson = <Map<String, dynamic>>[];
+      final projectIds = await _getProjectIdsByName(
+          report.tasks.map((task) => task.projectName).toSet());
 
       for (int i = 0; i < report.tasks.length; i++) {
         final task = report.tasks[i];
 
-        // Look up project ID by name
-        final projectId = await _getProjectIdByName(task.projectName);
+        final projectId = projectIds[task.projectName];
 
         if (projectId == null) {
           _logger.warning('Could not find project ID for "${task.projectName}", skipping task');
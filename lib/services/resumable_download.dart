@@ -0,0 +1,178 @@
+import 'dart:async';
+import 'dart:io';
+import 'logger_service.dart';
+
+/// Downloads a file over HTTP(S), resuming after dropped connections and
+/// across app restarts.
+///
+/// Bytes go to `<target>.part`; the validator the server sent with the first
+/// response (ETag, else Last-Modified) is kept in `<target>.part.validator`.
+/// A later attempt asks for the remaining range with `If-Range`, so a server
+/// that has replaced the file answers with the whole new body instead of a
+/// tail that would not fit the existing bytes. The part file is renamed to
+/// [target] only once it is complete.
+class ResumableDownload {
+  final Uri url;
+  final File target;
+
+  /// Size the finished file must have, when known up front.
+  final int? expectedSize;
+
+  final int maxAttempts;
+
+  /// Delay before retry `n` (1-based); doubles from one second by default.
+  final Duration Function(int attempt) retryDelay;
+
+  final HttpClient _client;
+  final _logger = LoggerService.subsystem('update');
+
+  ResumableDownload({
+    required this.url,
+    required this.target,
+    this.expectedSize,
+    this.maxAttempts = 6,
+    Duration Function(int attempt)? retryDelay,
+    HttpClient? client,
+  })  : retryDelay = retryDelay ?? _defaultRetryDelay,
+        _client = client ?? HttpClient();
+
+  static Duration _defaultRetryDelay(int attempt) =>
+      Duration(seconds: 1 << (attempt - 1).clamp(0, 5));
+
+  File get _partFile => File('${target.path}.part');
+  File get _validatorFile => File('${target.path}.part.validator');
+
+  /// Downloads [url] to [target], calling [onProgress] with the bytes on disk
+  /// and the total (0 while unknown). Throws once [maxAttempts] attempts in a
+  /// row have failed.
+  Future<File> run({void Function(int received, int total)? onProgress}) async {
+    await target.parent.create(recursive: true);
+    var attempt = 0;
+    while (true) {
+      attempt++;
+      try {
+        await _attempt(onProgress);
+        await _partFile.rename(target.path);
+        if (await _validatorFile.exists()) await _validatorFile.delete();
+        return target;
+      } on _RestartDownload catch (e) {
+        // The partial file is unusable; start over right away.
+        _logger.info('Restarting download of $url: ${e.reason}');
+        await _discardPart();
+        if (attempt >= maxAttempts) rethrow;
+      } on Exception catch (e) {
+        if (attempt >= maxAttempts) {
+          _logger.error('Download of $url failed after $attempt attempts', e);
+          rethrow;
+        }
+        final delay = retryDelay(attempt);
+        _logger.warning('Download of $url interrupted ($e), '
+            'retrying in ${delay.inMilliseconds} ms');
+        await Future<void>.delayed(delay);
+      }
+    }
+  }
+
+  Future<void> _attempt(void Function(int, int)? onProgress) async {
+    var offset = await _partFile.exists() ? await _partFile.length() : 0;
+    final validator = await _validatorFile.exists()
+        ? (await _validatorFile.readAsString()).trim()
+        : '';
+    if (offset > 0 && validator.isEmpty) {
+      // Nothing to prove the bytes belong to the current file.
+      throw const _RestartDownload('no validator for the partial file');
+    }
+    if (expectedSize != null && offset > expectedSize!) {
+      throw const _RestartDownload('partial file is larger than expected');
+    }
+
+    final request = await _client.getUrl(url);
+    request.headers.set(HttpHeaders.userAgentHeader, 'SilverStone-Desktop-App');
+    if (offset > 0) {
+      request.headers.set(HttpHeaders.rangeHeader, 'bytes=$offset-');
+      request.headers.set(HttpHeaders.ifRangeHeader, validator);
+    }
+    final response = await request.close();
+
+    int total;
+    switch (response.statusCode) {
+      case HttpStatus.partialContent:
+        final range = _parseContentRange(
+            response.headers.value(HttpHeaders.contentRangeHeader));
+        if (range == null || range.start != offset) {
+          await response.drain<void>();
+          throw const _RestartDownload('server sent an unexpected range');
+        }
+        total = range.total;
+      case HttpStatus.ok:
+        // Fresh start, or the file changed and If-Range did not match.
+        offset = 0;
+        total = response.contentLength > 0 ? response.contentLength : 0;
+        final newValidator =
+            response.headers.value(HttpHeaders.etagHeader) ??
+                response.headers.value(HttpHeaders.lastModifiedHeader) ??
+                '';
+        await _validatorFile.writeAsString(newValidator, flush: true);
+      case HttpStatus.requestedRangeNotSatisfiable:
+        await response.drain<void>();
+        if (expectedSize != null && offset == expectedSize) return;
+        throw const _RestartDownload('requested range not satisfiable');
+      default:
+        await response.drain<void>();
+        throw HttpException('HTTP ${response.statusCode}', uri: url);
+    }
+    if (expectedSize != null && total > 0 && total != expectedSize) {
+      await response.drain<void>();
+      throw HttpException(
+          'Server reports $total bytes, expected $expectedSize', uri: url);
+    }
+    total = expectedSize ?? total;
+
+    final sink = _partFile.openWrite(
+        mode: offset > 0 ? FileMode.writeOnlyAppend : FileMode.writeOnly);
+    var received = offset;
+    onProgress?.call(received, total);
+    try {
+      await for (final chunk in response) {
+        sink.add(chunk);
+        received += chunk.length;
+        onProgress?.call(received, total);
+      }
+    } finally {
+      // Keep what arrived so the next attempt resumes after it.
+      await sink.flush();
+      await sink.close();
+    }
+    if (total > 0 && received != total) {
+      throw HttpException(
+          'Connection closed after $received of $total bytes', uri: url);
+    }
+  }
+
+  /// Deletes [target] and any partial download of it, so the next [run]
+  /// starts from scratch.
+  Future<void> discard() async {
+    if (await target.exists()) await target.delete();
+    await _discardPart();
+  }
+
+  Future<void> _discardPart() async {
+    if (await _partFile.exists()) await _partFile.delete();
+    if (await _validatorFile.exists()) await _validatorFile.delete();
+  }
+
+  /// Parses `bytes START-END/TOTAL`.
+  static ({int start, int total})? _parseContentRange(String? value) {
+    if (value == null) return null;
+    final match = RegExp(r'^bytes (\d+)-(\d+)/(\d+)$').firstMatch(value.trim());
+    if (match == null) return null;
+    return (start: int.parse(match.group(1)!), total: int.parse(match.group(3)!));
+  }
+
+  void close() => _client.close(force: true);
+}
+
+class _RestartDownload implements Exception {
+  final String reason;
+  const _RestartDownload(this.reason);
+}
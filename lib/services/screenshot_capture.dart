@@ -0,0 +1,67 @@
+import 'dart:io';
+import 'package:image/image.dart' as img;
+import 'package:screen_capturer/screen_capturer.dart';
+import 'package:window_manager/window_manager.dart';
+import 'trace_service.dart';
+
+/// A screenshot saved as a JPEG in the system temp directory.
+class Screenshot {
+  final String path;
+  final String name;
+  final int size;
+
+  const Screenshot({
+    required this.path,
+    required this.name,
+    required this.size,
+  });
+}
+
+/// Lets the user select a screen region and saves it as a JPEG, traced as
+/// `screenshot: capture`, `screenshot: decode` and `screenshot: encode`.
+///
+/// The window is minimized while the region is selected and restored
+/// afterwards, also on failure. Returns null if the user cancelled; throws
+/// if the capture cannot be decoded or saved.
+Future<Screenshot?> captureScreenshot() async {
+  final trace = TraceService();
+  CapturedData? capturedData;
+  try {
+    await windowManager.minimize();
+
+    // Wait a moment for the window to minimize
+    await Future.delayed(const Duration(milliseconds: 300));
+
+    // Use screen_capturer for cross-platform support (Windows, macOS, Linux)
+    capturedData = await trace.traceAsync(
+      'screenshot: capture',
+      () => screenCapturer.capture(
+        mode: CaptureMode.region, // Interactive region selection
+      ),
+    );
+  } finally {
+    await windowManager.restore();
+    await windowManager.focus();
+  }
+
+  final pngBytes = capturedData?.imageBytes;
+  if (pngBytes == null) return null;
+
+  // Convert PNG to JPEG for smaller file size
+  final image = trace.traceSync(
+    'screenshot: decode',
+    () => img.decodeImage(pngBytes),
+  );
+  if (image == null) {
+    throw Exception('Failed to decode screenshot image');
+  }
+  final jpegBytes = trace.traceSync(
+    'screenshot: encode',
+    () => img.encodeJpg(image, quality: 85),
+  );
+
+  final name = 'screenshot_${DateTime.now().millisecondsSinceEpoch}.jpg';
+  final path = '${Directory.systemTemp.path}/$name';
+  await File(path).writeAsBytes(jpegBytes);
+  return Screenshot(path: path, name: name, size: jpegBytes.length);
+}
@@ -1,5 +1,6 @@
 import 'dart:async';
 import 'dart:io';
+import 'package:flutter_dotenv/flutter_dotenv.dart';
 import 'package:socket_io_client/socket_io_client.dart' as io;
 import '../models/attendance_event.dart';
 import '../models/task_event.dart';
@@ -22,11 +23,12 @@ class SocketService {
   static final SocketService _instance = SocketService._internal();
   factory SocketService() => _instance;
 
-  final _logger = LoggerService();
+  final _logger = LoggerService.subsystem('socket');
   final _storage = StorageService();
 
   // Socket.IO server URL (same as API base, without /api/v1)
-  static const String _socketUrl = 'https://app.ssarchitects.ae';
+  static String get _socketUrl =>
+      dotenv.env['SOCKET_URL'] ?? 'https://app.ssarchitects.ae';
 
   io.Socket? _socket;
   bool _isConnected = false;
@@ -1,5 +1,8 @@
 import 'dart:io';
+import 'package:ffi/ffi.dart';
+import 'package:flutter/services.dart';
 import 'package:system_tray/system_tray.dart';
+import '../native/native_tray_bindings.dart';
 import 'logger_service.dart';
 
 class SystemTrayService {
@@ -10,17 +13,49 @@ class SystemTrayService {
   final SystemTray _systemTray = SystemTray();
   bool _isInitialized = false;
 
+  /// The runner's own indicator on Linux (linux/runner/tray_indicator.h),
+  /// which draws the running timer into the icon. Null elsewhere, and when
+  /// the runner has none; the plugin is used then.
+  final NativeTrayBindings? _native =
+      Platform.isLinux && NativeTrayBindings.instance?.hasIndicator() == true
+          ? NativeTrayBindings.instance
+          : null;
+  static const _channel = MethodChannel('com.silverstone/tray');
+  static const _defaultTooltip = 'Work Tracker - Click to show';
+  String _tooltip = _defaultTooltip;
+
   Function()? onShowWindow;
   Function()? onSwitchToMain;
   Function()? onExit;
 
-  SystemTrayService._internal();
+  SystemTrayService._internal() {
+    if (_native != null) {
+      // "Exit" is handled by the runner. The tray is only up while
+      // floating, so showing the window means leaving floating mode; the
+      // runner leaves that to Dart so the floating window goes away too.
+      _channel.setMethodCallHandler((call) async {
+        if (call.method == 'menuAction' &&
+            (call.arguments == 'showWindow' ||
+                call.arguments == 'openDashboard')) {
+          onSwitchToMain?.call();
+        }
+      });
+    }
+  }
 
   bool get isInitialized => _isInitialized;
 
   Future<void> init() async {
     if (!_isDesktop() || _isInitialized) return;
 
+    final native = _native;
+    if (native != null) {
+      native.setVisible(true);
+      _isInitialized = true;
+      _logger.info('System tray shown by the runner');
+      return;
+    }
+
     try {
       // Get the icon path - need absolute path for Windows
       String iconPath = _getIconPath();
@@ -29,7 +64,7 @@ class SystemTrayService {
       await _systemTray.initSystemTray(
         title: 'Work Tracker',
         iconPath: iconPath,
-        toolTip: 'Work Tracker - Click to show',
+        toolTip: _tooltip,
       );
 
       final menu = Menu();
@@ -75,8 +110,30 @@ class SystemTrayService {
     // We don't hide the tray icon, it stays visible
   }
 
+  /// Shows [projectName]'s timer, started at [startedAt], in the tray; null
+  /// when no timer runs. The runner's indicator keeps the elapsed time
+  /// current itself; the plugin only gets the project name.
+  Future<void> updateSession(String? projectName, DateTime? startedAt) async {
+    final native = _native;
+    if (native != null) {
+      using((arena) {
+        native.setSession(
+          projectName == null || startedAt == null
+              ? nullptr
+              : projectName.toNativeUtf8(allocator: arena),
+          startedAt?.millisecondsSinceEpoch ?? 0,
+        );
+      });
+      return;
+    }
+    _tooltip = projectName == null
+        ? _defaultTooltip
+        : 'Work Tracker - $projectName';
+    await updateTooltip(_tooltip);
+  }
+
   Future<void> updateTooltip(String tooltip) async {
-    if (!_isDesktop() || !_isInitialized) return;
+    if (!_isDesktop() || !_isInitialized || _native != null) return;
     try {
       await _systemTray.setToolTip(tooltip);
     } catch (e) {
@@ -86,6 +143,13 @@ class SystemTrayService {
 
   Future<void> destroy() async {
     if (!_isDesktop() || !_isInitialized) return;
+    final native = _native;
+    if (native != null) {
+      native.setVisible(false);
+      _isInitialized = false;
+      _logger.info('System tray hidden by the runner');
+      return;
+    }
     try {
       await _systemTray.destroy();
       _isInitialized = false;
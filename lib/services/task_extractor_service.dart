@@ -3,6 +3,7 @@ import 'dart:io';
 import 'package:http/http.dart' as http;
 import 'package:http_parser/http_parser.dart';
 import 'logger_service.dart';
+import 'media_container_service.dart';
 
 /// Result from task extraction API
 class ExtractedTask {
@@ -35,6 +36,10 @@ class TaskExtractorService {
     try {
       _logger.info('Extracting task from audio file: ${audioFile.path}');
 
+      // Refuses a damaged recording before uploading it and puts the index
+      // first so the server can start on it early.
+      await MediaContainerService().prepareForUpload(audioFile);
+
       // Create multipart request
       final request = http.MultipartRequest('POST', Uri.parse(_apiUrl));
 
@@ -11,7 +11,7 @@ class TimerService {
 
   final _storage = StorageService();
   final _projectService = ProjectService();
-  final _logger = LoggerService();
+  final _logger = LoggerService.subsystem('timer');
 
   Timer? _timer;
   TimeEntry? _currentEntry;
@@ -0,0 +1,84 @@
+import 'dart:ffi';
+import 'package:ffi/ffi.dart';
+import '../native/native_trace_bindings.dart';
+
+/// Records Dart spans into the runner's trace, next to the platform thread,
+/// channel calls and native workers.
+///
+/// A session is started and stopped by the runner (Ctrl+Shift+F12, or the
+/// `--trace` flag); until then every call here returns after one leaf FFI
+/// call. Without the native library (Windows, macOS) it does nothing.
+class TraceService {
+  static final TraceService _instance = TraceService._internal();
+  factory TraceService() => _instance;
+
+  static const _category = 'dart';
+
+  final NativeTraceBindings? _bindings = NativeTraceBindings.instance;
+  final Map<String, int> _ids = {};
+  int _categoryId = 0;
+  // Kept clear of the ids the runner gives channel calls.
+  int _nextAsyncId = 1 << 32;
+
+  TraceService._internal();
+
+  /// Whether a trace session is running.
+  bool get isRecording => _bindings?.enabled() ?? false;
+
+  /// Runs [body] inside a span named [name].
+  T traceSync<T>(String name, T Function() body) {
+    final bindings = _bindings;
+    if (bindings == null || !bindings.enabled()) return body();
+
+    final nameId = _intern(name);
+    bindings.begin(_categoryId, nameId);
+    try {
+      return body();
+    } finally {
+      bindings.end(_categoryId, nameId);
+    }
+  }
+
+  /// Runs [body] inside an async span named [name], which covers the time
+  /// until the returned future completes. Other Dart work interleaves with
+  /// it, so it gets its own track in the trace.
+  Future<T> traceAsync<T>(String name, Future<T> Function() body) async {
+    final bindings = _bindings;
+    if (bindings == null || !bindings.enabled()) return body();
+
+    final nameId = _intern(name);
+    final id = _nextAsyncId++;
+    bindings.asyncBegin(_categoryId, nameId, id);
+    try {
+      return await body();
+    } finally {
+      bindings.asyncEnd(_categoryId, nameId, id);
+    }
+  }
+
+  void instant(String name) {
+    final bindings = _bindings;
+    if (bindings == null || !bindings.enabled()) return;
+    final nameId = _intern(name);
+    bindings.instant(_categoryId, nameId);
+  }
+
+  void counter(String name, num value) {
+    final bindings = _bindings;
+    if (bindings == null || !bindings.enabled()) return;
+    final nameId = _intern(name);
+    bindings.counter(_categoryId, nameId, value.toDouble());
+  }
+
+  int _intern(String name) {
+    final bindings = _bindings!;
+    if (_categoryId == 0) {
+      _categoryId = _internNative(bindings, _category);
+    }
+    return _ids.putIfAbsent(name, () => _internNative(bindings, name));
+  }
+
+  static int _internNative(NativeTraceBindings bindings, String text) =>
+      using((arena) =>
+          bindings.intern(text.toNativeUtf8(allocator: arena).cast()));
+}
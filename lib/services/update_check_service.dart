@@ -1,8 +1,6 @@
 import 'dart:convert';
-import 'dart:io';
 import 'package:flutter_dotenv/flutter_dotenv.dart';
 import 'package:http/http.dart' as http;
-import 'package:http/io_client.dart';
 import 'package:url_launcher/url_launcher.dart';
 import '../models/app_version_info.dart';
 import 'logger_service.dart';
@@ -13,17 +11,12 @@ class UpdateCheckService {
   static final UpdateCheckService _instance = UpdateCheckService._internal();
   factory UpdateCheckService() => _instance;
 
-  final _logger = LoggerService();
+  final _logger = LoggerService.subsystem('update');
   final _storage = StorageService();
 
-  // Custom HTTP client that bypasses SSL certificate verification
-  late final http.Client _httpClient = _createHttpClient();
-
-  http.Client _createHttpClient() {
-    final httpClient = HttpClient()
-      ..badCertificateCallback = (X509Certificate cert, String host, int port) => true;
-    return IOClient(httpClient);
-  }
+  // Verifies certificates, unlike the clients for our own servers: the
+  // release metadata carries the digest staged updates are checked against.
+  final http.Client _httpClient = http.Client();
 
   UpdateCheckService._internal();
 
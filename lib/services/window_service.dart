@@ -1,22 +1,45 @@
 import 'dart:io';
 import 'package:flutter/material.dart';
-import 'package:screen_retriever/screen_retriever.dart';
 import 'package:window_manager/window_manager.dart';
 import 'click_through_service.dart';
+import 'floating_view_service.dart';
 import 'logger_service.dart';
+import 'monitor_service.dart';
 
 class WindowService {
   static final WindowService _instance =
       WindowService._internal();
   factory WindowService() => _instance;
 
-  final _logger = LoggerService();
+  final _logger = LoggerService.subsystem('window');
+  final _floatingView = FloatingViewService();
   bool _isFloatingMode = false;
 
   WindowService._internal();
 
   bool get isFloatingMode => _isFloatingMode;
 
+  /// Whether the floating widget has a window of its own (the runner's
+  /// second view) rather than taking over the main one.
+  bool get hasFloatingView => _floatingView.isAttached;
+
+  // The floating widget's window, whichever window that is.
+  Future<Size> getFloatingSize() async => hasFloatingView
+      ? (await _floatingView.getFrame()).size
+      : await windowManager.getSize();
+
+  Future<Offset> getFloatingPosition() async => hasFloatingView
+      ? (await _floatingView.getFrame()).topLeft
+      : await windowManager.getPosition();
+
+  Future<void> setFloatingSize(Size size) => hasFloatingView
+      ? _floatingView.setSize(size)
+      : windowManager.setSize(size);
+
+  Future<void> setFloatingPosition(Offset position) => hasFloatingView
+      ? _floatingView.setPosition(position)
+      : windowManager.setPosition(position);
+
   // Get current window size
   Future<Size> getWindowSize() async {
     if (!_isDesktop()) return const Size(0, 0);
@@ -126,6 +149,16 @@ class WindowService {
   Future<void> switchToFloatingMode() async {
     if (!_isDesktop()) return;
 
+    if (hasFloatingView) {
+      _isFloatingMode = true;
+      // The widget is drawn in its view before the window is mapped, so
+      // the first thing on screen is the finished frame.
+      await WidgetsBinding.instance.endOfFrame;
+      await _floatingView.show();
+      _logger.info('Floating window shown');
+      return;
+    }
+
     try {
       // Exit fullscreen or maximized state before switching to floating mode
       if (await windowManager.isFullScreen()) {
@@ -155,13 +188,10 @@ class WindowService {
 
       // Position window at right edge of screen
       try {
-        final primaryDisplay = await screenRetriever
-            .getPrimaryDisplay();
-        final screenWidth = primaryDisplay.size.width;
-        final screenHeight = primaryDisplay.size.height;
+        final area = await MonitorService().primaryWorkArea();
         // Position so right edge aligns with screen edge
-        final x = screenWidth - _floatingWidth;
-        final y = (screenHeight - _floatingHeight) / 2;
+        final x = area.right - _floatingWidth;
+        final y = area.top + (area.height - _floatingHeight) / 2;
         await windowManager.setPosition(Offset(x, y));
       } catch (e) {
         _logger.warning(
@@ -227,6 +257,14 @@ class WindowService {
   Future<void> switchToMainMode() async {
     if (!_isDesktop()) return;
 
+    if (hasFloatingView) {
+      // The dashboard stayed built in the main view the whole time.
+      await _floatingView.hide();
+      _isFloatingMode = false;
+      _logger.info('Main window shown');
+      return;
+    }
+
     try {
       _isFloatingMode = false;
       _logger.info('Configuring main mode...');
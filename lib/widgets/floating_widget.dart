@@ -3,8 +3,6 @@ import 'dart:io';
 import 'dart:math' as math;
 import 'package:flutter/material.dart';
 import 'package:flutter_riverpod/flutter_riverpod.dart';
-import 'package:screen_retriever/screen_retriever.dart';
-import 'package:window_manager/window_manager.dart';
 import '../core/theme/app_theme.dart';
 import '../core/utils/date_time_utils.dart';
 import '../models/project.dart';
@@ -16,6 +14,8 @@ import '../providers/window_provider.dart';
 import '../providers/attendance_provider.dart';
 import '../providers/navigation_provider.dart';
 import '../services/click_through_service.dart';
+import '../services/monitor_service.dart';
+import '../services/window_service.dart';
 import '../models/project_with_time.dart';
 import 'floating_widget_constants.dart';
 import 'floating_project_item.dart';
@@ -50,6 +50,7 @@ class _FloatingWidgetState
 
   /// Timer for checking if window needs to snap back to right edge
   Timer? _snapBackTimer;
+  StreamSubscription<List<MonitorInfo>>? _monitorChanges;
 
   /// Search query for filtering projects
   String _searchQuery = '';
@@ -102,6 +103,11 @@ class _FloatingWidgetState
 
   /// Sets up click-through for Windows (entire window is click-through when collapsed)
   Future<void> _setupClickThrough() async {
+    if (WindowService().hasFloatingView) {
+      // Its own window is already mapped; no need to wait.
+      await ClickThroughService.setClickThroughEnabled(true);
+      return;
+    }
     if (!Platform.isWindows) return;
 
     // Wait for window to be fully ready
@@ -117,6 +123,15 @@ class _FloatingWidgetState
         !Platform.isLinux &&
         !Platform.isMacOS)
       return;
+    // Its own window only moves when dragged here, and on Wayland the
+    // compositor keeps it anchored to the edge. It goes back to the edge
+    // when the monitors change under it.
+    if (WindowService().hasFloatingView) {
+      _monitorChanges = MonitorService().changes.listen(
+        (_) => _checkAndSnapToRightEdge(),
+      );
+      return;
+    }
 
     // Check position every 2 seconds and snap back if moved
     _snapBackTimer = Timer.periodic(
@@ -135,7 +150,7 @@ class _FloatingWidgetState
     // Always allow vertical dragging, only snap horizontal position
 
     try {
-      final size = await windowManager.getSize();
+      final size = await WindowService().getFloatingSize();
 
       // If window is larger than floating widget, it's the dashboard - don't snap!
       if (size.width >
@@ -143,23 +158,18 @@ class _FloatingWidgetState
         return;
       }
 
-      final position = await windowManager.getPosition();
-
-      // Get primary display dimensions
-      final primaryDisplay = await screenRetriever
-          .getPrimaryDisplay();
-      final screenWidth = primaryDisplay.size.width;
+      final position = await WindowService().getFloatingPosition();
 
-      // Calculate right edge position
-      // Place window so its right edge aligns with screen right edge
-      final rightEdgeX = screenWidth - size.width;
+      // Right edge of the work area the window is on, in one call
+      // Preserve the vertical (y) position unless it is off that area
+      final snapped = await MonitorService().snapToRightEdge(
+        position & size,
+      );
 
       // If window has been moved away from right edge (more than 10px), snap it back
-      // Preserve the vertical (y) position to allow vertical dragging
-      if ((position.dx - rightEdgeX).abs() > 10) {
-        await windowManager.setPosition(
-          Offset(rightEdgeX, position.dy),
-        );
+      if ((position.dx - snapped.dx).abs() > 10 ||
+          position.dy != snapped.dy) {
+        await WindowService().setFloatingPosition(snapped);
       }
     } catch (e) {
       // Silently ignore snap errors
@@ -179,14 +189,14 @@ class _FloatingWidgetState
         const Duration(milliseconds: 250),
       );
 
-      final currentSize = await windowManager.getSize();
+      final currentSize = await WindowService().getFloatingSize();
 
       // If window height is less than baseHeight, resize it aggressively
       if (currentSize.height <
           FloatingWidgetConstants.baseHeight) {
         // Try multiple times to ensure the size sticks
         for (int i = 0; i < 3; i++) {
-          await windowManager.setSize(
+          await WindowService().setFloatingSize(
             Size(
               FloatingWidgetConstants.collapsedVisibleWidth,
               FloatingWidgetConstants.baseHeight,
@@ -196,7 +206,7 @@ class _FloatingWidgetState
             const Duration(milliseconds: 100),
           );
 
-          final checkSize = await windowManager.getSize();
+          final checkSize = await WindowService().getFloatingSize();
           if (checkSize.height >=
               FloatingWidgetConstants.baseHeight) {
             break;
@@ -212,6 +222,7 @@ class _FloatingWidgetState
   void dispose() {
     // Cancel timers
     _snapBackTimer?.cancel();
+    _monitorChanges?.cancel();
     _collapseTimer?.cancel();
     // Dispose search controller
     _searchController.dispose();
@@ -250,7 +261,7 @@ class _FloatingWidgetState
           : FloatingWidgetConstants.baseHeight;
 
       // Width is always fixed at 280px
-      await windowManager.setSize(
+      await WindowService().setFloatingSize(
         Size(
           FloatingWidgetConstants.fixedWidgetWidth,
           height,
@@ -532,7 +543,7 @@ class _FloatingWidgetState
           return;
         }
         // Capture initial positions for Y-axis only dragging
-        final windowPos = await windowManager.getPosition();
+        final windowPos = await WindowService().getFloatingPosition();
         _dragStartPosition = details.globalPosition;
         _dragStartWindowY = windowPos.dy;
         _fixedWindowX = windowPos.dx;
@@ -547,12 +558,16 @@ class _FloatingWidgetState
         final deltaY = details.globalPosition.dy - _dragStartPosition!.dy;
         final newY = _dragStartWindowY! + deltaY;
         // Keep X fixed, only update Y (fire-and-forget for smooth movement)
-        windowManager.setPosition(Offset(_fixedWindowX!, newY));
+        WindowService().setFloatingPosition(Offset(_fixedWindowX!, newY));
       },
       onPanEnd: (_) {
         // Clear drag state
         _dragStartPosition = null;
         _dragStartWindowY = null;
+        // Dragged past the top or bottom of the screen: bring it back
+        if (WindowService().hasFloatingView) {
+          _checkAndSnapToRightEdge();
+        }
       },
       child: MouseRegion(
         onHover: (event) {
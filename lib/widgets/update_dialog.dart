@@ -4,11 +4,16 @@ import 'package:url_launcher/url_launcher.dart';
 import '../core/theme/app_theme.dart';
 import '../models/app_version_info.dart';
 import '../services/app_info_service.dart';
+import '../services/delta_update_service.dart';
 import '../services/logger_service.dart';
 
 /// Mandatory update dialog - users MUST update to continue using the app
 /// No "Later" or "Skip" buttons - only "Update Now"
-class UpdateDialog extends StatelessWidget {
+///
+/// On Linux, when the release carries a delta for the installed version, the
+/// update is downloaded and installed in place and the app restarts into it;
+/// otherwise the download page opens in the browser.
+class UpdateDialog extends StatefulWidget {
   final AppVersionInfo versionInfo;
 
   const UpdateDialog({
@@ -29,6 +34,57 @@ class UpdateDialog extends StatelessWidget {
     );
   }
 
+  @override
+  State<UpdateDialog> createState() => _UpdateDialogState();
+}
+
+class _UpdateDialogState extends State<UpdateDialog> {
+  final _deltaUpdates = DeltaUpdateService();
+
+  AppVersionInfo get versionInfo => widget.versionInfo;
+
+  // Non-null while an in-place update is running.
+  DeltaUpdateProgress? _progress;
+
+  Future<void> _startUpdate(BuildContext context) async {
+    if (!_deltaUpdates.canStage(versionInfo)) {
+      return _downloadUpdate(context);
+    }
+
+    setState(() => _progress =
+        const DeltaUpdateProgress(DeltaUpdatePhase.downloading));
+    try {
+      await _deltaUpdates.stage(
+        versionInfo,
+        onProgress: (progress) {
+          if (mounted) setState(() => _progress = progress);
+        },
+      );
+      await _deltaUpdates.restart();
+    } catch (e, stackTrace) {
+      LoggerService().error('In-place update failed', e, stackTrace);
+      if (!mounted) return;
+      setState(() => _progress = null);
+      // The full installer still works.
+      if (context.mounted) await _downloadUpdate(context);
+    }
+  }
+
+  String get _progressLabel {
+    final progress = _progress!;
+    switch (progress.phase) {
+      case DeltaUpdatePhase.downloading:
+        final total = progress.total;
+        if (total <= 0) return 'Downloading...';
+        String mb(int bytes) => (bytes / (1 << 20)).toStringAsFixed(1);
+        return 'Downloading ${mb(progress.received)} / ${mb(total)} MB';
+      case DeltaUpdatePhase.verifying:
+        return 'Verifying...';
+      case DeltaUpdatePhase.installing:
+        return 'Installing...';
+    }
+  }
+
   Future<void> _downloadUpdate(BuildContext context) async {
     final logger = LoggerService();
     try {
@@ -180,12 +236,30 @@ class UpdateDialog extends StatelessWidget {
                 ),
                 const SizedBox(height: 24),
 
+                if (_progress != null) ...[
+                  LinearProgressIndicator(
+                    value: _progress!.fraction,
+                    color: AppTheme.secondaryColor,
+                    backgroundColor: AppTheme.elevatedSurfaceColor,
+                  ),
+                  const SizedBox(height: 8),
+                  Text(
+                    _progressLabel,
+                    style: TextStyle(
+                      fontSize: 12,
+                      color: AppTheme.textSecondary,
+                    ),
+                  ),
+                  const SizedBox(height: 16),
+                ],
+
                 // Update Now button - ONLY button, no "Later" or "Skip"
                 SizedBox(
                   width: double.infinity,
                   height: 50,
                   child: ElevatedButton.icon(
-                    onPressed: () => _downloadUpdate(context),
+                    onPressed:
+                        _progress == null ? () => _startUpdate(context) : null,
                     icon: const Icon(Icons.download_rounded, size: 20),
                     label: const Text(
                       'Update Now',
@@ -0,0 +1,212 @@
+// Patch size and time to create, apply and verify a bundle patch.
+//
+// By default runs on synthetic bundles shaped like a release build: a large
+// engine library that did not change, an AOT snapshot and the native
+// library recompiled with code inserted (so later addresses shift), an
+// unchanged ICU data file and a directory of assets with a few edits.
+// Set SS_UPDATE_OLD_BUNDLE and SS_UPDATE_NEW_BUNDLE to two real
+// `flutter build linux` bundles to measure those instead.
+
+#include <benchmark/benchmark.h>
+
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "update/bundle_manifest.h"
+#include "update/bundle_patch.h"
+
+namespace {
+
+struct Fixture {
+  std::string root;
+  std::string old_bundle;
+  std::string new_bundle;
+  std::string patch;
+  BundlePatchStats stats;
+  double create_seconds = 0;
+};
+
+void WriteFile(const std::string& path, const std::vector<uint8_t>& data) {
+  FILE* file = fopen(path.c_str(), "wb");
+  fwrite(data.data(), 1, data.size(), file);
+  fclose(file);
+}
+
+// Machine-code-like bytes: a small set of opcodes followed by 32-bit
+// operands that are mostly nearby addresses.
+std::vector<uint8_t> CodeLike(size_t size, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::vector<uint8_t> data;
+  data.reserve(size + 8);
+  static const uint8_t kOpcodes[] = {0x48, 0x89, 0x8b, 0xe8, 0xc3,
+                                     0x0f, 0x85, 0x74, 0x31, 0xff};
+  while (data.size() < size) {
+    data.push_back(kOpcodes[rng() % sizeof(kOpcodes)]);
+    if (rng() % 3 == 0) {
+      uint32_t operand = static_cast<uint32_t>(data.size()) + rng() % 4096;
+      for (int i = 0; i < 4; i++) {
+        data.push_back(static_cast<uint8_t>(operand >> (8 * i)));
+      }
+    }
+  }
+  data.resize(size);
+  return data;
+}
+
+// What recompiling after a small source change does: a few functions grow,
+// and operands pointing past them move.
+std::vector<uint8_t> Recompiled(const std::vector<uint8_t>& old_data,
+                                uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::vector<uint8_t> data = old_data;
+  for (int edit = 0; edit < 6; edit++) {
+    size_t at = rng() % data.size();
+    std::vector<uint8_t> inserted = CodeLike(512 + rng() % 4096, rng());
+    data.insert(data.begin() + at, inserted.begin(), inserted.end());
+  }
+  for (size_t i = 0; i + 4 < data.size(); i += 97 + rng() % 64) {
+    data[i] += 16;
+  }
+  return data;
+}
+
+void MakeDirectory(const std::string& path) {
+  mkdir(path.c_str(), 0755);
+}
+
+void WriteBundle(const std::string& root, bool updated) {
+  MakeDirectory(root);
+  MakeDirectory(root + "/lib");
+  MakeDirectory(root + "/data");
+  MakeDirectory(root + "/data/flutter_assets");
+
+  std::vector<uint8_t> binary = CodeLike(300 << 10, 1);
+  std::vector<uint8_t> app = CodeLike(9 << 20, 2);
+  std::vector<uint8_t> native = CodeLike(1 << 20, 3);
+  if (updated) {
+    app = Recompiled(app, 20);
+    native = Recompiled(native, 30);
+  }
+  WriteFile(root + "/silver_stone", binary);
+  chmod((root + "/silver_stone").c_str(), 0755);
+  WriteFile(root + "/lib/libflutter_linux_gtk.so", CodeLike(28 << 20, 4));
+  WriteFile(root + "/lib/libapp.so", app);
+  WriteFile(root + "/lib/libsilver_stone_native.so", native);
+  WriteFile(root + "/data/icudtl.dat", CodeLike(10 << 20, 5));
+
+  for (int i = 0; i < 60; i++) {
+    if (updated && i == 7) {
+      continue;  // Removed asset.
+    }
+    uint32_t seed = 100 + i + (updated && i % 20 == 3 ? 1000 : 0);
+    WriteFile(root + "/data/flutter_assets/asset_" + std::to_string(i),
+              CodeLike(8192 + i * 512, seed));
+  }
+  if (updated) {
+    WriteFile(root + "/data/flutter_assets/asset_new", CodeLike(40000, 999));
+  }
+}
+
+Fixture& GetFixture() {
+  static Fixture* fixture = [] {
+    Fixture* f = new Fixture();
+    char root[] = "/tmp/ss_bundle_patch_XXXXXX";
+    f->root = mkdtemp(root);
+    const char* old_env = getenv("SS_UPDATE_OLD_BUNDLE");
+    const char* new_env = getenv("SS_UPDATE_NEW_BUNDLE");
+    if (old_env != nullptr && new_env != nullptr) {
+      f->old_bundle = old_env;
+      f->new_bundle = new_env;
+    } else {
+      f->old_bundle = f->root + "/old";
+      f->new_bundle = f->root + "/new";
+      WriteBundle(f->old_bundle, false);
+      WriteBundle(f->new_bundle, true);
+    }
+    f->patch = f->root + "/update.sspatch";
+    return f;
+  }();
+  return *fixture;
+}
+
+void BM_CreatePatch(benchmark::State& state) {
+  Fixture& fixture = GetFixture();
+  std::string error;
+  for (auto _ : state) {
+    if (!CreateBundlePatch(fixture.old_bundle, fixture.new_bundle,
+                           fixture.patch, &fixture.stats, &error)) {
+      state.SkipWithError(error.c_str());
+      return;
+    }
+  }
+  state.counters["target_bytes"] =
+      static_cast<double>(fixture.stats.target_bytes);
+  state.counters["patch_bytes"] =
+      static_cast<double>(fixture.stats.patch_bytes);
+  state.counters["patched"] = fixture.stats.patched;
+  state.counters["kept"] = fixture.stats.kept;
+  state.counters["stored"] = fixture.stats.added;
+}
+BENCHMARK(BM_CreatePatch)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+// Rebuilds the new bundle from the old one and verifies every file.
+void BM_ApplyPatch(benchmark::State& state) {
+  Fixture& fixture = GetFixture();
+  const std::string staging = fixture.root + "/staged";
+  std::string error;
+  BundlePatchStats stats;
+  for (auto _ : state) {
+    if (!ApplyBundlePatch(fixture.old_bundle, fixture.patch, staging,
+                          static_cast<int>(state.range(0)), &stats,
+                          &error)) {
+      state.SkipWithError(error.c_str());
+      return;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * stats.target_bytes);
+  RemoveTree(staging);
+}
+BENCHMARK(BM_ApplyPatch)
+    ->Arg(1)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_VerifyBundle(benchmark::State& state) {
+  Fixture& fixture = GetFixture();
+  std::vector<BundleEntry> entries;
+  std::string error;
+  for (auto _ : state) {
+    if (!ScanBundle(fixture.new_bundle, static_cast<int>(state.range(0)),
+                    &entries, &error)) {
+      state.SkipWithError(error.c_str());
+      return;
+    }
+  }
+  uint64_t bytes = 0;
+  for (const BundleEntry& entry : entries) {
+    bytes += entry.size;
+  }
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_VerifyBundle)
+    ->Arg(1)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  RemoveTree(GetFixture().root);
+  return 0;
+}
@@ -0,0 +1,57 @@
+// Cost the runner's channel instrumentation adds to each platform message.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "diagnostics/channel_metrics.h"
+
+namespace {
+
+// "setClickThroughEnabled" encoded by StandardMethodCodec, with a bool.
+const uint8_t kMessage[] = {7,   22,  's', 'e', 't', 'C', 'l', 'i', 'c',
+                            'k', 'T', 'h', 'r', 'o', 'u', 'g', 'h', 'E',
+                            'n', 'a', 'b', 'l', 'e', 'd', 1};
+
+// All the runner does per message while metrics are off.
+void BM_Disabled(benchmark::State& state) {
+  ChannelMetrics& metrics = ChannelMetrics::Get();
+  metrics.SetEnabled(false);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(metrics.enabled());
+  }
+}
+BENCHMARK(BM_Disabled);
+
+// Lookup plus one sample, the full per-call cost while enabled.
+void BM_EnabledCall(benchmark::State& state) {
+  ChannelMetrics& metrics = ChannelMetrics::Get();
+  metrics.SetEnabled(true);
+  ChannelCallSample sample;
+  sample.request_bytes = sizeof(kMessage);
+  sample.response_bytes = 1;
+  uint64_t i = 0;
+  for (auto _ : state) {
+    MethodMetrics* method = metrics.ForMessage(
+        "com.worktracker/click_through", kMessage, sizeof(kMessage));
+    sample.handler_us = 20 + (i & 63);
+    sample.response_us = 40 + (i++ & 255);
+    method->Record(sample);
+  }
+  metrics.SetEnabled(false);
+}
+BENCHMARK(BM_EnabledCall);
+
+void BM_HistogramRecord(benchmark::State& state) {
+  HdrHistogram histogram;
+  uint64_t value = 1;
+  for (auto _ : state) {
+    histogram.Record(value);
+    value = value * 7 % 1000003;
+  }
+}
+BENCHMARK(BM_HistogramRecord);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,122 @@
+// The binary delta byte kernels at each SIMD level this CPU supports. Every
+// vector run reports "speedup", its time against the scalar kernel on the
+// same input.
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "update/delta_kernels.h"
+
+namespace {
+
+constexpr int64_t kSize = 64 * 1024;
+
+struct Inputs {
+  std::vector<uint8_t> a;
+  std::vector<uint8_t> b;
+  std::vector<uint8_t> out;
+
+  Inputs() : a(kSize), b(kSize), out(kSize) {
+    std::mt19937 rng(7);
+    for (int64_t i = 0; i < kSize; i++) {
+      a[i] = static_cast<uint8_t>(rng());
+      // Mostly equal, like code that only moved.
+      b[i] = rng() % 16 == 0 ? static_cast<uint8_t>(rng()) : a[i];
+    }
+  }
+};
+
+const Inputs& GetInputs() {
+  static const Inputs* inputs = new Inputs();
+  return *inputs;
+}
+
+enum Kernel { kMismatch, kCountEqual, kAdd };
+
+void Run(const DeltaKernels& kernels, Kernel kernel, const Inputs& in,
+         uint8_t* out) {
+  switch (kernel) {
+    case kMismatch:
+      // Identical inputs, so the whole buffer is compared.
+      benchmark::DoNotOptimize(kernels.mismatch(in.a.data(), in.a.data(),
+                                                kSize));
+      break;
+    case kCountEqual:
+      benchmark::DoNotOptimize(
+          kernels.count_equal(in.a.data(), in.b.data(), kSize));
+      break;
+    case kAdd:
+      kernels.add(in.a.data(), in.b.data(), out, kSize);
+      benchmark::ClobberMemory();
+      break;
+  }
+}
+
+// Seconds per call of the scalar kernel.
+double ScalarSeconds(Kernel kernel) {
+  static double seconds[3] = {0, 0, 0};
+  if (seconds[kernel] == 0) {
+    const Inputs& in = GetInputs();
+    std::vector<uint8_t> out(kSize);
+    const DeltaKernels& scalar = DeltaKernelsFor(SimdLevel::kScalar);
+    for (int i = 0; i < 50; i++) {
+      Run(scalar, kernel, in, out.data());
+    }
+    constexpr int kCalls = 500;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kCalls; i++) {
+      Run(scalar, kernel, in, out.data());
+    }
+    seconds[kernel] = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start)
+                          .count() /
+                      kCalls;
+  }
+  return seconds[kernel];
+}
+
+void BM_Kernel(benchmark::State& state) {
+  const Kernel kernel = static_cast<Kernel>(state.range(0));
+  const SimdLevel level = static_cast<SimdLevel>(state.range(1));
+  if (level > DetectSimdLevel()) {
+    state.SkipWithError("not supported by this CPU");
+    return;
+  }
+  const Inputs& in = GetInputs();
+  std::vector<uint8_t> out(kSize);
+  const DeltaKernels& kernels = DeltaKernelsFor(level);
+  state.SetLabel(SimdLevelName(level));
+  const double scalar_seconds =
+      level != SimdLevel::kScalar ? ScalarSeconds(kernel) : 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (auto _ : state) {
+    Run(kernels, kernel, in, out.data());
+  }
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  state.SetBytesProcessed(state.iterations() * kSize);
+  if (level != SimdLevel::kScalar && seconds > 0) {
+    state.counters["speedup"] =
+        scalar_seconds * state.iterations() / seconds;
+  }
+}
+
+void Levels(benchmark::internal::Benchmark* b) {
+  for (int kernel : {kMismatch, kCountEqual, kAdd}) {
+    for (SimdLevel level :
+         {SimdLevel::kScalar, SimdLevel::kAvx2, SimdLevel::kAvx512}) {
+      b->Args({kernel, static_cast<int>(level)});
+    }
+  }
+  b->ArgNames({"kernel", "level"});
+}
+BENCHMARK(BM_Kernel)->Apply(Levels)->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
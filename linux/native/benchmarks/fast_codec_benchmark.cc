@@ -0,0 +1,182 @@
+// One round trip of a runner channel call, as the native side sees it:
+// encode the call, decode it and run a no-op handler, encode the reply,
+// decode the reply. The generated fast-path codec against the
+// StandardMethodCodec the same call goes through on a MethodChannel.
+//
+// The standard side goes through standard_codec_model.h, which decodes into
+// owned values the way flutter::EncodableValue does; the engine hop and the
+// Dart side are not part of either number.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "benchmarks/standard_codec_model.h"
+#include "codec/fast_messages.g.h"
+
+namespace {
+
+using fast_messages::audio_recorder::StartRecordingArgs;
+using fast_messages::audio_recorder::StartRecordingResult;
+using fast_messages::click_through::SetClickThroughEnabledArgs;
+using fast_messages::click_through::SetClickThroughEnabledResult;
+
+constexpr char kPath[] =
+    "/home/user/.local/share/silver_stone/recordings/recording-1718000000.m4a";
+
+class NoOpRecorder : public fast_messages::audio_recorder::Handler {
+ public:
+  bool HasPermission(const fast_messages::audio_recorder::HasPermissionArgs&,
+                     fast_messages::audio_recorder::HasPermissionResult*,
+                     FastError*) override {
+    return true;
+  }
+  bool StartRecording(const StartRecordingArgs& args,
+                      StartRecordingResult* result, FastError*) override {
+    result->started = args.path.size > 0;
+    return true;
+  }
+  bool StopRecording(const fast_messages::audio_recorder::StopRecordingArgs&,
+                     fast_messages::audio_recorder::StopRecordingResult*,
+                     FastError*) override {
+    return true;
+  }
+  bool IsRecording(const fast_messages::audio_recorder::IsRecordingArgs&,
+                   fast_messages::audio_recorder::IsRecordingResult*,
+                   FastError*) override {
+    return true;
+  }
+};
+
+class NoOpClickThrough : public fast_messages::click_through::Handler {
+ public:
+  bool SetClickThroughEnabled(const SetClickThroughEnabledArgs& args,
+                              SetClickThroughEnabledResult*,
+                              FastError*) override {
+    enabled = args.enabled;
+    return true;
+  }
+  bool RestoreNormalWindowStyle(
+      const fast_messages::click_through::RestoreNormalWindowStyleArgs&,
+      fast_messages::click_through::RestoreNormalWindowStyleResult*,
+      FastError*) override {
+    return true;
+  }
+  bool SetFrameless(const fast_messages::click_through::SetFramelessArgs&,
+                    fast_messages::click_through::SetFramelessResult*,
+                    FastError*) override {
+    return true;
+  }
+
+  bool enabled = false;
+};
+
+// Decodes a StandardMethodCodec call into its method name and arguments.
+bool DecodeStandardCall(const std::vector<uint8_t>& message,
+                        std::string* method, StandardValue* arguments) {
+  standard_codec::Reader reader(message.data(), message.size());
+  return reader.ReadString(method) && reader.ReadValue(arguments);
+}
+
+bool DecodeStandardCall(const std::vector<uint8_t>& message,
+                        std::string* method, StandardMap* arguments) {
+  standard_codec::Reader reader(message.data(), message.size());
+  return reader.ReadString(method) && reader.ReadMap(arguments);
+}
+
+bool DecodeStandardReply(const std::vector<uint8_t>& reply,
+                         StandardValue* result) {
+  standard_codec::Reader reader(reply.data(), reply.size());
+  uint8_t envelope;
+  return reader.Byte(&envelope) && envelope == 0 && reader.ReadValue(result);
+}
+
+void BM_FastStartRecording(benchmark::State& state) {
+  NoOpRecorder recorder;
+  StartRecordingArgs args;
+  args.path = FastStringView{kPath, sizeof(kPath) - 1};
+  for (auto _ : state) {
+    const std::vector<uint8_t> call =
+        fast_messages::audio_recorder::EncodeStartRecording(args);
+    const std::vector<uint8_t> reply = fast_messages::audio_recorder::Dispatch(
+        &recorder, call.data(), call.size());
+    StartRecordingResult result;
+    FastError error;
+    benchmark::DoNotOptimize(
+        fast_messages::audio_recorder::DecodeStartRecordingReply(
+            reply.data(), reply.size(), &result, &error));
+    benchmark::DoNotOptimize(result.started);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FastStartRecording);
+
+void BM_StandardStartRecording(benchmark::State& state) {
+  for (auto _ : state) {
+    const std::vector<uint8_t> call = standard_codec::EncodeMethodCall(
+        "startRecording", StandardMap{{"path", std::string(kPath)}});
+    std::string method;
+    StandardMap arguments;
+    bool started = false;
+    if (DecodeStandardCall(call, &method, &arguments) &&
+        method == "startRecording") {
+      auto path = arguments.find("path");
+      started = path != arguments.end() &&
+                !std::get<std::string>(path->second).empty();
+    }
+    const std::vector<uint8_t> reply =
+        standard_codec::EncodeSuccessEnvelope(StandardValue(started));
+    StandardValue result;
+    benchmark::DoNotOptimize(DecodeStandardReply(reply, &result));
+    benchmark::DoNotOptimize(std::get<bool>(result));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StandardStartRecording);
+
+void BM_FastSetClickThrough(benchmark::State& state) {
+  NoOpClickThrough window;
+  SetClickThroughEnabledArgs args;
+  for (auto _ : state) {
+    args.enabled = !args.enabled;
+    const std::vector<uint8_t> call =
+        fast_messages::click_through::EncodeSetClickThroughEnabled(args);
+    const std::vector<uint8_t> reply = fast_messages::click_through::Dispatch(
+        &window, call.data(), call.size());
+    SetClickThroughEnabledResult result;
+    FastError error;
+    benchmark::DoNotOptimize(
+        fast_messages::click_through::DecodeSetClickThroughEnabledReply(
+            reply.data(), reply.size(), &result, &error));
+  }
+  benchmark::DoNotOptimize(window.enabled);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FastSetClickThrough);
+
+void BM_StandardSetClickThrough(benchmark::State& state) {
+  bool enabled = false;
+  for (auto _ : state) {
+    const std::vector<uint8_t> call = standard_codec::EncodeMethodCall(
+        "setClickThroughEnabled", StandardValue(!enabled));
+    std::string method;
+    StandardValue argument;
+    if (DecodeStandardCall(call, &method, &argument) &&
+        method == "setClickThroughEnabled") {
+      enabled = std::get<bool>(argument);
+    }
+    const std::vector<uint8_t> reply =
+        standard_codec::EncodeSuccessEnvelope(StandardValue());
+    StandardValue result;
+    benchmark::DoNotOptimize(DecodeStandardReply(reply, &result));
+  }
+  benchmark::DoNotOptimize(enabled);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StandardSetClickThrough);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,158 @@
+// Ingesting a large drop: one thread reading every file in turn against the
+// per-file tasks of IngestJob. Set SS_INGEST_DROP_DIR to a directory of real
+// attachments to measure those instead of the generated ones.
+
+#include <benchmark/benchmark.h>
+
+#include <dirent.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "ingest/file_ingest.h"
+#include "ingest/ingest_job.h"
+
+namespace {
+
+struct Fixture {
+  std::vector<std::string> paths;
+  uint64_t bytes = 0;
+};
+
+std::vector<uint8_t> Noise(size_t size, uint32_t seed) {
+  std::vector<uint8_t> data(size);
+  for (uint8_t& byte : data) {
+    seed = seed * 1664525u + 1013904223u;
+    byte = static_cast<uint8_t>(seed >> 24);
+  }
+  return data;
+}
+
+void WriteFile(const std::string& path, const std::vector<uint8_t>& data) {
+  std::ofstream(path, std::ios::binary)
+      .write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+// 48 files, 2 to 9 MiB each, a third each of PNG, JPEG and PDF: a site
+// visit's photos and drawings dropped at once.
+void WriteDrop(Fixture* f, const std::string& root) {
+  for (int i = 0; i < 48; i++) {
+    std::vector<uint8_t> data = Noise((2 + i % 8) << 20, 17 + i);
+    std::string name;
+    switch (i % 3) {
+      case 0: {
+        const uint8_t png[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n',
+                               0,    0,   0,   13,  'I',  'H',  'D',  'R',
+                               0,    0,   0x0F, 0xC0, 0,   0,   0x0B, 0xD0};
+        std::copy(std::begin(png), std::end(png), data.begin());
+        name = "photo_" + std::to_string(i) + ".png";
+        break;
+      }
+      case 1: {
+        const uint8_t jpeg[] = {0xFF, 0xD8, 0xFF, 0xC0, 0,    17,
+                                8,    0x0B, 0xD0, 0x0F, 0xC0};
+        std::copy(std::begin(jpeg), std::end(jpeg), data.begin());
+        name = "photo_" + std::to_string(i) + ".jpg";
+        break;
+      }
+      default: {
+        // Page dictionaries between binary streams.
+        const std::string page = "\n<< /Type /Page /Parent 2 0 R >>\n";
+        for (size_t at = 0; at + page.size() < data.size(); at += 64 << 10) {
+          std::copy(page.begin(), page.end(), data.begin() + at);
+        }
+        const std::string header = "%PDF-1.7\n";
+        std::copy(header.begin(), header.end(), data.begin());
+        name = "drawing_" + std::to_string(i) + ".pdf";
+        break;
+      }
+    }
+    f->paths.push_back(root + "/" + name);
+    f->bytes += data.size();
+    WriteFile(f->paths.back(), data);
+  }
+}
+
+Fixture& GetFixture() {
+  static Fixture* fixture = [] {
+    Fixture* f = new Fixture();
+    const char* dir_env = getenv("SS_INGEST_DROP_DIR");
+    if (dir_env != nullptr) {
+      if (DIR* dir = opendir(dir_env)) {
+        while (dirent* entry = readdir(dir)) {
+          if (entry->d_name[0] != '.') {
+            f->paths.push_back(std::string(dir_env) + "/" + entry->d_name);
+          }
+        }
+        closedir(dir);
+      }
+    } else {
+      char root[] = "/tmp/ss_file_ingest_XXXXXX";
+      WriteDrop(f, mkdtemp(root));
+    }
+    return f;
+  }();
+  return *fixture;
+}
+
+void ReportBytes(benchmark::State& state, const Fixture& fixture,
+                 uint64_t bytes) {
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * bytes);
+  state.counters["files"] = static_cast<double>(fixture.paths.size());
+}
+
+void BM_IngestSerial(benchmark::State& state) {
+  Fixture& fixture = GetFixture();
+  uint64_t bytes = 0;
+  for (auto _ : state) {
+    bytes = 0;
+    for (const std::string& path : fixture.paths) {
+      IngestResult result;
+      IngestFile(path, IngestLimits(), nullptr, &result);
+      bytes += result.size;
+      benchmark::DoNotOptimize(result.sha256[0]);
+    }
+  }
+  ReportBytes(state, fixture, bytes);
+}
+BENCHMARK(BM_IngestSerial)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Also reports how long the first result takes, which is when the dialog
+// can start showing the drop.
+void BM_IngestJob(benchmark::State& state) {
+  Fixture& fixture = GetFixture();
+  std::atomic<uint64_t> bytes{0};
+  double first_ms = 0;
+  for (auto _ : state) {
+    bytes = 0;
+    std::atomic<bool> first{true};
+    const auto start = std::chrono::steady_clock::now();
+    auto job = IngestJob::Start(
+        fixture.paths, IngestLimits(),
+        [&](size_t, const IngestResult& result) {
+          bytes += result.size;
+          if (first.exchange(false)) {
+            first_ms += std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+          }
+        },
+        nullptr);
+    job->Wait();
+  }
+  ReportBytes(state, fixture, bytes.load());
+  state.counters["first_result_ms"] =
+      first_ms / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_IngestJob)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,83 @@
+// Per-call cost of the structured logger as seen by the calling thread.
+//
+// Run with --benchmark_min_time=1 for stable numbers; the writer thread is
+// live and writing to a temporary directory throughout.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <string>
+
+#include "logging/logger.h"
+
+namespace {
+
+class LoggerFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const benchmark::State& state) override {
+    if (state.thread_index() != 0) {
+      return;
+    }
+    char directory[] = "/tmp/ss_log_benchXXXXXX";
+    LoggerConfig config;
+    config.directory = mkdtemp(directory);
+    config.min_level = LogLevel::kInfo;
+    // Keep the ring from filling so drops do not flatter the numbers.
+    config.flush_interval_ms = 50;
+    Logger::Get().Open(config);
+  }
+
+  void TearDown(const benchmark::State& state) override {
+    if (state.thread_index() == 0) {
+      Logger::Get().Close();
+    }
+  }
+};
+
+BENCHMARK_DEFINE_F(LoggerFixture, DisabledLevel)(benchmark::State& state) {
+  for (auto _ : state) {
+    SS_LOG(LogLevel::kDebug, "bench", "dropped {}", 42);
+  }
+}
+BENCHMARK_REGISTER_F(LoggerFixture, DisabledLevel);
+
+BENCHMARK_DEFINE_F(LoggerFixture, IntArgs)(benchmark::State& state) {
+  int64_t i = 0;
+  for (auto _ : state) {
+    SS_LOG(LogLevel::kInfo, "bench", "tick {} of {}", i++, 1000);
+  }
+  state.counters["dropped"] =
+      static_cast<double>(Logger::Get().stats().records_dropped);
+}
+BENCHMARK_REGISTER_F(LoggerFixture, IntArgs);
+
+BENCHMARK_DEFINE_F(LoggerFixture, ShortString)(benchmark::State& state) {
+  const std::string message = "Fetching my daily reports...";
+  for (auto _ : state) {
+    SS_LOG(LogLevel::kInfo, "bench", "{}", message);
+  }
+}
+BENCHMARK_REGISTER_F(LoggerFixture, ShortString);
+
+// A response body that gets truncated and sampled.
+BENCHMARK_DEFINE_F(LoggerFixture, OversizedPayload)(benchmark::State& state) {
+  const std::string body(16 * 1024, 'x');
+  for (auto _ : state) {
+    SS_LOG(LogLevel::kInfo, "bench", "Time entries response body: {}", body);
+  }
+  state.counters["sampled_out"] =
+      static_cast<double>(Logger::Get().stats().records_sampled_out);
+}
+BENCHMARK_REGISTER_F(LoggerFixture, OversizedPayload);
+
+BENCHMARK_DEFINE_F(LoggerFixture, Contended)(benchmark::State& state) {
+  int64_t i = 0;
+  for (auto _ : state) {
+    SS_LOG(LogLevel::kInfo, "bench", "thread tick {}", i++);
+  }
+}
+BENCHMARK_REGISTER_F(LoggerFixture, Contended)->Threads(4);
+
+}  // namespace
+
+BENCHMARK_MAIN();
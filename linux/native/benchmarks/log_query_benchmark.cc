@@ -0,0 +1,157 @@
+// Query latency over a month of archived logs.
+//
+// The archive is generated once per run: 30 daily segments of about 4 MiB
+// each, written in the logger's on-disk format and archived with
+// ArchiveLogSegment(), so the queries see exactly what the app leaves
+// behind.
+
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "logging/log_archive.h"
+#include "logging/log_query.h"
+#include "logging/log_record.h"
+
+namespace {
+
+constexpr int kDays = 30;
+constexpr int kRecordsPerDay = 50000;
+constexpr uint64_t kDayUs = 86400ull * 1000000;
+constexpr uint64_t kMonthStartUs = 1790000000ull * 1000000;
+
+const char* const kSubsystems[] = {"api", "timer", "window", "socket"};
+const char* const kFormats[] = {"Request {} finished in {} ms",
+                                "Timer tick {} for task {}",
+                                "Window moved to {}",
+                                "Socket heartbeat {}"};
+
+void AppendDefinition(std::vector<uint8_t>* out, uint32_t id,
+                      const std::string& text) {
+  uint16_t length = static_cast<uint16_t>(text.size());
+  out->push_back(static_cast<uint8_t>(LogEntryKind::kDefinition));
+  out->insert(out->end(), reinterpret_cast<uint8_t*>(&id),
+              reinterpret_cast<uint8_t*>(&id) + 4);
+  out->insert(out->end(), reinterpret_cast<uint8_t*>(&length),
+              reinterpret_cast<uint8_t*>(&length) + 2);
+  out->insert(out->end(), text.begin(), text.end());
+}
+
+void AppendRecord(std::vector<uint8_t>* out, uint64_t timestamp_us,
+                  uint32_t subsystem, LogLevel level, int64_t value,
+                  const std::string& text) {
+  std::vector<uint8_t> payload;
+  payload.push_back(static_cast<uint8_t>(LogArgType::kInt));
+  payload.insert(payload.end(), reinterpret_cast<uint8_t*>(&value),
+                 reinterpret_cast<uint8_t*>(&value) + 8);
+  uint16_t length = static_cast<uint16_t>(text.size());
+  payload.push_back(static_cast<uint8_t>(LogArgType::kString));
+  payload.insert(payload.end(), reinterpret_cast<uint8_t*>(&length),
+                 reinterpret_cast<uint8_t*>(&length) + 2);
+  payload.insert(payload.end(), text.begin(), text.end());
+
+  LogRecordHeader header;
+  header.timestamp_us = timestamp_us;
+  header.format_id = subsystem + 10;
+  header.subsystem_id = static_cast<uint16_t>(subsystem);
+  header.payload_size = static_cast<uint16_t>(payload.size());
+  header.thread_id = 1000 + subsystem;
+  header.level = static_cast<uint8_t>(level);
+  header.arg_count = 2;
+  header.flags = 0;
+  out->push_back(static_cast<uint8_t>(LogEntryKind::kRecord));
+  out->insert(out->end(), reinterpret_cast<uint8_t*>(&header),
+              reinterpret_cast<uint8_t*>(&header) + sizeof(header));
+  out->insert(out->end(), payload.begin(), payload.end());
+}
+
+const std::string& ArchiveDirectory() {
+  static const std::string directory = [] {
+    char path[] = "/tmp/ss_log_query_benchXXXXXX";
+    std::string dir = mkdtemp(path);
+    for (int day = 0; day < kDays; day++) {
+      std::vector<uint8_t> segment;
+      LogSegmentHeader header;
+      std::memcpy(header.magic, kLogSegmentMagic, sizeof(header.magic));
+      header.version = kLogFormatVersion;
+      header.start_time_us = kMonthStartUs + day * kDayUs;
+      segment.insert(segment.end(), reinterpret_cast<uint8_t*>(&header),
+                     reinterpret_cast<uint8_t*>(&header) + sizeof(header));
+      for (uint32_t s = 0; s < 4; s++) {
+        AppendDefinition(&segment, s + 1, kSubsystems[s]);
+        AppendDefinition(&segment, s + 11, kFormats[s]);
+      }
+      for (int i = 0; i < kRecordsPerDay; i++) {
+        uint32_t subsystem = 1 + i % 4;
+        // Roughly one error per 5000 records, like a healthy day.
+        LogLevel level = i % 4999 == 17 ? LogLevel::kError
+                         : i % 3 == 0   ? LogLevel::kDebug
+                                        : LogLevel::kInfo;
+        AppendRecord(&segment,
+                     header.start_time_us + uint64_t(i) * (kDayUs /
+                                                           kRecordsPerDay),
+                     subsystem, level, i,
+                     "GET /api/v1/time-entries?page=" + std::to_string(i));
+      }
+      char name[64];
+      snprintf(name, sizeof(name), "/log-day%02d-0000.sslog", day);
+      std::string raw = dir + name;
+      FILE* file = fopen(raw.c_str(), "wb");
+      fwrite(segment.data(), 1, segment.size(), file);
+      fclose(file);
+      if (ArchiveLogSegment(raw, raw + ".gz")) {
+        unlink(raw.c_str());
+      }
+    }
+    return dir;
+  }();
+  return directory;
+}
+
+void RunQuery(benchmark::State& state, const LogQuery& query) {
+  const std::string& directory = ArchiveDirectory();
+  LogQueryStats stats;
+  for (auto _ : state) {
+    LogQueryCursor cursor(directory, query);
+    LogEntry entry;
+    while (cursor.Next(&entry)) {
+      benchmark::DoNotOptimize(entry.message.data());
+    }
+    stats = cursor.stats();
+  }
+  state.counters["matched"] = static_cast<double>(stats.records_matched);
+  state.counters["blocks_inflated"] = stats.blocks_inflated;
+  state.counters["segments_skipped"] = stats.segments_skipped;
+}
+
+void BM_ErrorsForSubsystem(benchmark::State& state) {
+  LogQuery query;
+  query.min_level = LogLevel::kError;
+  query.subsystems = {"timer"};
+  RunQuery(state, query);
+}
+BENCHMARK(BM_ErrorsForSubsystem)->Unit(benchmark::kMillisecond);
+
+void BM_OneHourWindow(benchmark::State& state) {
+  LogQuery query;
+  query.from_us = kMonthStartUs + 14 * kDayUs + 10 * 3600ull * 1000000;
+  query.to_us = query.from_us + 3600ull * 1000000;
+  RunQuery(state, query);
+}
+BENCHMARK(BM_OneHourWindow)->Unit(benchmark::kMillisecond);
+
+// Worst case: a text search has to inflate and render every record.
+void BM_GrepWholeMonth(benchmark::State& state) {
+  LogQuery query;
+  query.text = "page=4242";
+  RunQuery(state, query);
+}
+BENCHMARK(BM_GrepWholeMonth)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
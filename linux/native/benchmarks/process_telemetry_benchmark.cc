@@ -0,0 +1,34 @@
+// Cost of one telemetry sample in this process, with and without the
+// smaps_rollup read that PSS needs.
+
+#include <benchmark/benchmark.h>
+
+#include "diagnostics/process_telemetry.h"
+
+namespace {
+
+void BM_Sample(benchmark::State& state) {
+  ProcessTelemetryOptions options;
+  options.pss_every = static_cast<uint32_t>(state.range(0));
+  ProcessTelemetry telemetry(options);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(telemetry.Sample());
+  }
+}
+// 0: never read PSS; 1: every sample; 6: the default rate.
+BENCHMARK(BM_Sample)->Arg(0)->Arg(1)->Arg(6)->Unit(benchmark::kMicrosecond);
+
+void BM_ToJson(benchmark::State& state) {
+  ProcessTelemetry telemetry{ProcessTelemetryOptions()};
+  for (int i = 0; i < 360; i++) {
+    telemetry.Sample();
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(telemetry.ToJson());
+  }
+}
+BENCHMARK(BM_ToJson)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,81 @@
+// Project lookups by name, as report submission does once per task: the
+// catalog's folded-name index against the scan it replaces, which compared
+// every cached project's lower-cased name in turn.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "catalog/project_catalog.h"
+
+namespace {
+
+std::vector<CatalogProject> Projects(int count) {
+  std::vector<CatalogProject> projects;
+  for (int i = 0; i < count; i++) {
+    CatalogProject project;
+    project.id = "65f0c0ffee" + std::to_string(100000 + i);
+    project.name = "Villa Project " + std::to_string(i) + " Dubai Hills";
+    project.client = "Client " + std::to_string(i % 20);
+    project.status = i % 5 ? "active" : "completed";
+    projects.push_back(project);
+  }
+  return projects;
+}
+
+// The name of the last project, in different case: the scan's worst case.
+std::string Query(int count) {
+  return "VILLA PROJECT " + std::to_string(count - 1) + " DUBAI HILLS";
+}
+
+void BM_FindByName(benchmark::State& state) {
+  const int count = static_cast<int>(state.range(0));
+  ProjectCatalog catalog;
+  CatalogDelta delta;
+  delta.upserts = Projects(count);
+  catalog.Apply(delta);
+  const std::string query = Query(count);
+  for (auto _ : state) {
+    auto snapshot = catalog.Snapshot();
+    benchmark::DoNotOptimize(snapshot->FindByName(query));
+  }
+}
+BENCHMARK(BM_FindByName)->Arg(50)->Arg(500)->Arg(5000);
+
+void BM_LinearScanByName(benchmark::State& state) {
+  const int count = static_cast<int>(state.range(0));
+  const std::vector<CatalogProject> projects = Projects(count);
+  const std::string query = Query(count);
+  for (auto _ : state) {
+    const std::string folded = FoldCase(query);
+    const CatalogProject* found = nullptr;
+    for (const CatalogProject& project : projects) {
+      if (FoldCase(project.name) == folded) {
+        found = &project;
+        break;
+      }
+    }
+    benchmark::DoNotOptimize(found);
+  }
+}
+BENCHMARK(BM_LinearScanByName)->Arg(50)->Arg(500)->Arg(5000);
+
+// One project changed on the server: the cost of a sync step.
+void BM_ApplyOneUpsert(benchmark::State& state) {
+  const int count = static_cast<int>(state.range(0));
+  ProjectCatalog catalog;
+  CatalogDelta full;
+  full.upserts = Projects(count);
+  catalog.Apply(full);
+  CatalogDelta delta;
+  delta.upserts.push_back(full.upserts[count / 2]);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(catalog.Apply(delta));
+  }
+}
+BENCHMARK(BM_ApplyOneUpsert)->Arg(50)->Arg(500)->Arg(5000);
+
+}  // namespace
+
+BENCHMARK_MAIN();
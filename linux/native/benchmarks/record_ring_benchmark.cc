@@ -0,0 +1,211 @@
+// Native-to-Dart streaming through a RecordRing, against the per-event work
+// of an EventChannel: encode a StandardMethodCodec envelope, post it as its
+// own message, decode it on the other side.
+//
+// The EventChannel side is modelled, not the engine itself: events go
+// through standard_codec_model.h and each one is posted to a locked queue
+// with a wakeup, as the engine does for every platform message.
+
+#include <benchmark/benchmark.h>
+
+#include <time.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "benchmarks/standard_codec_model.h"
+#include "diagnostics/hdr_histogram.h"
+#include "stream/record_ring.h"
+
+namespace {
+
+int64_t NowNs() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+// A level meter reading, the chattiest stream we have in mind.
+struct LevelRecord {
+  int64_t time_ns;
+  double peak;
+  double rms;
+  int32_t channel;
+  int32_t clipped;
+};
+
+void ReportLatency(benchmark::State& state, const HdrHistogram& latency) {
+  state.counters["p50_us"] = latency.ValueAtPercentile(50) / 1000.0;
+  state.counters["p99_us"] = latency.ValueAtPercentile(99) / 1000.0;
+  state.counters["max_us"] = latency.max() / 1000.0;
+}
+
+// Writer alone, with the same thread draining whenever half the ring has
+// filled.
+void BM_RingWrite(benchmark::State& state) {
+  RecordRing ring(sizeof(LevelRecord), 4096);
+  ring.Attach(nullptr, nullptr);
+  LevelRecord record{0, 0.5, 0.25, 0, 0};
+  uint64_t written = 0;
+  for (auto _ : state) {
+    record.time_ns = static_cast<int64_t>(written);
+    ring.Push(record);
+    if (++written % 2048 == 0) {
+      uint64_t first;
+      ring.Release(ring.Acquire(&first));
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  ring.Detach();
+}
+BENCHMARK(BM_RingWrite);
+
+// Reader thread state: sleeps until the doorbell or the queue wakes it.
+struct Waker {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool woken = false;
+  uint64_t wakeups = 0;
+
+  static void Ring(void* data) {
+    Waker* self = static_cast<Waker*>(data);
+    std::lock_guard<std::mutex> lock(self->mutex);
+    self->woken = true;
+    self->wakeups++;
+    self->cv.notify_one();
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this] { return woken; });
+    woken = false;
+  }
+};
+
+// |state.range(0)| records per iteration from a writer thread to a reader
+// woken by the doorbell, which drains everything waiting before re-arming.
+void BM_RingStream(benchmark::State& state) {
+  const int64_t batch = state.range(0);
+  RecordRing ring(sizeof(LevelRecord), 4096);
+  Waker waker;
+  ring.Attach(&Waker::Ring, &waker);
+  HdrHistogram latency;
+  uint64_t total = 0;
+  uint64_t wakeups = 0;
+
+  for (auto _ : state) {
+    std::thread writer([&ring, batch] {
+      for (int64_t i = 0; i < batch;) {
+        LevelRecord record{NowNs(), 0.5, 0.25, static_cast<int32_t>(i & 1),
+                           0};
+        if (ring.Push(record)) {
+          i++;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+    int64_t read = 0;
+    while (read < batch) {
+      uint64_t first;
+      const uint32_t count = ring.Acquire(&first);
+      double level = 0;
+      for (uint32_t i = 0; i < count; i++) {
+        const LevelRecord* record =
+            reinterpret_cast<const LevelRecord*>(ring.RecordAt(first + i));
+        level += record->peak;
+        latency.Record(static_cast<uint64_t>(NowNs() - record->time_ns));
+      }
+      benchmark::DoNotOptimize(level);
+      ring.Release(count);
+      read += count;
+      if (read < batch && !ring.Arm()) {
+        waker.Wait();
+      }
+    }
+    writer.join();
+    total += batch;
+  }
+  {
+    std::lock_guard<std::mutex> lock(waker.mutex);
+    wakeups = waker.wakeups;
+  }
+  ring.Detach();
+  state.SetItemsProcessed(static_cast<int64_t>(total));
+  state.counters["records_per_wakeup"] =
+      wakeups > 0 ? static_cast<double>(total) / wakeups : 0;
+  ReportLatency(state, latency);
+}
+BENCHMARK(BM_RingStream)->Arg(10000)->UseRealTime();
+
+// A success envelope around {"t":, "peak":, "rms":, "channel":}, as an
+// EventSink would send it.
+std::vector<uint8_t> EncodeEvent(const LevelRecord& record) {
+  return standard_codec::EncodeSuccessEnvelope(StandardMap{
+      {"t", record.time_ns},
+      {"peak", record.peak},
+      {"rms", record.rms},
+      {"channel", record.channel},
+  });
+}
+
+StandardMap DecodeEvent(const std::vector<uint8_t>& bytes) {
+  standard_codec::Reader reader(bytes.data(), bytes.size());
+  uint8_t envelope;
+  StandardMap event;
+  reader.Byte(&envelope);
+  reader.ReadMap(&event);
+  return event;
+}
+
+// The same stream as BM_RingStream, one encoded message per record.
+void BM_EventChannelStream(benchmark::State& state) {
+  const int64_t batch = state.range(0);
+  std::mutex mutex;
+  std::condition_variable posted;
+  std::deque<std::vector<uint8_t>> queue;
+  HdrHistogram latency;
+  uint64_t total = 0;
+
+  for (auto _ : state) {
+    std::thread writer([&] {
+      for (int64_t i = 0; i < batch; i++) {
+        LevelRecord record{NowNs(), 0.5, 0.25, static_cast<int32_t>(i & 1),
+                           0};
+        std::vector<uint8_t> message = EncodeEvent(record);
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(std::move(message));
+        posted.notify_one();
+      }
+    });
+    double level = 0;
+    for (int64_t read = 0; read < batch; read++) {
+      std::vector<uint8_t> message;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        posted.wait(lock, [&queue] { return !queue.empty(); });
+        message = std::move(queue.front());
+        queue.pop_front();
+      }
+      StandardMap event = DecodeEvent(message);
+      level += std::get<double>(event["peak"]);
+      latency.Record(
+          static_cast<uint64_t>(NowNs() - std::get<int64_t>(event["t"])));
+    }
+    benchmark::DoNotOptimize(level);
+    writer.join();
+    total += batch;
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(total));
+  ReportLatency(state, latency);
+}
+BENCHMARK(BM_EventChannelStream)->Arg(10000)->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
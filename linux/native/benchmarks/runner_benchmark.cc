@@ -0,0 +1,63 @@
+// The Windows runner's hot paths, on fake backends: argument and path
+// conversion at every call into Win32, and the click-through poll that runs
+// every 30 ms while the floating window is collapsed.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "runner/click_through.h"
+#include "runner/utf16.h"
+#include "tests/runner_fakes.h"
+
+namespace {
+
+void BM_Utf8FromUtf16Ascii(benchmark::State& state) {
+  const std::u16string path =
+      u"C:\\Users\\worker\\AppData\\Local\\Temp\\task_audio_1718000000000.m4a";
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Utf8FromUtf16(path));
+  }
+  state.SetBytesProcessed(state.iterations() * path.size() * 2);
+}
+BENCHMARK(BM_Utf8FromUtf16Ascii);
+
+void BM_Utf8FromUtf16Arabic(benchmark::State& state) {
+  const std::u16string path =
+      u"C:\\Users\\\u0645\u0647\u0646\u062f\u0633\\\u0645\u0634\u0627\u0631"
+      u"\u064a\u0639\\\u062a\u0642\u0631\u064a\u0631.pdf";
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Utf8FromUtf16(path));
+  }
+  state.SetBytesProcessed(state.iterations() * path.size() * 2);
+}
+BENCHMARK(BM_Utf8FromUtf16Arabic);
+
+void BM_Utf16FromUtf8(benchmark::State& state) {
+  const std::string path =
+      "C:\\Users\\worker\\AppData\\Local\\Temp\\task_audio_1718000000000.m4a";
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Utf16FromUtf8(path));
+  }
+  state.SetBytesProcessed(state.iterations() * path.size());
+}
+BENCHMARK(BM_Utf16FromUtf8);
+
+// The cursor sweeps across the window, so some polls change the style.
+void BM_ClickThroughPoll(benchmark::State& state) {
+  FakeClickThroughBackend backend;
+  ClickThroughController controller(&backend);
+  controller.SetEnabled(true);
+  int x = 0;
+  for (auto _ : state) {
+    backend.cursor = {x, 150};
+    x = (x + 7) % 600;
+    controller.Poll();
+  }
+  benchmark::DoNotOptimize(backend.style_changes);
+}
+BENCHMARK(BM_ClickThroughPoll);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,247 @@
+#ifndef NATIVE_BENCHMARKS_STANDARD_CODEC_MODEL_H_
+#define NATIVE_BENCHMARKS_STANDARD_CODEC_MODEL_H_
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <variant>
+#include <vector>
+
+// Just enough of StandardMessageCodec / StandardMethodCodec to compare our
+// own channel formats against: scalars, strings and flat string-keyed maps,
+// decoded into owned values the way flutter::EncodableValue (or a Dart Map)
+// holds them. The wire format matches the real codec; the engine and the
+// Dart side are not modelled.
+
+using StandardValue =
+    std::variant<std::monostate, bool, int32_t, int64_t, double, std::string>;
+using StandardMap = std::map<std::string, StandardValue>;
+
+namespace standard_codec {
+
+constexpr uint8_t kNull = 0;
+constexpr uint8_t kTrue = 1;
+constexpr uint8_t kFalse = 2;
+constexpr uint8_t kInt32 = 3;
+constexpr uint8_t kInt64 = 4;
+constexpr uint8_t kFloat64 = 6;
+constexpr uint8_t kString = 7;
+constexpr uint8_t kMap = 13;
+
+inline void WriteSize(std::vector<uint8_t>* out, size_t size) {
+  if (size < 254) {
+    out->push_back(static_cast<uint8_t>(size));
+  } else if (size <= 0xffff) {
+    out->push_back(254);
+    out->push_back(static_cast<uint8_t>(size));
+    out->push_back(static_cast<uint8_t>(size >> 8));
+  } else {
+    out->push_back(255);
+    for (int i = 0; i < 4; i++) {
+      out->push_back(static_cast<uint8_t>(size >> (8 * i)));
+    }
+  }
+}
+
+template <typename T>
+void WriteRaw(std::vector<uint8_t>* out, T value) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+  out->insert(out->end(), bytes, bytes + sizeof(T));
+}
+
+inline void WriteString(std::vector<uint8_t>* out, const std::string& text) {
+  out->push_back(kString);
+  WriteSize(out, text.size());
+  out->insert(out->end(), text.begin(), text.end());
+}
+
+inline void WriteValue(std::vector<uint8_t>* out, const StandardValue& value) {
+  switch (value.index()) {
+    case 0:
+      out->push_back(kNull);
+      break;
+    case 1:
+      out->push_back(std::get<bool>(value) ? kTrue : kFalse);
+      break;
+    case 2:
+      out->push_back(kInt32);
+      WriteRaw(out, std::get<int32_t>(value));
+      break;
+    case 3:
+      out->push_back(kInt64);
+      WriteRaw(out, std::get<int64_t>(value));
+      break;
+    case 4:
+      out->push_back(kFloat64);
+      while (out->size() % 8 != 0) {
+        out->push_back(0);
+      }
+      WriteRaw(out, std::get<double>(value));
+      break;
+    default:
+      WriteString(out, std::get<std::string>(value));
+      break;
+  }
+}
+
+inline void WriteMap(std::vector<uint8_t>* out, const StandardMap& map) {
+  out->push_back(kMap);
+  WriteSize(out, map.size());
+  for (const auto& entry : map) {
+    WriteString(out, entry.first);
+    WriteValue(out, entry.second);
+  }
+}
+
+class Reader {
+ public:
+  Reader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  bool ReadValue(StandardValue* value) {
+    uint8_t type;
+    if (!Byte(&type)) {
+      return false;
+    }
+    switch (type) {
+      case kNull:
+        *value = std::monostate();
+        return true;
+      case kTrue:
+      case kFalse:
+        *value = type == kTrue;
+        return true;
+      case kInt32:
+        return Raw<int32_t>(value);
+      case kInt64:
+        return Raw<int64_t>(value);
+      case kFloat64:
+        position_ = (position_ + 7) & ~size_t{7};
+        return Raw<double>(value);
+      case kString: {
+        std::string text;
+        if (!StringBody(&text)) {
+          return false;
+        }
+        *value = std::move(text);
+        return true;
+      }
+      default:
+        return false;
+    }
+  }
+
+  bool ReadString(std::string* text) {
+    uint8_t type;
+    return Byte(&type) && type == kString && StringBody(text);
+  }
+
+  bool ReadMap(StandardMap* map) {
+    uint8_t type;
+    size_t entries;
+    if (!Byte(&type) || type != kMap || !Size(&entries)) {
+      return false;
+    }
+    for (size_t i = 0; i < entries; i++) {
+      std::string key;
+      StandardValue value;
+      if (!ReadString(&key) || !ReadValue(&value)) {
+        return false;
+      }
+      map->emplace(std::move(key), std::move(value));
+    }
+    return true;
+  }
+
+  bool Byte(uint8_t* value) {
+    if (position_ >= size_) {
+      return false;
+    }
+    *value = data_[position_++];
+    return true;
+  }
+
+ private:
+  bool Size(size_t* size) {
+    uint8_t first;
+    if (!Byte(&first)) {
+      return false;
+    }
+    if (first < 254) {
+      *size = first;
+      return true;
+    }
+    const size_t width = first == 254 ? 2 : 4;
+    if (position_ + width > size_) {
+      return false;
+    }
+    *size = 0;
+    for (size_t i = 0; i < width; i++) {
+      *size |= static_cast<size_t>(data_[position_ + i]) << (8 * i);
+    }
+    position_ += width;
+    return true;
+  }
+
+  bool StringBody(std::string* text) {
+    size_t length;
+    if (!Size(&length) || position_ + length > size_) {
+      return false;
+    }
+    text->assign(reinterpret_cast<const char*>(data_ + position_), length);
+    position_ += length;
+    return true;
+  }
+
+  template <typename T>
+  bool Raw(StandardValue* value) {
+    if (position_ + sizeof(T) > size_) {
+      return false;
+    }
+    T raw;
+    std::memcpy(&raw, data_ + position_, sizeof(T));
+    position_ += sizeof(T);
+    *value = raw;
+    return true;
+  }
+
+  const uint8_t* data_;
+  size_t size_;
+  size_t position_ = 0;
+};
+
+// A method call: the method name, then the arguments value.
+inline std::vector<uint8_t> EncodeMethodCall(const std::string& method,
+                                             const StandardMap& arguments) {
+  std::vector<uint8_t> out;
+  WriteString(&out, method);
+  WriteMap(&out, arguments);
+  return out;
+}
+
+inline std::vector<uint8_t> EncodeMethodCall(const std::string& method,
+                                             const StandardValue& argument) {
+  std::vector<uint8_t> out;
+  WriteString(&out, method);
+  WriteValue(&out, argument);
+  return out;
+}
+
+inline std::vector<uint8_t> EncodeSuccessEnvelope(
+    const StandardValue& result) {
+  std::vector<uint8_t> out;
+  out.push_back(0);
+  WriteValue(&out, result);
+  return out;
+}
+
+inline std::vector<uint8_t> EncodeSuccessEnvelope(const StandardMap& result) {
+  std::vector<uint8_t> out;
+  out.push_back(0);
+  WriteMap(&out, result);
+  return out;
+}
+
+}  // namespace standard_codec
+
+#endif  // NATIVE_BENCHMARKS_STANDARD_CODEC_MODEL_H_
@@ -0,0 +1,168 @@
+// Scheduling latency and throughput of the shared thread pool.
+
+#include <benchmark/benchmark.h>
+
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "diagnostics/hdr_histogram.h"
+#include "scheduler/main_thread_queue.h"
+#include "scheduler/thread_pool.h"
+
+namespace {
+
+int64_t NowNs() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+ThreadPool& Pool() {
+  static ThreadPool* pool = new ThreadPool(ThreadPoolOptions());
+  return *pool;
+}
+
+void ReportPercentiles(benchmark::State& state, const HdrHistogram& latency) {
+  state.counters["p50_us"] = latency.ValueAtPercentile(50) / 1000.0;
+  state.counters["p99_us"] = latency.ValueAtPercentile(99) / 1000.0;
+  state.counters["max_us"] = latency.max() / 1000.0;
+}
+
+// Submit to start of the task. Arg 0 is the TaskPriority; with arg 1 set
+// the workers have gone to sleep before each submit, so the time includes
+// waking one.
+void BM_SubmitLatency(benchmark::State& state) {
+  ThreadPool& pool = Pool();
+  const auto priority = static_cast<TaskPriority>(state.range(0));
+  const bool asleep = state.range(1) != 0;
+  HdrHistogram latency;
+  std::atomic<int64_t> started{0};
+  for (auto _ : state) {
+    if (asleep) {
+      state.PauseTiming();
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      state.ResumeTiming();
+    }
+    started.store(0, std::memory_order_relaxed);
+    const int64_t submitted = NowNs();
+    pool.Submit(priority, [&started](const CancellationToken&) {
+      started.store(NowNs(), std::memory_order_release);
+    });
+    int64_t start;
+    while ((start = started.load(std::memory_order_acquire)) == 0) {
+      // Leave the core to the worker on small machines.
+      std::this_thread::yield();
+    }
+    latency.Record(static_cast<uint64_t>(start - submitted));
+  }
+  ReportPercentiles(state, latency);
+}
+BENCHMARK(BM_SubmitLatency)
+    ->ArgNames({"priority", "asleep"})
+    ->Args({0, 0})
+    ->Args({0, 1})
+    ->Args({1, 0})
+    ->Args({1, 1})
+    ->Args({2, 0})
+    ->Iterations(2000)
+    ->UseRealTime();
+
+// Many small independent tasks submitted from outside the pool, the shape
+// of hashing files or encoding thumbnails.
+void BM_IndependentTasks(benchmark::State& state) {
+  ThreadPool& pool = Pool();
+  const int tasks = static_cast<int>(state.range(0));
+  std::atomic<uint64_t> sink{0};
+  for (auto _ : state) {
+    TaskGroup group(&pool, TaskPriority::kInteractive);
+    for (int i = 0; i < tasks; i++) {
+      group.Run([&sink, i] {
+        uint64_t x = i;
+        for (int k = 0; k < 200; k++) {
+          x = x * 6364136223846793005u + 1442695040888963407u;
+        }
+        sink.fetch_add(x & 1, std::memory_order_relaxed);
+      });
+    }
+    group.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * tasks);
+}
+BENCHMARK(BM_IndependentTasks)->Arg(10000)->UseRealTime();
+
+uint64_t SumRange(ThreadPool* pool, const uint32_t* data, size_t begin,
+                  size_t end) {
+  if (end - begin <= 4096) {
+    uint64_t sum = 0;
+    for (size_t i = begin; i < end; i++) {
+      sum += data[i];
+    }
+    return sum;
+  }
+  const size_t middle = begin + (end - begin) / 2;
+  uint64_t left = 0;
+  TaskGroup group(pool, TaskPriority::kInteractive);
+  group.Run([&] { left = SumRange(pool, data, begin, middle); });
+  uint64_t right = SumRange(pool, data, middle, end);
+  group.Wait();
+  return left + right;
+}
+
+// Recursive fork/join: spawned halves go onto the local deque and idle
+// workers steal them.
+void BM_ForkJoin(benchmark::State& state) {
+  ThreadPool& pool = Pool();
+  std::vector<uint32_t> data(static_cast<size_t>(state.range(0)));
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<uint32_t>(i);
+  }
+  for (auto _ : state) {
+    std::atomic<uint64_t> result{0};
+    TaskGroup root(&pool, TaskPriority::kInteractive);
+    root.Run([&] {
+      result = SumRange(&pool, data.data(), 0, data.size());
+    });
+    root.Wait();
+    benchmark::DoNotOptimize(result.load());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ForkJoin)->Arg(1 << 22)->UseRealTime();
+
+// Results posted from workers and run on this thread in batches, as the
+// runner's main loop does.
+void BM_MainThreadHandoff(benchmark::State& state) {
+  ThreadPool& pool = Pool();
+  MainThreadQueue queue;
+  std::atomic<int> wakeups{0};
+  queue.SetWakeFunction(
+      [](void* data) {
+        static_cast<std::atomic<int>*>(data)->fetch_add(1);
+      },
+      &wakeups);
+  const int results = static_cast<int>(state.range(0));
+  int64_t handled = 0;
+  for (auto _ : state) {
+    TaskGroup group(&pool, TaskPriority::kBackground);
+    for (int i = 0; i < results; i++) {
+      group.Run([&queue, &handled] { queue.Post([&handled] { handled++; }); });
+    }
+    group.Wait();
+    while (queue.Drain(4000000)) {
+    }
+  }
+  state.SetItemsProcessed(handled);
+  state.counters["per_wakeup"] =
+      static_cast<double>(handled) / std::max(1, wakeups.load());
+}
+BENCHMARK(BM_MainThreadHandoff)->Arg(1000)->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
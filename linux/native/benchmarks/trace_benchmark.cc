@@ -0,0 +1,77 @@
+// Cost of a trace point with and without a session running, and of
+// collecting a full session.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "tracing/tracer.h"
+
+namespace {
+
+// What every instrumented block costs in normal use.
+void BM_ScopeDisabled(benchmark::State& state) {
+  Tracer::Get().Stop();
+  for (auto _ : state) {
+    SS_TRACE_SCOPE("bench", "disabled");
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_ScopeDisabled);
+
+void BM_ScopeEnabled(benchmark::State& state) {
+  Tracer& tracer = Tracer::Get();
+  tracer.Start();
+  for (auto _ : state) {
+    SS_TRACE_SCOPE("bench", "enabled");
+    benchmark::ClobberMemory();
+  }
+  tracer.Stop();
+}
+BENCHMARK(BM_ScopeEnabled)->ThreadRange(1, 4);
+
+void BM_Counter(benchmark::State& state) {
+  Tracer& tracer = Tracer::Get();
+  tracer.Start();
+  double value = 0;
+  for (auto _ : state) {
+    SS_TRACE_COUNTER("bench", "counter", value);
+    value += 1;
+  }
+  tracer.Stop();
+}
+BENCHMARK(BM_Counter);
+
+// Snapshot of four full buffers, the work behind a trace dump.
+void BM_Collect(benchmark::State& state) {
+  Tracer& tracer = Tracer::Get();
+  tracer.Start();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([] {
+      for (int i = 0; i < 20000; i++) {
+        SS_TRACE_SCOPE("bench", "collect");
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  tracer.Stop();
+
+  uint64_t events = 0;
+  for (auto _ : state) {
+    TraceStats stats;
+    std::vector<TraceThread> collected = tracer.Collect(&stats);
+    benchmark::DoNotOptimize(collected.data());
+    events = stats.events;
+  }
+  state.counters["events"] = static_cast<double>(events);
+}
+BENCHMARK(BM_Collect)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,78 @@
+#include "catalog/catalog_api.h"
+
+#include <memory>
+#include <string_view>
+
+#include "catalog/project_catalog.h"
+
+struct SsCatalogSnapshot {
+  std::shared_ptr<const CatalogSnapshot> snapshot;
+};
+
+namespace {
+
+std::string_view View(const uint8_t* data, int64_t size) {
+  if (data == nullptr || size <= 0) {
+    return std::string_view();
+  }
+  return std::string_view(reinterpret_cast<const char*>(data),
+                          static_cast<size_t>(size));
+}
+
+void SetString(std::string_view text, const uint8_t** data, int32_t* size) {
+  *data = reinterpret_cast<const uint8_t*>(text.data());
+  *size = static_cast<int32_t>(text.size());
+}
+
+}  // namespace
+
+int64_t ss_catalog_apply_delta(const uint8_t* delta, int64_t size) {
+  if (delta == nullptr || size < 0) {
+    return -1;
+  }
+  CatalogDelta decoded;
+  if (!DecodeCatalogDelta(delta, static_cast<size_t>(size), &decoded)) {
+    return -1;
+  }
+  return static_cast<int64_t>(ProjectCatalog::Get().Apply(decoded));
+}
+
+SsCatalogSnapshot* ss_catalog_acquire(void) {
+  return new SsCatalogSnapshot{ProjectCatalog::Get().Snapshot()};
+}
+
+void ss_catalog_release(SsCatalogSnapshot* snapshot) {
+  delete snapshot;
+}
+
+int64_t ss_catalog_version(const SsCatalogSnapshot* snapshot) {
+  return static_cast<int64_t>(snapshot->snapshot->version());
+}
+
+int64_t ss_catalog_size(const SsCatalogSnapshot* snapshot) {
+  return snapshot->snapshot->size();
+}
+
+int64_t ss_catalog_find_id(const SsCatalogSnapshot* snapshot,
+                           const uint8_t* id, int64_t size) {
+  return snapshot->snapshot->FindById(View(id, size));
+}
+
+int64_t ss_catalog_find_name(const SsCatalogSnapshot* snapshot,
+                             const uint8_t* name, int64_t size) {
+  return snapshot->snapshot->FindByName(View(name, size));
+}
+
+bool ss_catalog_row(const SsCatalogSnapshot* snapshot, int64_t row,
+                    SsCatalogRow* out) {
+  const CatalogSnapshot& catalog = *snapshot->snapshot;
+  if (row < 0 || row >= catalog.size()) {
+    return false;
+  }
+  SetString(catalog.id(row), &out->id, &out->id_size);
+  SetString(catalog.name(row), &out->name, &out->name_size);
+  SetString(catalog.client(row), &out->client, &out->client_size);
+  SetString(catalog.status(row), &out->status, &out->status_size);
+  out->last_active_ms = catalog.last_active_ms(row);
+  return true;
+}
@@ -0,0 +1,57 @@
+#ifndef NATIVE_CATALOG_CATALOG_API_H_
+#define NATIVE_CATALOG_CATALOG_API_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/native_export.h"
+
+// C interface to the project catalog (catalog/project_catalog.h), for
+// lib/services/project_catalog.dart. A snapshot handle pins one version;
+// the strings it hands out stay valid until it is released.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SsCatalogSnapshot SsCatalogSnapshot;
+
+// One row. Strings are UTF-8 and not NUL-terminated.
+typedef struct {
+  const uint8_t* id;
+  const uint8_t* name;
+  const uint8_t* client;
+  const uint8_t* status;
+  int64_t last_active_ms;
+  int32_t id_size;
+  int32_t name_size;
+  int32_t client_size;
+  int32_t status_size;
+} SsCatalogRow;
+
+// Applies an encoded CatalogDelta. Returns the new version, or -1 if
+// |delta| is malformed, in which case nothing changes.
+SS_EXPORT int64_t ss_catalog_apply_delta(const uint8_t* delta, int64_t size);
+
+// The current version; release it with ss_catalog_release().
+SS_EXPORT SsCatalogSnapshot* ss_catalog_acquire(void);
+SS_EXPORT void ss_catalog_release(SsCatalogSnapshot* snapshot);
+
+SS_EXPORT int64_t ss_catalog_version(const SsCatalogSnapshot* snapshot);
+SS_EXPORT int64_t ss_catalog_size(const SsCatalogSnapshot* snapshot);
+
+// Row of a project, or -1. Names compare case-insensitively.
+SS_EXPORT int64_t ss_catalog_find_id(const SsCatalogSnapshot* snapshot,
+                                     const uint8_t* id, int64_t size);
+SS_EXPORT int64_t ss_catalog_find_name(const SsCatalogSnapshot* snapshot,
+                                       const uint8_t* name, int64_t size);
+
+// Returns false if |row| is out of range.
+SS_EXPORT bool ss_catalog_row(const SsCatalogSnapshot* snapshot,
+                              int64_t row, SsCatalogRow* out);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // NATIVE_CATALOG_CATALOG_API_H_
@@ -0,0 +1,308 @@
+#include "catalog/project_catalog.h"
+
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "codec/fast_codec.h"
+
+namespace {
+
+uint32_t FoldCodePoint(uint32_t c) {
+  if ((c >= 0xC0 && c <= 0xDE && c != 0xD7) ||
+      (c >= 0x391 && c <= 0x3AB && c != 0x3A2) ||
+      (c >= 0x410 && c <= 0x42F)) {
+    return c + 0x20;
+  }
+  if (c >= 0x400 && c <= 0x40F) {
+    return c + 0x50;
+  }
+  // Latin Extended-A pairs capitals with the next code point, starting on
+  // an even one or, in two runs, on an odd one. U+0130 has no single
+  // lower-case form.
+  if (((c >= 0x100 && c <= 0x137 && c != 0x130) ||
+       (c >= 0x14A && c <= 0x177)) &&
+      c % 2 == 0) {
+    return c + 1;
+  }
+  if (((c >= 0x139 && c <= 0x148) || (c >= 0x179 && c <= 0x17E)) &&
+      c % 2 == 1) {
+    return c + 1;
+  }
+  switch (c) {
+    case 0x178:
+      return 0xFF;
+    case 0x386:
+      return 0x3AC;
+    case 0x388:
+    case 0x389:
+    case 0x38A:
+      return c + 0x25;
+    case 0x38C:
+      return 0x3CC;
+    case 0x38E:
+    case 0x38F:
+      return c + 0x3F;
+  }
+  return c;
+}
+
+size_t HashKey(std::string_view key) {
+  return std::hash<std::string_view>()(key);
+}
+
+size_t IndexCapacity(size_t rows) {
+  size_t capacity = 8;
+  while (capacity < rows * 2) {
+    capacity *= 2;
+  }
+  return capacity;
+}
+
+bool ReadCount(FastReader* reader, int32_t* count) {
+  return reader->ReadInt32(count) && *count >= 0;
+}
+
+}  // namespace
+
+std::string FoldCase(std::string_view text) {
+  std::string folded;
+  folded.reserve(text.size());
+  size_t i = 0;
+  while (i < text.size()) {
+    const uint8_t lead = static_cast<uint8_t>(text[i]);
+    if (lead < 0x80) {
+      folded.push_back(lead >= 'A' && lead <= 'Z' ? lead + ('a' - 'A')
+                                                  : lead);
+      i++;
+      continue;
+    }
+    // Every character folded here, and its lower-case form, is two bytes.
+    if ((lead & 0xE0) == 0xC0 && i + 1 < text.size()) {
+      const uint8_t trail = static_cast<uint8_t>(text[i + 1]);
+      const uint32_t c = ((lead & 0x1Fu) << 6) | (trail & 0x3Fu);
+      if ((trail & 0xC0) == 0x80 && c >= 0x80) {
+        const uint32_t lower = FoldCodePoint(c);
+        folded.push_back(static_cast<char>(0xC0 | (lower >> 6)));
+        folded.push_back(static_cast<char>(0x80 | (lower & 0x3F)));
+        i += 2;
+        continue;
+      }
+    }
+    folded.push_back(static_cast<char>(lead));
+    i++;
+  }
+  return folded;
+}
+
+bool DecodeCatalogDelta(const uint8_t* data, size_t size, CatalogDelta* out) {
+  *out = CatalogDelta();
+  FastReader reader(data, size);
+  int32_t upserts;
+  if (!reader.ReadBool(&out->reset) || !ReadCount(&reader, &upserts)) {
+    return false;
+  }
+  for (int32_t i = 0; i < upserts; i++) {
+    CatalogProject project;
+    if (!reader.ReadString(&project.id) ||
+        !reader.ReadString(&project.name) ||
+        !reader.ReadString(&project.client) ||
+        !reader.ReadString(&project.status) ||
+        !reader.ReadInt64(&project.last_active_ms)) {
+      return false;
+    }
+    out->upserts.push_back(std::move(project));
+  }
+  int32_t removals;
+  if (!ReadCount(&reader, &removals)) {
+    return false;
+  }
+  for (int32_t i = 0; i < removals; i++) {
+    std::string id;
+    if (!reader.ReadString(&id)) {
+      return false;
+    }
+    out->removals.push_back(std::move(id));
+  }
+  return reader.AtEnd();
+}
+
+std::vector<uint8_t> EncodeCatalogDelta(const CatalogDelta& delta) {
+  FastWriter writer;
+  writer.WriteBool(delta.reset);
+  writer.WriteInt32(static_cast<int32_t>(delta.upserts.size()));
+  for (const CatalogProject& project : delta.upserts) {
+    writer.WriteString(project.id);
+    writer.WriteString(project.name);
+    writer.WriteString(project.client);
+    writer.WriteString(project.status);
+    writer.WriteInt64(project.last_active_ms);
+  }
+  writer.WriteInt32(static_cast<int32_t>(delta.removals.size()));
+  for (const std::string& id : delta.removals) {
+    writer.WriteString(id);
+  }
+  return writer.Take();
+}
+
+// Fills a new snapshot row by row, then indexes it.
+class CatalogBuilder {
+ public:
+  CatalogBuilder(CatalogSnapshot* snapshot, uint64_t version, size_t rows)
+      : snapshot_(snapshot) {
+    snapshot_->version_ = version;
+    snapshot_->ids_.reserve(rows);
+    snapshot_->names_.reserve(rows);
+    snapshot_->folded_names_.reserve(rows);
+    snapshot_->clients_.reserve(rows);
+    snapshot_->statuses_.reserve(rows);
+    snapshot_->last_active_ms_.reserve(rows);
+  }
+
+  void Add(std::string_view id, std::string_view name,
+           std::string_view client, std::string_view status,
+           int64_t last_active_ms) {
+    snapshot_->ids_.push_back(Intern(id));
+    snapshot_->names_.push_back(Intern(name));
+    snapshot_->folded_names_.push_back(Intern(FoldCase(name)));
+    snapshot_->clients_.push_back(Intern(client));
+    snapshot_->statuses_.push_back(Intern(status));
+    snapshot_->last_active_ms_.push_back(last_active_ms);
+  }
+
+  void Finish() {
+    const size_t rows = snapshot_->ids_.size();
+    snapshot_->id_index_.assign(IndexCapacity(rows), 0);
+    snapshot_->name_index_.assign(IndexCapacity(rows), 0);
+    for (size_t row = 0; row < rows; row++) {
+      Insert(&snapshot_->id_index_, snapshot_->ids_, row);
+      Insert(&snapshot_->name_index_, snapshot_->folded_names_, row);
+    }
+  }
+
+ private:
+  uint32_t Intern(std::string_view text) {
+    auto it = interned_.find(std::string(text));
+    if (it != interned_.end()) {
+      return it->second;
+    }
+    const uint32_t id =
+        static_cast<uint32_t>(snapshot_->string_offsets_.size() - 1);
+    snapshot_->strings_.append(text.data(), text.size());
+    snapshot_->string_offsets_.push_back(
+        static_cast<uint32_t>(snapshot_->strings_.size()));
+    interned_.emplace(std::string(text), id);
+    return id;
+  }
+
+  // Adds |row| under its key unless an earlier row has the same key.
+  void Insert(std::vector<uint32_t>* index,
+              const std::vector<uint32_t>& column, size_t row) {
+    const size_t mask = index->size() - 1;
+    for (size_t slot = HashKey(snapshot_->String(column[row])) & mask;;
+         slot = (slot + 1) & mask) {
+      const uint32_t entry = (*index)[slot];
+      if (entry == 0) {
+        (*index)[slot] = static_cast<uint32_t>(row + 1);
+        return;
+      }
+      // Interned, so equal strings have equal ids.
+      if (column[entry - 1] == column[row]) {
+        return;
+      }
+    }
+  }
+
+  CatalogSnapshot* snapshot_;
+  std::unordered_map<std::string, uint32_t> interned_;
+};
+
+CatalogSnapshot::CatalogSnapshot() : string_offsets_(1, 0) {}
+
+int64_t CatalogSnapshot::FindById(std::string_view id) const {
+  return Find(id_index_, ids_, id);
+}
+
+int64_t CatalogSnapshot::FindByName(std::string_view name) const {
+  return Find(name_index_, folded_names_, FoldCase(name));
+}
+
+int64_t CatalogSnapshot::Find(const std::vector<uint32_t>& index,
+                              const std::vector<uint32_t>& column,
+                              std::string_view key) const {
+  if (index.empty()) {
+    return kNotFound;
+  }
+  const size_t mask = index.size() - 1;
+  for (size_t slot = HashKey(key) & mask;; slot = (slot + 1) & mask) {
+    const uint32_t entry = index[slot];
+    if (entry == 0) {
+      return kNotFound;
+    }
+    if (String(column[entry - 1]) == key) {
+      return entry - 1;
+    }
+  }
+}
+
+ProjectCatalog& ProjectCatalog::Get() {
+  static ProjectCatalog* catalog = new ProjectCatalog();
+  return *catalog;
+}
+
+ProjectCatalog::ProjectCatalog()
+    : current_(std::make_shared<CatalogSnapshot>()) {}
+
+std::shared_ptr<const CatalogSnapshot> ProjectCatalog::Snapshot() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return current_;
+}
+
+uint64_t ProjectCatalog::Apply(const CatalogDelta& delta) {
+  std::lock_guard<std::mutex> write_lock(write_mutex_);
+  const std::shared_ptr<const CatalogSnapshot> current = Snapshot();
+
+  // The last upsert of an id wins.
+  std::unordered_map<std::string_view, size_t> upserts;
+  for (size_t i = 0; i < delta.upserts.size(); i++) {
+    upserts[delta.upserts[i].id] = i;
+  }
+  const std::unordered_set<std::string_view> removed(delta.removals.begin(),
+                                                     delta.removals.end());
+
+  auto next = std::make_shared<CatalogSnapshot>();
+  CatalogBuilder builder(next.get(), current->version() + 1,
+                         current->size() + upserts.size());
+  std::unordered_set<std::string_view> added;
+  if (!delta.reset) {
+    for (int64_t row = 0; row < current->size(); row++) {
+      const std::string_view id = current->id(row);
+      if (removed.count(id) != 0) {
+        continue;
+      }
+      auto upsert = upserts.find(id);
+      if (upsert != upserts.end()) {
+        const CatalogProject& project = delta.upserts[upsert->second];
+        builder.Add(project.id, project.name, project.client, project.status,
+                    project.last_active_ms);
+        added.insert(id);
+      } else {
+        builder.Add(id, current->name(row), current->client(row),
+                    current->status(row), current->last_active_ms(row));
+      }
+    }
+  }
+  for (size_t i = 0; i < delta.upserts.size(); i++) {
+    const CatalogProject& project = delta.upserts[i];
+    if (upserts[project.id] == i && added.count(project.id) == 0) {
+      builder.Add(project.id, project.name, project.client, project.status,
+                  project.last_active_ms);
+    }
+  }
+  builder.Finish();
+
+  const uint64_t version = next->version();
+  std::lock_guard<std::mutex> lock(mutex_);
+  current_ = std::move(next);
+  return version;
+}
@@ -0,0 +1,129 @@
+#ifndef NATIVE_CATALOG_PROJECT_CATALOG_H_
+#define NATIVE_CATALOG_PROJECT_CATALOG_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The projects the signed-in user can log time against, shared by every
+// reader in the process.
+//
+// Each version of the catalog is an immutable CatalogSnapshot. Its columns
+// are flat arrays indexed by row. Strings are ids into one table that holds
+// each distinct string once, which matters for statuses and clients. Open
+// addressing indexes map ids and case-folded names to rows. Applying a
+// CatalogDelta builds the next snapshot and swaps it in. Readers keep the
+// snapshot they hold, so a lookup never sees half a sync and never copies.
+
+struct CatalogProject {
+  std::string id;
+  std::string name;
+  std::string client;
+  std::string status;
+  int64_t last_active_ms = 0;  // Unix epoch; 0 if never.
+};
+
+// One sync step. Removals apply before upserts; an upsert of a known id
+// replaces that row in place, a new id is appended.
+struct CatalogDelta {
+  bool reset = false;  // Drop every project first (a full download).
+  std::vector<CatalogProject> upserts;
+  std::vector<std::string> removals;
+};
+
+// Wire format of a delta through dart:ffi, in the fast codec primitives
+// (codec/fast_codec.h): the reset flag, an int32 count of upserts each as
+// id, name, client and status strings and an int64 last_active_ms, then an
+// int32 count of removed id strings.
+bool DecodeCatalogDelta(const uint8_t* data, size_t size, CatalogDelta* out);
+std::vector<uint8_t> EncodeCatalogDelta(const CatalogDelta& delta);
+
+// Lower-cases ASCII, Latin-1, Latin Extended-A, Greek and Cyrillic; other
+// characters, and malformed UTF-8, are kept as they are.
+std::string FoldCase(std::string_view text);
+
+class CatalogSnapshot {
+ public:
+  static constexpr int64_t kNotFound = -1;
+
+  CatalogSnapshot();
+
+  uint64_t version() const { return version_; }
+  int64_t size() const { return static_cast<int64_t>(ids_.size()); }
+
+  // Row of |id|, or kNotFound.
+  int64_t FindById(std::string_view id) const;
+  // First row whose name folds to the same text as |name|, or kNotFound.
+  int64_t FindByName(std::string_view name) const;
+
+  // Valid for as long as the snapshot is.
+  std::string_view id(int64_t row) const { return String(ids_[row]); }
+  std::string_view name(int64_t row) const { return String(names_[row]); }
+  std::string_view client(int64_t row) const {
+    return String(clients_[row]);
+  }
+  std::string_view status(int64_t row) const {
+    return String(statuses_[row]);
+  }
+  int64_t last_active_ms(int64_t row) const { return last_active_ms_[row]; }
+
+  // Distinct strings and their total bytes.
+  size_t string_count() const { return string_offsets_.size() - 1; }
+  size_t string_bytes() const { return strings_.size(); }
+
+ private:
+  friend class CatalogBuilder;
+
+  std::string_view String(uint32_t id) const {
+    return std::string_view(strings_.data() + string_offsets_[id],
+                            string_offsets_[id + 1] - string_offsets_[id]);
+  }
+  int64_t Find(const std::vector<uint32_t>& index,
+               const std::vector<uint32_t>& column,
+               std::string_view key) const;
+
+  uint64_t version_ = 0;
+
+  // String table: string i is strings_[offsets[i], offsets[i + 1]).
+  std::string strings_;
+  std::vector<uint32_t> string_offsets_;
+
+  // Columns; each string column holds string table ids.
+  std::vector<uint32_t> ids_;
+  std::vector<uint32_t> names_;
+  std::vector<uint32_t> folded_names_;
+  std::vector<uint32_t> clients_;
+  std::vector<uint32_t> statuses_;
+  std::vector<int64_t> last_active_ms_;
+
+  // Open addressing over a power-of-two table of row + 1 (0 is empty).
+  std::vector<uint32_t> id_index_;
+  std::vector<uint32_t> name_index_;
+};
+
+class ProjectCatalog {
+ public:
+  // The process-wide catalog that the C interface serves.
+  static ProjectCatalog& Get();
+
+  ProjectCatalog();
+
+  // The current version. Never null; empty until the first delta.
+  std::shared_ptr<const CatalogSnapshot> Snapshot() const;
+
+  // Builds the next snapshot from the current one and |delta|, publishes
+  // it and returns its version. Writers are serialized; readers are not
+  // blocked while the snapshot is built.
+  uint64_t Apply(const CatalogDelta& delta);
+
+ private:
+  std::mutex write_mutex_;
+  mutable std::mutex mutex_;  // Guards current_ only.
+  std::shared_ptr<const CatalogSnapshot> current_;
+};
+
+#endif  // NATIVE_CATALOG_PROJECT_CATALOG_H_
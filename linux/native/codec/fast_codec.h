@@ -0,0 +1,203 @@
+#ifndef NATIVE_CODEC_FAST_CODEC_H_
+#define NATIVE_CODEC_FAST_CODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Binary message format of the fast-path platform channels, the C++ half of
+// lib/native/fast_codec.dart. Header-only so the Windows runner can use it
+// without the native library.
+//
+// A call is the magic byte, the schema version, the call id and then the
+// arguments in declaration order; a reply is a status byte (0 success,
+// 1 error, as in StandardMethodCodec envelopes) followed by the results, or
+// by an error code and message. An empty reply means the call is unknown.
+// Integers and doubles are little-endian and unaligned; strings and byte
+// arrays are a uint32 length and the bytes.
+//
+// Encoders and decoders for each channel are generated from
+// codec/fast_messages.schema by tools/ss_codec_gen.cc.
+
+constexpr uint8_t kFastCallMagic = 0xFA;
+constexpr uint8_t kFastReplySuccess = 0;
+constexpr uint8_t kFastReplyError = 1;
+
+// Bytes inside a message, valid for as long as the message is.
+struct FastByteView {
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+};
+
+// Same, for UTF-8 text.
+struct FastStringView {
+  const char* data = nullptr;
+  size_t size = 0;
+
+  std::string ToString() const { return std::string(data, size); }
+};
+
+// Error reply of a handler.
+struct FastError {
+  std::string code;
+  std::string message;
+};
+
+class FastWriter {
+ public:
+  FastWriter() { bytes_.reserve(64); }
+
+  void WriteUint8(uint8_t value) { bytes_.push_back(value); }
+  void WriteBool(bool value) { bytes_.push_back(value ? 1 : 0); }
+  void WriteInt32(int32_t value) { WriteLittleEndian(value, 4); }
+  void WriteInt64(int64_t value) { WriteLittleEndian(value, 8); }
+  void WriteFloat64(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    WriteLittleEndian(bits, 8);
+  }
+  void WriteString(const std::string& value) {
+    WriteBytes(reinterpret_cast<const uint8_t*>(value.data()), value.size());
+  }
+  void WriteString(FastStringView value) {
+    WriteBytes(reinterpret_cast<const uint8_t*>(value.data), value.size);
+  }
+  void WriteBytes(FastByteView value) { WriteBytes(value.data, value.size); }
+  void WriteBytes(const uint8_t* data, size_t size) {
+    WriteLittleEndian(static_cast<uint32_t>(size), 4);
+    bytes_.insert(bytes_.end(), data, data + size);
+  }
+
+  const std::vector<uint8_t>& bytes() const { return bytes_; }
+  std::vector<uint8_t> Take() { return std::move(bytes_); }
+
+ private:
+  template <typename T>
+  void WriteLittleEndian(T value, int size) {
+    uint64_t bits = static_cast<uint64_t>(value);
+    for (int i = 0; i < size; i++) {
+      bytes_.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+    }
+  }
+
+  std::vector<uint8_t> bytes_;
+};
+
+// Reads a message in place. A read past the end, or of a malformed value,
+// fails and leaves the reader failed.
+class FastReader {
+ public:
+  FastReader(const uint8_t* data, size_t size) : data_(data), end_(size) {}
+
+  bool ReadUint8(uint8_t* value) {
+    if (!Has(1)) {
+      return false;
+    }
+    *value = data_[position_++];
+    return true;
+  }
+  bool ReadBool(bool* value) {
+    uint8_t byte;
+    if (!ReadUint8(&byte) || byte > 1) {
+      return Fail();
+    }
+    *value = byte != 0;
+    return true;
+  }
+  bool ReadInt32(int32_t* value) {
+    uint64_t bits;
+    if (!ReadLittleEndian(4, &bits)) {
+      return false;
+    }
+    *value = static_cast<int32_t>(static_cast<uint32_t>(bits));
+    return true;
+  }
+  bool ReadInt64(int64_t* value) {
+    uint64_t bits;
+    if (!ReadLittleEndian(8, &bits)) {
+      return false;
+    }
+    *value = static_cast<int64_t>(bits);
+    return true;
+  }
+  bool ReadFloat64(double* value) {
+    uint64_t bits;
+    if (!ReadLittleEndian(8, &bits)) {
+      return false;
+    }
+    std::memcpy(value, &bits, sizeof(bits));
+    return true;
+  }
+  bool ReadString(FastStringView* value) {
+    FastByteView bytes;
+    if (!ReadBytes(&bytes)) {
+      return false;
+    }
+    value->data = reinterpret_cast<const char*>(bytes.data);
+    value->size = bytes.size;
+    return true;
+  }
+  bool ReadString(std::string* value) {
+    FastStringView view;
+    if (!ReadString(&view)) {
+      return false;
+    }
+    value->assign(view.data, view.size);
+    return true;
+  }
+  bool ReadBytes(FastByteView* value) {
+    uint64_t size;
+    if (!ReadLittleEndian(4, &size) || !Has(size)) {
+      return Fail();
+    }
+    value->data = data_ + position_;
+    value->size = static_cast<size_t>(size);
+    position_ += static_cast<size_t>(size);
+    return true;
+  }
+
+  bool failed() const { return failed_; }
+  bool AtEnd() const { return !failed_ && position_ == end_; }
+
+ private:
+  bool Has(uint64_t size) {
+    if (failed_ || end_ - position_ < size) {
+      return Fail();
+    }
+    return true;
+  }
+  bool Fail() {
+    failed_ = true;
+    return false;
+  }
+  bool ReadLittleEndian(int size, uint64_t* value) {
+    if (!Has(size)) {
+      return false;
+    }
+    uint64_t bits = 0;
+    for (int i = 0; i < size; i++) {
+      bits |= static_cast<uint64_t>(data_[position_ + i]) << (8 * i);
+    }
+    position_ += size;
+    *value = bits;
+    return true;
+  }
+
+  const uint8_t* data_;
+  size_t end_;
+  size_t position_ = 0;
+  bool failed_ = false;
+};
+
+// Reply bodies shared by every generated dispatcher.
+inline std::vector<uint8_t> FastErrorReply(const FastError& error) {
+  FastWriter writer;
+  writer.WriteUint8(kFastReplyError);
+  writer.WriteString(error.code);
+  writer.WriteString(error.message);
+  return writer.Take();
+}
+
+#endif  // NATIVE_CODEC_FAST_CODEC_H_
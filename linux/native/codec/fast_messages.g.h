@@ -0,0 +1,520 @@
+// Generated by tools/ss_codec_gen.cc from codec/fast_messages.schema.
+// Do not edit.
+
+#ifndef NATIVE_CODEC_FAST_MESSAGES_G_H_
+#define NATIVE_CODEC_FAST_MESSAGES_G_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "codec/fast_codec.h"
+
+namespace fast_messages {
+
+constexpr uint8_t kVersion = 2;
+
+namespace click_through {
+
+constexpr char kChannel[] = "com.silverstone/fast/click_through";
+
+struct SetClickThroughEnabledArgs {
+  bool enabled = false;
+};
+struct SetClickThroughEnabledResult {};
+
+struct RestoreNormalWindowStyleArgs {};
+struct RestoreNormalWindowStyleResult {};
+
+struct SetFramelessArgs {
+  bool frameless = false;
+};
+struct SetFramelessResult {};
+
+// Implemented by the runner. Arguments point into the message and are
+// only valid during the call. Return false with |error| set to reply
+// with an error.
+class Handler {
+ public:
+  virtual ~Handler() = default;
+
+  virtual bool SetClickThroughEnabled(
+      const SetClickThroughEnabledArgs& args,
+      SetClickThroughEnabledResult* result,
+      FastError* error) = 0;
+  virtual bool RestoreNormalWindowStyle(
+      const RestoreNormalWindowStyleArgs& args,
+      RestoreNormalWindowStyleResult* result,
+      FastError* error) = 0;
+  virtual bool SetFrameless(
+      const SetFramelessArgs& args,
+      SetFramelessResult* result,
+      FastError* error) = 0;
+};
+
+// Decodes |message|, runs the handler and returns the reply, which is
+// empty for calls this version does not know.
+inline std::vector<uint8_t> Dispatch(Handler* handler,
+                                     const uint8_t* message,
+                                     size_t size) {
+  FastReader reader(message, size);
+  uint8_t magic = 0;
+  uint8_t version = 0;
+  uint8_t call = 0;
+  if (!reader.ReadUint8(&magic) || magic != kFastCallMagic ||
+      !reader.ReadUint8(&version) || !reader.ReadUint8(&call)) {
+    return FastErrorReply({"BAD_MESSAGE", "not a fast-path call"});
+  }
+  if (version != kVersion) {
+    return FastErrorReply({"VERSION_MISMATCH",
+                           "expected version " + std::to_string(kVersion)});
+  }
+  FastError error;
+  FastWriter writer;
+  switch (call) {
+    case 1: {
+      SetClickThroughEnabledArgs args;
+      reader.ReadBool(&args.enabled);
+      if (!reader.AtEnd()) {
+        return FastErrorReply({"INVALID_ARGS", "setClickThroughEnabled"});
+      }
+      SetClickThroughEnabledResult result;
+      if (!handler->SetClickThroughEnabled(args, &result, &error)) {
+        return FastErrorReply(error);
+      }
+      writer.WriteUint8(kFastReplySuccess);
+      return writer.Take();
+    }
+    case 2: {
+      RestoreNormalWindowStyleArgs args;
+      if (!reader.AtEnd()) {
+        return FastErrorReply({"INVALID_ARGS", "restoreNormalWindowStyle"});
+      }
+      RestoreNormalWindowStyleResult result;
+      if (!handler->RestoreNormalWindowStyle(args, &result, &error)) {
+        return FastErrorReply(error);
+      }
+      writer.WriteUint8(kFastReplySuccess);
+      return writer.Take();
+    }
+    case 3: {
+      SetFramelessArgs args;
+      reader.ReadBool(&args.frameless);
+      if (!reader.AtEnd()) {
+        return FastErrorReply({"INVALID_ARGS", "setFrameless"});
+      }
+      SetFramelessResult result;
+      if (!handler->SetFrameless(args, &result, &error)) {
+        return FastErrorReply(error);
+      }
+      writer.WriteUint8(kFastReplySuccess);
+      return writer.Take();
+    }
+  }
+  return {};
+}
+
+// Client side, as in Dart; for tests and benchmarks.
+inline std::vector<uint8_t> EncodeSetClickThroughEnabled(
+    const SetClickThroughEnabledArgs& args) {
+  FastWriter writer;
+  writer.WriteUint8(kFastCallMagic);
+  writer.WriteUint8(kVersion);
+  writer.WriteUint8(1);
+  writer.WriteBool(args.enabled);
+  return writer.Take();
+}
+
+inline bool DecodeSetClickThroughEnabledReply(const uint8_t* reply,
+    size_t size,
+    SetClickThroughEnabledResult* result,
+    FastError* error) {
+  FastReader reader(reply, size);
+  uint8_t status = 0;
+  if (!reader.ReadUint8(&status)) {
+    error->code = "NOT_IMPLEMENTED";
+    return false;
+  }
+  if (status != kFastReplySuccess) {
+    reader.ReadString(&error->code);
+    reader.ReadString(&error->message);
+    return false;
+  }
+  if (!reader.AtEnd()) {
+    error->code = "BAD_REPLY";
+    return false;
+  }
+  return true;
+}
+
+inline std::vector<uint8_t> EncodeRestoreNormalWindowStyle(
+    const RestoreNormalWindowStyleArgs& args) {
+  FastWriter writer;
+  writer.WriteUint8(kFastCallMagic);
+  writer.WriteUint8(kVersion);
+  writer.WriteUint8(2);
+  return writer.Take();
+}
+
+inline bool DecodeRestoreNormalWindowStyleReply(const uint8_t* reply,
+    size_t size,
+    RestoreNormalWindowStyleResult* result,
+    FastError* error) {
+  FastReader reader(reply, size);
+  uint8_t status = 0;
+  if (!reader.ReadUint8(&status)) {
+    error->code = "NOT_IMPLEMENTED";
+    return false;
+  }
+  if (status != kFastReplySuccess) {
+    reader.ReadString(&error->code);
+    reader.ReadString(&error->message);
+    return false;
+  }
+  if (!reader.AtEnd()) {
+    error->code = "BAD_REPLY";
+    return false;
+  }
+  return true;
+}
+
+inline std::vector<uint8_t> EncodeSetFrameless(
+    const SetFramelessArgs& args) {
+  FastWriter writer;
+  writer.WriteUint8(kFastCallMagic);
+  writer.WriteUint8(kVersion);
+  writer.WriteUint8(3);
+  writer.WriteBool(args.frameless);
+  return writer.Take();
+}
+
+inline bool DecodeSetFramelessReply(const uint8_t* reply,
+    size_t size,
+    SetFramelessResult* result,
+    FastError* error) {
+  FastReader reader(reply, size);
+  uint8_t status = 0;
+  if (!reader.ReadUint8(&status)) {
+    error->code = "NOT_IMPLEMENTED";
+    return false;
+  }
+  if (status != kFastReplySuccess) {
+    reader.ReadString(&error->code);
+    reader.ReadString(&error->message);
+    return false;
+  }
+  if (!reader.AtEnd()) {
+    error->code = "BAD_REPLY";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace click_through
+
+namespace audio_recorder {
+
+constexpr char kChannel[] = "com.silverstone/fast/audio_recorder";
+
+struct HasPermissionArgs {};
+struct HasPermissionResult {
+  bool granted = false;
+};
+
+struct StartRecordingArgs {
+  FastStringView path;
+};
+struct StartRecordingResult {
+  bool started = false;
+};
+
+struct StopRecordingArgs {};
+struct StopRecordingResult {
+  std::string path;
+  int64_t samples = 0;
+  int64_t empty_reads = 0;
+  int64_t xruns = 0;
+  int64_t timestamp_gaps = 0;
+  int64_t missing_us = 0;
+  int64_t max_gap_us = 0;
+  int64_t max_backlog_us = 0;
+  int64_t media_us = 0;
+  int64_t write_p50_us = 0;
+  int64_t write_p99_us = 0;
+  int64_t write_max_us = 0;
+  int64_t finish_us = 0;
+  int64_t file_bytes = 0;
+  bool failed = false;
+};
+
+struct IsRecordingArgs {};
+struct IsRecordingResult {
+  bool recording = false;
+};
+
+// Implemented by the runner. Arguments point into the message and are
+// only valid during the call. Return false with |error| set to reply
+// with an error.
+class Handler {
+ public:
+  virtual ~Handler() = default;
+
+  virtual bool HasPermission(
+      const HasPermissionArgs& args,
+      HasPermissionResult* result,
+      FastError* error) = 0;
+  virtual bool StartRecording(
+      const StartRecordingArgs& args,
+      StartRecordingResult* result,
+      FastError* error) = 0;
+  virtual bool StopRecording(
+      const StopRecordingArgs& args,
+      StopRecordingResult* result,
+      FastError* error) = 0;
+  virtual bool IsRecording(
+      const IsRecordingArgs& args,
+      IsRecordingResult* result,
+      FastError* error) = 0;
+};
+
+// Decodes |message|, runs the handler and returns the reply, which is
+// empty for calls this version does not know.
+inline std::vector<uint8_t> Dispatch(Handler* handler,
+                                     const uint8_t* message,
+                                     size_t size) {
+  FastReader reader(message, size);
+  uint8_t magic = 0;
+  uint8_t version = 0;
+  uint8_t call = 0;
+  if (!reader.ReadUint8(&magic) || magic != kFastCallMagic ||
+      !reader.ReadUint8(&version) || !reader.ReadUint8(&call)) {
+    return FastErrorReply({"BAD_MESSAGE", "not a fast-path call"});
+  }
+  if (version != kVersion) {
+    return FastErrorReply({"VERSION_MISMATCH",
+                           "expected version " + std::to_string(kVersion)});
+  }
+  FastError error;
+  FastWriter writer;
+  switch (call) {
+    case 1: {
+      HasPermissionArgs args;
+      if (!reader.AtEnd()) {
+        return FastErrorReply({"INVALID_ARGS", "hasPermission"});
+      }
+      HasPermissionResult result;
+      if (!handler->HasPermission(args, &result, &error)) {
+        return FastErrorReply(error);
+      }
+      writer.WriteUint8(kFastReplySuccess);
+      writer.WriteBool(result.granted);
+      return writer.Take();
+    }
+    case 2: {
+      StartRecordingArgs args;
+      reader.ReadString(&args.path);
+      if (!reader.AtEnd()) {
+        return FastErrorReply({"INVALID_ARGS", "startRecording"});
+      }
+      StartRecordingResult result;
+      if (!handler->StartRecording(args, &result, &error)) {
+        return FastErrorReply(error);
+      }
+      writer.WriteUint8(kFastReplySuccess);
+      writer.WriteBool(result.started);
+      return writer.Take();
+    }
+    case 3: {
+      StopRecordingArgs args;
+      if (!reader.AtEnd()) {
+        return FastErrorReply({"INVALID_ARGS", "stopRecording"});
+      }
+      StopRecordingResult result;
+      if (!handler->StopRecording(args, &result, &error)) {
+        return FastErrorReply(error);
+      }
+      writer.WriteUint8(kFastReplySuccess);
+      writer.WriteString(result.path);
+      writer.WriteInt64(result.samples);
+      writer.WriteInt64(result.empty_reads);
+      writer.WriteInt64(result.xruns);
+      writer.WriteInt64(result.timestamp_gaps);
+      writer.WriteInt64(result.missing_us);
+      writer.WriteInt64(result.max_gap_us);
+      writer.WriteInt64(result.max_backlog_us);
+      writer.WriteInt64(result.media_us);
+      writer.WriteInt64(result.write_p50_us);
+      writer.WriteInt64(result.write_p99_us);
+      writer.WriteInt64(result.write_max_us);
+      writer.WriteInt64(result.finish_us);
+      writer.WriteInt64(result.file_bytes);
+      writer.WriteBool(result.failed);
+      return writer.Take();
+    }
+    case 4: {
+      IsRecordingArgs args;
+      if (!reader.AtEnd()) {
+        return FastErrorReply({"INVALID_ARGS", "isRecording"});
+      }
+      IsRecordingResult result;
+      if (!handler->IsRecording(args, &result, &error)) {
+        return FastErrorReply(error);
+      }
+      writer.WriteUint8(kFastReplySuccess);
+      writer.WriteBool(result.recording);
+      return writer.Take();
+    }
+  }
+  return {};
+}
+
+// Client side, as in Dart; for tests and benchmarks.
+inline std::vector<uint8_t> EncodeHasPermission(
+    const HasPermissionArgs& args) {
+  FastWriter writer;
+  writer.WriteUint8(kFastCallMagic);
+  writer.WriteUint8(kVersion);
+  writer.WriteUint8(1);
+  return writer.Take();
+}
+
+inline bool DecodeHasPermissionReply(const uint8_t* reply,
+    size_t size,
+    HasPermissionResult* result,
+    FastError* error) {
+  FastReader reader(reply, size);
+  uint8_t status = 0;
+  if (!reader.ReadUint8(&status)) {
+    error->code = "NOT_IMPLEMENTED";
+    return false;
+  }
+  if (status != kFastReplySuccess) {
+    reader.ReadString(&error->code);
+    reader.ReadString(&error->message);
+    return false;
+  }
+  reader.ReadBool(&result->granted);
+  if (!reader.AtEnd()) {
+    error->code = "BAD_REPLY";
+    return false;
+  }
+  return true;
+}
+
+inline std::vector<uint8_t> EncodeStartRecording(
+    const StartRecordingArgs& args) {
+  FastWriter writer;
+  writer.WriteUint8(kFastCallMagic);
+  writer.WriteUint8(kVersion);
+  writer.WriteUint8(2);
+  writer.WriteString(args.path);
+  return writer.Take();
+}
+
+inline bool DecodeStartRecordingReply(const uint8_t* reply,
+    size_t size,
+    StartRecordingResult* result,
+    FastError* error) {
+  FastReader reader(reply, size);
+  uint8_t status = 0;
+  if (!reader.ReadUint8(&status)) {
+    error->code = "NOT_IMPLEMENTED";
+    return false;
+  }
+  if (status != kFastReplySuccess) {
+    reader.ReadString(&error->code);
+    reader.ReadString(&error->message);
+    return false;
+  }
+  reader.ReadBool(&result->started);
+  if (!reader.AtEnd()) {
+    error->code = "BAD_REPLY";
+    return false;
+  }
+  return true;
+}
+
+inline std::vector<uint8_t> EncodeStopRecording(
+    const StopRecordingArgs& args) {
+  FastWriter writer;
+  writer.WriteUint8(kFastCallMagic);
+  writer.WriteUint8(kVersion);
+  writer.WriteUint8(3);
+  return writer.Take();
+}
+
+inline bool DecodeStopRecordingReply(const uint8_t* reply,
+    size_t size,
+    StopRecordingResult* result,
+    FastError* error) {
+  FastReader reader(reply, size);
+  uint8_t status = 0;
+  if (!reader.ReadUint8(&status)) {
+    error->code = "NOT_IMPLEMENTED";
+    return false;
+  }
+  if (status != kFastReplySuccess) {
+    reader.ReadString(&error->code);
+    reader.ReadString(&error->message);
+    return false;
+  }
+  reader.ReadString(&result->path);
+  reader.ReadInt64(&result->samples);
+  reader.ReadInt64(&result->empty_reads);
+  reader.ReadInt64(&result->xruns);
+  reader.ReadInt64(&result->timestamp_gaps);
+  reader.ReadInt64(&result->missing_us);
+  reader.ReadInt64(&result->max_gap_us);
+  reader.ReadInt64(&result->max_backlog_us);
+  reader.ReadInt64(&result->media_us);
+  reader.ReadInt64(&result->write_p50_us);
+  reader.ReadInt64(&result->write_p99_us);
+  reader.ReadInt64(&result->write_max_us);
+  reader.ReadInt64(&result->finish_us);
+  reader.ReadInt64(&result->file_bytes);
+  reader.ReadBool(&result->failed);
+  if (!reader.AtEnd()) {
+    error->code = "BAD_REPLY";
+    return false;
+  }
+  return true;
+}
+
+inline std::vector<uint8_t> EncodeIsRecording(
+    const IsRecordingArgs& args) {
+  FastWriter writer;
+  writer.WriteUint8(kFastCallMagic);
+  writer.WriteUint8(kVersion);
+  writer.WriteUint8(4);
+  return writer.Take();
+}
+
+inline bool DecodeIsRecordingReply(const uint8_t* reply,
+    size_t size,
+    IsRecordingResult* result,
+    FastError* error) {
+  FastReader reader(reply, size);
+  uint8_t status = 0;
+  if (!reader.ReadUint8(&status)) {
+    error->code = "NOT_IMPLEMENTED";
+    return false;
+  }
+  if (status != kFastReplySuccess) {
+    reader.ReadString(&error->code);
+    reader.ReadString(&error->message);
+    return false;
+  }
+  reader.ReadBool(&result->recording);
+  if (!reader.AtEnd()) {
+    error->code = "BAD_REPLY";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace audio_recorder
+
+}  // namespace fast_messages
+
+#endif  // NATIVE_CODEC_FAST_MESSAGES_G_H_
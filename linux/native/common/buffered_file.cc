@@ -0,0 +1,114 @@
+#include "common/buffered_file.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+BufferedFile::BufferedFile(size_t buffer_size) : buffer_(buffer_size) {}
+
+BufferedFile::~BufferedFile() {
+  if (fd_ >= 0) {
+    Abort();
+  }
+}
+
+bool BufferedFile::Open(const std::string& path) {
+  if (fd_ >= 0) {
+    return false;
+  }
+  path_ = path;
+  temp_path_ = path + ".part";
+  fd_ = ::open(temp_path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+               0644);
+  used_ = 0;
+  offset_ = 0;
+  ok_ = fd_ >= 0;
+  return ok_;
+}
+
+bool BufferedFile::Write(const void* data, size_t size) {
+  if (!ok_) {
+    return false;
+  }
+  const char* bytes = static_cast<const char*>(data);
+  offset_ += size;
+  while (size > 0) {
+    if (used_ == buffer_.size() && !Flush()) {
+      return false;
+    }
+    // Large writes with an empty buffer skip the copy entirely.
+    if (used_ == 0 && size >= buffer_.size()) {
+      ssize_t written = ::write(fd_, bytes, size);
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        ok_ = false;
+        return false;
+      }
+      bytes += written;
+      size -= static_cast<size_t>(written);
+      continue;
+    }
+    size_t chunk = buffer_.size() - used_;
+    if (chunk > size) {
+      chunk = size;
+    }
+    std::memcpy(buffer_.data() + used_, bytes, chunk);
+    used_ += chunk;
+    bytes += chunk;
+    size -= chunk;
+  }
+  return true;
+}
+
+bool BufferedFile::Flush() {
+  if (!ok_) {
+    return false;
+  }
+  size_t done = 0;
+  while (done < used_) {
+    ssize_t written = ::write(fd_, buffer_.data() + done, used_ - done);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      ok_ = false;
+      return false;
+    }
+    done += static_cast<size_t>(written);
+  }
+  used_ = 0;
+  return true;
+}
+
+bool BufferedFile::Commit() {
+  if (fd_ < 0) {
+    return false;
+  }
+  bool success = Flush() && ::fdatasync(fd_) == 0;
+  success = ::close(fd_) == 0 && success;
+  fd_ = -1;
+  if (success) {
+    success = std::rename(temp_path_.c_str(), path_.c_str()) == 0;
+  }
+  if (!success) {
+    ::unlink(temp_path_.c_str());
+    ok_ = false;
+  }
+  return success;
+}
+
+void BufferedFile::Abort() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+  if (!temp_path_.empty()) {
+    ::unlink(temp_path_.c_str());
+  }
+  ok_ = false;
+}
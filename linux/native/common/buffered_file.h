@@ -0,0 +1,54 @@
+#ifndef NATIVE_COMMON_BUFFERED_FILE_H_
+#define NATIVE_COMMON_BUFFERED_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Append-only file writer backed by a fixed-size buffer.
+//
+// Output goes to "<path>.part" and is only renamed into place by Commit(), so
+// a crashed or cancelled writer never leaves a truncated file under the final
+// name. Memory use is the buffer size regardless of how much is written.
+class BufferedFile {
+ public:
+  explicit BufferedFile(size_t buffer_size = 64 * 1024);
+  ~BufferedFile();
+
+  BufferedFile(const BufferedFile&) = delete;
+  BufferedFile& operator=(const BufferedFile&) = delete;
+
+  // Opens the temporary file next to |path|. Returns false on failure.
+  bool Open(const std::string& path);
+
+  bool Write(const void* data, size_t size);
+  bool Write(const std::string& data) { return Write(data.data(), data.size()); }
+
+  // Writes any buffered bytes to the file descriptor.
+  bool Flush();
+
+  // Flushes, syncs and renames the temporary file to the final path.
+  bool Commit();
+
+  // Closes and removes the temporary file.
+  void Abort();
+
+  bool is_open() const { return fd_ >= 0; }
+  bool ok() const { return ok_; }
+
+  // Number of bytes accepted so far, including bytes still buffered. This is
+  // also the current file offset, which the zip and PDF writers rely on.
+  uint64_t offset() const { return offset_; }
+
+ private:
+  int fd_ = -1;
+  std::string path_;
+  std::string temp_path_;
+  std::vector<char> buffer_;
+  size_t used_ = 0;
+  uint64_t offset_ = 0;
+  bool ok_ = true;
+};
+
+#endif  // NATIVE_COMMON_BUFFERED_FILE_H_
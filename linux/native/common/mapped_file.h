@@ -0,0 +1,35 @@
+#ifndef NATIVE_COMMON_MAPPED_FILE_H_
+#define NATIVE_COMMON_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only memory mapping of a whole file.
+//
+// The kernel pages data in on demand, so mapping a large archive costs
+// nothing until its bytes are touched. Empty files map to a null span.
+class MappedFile {
+ public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  // Maps |path|, releasing any previous mapping. Returns false on failure.
+  bool Open(const std::string& path);
+  void Close();
+
+  // Hints that the mapping will be read front to back.
+  void AdviseSequential();
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+#endif  // NATIVE_COMMON_MAPPED_FILE_H_
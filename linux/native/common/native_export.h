@@ -0,0 +1,8 @@
+#ifndef NATIVE_COMMON_NATIVE_EXPORT_H_
+#define NATIVE_COMMON_NATIVE_EXPORT_H_
+
+// Marks functions that Dart looks up through dart:ffi. The library is built
+// with hidden visibility, so anything without this stays internal.
+#define SS_EXPORT __attribute__((visibility("default")))
+
+#endif  // NATIVE_COMMON_NATIVE_EXPORT_H_
@@ -0,0 +1,11 @@
+#ifndef NATIVE_COMMON_PROC_FILE_H_
+#define NATIVE_COMMON_PROC_FILE_H_
+
+#include <string>
+
+// Reads a whole procfs, sysfs or cgroupfs file into |out|. Those report a
+// size of 0, so this reads until EOF instead of trusting stat(). Returns
+// false if the file cannot be opened or read.
+bool ReadProcFile(const std::string& path, std::string* out);
+
+#endif  // NATIVE_COMMON_PROC_FILE_H_
@@ -0,0 +1,17 @@
+#ifndef NATIVE_COMMON_THREAD_ID_H_
+#define NATIVE_COMMON_THREAD_ID_H_
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdint>
+
+// Kernel id of the calling thread, as shown by top and in /proc. Cached, so
+// only the first call per thread makes a syscall.
+inline uint32_t CurrentThreadId() {
+  static thread_local uint32_t thread_id =
+      static_cast<uint32_t>(::syscall(SYS_gettid));
+  return thread_id;
+}
+
+#endif  // NATIVE_COMMON_THREAD_ID_H_
@@ -0,0 +1,101 @@
+#ifndef NATIVE_CORO_AWAITABLES_H_
+#define NATIVE_CORO_AWAITABLES_H_
+
+#include <coroutine>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "scheduler/pool_api.h"
+#include "scheduler/task.h"
+
+// Awaitables that move a coroutine between the platform (main) thread and
+// the shared worker pool. They go through the C interface in pool_api.h, so
+// the runner can use them; "main thread" is wherever the MainThreadQueue is
+// drained, which the runner does on the GLib main context
+// (linux/runner/worker_pool.cc).
+
+namespace coro_internal {
+
+inline void ResumeHandle(void* address) {
+  std::coroutine_handle<>::from_address(address).resume();
+}
+
+inline void ResumeHandleTask(void* address, const SsCancelToken*) {
+  ResumeHandle(address);
+}
+
+}  // namespace coro_internal
+
+// co_await ResumeOnPool(): continues on a pool worker of |priority|.
+inline auto ResumeOnPool(TaskPriority priority = TaskPriority::kBackground) {
+  struct Awaiter {
+    TaskPriority priority;
+    bool await_ready() noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) noexcept {
+      ss_pool_post(static_cast<int32_t>(priority),
+                   coro_internal::ResumeHandleTask, nullptr,
+                   handle.address());
+    }
+    void await_resume() noexcept {}
+  };
+  return Awaiter{priority};
+}
+
+// co_await ResumeOnMain(): continues on the main thread in its next batch.
+inline auto ResumeOnMain() {
+  struct Awaiter {
+    bool await_ready() noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) noexcept {
+      ss_pool_post_to_main(coro_internal::ResumeHandle, handle.address());
+    }
+    void await_resume() noexcept {}
+  };
+  return Awaiter{};
+}
+
+// co_await RunInBackground(function): calls |function| on a pool worker and
+// continues on the main thread with its result. For blocking work started
+// from a platform-thread handler.
+template <typename Function>
+auto RunInBackground(Function function,
+                     TaskPriority priority = TaskPriority::kBackground) {
+  using Result = std::invoke_result_t<Function&>;
+  using Stored = std::conditional_t<std::is_void_v<Result>, bool, Result>;
+
+  struct Awaiter {
+    Function function;
+    TaskPriority priority;
+    std::optional<Stored> result;
+    std::coroutine_handle<> handle;
+
+    bool await_ready() noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> awaiting) noexcept {
+      handle = awaiting;
+      // The awaiter lives in the suspended frame until resumed, so the pool
+      // task can fill it in place.
+      ss_pool_post(
+          static_cast<int32_t>(priority),
+          [](void* data, const SsCancelToken*) {
+            Awaiter* self = static_cast<Awaiter*>(data);
+            if constexpr (std::is_void_v<Result>) {
+              self->function();
+              self->result.emplace(true);
+            } else {
+              self->result.emplace(self->function());
+            }
+            ss_pool_post_to_main(coro_internal::ResumeHandle,
+                                 self->handle.address());
+          },
+          nullptr, this);
+    }
+    Result await_resume() {
+      if constexpr (!std::is_void_v<Result>) {
+        return std::move(*result);
+      }
+    }
+  };
+  return Awaiter{std::move(function), priority, std::nullopt, {}};
+}
+
+#endif  // NATIVE_CORO_AWAITABLES_H_
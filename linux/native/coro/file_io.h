@@ -0,0 +1,107 @@
+#ifndef NATIVE_CORO_FILE_IO_H_
+#define NATIVE_CORO_FILE_IO_H_
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <string>
+#include <utility>
+
+#include "coro/awaitables.h"
+
+// File I/O for coroutines on the main thread: the blocking calls run on a
+// background pool worker and the coroutine continues on the main thread.
+
+struct FileResult {
+  int error = 0;      // errno of the failed call; 0 on success.
+  std::string data;   // Contents, for reads.
+
+  bool ok() const { return error == 0; }
+};
+
+namespace coro_internal {
+
+inline FileResult ReadWholeFile(const std::string& path) {
+  FileResult result;
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    result.error = errno;
+    return result;
+  }
+  char buffer[64 * 1024];
+  while (true) {
+    ssize_t count = read(fd, buffer, sizeof(buffer));
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count < 0) {
+      result.error = errno;
+      result.data.clear();
+      break;
+    }
+    if (count == 0) {
+      break;
+    }
+    result.data.append(buffer, static_cast<size_t>(count));
+  }
+  close(fd);
+  return result;
+}
+
+// Writes a sibling temporary file and renames it over |path|, so readers
+// see either the old or the new contents.
+inline FileResult ReplaceFile(const std::string& path,
+                              const std::string& data) {
+  FileResult result;
+  const std::string temporary = path + ".tmp";
+  int fd = open(temporary.c_str(),
+                O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    result.error = errno;
+    return result;
+  }
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t count = write(fd, data.data() + written, data.size() - written);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count < 0) {
+      result.error = errno;
+      break;
+    }
+    written += static_cast<size_t>(count);
+  }
+  if (result.ok() && fsync(fd) != 0) {
+    result.error = errno;
+  }
+  close(fd);
+  if (result.ok() && rename(temporary.c_str(), path.c_str()) != 0) {
+    result.error = errno;
+  }
+  if (!result.ok()) {
+    unlink(temporary.c_str());
+  }
+  return result;
+}
+
+}  // namespace coro_internal
+
+// co_await ReadFileAsync(path) -> FileResult with the whole file.
+inline auto ReadFileAsync(std::string path) {
+  return RunInBackground([path = std::move(path)] {
+    return coro_internal::ReadWholeFile(path);
+  });
+}
+
+// co_await WriteFileAsync(path, data) -> FileResult; replaces the file
+// atomically.
+inline auto WriteFileAsync(std::string path, std::string data) {
+  return RunInBackground([path = std::move(path), data = std::move(data)] {
+    return coro_internal::ReplaceFile(path, data);
+  });
+}
+
+#endif  // NATIVE_CORO_FILE_IO_H_
@@ -0,0 +1,145 @@
+#ifndef NATIVE_CORO_TASK_H_
+#define NATIVE_CORO_TASK_H_
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+// Lazily started coroutine producing a T (C++20).
+//
+// A Task does nothing until it is awaited; the awaiting coroutine resumes
+// when it finishes, on whatever thread finished it. Tasks own their frame
+// and are move-only. Exceptions are not used in this code base, so one
+// escaping a coroutine terminates. Use Spawn() to start a top-level
+// Task<void> from ordinary code.
+template <typename T = void>
+class Task;
+
+namespace coro_internal {
+
+struct PromiseBase {
+  struct FinalAwaiter {
+    bool await_ready() noexcept { return false; }
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<Promise> handle) noexcept {
+      // Symmetric transfer: resuming the awaiter here cannot grow the stack
+      // however long a chain of tasks completes synchronously.
+      std::coroutine_handle<> continuation = handle.promise().continuation;
+      return continuation ? continuation : std::noop_coroutine();
+    }
+    void await_resume() noexcept {}
+  };
+
+  std::suspend_always initial_suspend() noexcept { return {}; }
+  FinalAwaiter final_suspend() noexcept { return {}; }
+  void unhandled_exception() noexcept { std::terminate(); }
+
+  std::coroutine_handle<> continuation;
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+  Task<T> get_return_object() noexcept;
+  template <typename U>
+  void return_value(U&& result) {
+    value.emplace(std::forward<U>(result));
+  }
+
+  std::optional<T> value;
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+  Task<void> get_return_object() noexcept;
+  void return_void() noexcept {}
+};
+
+}  // namespace coro_internal
+
+template <typename T>
+class Task {
+ public:
+  using promise_type = coro_internal::Promise<T>;
+  using Handle = std::coroutine_handle<promise_type>;
+
+  Task() = default;
+  explicit Task(Handle handle) : handle_(handle) {}
+  Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      handle_ = std::exchange(other.handle_, {});
+    }
+    return *this;
+  }
+  ~Task() { Reset(); }
+
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+
+  bool valid() const { return static_cast<bool>(handle_); }
+
+  auto operator co_await() && noexcept {
+    struct Awaiter {
+      Handle handle;
+      bool await_ready() noexcept { return false; }
+      std::coroutine_handle<> await_suspend(
+          std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+      }
+      T await_resume() {
+        if constexpr (!std::is_void_v<T>) {
+          return std::move(*handle.promise().value);
+        }
+      }
+    };
+    return Awaiter{handle_};
+  }
+
+ private:
+  void Reset() {
+    if (handle_) {
+      handle_.destroy();
+      handle_ = {};
+    }
+  }
+
+  Handle handle_;
+};
+
+namespace coro_internal {
+
+template <typename T>
+Task<T> Promise<T>::get_return_object() noexcept {
+  return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() noexcept {
+  return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+// Starts immediately and frees itself when done.
+struct Detached {
+  struct promise_type {
+    Detached get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+}  // namespace coro_internal
+
+// Runs |task| on the calling thread until its first suspension; it then
+// continues wherever its awaits resume it. The frame frees itself at the
+// end.
+inline coro_internal::Detached Spawn(Task<void> task) {
+  co_await std::move(task);
+}
+
+#endif  // NATIVE_CORO_TASK_H_
@@ -0,0 +1,223 @@
+#include "diagnostics/channel_metrics.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#include "codec/fast_codec.h"
+
+namespace {
+
+// StandardMessageCodec type tag for strings.
+constexpr uint8_t kStandardString = 7;
+
+void AppendEscaped(std::string* out, const std::string& value) {
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      out->push_back('\\');
+      out->push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out->push_back(' ');
+    } else {
+      out->push_back(c);
+    }
+  }
+}
+
+void AppendHistogram(std::string* out, const char* name,
+                     const HdrHistogram& histogram) {
+  char buffer[256];
+  snprintf(buffer, sizeof(buffer),
+           "\"%s\":{\"count\":%" PRIu64 ",\"mean\":%.1f,\"p50\":%" PRIu64
+           ",\"p90\":%" PRIu64 ",\"p99\":%" PRIu64 ",\"max\":%" PRIu64 "}",
+           name, histogram.count(), histogram.Mean(),
+           histogram.ValueAtPercentile(50), histogram.ValueAtPercentile(90),
+           histogram.ValueAtPercentile(99), histogram.max());
+  out->append(buffer);
+}
+
+}  // namespace
+
+MethodMetrics::MethodMetrics(const std::string& channel,
+                             const std::string& method, uint32_t id)
+    : channel_(channel), method_(method), id_(id) {}
+
+void MethodMetrics::Record(const ChannelCallSample& sample) {
+  if (sample.status == ChannelCallStatus::kError) {
+    errors_.fetch_add(1, std::memory_order_relaxed);
+  } else if (sample.status == ChannelCallStatus::kNotImplemented) {
+    not_implemented_.fetch_add(1, std::memory_order_relaxed);
+  }
+  handler_us_.Record(sample.handler_us);
+  response_us_.Record(sample.response_us);
+  request_bytes_.Record(sample.request_bytes);
+  response_bytes_.Record(sample.response_bytes);
+}
+
+void MethodMetrics::Reset() {
+  errors_.store(0, std::memory_order_relaxed);
+  not_implemented_.store(0, std::memory_order_relaxed);
+  handler_us_.Reset();
+  response_us_.Reset();
+  request_bytes_.Reset();
+  response_bytes_.Reset();
+}
+
+void MethodMetrics::AppendJson(std::string* out) const {
+  out->append("{\"channel\":\"");
+  AppendEscaped(out, channel_);
+  out->append("\",\"method\":\"");
+  AppendEscaped(out, method_);
+  char buffer[128];
+  snprintf(buffer, sizeof(buffer),
+           "\",\"calls\":%" PRIu64 ",\"errors\":%" PRIu64
+           ",\"not_implemented\":%" PRIu64 ",",
+           handler_us_.count(), errors_.load(std::memory_order_relaxed),
+           not_implemented_.load(std::memory_order_relaxed));
+  out->append(buffer);
+  AppendHistogram(out, "handler_us", handler_us_);
+  out->push_back(',');
+  AppendHistogram(out, "response_us", response_us_);
+  out->push_back(',');
+  AppendHistogram(out, "request_bytes", request_bytes_);
+  out->push_back(',');
+  AppendHistogram(out, "response_bytes", response_bytes_);
+  out->push_back('}');
+}
+
+ChannelMetrics& ChannelMetrics::Get() {
+  static ChannelMetrics* metrics = new ChannelMetrics();
+  return *metrics;
+}
+
+void ChannelMetrics::SetEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+MethodMetrics* ChannelMetrics::ForMessage(const std::string& channel,
+                                          const uint8_t* message,
+                                          size_t size) {
+  std::string method = MethodNameFromMessage(message, size);
+  std::string key = channel + '\n' + method;
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::unique_ptr<MethodMetrics>& slot = methods_[key];
+  if (!slot) {
+    slot = std::make_unique<MethodMetrics>(
+        channel, method, static_cast<uint32_t>(by_id_.size()));
+    by_id_.push_back(slot.get());
+  }
+  return slot.get();
+}
+
+void ChannelMetrics::RecordPlatformLag(uint64_t lag_us) {
+  platform_lag_us_.Record(lag_us);
+}
+
+void ChannelMetrics::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& entry : methods_) {
+    entry.second->Reset();
+  }
+  platform_lag_us_.Reset();
+}
+
+std::string ChannelMetrics::ToJson() const {
+  std::string out = enabled() ? "{\"enabled\":true," : "{\"enabled\":false,";
+  AppendHistogram(&out, "platform_lag_us", platform_lag_us_);
+  out.append(",\"methods\":[");
+  std::lock_guard<std::mutex> lock(mutex_);
+  bool first = true;
+  for (const auto& entry : methods_) {
+    if (!first) {
+      out.push_back(',');
+    }
+    first = false;
+    entry.second->AppendJson(&out);
+  }
+  out.append("]}");
+  return out;
+}
+
+std::string ChannelMetrics::Summary() const {
+  std::string out;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& entry : methods_) {
+    entry.second->AppendJson(&out);
+    out.push_back('\n');
+  }
+  return out;
+}
+
+std::vector<const MethodMetrics*> ChannelMetrics::Methods() const {
+  std::vector<const MethodMetrics*> methods;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& entry : methods_) {
+    methods.push_back(entry.second.get());
+  }
+  return methods;
+}
+
+const MethodMetrics* ChannelMetrics::MethodById(uint32_t id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return id < by_id_.size() ? by_id_[id] : nullptr;
+}
+
+std::string MethodNameFromMessage(const uint8_t* message, size_t size) {
+  if (message == nullptr || size == 0) {
+    return "?";
+  }
+  if (message[0] == kStandardString && size >= 2) {
+    // Sizes below 254 take one byte; 254 and 255 prefix a 16 or 32-bit size.
+    size_t length = message[1];
+    size_t offset = 2;
+    if (length == 254 && size >= 4) {
+      length = message[2] | (message[3] << 8);
+      offset = 4;
+    } else if (length == 255) {
+      return "?";
+    }
+    if (offset + length <= size) {
+      return std::string(reinterpret_cast<const char*>(message + offset),
+                         length);
+    }
+    return "?";
+  }
+  if (message[0] == kFastCallMagic && size >= 3) {
+    // Fast-path calls carry a numeric id; the schema has the name.
+    return "call " + std::to_string(message[2]);
+  }
+  if (message[0] == '{') {
+    static const char kKey[] = "\"method\":\"";
+    std::string text(reinterpret_cast<const char*>(message),
+                     size < 512 ? size : 512);
+    size_t start = text.find(kKey);
+    if (start != std::string::npos) {
+      start += sizeof(kKey) - 1;
+      size_t end = text.find('"', start);
+      if (end != std::string::npos) {
+        return text.substr(start, end - start);
+      }
+    }
+  }
+  return "?";
+}
+
+ChannelCallStatus StatusFromResponse(const uint8_t* response, size_t size) {
+  if (response == nullptr || size == 0) {
+    return ChannelCallStatus::kNotImplemented;
+  }
+  // StandardMethodCodec envelopes start with 0 (success) or 1 (error).
+  if (response[0] == 1) {
+    return ChannelCallStatus::kError;
+  }
+  // JSONMethodCodec errors are ["code", "message", details].
+  if (response[0] == '[' && size > 2 && response[1] == '"') {
+    const uint8_t* end = response + size;
+    const uint8_t* quote = static_cast<const uint8_t*>(
+        std::memchr(response + 2, '"', size - 2));
+    if (quote != nullptr && quote + 1 < end && quote[1] == ',') {
+      return ChannelCallStatus::kError;
+    }
+  }
+  return ChannelCallStatus::kSuccess;
+}
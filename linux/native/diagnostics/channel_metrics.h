@@ -0,0 +1,117 @@
+#ifndef NATIVE_DIAGNOSTICS_CHANNEL_METRICS_H_
+#define NATIVE_DIAGNOSTICS_CHANNEL_METRICS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "diagnostics/hdr_histogram.h"
+
+// Platform-channel call metrics gathered by the runners.
+//
+// Portable on purpose: the Linux runner feeds it through diagnostics_api.h
+// and the Windows runner compiles it in directly.
+
+enum class ChannelCallStatus {
+  kSuccess = 0,
+  kError = 1,
+  kNotImplemented = 2,  // Empty reply.
+};
+
+// Measurements of one finished call.
+struct ChannelCallSample {
+  uint64_t handler_us = 0;   // Time spent inside the handler.
+  uint64_t response_us = 0;  // Arrival until reply, including async work.
+  uint64_t request_bytes = 0;
+  uint64_t response_bytes = 0;
+  ChannelCallStatus status = ChannelCallStatus::kSuccess;
+};
+
+// Per channel and method totals.
+class MethodMetrics {
+ public:
+  MethodMetrics(const std::string& channel, const std::string& method,
+                uint32_t id);
+
+  void Record(const ChannelCallSample& sample);
+  void Reset();
+  void AppendJson(std::string* out) const;
+
+  const std::string& channel() const { return channel_; }
+  const std::string& method() const { return method_; }
+  // Small number, in order of first use.
+  uint32_t id() const { return id_; }
+  uint64_t calls() const { return handler_us_.count(); }
+  uint64_t errors() const { return errors_.load(std::memory_order_relaxed); }
+  const HdrHistogram& handler_us() const { return handler_us_; }
+  const HdrHistogram& response_us() const { return response_us_; }
+  const HdrHistogram& request_bytes() const { return request_bytes_; }
+
+ private:
+  const std::string channel_;
+  const std::string method_;
+  const uint32_t id_;
+  std::atomic<uint64_t> errors_{0};
+  std::atomic<uint64_t> not_implemented_{0};
+  HdrHistogram handler_us_;
+  HdrHistogram response_us_;
+  HdrHistogram request_bytes_;
+  HdrHistogram response_bytes_;
+};
+
+class ChannelMetrics {
+ public:
+  static ChannelMetrics& Get();
+
+  // Cheap enough to check on every message; instrumentation does nothing
+  // else while this is false.
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+  void SetEnabled(bool enabled);
+
+  // Returns the metrics for the method named in |message|, creating them on
+  // first use. The pointer stays valid for the life of the process.
+  MethodMetrics* ForMessage(const std::string& channel, const uint8_t* message,
+                            size_t size);
+
+  // Lateness of a periodic timer on the platform thread, which is how long
+  // any channel message would have waited to be dispatched.
+  void RecordPlatformLag(uint64_t lag_us);
+
+  void Reset();
+
+  // {"enabled":..,"platform_lag_us":{..},"methods":[{..},..]}
+  std::string ToJson() const;
+
+  // One JSON object per line and method, for the periodic dump.
+  std::string Summary() const;
+
+  // Every method seen so far, in channel and method order.
+  std::vector<const MethodMetrics*> Methods() const;
+
+  // The method with MethodMetrics::id() |id|, or null.
+  const MethodMetrics* MethodById(uint32_t id) const;
+
+ private:
+  ChannelMetrics() = default;
+
+  std::atomic<bool> enabled_{false};
+  mutable std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<MethodMetrics>> methods_;
+  std::vector<const MethodMetrics*> by_id_;
+  HdrHistogram platform_lag_us_;
+};
+
+// Reads the method name from an encoded method call: StandardMethodCodec
+// (leading string), JSONMethodCodec ({"method": ...}) or a fast-path call
+// ("call <id>", see codec/fast_codec.h). Returns "?" for anything else.
+std::string MethodNameFromMessage(const uint8_t* message, size_t size);
+
+// Classifies an encoded reply envelope from either codec.
+ChannelCallStatus StatusFromResponse(const uint8_t* response, size_t size);
+
+#endif  // NATIVE_DIAGNOSTICS_CHANNEL_METRICS_H_
@@ -0,0 +1,169 @@
+#include "diagnostics/diagnostics_api.h"
+
+#include <time.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "diagnostics/channel_metrics.h"
+#include "diagnostics/process_telemetry.h"
+#include "logging/logger.h"
+#include "stream/stream_registry.h"
+#include "tracing/tracer.h"
+
+namespace {
+
+uint64_t NonNegative(int64_t value) {
+  return value > 0 ? static_cast<uint64_t>(value) : 0;
+}
+
+int32_t Clamp32(uint64_t value) {
+  return static_cast<int32_t>(std::min<uint64_t>(value, INT32_MAX));
+}
+
+int32_t CopyJson(const std::string& json, char* buffer, int32_t size) {
+  if (buffer != nullptr && size > 0) {
+    size_t copied = std::min<size_t>(json.size(), size - 1);
+    std::memcpy(buffer, json.data(), copied);
+    buffer[copied] = '\0';
+  }
+  return static_cast<int32_t>(json.size());
+}
+
+int64_t MonotonicUs() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+}
+
+// Every call as it happens, for a live view in Dart. Written on the
+// platform thread only.
+RecordRing* CallStream() {
+  static RecordRing* ring = StreamRegistry::Get().Open(
+      SS_CHANNEL_CALL_STREAM, sizeof(SsChannelCallRecord), 4096);
+  return ring;
+}
+
+void WriteCallRecord(const MethodMetrics& method,
+                     const ChannelCallSample& sample) {
+  RecordRing* ring = CallStream();
+  if (ring == nullptr || !ring->attached()) {
+    return;
+  }
+  SsChannelCallRecord record;
+  record.time_us = MonotonicUs();
+  record.handler_us = static_cast<int64_t>(sample.handler_us);
+  record.response_us = static_cast<int64_t>(sample.response_us);
+  record.request_bytes = Clamp32(sample.request_bytes);
+  record.response_bytes = Clamp32(sample.response_bytes);
+  record.status = static_cast<int32_t>(sample.status);
+  record.method_id = method.id();
+  ring->Push(record);
+}
+
+}  // namespace
+
+void ss_diag_set_enabled(bool enabled) {
+  ChannelMetrics::Get().SetEnabled(enabled);
+}
+
+bool ss_diag_enabled(void) {
+  return ChannelMetrics::Get().enabled();
+}
+
+SsChannelMethod* ss_diag_channel_method(const char* channel,
+                                        const uint8_t* message, size_t size) {
+  if (channel == nullptr) {
+    return nullptr;
+  }
+  return reinterpret_cast<SsChannelMethod*>(
+      ChannelMetrics::Get().ForMessage(channel, message, size));
+}
+
+int32_t ss_diag_response_status(const uint8_t* response, size_t size) {
+  return static_cast<int32_t>(StatusFromResponse(response, size));
+}
+
+uint32_t ss_diag_method_trace_name(const SsChannelMethod* method) {
+  if (method == nullptr) {
+    return 0;
+  }
+  // Only asked for while a trace session runs, so the lookup is not cached.
+  const MethodMetrics* metrics =
+      reinterpret_cast<const MethodMetrics*>(method);
+  return Tracer::Intern(metrics->channel() + ": " + metrics->method());
+}
+
+int32_t ss_diag_method_name(uint32_t method_id, char* buffer, int32_t size) {
+  const MethodMetrics* method = ChannelMetrics::Get().MethodById(method_id);
+  if (method == nullptr) {
+    return -1;
+  }
+  std::string name = method->channel() + ": " + method->method();
+  if (buffer != nullptr && size > 0) {
+    size_t copied = std::min<size_t>(name.size(), size - 1);
+    std::memcpy(buffer, name.data(), copied);
+    buffer[copied] = '\0';
+  }
+  return static_cast<int32_t>(name.size());
+}
+
+void ss_diag_record_call(SsChannelMethod* method,
+                         const SsChannelCallSample* sample) {
+  if (method == nullptr || sample == nullptr) {
+    return;
+  }
+  ChannelCallSample converted;
+  converted.handler_us = NonNegative(sample->handler_us);
+  converted.response_us = NonNegative(sample->response_us);
+  converted.request_bytes = NonNegative(sample->request_bytes);
+  converted.response_bytes = NonNegative(sample->response_bytes);
+  if (sample->status >= 0 &&
+      sample->status <= static_cast<int32_t>(ChannelCallStatus::kNotImplemented)) {
+    converted.status = static_cast<ChannelCallStatus>(sample->status);
+  }
+  MethodMetrics* metrics = reinterpret_cast<MethodMetrics*>(method);
+  metrics->Record(converted);
+  WriteCallRecord(*metrics, converted);
+}
+
+void ss_diag_record_platform_lag(int64_t lag_us) {
+  ChannelMetrics::Get().RecordPlatformLag(NonNegative(lag_us));
+}
+
+void ss_diag_reset(void) {
+  ChannelMetrics::Get().Reset();
+}
+
+int32_t ss_diag_get_json(char* buffer, int32_t size) {
+  return CopyJson(ChannelMetrics::Get().ToJson(), buffer, size);
+}
+
+void ss_diag_log_summary(void) {
+  for (const MethodMetrics* method : ChannelMetrics::Get().Methods()) {
+    if (method->calls() == 0) {
+      continue;
+    }
+    SS_LOG(LogLevel::kInfo, "channels",
+           "{} {}: {} calls, {} errors, handler p50 {} us p99 {} us, "
+           "response p99 {} us, request p99 {} bytes",
+           method->channel(), method->method(), method->calls(),
+           method->errors(), method->handler_us().ValueAtPercentile(50),
+           method->handler_us().ValueAtPercentile(99),
+           method->response_us().ValueAtPercentile(99),
+           method->request_bytes().ValueAtPercentile(99));
+  }
+}
+
+bool ss_diag_sample_process(void) {
+  return ProcessTelemetry::Get().Sample();
+}
+
+int32_t ss_diag_get_process_json(char* buffer, int32_t size) {
+  return CopyJson(ProcessTelemetry::Get().ToJson(), buffer, size);
+}
+
+void ss_diag_log_process_summary(void) {
+  ProcessTelemetry::Get().LogSummary();
+}
@@ -0,0 +1,94 @@
+#ifndef NATIVE_DIAGNOSTICS_DIAGNOSTICS_API_H_
+#define NATIVE_DIAGNOSTICS_DIAGNOSTICS_API_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common/native_export.h"
+
+// C interface for the runner's channel instrumentation
+// (linux/runner/channel_instrumentation.cc).
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SsChannelMethod SsChannelMethod;
+
+// Mirrors ChannelCallSample. |status| is a ChannelCallStatus.
+typedef struct {
+  int64_t handler_us;
+  int64_t response_us;
+  int64_t request_bytes;
+  int64_t response_bytes;
+  int32_t status;
+} SsChannelCallSample;
+
+// Record of the "channel_calls" stream (stream/stream_api.h), written for
+// each recorded call while a reader is attached.
+typedef struct {
+  int64_t time_us;  // CLOCK_MONOTONIC when the reply was sent.
+  int64_t handler_us;
+  int64_t response_us;
+  int32_t request_bytes;
+  int32_t response_bytes;
+  int32_t status;
+  uint32_t method_id;  // See ss_diag_method_name().
+} SsChannelCallRecord;
+
+#define SS_CHANNEL_CALL_STREAM "channel_calls"
+
+SS_EXPORT void ss_diag_set_enabled(bool enabled);
+SS_EXPORT bool ss_diag_enabled(void);
+
+// Returns the metrics slot for the method encoded in |message| on
+// |channel|. Slots live for the whole process.
+SS_EXPORT SsChannelMethod* ss_diag_channel_method(const char* channel,
+                                                  const uint8_t* message,
+                                                  size_t size);
+
+// Classifies an encoded reply. Returns a ChannelCallStatus.
+SS_EXPORT int32_t ss_diag_response_status(const uint8_t* response,
+                                          size_t size);
+
+// Tracer string id to name spans of |method| with (see trace_api.h).
+SS_EXPORT uint32_t ss_diag_method_trace_name(const SsChannelMethod* method);
+
+// Writes "<channel>: <method>" for a method id from SsChannelCallRecord.
+// Returns the full length, or -1 for an unknown id.
+SS_EXPORT int32_t ss_diag_method_name(uint32_t method_id,
+                                      char* buffer,
+                                      int32_t size);
+
+SS_EXPORT void ss_diag_record_call(SsChannelMethod* method,
+                                   const SsChannelCallSample* sample);
+
+SS_EXPORT void ss_diag_record_platform_lag(int64_t lag_us);
+
+SS_EXPORT void ss_diag_reset(void);
+
+// Copies the metrics as JSON into |buffer| (NUL-terminated when |size| >
+// 0). Returns the full length, so callers can retry with a larger buffer.
+SS_EXPORT int32_t ss_diag_get_json(char* buffer, int32_t size);
+
+// Writes one log record per method to the native log.
+SS_EXPORT void ss_diag_log_summary(void);
+
+// Process telemetry (diagnostics/process_telemetry.h). Sampling takes a
+// fraction of a millisecond of file reads; call it from a worker. Returns
+// false if /proc could not be read.
+SS_EXPORT bool ss_diag_sample_process(void);
+
+// Copies the sample window and per-thread activity as JSON, like
+// ss_diag_get_json().
+SS_EXPORT int32_t ss_diag_get_process_json(char* buffer, int32_t size);
+
+// Logs rates over the sample window and the busiest threads.
+SS_EXPORT void ss_diag_log_process_summary(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // NATIVE_DIAGNOSTICS_DIAGNOSTICS_API_H_
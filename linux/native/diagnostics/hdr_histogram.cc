@@ -0,0 +1,104 @@
+#include "diagnostics/hdr_histogram.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+constexpr uint64_t kSubBucketCount = uint64_t{1} << HdrHistogram::kSubBucketBits;
+constexpr uint64_t kSubBucketHalf = kSubBucketCount / 2;
+
+// |value| must be non-zero.
+int FloorLog2(uint64_t value) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanReverse64(&index, value);
+  return static_cast<int>(index);
+#else
+  return 63 - __builtin_clzll(value);
+#endif
+}
+
+}  // namespace
+
+HdrHistogram::HdrHistogram(uint64_t highest_trackable)
+    : highest_trackable_(highest_trackable < kSubBucketCount
+                             ? kSubBucketCount
+                             : highest_trackable),
+      bucket_count_(IndexFor(highest_trackable_) + 1),
+      counts_(new std::atomic<uint64_t>[bucket_count_]) {
+  Reset();
+}
+
+size_t HdrHistogram::IndexFor(uint64_t value) const {
+  if (value < kSubBucketCount) {
+    return static_cast<size_t>(value);
+  }
+  // |shift| is how many low bits a sub-bucket of this range spans.
+  int shift = FloorLog2(value) - (kSubBucketBits - 1);
+  uint64_t sub_bucket = value >> shift;  // In [half, count).
+  return static_cast<size_t>((shift + 1) * kSubBucketHalf +
+                             (sub_bucket - kSubBucketHalf));
+}
+
+uint64_t HdrHistogram::HighestEquivalentValue(size_t index) const {
+  if (index < kSubBucketCount) {
+    return index;
+  }
+  int shift = static_cast<int>(index / kSubBucketHalf) - 1;
+  uint64_t sub_bucket = index % kSubBucketHalf + kSubBucketHalf;
+  return ((sub_bucket + 1) << shift) - 1;
+}
+
+void HdrHistogram::Record(uint64_t value) {
+  if (value > highest_trackable_) {
+    value = highest_trackable_;
+  }
+  counts_[IndexFor(value)].fetch_add(1, std::memory_order_relaxed);
+  total_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+  uint64_t seen = max_.load(std::memory_order_relaxed);
+  while (value > seen &&
+         !max_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+  }
+}
+
+void HdrHistogram::Reset() {
+  for (size_t i = 0; i < bucket_count_; i++) {
+    counts_[i].store(0, std::memory_order_relaxed);
+  }
+  total_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+double HdrHistogram::Mean() const {
+  uint64_t total = count();
+  return total == 0 ? 0.0
+                    : static_cast<double>(sum_.load(std::memory_order_relaxed)) /
+                          total;
+}
+
+uint64_t HdrHistogram::ValueAtPercentile(double percentile) const {
+  uint64_t total = count();
+  if (total == 0) {
+    return 0;
+  }
+  if (percentile > 100.0) {
+    percentile = 100.0;
+  }
+  uint64_t target = static_cast<uint64_t>(percentile / 100.0 * total + 0.5);
+  if (target == 0) {
+    target = 1;
+  }
+  uint64_t seen = 0;
+  for (size_t i = 0; i < bucket_count_; i++) {
+    seen += counts_[i].load(std::memory_order_relaxed);
+    if (seen >= target) {
+      uint64_t value = HighestEquivalentValue(i);
+      return value < max() ? value : max();
+    }
+  }
+  return max();
+}
@@ -0,0 +1,49 @@
+#ifndef NATIVE_DIAGNOSTICS_HDR_HISTOGRAM_H_
+#define NATIVE_DIAGNOSTICS_HDR_HISTOGRAM_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Fixed-memory histogram with bounded relative error, after HdrHistogram.
+//
+// Values are grouped into power-of-two ranges and each range is split into
+// 2^(kSubBucketBits - 1) linear sub-buckets, so any recorded value is
+// reported within 1/64 (about 1.6%) of itself. Values below 128 are exact.
+// Recording is a single relaxed atomic increment and may happen on any
+// thread; reads are not synchronized with writers and see a recent
+// snapshot.
+class HdrHistogram {
+ public:
+  static constexpr int kSubBucketBits = 7;
+
+  // Values above |highest_trackable| are clamped to it.
+  explicit HdrHistogram(uint64_t highest_trackable = uint64_t{1} << 36);
+
+  HdrHistogram(const HdrHistogram&) = delete;
+  HdrHistogram& operator=(const HdrHistogram&) = delete;
+
+  void Record(uint64_t value);
+  void Reset();
+
+  uint64_t count() const { return total_.load(std::memory_order_relaxed); }
+  uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+  double Mean() const;
+
+  // Highest value equivalent to the one at |percentile| (0-100).
+  uint64_t ValueAtPercentile(double percentile) const;
+
+ private:
+  size_t IndexFor(uint64_t value) const;
+  uint64_t HighestEquivalentValue(size_t index) const;
+
+  const uint64_t highest_trackable_;
+  const size_t bucket_count_;
+  std::unique_ptr<std::atomic<uint64_t>[]> counts_;
+  std::atomic<uint64_t> total_{0};
+  std::atomic<uint64_t> sum_{0};
+  std::atomic<uint64_t> max_{0};
+};
+
+#endif  // NATIVE_DIAGNOSTICS_HDR_HISTOGRAM_H_
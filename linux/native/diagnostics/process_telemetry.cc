@@ -0,0 +1,369 @@
+#include "diagnostics/process_telemetry.h"
+
+#include <dirent.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+#include "common/proc_file.h"
+#include "logging/logger.h"
+#include "tracing/tracer.h"
+
+namespace {
+
+int64_t MonotonicUs() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+}
+
+// Value after "<name>:" on a line of a "key: value" file.
+bool ParseField(const std::string& line, const char* name, uint64_t* value) {
+  const size_t length = std::char_traits<char>::length(name);
+  if (line.size() <= length || line.compare(0, length, name) != 0 ||
+      line[length] != ':') {
+    return false;
+  }
+  *value = std::strtoull(line.c_str() + length + 1, nullptr, 10);
+  return true;
+}
+
+// Calls |entry| with each numeric name in |directory|; returns how many
+// entries there were, not counting "." and "..".
+template <typename Entry>
+uint32_t ForEachEntry(const std::string& directory, Entry entry) {
+  DIR* dir = opendir(directory.c_str());
+  if (dir == nullptr) {
+    return 0;
+  }
+  uint32_t count = 0;
+  while (const dirent* item = readdir(dir)) {
+    if (item->d_name[0] == '.') {
+      continue;
+    }
+    count++;
+    entry(item->d_name);
+  }
+  closedir(dir);
+  return count;
+}
+
+void AppendEscaped(std::string* out, const std::string& value) {
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      out->push_back('\\');
+      out->push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out->push_back(' ');
+    } else {
+      out->push_back(c);
+    }
+  }
+}
+
+// Per-second rate of a counter between two samples; counters summed over
+// threads can go down when threads exit, which reads as 0.
+double Rate(uint64_t first, uint64_t last, double seconds) {
+  return last > first && seconds > 0 ? (last - first) / seconds : 0;
+}
+
+}  // namespace
+
+bool ParseProcStat(const std::string& text, int64_t ticks_per_second,
+                   uint64_t page_size, ProcessSample* out) {
+  // The command name may contain anything, including ") ", so fields are
+  // counted from the last parenthesis.
+  const size_t paren = text.rfind(')');
+  if (paren == std::string::npos || ticks_per_second <= 0) {
+    return false;
+  }
+  std::istringstream fields(text.substr(paren + 1));
+  // Field 3 (state) onwards; utime and stime are 14 and 15, num_threads 20
+  // and rss 24, counting from 1.
+  std::string field;
+  int64_t utime = -1;
+  int64_t stime = -1;
+  int64_t threads = -1;
+  int64_t rss_pages = -1;
+  for (int number = 3; number <= 24 && fields >> field; number++) {
+    if (number == 14) {
+      utime = std::strtoll(field.c_str(), nullptr, 10);
+    } else if (number == 15) {
+      stime = std::strtoll(field.c_str(), nullptr, 10);
+    } else if (number == 20) {
+      threads = std::strtoll(field.c_str(), nullptr, 10);
+    } else if (number == 24) {
+      rss_pages = std::strtoll(field.c_str(), nullptr, 10);
+    }
+  }
+  if (rss_pages < 0) {
+    return false;
+  }
+  out->cpu_user_us = utime * 1000000 / ticks_per_second;
+  out->cpu_system_us = stime * 1000000 / ticks_per_second;
+  out->threads = static_cast<uint32_t>(threads);
+  out->rss_bytes = static_cast<uint64_t>(rss_pages) * page_size;
+  return true;
+}
+
+bool ParseProcIo(const std::string& text, ProcessSample* out) {
+  bool has_read = false;
+  bool has_write = false;
+  std::istringstream lines(text);
+  std::string line;
+  while (std::getline(lines, line)) {
+    has_read |= ParseField(line, "read_bytes", &out->read_bytes);
+    has_write |= ParseField(line, "write_bytes", &out->write_bytes);
+  }
+  return has_read && has_write;
+}
+
+bool ParseSmapsRollupPss(const std::string& text, uint64_t* pss_bytes) {
+  std::istringstream lines(text);
+  std::string line;
+  while (std::getline(lines, line)) {
+    uint64_t kib;
+    if (ParseField(line, "Pss", &kib)) {
+      *pss_bytes = kib * 1024;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ParseThreadStatus(const std::string& text, std::string* name,
+                       uint64_t* voluntary, uint64_t* involuntary) {
+  bool has_switches = false;
+  std::istringstream lines(text);
+  std::string line;
+  while (std::getline(lines, line)) {
+    if (line.compare(0, 5, "Name:") == 0) {
+      const size_t start = line.find_first_not_of(" \t", 5);
+      *name = start == std::string::npos ? "" : line.substr(start);
+    } else if (ParseField(line, "voluntary_ctxt_switches", voluntary)) {
+      has_switches = true;
+    } else {
+      ParseField(line, "nonvoluntary_ctxt_switches", involuntary);
+    }
+  }
+  return has_switches;
+}
+
+bool ParseSchedstat(const std::string& text, uint64_t* cpu_ns) {
+  char* end = nullptr;
+  const uint64_t value = std::strtoull(text.c_str(), &end, 10);
+  if (end == text.c_str()) {
+    return false;
+  }
+  *cpu_ns = value;
+  return true;
+}
+
+ProcessTelemetry& ProcessTelemetry::Get() {
+  static ProcessTelemetry* telemetry =
+      new ProcessTelemetry(ProcessTelemetryOptions());
+  return *telemetry;
+}
+
+ProcessTelemetry::ProcessTelemetry(const ProcessTelemetryOptions& options)
+    : options_(options),
+      ticks_per_second_(sysconf(_SC_CLK_TCK)),
+      page_size_(static_cast<uint64_t>(sysconf(_SC_PAGESIZE))),
+      ring_(std::max<size_t>(options.window, 1)) {}
+
+bool ProcessTelemetry::Sample() {
+  SS_TRACE_SCOPE("telemetry", "sample");
+  std::lock_guard<std::mutex> sample_lock(sample_mutex_);
+  ProcessSample sample;
+  sample.time_us = MonotonicUs();
+  std::string text;
+  if (!ReadProcFile(options_.proc_self + "/stat", &text) ||
+      !ParseProcStat(text, ticks_per_second_, page_size_, &sample)) {
+    return false;
+  }
+  if (ReadProcFile(options_.proc_self + "/io", &text)) {
+    ParseProcIo(text, &sample);
+  }
+  if (options_.pss_every > 0 && samples_taken_ % options_.pss_every == 0 &&
+      ReadProcFile(options_.proc_self + "/smaps_rollup", &text)) {
+    ParseSmapsRollupPss(text, &last_pss_bytes_);
+  }
+  sample.pss_bytes = last_pss_bytes_;
+  // opendir() holds a descriptor of its own while counting.
+  const uint32_t fds =
+      ForEachEntry(options_.proc_self + "/fd", [](const char*) {});
+  sample.fds = fds > 0 ? fds - 1 : 0;
+  SampleThreads(&sample);
+  samples_taken_++;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  ring_[next_] = sample;
+  next_ = (next_ + 1) % ring_.size();
+  count_ = std::min(count_ + 1, ring_.size());
+  return true;
+}
+
+void ProcessTelemetry::SampleThreads(ProcessSample* sample) {
+  const std::string task_directory = options_.proc_self + "/task/";
+  std::string text;
+  ForEachEntry(task_directory, [&](const char* entry) {
+    const uint32_t thread_id =
+        static_cast<uint32_t>(std::strtoul(entry, nullptr, 10));
+    const std::string directory = task_directory + entry;
+    std::string name;
+    uint64_t voluntary = 0;
+    uint64_t involuntary = 0;
+    if (!ReadProcFile(directory + "/status", &text) ||
+        !ParseThreadStatus(text, &name, &voluntary, &involuntary)) {
+      return;  // Exited meanwhile.
+    }
+    uint64_t cpu_ns = 0;
+    if (!ReadProcFile(directory + "/schedstat", &text) ||
+        !ParseSchedstat(text, &cpu_ns)) {
+      // Kernels without schedstats: tick-based times from stat.
+      ProcessSample thread;
+      if (ReadProcFile(directory + "/stat", &text) &&
+          ParseProcStat(text, ticks_per_second_, page_size_, &thread)) {
+        cpu_ns = static_cast<uint64_t>(thread.cpu_user_us +
+                                       thread.cpu_system_us) *
+                 1000;
+      }
+    }
+
+    auto found = threads_.find(thread_id);
+    const bool known = found != threads_.end() && found->second.name == name;
+    ThreadState& state = threads_[thread_id];
+    ThreadActivity& activity = state.activity;
+    activity.thread_id = thread_id;
+    activity.name = name;
+    activity.cpu_us = static_cast<int64_t>(cpu_ns / 1000);
+    activity.cpu_delta_us =
+        known && cpu_ns > state.cpu_ns
+            ? static_cast<int64_t>((cpu_ns - state.cpu_ns) / 1000)
+            : 0;
+    activity.wakeups_delta =
+        known && voluntary > state.voluntary ? voluntary - state.voluntary
+                                             : 0;
+    state.name = name;
+    state.cpu_ns = cpu_ns;
+    state.voluntary = voluntary;
+    state.involuntary = involuntary;
+    state.seen = samples_taken_;
+
+    sample->voluntary_switches += voluntary;
+    sample->involuntary_switches += involuntary;
+  });
+
+  std::vector<ThreadActivity> latest;
+  for (auto it = threads_.begin(); it != threads_.end();) {
+    if (it->second.seen != samples_taken_) {
+      it = threads_.erase(it);
+    } else {
+      latest.push_back(it->second.activity);
+      ++it;
+    }
+  }
+  std::sort(latest.begin(), latest.end(),
+            [](const ThreadActivity& a, const ThreadActivity& b) {
+              return a.cpu_delta_us != b.cpu_delta_us
+                         ? a.cpu_delta_us > b.cpu_delta_us
+                         : a.cpu_us > b.cpu_us;
+            });
+  std::lock_guard<std::mutex> lock(mutex_);
+  latest_threads_ = std::move(latest);
+}
+
+std::vector<ProcessSample> ProcessTelemetry::Window() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<ProcessSample> window;
+  window.reserve(count_);
+  const size_t first = (next_ + ring_.size() - count_) % ring_.size();
+  for (size_t i = 0; i < count_; i++) {
+    window.push_back(ring_[(first + i) % ring_.size()]);
+  }
+  return window;
+}
+
+std::vector<ThreadActivity> ProcessTelemetry::Threads() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return latest_threads_;
+}
+
+std::string ProcessTelemetry::ToJson() const {
+  const std::vector<ProcessSample> window = Window();
+  const std::vector<ThreadActivity> threads = Threads();
+  char buffer[512];
+  snprintf(buffer, sizeof(buffer), "{\"window_size\":%zu,\"samples\":[",
+           ring_.size());
+  std::string out = buffer;
+  for (size_t i = 0; i < window.size(); i++) {
+    const ProcessSample& s = window[i];
+    snprintf(buffer, sizeof(buffer),
+             "%s{\"time_us\":%" PRId64 ",\"rss_bytes\":%" PRIu64
+             ",\"pss_bytes\":%" PRIu64 ",\"cpu_user_us\":%" PRId64
+             ",\"cpu_system_us\":%" PRId64 ",\"voluntary_switches\":%" PRIu64
+             ",\"involuntary_switches\":%" PRIu64 ",\"read_bytes\":%" PRIu64
+             ",\"write_bytes\":%" PRIu64 ",\"fds\":%u,\"threads\":%u}",
+             i > 0 ? "," : "", s.time_us, s.rss_bytes, s.pss_bytes,
+             s.cpu_user_us, s.cpu_system_us, s.voluntary_switches,
+             s.involuntary_switches, s.read_bytes, s.write_bytes, s.fds,
+             s.threads);
+    out.append(buffer);
+  }
+  out.append("],\"threads\":[");
+  for (size_t i = 0; i < threads.size(); i++) {
+    const ThreadActivity& t = threads[i];
+    snprintf(buffer, sizeof(buffer), "%s{\"thread_id\":%u,\"name\":\"",
+             i > 0 ? "," : "", t.thread_id);
+    out.append(buffer);
+    AppendEscaped(&out, t.name);
+    snprintf(buffer, sizeof(buffer),
+             "\",\"cpu_us\":%" PRId64 ",\"cpu_delta_us\":%" PRId64
+             ",\"wakeups_delta\":%" PRIu64 "}",
+             t.cpu_us, t.cpu_delta_us, t.wakeups_delta);
+    out.append(buffer);
+  }
+  out.append("]}");
+  return out;
+}
+
+void ProcessTelemetry::LogSummary() const {
+  const std::vector<ProcessSample> window = Window();
+  if (window.size() < 2) {
+    return;
+  }
+  const ProcessSample& first = window.front();
+  const ProcessSample& last = window.back();
+  const double seconds = (last.time_us - first.time_us) / 1e6;
+  const int64_t cpu_us = (last.cpu_user_us + last.cpu_system_us) -
+                         (first.cpu_user_us + first.cpu_system_us);
+  uint64_t rss_max = 0;
+  for (const ProcessSample& sample : window) {
+    rss_max = std::max(rss_max, sample.rss_bytes);
+  }
+  SS_LOG(LogLevel::kInfo, "telemetry",
+         "over {} s: cpu {}%, {} wakeups/s, {} preemptions/s, rss {} bytes "
+         "(max {}), pss {} bytes, disk read {} B/s write {} B/s, {} fds, "
+         "{} threads",
+         seconds, seconds > 0 ? cpu_us / seconds / 1e4 : 0.0,
+         Rate(first.voluntary_switches, last.voluntary_switches, seconds),
+         Rate(first.involuntary_switches, last.involuntary_switches,
+              seconds),
+         last.rss_bytes, rss_max, last.pss_bytes,
+         Rate(first.read_bytes, last.read_bytes, seconds),
+         Rate(first.write_bytes, last.write_bytes, seconds),
+         static_cast<uint64_t>(last.fds), static_cast<uint64_t>(last.threads));
+
+  const std::vector<ThreadActivity> threads = Threads();
+  for (size_t i = 0; i < threads.size() && i < 3; i++) {
+    SS_LOG(LogLevel::kInfo, "telemetry",
+           "thread {} ({}): {} us cpu, {} wakeups in the last interval",
+           threads[i].name, static_cast<uint64_t>(threads[i].thread_id),
+           threads[i].cpu_delta_us, threads[i].wakeups_delta);
+  }
+}
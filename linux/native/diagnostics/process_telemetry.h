@@ -0,0 +1,125 @@
+#ifndef NATIVE_DIAGNOSTICS_PROCESS_TELEMETRY_H_
+#define NATIVE_DIAGNOSTICS_PROCESS_TELEMETRY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// One look at the whole process. Counters are totals since the process
+// started; rates come from the difference between two samples.
+struct ProcessSample {
+  int64_t time_us = 0;  // CLOCK_MONOTONIC.
+  uint64_t rss_bytes = 0;
+  // Proportional set size, from the most recent smaps_rollup read (see
+  // ProcessTelemetryOptions::pss_every); 0 until the first.
+  uint64_t pss_bytes = 0;
+  int64_t cpu_user_us = 0;
+  int64_t cpu_system_us = 0;
+  // Summed over the threads alive at the time. A voluntary switch is a
+  // thread going to sleep, so it counts the wakeups that follow.
+  uint64_t voluntary_switches = 0;
+  uint64_t involuntary_switches = 0;
+  // Bytes that reached or came from storage, not the page cache.
+  uint64_t read_bytes = 0;
+  uint64_t write_bytes = 0;
+  uint32_t fds = 0;
+  uint32_t threads = 0;
+};
+
+// One thread, over the interval between the last two samples.
+struct ThreadActivity {
+  uint32_t thread_id = 0;
+  std::string name;
+  int64_t cpu_us = 0;  // Since the thread started.
+  int64_t cpu_delta_us = 0;
+  uint64_t wakeups_delta = 0;
+};
+
+struct ProcessTelemetryOptions {
+  // Samples kept; at the runner's rate of one per 10 s, an hour.
+  size_t window = 360;
+  // smaps_rollup makes the kernel walk every mapping, so PSS is only read
+  // every this many samples.
+  uint32_t pss_every = 6;
+  // Where to read from; tests point it at a fake tree.
+  std::string proc_self = "/proc/self";
+};
+
+// Parsers for the /proc files a sample is built from, on their contents.
+// Tick and page sizes come from the caller.
+bool ParseProcStat(const std::string& text, int64_t ticks_per_second,
+                   uint64_t page_size, ProcessSample* out);
+bool ParseProcIo(const std::string& text, ProcessSample* out);
+bool ParseSmapsRollupPss(const std::string& text, uint64_t* pss_bytes);
+// Thread status: name and context switch counts.
+bool ParseThreadStatus(const std::string& text, std::string* name,
+                       uint64_t* voluntary, uint64_t* involuntary);
+// "<cpu ns> <wait ns> <timeslices>" from schedstat.
+bool ParseSchedstat(const std::string& text, uint64_t* cpu_ns);
+
+// Low-rate sampler of what the process costs the machine: memory, CPU per
+// thread, wakeups, file descriptors and disk I/O, kept as a rolling window
+// for the diagnostics channel and summarised into the log.
+//
+// Sample() reads a handful of small /proc files (and one status and
+// schedstat per thread) and takes well under a millisecond; call it from a
+// worker, not the platform thread. Everything else may run on any thread.
+class ProcessTelemetry {
+ public:
+  // The shared sampler. Never destroyed.
+  static ProcessTelemetry& Get();
+
+  explicit ProcessTelemetry(const ProcessTelemetryOptions& options);
+
+  ProcessTelemetry(const ProcessTelemetry&) = delete;
+  ProcessTelemetry& operator=(const ProcessTelemetry&) = delete;
+
+  // Takes a sample and adds it to the window. Returns false if the basic
+  // process files could not be read.
+  bool Sample();
+
+  // The window, oldest first.
+  std::vector<ProcessSample> Window() const;
+  // Threads seen in the last sample, busiest first.
+  std::vector<ThreadActivity> Threads() const;
+
+  // {"window_size":, "samples":[...], "threads":[...]}.
+  std::string ToJson() const;
+
+  // Logs rates over the window and the busiest threads.
+  void LogSummary() const;
+
+ private:
+  struct ThreadState {
+    std::string name;
+    uint64_t cpu_ns = 0;
+    uint64_t voluntary = 0;
+    uint64_t involuntary = 0;
+    ThreadActivity activity;
+    uint64_t seen = 0;  // Sample number.
+  };
+
+  void SampleThreads(ProcessSample* sample);
+
+  const ProcessTelemetryOptions options_;
+  const int64_t ticks_per_second_;
+  const uint64_t page_size_;
+
+  // Sample() state; one sampler at a time.
+  std::mutex sample_mutex_;
+  uint64_t samples_taken_ = 0;
+  uint64_t last_pss_bytes_ = 0;
+  std::map<uint32_t, ThreadState> threads_;
+
+  // What readers see.
+  mutable std::mutex mutex_;
+  std::vector<ProcessSample> ring_;
+  size_t next_ = 0;
+  size_t count_ = 0;
+  std::vector<ThreadActivity> latest_threads_;
+};
+
+#endif  // NATIVE_DIAGNOSTICS_PROCESS_TELEMETRY_H_
@@ -0,0 +1,73 @@
+#include "export/csv_writer.h"
+
+#include "export/row_format.h"
+
+CsvWriter::CsvWriter(const std::string& path) : path_(path) {}
+
+bool CsvWriter::Begin() {
+  if (!file_.Open(path_)) {
+    return false;
+  }
+  static const char kBom[] = "\xEF\xBB\xBF";
+  file_.Write(kBom, 3);
+  return file_.Write(
+      "Date,Project,Task,Description,Start,End,Duration,Hours\r\n");
+}
+
+void CsvWriter::AppendField(const std::string& value, bool last) {
+  bool needs_quotes = false;
+  for (char c : value) {
+    if (c == ',' || c == '"' || c == '\r' || c == '\n') {
+      needs_quotes = true;
+      break;
+    }
+  }
+  bool formula_like = !value.empty() && (value[0] == '=' || value[0] == '+' ||
+                                         value[0] == '-' || value[0] == '@');
+  if (needs_quotes) {
+    line_ += '"';
+  }
+  if (formula_like) {
+    line_ += '\'';
+  }
+  if (needs_quotes) {
+    for (char c : value) {
+      if (c == '"') {
+        line_ += '"';
+      }
+      line_ += c;
+    }
+    line_ += '"';
+  } else {
+    line_ += value;
+  }
+  line_ += last ? "\r\n" : ",";
+}
+
+bool CsvWriter::WriteRow(const ExportRow& row) {
+  line_.clear();
+  AppendField(row.date, false);
+  AppendField(row.project, false);
+  AppendField(row.title, false);
+  AppendField(row.description, false);
+  AppendField(FormatClockTime(row.started_at_ms), false);
+  AppendField(FormatClockTime(row.ended_at_ms), false);
+  AppendField(FormatDurationLabel(row.duration_seconds), false);
+  AppendField(FormatHours(row.duration_seconds), true);
+  total_seconds_ += row.duration_seconds;
+  return file_.Write(line_);
+}
+
+bool CsvWriter::Finish() {
+  line_ = "Total,,,,,,";
+  line_ += FormatDurationLabel(total_seconds_);
+  line_ += ',';
+  line_ += FormatHours(total_seconds_);
+  line_ += "\r\n";
+  file_.Write(line_);
+  return file_.Commit();
+}
+
+void CsvWriter::Abort() {
+  file_.Abort();
+}
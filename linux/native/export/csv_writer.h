@@ -0,0 +1,31 @@
+#ifndef NATIVE_EXPORT_CSV_WRITER_H_
+#define NATIVE_EXPORT_CSV_WRITER_H_
+
+#include <string>
+
+#include "common/buffered_file.h"
+#include "export/report_writer.h"
+
+// RFC 4180 CSV with a UTF-8 byte order mark so Excel picks the right
+// encoding. Cells that a spreadsheet would evaluate as formulas are prefixed
+// with an apostrophe.
+class CsvWriter : public ReportWriter {
+ public:
+  explicit CsvWriter(const std::string& path);
+
+  bool Begin() override;
+  bool WriteRow(const ExportRow& row) override;
+  bool Finish() override;
+  void Abort() override;
+  uint64_t bytes_written() const override { return file_.offset(); }
+
+ private:
+  void AppendField(const std::string& value, bool last);
+
+  std::string path_;
+  BufferedFile file_;
+  std::string line_;
+  int64_t total_seconds_ = 0;
+};
+
+#endif  // NATIVE_EXPORT_CSV_WRITER_H_
@@ -0,0 +1,101 @@
+#include "export/export_api.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "export/export_job.h"
+
+namespace {
+
+// Rows waiting for the worker. At a few hundred bytes per row this caps the
+// queue at well under a megabyte.
+constexpr size_t kQueueCapacity = 2048;
+
+std::string FromC(const char* value) {
+  return value ? std::string(value) : std::string();
+}
+
+}  // namespace
+
+struct SsExportJob {
+  std::unique_ptr<ExportJob> job;
+};
+
+SsExportJob* ss_export_open(const char* path, int32_t format,
+                            const char* title, int64_t total_rows) {
+  if (path == nullptr || format < 0 ||
+      format > static_cast<int32_t>(ExportFormat::kPdf)) {
+    return nullptr;
+  }
+  auto writer = CreateReportWriter(static_cast<ExportFormat>(format), path,
+                                   FromC(title));
+  auto job = std::make_unique<ExportJob>(std::move(writer), kQueueCapacity,
+                                         total_rows);
+  if (!job->Start()) {
+    return nullptr;
+  }
+  return new SsExportJob{std::move(job)};
+}
+
+int32_t ss_export_add_rows(SsExportJob* job, const SsExportRow* rows,
+                           int32_t count) {
+  if (job == nullptr || rows == nullptr) {
+    return 0;
+  }
+  int32_t accepted = 0;
+  for (; accepted < count; accepted++) {
+    const SsExportRow& in = rows[accepted];
+    ExportRow row;
+    row.date = FromC(in.date);
+    row.project = FromC(in.project);
+    row.title = FromC(in.title);
+    row.description = FromC(in.description);
+    row.started_at_ms = in.started_at_ms;
+    row.ended_at_ms = in.ended_at_ms;
+    row.duration_seconds = in.duration_seconds;
+    if (!job->job->Push(std::move(row))) {
+      break;
+    }
+  }
+  return accepted;
+}
+
+void ss_export_finish(SsExportJob* job) {
+  if (job != nullptr) {
+    job->job->FinishInput();
+  }
+}
+
+void ss_export_cancel(SsExportJob* job) {
+  if (job != nullptr) {
+    job->job->Cancel();
+  }
+}
+
+void ss_export_get_progress(SsExportJob* job, SsExportProgress* out) {
+  if (job == nullptr || out == nullptr) {
+    return;
+  }
+  ExportProgress progress = job->job->progress();
+  out->state = static_cast<int32_t>(progress.state);
+  out->rows_written = progress.rows_written;
+  out->total_rows = progress.total_rows;
+  out->bytes_written = progress.bytes_written;
+}
+
+int32_t ss_export_get_error(SsExportJob* job, char* buffer, int32_t size) {
+  if (job == nullptr) {
+    return 0;
+  }
+  std::string error = job->job->error();
+  if (buffer != nullptr && size > 0) {
+    size_t copied = std::min(error.size(), static_cast<size_t>(size - 1));
+    std::memcpy(buffer, error.data(), copied);
+    buffer[copied] = '\0';
+  }
+  return static_cast<int32_t>(error.size());
+}
+
+void ss_export_close(SsExportJob* job) {
+  delete job;
+}
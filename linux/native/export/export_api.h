@@ -0,0 +1,64 @@
+#ifndef NATIVE_EXPORT_EXPORT_API_H_
+#define NATIVE_EXPORT_EXPORT_API_H_
+
+#include <stdint.h>
+
+#include "common/native_export.h"
+
+// C interface for lib/native/report_export_bindings.dart.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SsExportJob SsExportJob;
+
+// Mirrors ExportRow. Strings are UTF-8 and only borrowed for the duration of
+// ss_export_add_rows().
+typedef struct {
+  const char* date;
+  const char* project;
+  const char* title;
+  const char* description;
+  int64_t started_at_ms;
+  int64_t ended_at_ms;
+  int64_t duration_seconds;
+} SsExportRow;
+
+typedef struct {
+  int32_t state;  // ExportState.
+  int64_t rows_written;
+  int64_t total_rows;
+  uint64_t bytes_written;
+} SsExportProgress;
+
+// Creates the output file; rows are formatted on the shared thread pool.
+// |format| is an ExportFormat value. Returns null if the file cannot be
+// created.
+SS_EXPORT SsExportJob* ss_export_open(const char* path, int32_t format,
+                                      const char* title, int64_t total_rows);
+
+// Copies |count| rows into the job's queue, blocking while it is full.
+// Returns the number of rows accepted.
+SS_EXPORT int32_t ss_export_add_rows(SsExportJob* job, const SsExportRow* rows,
+                                     int32_t count);
+
+// Marks the end of input. Completion is reported through the progress state.
+SS_EXPORT void ss_export_finish(SsExportJob* job);
+
+SS_EXPORT void ss_export_cancel(SsExportJob* job);
+
+SS_EXPORT void ss_export_get_progress(SsExportJob* job, SsExportProgress* out);
+
+// Copies the failure message into |buffer|. Returns its full length.
+SS_EXPORT int32_t ss_export_get_error(SsExportJob* job, char* buffer,
+                                      int32_t size);
+
+// Frees the job, cancelling it first if it is still running.
+SS_EXPORT void ss_export_close(SsExportJob* job);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // NATIVE_EXPORT_EXPORT_API_H_
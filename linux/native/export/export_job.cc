@@ -0,0 +1,160 @@
+#include "export/export_job.h"
+
+#include <vector>
+
+#include "logging/logger.h"
+#include "scheduler/thread_pool.h"
+#include "tracing/tracer.h"
+
+ExportJob::ExportJob(std::unique_ptr<ReportWriter> writer,
+                     size_t queue_capacity, int64_t total_rows)
+    : writer_(std::move(writer)),
+      queue_capacity_(queue_capacity > 0 ? queue_capacity : 1),
+      total_rows_(total_rows) {}
+
+ExportJob::~ExportJob() {
+  Cancel();
+  Wait();
+}
+
+bool ExportJob::Start() {
+  if (!writer_ || !writer_->Begin()) {
+    if (writer_) {
+      writer_->Abort();
+    }
+    Fail("Could not create the export file");
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  started_ = true;
+  return true;
+}
+
+bool ExportJob::Push(ExportRow&& row) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_full_.wait(lock, [this] {
+    return queue_.size() < queue_capacity_ || cancelled_ ||
+           state_.load() != static_cast<int>(ExportState::kRunning);
+  });
+  if (cancelled_ || input_finished_ ||
+      state_.load() != static_cast<int>(ExportState::kRunning)) {
+    return false;
+  }
+  queue_.push_back(std::move(row));
+  ScheduleDrainLocked();
+  return true;
+}
+
+void ExportJob::FinishInput() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  input_finished_ = true;
+  ScheduleDrainLocked();
+}
+
+void ExportJob::Cancel() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cancelled_ = true;
+  not_full_.notify_all();
+  ScheduleDrainLocked();
+}
+
+void ExportJob::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  drained_.wait(lock, [this] { return !draining_; });
+}
+
+void ExportJob::Fail(const std::string& message) {
+  SS_LOG(LogLevel::kError, "export", "Export failed: {}", message);
+  std::lock_guard<std::mutex> lock(mutex_);
+  error_ = message;
+  state_ = static_cast<int>(ExportState::kFailed);
+  not_full_.notify_all();
+}
+
+void ExportJob::ScheduleDrainLocked() {
+  if (!started_ || draining_ ||
+      state_.load() != static_cast<int>(ExportState::kRunning)) {
+    return;
+  }
+  draining_ = true;
+  // The user is watching the progress bar, so this is interactive work.
+  ThreadPool::Get().Submit(TaskPriority::kInteractive,
+                           [this](const CancellationToken&) { Drain(); });
+}
+
+void ExportJob::EndDrain() {
+  // Notified under the lock: once Wait() sees the flag clear it may destroy
+  // the job, and this task must not touch it after that.
+  std::lock_guard<std::mutex> lock(mutex_);
+  draining_ = false;
+  drained_.notify_all();
+}
+
+void ExportJob::Drain() {
+  std::vector<ExportRow> batch;
+  while (true) {
+    bool finished = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (cancelled_) {
+        break;
+      }
+      if (queue_.empty() && !input_finished_) {
+        // Caught up with the producer; the next Push() queues a new drain.
+        draining_ = false;
+        drained_.notify_all();
+        return;
+      }
+      // Take everything that is queued in one go so the producer is only
+      // woken once per batch instead of once per row.
+      batch.assign(std::make_move_iterator(queue_.begin()),
+                   std::make_move_iterator(queue_.end()));
+      queue_.clear();
+      finished = input_finished_;
+      not_full_.notify_all();
+    }
+
+    SS_TRACE_SCOPE("export", "write batch");
+    for (const ExportRow& row : batch) {
+      if (!writer_->WriteRow(row)) {
+        writer_->Abort();
+        Fail("Failed writing to the export file");
+        EndDrain();
+        return;
+      }
+      rows_written_.fetch_add(1, std::memory_order_relaxed);
+    }
+    bytes_written_.store(writer_->bytes_written(), std::memory_order_relaxed);
+    batch.clear();
+
+    if (finished) {
+      if (!writer_->Finish()) {
+        Fail("Failed to finalize the export file");
+      } else {
+        bytes_written_.store(writer_->bytes_written(),
+                             std::memory_order_relaxed);
+        state_ = static_cast<int>(ExportState::kDone);
+      }
+      EndDrain();
+      return;
+    }
+  }
+
+  writer_->Abort();
+  state_ = static_cast<int>(ExportState::kCancelled);
+  EndDrain();
+}
+
+ExportProgress ExportJob::progress() const {
+  ExportProgress progress;
+  progress.state = static_cast<ExportState>(state_.load());
+  progress.rows_written = rows_written_.load(std::memory_order_relaxed);
+  progress.total_rows = total_rows_;
+  progress.bytes_written = bytes_written_.load(std::memory_order_relaxed);
+  return progress;
+}
+
+std::string ExportJob::error() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return error_;
+}
@@ -0,0 +1,89 @@
+#ifndef NATIVE_EXPORT_EXPORT_JOB_H_
+#define NATIVE_EXPORT_EXPORT_JOB_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "export/report_writer.h"
+
+enum class ExportState {
+  kRunning = 0,
+  kDone = 1,
+  kFailed = 2,
+  kCancelled = 3,
+};
+
+struct ExportProgress {
+  ExportState state = ExportState::kRunning;
+  int64_t rows_written = 0;
+  int64_t total_rows = 0;  // Caller's hint; 0 when unknown.
+  uint64_t bytes_written = 0;
+};
+
+// Formats rows on the shared thread pool while the caller keeps feeding them.
+//
+// Rows pass through a bounded queue: Push() blocks once |queue_capacity| rows
+// are waiting, so a fast producer can never make the job buffer the whole
+// dataset. A pool task drains the queue whenever it has rows, so the job
+// holds no thread while it waits for the caller.
+class ExportJob {
+ public:
+  ExportJob(std::unique_ptr<ReportWriter> writer, size_t queue_capacity,
+            int64_t total_rows);
+  ~ExportJob();
+
+  ExportJob(const ExportJob&) = delete;
+  ExportJob& operator=(const ExportJob&) = delete;
+
+  // Opens the output. Returns false if the writer could not.
+  bool Start();
+
+  // Queues a row. Returns false once the job has failed or been cancelled.
+  bool Push(ExportRow&& row);
+
+  // Signals that no more rows follow; the job writes trailers and commits
+  // the file.
+  void FinishInput();
+
+  // Stops writing and removes the partial output.
+  void Cancel();
+
+  // Blocks until no drain task is queued or running.
+  void Wait();
+
+  ExportProgress progress() const;
+  std::string error() const;
+
+ private:
+  // Queues a drain task unless one is already queued or running.
+  void ScheduleDrainLocked();
+  void Drain();
+  void EndDrain();
+  void Fail(const std::string& message);
+
+  std::unique_ptr<ReportWriter> writer_;
+  const size_t queue_capacity_;
+  const int64_t total_rows_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<ExportRow> queue_;
+  bool input_finished_ = false;
+  bool cancelled_ = false;
+  bool started_ = false;
+  bool draining_ = false;
+  std::condition_variable drained_;
+  std::string error_;
+
+  std::atomic<int> state_{static_cast<int>(ExportState::kRunning)};
+  std::atomic<int64_t> rows_written_{0};
+  std::atomic<uint64_t> bytes_written_{0};
+};
+
+#endif  // NATIVE_EXPORT_EXPORT_JOB_H_
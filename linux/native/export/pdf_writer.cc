@@ -0,0 +1,381 @@
+#include "export/pdf_writer.h"
+
+#include <zlib.h>
+
+#include <cstdio>
+#include <ctime>
+
+#include "export/row_format.h"
+
+namespace {
+
+// A4 landscape, in points.
+constexpr double kPageWidth = 842;
+constexpr double kPageHeight = 595;
+constexpr double kMargin = 36;
+constexpr double kFontSize = 8.5;
+constexpr double kRowHeight = 14;
+constexpr double kCellPadding = 3;
+
+// Fixed object ids; pages and content streams are allocated after these.
+constexpr int kCatalogId = 1;
+constexpr int kPagesId = 2;
+constexpr int kFontRegularId = 3;
+constexpr int kFontBoldId = 4;
+
+struct Column {
+  const char* title;
+  double x;
+  double width;
+};
+
+const Column kColumns[] = {
+    {"Date", kMargin, 62},        {"Project", kMargin + 62, 130},
+    {"Task", kMargin + 192, 170}, {"Description", kMargin + 362, 282},
+    {"Start", kMargin + 644, 40}, {"End", kMargin + 684, 40},
+    {"Hours", kMargin + 724, 46},
+};
+constexpr int kHoursColumn = 6;
+
+// Helvetica advance widths for 0x20..0x7E in 1/1000 em (from the AFM).
+const uint16_t kHelveticaWidths[95] = {
+    278, 278, 355, 556, 556, 889, 667, 191, 333, 333, 389, 584, 278, 333,
+    278, 278, 556, 556, 556, 556, 556, 556, 556, 556, 556, 556, 278, 278,
+    584, 584, 584, 556, 1015, 667, 667, 722, 722, 667, 611, 778, 722, 278,
+    500, 667, 556, 833, 722, 778, 667, 778, 722, 667, 611, 722, 667, 944,
+    667, 667, 611, 278, 278, 278, 469, 556, 333, 556, 556, 500, 556, 556,
+    278, 556, 556, 222, 222, 500, 222, 833, 556, 556, 556, 556, 333, 500,
+    278, 556, 500, 722, 500, 500, 500, 334, 260, 334, 584,
+};
+
+double GlyphWidth(unsigned char c, bool bold) {
+  double width = (c >= 0x20 && c <= 0x7E) ? kHelveticaWidths[c - 0x20] : 556;
+  // Helvetica-Bold runs about 5% wider; close enough for truncation.
+  return width * (bold ? 1.05 : 1.0) * kFontSize / 1000.0;
+}
+
+// Converts UTF-8 to the WinAnsi encoding used by the standard fonts. Code
+// points that WinAnsi cannot represent become '?'.
+std::string ToWinAnsi(const std::string& utf8) {
+  std::string out;
+  out.reserve(utf8.size());
+  size_t i = 0;
+  while (i < utf8.size()) {
+    unsigned char lead = static_cast<unsigned char>(utf8[i]);
+    uint32_t code = 0;
+    size_t length = 1;
+    if (lead < 0x80) {
+      code = lead;
+    } else if ((lead & 0xE0) == 0xC0) {
+      code = lead & 0x1F;
+      length = 2;
+    } else if ((lead & 0xF0) == 0xE0) {
+      code = lead & 0x0F;
+      length = 3;
+    } else if ((lead & 0xF8) == 0xF0) {
+      code = lead & 0x07;
+      length = 4;
+    } else {
+      out += '?';
+      i++;
+      continue;
+    }
+    if (i + length > utf8.size()) {
+      out += '?';
+      break;
+    }
+    for (size_t k = 1; k < length; k++) {
+      code = (code << 6) | (static_cast<unsigned char>(utf8[i + k]) & 0x3F);
+    }
+    i += length;
+
+    if (code == '\n' || code == '\r' || code == '\t') {
+      out += ' ';
+    } else if (code < 0x20) {
+      continue;
+    } else if (code < 0x7F || (code >= 0xA0 && code <= 0xFF)) {
+      out += static_cast<char>(code);
+    } else {
+      switch (code) {
+        case 0x20AC: out += '\x80'; break;  // Euro sign.
+        case 0x2018: out += '\x91'; break;  // Left single quote.
+        case 0x2019: out += '\x92'; break;  // Right single quote.
+        case 0x201C: out += '\x93'; break;  // Left double quote.
+        case 0x201D: out += '\x94'; break;  // Right double quote.
+        case 0x2022: out += '\x95'; break;  // Bullet.
+        case 0x2013: out += '\x96'; break;  // En dash.
+        case 0x2014: out += '\x97'; break;  // Em dash.
+        case 0x2026: out += '\x85'; break;  // Ellipsis.
+        default: out += '?'; break;
+      }
+    }
+  }
+  return out;
+}
+
+void AppendPdfString(const std::string& text, std::string* out) {
+  *out += '(';
+  for (char c : text) {
+    if (c == '(' || c == ')' || c == '\\') {
+      *out += '\\';
+    }
+    *out += c;
+  }
+  *out += ')';
+}
+
+std::string Number(double value) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.2f", value);
+  return buffer;
+}
+
+}  // namespace
+
+PdfWriter::PdfWriter(const std::string& path, const std::string& title)
+    : path_(path), title_(title) {}
+
+int PdfWriter::AllocateObject() {
+  offsets_.push_back(0);
+  return static_cast<int>(offsets_.size()) - 1;
+}
+
+bool PdfWriter::BeginObject(int id) {
+  offsets_[id] = file_.offset();
+  return file_.Write(std::to_string(id) + " 0 obj\n");
+}
+
+bool PdfWriter::Begin() {
+  if (!file_.Open(path_)) {
+    return false;
+  }
+  offsets_.assign(kFontBoldId + 1, 0);
+  // The binary comment marks the file as 8-bit for transfer tools.
+  file_.Write("%PDF-1.4\n%\xE2\xE3\xCF\xD3\n");
+
+  BeginObject(kFontRegularId);
+  file_.Write(
+      "<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica "
+      "/Encoding /WinAnsiEncoding >>\nendobj\n");
+  BeginObject(kFontBoldId);
+  file_.Write(
+      "<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica-Bold "
+      "/Encoding /WinAnsiEncoding >>\nendobj\n");
+  StartPage();
+  return file_.ok();
+}
+
+void PdfWriter::DrawText(double x, double y, const std::string& text,
+                         bool bold, double max_width) {
+  std::string encoded = ToWinAnsi(text);
+  double width = 0;
+  size_t fit = 0;
+  const double ellipsis = GlyphWidth('.', bold) * 3;
+  for (; fit < encoded.size(); fit++) {
+    double glyph = GlyphWidth(static_cast<unsigned char>(encoded[fit]), bold);
+    if (width + glyph > max_width) {
+      break;
+    }
+    width += glyph;
+  }
+  if (fit < encoded.size()) {
+    // Back off until the ellipsis fits too.
+    while (fit > 0 && width + ellipsis > max_width) {
+      fit--;
+      width -= GlyphWidth(static_cast<unsigned char>(encoded[fit]), bold);
+    }
+    encoded.resize(fit);
+    encoded += "...";
+  }
+  if (encoded.empty()) {
+    return;
+  }
+  content_ += "BT /";
+  content_ += bold ? "F2 " : "F1 ";
+  content_ += Number(kFontSize) + " Tf " + Number(x) + " " + Number(y) +
+              " Td ";
+  AppendPdfString(encoded, &content_);
+  content_ += " Tj ET\n";
+}
+
+void PdfWriter::DrawRightAligned(double right, double y,
+                                 const std::string& text, bool bold) {
+  double width = 0;
+  for (char c : text) {
+    width += GlyphWidth(static_cast<unsigned char>(c), bold);
+  }
+  DrawText(right - width, y, text, bold, width + 1);
+}
+
+void PdfWriter::DrawRule(double y, double gray) {
+  content_ += Number(gray) + " G 0.5 w " + Number(kMargin) + " " + Number(y) +
+              " m " + Number(kPageWidth - kMargin) + " " + Number(y) +
+              " l S\n";
+}
+
+void PdfWriter::StartPage() {
+  content_.clear();
+  last_date_.clear();
+
+  double y = kPageHeight - kMargin - 12;
+  content_ += "BT /F2 14 Tf " + Number(kMargin) + " " + Number(y) + " Td ";
+  AppendPdfString(ToWinAnsi(title_), &content_);
+  content_ += " Tj ET\n";
+
+  // Header band.
+  y -= 26;
+  content_ += "0.92 g " + Number(kMargin) + " " + Number(y - 4) + " " +
+              Number(kPageWidth - 2 * kMargin) + " " + Number(kRowHeight) +
+              " re f 0 g\n";
+  for (int i = 0; i < 7; i++) {
+    const Column& column = kColumns[i];
+    if (i == kHoursColumn) {
+      DrawRightAligned(column.x + column.width - kCellPadding, y,
+                       column.title, true);
+    } else {
+      DrawText(column.x + kCellPadding, y, column.title, true,
+               column.width - 2 * kCellPadding);
+    }
+  }
+  cursor_y_ = y - kRowHeight;
+}
+
+bool PdfWriter::FlushPage() {
+  int page_number = static_cast<int>(page_ids_.size()) + 1;
+  content_ += "BT /F1 8 Tf " + Number(kPageWidth - kMargin - 40) + " " +
+              Number(kMargin - 14) + " Td (Page " +
+              std::to_string(page_number) + ") Tj ET\n";
+
+  uLongf compressed_size = compressBound(content_.size());
+  std::string compressed(compressed_size, '\0');
+  if (compress2(reinterpret_cast<Bytef*>(&compressed[0]), &compressed_size,
+                reinterpret_cast<const Bytef*>(content_.data()),
+                content_.size(), Z_DEFAULT_COMPRESSION) != Z_OK) {
+    return false;
+  }
+  compressed.resize(compressed_size);
+
+  int content_id = AllocateObject();
+  BeginObject(content_id);
+  file_.Write("<< /Length " + std::to_string(compressed.size()) +
+              " /Filter /FlateDecode >>\nstream\n");
+  file_.Write(compressed);
+  file_.Write("\nendstream\nendobj\n");
+
+  int page_id = AllocateObject();
+  BeginObject(page_id);
+  file_.Write("<< /Type /Page /Parent " + std::to_string(kPagesId) +
+              " 0 R /MediaBox [0 0 " + Number(kPageWidth) + " " +
+              Number(kPageHeight) + "] /Contents " +
+              std::to_string(content_id) +
+              " 0 R /Resources << /Font << /F1 " +
+              std::to_string(kFontRegularId) + " 0 R /F2 " +
+              std::to_string(kFontBoldId) + " 0 R >> >> >>\nendobj\n");
+  page_ids_.push_back(page_id);
+  content_.clear();
+  return file_.ok();
+}
+
+bool PdfWriter::WriteRow(const ExportRow& row) {
+  if (cursor_y_ < kMargin + kRowHeight) {
+    if (!FlushPage()) {
+      return false;
+    }
+    StartPage();
+  }
+  // Show each date once per run of rows, like the grouped report cards.
+  if (row.date != last_date_) {
+    if (!last_date_.empty()) {
+      DrawRule(cursor_y_ + kRowHeight - 3, 0.8);
+    }
+    DrawText(kColumns[0].x + kCellPadding, cursor_y_, row.date, true,
+             kColumns[0].width - 2 * kCellPadding);
+    last_date_ = row.date;
+  }
+  const std::string* texts[] = {&row.project, &row.title, &row.description};
+  for (int i = 0; i < 3; i++) {
+    const Column& column = kColumns[i + 1];
+    DrawText(column.x + kCellPadding, cursor_y_, *texts[i], false,
+             column.width - 2 * kCellPadding);
+  }
+  DrawText(kColumns[4].x + kCellPadding, cursor_y_,
+           FormatClockTime(row.started_at_ms), false, kColumns[4].width);
+  DrawText(kColumns[5].x + kCellPadding, cursor_y_,
+           FormatClockTime(row.ended_at_ms), false, kColumns[5].width);
+  const Column& hours = kColumns[kHoursColumn];
+  DrawRightAligned(hours.x + hours.width - kCellPadding, cursor_y_,
+                   FormatHours(row.duration_seconds), false);
+
+  cursor_y_ -= kRowHeight;
+  total_seconds_ += row.duration_seconds;
+  row_count_++;
+  return file_.ok();
+}
+
+bool PdfWriter::Finish() {
+  if (cursor_y_ < kMargin + kRowHeight) {
+    if (!FlushPage()) {
+      Abort();
+      return false;
+    }
+    StartPage();
+  }
+  DrawRule(cursor_y_ + kRowHeight - 3, 0.3);
+  DrawText(kColumns[0].x + kCellPadding, cursor_y_,
+           "Total (" + std::to_string(row_count_) + " tasks)", true, 200);
+  const Column& hours = kColumns[kHoursColumn];
+  DrawRightAligned(hours.x + hours.width - kCellPadding, cursor_y_,
+                   FormatHours(total_seconds_), true);
+  if (!FlushPage()) {
+    Abort();
+    return false;
+  }
+
+  BeginObject(kPagesId);
+  std::string kids;
+  for (int id : page_ids_) {
+    kids += std::to_string(id) + " 0 R ";
+  }
+  file_.Write("<< /Type /Pages /Kids [" + kids + "] /Count " +
+              std::to_string(page_ids_.size()) + " >>\nendobj\n");
+
+  time_t now = time(nullptr);
+  struct tm local;
+  localtime_r(&now, &local);
+  char created[32];
+  strftime(created, sizeof(created), "D:%Y%m%d%H%M%S", &local);
+
+  BeginObject(kCatalogId);
+  file_.Write("<< /Type /Catalog /Pages " + std::to_string(kPagesId) +
+              " 0 R >>\nendobj\n");
+  int info_id = AllocateObject();
+  BeginObject(info_id);
+  std::string info = "<< /Title ";
+  AppendPdfString(ToWinAnsi(title_), &info);
+  info += " /Producer (Silver Stone) /CreationDate (" + std::string(created) +
+          ") >>\nendobj\n";
+  file_.Write(info);
+
+  uint64_t xref_offset = file_.offset();
+  std::string xref = "xref\n0 " + std::to_string(offsets_.size()) +
+                     "\n0000000000 65535 f \n";
+  char entry[24];
+  for (size_t id = 1; id < offsets_.size(); id++) {
+    snprintf(entry, sizeof(entry), "%010llu 00000 n \n",
+             static_cast<unsigned long long>(offsets_[id]));
+    xref += entry;
+  }
+  xref += "trailer\n<< /Size " + std::to_string(offsets_.size()) +
+          " /Root " + std::to_string(kCatalogId) + " 0 R /Info " +
+          std::to_string(info_id) + " 0 R >>\nstartxref\n" +
+          std::to_string(xref_offset) + "\n%%EOF\n";
+  if (!file_.Write(xref)) {
+    Abort();
+    return false;
+  }
+  return file_.Commit();
+}
+
+void PdfWriter::Abort() {
+  file_.Abort();
+}
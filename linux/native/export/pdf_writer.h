@@ -0,0 +1,49 @@
+#ifndef NATIVE_EXPORT_PDF_WRITER_H_
+#define NATIVE_EXPORT_PDF_WRITER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/buffered_file.h"
+#include "export/report_writer.h"
+
+// Timesheet table rendered straight to PDF operators.
+//
+// Uses the standard Helvetica fonts, so nothing is embedded, and emits each
+// page as soon as it is full. Only the current page's content stream and the
+// object offset table are kept in memory.
+class PdfWriter : public ReportWriter {
+ public:
+  PdfWriter(const std::string& path, const std::string& title);
+
+  bool Begin() override;
+  bool WriteRow(const ExportRow& row) override;
+  bool Finish() override;
+  void Abort() override;
+  uint64_t bytes_written() const override { return file_.offset(); }
+
+ private:
+  int AllocateObject();
+  bool BeginObject(int id);
+  void StartPage();
+  bool FlushPage();
+  void DrawText(double x, double y, const std::string& text, bool bold,
+                double max_width);
+  void DrawRightAligned(double right, double y, const std::string& text,
+                        bool bold);
+  void DrawRule(double y, double gray);
+
+  std::string path_;
+  std::string title_;
+  BufferedFile file_;
+  std::vector<uint64_t> offsets_;  // Indexed by object id; 0 is unused.
+  std::vector<int> page_ids_;
+  std::string content_;
+  double cursor_y_ = 0;
+  std::string last_date_;
+  int64_t total_seconds_ = 0;
+  int64_t row_count_ = 0;
+};
+
+#endif  // NATIVE_EXPORT_PDF_WRITER_H_
@@ -0,0 +1,19 @@
+#include "export/report_writer.h"
+
+#include "export/csv_writer.h"
+#include "export/pdf_writer.h"
+#include "export/xlsx_writer.h"
+
+std::unique_ptr<ReportWriter> CreateReportWriter(ExportFormat format,
+                                                 const std::string& path,
+                                                 const std::string& title) {
+  switch (format) {
+    case ExportFormat::kCsv:
+      return std::make_unique<CsvWriter>(path);
+    case ExportFormat::kXlsx:
+      return std::make_unique<XlsxWriter>(path, title);
+    case ExportFormat::kPdf:
+      return std::make_unique<PdfWriter>(path, title);
+  }
+  return nullptr;
+}
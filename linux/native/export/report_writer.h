@@ -0,0 +1,53 @@
+#ifndef NATIVE_EXPORT_REPORT_WRITER_H_
+#define NATIVE_EXPORT_REPORT_WRITER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// One exported line: a task from a daily report with its time entry.
+struct ExportRow {
+  std::string date;         // Report date, YYYY-MM-DD.
+  std::string project;
+  std::string title;
+  std::string description;
+  int64_t started_at_ms = 0;  // Epoch milliseconds, 0 when unknown.
+  int64_t ended_at_ms = 0;
+  int64_t duration_seconds = 0;
+};
+
+enum class ExportFormat {
+  kCsv = 0,
+  kXlsx = 1,
+  kPdf = 2,
+};
+
+// Streaming sink for exported rows. Implementations write each row as it
+// arrives and keep at most a bounded amount of state (one PDF page, one
+// deflate window), never the whole dataset.
+class ReportWriter {
+ public:
+  virtual ~ReportWriter() = default;
+
+  // Writes the document preamble. Returns false on I/O failure.
+  virtual bool Begin() = 0;
+
+  virtual bool WriteRow(const ExportRow& row) = 0;
+
+  // Writes totals and trailers and moves the file into place.
+  virtual bool Finish() = 0;
+
+  // Discards the partially written file.
+  virtual void Abort() = 0;
+
+  // Bytes produced so far (compressed bytes for XLSX and PDF).
+  virtual uint64_t bytes_written() const = 0;
+};
+
+// Creates a writer for |format| that targets |path|. |title| is used for the
+// sheet name and the PDF heading.
+std::unique_ptr<ReportWriter> CreateReportWriter(ExportFormat format,
+                                                 const std::string& path,
+                                                 const std::string& title);
+
+#endif  // NATIVE_EXPORT_REPORT_WRITER_H_
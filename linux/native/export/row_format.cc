@@ -0,0 +1,47 @@
+#include "export/row_format.h"
+
+#include <cstdio>
+#include <ctime>
+
+std::string FormatClockTime(int64_t epoch_ms) {
+  if (epoch_ms <= 0) {
+    return std::string();
+  }
+  time_t seconds = static_cast<time_t>(epoch_ms / 1000);
+  struct tm local;
+  if (localtime_r(&seconds, &local) == nullptr) {
+    return std::string();
+  }
+  char buffer[8];
+  snprintf(buffer, sizeof(buffer), "%02d:%02d", local.tm_hour, local.tm_min);
+  return buffer;
+}
+
+std::string FormatHours(int64_t seconds) {
+  if (seconds < 0) {
+    seconds = 0;
+  }
+  // Round to the nearest hundredth of an hour without going through double.
+  int64_t hundredths = (seconds * 100 + 1800) / 3600;
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%lld.%02lld",
+           static_cast<long long>(hundredths / 100),
+           static_cast<long long>(hundredths % 100));
+  return buffer;
+}
+
+std::string FormatDurationLabel(int64_t seconds) {
+  if (seconds <= 0) {
+    return std::string();
+  }
+  int64_t hours = seconds / 3600;
+  int64_t minutes = (seconds % 3600) / 60;
+  char buffer[32];
+  if (hours > 0) {
+    snprintf(buffer, sizeof(buffer), "%lldh %02lldm",
+             static_cast<long long>(hours), static_cast<long long>(minutes));
+  } else {
+    snprintf(buffer, sizeof(buffer), "%lldm", static_cast<long long>(minutes));
+  }
+  return buffer;
+}
@@ -0,0 +1,16 @@
+#ifndef NATIVE_EXPORT_ROW_FORMAT_H_
+#define NATIVE_EXPORT_ROW_FORMAT_H_
+
+#include <cstdint>
+#include <string>
+
+// Formats epoch milliseconds as local "HH:MM". Returns an empty string for 0.
+std::string FormatClockTime(int64_t epoch_ms);
+
+// Formats a duration as decimal hours with two places, e.g. "1.75".
+std::string FormatHours(int64_t seconds);
+
+// Formats a duration as "3h 05m" the way the reports screen shows it.
+std::string FormatDurationLabel(int64_t seconds);
+
+#endif  // NATIVE_EXPORT_ROW_FORMAT_H_
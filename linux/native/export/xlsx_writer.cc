@@ -0,0 +1,224 @@
+#include "export/xlsx_writer.h"
+
+#include "export/row_format.h"
+#include "export/xml_escape.h"
+
+namespace {
+
+// Cell style indexes into cellXfs below.
+constexpr int kStyleDefault = 0;
+constexpr int kStyleHeader = 1;
+constexpr int kStyleHours = 2;
+constexpr int kStyleTotal = 3;
+
+const char kContentTypes[] =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/"
+    "content-types\">"
+    "<Default Extension=\"rels\" ContentType=\"application/"
+    "vnd.openxmlformats-package.relationships+xml\"/>"
+    "<Default Extension=\"xml\" ContentType=\"application/xml\"/>"
+    "<Override PartName=\"/xl/workbook.xml\" ContentType=\"application/"
+    "vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml\"/>"
+    "<Override PartName=\"/xl/worksheets/sheet1.xml\" ContentType="
+    "\"application/"
+    "vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>"
+    "<Override PartName=\"/xl/styles.xml\" ContentType=\"application/"
+    "vnd.openxmlformats-officedocument.spreadsheetml.styles+xml\"/>"
+    "</Types>";
+
+const char kRootRels[] =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/"
+    "relationships\">"
+    "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/"
+    "officeDocument/2006/relationships/officeDocument\" "
+    "Target=\"xl/workbook.xml\"/>"
+    "</Relationships>";
+
+const char kWorkbookRels[] =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/"
+    "relationships\">"
+    "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/"
+    "officeDocument/2006/relationships/worksheet\" "
+    "Target=\"worksheets/sheet1.xml\"/>"
+    "<Relationship Id=\"rId2\" Type=\"http://schemas.openxmlformats.org/"
+    "officeDocument/2006/relationships/styles\" Target=\"styles.xml\"/>"
+    "</Relationships>";
+
+const char kStyles[] =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<styleSheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/"
+    "2006/main\">"
+    "<fonts count=\"2\">"
+    "<font><sz val=\"11\"/><name val=\"Calibri\"/></font>"
+    "<font><b/><sz val=\"11\"/><name val=\"Calibri\"/></font>"
+    "</fonts>"
+    "<fills count=\"2\">"
+    "<fill><patternFill patternType=\"none\"/></fill>"
+    "<fill><patternFill patternType=\"gray125\"/></fill>"
+    "</fills>"
+    "<borders count=\"1\"><border><left/><right/><top/><bottom/><diagonal/>"
+    "</border></borders>"
+    "<cellStyleXfs count=\"1\"><xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" "
+    "borderId=\"0\"/></cellStyleXfs>"
+    "<cellXfs count=\"4\">"
+    "<xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\"/>"
+    "<xf numFmtId=\"0\" fontId=\"1\" fillId=\"0\" borderId=\"0\" xfId=\"0\" "
+    "applyFont=\"1\"/>"
+    "<xf numFmtId=\"2\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\" "
+    "applyNumberFormat=\"1\"/>"
+    "<xf numFmtId=\"2\" fontId=\"1\" fillId=\"0\" borderId=\"0\" xfId=\"0\" "
+    "applyFont=\"1\" applyNumberFormat=\"1\"/>"
+    "</cellXfs>"
+    "</styleSheet>";
+
+const char kSheetHead[] =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/"
+    "2006/main\">"
+    "<sheetViews><sheetView workbookViewId=\"0\"><pane ySplit=\"1\" "
+    "topLeftCell=\"A2\" activePane=\"bottomLeft\" state=\"frozen\"/>"
+    "</sheetView></sheetViews>"
+    "<cols>"
+    "<col min=\"1\" max=\"1\" width=\"12\" customWidth=\"1\"/>"
+    "<col min=\"2\" max=\"2\" width=\"28\" customWidth=\"1\"/>"
+    "<col min=\"3\" max=\"3\" width=\"36\" customWidth=\"1\"/>"
+    "<col min=\"4\" max=\"4\" width=\"60\" customWidth=\"1\"/>"
+    "<col min=\"5\" max=\"6\" width=\"8\" customWidth=\"1\"/>"
+    "<col min=\"7\" max=\"7\" width=\"10\" customWidth=\"1\"/>"
+    "</cols>"
+    "<sheetData>";
+
+// Sheet names cannot contain []:*?/\ and are limited to 31 characters.
+std::string SanitizeSheetName(const std::string& title) {
+  std::string name;
+  for (char c : title) {
+    if (c == '[' || c == ']' || c == ':' || c == '*' || c == '?' ||
+        c == '/' || c == '\\') {
+      continue;
+    }
+    name += c;
+  }
+  if (name.size() > 31) {
+    // Trim without splitting a UTF-8 sequence.
+    size_t end = 31;
+    while (end > 0 && (static_cast<unsigned char>(name[end]) & 0xC0) == 0x80) {
+      --end;
+    }
+    name.resize(end);
+  }
+  return name.empty() ? "Timesheet" : name;
+}
+
+}  // namespace
+
+XlsxWriter::XlsxWriter(const std::string& path, const std::string& title)
+    : path_(path), title_(title) {}
+
+bool XlsxWriter::WritePart(const std::string& name,
+                           const std::string& content) {
+  return zip_.BeginEntry(name) && zip_.Write(content) && zip_.EndEntry();
+}
+
+bool XlsxWriter::Begin() {
+  if (!zip_.Open(path_)) {
+    return false;
+  }
+  std::string workbook =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+      "<workbook xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/"
+      "2006/main\" xmlns:r=\"http://schemas.openxmlformats.org/"
+      "officeDocument/2006/relationships\"><sheets><sheet name=\"";
+  AppendXmlEscaped(SanitizeSheetName(title_), &workbook);
+  workbook += "\" sheetId=\"1\" r:id=\"rId1\"/></sheets>"
+      // The totals row is a formula without a cached value.
+      "<calcPr fullCalcOnLoad=\"1\"/></workbook>";
+
+  bool ok = WritePart("[Content_Types].xml", kContentTypes) &&
+            WritePart("_rels/.rels", kRootRels) &&
+            WritePart("xl/workbook.xml", workbook) &&
+            WritePart("xl/_rels/workbook.xml.rels", kWorkbookRels) &&
+            WritePart("xl/styles.xml", kStyles) &&
+            zip_.BeginEntry("xl/worksheets/sheet1.xml") &&
+            zip_.Write(kSheetHead, sizeof(kSheetHead) - 1);
+  if (!ok) {
+    return false;
+  }
+
+  row_number_ = 1;
+  xml_ = "<row r=\"1\">";
+  const char* headers[] = {"Date", "Project", "Task", "Description",
+                           "Start", "End", "Hours"};
+  for (int i = 0; i < 7; i++) {
+    AppendTextCell(static_cast<char>('A' + i), headers[i], kStyleHeader);
+  }
+  xml_ += "</row>";
+  return zip_.Write(xml_);
+}
+
+void XlsxWriter::AppendTextCell(char column, const std::string& value,
+                                int style) {
+  if (value.empty()) {
+    return;
+  }
+  xml_ += "<c r=\"";
+  xml_ += column;
+  xml_ += std::to_string(row_number_);
+  xml_ += "\" t=\"inlineStr\"";
+  if (style != kStyleDefault) {
+    xml_ += " s=\"" + std::to_string(style) + "\"";
+  }
+  xml_ += "><is><t xml:space=\"preserve\">";
+  AppendXmlEscaped(value, &xml_);
+  xml_ += "</t></is></c>";
+}
+
+void XlsxWriter::AppendNumberCell(char column, const std::string& value,
+                                  int style) {
+  xml_ += "<c r=\"";
+  xml_ += column;
+  xml_ += std::to_string(row_number_);
+  xml_ += "\" s=\"" + std::to_string(style) + "\"><v>";
+  xml_ += value;
+  xml_ += "</v></c>";
+}
+
+bool XlsxWriter::WriteRow(const ExportRow& row) {
+  row_number_++;
+  xml_ = "<row r=\"" + std::to_string(row_number_) + "\">";
+  AppendTextCell('A', row.date, kStyleDefault);
+  AppendTextCell('B', row.project, kStyleDefault);
+  AppendTextCell('C', row.title, kStyleDefault);
+  AppendTextCell('D', row.description, kStyleDefault);
+  AppendTextCell('E', FormatClockTime(row.started_at_ms), kStyleDefault);
+  AppendTextCell('F', FormatClockTime(row.ended_at_ms), kStyleDefault);
+  AppendNumberCell('G', FormatHours(row.duration_seconds), kStyleHours);
+  xml_ += "</row>";
+  return zip_.Write(xml_);
+}
+
+bool XlsxWriter::Finish() {
+  int last_data_row = row_number_;
+  row_number_++;
+  xml_ = "<row r=\"" + std::to_string(row_number_) + "\">";
+  AppendTextCell('A', "Total", kStyleHeader);
+  xml_ += "<c r=\"G" + std::to_string(row_number_) + "\" s=\"" +
+          std::to_string(kStyleTotal) + "\">";
+  if (last_data_row > 1) {
+    xml_ += "<f>SUM(G2:G" + std::to_string(last_data_row) + ")</f>";
+  } else {
+    xml_ += "<v>0</v>";
+  }
+  xml_ += "</c></row></sheetData></worksheet>";
+  if (!zip_.Write(xml_)) {
+    zip_.Abort();
+    return false;
+  }
+  return zip_.Finish();
+}
+
+void XlsxWriter::Abort() {
+  zip_.Abort();
+}
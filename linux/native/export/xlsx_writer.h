@@ -0,0 +1,36 @@
+#ifndef NATIVE_EXPORT_XLSX_WRITER_H_
+#define NATIVE_EXPORT_XLSX_WRITER_H_
+
+#include <string>
+
+#include "export/report_writer.h"
+#include "export/zip_writer.h"
+
+// Single-sheet Office Open XML workbook.
+//
+// The package parts are tiny and written up front; the worksheet is streamed
+// row by row into the zip with inline strings, so there is no shared string
+// table to accumulate.
+class XlsxWriter : public ReportWriter {
+ public:
+  XlsxWriter(const std::string& path, const std::string& title);
+
+  bool Begin() override;
+  bool WriteRow(const ExportRow& row) override;
+  bool Finish() override;
+  void Abort() override;
+  uint64_t bytes_written() const override { return zip_.bytes_written(); }
+
+ private:
+  bool WritePart(const std::string& name, const std::string& content);
+  void AppendTextCell(char column, const std::string& value, int style);
+  void AppendNumberCell(char column, const std::string& value, int style);
+
+  std::string path_;
+  std::string title_;
+  ZipWriter zip_;
+  std::string xml_;
+  int row_number_ = 0;
+};
+
+#endif  // NATIVE_EXPORT_XLSX_WRITER_H_
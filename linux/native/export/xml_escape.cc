@@ -0,0 +1,30 @@
+#include "export/xml_escape.h"
+
+void AppendXmlEscaped(const std::string& text, std::string* out) {
+  for (char c : text) {
+    switch (c) {
+      case '&':
+        *out += "&amp;";
+        break;
+      case '<':
+        *out += "&lt;";
+        break;
+      case '>':
+        *out += "&gt;";
+        break;
+      case '"':
+        *out += "&quot;";
+        break;
+      case '\t':
+      case '\n':
+      case '\r':
+        *out += c;
+        break;
+      default:
+        if (static_cast<unsigned char>(c) >= 0x20) {
+          *out += c;
+        }
+        break;
+    }
+  }
+}
@@ -0,0 +1,10 @@
+#ifndef NATIVE_EXPORT_XML_ESCAPE_H_
+#define NATIVE_EXPORT_XML_ESCAPE_H_
+
+#include <string>
+
+// Appends |text| to |out| with XML special characters escaped. Control
+// characters that XML 1.0 cannot represent are dropped.
+void AppendXmlEscaped(const std::string& text, std::string* out);
+
+#endif  // NATIVE_EXPORT_XML_ESCAPE_H_
@@ -0,0 +1,191 @@
+#include "export/zip_writer.h"
+
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+constexpr uint32_t kLocalHeaderSignature = 0x04034b50;
+constexpr uint32_t kDataDescriptorSignature = 0x08074b50;
+constexpr uint32_t kCentralHeaderSignature = 0x02014b50;
+constexpr uint32_t kEndOfCentralSignature = 0x06054b50;
+constexpr uint16_t kVersion = 20;
+// Bit 3: sizes and CRC follow the data. Bit 11: names are UTF-8.
+constexpr uint16_t kFlags = (1 << 3) | (1 << 11);
+constexpr uint16_t kMethodDeflate = 8;
+
+void Put16(std::string* out, uint16_t value) {
+  out->push_back(static_cast<char>(value & 0xff));
+  out->push_back(static_cast<char>((value >> 8) & 0xff));
+}
+
+void Put32(std::string* out, uint32_t value) {
+  Put16(out, static_cast<uint16_t>(value & 0xffff));
+  Put16(out, static_cast<uint16_t>(value >> 16));
+}
+
+}  // namespace
+
+ZipWriter::ZipWriter() : out_buffer_(32 * 1024) {
+  std::memset(&stream_, 0, sizeof(stream_));
+}
+
+ZipWriter::~ZipWriter() {
+  if (stream_ready_) {
+    deflateEnd(&stream_);
+  }
+}
+
+bool ZipWriter::Open(const std::string& path) {
+  if (!file_.Open(path)) {
+    return false;
+  }
+  // A negative window size produces raw deflate data without zlib headers,
+  // which is what the zip format expects.
+  if (deflateInit2(&stream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    file_.Abort();
+    return false;
+  }
+  stream_ready_ = true;
+
+  time_t now = time(nullptr);
+  struct tm local;
+  localtime_r(&now, &local);
+  dos_time_ = static_cast<uint16_t>((local.tm_hour << 11) |
+                                    (local.tm_min << 5) | (local.tm_sec / 2));
+  dos_date_ = static_cast<uint16_t>(((local.tm_year - 80) << 9) |
+                                    ((local.tm_mon + 1) << 5) | local.tm_mday);
+  return true;
+}
+
+bool ZipWriter::BeginEntry(const std::string& name) {
+  if (in_entry_ && !EndEntry()) {
+    return false;
+  }
+  if (file_.offset() > UINT32_MAX) {
+    // Zip64 is not supported; a timesheet never gets near 4 GiB.
+    return false;
+  }
+  current_ = CentralRecord();
+  current_.name = name;
+  current_.crc = crc32(0L, Z_NULL, 0);
+  current_.local_header_offset = static_cast<uint32_t>(file_.offset());
+
+  std::string header;
+  Put32(&header, kLocalHeaderSignature);
+  Put16(&header, kVersion);
+  Put16(&header, kFlags);
+  Put16(&header, kMethodDeflate);
+  Put16(&header, dos_time_);
+  Put16(&header, dos_date_);
+  Put32(&header, 0);  // CRC, in the data descriptor.
+  Put32(&header, 0);  // Compressed size, in the data descriptor.
+  Put32(&header, 0);  // Uncompressed size, in the data descriptor.
+  Put16(&header, static_cast<uint16_t>(name.size()));
+  Put16(&header, 0);  // Extra field length.
+  header += name;
+
+  deflateReset(&stream_);
+  in_entry_ = true;
+  return file_.Write(header);
+}
+
+bool ZipWriter::Deflate(int flush) {
+  do {
+    stream_.next_out = out_buffer_.data();
+    stream_.avail_out = static_cast<uInt>(out_buffer_.size());
+    int status = deflate(&stream_, flush);
+    if (status == Z_STREAM_ERROR) {
+      return false;
+    }
+    size_t produced = out_buffer_.size() - stream_.avail_out;
+    if (produced > 0 && !file_.Write(out_buffer_.data(), produced)) {
+      return false;
+    }
+    current_.compressed_size += static_cast<uint32_t>(produced);
+  } while (stream_.avail_out == 0);
+  return true;
+}
+
+bool ZipWriter::Write(const void* data, size_t size) {
+  if (!in_entry_) {
+    return false;
+  }
+  const Bytef* bytes = static_cast<const Bytef*>(data);
+  current_.crc = crc32(current_.crc, bytes, static_cast<uInt>(size));
+  current_.uncompressed_size += static_cast<uint32_t>(size);
+  stream_.next_in = const_cast<Bytef*>(bytes);
+  stream_.avail_in = static_cast<uInt>(size);
+  return Deflate(Z_NO_FLUSH);
+}
+
+bool ZipWriter::EndEntry() {
+  if (!in_entry_) {
+    return true;
+  }
+  in_entry_ = false;
+  stream_.next_in = nullptr;
+  stream_.avail_in = 0;
+  if (!Deflate(Z_FINISH)) {
+    return false;
+  }
+
+  std::string descriptor;
+  Put32(&descriptor, kDataDescriptorSignature);
+  Put32(&descriptor, current_.crc);
+  Put32(&descriptor, current_.compressed_size);
+  Put32(&descriptor, current_.uncompressed_size);
+  records_.push_back(current_);
+  return file_.Write(descriptor);
+}
+
+bool ZipWriter::Finish() {
+  if (!EndEntry()) {
+    Abort();
+    return false;
+  }
+  uint64_t directory_offset = file_.offset();
+  std::string directory;
+  for (const CentralRecord& record : records_) {
+    Put32(&directory, kCentralHeaderSignature);
+    Put16(&directory, kVersion);  // Version made by.
+    Put16(&directory, kVersion);  // Version needed to extract.
+    Put16(&directory, kFlags);
+    Put16(&directory, kMethodDeflate);
+    Put16(&directory, dos_time_);
+    Put16(&directory, dos_date_);
+    Put32(&directory, record.crc);
+    Put32(&directory, record.compressed_size);
+    Put32(&directory, record.uncompressed_size);
+    Put16(&directory, static_cast<uint16_t>(record.name.size()));
+    Put16(&directory, 0);  // Extra field length.
+    Put16(&directory, 0);  // Comment length.
+    Put16(&directory, 0);  // Disk number.
+    Put16(&directory, 0);  // Internal attributes.
+    Put32(&directory, 0);  // External attributes.
+    Put32(&directory, record.local_header_offset);
+    directory += record.name;
+  }
+  uint64_t directory_size = directory.size();
+
+  Put32(&directory, kEndOfCentralSignature);
+  Put16(&directory, 0);  // This disk.
+  Put16(&directory, 0);  // Disk with the central directory.
+  Put16(&directory, static_cast<uint16_t>(records_.size()));
+  Put16(&directory, static_cast<uint16_t>(records_.size()));
+  Put32(&directory, static_cast<uint32_t>(directory_size));
+  Put32(&directory, static_cast<uint32_t>(directory_offset));
+  Put16(&directory, 0);  // Comment length.
+
+  if (!file_.Write(directory)) {
+    Abort();
+    return false;
+  }
+  return file_.Commit();
+}
+
+void ZipWriter::Abort() {
+  in_entry_ = false;
+  file_.Abort();
+}
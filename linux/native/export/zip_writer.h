@@ -0,0 +1,62 @@
+#ifndef NATIVE_EXPORT_ZIP_WRITER_H_
+#define NATIVE_EXPORT_ZIP_WRITER_H_
+
+#include <zlib.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/buffered_file.h"
+
+// Streaming zip archive writer.
+//
+// Entries are deflated as they are written and sized afterwards through data
+// descriptors, so neither the uncompressed nor the compressed entry is ever
+// held in memory. Only the central directory (one small record per entry) is
+// kept until Finish().
+class ZipWriter {
+ public:
+  ZipWriter();
+  ~ZipWriter();
+
+  ZipWriter(const ZipWriter&) = delete;
+  ZipWriter& operator=(const ZipWriter&) = delete;
+
+  bool Open(const std::string& path);
+
+  // Starts a new deflated entry, closing the current one if needed.
+  bool BeginEntry(const std::string& name);
+  bool Write(const void* data, size_t size);
+  bool Write(const std::string& data) { return Write(data.data(), data.size()); }
+  bool EndEntry();
+
+  // Writes the central directory and moves the archive into place.
+  bool Finish();
+  void Abort();
+
+  uint64_t bytes_written() const { return file_.offset(); }
+
+ private:
+  struct CentralRecord {
+    std::string name;
+    uint32_t crc = 0;
+    uint32_t compressed_size = 0;
+    uint32_t uncompressed_size = 0;
+    uint32_t local_header_offset = 0;
+  };
+
+  bool Deflate(int flush);
+
+  BufferedFile file_;
+  z_stream stream_;
+  bool stream_ready_ = false;
+  bool in_entry_ = false;
+  std::vector<unsigned char> out_buffer_;
+  std::vector<CentralRecord> records_;
+  CentralRecord current_;
+  uint16_t dos_time_ = 0;
+  uint16_t dos_date_ = 0;
+};
+
+#endif  // NATIVE_EXPORT_ZIP_WRITER_H_
@@ -0,0 +1,41 @@
+// libFuzzer target for the MP4 inspector and faststart rewriter. Build with
+// the "fuzz" preset and seed it with real recordings:
+//
+//   cmake --preset fuzz && cmake --build --preset fuzz
+//   build/fuzz/mp4_fuzzer -max_len=65536 corpus/ ~/recordings/
+//
+// Besides memory errors it checks that whatever the rewriter accepts comes
+// out as a valid faststart file.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "media/mp4_faststart.h"
+#include "media/mp4_inspector.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  Mp4Info info;
+  std::string error;
+  const bool valid = InspectMp4(data, size, &info, &error);
+
+  std::vector<uint8_t> output;
+  const FaststartResult result = FaststartMp4(
+      data, size,
+      [&output](const uint8_t* bytes, size_t count) {
+        output.insert(output.end(), bytes, bytes + count);
+        return true;
+      },
+      &error);
+  if (!valid && result != FaststartResult::kFailed) {
+    std::abort();
+  }
+  if (result == FaststartResult::kRewritten &&
+      (!InspectMp4(output.data(), output.size(), &info, &error) ||
+       !info.faststart)) {
+    std::abort();
+  }
+  return 0;
+}
@@ -0,0 +1,432 @@
+#include "ingest/file_ingest.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Large enough for the headers we read and for sequential throughput.
+constexpr size_t kBlockBytes = 256 * 1024;
+// How much of the first block decides between text and binary.
+constexpr size_t kTextSniffBytes = 4096;
+
+uint32_t Be16(const uint8_t* p) {
+  return (p[0] << 8) | p[1];
+}
+
+uint32_t Be32(const uint8_t* p) {
+  return (static_cast<uint32_t>(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) |
+         p[3];
+}
+
+uint32_t Le16(const uint8_t* p) {
+  return p[0] | (p[1] << 8);
+}
+
+uint32_t Le24(const uint8_t* p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16);
+}
+
+uint32_t Le32(const uint8_t* p) {
+  return Le24(p) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+bool StartsWith(const uint8_t* data, size_t size, const char* magic,
+                size_t offset = 0) {
+  const size_t length = strlen(magic);
+  return size >= offset + length && memcmp(data + offset, magic, length) == 0;
+}
+
+bool LooksLikeText(const uint8_t* data, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    const uint8_t c = data[i];
+    if (c < 0x20 && c != '\t' && c != '\n' && c != '\r' && c != '\f' &&
+        c != 0x1B) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ReadJpegSize(const uint8_t* data, size_t size, int32_t* width,
+                  int32_t* height) {
+  size_t pos = 2;
+  while (pos + 4 <= size) {
+    if (data[pos] != 0xFF) {
+      return false;
+    }
+    const uint8_t marker = data[pos + 1];
+    if (marker == 0xFF) {
+      pos++;  // Fill byte.
+      continue;
+    }
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8)) {
+      pos += 2;  // No length.
+      continue;
+    }
+    if (marker == 0xD9 || marker == 0xDA) {
+      return false;  // Image data before any frame header.
+    }
+    const uint32_t length = Be16(data + pos + 2);
+    if (length < 2) {
+      return false;
+    }
+    // SOF0 to SOF15, except DHT, JPG and DAC which share the range.
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 &&
+        marker != 0xC8 && marker != 0xCC) {
+      if (pos + 9 > size) {
+        return false;
+      }
+      *height = static_cast<int32_t>(Be16(data + pos + 5));
+      *width = static_cast<int32_t>(Be16(data + pos + 7));
+      return true;
+    }
+    pos += 2 + length;
+  }
+  return false;
+}
+
+bool ReadWebpSize(const uint8_t* data, size_t size, int32_t* width,
+                  int32_t* height) {
+  if (size < 30) {
+    return false;
+  }
+  if (StartsWith(data, size, "VP8 ", 12)) {
+    if (data[23] != 0x9D || data[24] != 0x01 || data[25] != 0x2A) {
+      return false;
+    }
+    *width = static_cast<int32_t>(Le16(data + 26) & 0x3FFF);
+    *height = static_cast<int32_t>(Le16(data + 28) & 0x3FFF);
+    return true;
+  }
+  if (StartsWith(data, size, "VP8L", 12)) {
+    if (data[20] != 0x2F) {
+      return false;
+    }
+    const uint32_t bits = Le32(data + 21);
+    *width = static_cast<int32_t>((bits & 0x3FFF) + 1);
+    *height = static_cast<int32_t>(((bits >> 14) & 0x3FFF) + 1);
+    return true;
+  }
+  if (StartsWith(data, size, "VP8X", 12)) {
+    *width = static_cast<int32_t>(Le24(data + 24) + 1);
+    *height = static_cast<int32_t>(Le24(data + 27) + 1);
+    return true;
+  }
+  return false;
+}
+
+bool IsPdfSpace(uint8_t c) {
+  return c == 0 || c == '\t' || c == '\n' || c == '\f' || c == '\r' ||
+         c == ' ';
+}
+
+// Neither white space nor a delimiter, so it continues a name.
+bool IsPdfRegular(uint8_t c) {
+  return !IsPdfSpace(c) && strchr("()<>[]{}/%", c) == nullptr;
+}
+
+// Reads up to |size| bytes, retrying short reads. Returns -1 on error.
+ssize_t ReadFully(int fd, uint8_t* buffer, size_t size) {
+  size_t total = 0;
+  while (total < size) {
+    const ssize_t n = read(fd, buffer + total, size - total);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      return -1;
+    }
+    if (n == 0) {
+      break;
+    }
+    total += n;
+  }
+  return static_cast<ssize_t>(total);
+}
+
+}  // namespace
+
+IngestKind SniffKind(const uint8_t* data, size_t size) {
+  static const uint8_t kPngMagic[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A,
+                                      '\n'};
+  if (size >= sizeof(kPngMagic) &&
+      memcmp(data, kPngMagic, sizeof(kPngMagic)) == 0) {
+    return IngestKind::kPng;
+  }
+  if (size >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF) {
+    return IngestKind::kJpeg;
+  }
+  if (StartsWith(data, size, "GIF87a") || StartsWith(data, size, "GIF89a")) {
+    return IngestKind::kGif;
+  }
+  if (StartsWith(data, size, "RIFF") && StartsWith(data, size, "WEBP", 8)) {
+    return IngestKind::kWebp;
+  }
+  if (StartsWith(data, size, "BM") && size >= 18) {
+    // "BM" alone also starts plenty of text; the DIB header size settles it.
+    const uint32_t header = Le32(data + 14);
+    if (header == 12 || header == 40 || header == 52 || header == 56 ||
+        header == 108 || header == 124) {
+      return IngestKind::kBmp;
+    }
+  }
+  if (StartsWith(data, size, "ftyp", 4)) {
+    for (const char* brand : {"heic", "heix", "hevc", "heim", "heis", "mif1",
+                              "msf1"}) {
+      if (StartsWith(data, size, brand, 8)) {
+        return IngestKind::kHeif;
+      }
+    }
+  }
+  if (StartsWith(data, size, "%PDF-")) {
+    return IngestKind::kPdf;
+  }
+  if (StartsWith(data, size, "PK\x03\x04") ||
+      StartsWith(data, size, "PK\x05\x06")) {
+    return IngestKind::kZip;
+  }
+  if (LooksLikeText(data, std::min(size, kTextSniffBytes))) {
+    return IngestKind::kText;
+  }
+  return IngestKind::kUnknown;
+}
+
+const char* IngestMimeType(IngestKind kind) {
+  switch (kind) {
+    case IngestKind::kText:
+      return "text/plain";
+    case IngestKind::kPng:
+      return "image/png";
+    case IngestKind::kJpeg:
+      return "image/jpeg";
+    case IngestKind::kGif:
+      return "image/gif";
+    case IngestKind::kBmp:
+      return "image/bmp";
+    case IngestKind::kWebp:
+      return "image/webp";
+    case IngestKind::kHeif:
+      return "image/heif";
+    case IngestKind::kPdf:
+      return "application/pdf";
+    case IngestKind::kZip:
+      return "application/zip";
+    default:
+      return "application/octet-stream";
+  }
+}
+
+bool IsImageKind(IngestKind kind) {
+  return kind >= IngestKind::kPng && kind <= IngestKind::kHeif;
+}
+
+bool ReadImageSize(IngestKind kind, const uint8_t* data, size_t size,
+                   int32_t* width, int32_t* height) {
+  int32_t w = 0;
+  int32_t h = 0;
+  bool found = false;
+  switch (kind) {
+    case IngestKind::kPng:
+      if (size >= 24 && StartsWith(data, size, "IHDR", 12)) {
+        w = static_cast<int32_t>(Be32(data + 16));
+        h = static_cast<int32_t>(Be32(data + 20));
+        found = true;
+      }
+      break;
+    case IngestKind::kJpeg:
+      found = ReadJpegSize(data, size, &w, &h);
+      break;
+    case IngestKind::kGif:
+      if (size >= 10) {
+        w = static_cast<int32_t>(Le16(data + 6));
+        h = static_cast<int32_t>(Le16(data + 8));
+        found = true;
+      }
+      break;
+    case IngestKind::kBmp:
+      if (size >= 26 && Le32(data + 14) == 12) {
+        w = static_cast<int32_t>(Le16(data + 18));
+        h = static_cast<int32_t>(Le16(data + 20));
+        found = true;
+      } else if (size >= 26) {
+        w = static_cast<int32_t>(Le32(data + 18));
+        // Negative for top-down bitmaps.
+        h = std::abs(static_cast<int32_t>(Le32(data + 22)));
+        found = true;
+      }
+      break;
+    case IngestKind::kWebp:
+      found = ReadWebpSize(data, size, &w, &h);
+      break;
+    default:
+      break;
+  }
+  if (!found || w <= 0 || h <= 0) {
+    return false;
+  }
+  *width = w;
+  *height = h;
+  return true;
+}
+
+void PdfPageCounter::Update(const uint8_t* data, size_t size) {
+  static constexpr char kType[] = "/Type";
+  static constexpr char kPage[] = "/Page";
+  const uint8_t* end = data + size;
+  const uint8_t* p = data;
+  while (p < end) {
+    if (phase_ == Phase::kType && matched_ == 0) {
+      // Most of a PDF is streams; skip to the next name.
+      p = static_cast<const uint8_t*>(memchr(p, '/', end - p));
+      if (p == nullptr) {
+        return;
+      }
+    }
+    const uint8_t c = *p;
+    switch (phase_) {
+      case Phase::kType:
+        if (c == kType[matched_]) {
+          if (++matched_ == 5) {
+            phase_ = Phase::kSpace;
+          }
+        } else {
+          matched_ = c == '/' ? 1 : 0;
+        }
+        break;
+      case Phase::kSpace:
+        if (c == '/') {
+          phase_ = Phase::kPage;
+          matched_ = 1;
+        } else if (!IsPdfSpace(c)) {
+          phase_ = Phase::kType;
+          matched_ = 0;
+        }
+        break;
+      case Phase::kPage:
+        if (c == kPage[matched_]) {
+          if (++matched_ == 5) {
+            phase_ = Phase::kAfterPage;
+          }
+        } else {
+          phase_ = Phase::kType;
+          matched_ = c == '/' ? 1 : 0;
+        }
+        break;
+      case Phase::kAfterPage:
+        phase_ = Phase::kType;
+        matched_ = 0;
+        // "/Pages" and "/PageLabel" go on; "/Page" ends here.
+        if (!IsPdfRegular(c)) {
+          pages_++;
+          continue;  // |c| may start the next name.
+        }
+        break;
+    }
+    p++;
+  }
+}
+
+int32_t PdfPageCounter::pages() const {
+  return pages_ + (phase_ == Phase::kAfterPage ? 1 : 0);
+}
+
+void FitThumbnail(int32_t width, int32_t height, int32_t box,
+                  int32_t* thumbnail_width, int32_t* thumbnail_height) {
+  if (width <= 0 || height <= 0 || box <= 0) {
+    *thumbnail_width = 0;
+    *thumbnail_height = 0;
+    return;
+  }
+  if (width <= box && height <= box) {
+    *thumbnail_width = width;
+    *thumbnail_height = height;
+    return;
+  }
+  // Rounded, and at least one pixel for extreme aspect ratios.
+  if (width >= height) {
+    *thumbnail_width = box;
+    *thumbnail_height = static_cast<int32_t>(
+        std::max<int64_t>(1, (int64_t{height} * box + width / 2) / width));
+  } else {
+    *thumbnail_height = box;
+    *thumbnail_width = static_cast<int32_t>(
+        std::max<int64_t>(1, (int64_t{width} * box + height / 2) / height));
+  }
+}
+
+void IngestFile(const std::string& path, const IngestLimits& limits,
+                const CancellationToken* token, IngestResult* out) {
+  *out = IngestResult();
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    out->status = errno == ENOENT || errno == ENOTDIR
+                      ? IngestStatus::kMissing
+                      : IngestStatus::kUnreadable;
+    return;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    out->status = IngestStatus::kUnreadable;
+    close(fd);
+    return;
+  }
+  if (!S_ISREG(info.st_mode)) {
+    out->status = IngestStatus::kNotAFile;
+    close(fd);
+    return;
+  }
+  out->size = static_cast<uint64_t>(info.st_size);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+  std::vector<uint8_t> block(kBlockBytes);
+  ssize_t n = ReadFully(fd, block.data(), block.size());
+  if (n < 0) {
+    out->status = IngestStatus::kUnreadable;
+    close(fd);
+    return;
+  }
+  out->kind = SniffKind(block.data(), n);
+  ReadImageSize(out->kind, block.data(), n, &out->width, &out->height);
+  const uint64_t limit = IsImageKind(out->kind) ? limits.max_image_bytes
+                                                : limits.max_file_bytes;
+  if (out->size > limit) {
+    out->status = IngestStatus::kTooLarge;
+    close(fd);
+    return;
+  }
+
+  Sha256 hash;
+  PdfPageCounter pdf;
+  const bool is_pdf = out->kind == IngestKind::kPdf;
+  while (n > 0) {
+    hash.Update(block.data(), n);
+    if (is_pdf) {
+      pdf.Update(block.data(), n);
+    }
+    if (token != nullptr && token->IsCancelled()) {
+      out->status = IngestStatus::kCancelled;
+      close(fd);
+      return;
+    }
+    n = ReadFully(fd, block.data(), block.size());
+  }
+  close(fd);
+  if (n < 0) {
+    out->status = IngestStatus::kUnreadable;
+    return;
+  }
+  hash.Final(out->sha256);
+  if (is_pdf) {
+    out->pages = pdf.pages();
+  }
+  FitThumbnail(out->width, out->height, limits.thumbnail_size,
+               &out->thumbnail_width, &out->thumbnail_height);
+}
@@ -0,0 +1,95 @@
+#ifndef NATIVE_INGEST_FILE_INGEST_H_
+#define NATIVE_INGEST_FILE_INGEST_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "scheduler/task.h"
+#include "update/sha256.h"
+
+// What an attachment dropped on the task dialogs turns out to be, worked out
+// in a single read of the file: the type from its magic bytes (the
+// extension is not trusted), the size checked against the limit for that
+// type, a SHA-256 of the content, and image dimensions or a PDF page count.
+// Files over their limit are not read past the first block.
+
+enum class IngestKind : int32_t {
+  kUnknown = 0,  // Binary data we do not recognise.
+  kText = 1,
+  kPng = 2,
+  kJpeg = 3,
+  kGif = 4,
+  kBmp = 5,
+  kWebp = 6,
+  kHeif = 7,
+  kPdf = 8,
+  kZip = 9,  // Includes .docx and .xlsx.
+};
+
+enum class IngestStatus : int32_t {
+  kOk = 0,
+  kMissing = 1,
+  kNotAFile = 2,  // A directory, socket...
+  kTooLarge = 3,
+  kUnreadable = 4,
+  kCancelled = 5,
+};
+
+struct IngestLimits {
+  // Matches what the task dialogs accept.
+  uint64_t max_image_bytes = 20ull << 20;
+  uint64_t max_file_bytes = 50ull << 20;
+  // Previews fit a square this many pixels wide.
+  int32_t thumbnail_size = 120;
+};
+
+struct IngestResult {
+  IngestStatus status = IngestStatus::kOk;
+  IngestKind kind = IngestKind::kUnknown;
+  uint64_t size = 0;
+  // Pixels, for images whose header we can read; 0 otherwise.
+  int32_t width = 0;
+  int32_t height = 0;
+  // Size to decode the preview at, or 0 when there is none to draw.
+  int32_t thumbnail_width = 0;
+  int32_t thumbnail_height = 0;
+  // PDF pages; 0 when unknown (the page objects are compressed).
+  int32_t pages = 0;
+  // Set when status is kOk.
+  uint8_t sha256[Sha256::kDigestBytes] = {};
+};
+
+// Recognises a file from its first bytes.
+IngestKind SniffKind(const uint8_t* data, size_t size);
+const char* IngestMimeType(IngestKind kind);
+bool IsImageKind(IngestKind kind);
+
+// Reads width and height from an image header in |data|. Returns false for
+// other kinds, or when the header is cut short or malformed.
+bool ReadImageSize(IngestKind kind, const uint8_t* data, size_t size,
+                   int32_t* width, int32_t* height);
+
+// Counts "/Type /Page" dictionaries in a PDF fed in pieces of any size.
+class PdfPageCounter {
+ public:
+  void Update(const uint8_t* data, size_t size);
+  int32_t pages() const;
+
+ private:
+  enum class Phase { kType, kSpace, kPage, kAfterPage };
+
+  Phase phase_ = Phase::kType;
+  size_t matched_ = 0;
+  int32_t pages_ = 0;
+};
+
+// Fits |width| x |height| into a |box| square without enlarging it.
+void FitThumbnail(int32_t width, int32_t height, int32_t box,
+                  int32_t* thumbnail_width, int32_t* thumbnail_height);
+
+// Fills |out| for |path|. |token| (may be null) is checked between blocks.
+void IngestFile(const std::string& path, const IngestLimits& limits,
+                const CancellationToken* token, IngestResult* out);
+
+#endif  // NATIVE_INGEST_FILE_INGEST_H_
@@ -0,0 +1,72 @@
+#include "ingest/ingest_api.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ingest/ingest_job.h"
+
+struct SsIngestJob {
+  std::shared_ptr<IngestJob> job;
+};
+
+SsIngestJob* ss_ingest_start(const char* const* paths, int32_t count,
+                             const SsIngestLimits* limits,
+                             SsIngestResultCallback on_result,
+                             SsIngestDoneCallback on_done, void* user_data) {
+  if (count < 0 || (count > 0 && paths == nullptr)) {
+    return nullptr;
+  }
+  std::vector<std::string> copies;
+  copies.reserve(count);
+  for (int32_t i = 0; i < count; i++) {
+    copies.emplace_back(paths[i] ? paths[i] : "");
+  }
+  IngestLimits ingest_limits;
+  if (limits != nullptr) {
+    ingest_limits.max_image_bytes = limits->max_image_bytes;
+    ingest_limits.max_file_bytes = limits->max_file_bytes;
+    ingest_limits.thumbnail_size = limits->thumbnail_size;
+  }
+  IngestJob::ResultCallback result_callback;
+  if (on_result != nullptr) {
+    result_callback = [on_result, user_data](size_t index,
+                                             const IngestResult& result) {
+      SsIngestResult out;
+      out.index = static_cast<int32_t>(index);
+      out.status = static_cast<int32_t>(result.status);
+      out.kind = static_cast<int32_t>(result.kind);
+      out.width = result.width;
+      out.height = result.height;
+      out.thumbnail_width = result.thumbnail_width;
+      out.thumbnail_height = result.thumbnail_height;
+      out.pages = result.pages;
+      out.size = result.size;
+      std::memcpy(out.sha256, result.sha256, sizeof(out.sha256));
+      out.mime = IngestMimeType(result.kind);
+      on_result(&out, user_data);
+    };
+  }
+  IngestJob::DoneCallback done_callback;
+  if (on_done != nullptr) {
+    done_callback = [on_done, user_data]() { on_done(user_data); };
+  }
+  return new SsIngestJob{IngestJob::Start(std::move(copies), ingest_limits,
+                                          std::move(result_callback),
+                                          std::move(done_callback))};
+}
+
+void ss_ingest_cancel(SsIngestJob* job) {
+  if (job != nullptr) {
+    job->job->Cancel();
+  }
+}
+
+void ss_ingest_release(SsIngestJob* job) {
+  if (job != nullptr) {
+    // Tasks still running hold their own reference to the job.
+    job->job->Cancel();
+    delete job;
+  }
+}
@@ -0,0 +1,66 @@
+#ifndef NATIVE_INGEST_INGEST_API_H_
+#define NATIVE_INGEST_INGEST_API_H_
+
+#include <stdint.h>
+
+#include "common/native_export.h"
+
+// C interface for the Linux runner's drop handler (linux/runner/
+// drop_ingest.cc).
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SsIngestJob SsIngestJob;
+
+// Mirrors IngestLimits.
+typedef struct {
+  uint64_t max_image_bytes;
+  uint64_t max_file_bytes;
+  int32_t thumbnail_size;
+} SsIngestLimits;
+
+// Mirrors IngestResult; |index| is the file's position in the paths given to
+// ss_ingest_start(). |mime| is a static string.
+typedef struct {
+  int32_t index;
+  int32_t status;  // IngestStatus.
+  int32_t kind;    // IngestKind.
+  int32_t width;
+  int32_t height;
+  int32_t thumbnail_width;
+  int32_t thumbnail_height;
+  int32_t pages;
+  uint64_t size;
+  uint8_t sha256[32];
+  const char* mime;
+} SsIngestResult;
+
+// Both run on pool threads, one call at a time. |result| is only valid for
+// the duration of the call.
+typedef void (*SsIngestResultCallback)(const SsIngestResult* result,
+                                       void* user_data);
+typedef void (*SsIngestDoneCallback)(void* user_data);
+
+// Ingests |count| files on the shared thread pool; the paths are copied.
+// |limits| may be null for the defaults. Results arrive in completion order,
+// then |on_done| once, unless the job is cancelled first.
+SS_EXPORT SsIngestJob* ss_ingest_start(const char* const* paths,
+                                       int32_t count,
+                                       const SsIngestLimits* limits,
+                                       SsIngestResultCallback on_result,
+                                       SsIngestDoneCallback on_done,
+                                       void* user_data);
+
+// No callback runs once this returns.
+SS_EXPORT void ss_ingest_cancel(SsIngestJob* job);
+
+// Frees the job, cancelling it first if it is still running.
+SS_EXPORT void ss_ingest_release(SsIngestJob* job);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // NATIVE_INGEST_INGEST_API_H_
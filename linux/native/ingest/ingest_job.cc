@@ -0,0 +1,95 @@
+#include "ingest/ingest_job.h"
+
+#include <utility>
+
+std::shared_ptr<IngestJob> IngestJob::Start(std::vector<std::string> paths,
+                                            const IngestLimits& limits,
+                                            ResultCallback on_result,
+                                            DoneCallback on_done,
+                                            ThreadPool* pool) {
+  std::shared_ptr<IngestJob> job(new IngestJob(
+      std::move(paths), limits, std::move(on_result), std::move(on_done)));
+  if (pool == nullptr) {
+    pool = &ThreadPool::Get();
+  }
+  std::lock_guard<std::mutex> lock(job->mutex_);
+  job->remaining_ = job->paths_.size();
+  job->tasks_.reserve(job->paths_.size());
+  for (size_t i = 0; i < job->paths_.size(); i++) {
+    // Hashing a large drawing takes a while, so it stays off the
+    // interactive workers; the results still stream in as each completes.
+    job->tasks_.push_back(pool->Submit(
+        TaskPriority::kBackground,
+        [job, i](const CancellationToken& token) { job->Run(i, token); }));
+  }
+  if (job->paths_.empty()) {
+    if (job->on_done_) {
+      job->on_done_();
+    }
+    job->done_ = true;
+  }
+  return job;
+}
+
+IngestJob::IngestJob(std::vector<std::string> paths,
+                     const IngestLimits& limits, ResultCallback on_result,
+                     DoneCallback on_done)
+    : paths_(std::move(paths)),
+      limits_(limits),
+      on_result_(std::move(on_result)),
+      on_done_(std::move(on_done)) {}
+
+void IngestJob::Cancel() {
+  {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    cancelled_ = true;
+  }
+  std::vector<TaskHandle> tasks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks.swap(tasks_);
+  }
+  for (TaskHandle& task : tasks) {
+    if (task.Cancel()) {
+      // Never runs, so it never finishes by itself.
+      Finish();
+    }
+  }
+}
+
+void IngestJob::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  finished_.wait(lock, [this] { return done_; });
+}
+
+void IngestJob::Run(size_t index, const CancellationToken& token) {
+  IngestResult result;
+  IngestFile(paths_[index], limits_, &token, &result);
+  {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    if (!cancelled_ && on_result_) {
+      on_result_(index, result);
+    }
+  }
+  Finish();
+}
+
+void IngestJob::Finish() {
+  bool last;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    last = --remaining_ == 0;
+  }
+  if (!last) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    if (!cancelled_ && on_done_) {
+      on_done_();
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  done_ = true;
+  finished_.notify_all();
+}
@@ -0,0 +1,67 @@
+#ifndef NATIVE_INGEST_INGEST_JOB_H_
+#define NATIVE_INGEST_INGEST_JOB_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ingest/file_ingest.h"
+#include "scheduler/thread_pool.h"
+
+// Ingests a batch of dropped files on the shared thread pool, one task per
+// file, and reports each result as soon as it is ready.
+//
+// Callbacks run on pool workers, one at a time, in completion order.
+// |on_done| runs once after the last result unless the job is cancelled.
+class IngestJob : public std::enable_shared_from_this<IngestJob> {
+ public:
+  using ResultCallback =
+      std::function<void(size_t index, const IngestResult& result)>;
+  using DoneCallback = std::function<void()>;
+
+  static std::shared_ptr<IngestJob> Start(std::vector<std::string> paths,
+                                          const IngestLimits& limits,
+                                          ResultCallback on_result,
+                                          DoneCallback on_done,
+                                          ThreadPool* pool = nullptr);
+
+  IngestJob(const IngestJob&) = delete;
+  IngestJob& operator=(const IngestJob&) = delete;
+
+  // Skips files not started yet and stops those being read. No callback
+  // runs once this returns.
+  void Cancel();
+
+  // Blocks until every task has finished or been skipped.
+  void Wait();
+
+  size_t size() const { return paths_.size(); }
+
+ private:
+  IngestJob(std::vector<std::string> paths, const IngestLimits& limits,
+            ResultCallback on_result, DoneCallback on_done);
+
+  void Run(size_t index, const CancellationToken& token);
+  // One task has run or been skipped.
+  void Finish();
+
+  const std::vector<std::string> paths_;
+  const IngestLimits limits_;
+  ResultCallback on_result_;
+  DoneCallback on_done_;
+
+  std::mutex callback_mutex_;  // Serializes callbacks against Cancel().
+  bool cancelled_ = false;
+
+  std::mutex mutex_;
+  std::condition_variable finished_;
+  size_t remaining_ = 0;
+  bool done_ = false;  // Set once on_done_ has run or been skipped.
+  std::vector<TaskHandle> tasks_;
+};
+
+#endif  // NATIVE_INGEST_INGEST_JOB_H_
@@ -0,0 +1,221 @@
+#include "logging/log_api.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "logging/log_query.h"
+#include "logging/logger.h"
+
+namespace {
+
+constexpr size_t kMaxArgs = 32;
+
+LogLevel ToLevel(int32_t level) {
+  if (level < 0) {
+    return LogLevel::kTrace;
+  }
+  if (level > static_cast<int32_t>(LogLevel::kFatal)) {
+    return LogLevel::kFatal;
+  }
+  return static_cast<LogLevel>(level);
+}
+
+uint32_t MessageFormatId() {
+  static const uint32_t id = Logger::Intern("{}");
+  return id;
+}
+
+std::vector<std::string> SplitList(const char* list) {
+  std::vector<std::string> items;
+  if (list == nullptr) {
+    return items;
+  }
+  std::string item;
+  for (const char* c = list;; c++) {
+    if (*c == ',' || *c == '\0') {
+      if (!item.empty()) {
+        items.push_back(item);
+      }
+      item.clear();
+      if (*c == '\0') {
+        break;
+      }
+    } else if (*c != ' ') {
+      item.push_back(*c);
+    }
+  }
+  return items;
+}
+
+}  // namespace
+
+struct SsLogQuery {
+  std::unique_ptr<LogQueryCursor> cursor;
+  std::vector<LogEntry> batch;  // Backs the strings handed out last.
+};
+
+bool ss_log_open(const SsLogConfig* config) {
+  if (config == nullptr || config->directory == nullptr) {
+    return false;
+  }
+  LoggerConfig logger_config;
+  logger_config.directory = config->directory;
+  if (config->max_segment_bytes > 0) {
+    logger_config.rotation.max_segment_bytes = config->max_segment_bytes;
+  }
+  if (config->max_segment_age_seconds > 0) {
+    logger_config.rotation.max_segment_age_us =
+        config->max_segment_age_seconds * 1000000;
+  }
+  if (config->max_archived_segments > 0) {
+    logger_config.rotation.max_archived_segments =
+        config->max_archived_segments;
+  }
+  if (config->max_archive_bytes > 0) {
+    logger_config.rotation.max_archive_bytes = config->max_archive_bytes;
+  }
+  if (config->max_string_bytes > 0) {
+    logger_config.max_string_bytes = config->max_string_bytes;
+  }
+  if (config->oversized_sample_every > 0) {
+    logger_config.oversized_sample_every = config->oversized_sample_every;
+  }
+  if (config->flush_interval_ms > 0) {
+    logger_config.flush_interval_ms = config->flush_interval_ms;
+  }
+  logger_config.min_level = ToLevel(config->min_level);
+  MessageFormatId();
+  return Logger::Get().Open(logger_config);
+}
+
+void ss_log_close(void) {
+  Logger::Get().Close();
+}
+
+uint32_t ss_log_intern(const char* text) {
+  return text != nullptr ? Logger::Intern(text) : 0;
+}
+
+void ss_log_write(int32_t level, uint32_t subsystem_id, uint32_t format_id,
+                  const SsLogArg* args, int32_t count) {
+  Logger& logger = Logger::Get();
+  LogLevel log_level = ToLevel(level);
+  if (!logger.IsEnabled(log_level)) {
+    return;
+  }
+  size_t arg_count = count > 0 && args != nullptr
+                         ? std::min<size_t>(count, kMaxArgs)
+                         : 0;
+  LogArg converted[kMaxArgs];
+  size_t converted_count = 0;
+  for (size_t i = 0; i < arg_count; i++) {
+    const SsLogArg& arg = args[i];
+    LogArgType type = static_cast<LogArgType>(arg.type);
+    if (type != LogArgType::kInt && type != LogArgType::kDouble &&
+        type != LogArgType::kString) {
+      continue;
+    }
+    size_t length = arg.string_value != nullptr && arg.string_length > 0
+                        ? static_cast<size_t>(arg.string_length)
+                        : 0;
+    converted[converted_count++] = LogArg(type, arg.int_value,
+                                          arg.double_value, arg.string_value,
+                                          length);
+  }
+  logger.Log(log_level, subsystem_id, format_id, converted, converted_count);
+}
+
+void ss_log_message(int32_t level, uint32_t subsystem_id, const char* message,
+                    int32_t length) {
+  Logger& logger = Logger::Get();
+  LogLevel log_level = ToLevel(level);
+  if (!logger.IsEnabled(log_level)) {
+    return;
+  }
+  LogArg arg(LogArgType::kString, 0, 0, message,
+             message != nullptr && length > 0 ? static_cast<size_t>(length)
+                                              : 0);
+  logger.Log(log_level, subsystem_id, MessageFormatId(), &arg, 1);
+}
+
+void ss_log_set_level(int32_t level) {
+  Logger::Get().SetMinLevel(ToLevel(level));
+}
+
+void ss_log_flush(void) {
+  Logger::Get().Flush();
+}
+
+void ss_log_get_stats(SsLogStats* out) {
+  if (out == nullptr) {
+    return;
+  }
+  LoggerStats stats = Logger::Get().stats();
+  out->records_written = stats.records_written;
+  out->records_dropped = stats.records_dropped;
+  out->records_sampled_out = stats.records_sampled_out;
+  out->records_truncated = stats.records_truncated;
+  out->bytes_written = stats.bytes_written;
+  out->segments_rotated = stats.segments_rotated;
+}
+
+SsLogQuery* ss_log_query_open(const char* directory,
+                              const SsLogQueryFilter* filter) {
+  if (directory == nullptr) {
+    return nullptr;
+  }
+  LogQuery query;
+  if (filter != nullptr) {
+    query.from_us = filter->from_us > 0 ? filter->from_us : 0;
+    if (filter->to_us > 0) {
+      query.to_us = filter->to_us;
+    }
+    query.min_level = ToLevel(filter->min_level);
+    query.subsystems = SplitList(filter->subsystems);
+    if (filter->text != nullptr) {
+      query.text = filter->text;
+    }
+  }
+  return new SsLogQuery{std::make_unique<LogQueryCursor>(directory, query),
+                        {}};
+}
+
+int32_t ss_log_query_next(SsLogQuery* query, SsLogEntry* entries,
+                          int32_t max) {
+  if (query == nullptr || entries == nullptr || max <= 0) {
+    return 0;
+  }
+  query->batch.resize(max);
+  int32_t count = 0;
+  while (count < max && query->cursor->Next(&query->batch[count])) {
+    const LogEntry& entry = query->batch[count];
+    SsLogEntry& out = entries[count];
+    out.timestamp_us = static_cast<int64_t>(entry.timestamp_us);
+    out.level = static_cast<int32_t>(entry.level);
+    out.thread_id = entry.thread_id;
+    out.truncated = entry.truncated ? 1 : 0;
+    out.subsystem = entry.subsystem.c_str();
+    out.message = entry.message.c_str();
+    count++;
+  }
+  return count;
+}
+
+void ss_log_query_get_stats(SsLogQuery* query, SsLogQueryStats* out) {
+  if (query == nullptr || out == nullptr) {
+    return;
+  }
+  const LogQueryStats& stats = query->cursor->stats();
+  out->segments = stats.segments;
+  out->segments_skipped = stats.segments_skipped;
+  out->blocks_inflated = stats.blocks_inflated;
+  out->blocks_skipped = stats.blocks_skipped;
+  out->records_scanned = stats.records_scanned;
+  out->records_matched = stats.records_matched;
+}
+
+void ss_log_query_close(SsLogQuery* query) {
+  delete query;
+}
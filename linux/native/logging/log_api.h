@@ -0,0 +1,119 @@
+#ifndef NATIVE_LOGGING_LOG_API_H_
+#define NATIVE_LOGGING_LOG_API_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/native_export.h"
+
+// C interface for lib/native/native_log_bindings.dart.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  const char* directory;
+  uint64_t max_segment_bytes;
+  uint64_t max_segment_age_seconds;
+  uint32_t max_archived_segments;
+  uint64_t max_archive_bytes;
+  uint32_t max_string_bytes;
+  uint32_t oversized_sample_every;
+  uint32_t flush_interval_ms;
+  int32_t min_level;  // LogLevel.
+} SsLogConfig;
+
+// Mirrors LogArg. |type| is a LogArgType; |string_value| is UTF-8 of
+// |string_length| bytes and is only borrowed for the call.
+typedef struct {
+  int32_t type;
+  int32_t string_length;
+  int64_t int_value;
+  double double_value;
+  const char* string_value;
+} SsLogArg;
+
+typedef struct {
+  uint64_t records_written;
+  uint64_t records_dropped;
+  uint64_t records_sampled_out;
+  uint64_t records_truncated;
+  uint64_t bytes_written;
+  uint32_t segments_rotated;
+} SsLogStats;
+
+// Starts the writer thread. Zero fields in |config| keep their defaults.
+SS_EXPORT bool ss_log_open(const SsLogConfig* config);
+
+// Drains the ring, flushes and stops the writer thread.
+SS_EXPORT void ss_log_close(void);
+
+// Returns a stable id for a format string or subsystem name.
+SS_EXPORT uint32_t ss_log_intern(const char* text);
+
+SS_EXPORT void ss_log_write(int32_t level, uint32_t subsystem_id,
+                            uint32_t format_id, const SsLogArg* args,
+                            int32_t count);
+
+// Logs |message| as the single argument of the "{}" format.
+SS_EXPORT void ss_log_message(int32_t level, uint32_t subsystem_id,
+                              const char* message, int32_t length);
+
+SS_EXPORT void ss_log_set_level(int32_t level);
+
+// Blocks until everything logged so far is on disk.
+SS_EXPORT void ss_log_flush(void);
+
+SS_EXPORT void ss_log_get_stats(SsLogStats* out);
+
+typedef struct SsLogQuery SsLogQuery;
+
+// Mirrors LogQuery. |subsystems| is a comma-separated list; null or empty
+// strings match everything. Zero |to_us| means no upper bound.
+typedef struct {
+  int64_t from_us;
+  int64_t to_us;
+  int32_t min_level;
+  const char* subsystems;
+  const char* text;
+} SsLogQueryFilter;
+
+typedef struct {
+  int64_t timestamp_us;
+  int32_t level;
+  uint32_t thread_id;
+  int32_t truncated;
+  const char* subsystem;
+  const char* message;
+} SsLogEntry;
+
+typedef struct {
+  uint32_t segments;
+  uint32_t segments_skipped;
+  uint32_t blocks_inflated;
+  uint32_t blocks_skipped;
+  uint64_t records_scanned;
+  uint64_t records_matched;
+} SsLogQueryStats;
+
+// Starts a query over the log directory |directory|. Call ss_log_flush()
+// first to include records still in memory.
+SS_EXPORT SsLogQuery* ss_log_query_open(const char* directory,
+                                        const SsLogQueryFilter* filter);
+
+// Fills up to |max| entries and returns how many were filled; 0 means the
+// query is exhausted. Strings stay valid until the next call.
+SS_EXPORT int32_t ss_log_query_next(SsLogQuery* query, SsLogEntry* entries,
+                                    int32_t max);
+
+SS_EXPORT void ss_log_query_get_stats(SsLogQuery* query,
+                                      SsLogQueryStats* out);
+
+SS_EXPORT void ss_log_query_close(SsLogQuery* query);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // NATIVE_LOGGING_LOG_API_H_
@@ -0,0 +1,194 @@
+#include "logging/log_archive.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "common/buffered_file.h"
+#include "common/mapped_file.h"
+#include "logging/log_index.h"
+#include "logging/log_reader.h"
+#include "logging/log_record.h"
+#include "tracing/tracer.h"
+
+namespace {
+
+constexpr size_t kChunkBytes = 64 * 1024;
+
+// Streams deflate output for one archive into a BufferedFile.
+class GzipSink {
+ public:
+  explicit GzipSink(BufferedFile* file) : file_(file), chunk_(kChunkBytes) {
+    std::memset(&stream_, 0, sizeof(stream_));
+    // 15 + 16 selects a gzip wrapper, so archives open with zcat.
+    ok_ = deflateInit2(&stream_, 6, Z_DEFLATED, 15 + 16, 8,
+                       Z_DEFAULT_STRATEGY) == Z_OK;
+  }
+
+  ~GzipSink() { deflateEnd(&stream_); }
+
+  // Compresses |size| bytes. Z_FULL_FLUSH makes the following data
+  // decodable without anything before it.
+  bool Write(const uint8_t* data, size_t size, int flush) {
+    if (!ok_) {
+      return false;
+    }
+    stream_.next_in = const_cast<Bytef*>(data);
+    stream_.avail_in = static_cast<uInt>(size);
+    int result;
+    do {
+      stream_.next_out = reinterpret_cast<Bytef*>(chunk_.data());
+      stream_.avail_out = static_cast<uInt>(chunk_.size());
+      result = deflate(&stream_, flush);
+      if (result == Z_STREAM_ERROR) {
+        return ok_ = false;
+      }
+      size_t produced = chunk_.size() - stream_.avail_out;
+      if (produced > 0 && !file_->Write(chunk_.data(), produced)) {
+        return ok_ = false;
+      }
+    } while (stream_.avail_out == 0 ||
+             (flush == Z_FINISH && result != Z_STREAM_END));
+    return true;
+  }
+
+ private:
+  BufferedFile* file_;
+  std::vector<char> chunk_;
+  z_stream stream_;
+  bool ok_ = false;
+};
+
+bool WriteIndex(const std::string& path, LogIndexHeader header,
+                const std::vector<LogIndexBlock>& blocks,
+                const std::vector<uint32_t>& subsystems,
+                const LogDefinitions& definitions) {
+  BufferedFile file;
+  if (!file.Open(path)) {
+    return false;
+  }
+  header.block_count = static_cast<uint32_t>(blocks.size());
+  header.subsystem_count = static_cast<uint32_t>(subsystems.size());
+  header.definition_count = static_cast<uint32_t>(definitions.size());
+  file.Write(&header, sizeof(header));
+  if (!blocks.empty()) {
+    file.Write(blocks.data(), blocks.size() * sizeof(LogIndexBlock));
+  }
+  if (!subsystems.empty()) {
+    file.Write(subsystems.data(), subsystems.size() * sizeof(uint32_t));
+  }
+  for (const auto& definition : definitions) {
+    uint16_t length = static_cast<uint16_t>(
+        std::min<size_t>(definition.second.size(), UINT16_MAX));
+    file.Write(&definition.first, sizeof(definition.first));
+    file.Write(&length, sizeof(length));
+    file.Write(definition.second.data(), length);
+  }
+  if (!file.ok()) {
+    file.Abort();
+    return false;
+  }
+  return file.Commit();
+}
+
+}  // namespace
+
+std::string LogIndexPathFor(const std::string& archive_path) {
+  std::string base = archive_path;
+  if (base.size() > 3 && base.compare(base.size() - 3, 3, ".gz") == 0) {
+    base.resize(base.size() - 3);
+  }
+  return base + ".idx";
+}
+
+bool ArchiveLogSegment(const std::string& raw_path,
+                       const std::string& archive_path) {
+  SS_TRACE_SCOPE("log", "archive segment");
+  MappedFile raw;
+  LogSegmentHeader segment_header;
+  if (!raw.Open(raw_path) ||
+      !ReadLogSegmentHeader(raw.data(), raw.size(), &segment_header)) {
+    return false;
+  }
+  raw.AdviseSequential();
+  const uint8_t* data = raw.data();
+  const size_t size = raw.size();
+  const size_t base = sizeof(LogSegmentHeader);
+
+  BufferedFile archive;
+  if (!archive.Open(archive_path)) {
+    return false;
+  }
+  GzipSink gzip(&archive);
+  gzip.Write(data, base, Z_FULL_FLUSH);
+
+  LogIndexHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kLogIndexMagic, sizeof(header.magic));
+  header.version = kLogIndexVersion;
+  header.raw_bytes = size;
+
+  std::vector<LogIndexBlock> blocks;
+  std::vector<uint32_t> subsystems;
+  LogDefinitions definitions;
+  LogIndexBlock block = {};
+  block.raw_offset = base;
+  block.compressed_offset = archive.offset();
+
+  LogSegmentParser parser(data + base, size - base, &definitions);
+  LogRecordView record;
+  while (parser.Next(&record)) {
+    const LogRecordHeader& r = record.header;
+    if (block.record_count == 0 || r.timestamp_us < block.first_us) {
+      block.first_us = r.timestamp_us;
+    }
+    block.last_us = std::max(block.last_us, r.timestamp_us);
+    block.level_mask |= 1u << r.level;
+    block.subsystem_bloom |= LogSubsystemBloomBit(r.subsystem_id);
+    block.record_count++;
+    if (std::find(subsystems.begin(), subsystems.end(), r.subsystem_id) ==
+        subsystems.end()) {
+      subsystems.push_back(r.subsystem_id);
+    }
+
+    // Blocks end on entry boundaries once they reach the target size.
+    size_t end = base + parser.offset();
+    if (end - block.raw_offset >= kLogIndexBlockBytes) {
+      gzip.Write(data + block.raw_offset, end - block.raw_offset,
+                 Z_FULL_FLUSH);
+      blocks.push_back(block);
+      block = {};
+      block.raw_offset = end;
+      block.compressed_offset = archive.offset();
+    }
+  }
+  // Any partial trailing entry rides along in the last block.
+  if (!gzip.Write(data + block.raw_offset, size - block.raw_offset,
+                  Z_FINISH) ||
+      !archive.ok()) {
+    archive.Abort();
+    return false;
+  }
+  if (block.record_count > 0) {
+    blocks.push_back(block);
+  }
+
+  for (const LogIndexBlock& b : blocks) {
+    if (header.level_mask == 0 || b.first_us < header.first_us) {
+      header.first_us = b.first_us;
+    }
+    header.last_us = std::max(header.last_us, b.last_us);
+    header.level_mask |= b.level_mask;
+  }
+
+  if (!archive.Commit()) {
+    return false;
+  }
+  // Queries fall back to a full scan when the index is missing, so a
+  // failure here does not lose the archive.
+  WriteIndex(LogIndexPathFor(archive_path), header, blocks, subsystems,
+             definitions);
+  return true;
+}
@@ -0,0 +1,15 @@
+#ifndef NATIVE_LOGGING_LOG_ARCHIVE_H_
+#define NATIVE_LOGGING_LOG_ARCHIVE_H_
+
+#include <string>
+
+// Compresses the raw segment at |raw_path| to |archive_path| (gzip) and
+// writes its sparse index (see log_index.h) next to it. Both files appear
+// atomically; on failure neither exists and |raw_path| is left in place.
+bool ArchiveLogSegment(const std::string& raw_path,
+                       const std::string& archive_path);
+
+// "x.sslog.gz" -> "x.sslog.idx".
+std::string LogIndexPathFor(const std::string& archive_path);
+
+#endif  // NATIVE_LOGGING_LOG_ARCHIVE_H_
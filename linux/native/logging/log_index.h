@@ -0,0 +1,54 @@
+#ifndef NATIVE_LOGGING_LOG_INDEX_H_
+#define NATIVE_LOGGING_LOG_INDEX_H_
+
+#include <cstdint>
+
+// Sparse index written next to each archived segment ("x.sslog.idx" for
+// "x.sslog.gz").
+//
+// The archive is a gzip stream with a full flush before every block, so a
+// block can be inflated on its own starting at |compressed_offset|. The
+// index records, per block, what a query needs to decide whether to inflate
+// it at all. Layout:
+//   LogIndexHeader
+//   LogIndexBlock[block_count]
+//   uint32 subsystem id[subsystem_count]   (every subsystem in the segment)
+//   definition[definition_count]           (uint32 id, uint16 length, text)
+// The definitions are the segment's complete table, which a parser needs
+// when it starts in the middle of a segment.
+
+constexpr char kLogIndexMagic[8] = {'S', 'S', 'L', 'I', 'D', 'X', '0', '1'};
+constexpr uint32_t kLogIndexVersion = 1;
+
+// Uncompressed bytes per independently inflatable block.
+constexpr uint32_t kLogIndexBlockBytes = 64 * 1024;
+
+#pragma pack(push, 1)
+struct LogIndexHeader {
+  char magic[8];
+  uint32_t version;
+  uint64_t first_us;   // Earliest record timestamp; 0 if there are none.
+  uint64_t last_us;    // Latest record timestamp.
+  uint64_t raw_bytes;  // Size of the uncompressed segment.
+  uint32_t level_mask;  // Bit n set if any record has LogLevel n.
+  uint32_t block_count;
+  uint32_t subsystem_count;
+  uint32_t definition_count;
+};
+
+struct LogIndexBlock {
+  uint64_t first_us;
+  uint64_t last_us;
+  uint64_t raw_offset;         // Offset in the uncompressed segment.
+  uint64_t compressed_offset;  // Offset in the .gz file.
+  uint64_t subsystem_bloom;    // Bit (id % 64) set per subsystem present.
+  uint32_t record_count;
+  uint32_t level_mask;
+};
+#pragma pack(pop)
+
+inline uint64_t LogSubsystemBloomBit(uint32_t subsystem_id) {
+  return uint64_t{1} << (subsystem_id % 64);
+}
+
+#endif  // NATIVE_LOGGING_LOG_INDEX_H_
@@ -0,0 +1,313 @@
+#include "logging/log_query.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "logging/log_archive.h"
+#include "logging/log_index.h"
+
+namespace {
+
+constexpr char kArchivePrefix[] = "log-";
+constexpr char kCurrentSegment[] = "current.sslog";
+
+bool EndsWith(const std::string& value, const std::string& suffix) {
+  return value.size() >= suffix.size() &&
+         value.compare(value.size() - suffix.size(), suffix.size(), suffix) ==
+             0;
+}
+
+// Inflates |in| into |out|. With |expected| set, stops once that many bytes
+// are produced, which is how a single block is cut out of a longer stream.
+// Returns false if nothing could be decoded.
+bool Inflate(const uint8_t* in, size_t in_size, int window_bits,
+             size_t expected, std::vector<uint8_t>* out) {
+  z_stream stream;
+  std::memset(&stream, 0, sizeof(stream));
+  if (inflateInit2(&stream, window_bits) != Z_OK) {
+    return false;
+  }
+  out->resize(expected > 0 ? expected : in_size * 4 + 4096);
+  stream.next_in = const_cast<Bytef*>(in);
+  stream.avail_in = static_cast<uInt>(in_size);
+  size_t produced = 0;
+  int result = Z_OK;
+  while (true) {
+    if (produced == out->size()) {
+      if (expected > 0) {
+        break;
+      }
+      out->resize(out->size() * 2);
+    }
+    stream.next_out = out->data() + produced;
+    stream.avail_out = static_cast<uInt>(out->size() - produced);
+    result = inflate(&stream, Z_NO_FLUSH);
+    produced = out->size() - stream.avail_out;
+    if (result != Z_OK) {
+      break;
+    }
+  }
+  inflateEnd(&stream);
+  out->resize(produced);
+  return produced > 0 || result == Z_STREAM_END;
+}
+
+template <typename T>
+bool ReadAt(const MappedFile& file, size_t* offset, T* value) {
+  if (file.size() - *offset < sizeof(T)) {
+    return false;
+  }
+  std::memcpy(value, file.data() + *offset, sizeof(T));
+  *offset += sizeof(T);
+  return true;
+}
+
+}  // namespace
+
+LogQueryCursor::LogQueryCursor(const std::string& directory,
+                               const LogQuery& query)
+    : directory_(directory),
+      query_(query),
+      level_mask_(0x3fu & ~((1u << static_cast<uint32_t>(query.min_level)) -
+                            1)) {}
+
+LogQueryCursor::~LogQueryCursor() = default;
+
+bool LogQueryCursor::Next(LogEntry* entry) {
+  while (true) {
+    if (!parser_ && !LoadNextSpan()) {
+      return false;
+    }
+    LogRecordView record;
+    if (!parser_->Next(&record)) {
+      parser_.reset();
+      continue;
+    }
+    stats_.records_scanned++;
+    const LogRecordHeader& header = record.header;
+    if (header.timestamp_us < query_.from_us ||
+        header.timestamp_us > query_.to_us ||
+        (level_mask_ & (1u << header.level)) == 0 ||
+        (!query_.subsystems.empty() && !SubsystemMatches(header.subsystem_id))) {
+      continue;
+    }
+
+    auto format = definitions_.find(header.format_id);
+    std::string message = RenderLogMessage(
+        format != definitions_.end() ? format->second : std::string(), record);
+    if (!query_.text.empty() && message.find(query_.text) == std::string::npos) {
+      continue;
+    }
+
+    entry->timestamp_us = header.timestamp_us;
+    entry->level = static_cast<LogLevel>(header.level);
+    entry->thread_id = header.thread_id;
+    entry->truncated = (header.flags & kLogFlagTruncated) != 0;
+    auto subsystem = definitions_.find(header.subsystem_id);
+    if (subsystem != definitions_.end()) {
+      entry->subsystem = subsystem->second;
+    } else {
+      entry->subsystem.clear();
+    }
+    entry->message = std::move(message);
+    stats_.records_matched++;
+    return true;
+  }
+}
+
+void LogQueryCursor::ListSegments() {
+  listed_ = true;
+  DIR* dir = ::opendir(directory_.c_str());
+  if (dir == nullptr) {
+    return;
+  }
+  bool has_current = false;
+  while (struct dirent* entry = ::readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name == kCurrentSegment) {
+      has_current = true;
+    } else if (name.compare(0, sizeof(kArchivePrefix) - 1, kArchivePrefix) ==
+                   0 &&
+               (EndsWith(name, ".sslog.gz") || EndsWith(name, ".sslog"))) {
+      segment_paths_.push_back(name);
+    }
+  }
+  ::closedir(dir);
+  // Archive names start with the segment's UTC start time.
+  std::sort(segment_paths_.begin(), segment_paths_.end());
+  if (has_current) {
+    segment_paths_.push_back(kCurrentSegment);
+  }
+}
+
+bool LogQueryCursor::OpenNextSegment() {
+  if (!listed_) {
+    ListSegments();
+  }
+  while (next_segment_ < segment_paths_.size()) {
+    std::string path = directory_ + "/" + segment_paths_[next_segment_++];
+    stats_.segments++;
+    parser_.reset();
+    file_.Close();
+    definitions_.clear();
+    subsystem_matches_.clear();
+    spans_.clear();
+    next_span_ = 0;
+    compressed_ = EndsWith(path, ".gz");
+    indexed_ = compressed_ && PlanIndexedSegment(LogIndexPathFor(path));
+    if (indexed_ && spans_.empty()) {
+      stats_.segments_skipped++;
+      continue;
+    }
+    if (!file_.Open(path)) {
+      continue;
+    }
+    if (!indexed_) {
+      spans_.push_back({0, UINT64_MAX, 0, file_.size()});
+    }
+    return true;
+  }
+  return false;
+}
+
+bool LogQueryCursor::PlanIndexedSegment(const std::string& index_path) {
+  MappedFile index;
+  LogIndexHeader header;
+  size_t offset = 0;
+  if (!index.Open(index_path) || !ReadAt(index, &offset, &header) ||
+      std::memcmp(header.magic, kLogIndexMagic, sizeof(header.magic)) != 0 ||
+      header.version != kLogIndexVersion) {
+    return false;
+  }
+  if (header.block_count == 0 || header.last_us < query_.from_us ||
+      header.first_us > query_.to_us ||
+      (header.level_mask & level_mask_) == 0) {
+    return true;
+  }
+
+  std::vector<LogIndexBlock> blocks(header.block_count);
+  for (LogIndexBlock& block : blocks) {
+    if (!ReadAt(index, &offset, &block)) {
+      return false;
+    }
+  }
+  std::vector<uint32_t> subsystems(header.subsystem_count);
+  for (uint32_t& id : subsystems) {
+    if (!ReadAt(index, &offset, &id)) {
+      return false;
+    }
+  }
+  for (uint32_t i = 0; i < header.definition_count; i++) {
+    uint32_t id;
+    uint16_t length;
+    if (!ReadAt(index, &offset, &id) || !ReadAt(index, &offset, &length) ||
+        index.size() - offset < length) {
+      return false;
+    }
+    definitions_[id].assign(
+        reinterpret_cast<const char*>(index.data() + offset), length);
+    offset += length;
+  }
+
+  uint64_t wanted_bloom = ~uint64_t{0};
+  if (!query_.subsystems.empty()) {
+    wanted_bloom = 0;
+    for (uint32_t id : subsystems) {
+      if (SubsystemMatches(id)) {
+        wanted_bloom |= LogSubsystemBloomBit(id);
+      }
+    }
+    if (wanted_bloom == 0) {
+      return true;
+    }
+  }
+
+  for (size_t i = 0; i < blocks.size(); i++) {
+    const LogIndexBlock& block = blocks[i];
+    if (block.last_us < query_.from_us || block.first_us > query_.to_us ||
+        (block.level_mask & level_mask_) == 0 ||
+        (block.subsystem_bloom & wanted_bloom) == 0) {
+      stats_.blocks_skipped++;
+      continue;
+    }
+    uint64_t raw_end =
+        i + 1 < blocks.size() ? blocks[i + 1].raw_offset : header.raw_bytes;
+    uint64_t compressed_end = i + 1 < blocks.size()
+                                  ? blocks[i + 1].compressed_offset
+                                  : UINT64_MAX;
+    // Neighbouring blocks are inflated in one pass.
+    if (!spans_.empty() && spans_.back().raw_end == block.raw_offset) {
+      spans_.back().raw_end = raw_end;
+      spans_.back().compressed_end = compressed_end;
+    } else {
+      spans_.push_back(
+          {block.raw_offset, raw_end, block.compressed_offset, compressed_end});
+    }
+  }
+  return true;
+}
+
+bool LogQueryCursor::LoadNextSpan() {
+  while (true) {
+    if (next_span_ >= spans_.size() && !OpenNextSegment()) {
+      return false;
+    }
+    const Span span = spans_[next_span_++];
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    if (indexed_) {
+      uint64_t compressed_end =
+          std::min<uint64_t>(span.compressed_end, file_.size());
+      if (span.compressed_offset >= compressed_end ||
+          !Inflate(file_.data() + span.compressed_offset,
+                   compressed_end - span.compressed_offset, -MAX_WBITS,
+                   span.raw_end - span.raw_offset, &inflated_)) {
+        continue;
+      }
+      stats_.blocks_inflated++;
+      data = inflated_.data();
+      size = inflated_.size();
+    } else {
+      if (compressed_) {
+        // 32 lets zlib detect the gzip header.
+        if (!Inflate(file_.data(), file_.size(), MAX_WBITS + 32, 0,
+                     &inflated_)) {
+          continue;
+        }
+        data = inflated_.data();
+        size = inflated_.size();
+      } else {
+        file_.AdviseSequential();
+        data = file_.data();
+        size = file_.size();
+      }
+      LogSegmentHeader header;
+      if (!ReadLogSegmentHeader(data, size, &header) ||
+          header.start_time_us > query_.to_us) {
+        continue;
+      }
+      data += sizeof(header);
+      size -= sizeof(header);
+    }
+    parser_ = std::make_unique<LogSegmentParser>(data, size, &definitions_);
+    return true;
+  }
+}
+
+bool LogQueryCursor::SubsystemMatches(uint32_t id) {
+  auto cached = subsystem_matches_.find(id);
+  if (cached != subsystem_matches_.end()) {
+    return cached->second;
+  }
+  auto name = definitions_.find(id);
+  bool matches =
+      name != definitions_.end() &&
+      std::find(query_.subsystems.begin(), query_.subsystems.end(),
+                name->second) != query_.subsystems.end();
+  subsystem_matches_[id] = matches;
+  return matches;
+}
@@ -0,0 +1,99 @@
+#ifndef NATIVE_LOGGING_LOG_QUERY_H_
+#define NATIVE_LOGGING_LOG_QUERY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/mapped_file.h"
+#include "logging/log_reader.h"
+#include "logging/log_record.h"
+
+struct LogQuery {
+  uint64_t from_us = 0;  // Inclusive, microseconds since the epoch.
+  uint64_t to_us = UINT64_MAX;  // Inclusive.
+  LogLevel min_level = LogLevel::kTrace;
+  std::vector<std::string> subsystems;  // Empty matches every subsystem.
+  std::string text;  // Substring of the rendered message; empty matches all.
+};
+
+struct LogEntry {
+  uint64_t timestamp_us = 0;
+  LogLevel level = LogLevel::kInfo;
+  uint32_t thread_id = 0;
+  bool truncated = false;
+  std::string subsystem;
+  std::string message;
+};
+
+struct LogQueryStats {
+  uint32_t segments = 0;
+  uint32_t segments_skipped = 0;  // Ruled out by their index alone.
+  uint32_t blocks_inflated = 0;
+  uint32_t blocks_skipped = 0;
+  uint64_t records_scanned = 0;
+  uint64_t records_matched = 0;
+};
+
+// Streams the records of a log directory that match a LogQuery, oldest
+// segment first.
+//
+// Files are memory-mapped. Archived segments are checked against their
+// sparse index first: a segment whose time range, levels or subsystems
+// cannot match is never opened, and inside a matching segment only the
+// blocks that can match are inflated. Segments without an index (older
+// archives, the live current.sslog) are scanned in full.
+class LogQueryCursor {
+ public:
+  LogQueryCursor(const std::string& directory, const LogQuery& query);
+  ~LogQueryCursor();
+
+  LogQueryCursor(const LogQueryCursor&) = delete;
+  LogQueryCursor& operator=(const LogQueryCursor&) = delete;
+
+  // Fills |entry| with the next match. Returns false when there are no more.
+  bool Next(LogEntry* entry);
+
+  const LogQueryStats& stats() const { return stats_; }
+
+ private:
+  // A byte range of the current segment to parse. For indexed archives it
+  // is one block; otherwise it covers the whole segment.
+  struct Span {
+    uint64_t raw_offset;
+    uint64_t raw_end;
+    uint64_t compressed_offset;
+    uint64_t compressed_end;
+  };
+
+  void ListSegments();
+  bool OpenNextSegment();
+  bool PlanIndexedSegment(const std::string& index_path);
+  bool LoadNextSpan();
+  bool SubsystemMatches(uint32_t id);
+
+  const std::string directory_;
+  const LogQuery query_;
+  const uint32_t level_mask_;
+
+  std::vector<std::string> segment_paths_;
+  size_t next_segment_ = 0;
+  bool listed_ = false;
+
+  MappedFile file_;
+  bool compressed_ = false;
+  bool indexed_ = false;
+  LogDefinitions definitions_;
+  std::unordered_map<uint32_t, bool> subsystem_matches_;
+  std::vector<Span> spans_;
+  size_t next_span_ = 0;
+  std::vector<uint8_t> inflated_;
+  std::unique_ptr<LogSegmentParser> parser_;
+
+  LogQueryStats stats_;
+};
+
+#endif  // NATIVE_LOGGING_LOG_QUERY_H_
@@ -0,0 +1,173 @@
+#include "logging/log_reader.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// Reads one argument at |*cursor|, appending its text to |out|. Returns
+// false if the argument runs past |end|.
+bool AppendArg(const uint8_t** cursor, const uint8_t* end, std::string* out) {
+  const uint8_t* in = *cursor;
+  if (in >= end) {
+    return false;
+  }
+  LogArgType type = static_cast<LogArgType>(*in++);
+  char number[32];
+  switch (type) {
+    case LogArgType::kInt: {
+      if (end - in < 8) {
+        return false;
+      }
+      int64_t value;
+      std::memcpy(&value, in, 8);
+      snprintf(number, sizeof(number), "%" PRId64, value);
+      out->append(number);
+      in += 8;
+      break;
+    }
+    case LogArgType::kDouble: {
+      if (end - in < 8) {
+        return false;
+      }
+      double value;
+      std::memcpy(&value, in, 8);
+      snprintf(number, sizeof(number), "%g", value);
+      out->append(number);
+      in += 8;
+      break;
+    }
+    case LogArgType::kString: {
+      if (end - in < 2) {
+        return false;
+      }
+      uint16_t length;
+      std::memcpy(&length, in, 2);
+      in += 2;
+      if (end - in < length) {
+        return false;
+      }
+      out->append(reinterpret_cast<const char*>(in), length);
+      in += length;
+      break;
+    }
+    default:
+      return false;
+  }
+  *cursor = in;
+  return true;
+}
+
+}  // namespace
+
+LogSegmentParser::LogSegmentParser(const uint8_t* data, size_t size,
+                                   LogDefinitions* definitions)
+    : data_(data), size_(size), definitions_(definitions) {}
+
+bool LogSegmentParser::Next(LogRecordView* record) {
+  while (offset_ < size_) {
+    const uint8_t* entry = data_ + offset_;
+    size_t remaining = size_ - offset_;
+    switch (static_cast<LogEntryKind>(entry[0])) {
+      case LogEntryKind::kDefinition: {
+        if (remaining < 7) {
+          return false;
+        }
+        uint32_t id;
+        uint16_t length;
+        std::memcpy(&id, entry + 1, 4);
+        std::memcpy(&length, entry + 5, 2);
+        if (remaining < 7u + length) {
+          return false;
+        }
+        (*definitions_)[id].assign(reinterpret_cast<const char*>(entry + 7),
+                                   length);
+        offset_ += 7u + length;
+        break;
+      }
+      case LogEntryKind::kRecord: {
+        if (remaining < 1 + sizeof(LogRecordHeader)) {
+          return false;
+        }
+        std::memcpy(&record->header, entry + 1, sizeof(LogRecordHeader));
+        size_t total = 1 + sizeof(LogRecordHeader) + record->header.payload_size;
+        if (remaining < total) {
+          return false;
+        }
+        record->payload = entry + 1 + sizeof(LogRecordHeader);
+        offset_ += total;
+        return true;
+      }
+      default:
+        corrupt_ = true;
+        return false;
+    }
+  }
+  return false;
+}
+
+bool ReadLogSegmentHeader(const uint8_t* data, size_t size,
+                          LogSegmentHeader* header) {
+  if (size < sizeof(LogSegmentHeader)) {
+    return false;
+  }
+  std::memcpy(header, data, sizeof(LogSegmentHeader));
+  return std::memcmp(header->magic, kLogSegmentMagic, sizeof(header->magic)) ==
+             0 &&
+         header->version == kLogFormatVersion;
+}
+
+std::string RenderLogMessage(const std::string& format,
+                             const LogRecordView& record) {
+  std::string out;
+  out.reserve(format.size() + record.header.payload_size);
+  const uint8_t* cursor = record.payload;
+  const uint8_t* end = record.payload + record.header.payload_size;
+  int remaining_args = record.header.arg_count;
+
+  size_t position = 0;
+  while (position < format.size()) {
+    size_t placeholder = format.find("{}", position);
+    if (placeholder == std::string::npos) {
+      out.append(format, position, std::string::npos);
+      break;
+    }
+    out.append(format, position, placeholder - position);
+    position = placeholder + 2;
+    if (remaining_args > 0 && AppendArg(&cursor, end, &out)) {
+      remaining_args--;
+    } else {
+      remaining_args = 0;
+      out.append("{}");
+    }
+  }
+  while (remaining_args-- > 0) {
+    out.push_back(' ');
+    if (!AppendArg(&cursor, end, &out)) {
+      break;
+    }
+  }
+  if (record.header.flags & kLogFlagTruncated) {
+    out.append(" [truncated]");
+  }
+  return out;
+}
+
+const char* LogLevelName(LogLevel level) {
+  switch (level) {
+    case LogLevel::kTrace:
+      return "TRACE";
+    case LogLevel::kDebug:
+      return "DEBUG";
+    case LogLevel::kInfo:
+      return "INFO";
+    case LogLevel::kWarning:
+      return "WARN";
+    case LogLevel::kError:
+      return "ERROR";
+    case LogLevel::kFatal:
+      return "FATAL";
+  }
+  return "?";
+}
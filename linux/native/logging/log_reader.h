@@ -0,0 +1,63 @@
+#ifndef NATIVE_LOGGING_LOG_READER_H_
+#define NATIVE_LOGGING_LOG_READER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "logging/log_record.h"
+
+// Format and subsystem strings of one segment, keyed by interned id. Ids are
+// only meaningful within the segment that defined them.
+using LogDefinitions = std::unordered_map<uint32_t, std::string>;
+
+// A record as it sits in segment bytes. |payload| points into the parsed
+// buffer and is valid as long as that buffer is.
+struct LogRecordView {
+  LogRecordHeader header;
+  const uint8_t* payload = nullptr;
+};
+
+// Walks the entries of a segment, or of any slice of one that starts on an
+// entry boundary.
+//
+// Definitions are added to |definitions| as they pass, so a parser started
+// mid-segment needs the table from the segment's index. Parsing stops
+// cleanly at a partially written trailing entry, which is what the live
+// segment usually ends with.
+class LogSegmentParser {
+ public:
+  LogSegmentParser(const uint8_t* data, size_t size,
+                   LogDefinitions* definitions);
+
+  // Returns the next record, or false at the end of the data.
+  bool Next(LogRecordView* record);
+
+  // Offset of the next unread entry.
+  size_t offset() const { return offset_; }
+
+  // True if parsing stopped at bytes that are not a valid entry.
+  bool corrupt() const { return corrupt_; }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_ = 0;
+  LogDefinitions* definitions_;
+  bool corrupt_ = false;
+};
+
+// Checks the segment header at the start of |data|.
+bool ReadLogSegmentHeader(const uint8_t* data, size_t size,
+                          LogSegmentHeader* header);
+
+// Substitutes the record's arguments into |format| in place of each "{}".
+// Arguments left over after the last placeholder are appended, separated
+// by spaces, so nothing logged is lost to a mismatched format.
+std::string RenderLogMessage(const std::string& format,
+                             const LogRecordView& record);
+
+const char* LogLevelName(LogLevel level);
+
+#endif  // NATIVE_LOGGING_LOG_READER_H_
@@ -0,0 +1,66 @@
+#ifndef NATIVE_LOGGING_LOG_RECORD_H_
+#define NATIVE_LOGGING_LOG_RECORD_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// Binary log format shared by the writer (logger.cc) and readers.
+//
+// A segment file is a SegmentHeader followed by entries. Each entry starts
+// with a one-byte LogEntryKind:
+//   kDefinition: uint32 id, uint16 length, UTF-8 text. Emitted the first time
+//                a format or subsystem id is used in a segment, so every
+//                segment can be decoded on its own.
+//   kRecord:     LogRecordHeader followed by |payload_size| bytes of
+//                arguments.
+// An argument is a LogArgType byte followed by an int64, a double, or a
+// uint16 length and that many UTF-8 bytes. Integers are little-endian.
+
+enum class LogLevel : uint8_t {
+  kTrace = 0,
+  kDebug = 1,
+  kInfo = 2,
+  kWarning = 3,
+  kError = 4,
+  kFatal = 5,
+};
+
+enum class LogEntryKind : uint8_t {
+  kRecord = 'R',
+  kDefinition = 'D',
+};
+
+enum class LogArgType : uint8_t {
+  kInt = 1,
+  kDouble = 2,
+  kString = 3,
+};
+
+// Set in LogRecordHeader::flags when a string argument was cut short.
+constexpr uint8_t kLogFlagTruncated = 1 << 0;
+
+constexpr char kLogSegmentMagic[8] = {'S', 'S', 'L', 'O', 'G', '0', '0', '1'};
+constexpr uint32_t kLogFormatVersion = 1;
+
+#pragma pack(push, 1)
+struct LogSegmentHeader {
+  char magic[8];
+  uint32_t version;
+  uint64_t start_time_us;
+};
+
+struct LogRecordHeader {
+  uint64_t timestamp_us;  // Wall clock, microseconds since the epoch.
+  uint32_t format_id;
+  uint16_t subsystem_id;
+  uint16_t payload_size;
+  uint32_t thread_id;
+  uint8_t level;
+  uint8_t arg_count;
+  uint8_t flags;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(LogRecordHeader) == 23, "LogRecordHeader is packed");
+
+#endif  // NATIVE_LOGGING_LOG_RECORD_H_
@@ -0,0 +1,72 @@
+#include "logging/log_ring.h"
+
+namespace {
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+}  // namespace
+
+LogRing::LogRing(size_t capacity)
+    : mask_(RoundUpToPowerOfTwo(capacity < 2 ? 2 : capacity) - 1),
+      slots_(new Slot[mask_ + 1]) {
+  for (size_t i = 0; i <= mask_; i++) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+    slots_[i].size = 0;
+  }
+}
+
+uint8_t* LogRing::BeginPush(uint64_t* ticket) {
+  uint64_t position = enqueue_position_.load(std::memory_order_relaxed);
+  while (true) {
+    Slot& slot = slots_[position & mask_];
+    uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    int64_t difference =
+        static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+    if (difference == 0) {
+      if (enqueue_position_.compare_exchange_weak(
+              position, position + 1, std::memory_order_relaxed)) {
+        *ticket = position;
+        return slot.bytes;
+      }
+    } else if (difference < 0) {
+      return nullptr;  // Full: the consumer has not freed this slot yet.
+    } else {
+      position = enqueue_position_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void LogRing::CommitPush(uint64_t ticket, size_t size) {
+  Slot& slot = slots_[ticket & mask_];
+  slot.size = static_cast<uint32_t>(size);
+  slot.sequence.store(ticket + 1, std::memory_order_release);
+}
+
+const uint8_t* LogRing::Peek(size_t* size) {
+  Slot& slot = slots_[dequeue_position_ & mask_];
+  uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+  if (sequence != dequeue_position_ + 1) {
+    return nullptr;
+  }
+  *size = slot.size;
+  return slot.bytes;
+}
+
+void LogRing::Pop() {
+  Slot& slot = slots_[dequeue_position_ & mask_];
+  slot.sequence.store(dequeue_position_ + mask_ + 1,
+                      std::memory_order_release);
+  dequeue_position_++;
+}
+
+bool LogRing::Empty() const {
+  const Slot& slot = slots_[dequeue_position_ & mask_];
+  return slot.sequence.load(std::memory_order_acquire) !=
+         dequeue_position_ + 1;
+}
@@ -0,0 +1,54 @@
+#ifndef NATIVE_LOGGING_LOG_RING_H_
+#define NATIVE_LOGGING_LOG_RING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bounded lock-free multi-producer, single-consumer queue of fixed-size
+// slots (Vyukov's sequence-numbered ring).
+//
+// Producers claim a slot with one compare-and-swap, fill it in place and
+// publish it; they never block and never allocate. When the ring is full the
+// record is rejected and the caller counts it as dropped.
+class LogRing {
+ public:
+  static constexpr size_t kSlotBytes = 488;
+
+  // |capacity| is rounded up to a power of two.
+  explicit LogRing(size_t capacity);
+
+  LogRing(const LogRing&) = delete;
+  LogRing& operator=(const LogRing&) = delete;
+
+  // Claims a slot. Returns its buffer of kSlotBytes bytes, or null when the
+  // ring is full.
+  uint8_t* BeginPush(uint64_t* ticket);
+
+  // Publishes a slot claimed by BeginPush() holding |size| bytes.
+  void CommitPush(uint64_t ticket, size_t size);
+
+  // Consumer side: returns the oldest published slot or null.
+  const uint8_t* Peek(size_t* size);
+
+  // Releases the slot returned by Peek() back to producers.
+  void Pop();
+
+  bool Empty() const;
+  size_t capacity() const { return mask_ + 1; }
+
+ private:
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> sequence;
+    uint32_t size;
+    uint8_t bytes[kSlotBytes];
+  };
+
+  const size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  alignas(64) std::atomic<uint64_t> enqueue_position_{0};
+  alignas(64) uint64_t dequeue_position_ = 0;
+};
+
+#endif  // NATIVE_LOGGING_LOG_RING_H_
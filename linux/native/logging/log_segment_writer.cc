@@ -0,0 +1,216 @@
+#include "logging/log_segment_writer.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include "logging/log_archive.h"
+#include "logging/log_record.h"
+
+namespace {
+
+constexpr size_t kBufferBytes = 64 * 1024;
+constexpr char kArchivePrefix[] = "log-";
+constexpr char kArchiveSuffix[] = ".sslog.gz";
+
+bool EndsWith(const std::string& value, const std::string& suffix) {
+  return value.size() >= suffix.size() &&
+         value.compare(value.size() - suffix.size(), suffix.size(), suffix) ==
+             0;
+}
+
+bool WriteAll(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t written = ::write(fd, data, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    size -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+// Reads the start time from a segment header, or returns 0.
+uint64_t ReadSegmentStart(const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return 0;
+  }
+  LogSegmentHeader header;
+  ssize_t got = ::read(fd, &header, sizeof(header));
+  ::close(fd);
+  if (got != static_cast<ssize_t>(sizeof(header)) ||
+      std::memcmp(header.magic, kLogSegmentMagic, sizeof(header.magic)) != 0) {
+    return 0;
+  }
+  return header.start_time_us;
+}
+
+}  // namespace
+
+LogSegmentWriter::LogSegmentWriter(const std::string& directory,
+                                   const LogRotationPolicy& policy)
+    : directory_(directory),
+      current_path_(directory + "/current.sslog"),
+      policy_(policy) {
+  buffer_.reserve(kBufferBytes);
+}
+
+LogSegmentWriter::~LogSegmentWriter() {
+  Close();
+}
+
+bool LogSegmentWriter::Open(uint64_t now_us) {
+  ::mkdir(directory_.c_str(), 0755);
+  struct stat info;
+  if (::stat(current_path_.c_str(), &info) == 0) {
+    uint64_t start_us = ReadSegmentStart(current_path_);
+    ArchiveFile(current_path_, start_us != 0 ? start_us : now_us);
+    EnforceRetention();
+  }
+  return StartSegment(now_us);
+}
+
+bool LogSegmentWriter::StartSegment(uint64_t now_us) {
+  fd_ = ::open(current_path_.c_str(),
+               O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    return false;
+  }
+  LogSegmentHeader header;
+  std::memcpy(header.magic, kLogSegmentMagic, sizeof(header.magic));
+  header.version = kLogFormatVersion;
+  header.start_time_us = now_us;
+  segment_bytes_ = 0;
+  segment_start_us_ = now_us;
+  fresh_segment_ = true;
+  return Append(&header, sizeof(header));
+}
+
+bool LogSegmentWriter::Append(const void* data, size_t size) {
+  if (fd_ < 0) {
+    return false;
+  }
+  if (buffer_.size() + size > kBufferBytes && !Flush()) {
+    return false;
+  }
+  const char* bytes = static_cast<const char*>(data);
+  buffer_.insert(buffer_.end(), bytes, bytes + size);
+  segment_bytes_ += size;
+  bytes_written_ += size;
+  return true;
+}
+
+bool LogSegmentWriter::Flush() {
+  if (fd_ < 0 || buffer_.empty()) {
+    return fd_ >= 0;
+  }
+  bool ok = WriteAll(fd_, buffer_.data(), buffer_.size());
+  buffer_.clear();
+  return ok;
+}
+
+void LogSegmentWriter::Close() {
+  if (fd_ < 0) {
+    return;
+  }
+  Flush();
+  ::close(fd_);
+  fd_ = -1;
+}
+
+bool LogSegmentWriter::ShouldRotate(uint64_t now_us) const {
+  // Never archive a segment that holds nothing but its header.
+  if (fd_ < 0 || segment_bytes_ <= sizeof(LogSegmentHeader)) {
+    return false;
+  }
+  return segment_bytes_ >= policy_.max_segment_bytes ||
+         now_us - segment_start_us_ >= policy_.max_segment_age_us;
+}
+
+bool LogSegmentWriter::Rotate(uint64_t now_us) {
+  uint64_t start_us = segment_start_us_;
+  Close();
+  ArchiveFile(current_path_, start_us);
+  EnforceRetention();
+  segments_rotated_++;
+  return StartSegment(now_us);
+}
+
+void LogSegmentWriter::ArchiveFile(const std::string& raw_path,
+                                   uint64_t start_us) {
+  time_t seconds = static_cast<time_t>(start_us / 1000000);
+  struct tm utc;
+  gmtime_r(&seconds, &utc);
+  char stamp[32];
+  strftime(stamp, sizeof(stamp), "%Y%m%dT%H%M%SZ", &utc);
+  char name[96];
+  // The sequence keeps names unique when segments rotate within a second;
+  // names sort by start time, which retention relies on.
+  snprintf(name, sizeof(name), "%s%s-%04u", kArchivePrefix, stamp,
+           archive_sequence_++ % 10000);
+  std::string archived = directory_ + "/" + name + ".sslog";
+  if (std::rename(raw_path.c_str(), archived.c_str()) != 0) {
+    return;
+  }
+
+  // gzip with a sparse index; zlib already ships with the runtime. If that
+  // fails the raw segment stays archived as is.
+  std::string compressed = archived + ".gz";
+  if (ArchiveLogSegment(archived, compressed)) {
+    ::unlink(archived.c_str());
+  }
+}
+
+void LogSegmentWriter::EnforceRetention() {
+  DIR* dir = ::opendir(directory_.c_str());
+  if (dir == nullptr) {
+    return;
+  }
+  struct Archived {
+    std::string name;
+    uint64_t size;
+  };
+  std::vector<Archived> archives;
+  while (struct dirent* entry = ::readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name.compare(0, sizeof(kArchivePrefix) - 1, kArchivePrefix) != 0 ||
+        !(EndsWith(name, kArchiveSuffix) || EndsWith(name, ".sslog"))) {
+      continue;
+    }
+    struct stat info;
+    std::string path = directory_ + "/" + name;
+    if (::stat(path.c_str(), &info) == 0) {
+      archives.push_back({name, static_cast<uint64_t>(info.st_size)});
+    }
+  }
+  ::closedir(dir);
+
+  std::sort(archives.begin(), archives.end(),
+            [](const Archived& a, const Archived& b) { return a.name < b.name; });
+  uint64_t total = 0;
+  for (const Archived& archive : archives) {
+    total += archive.size;
+  }
+  size_t index = 0;
+  while (index < archives.size() &&
+         (archives.size() - index > policy_.max_archived_segments ||
+          total > policy_.max_archive_bytes)) {
+    std::string path = directory_ + "/" + archives[index].name;
+    ::unlink(path.c_str());
+    ::unlink(LogIndexPathFor(path).c_str());
+    total -= archives[index].size;
+    index++;
+  }
+}
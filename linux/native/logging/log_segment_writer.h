@@ -0,0 +1,74 @@
+#ifndef NATIVE_LOGGING_LOG_SEGMENT_WRITER_H_
+#define NATIVE_LOGGING_LOG_SEGMENT_WRITER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct LogRotationPolicy {
+  uint64_t max_segment_bytes = 4 * 1024 * 1024;
+  uint64_t max_segment_age_us = 24ull * 3600 * 1000000;
+  uint32_t max_archived_segments = 32;
+  uint64_t max_archive_bytes = 64 * 1024 * 1024;
+};
+
+// Owns the active log segment and the archive of rotated ones.
+//
+// The active segment is "<dir>/current.sslog". On rotation it is renamed to
+// "<dir>/log-<start>-<seq>.sslog", gzip-compressed next to itself with a
+// sparse index (log_index.h) and the raw copy removed; the archive is then
+// trimmed to the retention limits.
+// Only the logger's writer thread touches this class.
+class LogSegmentWriter {
+ public:
+  LogSegmentWriter(const std::string& directory,
+                   const LogRotationPolicy& policy);
+  ~LogSegmentWriter();
+
+  LogSegmentWriter(const LogSegmentWriter&) = delete;
+  LogSegmentWriter& operator=(const LogSegmentWriter&) = delete;
+
+  // Archives a segment left over from a previous run and starts a new one.
+  bool Open(uint64_t now_us);
+
+  bool Append(const void* data, size_t size);
+  bool Flush();
+  void Close();
+
+  // True when the active segment has reached its size or age limit.
+  bool ShouldRotate(uint64_t now_us) const;
+
+  // Closes, archives and compresses the active segment and starts a new one.
+  // Returns true if a new segment was started.
+  bool Rotate(uint64_t now_us);
+
+  // True right after a new segment was started, until the caller has
+  // re-emitted its definitions. Cleared by ClearFreshSegment().
+  bool fresh_segment() const { return fresh_segment_; }
+  void ClearFreshSegment() { fresh_segment_ = false; }
+
+  bool has_buffered_data() const { return !buffer_.empty(); }
+  uint64_t segment_start_us() const { return segment_start_us_; }
+  uint64_t bytes_written() const { return bytes_written_; }
+  uint32_t segments_rotated() const { return segments_rotated_; }
+
+ private:
+  bool StartSegment(uint64_t now_us);
+  void ArchiveFile(const std::string& raw_path, uint64_t start_us);
+  void EnforceRetention();
+
+  const std::string directory_;
+  const std::string current_path_;
+  const LogRotationPolicy policy_;
+  int fd_ = -1;
+  std::vector<char> buffer_;
+  uint64_t segment_bytes_ = 0;
+  uint64_t segment_start_us_ = 0;
+  uint64_t bytes_written_ = 0;
+  uint32_t segments_rotated_ = 0;
+  uint32_t archive_sequence_ = 0;
+  bool fresh_segment_ = false;
+};
+
+#endif  // NATIVE_LOGGING_LOG_SEGMENT_WRITER_H_
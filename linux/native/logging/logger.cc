@@ -0,0 +1,359 @@
+#include "logging/logger.h"
+
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "common/thread_id.h"
+#include "tracing/tracer.h"
+
+namespace {
+
+StringInterner& Interner() {
+  static StringInterner* interner = new StringInterner();
+  return *interner;
+}
+
+uint64_t NowMicros() {
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+}
+
+// Shortens |length| so that it does not end inside a UTF-8 sequence.
+size_t TrimToUtf8Boundary(const char* text, size_t length) {
+  while (length > 0 &&
+         (static_cast<unsigned char>(text[length]) & 0xC0) == 0x80) {
+    length--;
+  }
+  return length;
+}
+
+}  // namespace
+
+Logger& Logger::Get() {
+  // Leaked on purpose so that logging from static destructors stays safe.
+  static Logger* logger = new Logger();
+  return *logger;
+}
+
+uint32_t Logger::Intern(const std::string& text) {
+  return Interner().Intern(text);
+}
+
+bool Logger::LookupString(uint32_t id, std::string* text) {
+  return Interner().Lookup(id, text);
+}
+
+Logger::Logger() : ring_(kRingSlots) {
+  for (auto& counter : oversized_counters_) {
+    counter.store(0, std::memory_order_relaxed);
+  }
+}
+
+Logger::~Logger() {
+  Close();
+}
+
+bool Logger::Open(const LoggerConfig& config) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (open_.load() || config.directory.empty()) {
+    return false;
+  }
+  segments_ =
+      std::make_unique<LogSegmentWriter>(config.directory, config.rotation);
+  if (!segments_->Open(NowMicros())) {
+    segments_.reset();
+    return false;
+  }
+  config_ = config;
+  max_string_bytes_ = std::max<uint32_t>(config.max_string_bytes, 16);
+  oversized_sample_every_ =
+      std::max<uint32_t>(config.oversized_sample_every, 1);
+  min_level_.store(static_cast<uint8_t>(config.min_level));
+  stop_requested_ = false;
+  defined_ids_.clear();
+  writer_ = std::thread(&Logger::Run, this);
+  open_.store(true, std::memory_order_release);
+  return true;
+}
+
+void Logger::Close() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!open_.load()) {
+      return;
+    }
+    open_.store(false, std::memory_order_release);
+    stop_requested_ = true;
+    wake_.notify_one();
+    flushed_.notify_all();
+  }
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+  segments_.reset();
+}
+
+void Logger::Log(LogLevel level, uint32_t subsystem_id, uint32_t format_id,
+                 const LogArg* args, size_t count) {
+  if (!IsEnabled(level)) {
+    return;
+  }
+
+  bool oversized = false;
+  for (size_t i = 0; i < count; i++) {
+    if (args[i].type == LogArgType::kString &&
+        args[i].string_length > max_string_bytes_) {
+      oversized = true;
+      break;
+    }
+  }
+  // Warnings and errors are always kept, just truncated.
+  if (oversized && oversized_sample_every_ > 1 && level < LogLevel::kWarning) {
+    uint32_t seen = oversized_counters_[format_id & 0xff].fetch_add(
+        1, std::memory_order_relaxed);
+    if (seen % oversized_sample_every_ != 0) {
+      records_sampled_out_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  }
+
+  uint64_t ticket;
+  uint8_t* slot = ring_.BeginPush(&ticket);
+  if (slot == nullptr) {
+    records_dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  LogRecordHeader header;
+  header.timestamp_us = NowMicros();
+  header.format_id = format_id;
+  header.subsystem_id = static_cast<uint16_t>(subsystem_id);
+  header.thread_id = CurrentThreadId();
+  header.level = static_cast<uint8_t>(level);
+  header.arg_count = 0;
+  header.flags = 0;
+
+  uint8_t* out = slot + sizeof(header);
+  uint8_t* const end = slot + LogRing::kSlotBytes;
+  for (size_t i = 0; i < count && header.arg_count < 255; i++) {
+    const LogArg& arg = args[i];
+    if (arg.type == LogArgType::kString) {
+      if (end - out < 3) {
+        header.flags |= kLogFlagTruncated;
+        break;
+      }
+      size_t length = arg.string_length;
+      size_t room = static_cast<size_t>(end - out) - 3;
+      size_t limit = std::min<size_t>(max_string_bytes_, room);
+      if (length > limit) {
+        length = TrimToUtf8Boundary(arg.string_value, limit);
+        header.flags |= kLogFlagTruncated;
+      }
+      uint16_t length16 = static_cast<uint16_t>(length);
+      *out++ = static_cast<uint8_t>(LogArgType::kString);
+      std::memcpy(out, &length16, sizeof(length16));
+      out += sizeof(length16);
+      if (length > 0) {
+        std::memcpy(out, arg.string_value, length);
+      }
+      out += length;
+    } else {
+      if (end - out < 9) {
+        header.flags |= kLogFlagTruncated;
+        break;
+      }
+      *out++ = static_cast<uint8_t>(arg.type);
+      if (arg.type == LogArgType::kInt) {
+        std::memcpy(out, &arg.int_value, 8);
+      } else {
+        std::memcpy(out, &arg.double_value, 8);
+      }
+      out += 8;
+    }
+    header.arg_count++;
+  }
+  if (header.flags & kLogFlagTruncated) {
+    records_truncated_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  size_t size = static_cast<size_t>(out - slot);
+  header.payload_size = static_cast<uint16_t>(size - sizeof(header));
+  std::memcpy(slot, &header, sizeof(header));
+  ring_.CommitPush(ticket, size);
+  WakeWriter(level, ticket);
+}
+
+void Logger::WakeWriter(LogLevel level, uint64_t ticket) {
+  // Pairs with the fence in Run(): either the writer sees this record before
+  // it goes to sleep, or this thread sees it sleeping and wakes it.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  bool sleeping = writer_sleeping_.load(std::memory_order_relaxed) &&
+                  writer_sleeping_.exchange(false);
+  // Errors are written out promptly, and a filling ring is drained before
+  // producers start dropping. Everything else waits for the flush interval.
+  bool urgent = level >= LogLevel::kError ||
+                (ticket & (ring_.capacity() / 2 - 1)) == 0;
+  if (urgent) {
+    urgent_.store(true, std::memory_order_relaxed);
+  }
+  if (sleeping || urgent) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    wake_.notify_one();
+  }
+}
+
+void Logger::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!open_.load()) {
+    return;
+  }
+  uint64_t target = ++flush_requests_;
+  wake_.notify_one();
+  flushed_.wait(lock, [this, target] {
+    return flush_completed_ >= target || !open_.load();
+  });
+}
+
+void Logger::WriteDefinition(LogSegmentWriter* segments, uint32_t id) {
+  if (id == 0 || !defined_ids_.insert(id).second) {
+    return;
+  }
+  std::string text;
+  if (!LookupString(id, &text)) {
+    return;
+  }
+  if (text.size() > UINT16_MAX) {
+    text.resize(UINT16_MAX);
+  }
+  uint8_t prefix[7];
+  prefix[0] = static_cast<uint8_t>(LogEntryKind::kDefinition);
+  uint16_t length = static_cast<uint16_t>(text.size());
+  std::memcpy(prefix + 1, &id, 4);
+  std::memcpy(prefix + 5, &length, 2);
+  segments->Append(prefix, sizeof(prefix));
+  segments->Append(text.data(), text.size());
+}
+
+bool Logger::DrainRing(LogSegmentWriter* segments) {
+  SS_TRACE_SCOPE("log", "drain ring");
+  bool saw_error = false;
+  size_t size;
+  while (const uint8_t* bytes = ring_.Peek(&size)) {
+    LogRecordHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (segments->ShouldRotate(header.timestamp_us)) {
+      segments->Rotate(header.timestamp_us);
+    }
+    if (segments->fresh_segment()) {
+      defined_ids_.clear();
+      segments->ClearFreshSegment();
+    }
+    WriteDefinition(segments, header.subsystem_id);
+    WriteDefinition(segments, header.format_id);
+    uint8_t kind = static_cast<uint8_t>(LogEntryKind::kRecord);
+    segments->Append(&kind, 1);
+    segments->Append(bytes, size);
+    ring_.Pop();
+    records_written_.fetch_add(1, std::memory_order_relaxed);
+    if (header.level >= static_cast<uint8_t>(LogLevel::kError)) {
+      saw_error = true;
+    }
+  }
+  return saw_error;
+}
+
+void Logger::Run() {
+  Tracer::Get().SetThreadName("log writer");
+  LogSegmentWriter* segments = segments_.get();
+  const auto flush_interval =
+      std::chrono::milliseconds(config_.flush_interval_ms);
+  auto last_flush = std::chrono::steady_clock::now();
+
+  while (true) {
+    uint64_t flush_target;
+    bool stopping;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      flush_target = flush_requests_;
+      stopping = stop_requested_;
+    }
+    urgent_.store(false, std::memory_order_relaxed);
+
+    bool saw_error = DrainRing(segments);
+    uint64_t now_us = NowMicros();
+    if (segments->ShouldRotate(now_us)) {
+      segments->Rotate(now_us);
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (saw_error || stopping || flush_target != flush_completed_ ||
+        now - last_flush >= flush_interval) {
+      segments->Flush();
+      last_flush = now;
+    }
+    bytes_written_.store(segments->bytes_written(), std::memory_order_relaxed);
+    segments_rotated_.store(segments->segments_rotated(),
+                            std::memory_order_relaxed);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (flush_completed_ != flush_target) {
+      flush_completed_ = flush_target;
+      flushed_.notify_all();
+    }
+    if (stopping) {
+      break;
+    }
+    if (!ring_.Empty() || stop_requested_ ||
+        flush_requests_ != flush_completed_) {
+      continue;
+    }
+
+    if (segments->has_buffered_data()) {
+      // Coalesce: wait out the rest of the flush interval unless something
+      // urgent arrives. Producers do not need to wake us for ordinary
+      // records in this state.
+      wake_.wait_until(lock, last_flush + flush_interval, [this] {
+        return stop_requested_ || flush_requests_ != flush_completed_ ||
+               urgent_.load(std::memory_order_relaxed);
+      });
+      continue;
+    }
+
+    // Nothing pending: sleep until a producer wakes us or the segment ages
+    // out. No periodic wakeups while the app is quiet.
+    writer_sleeping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!ring_.Empty()) {
+      writer_sleeping_.store(false, std::memory_order_relaxed);
+      continue;
+    }
+    uint64_t age_limit = config_.rotation.max_segment_age_us;
+    uint64_t age = now_us - segments->segment_start_us();
+    auto until_rotation =
+        std::chrono::microseconds(age < age_limit ? age_limit - age : 0);
+    wake_.wait_for(lock, until_rotation, [this] {
+      return stop_requested_ || flush_requests_ != flush_completed_ ||
+             !writer_sleeping_.load(std::memory_order_relaxed) ||
+             urgent_.load(std::memory_order_relaxed);
+    });
+    writer_sleeping_.store(false, std::memory_order_relaxed);
+  }
+
+  DrainRing(segments);
+  segments->Close();
+}
+
+LoggerStats Logger::stats() const {
+  LoggerStats stats;
+  stats.records_written = records_written_.load(std::memory_order_relaxed);
+  stats.records_dropped = records_dropped_.load(std::memory_order_relaxed);
+  stats.records_sampled_out =
+      records_sampled_out_.load(std::memory_order_relaxed);
+  stats.records_truncated = records_truncated_.load(std::memory_order_relaxed);
+  stats.bytes_written = bytes_written_.load(std::memory_order_relaxed);
+  stats.segments_rotated = segments_rotated_.load(std::memory_order_relaxed);
+  return stats;
+}
@@ -0,0 +1,171 @@
+#ifndef NATIVE_LOGGING_LOGGER_H_
+#define NATIVE_LOGGING_LOGGER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+#include "logging/log_record.h"
+#include "logging/log_ring.h"
+#include "logging/log_segment_writer.h"
+#include "logging/string_interner.h"
+
+// One argument of a structured log call. Strings are borrowed until Log()
+// returns.
+struct LogArg {
+  LogArgType type;
+  int64_t int_value = 0;
+  double double_value = 0;
+  const char* string_value = nullptr;
+  size_t string_length = 0;
+
+  LogArg() : type(LogArgType::kInt) {}
+  LogArg(int value) : type(LogArgType::kInt), int_value(value) {}
+  LogArg(int64_t value) : type(LogArgType::kInt), int_value(value) {}
+  LogArg(uint64_t value)
+      : type(LogArgType::kInt), int_value(static_cast<int64_t>(value)) {}
+  LogArg(double value) : type(LogArgType::kDouble), double_value(value) {}
+  LogArg(const char* value)
+      : type(LogArgType::kString),
+        string_value(value),
+        string_length(value ? std::char_traits<char>::length(value) : 0) {}
+  LogArg(const std::string& value)
+      : type(LogArgType::kString),
+        string_value(value.data()),
+        string_length(value.size()) {}
+  LogArg(LogArgType arg_type, int64_t i, double d, const char* s, size_t n)
+      : type(arg_type),
+        int_value(i),
+        double_value(d),
+        string_value(s),
+        string_length(n) {}
+};
+
+struct LoggerConfig {
+  std::string directory;
+  LogRotationPolicy rotation;
+  LogLevel min_level = LogLevel::kInfo;
+  // String arguments longer than this are cut and the record is flagged.
+  // A record never exceeds one ring slot either way.
+  uint32_t max_string_bytes = 384;
+  // Of the trace, debug and info records that needed truncation, keep one in
+  // this many per format. Large payloads tend to repeat (polling responses),
+  // so this bounds both CPU and disk when something logs bodies in a loop.
+  uint32_t oversized_sample_every = 8;
+  uint32_t flush_interval_ms = 1000;
+};
+
+struct LoggerStats {
+  uint64_t records_written = 0;
+  uint64_t records_dropped = 0;  // Ring was full.
+  uint64_t records_sampled_out = 0;
+  uint64_t records_truncated = 0;
+  uint64_t bytes_written = 0;
+  uint32_t segments_rotated = 0;
+};
+
+// Process-wide structured logger.
+//
+// Log() encodes a compact binary record straight into a lock-free ring and
+// returns; a background thread drains the ring into rotating segment files.
+// The caller never formats text, takes a lock, or touches the disk.
+class Logger {
+ public:
+  static Logger& Get();
+
+  // Interned ids are valid before Open() and across reopen.
+  static uint32_t Intern(const std::string& text);
+  static bool LookupString(uint32_t id, std::string* text);
+
+  bool Open(const LoggerConfig& config);
+  void Close();
+  bool is_open() const { return open_.load(std::memory_order_acquire); }
+
+  void SetMinLevel(LogLevel level) {
+    min_level_.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+  }
+  bool IsEnabled(LogLevel level) const {
+    return static_cast<uint8_t>(level) >=
+               min_level_.load(std::memory_order_relaxed) &&
+           open_.load(std::memory_order_relaxed);
+  }
+
+  void Log(LogLevel level, uint32_t subsystem_id, uint32_t format_id,
+           const LogArg* args, size_t count);
+
+  template <typename... Args>
+  void Logf(LogLevel level, uint32_t subsystem_id, uint32_t format_id,
+            const Args&... args) {
+    if (!IsEnabled(level)) {
+      return;
+    }
+    const LogArg packed[] = {LogArg(args)..., LogArg(0)};
+    Log(level, subsystem_id, format_id, packed, sizeof...(Args));
+  }
+
+  // Asks the writer to write out everything queued so far and waits for it.
+  void Flush();
+
+  LoggerStats stats() const;
+
+ private:
+  // About 2 MiB. Fixed rather than configured: the ring outlives Close(), as
+  // a Log() call that saw the logger open may still be writing to it.
+  static constexpr size_t kRingSlots = 4096;
+
+  Logger();
+  ~Logger();
+
+  void Run();
+  void WakeWriter(LogLevel level, uint64_t ticket);
+  bool DrainRing(LogSegmentWriter* segments);
+  void WriteDefinition(LogSegmentWriter* segments, uint32_t id);
+
+  LogRing ring_;
+  std::atomic<bool> open_{false};
+  std::atomic<uint8_t> min_level_{static_cast<uint8_t>(LogLevel::kInfo)};
+  uint32_t max_string_bytes_ = 384;
+  uint32_t oversized_sample_every_ = 8;
+  std::atomic<uint32_t> oversized_counters_[256];
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable flushed_;
+  std::atomic<bool> writer_sleeping_{false};
+  std::atomic<bool> urgent_{false};
+  bool stop_requested_ = false;
+  uint64_t flush_requests_ = 0;
+  uint64_t flush_completed_ = 0;
+  LoggerConfig config_;
+  std::thread writer_;
+
+  // Writer thread state.
+  std::unique_ptr<LogSegmentWriter> segments_;
+  std::unordered_set<uint32_t> defined_ids_;
+
+  std::atomic<uint64_t> records_written_{0};
+  std::atomic<uint64_t> records_dropped_{0};
+  std::atomic<uint64_t> records_sampled_out_{0};
+  std::atomic<uint64_t> records_truncated_{0};
+  std::atomic<uint64_t> bytes_written_{0};
+  std::atomic<uint32_t> segments_rotated_{0};
+};
+
+// Logs from native code with the format and subsystem interned once per call
+// site, e.g. SS_LOG(LogLevel::kWarning, "export", "write failed: {}", path).
+#define SS_LOG(level, subsystem, format, ...)                          \
+  do {                                                                 \
+    Logger& ss_logger = Logger::Get();                                 \
+    if (ss_logger.IsEnabled(level)) {                                  \
+      static const uint32_t ss_subsystem_id = Logger::Intern(subsystem); \
+      static const uint32_t ss_format_id = Logger::Intern(format);     \
+      ss_logger.Logf(level, ss_subsystem_id, ss_format_id, ##__VA_ARGS__); \
+    }                                                                  \
+  } while (0)
+
+#endif  // NATIVE_LOGGING_LOGGER_H_
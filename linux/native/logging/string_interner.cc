@@ -0,0 +1,22 @@
+#include "logging/string_interner.h"
+
+uint32_t StringInterner::Intern(const std::string& text) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = ids_.find(text);
+  if (it != ids_.end()) {
+    return it->second;
+  }
+  strings_.push_back(text);
+  uint32_t id = static_cast<uint32_t>(strings_.size());
+  ids_.emplace(text, id);
+  return id;
+}
+
+bool StringInterner::Lookup(uint32_t id, std::string* text) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (id == 0 || id > strings_.size()) {
+    return false;
+  }
+  *text = strings_[id - 1];
+  return true;
+}
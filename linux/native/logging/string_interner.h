@@ -0,0 +1,27 @@
+#ifndef NATIVE_LOGGING_STRING_INTERNER_H_
+#define NATIVE_LOGGING_STRING_INTERNER_H_
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Maps format strings and subsystem names to small stable ids.
+//
+// Interning takes a lock, so callers intern once and keep the id; the hot
+// logging path only ever carries ids. Ids start at 1 and are never reused.
+class StringInterner {
+ public:
+  uint32_t Intern(const std::string& text);
+
+  // Returns false if |id| was never handed out.
+  bool Lookup(uint32_t id, std::string* text) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, uint32_t> ids_;
+  std::deque<std::string> strings_;  // Index is id - 1.
+};
+
+#endif  // NATIVE_LOGGING_STRING_INTERNER_H_
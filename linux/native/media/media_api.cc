@@ -0,0 +1,70 @@
+#include "media/media_api.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "media/mp4_faststart.h"
+#include "media/mp4_file.h"
+#include "media/mp4_inspector.h"
+
+namespace {
+
+void CopyOut(const std::string& text, char* buffer, int32_t size) {
+  if (buffer != nullptr && size > 0) {
+    size_t count = std::min(text.size(), static_cast<size_t>(size - 1));
+    std::memcpy(buffer, text.data(), count);
+    buffer[count] = '\0';
+  }
+}
+
+}  // namespace
+
+bool ss_mp4_inspect(const char* path, SsMp4Info* info, char* error,
+                    int32_t error_size) {
+  if (path == nullptr || info == nullptr) {
+    CopyOut("missing argument", error, error_size);
+    return false;
+  }
+  Mp4Info parsed;
+  std::string message;
+  if (!InspectMp4File(path, &parsed, &message)) {
+    CopyOut(message, error, error_size);
+    return false;
+  }
+  const Mp4Track* main = &parsed.tracks[0];
+  for (const Mp4Track& track : parsed.tracks) {
+    if (track.handler == Mp4Type("soun")) {
+      main = &track;
+      break;
+    }
+  }
+  *info = SsMp4Info();
+  info->duration_us = parsed.duration_us > 0 ? parsed.duration_us
+                                             : main->duration_us;
+  info->mdat_bytes = parsed.mdat_bytes;
+  info->major_brand = parsed.major_brand;
+  info->track_count = static_cast<uint32_t>(parsed.tracks.size());
+  info->codec = main->codec;
+  info->sample_count = main->sample_count;
+  info->sample_rate = main->sample_rate;
+  info->channels = main->channels;
+  info->width = main->width;
+  info->height = main->height;
+  info->faststart = parsed.faststart;
+  info->fragmented = parsed.fragmented;
+  return true;
+}
+
+int32_t ss_mp4_faststart(const char* path, char* error, int32_t error_size) {
+  if (path == nullptr) {
+    CopyOut("missing argument", error, error_size);
+    return static_cast<int32_t>(FaststartResult::kFailed);
+  }
+  std::string message;
+  const FaststartResult result = FaststartMp4File(path, &message);
+  if (result == FaststartResult::kFailed) {
+    CopyOut(message, error, error_size);
+  }
+  return static_cast<int32_t>(result);
+}
@@ -0,0 +1,51 @@
+#ifndef NATIVE_MEDIA_MEDIA_API_H_
+#define NATIVE_MEDIA_MEDIA_API_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/native_export.h"
+
+// C interface for lib/native/native_media_bindings.dart.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// What the upload needs to know of an Mp4Info. The codec and format fields
+// are those of the first audio track, or of the first track when there is
+// no audio. Four-character codes are big-endian, as in the file.
+typedef struct {
+  int64_t duration_us;
+  uint64_t mdat_bytes;
+  uint32_t major_brand;
+  uint32_t track_count;
+  uint32_t codec;
+  uint32_t sample_count;
+  uint32_t sample_rate;
+  uint16_t channels;
+  uint16_t width;
+  uint16_t height;
+  bool faststart;
+  bool fragmented;
+} SsMp4Info;
+
+// Inspects the MP4 file at |path| without decoding it. On failure copies
+// the reason into |error| and returns false.
+SS_EXPORT bool ss_mp4_inspect(const char* path,
+                              SsMp4Info* info,
+                              char* error,
+                              int32_t error_size);
+
+// Moves the moov box of |path| in front of its media data, in place.
+// Returns a FaststartResult, with the reason in |error| for kFailed.
+// Blocking; reads and writes the whole file.
+SS_EXPORT int32_t ss_mp4_faststart(const char* path,
+                                   char* error,
+                                   int32_t error_size);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // NATIVE_MEDIA_MEDIA_API_H_
@@ -0,0 +1,246 @@
+#include "media/mp4_faststart.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "media/mp4_inspector.h"
+
+namespace {
+
+// Where a top-level box lands in the rewritten file.
+struct Placement {
+  uint64_t old_offset = 0;
+  uint64_t new_offset = 0;
+  uint64_t size = 0;
+};
+
+// Maps a chunk offset through the placements, which are sorted by old
+// offset. Empty placements leave offsets as they are, to measure the moov.
+bool MoveOffset(const std::vector<Placement>& placements, uint64_t offset,
+                uint64_t* moved) {
+  if (placements.empty()) {
+    *moved = offset;
+    return true;
+  }
+  auto after = std::upper_bound(
+      placements.begin(), placements.end(), offset,
+      [](uint64_t value, const Placement& p) { return value < p.old_offset; });
+  if (after == placements.begin()) {
+    return false;
+  }
+  const Placement& p = *(after - 1);
+  if (offset - p.old_offset >= p.size) {
+    return false;  // Inside the moov box itself.
+  }
+  *moved = p.new_offset + (offset - p.old_offset);
+  return true;
+}
+
+void AppendU32(uint32_t value, std::vector<uint8_t>* out) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    out->push_back(static_cast<uint8_t>(value >> shift));
+  }
+}
+
+void AppendU64(uint64_t value, std::vector<uint8_t>* out) {
+  AppendU32(static_cast<uint32_t>(value >> 32), out);
+  AppendU32(static_cast<uint32_t>(value), out);
+}
+
+void PatchU32(size_t at, uint32_t value, std::vector<uint8_t>* out) {
+  for (int i = 0; i < 4; ++i) {
+    (*out)[at + i] = static_cast<uint8_t>(value >> (24 - 8 * i));
+  }
+}
+
+// Boxes between moov and the chunk offset tables, which are rebuilt rather
+// than copied because a table inside them may change size.
+bool IsOnPathToOffsets(uint32_t type) {
+  return type == Mp4Type("moov") || type == Mp4Type("trak") ||
+         type == Mp4Type("mdia") || type == Mp4Type("minf") ||
+         type == Mp4Type("stbl");
+}
+
+class MoovRewriter {
+ public:
+  MoovRewriter(const uint8_t* data, const std::vector<Placement>& placements,
+               bool wide_offsets)
+      : data_(data), placements_(placements), wide_offsets_(wide_offsets) {}
+
+  // Appends |box| with its chunk offsets moved. Returns false with |error|
+  // for an offset that cannot be moved.
+  bool Append(const Mp4Box& box, std::vector<uint8_t>* out,
+              std::string* error) {
+    if (box.type == Mp4Type("stco") || box.type == Mp4Type("co64")) {
+      return AppendOffsets(box, out, error);
+    }
+    if (!IsOnPathToOffsets(box.type)) {
+      out->insert(out->end(), data_ + box.offset, data_ + box.end());
+      return true;
+    }
+    std::vector<Mp4Box> children;
+    if (!ReadMp4Children(data_, box, &children)) {
+      *error = "malformed " + Mp4TypeName(box.type) + " box";
+      return false;
+    }
+    const size_t start = out->size();
+    AppendU32(0, out);
+    AppendU32(box.type, out);
+    for (const Mp4Box& child : children) {
+      if (!Append(child, out, error)) {
+        return false;
+      }
+    }
+    if (out->size() - start > std::numeric_limits<uint32_t>::max()) {
+      *error = "moov box too large";
+      return false;
+    }
+    PatchU32(start, static_cast<uint32_t>(out->size() - start), out);
+    return true;
+  }
+
+  // Set when a moved offset needs 64 bits and the table holding it had 32.
+  bool overflowed() const { return overflowed_; }
+
+ private:
+  bool AppendOffsets(const Mp4Box& box, std::vector<uint8_t>* out,
+                     std::string* error) {
+    const bool wide_in = box.type == Mp4Type("co64");
+    const bool wide_out = wide_in || wide_offsets_;
+    const uint8_t* payload = data_ + box.payload_offset();
+    // The inspector only checks the table it reads, the first one.
+    const uint32_t count =
+        box.payload_size() >= 8 ? Mp4ReadU32(payload + 4) : 0;
+    if (box.payload_size() < 8 ||
+        count > (box.payload_size() - 8) / (wide_in ? 8 : 4)) {
+      *error = "malformed " + Mp4TypeName(box.type) + " box";
+      return false;
+    }
+    const uint64_t size =
+        16 + static_cast<uint64_t>(count) * (wide_out ? 8 : 4);
+    if (size > std::numeric_limits<uint32_t>::max()) {
+      *error = "chunk offset table too large";
+      return false;
+    }
+    out->reserve(out->size() + size);
+    AppendU32(static_cast<uint32_t>(size), out);
+    AppendU32(wide_out ? Mp4Type("co64") : Mp4Type("stco"), out);
+    AppendU32(Mp4ReadU32(payload), out);  // Version and flags.
+    AppendU32(count, out);
+    for (uint32_t i = 0; i < count; ++i) {
+      const uint64_t offset = wide_in ? Mp4ReadU64(payload + 8 + i * 8ull)
+                                      : Mp4ReadU32(payload + 8 + i * 4ull);
+      uint64_t moved = 0;
+      if (!MoveOffset(placements_, offset, &moved)) {
+        *error = "chunk offset " + std::to_string(offset) +
+                 " is not in a media box";
+        return false;
+      }
+      if (wide_out) {
+        AppendU64(moved, out);
+      } else {
+        if (moved > std::numeric_limits<uint32_t>::max()) {
+          overflowed_ = true;
+        }
+        AppendU32(static_cast<uint32_t>(moved), out);
+      }
+    }
+    return true;
+  }
+
+  const uint8_t* data_;
+  const std::vector<Placement>& placements_;
+  const bool wide_offsets_;
+  bool overflowed_ = false;
+};
+
+}  // namespace
+
+FaststartResult FaststartMp4(
+    const uint8_t* data, size_t size,
+    const std::function<bool(const uint8_t* bytes, size_t count)>& write,
+    std::string* error) {
+  Mp4Info info;
+  if (!InspectMp4(data, size, &info, error)) {
+    return FaststartResult::kFailed;
+  }
+  if (info.faststart) {
+    return FaststartResult::kAlreadyFaststart;
+  }
+  if (info.fragmented) {
+    *error = "fragmented files are not rewritten";
+    return FaststartResult::kFailed;
+  }
+
+  Mp4Box file;
+  file.size = size;
+  std::vector<Mp4Box> boxes;
+  ReadMp4Children(data, file, &boxes);  // Read once already by InspectMp4.
+  size_t moov = 0;
+  size_t first_mdat = boxes.size();
+  for (size_t i = 0; i < boxes.size(); ++i) {
+    if (boxes[i].type == Mp4Type("moov")) {
+      moov = i;
+    } else if (boxes[i].type == Mp4Type("mdat") &&
+               first_mdat == boxes.size()) {
+      first_mdat = i;
+    }
+  }
+  // moov goes in front of the first mdat; the others keep their order.
+  std::vector<size_t> order;
+  for (size_t i = 0; i < boxes.size(); ++i) {
+    if (i == first_mdat) {
+      order.push_back(moov);
+    }
+    if (i != moov) {
+      order.push_back(i);
+    }
+  }
+
+  // Rebuilding does not change the moov size as long as the tables keep
+  // their width, so it is measured with unmoved offsets first. A second round
+  // widens every stco table if a moved offset no longer fits.
+  std::vector<uint8_t> rewritten;
+  for (bool wide_offsets : {false, true}) {
+    const std::vector<Placement> unmoved;
+    rewritten.clear();
+    if (!MoovRewriter(data, unmoved, wide_offsets)
+             .Append(boxes[moov], &rewritten, error)) {
+      return FaststartResult::kFailed;
+    }
+    std::vector<Placement> placements;
+    uint64_t offset = 0;
+    for (size_t i : order) {
+      if (i == moov) {
+        offset += rewritten.size();
+        continue;
+      }
+      placements.push_back({boxes[i].offset, offset, boxes[i].size});
+      offset += boxes[i].size;
+    }
+    std::sort(placements.begin(), placements.end(),
+              [](const Placement& a, const Placement& b) {
+                return a.old_offset < b.old_offset;
+              });
+    MoovRewriter rewriter(data, placements, wide_offsets);
+    rewritten.clear();
+    if (!rewriter.Append(boxes[moov], &rewritten, error)) {
+      return FaststartResult::kFailed;
+    }
+    if (!rewriter.overflowed()) {
+      break;
+    }
+  }
+
+  for (size_t i : order) {
+    const bool ok = i == moov
+                        ? write(rewritten.data(), rewritten.size())
+                        : write(data + boxes[i].offset, boxes[i].size);
+    if (!ok) {
+      *error = "write failed";
+      return FaststartResult::kFailed;
+    }
+  }
+  return FaststartResult::kRewritten;
+}
@@ -0,0 +1,35 @@
+#ifndef NATIVE_MEDIA_MP4_FASTSTART_H_
+#define NATIVE_MEDIA_MP4_FASTSTART_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Moves the moov box of an MP4 file ahead of its media data ("faststart"),
+// so the server can read duration and codecs, and a player can start,
+// before the whole upload has arrived. Recorders write moov last because
+// they only know the sample tables once they stop.
+//
+// Every chunk offset in the sample tables moves by the same amount as the
+// box its chunk lives in. stco tables become co64 ones when an offset would
+// no longer fit in 32 bits. Nothing else in the file changes.
+//
+// Works on memory only, so it also builds into the Windows runner; reading
+// and replacing files on Linux is in media/mp4_file.h.
+
+enum class FaststartResult {
+  kRewritten,
+  kAlreadyFaststart,  // Nothing written.
+  kFailed,
+};
+
+// Streams the rewritten form of the |size| bytes at |data| to |write|, in
+// order, in pieces of any size. Fragmented files, whose moof boxes carry
+// their own offsets, are refused; they stream as they are.
+FaststartResult FaststartMp4(
+    const uint8_t* data, size_t size,
+    const std::function<bool(const uint8_t* bytes, size_t count)>& write,
+    std::string* error);
+
+#endif  // NATIVE_MEDIA_MP4_FASTSTART_H_
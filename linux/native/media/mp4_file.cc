@@ -0,0 +1,43 @@
+#include "media/mp4_file.h"
+
+#include "common/buffered_file.h"
+#include "common/mapped_file.h"
+
+bool InspectMp4File(const std::string& path, Mp4Info* info,
+                    std::string* error) {
+  MappedFile file;
+  if (!file.Open(path)) {
+    *error = "cannot read " + path;
+    return false;
+  }
+  return InspectMp4(file.data(), file.size(), info, error);
+}
+
+FaststartResult FaststartMp4File(const std::string& path, std::string* error) {
+  MappedFile input;
+  if (!input.Open(path)) {
+    *error = "cannot read " + path;
+    return FaststartResult::kFailed;
+  }
+  input.AdviseSequential();
+  BufferedFile output(1 << 20);
+  if (!output.Open(path)) {
+    *error = "cannot write next to " + path;
+    return FaststartResult::kFailed;
+  }
+  const FaststartResult result = FaststartMp4(
+      input.data(), input.size(),
+      [&output](const uint8_t* bytes, size_t count) {
+        return output.Write(bytes, count);
+      },
+      error);
+  if (result != FaststartResult::kRewritten) {
+    output.Abort();
+    return result;
+  }
+  if (!output.Commit()) {
+    *error = "cannot replace " + path;
+    return FaststartResult::kFailed;
+  }
+  return FaststartResult::kRewritten;
+}
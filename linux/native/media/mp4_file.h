@@ -0,0 +1,19 @@
+#ifndef NATIVE_MEDIA_MP4_FILE_H_
+#define NATIVE_MEDIA_MP4_FILE_H_
+
+#include <string>
+
+#include "media/mp4_faststart.h"
+#include "media/mp4_inspector.h"
+
+// InspectMp4() and FaststartMp4() on files, mapped rather than read. POSIX
+// only; the Windows runner reads recordings itself.
+
+bool InspectMp4File(const std::string& path, Mp4Info* info,
+                    std::string* error);
+
+// Rewrites |path| in place: the new file is written next to it and renamed
+// over it, so a failure leaves the original untouched.
+FaststartResult FaststartMp4File(const std::string& path, std::string* error);
+
+#endif  // NATIVE_MEDIA_MP4_FILE_H_
@@ -0,0 +1,299 @@
+#include "media/mp4_inspector.h"
+
+#include <limits>
+
+namespace {
+
+const Mp4Box* FindChild(const std::vector<Mp4Box>& children, uint32_t type) {
+  for (const Mp4Box& child : children) {
+    if (child.type == type) {
+      return &child;
+    }
+  }
+  return nullptr;
+}
+
+// The children of the |type| child of |parent|, which must be there.
+bool ReadRequired(const uint8_t* data, const std::vector<Mp4Box>& parent,
+                  uint32_t type, std::vector<Mp4Box>* children,
+                  std::string* error) {
+  const Mp4Box* box = FindChild(parent, type);
+  if (box == nullptr) {
+    *error = "no " + Mp4TypeName(type) + " box";
+    return false;
+  }
+  if (!ReadMp4Children(data, *box, children)) {
+    *error = "malformed " + Mp4TypeName(type) + " box";
+    return false;
+  }
+  return true;
+}
+
+// |value| ticks of |timescale| per second. The all-ones durations that mean
+// "unknown" become 0.
+bool ToMicroseconds(uint64_t value, uint32_t timescale, bool wide,
+                    int64_t* us) {
+  if (timescale == 0) {
+    return false;
+  }
+  if (value == (wide ? std::numeric_limits<uint64_t>::max()
+                     : std::numeric_limits<uint32_t>::max())) {
+    *us = 0;
+    return true;
+  }
+  const uint64_t seconds = value / timescale;
+  if (seconds > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) /
+                    1000000 - 1) {
+    return false;
+  }
+  *us = static_cast<int64_t>(seconds * 1000000 +
+                             value % timescale * 1000000 / timescale);
+  return true;
+}
+
+// The timescale and duration of an mvhd or mdhd box, which start alike.
+bool ReadDuration(const uint8_t* data, const Mp4Box& box, uint32_t* timescale,
+                  int64_t* duration_us) {
+  const uint8_t* payload = data + box.payload_offset();
+  const bool wide = box.payload_size() >= 4 && payload[0] == 1;
+  if (box.payload_size() < (wide ? 32u : 20u)) {
+    return false;
+  }
+  *timescale = Mp4ReadU32(payload + (wide ? 20 : 12));
+  const uint64_t duration =
+      wide ? Mp4ReadU64(payload + 24) : Mp4ReadU32(payload + 16);
+  return ToMicroseconds(duration, *timescale, wide, duration_us);
+}
+
+bool ReadSampleTables(const uint8_t* data, size_t size,
+                      const std::vector<Mp4Box>& stbl, Mp4Track* track,
+                      std::string* error) {
+  const Mp4Box* stsd = FindChild(stbl, Mp4Type("stsd"));
+  if (stsd == nullptr || stsd->payload_size() < 8) {
+    *error = "track " + std::to_string(track->id) + " has no sample entries";
+    return false;
+  }
+  if (Mp4ReadU32(data + stsd->payload_offset() + 4) > 0) {
+    Mp4Box entry;
+    if (!ReadMp4Box(data, stsd->payload_offset() + 8, stsd->end(), &entry)) {
+      *error = "malformed stsd box";
+      return false;
+    }
+    track->codec = entry.type;
+    // Fields of the audio and visual sample entries, after the 8 bytes of
+    // SampleEntry and the 8 reserved bytes or 16 predefined ones.
+    if (entry.size >= 36 && track->handler == Mp4Type("soun")) {
+      track->channels = Mp4ReadU16(data + entry.offset + 24);
+      track->sample_rate = Mp4ReadU32(data + entry.offset + 32) >> 16;
+    } else if (entry.size >= 36 && track->handler == Mp4Type("vide")) {
+      track->width = Mp4ReadU16(data + entry.offset + 32);
+      track->height = Mp4ReadU16(data + entry.offset + 34);
+    }
+  }
+
+  const Mp4Box* stsz = FindChild(stbl, Mp4Type("stsz"));
+  if (stsz == nullptr) {
+    stsz = FindChild(stbl, Mp4Type("stz2"));
+  }
+  if (stsz == nullptr || stsz->payload_size() < 12) {
+    *error = "track " + std::to_string(track->id) + " has no sample sizes";
+    return false;
+  }
+  track->sample_count = Mp4ReadU32(data + stsz->payload_offset() + 8);
+
+  const Mp4Box* stco = FindChild(stbl, Mp4Type("stco"));
+  const bool wide = stco == nullptr;
+  if (wide) {
+    stco = FindChild(stbl, Mp4Type("co64"));
+  }
+  if (stco == nullptr || stco->payload_size() < 8) {
+    *error = "track " + std::to_string(track->id) + " has no chunk offsets";
+    return false;
+  }
+  const uint8_t* entries = data + stco->payload_offset() + 8;
+  const uint64_t count = Mp4ReadU32(entries - 4);
+  const uint64_t width = wide ? 8 : 4;
+  if (count > (stco->payload_size() - 8) / width) {
+    *error = "malformed " + Mp4TypeName(stco->type) + " box";
+    return false;
+  }
+  for (uint64_t i = 0; i < count; ++i) {
+    const uint64_t offset = wide ? Mp4ReadU64(entries + i * 8)
+                                 : Mp4ReadU32(entries + i * 4);
+    if (offset >= size) {
+      *error = "track " + std::to_string(track->id) +
+               " has a chunk outside the file";
+      return false;
+    }
+  }
+  track->chunk_count = static_cast<uint32_t>(count);
+  return true;
+}
+
+bool ReadTrack(const uint8_t* data, size_t size, const Mp4Box& trak,
+               Mp4Track* track, std::string* error) {
+  std::vector<Mp4Box> children;
+  if (!ReadMp4Children(data, trak, &children)) {
+    *error = "malformed trak box";
+    return false;
+  }
+  const Mp4Box* tkhd = FindChild(children, Mp4Type("tkhd"));
+  if (tkhd != nullptr && tkhd->payload_size() >= 24) {
+    const uint8_t* payload = data + tkhd->payload_offset();
+    track->id = Mp4ReadU32(payload + (payload[0] == 1 ? 20 : 12));
+  }
+
+  std::vector<Mp4Box> mdia;
+  if (!ReadRequired(data, children, Mp4Type("mdia"), &mdia, error)) {
+    return false;
+  }
+  const Mp4Box* mdhd = FindChild(mdia, Mp4Type("mdhd"));
+  if (mdhd == nullptr ||
+      !ReadDuration(data, *mdhd, &track->timescale, &track->duration_us)) {
+    *error = "track " + std::to_string(track->id) + " has no usable mdhd";
+    return false;
+  }
+  const Mp4Box* hdlr = FindChild(mdia, Mp4Type("hdlr"));
+  if (hdlr != nullptr && hdlr->payload_size() >= 12) {
+    track->handler = Mp4ReadU32(data + hdlr->payload_offset() + 8);
+  }
+
+  std::vector<Mp4Box> minf;
+  std::vector<Mp4Box> stbl;
+  return ReadRequired(data, mdia, Mp4Type("minf"), &minf, error) &&
+         ReadRequired(data, minf, Mp4Type("stbl"), &stbl, error) &&
+         ReadSampleTables(data, size, stbl, track, error);
+}
+
+}  // namespace
+
+std::string Mp4TypeName(uint32_t type) {
+  std::string name(4, ' ');
+  for (int i = 0; i < 4; ++i) {
+    const char c = static_cast<char>(type >> (24 - 8 * i));
+    name[i] = c >= 0x20 && c < 0x7f ? c : '?';
+  }
+  return name;
+}
+
+bool ReadMp4Box(const uint8_t* data, uint64_t offset, uint64_t end,
+                Mp4Box* box) {
+  if (offset >= end || end - offset < 8) {
+    return false;
+  }
+  const uint8_t* header = data + offset;
+  box->type = Mp4ReadU32(header + 4);
+  box->offset = offset;
+  box->header_size = 8;
+  const uint32_t size = Mp4ReadU32(header);
+  if (size == 1) {
+    if (end - offset < 16) {
+      return false;
+    }
+    box->size = Mp4ReadU64(header + 8);
+    box->header_size = 16;
+  } else if (size == 0) {
+    box->size = end - offset;
+  } else {
+    box->size = size;
+  }
+  if (box->type == Mp4Type("uuid")) {
+    box->header_size += 16;
+  }
+  return box->size >= box->header_size && box->size <= end - offset;
+}
+
+bool ReadMp4Children(const uint8_t* data, const Mp4Box& parent,
+                     std::vector<Mp4Box>* children) {
+  children->clear();
+  for (uint64_t offset = parent.payload_offset(); offset < parent.end();) {
+    Mp4Box child;
+    if (!ReadMp4Box(data, offset, parent.end(), &child)) {
+      return false;
+    }
+    children->push_back(child);
+    offset = child.end();
+  }
+  return true;
+}
+
+bool InspectMp4(const uint8_t* data, size_t size, Mp4Info* info,
+                std::string* error) {
+  *info = Mp4Info();
+  Mp4Box file;
+  file.size = size;
+  std::vector<Mp4Box> boxes;
+  if (!ReadMp4Children(data, file, &boxes)) {
+    *error = "malformed box at offset " +
+             std::to_string(boxes.empty() ? 0 : boxes.back().end()) +
+             " (truncated file?)";
+    return false;
+  }
+  if (boxes.empty() || boxes[0].type != Mp4Type("ftyp") ||
+      boxes[0].payload_size() < 4) {
+    *error = "not an MP4 file";
+    return false;
+  }
+  info->major_brand = Mp4ReadU32(data + boxes[0].payload_offset());
+
+  const Mp4Box* moov = nullptr;
+  bool has_mdat = false;
+  for (const Mp4Box& box : boxes) {
+    if (box.type == Mp4Type("moov")) {
+      if (moov != nullptr) {
+        *error = "more than one moov box";
+        return false;
+      }
+      moov = &box;
+    } else if (box.type == Mp4Type("mdat")) {
+      if (!has_mdat) {
+        info->mdat_offset = box.offset;
+      }
+      has_mdat = true;
+      info->mdat_bytes += box.payload_size();
+    } else if (box.type == Mp4Type("moof")) {
+      info->fragmented = true;
+    }
+  }
+  if (moov == nullptr) {
+    *error = "no moov box (unfinished recording?)";
+    return false;
+  }
+  if (!has_mdat) {
+    *error = "no mdat box";
+    return false;
+  }
+  info->moov_offset = moov->offset;
+  info->moov_size = moov->size;
+  info->faststart = moov->offset < info->mdat_offset;
+
+  std::vector<Mp4Box> children;
+  if (!ReadMp4Children(data, *moov, &children)) {
+    *error = "malformed moov box";
+    return false;
+  }
+  const Mp4Box* mvhd = FindChild(children, Mp4Type("mvhd"));
+  uint32_t timescale = 0;
+  if (mvhd == nullptr ||
+      !ReadDuration(data, *mvhd, &timescale, &info->duration_us)) {
+    *error = "no usable mvhd box";
+    return false;
+  }
+  if (FindChild(children, Mp4Type("mvex")) != nullptr) {
+    info->fragmented = true;
+  }
+  for (const Mp4Box& child : children) {
+    if (child.type == Mp4Type("trak")) {
+      Mp4Track track;
+      if (!ReadTrack(data, size, child, &track, error)) {
+        return false;
+      }
+      info->tracks.push_back(track);
+    }
+  }
+  if (info->tracks.empty()) {
+    *error = "no tracks";
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,96 @@
+#ifndef NATIVE_MEDIA_MP4_INSPECTOR_H_
+#define NATIVE_MEDIA_MP4_INSPECTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Reads the box structure of ISO base media files (MP4, M4A, MOV: what the
+// recorders write and what gets uploaded) without decoding or even touching
+// the media data. Every size is checked against its parent, so a damaged
+// file is an error rather than a read out of bounds.
+
+constexpr uint32_t Mp4Type(const char (&fourcc)[5]) {
+  return static_cast<uint32_t>(static_cast<uint8_t>(fourcc[0])) << 24 |
+         static_cast<uint32_t>(static_cast<uint8_t>(fourcc[1])) << 16 |
+         static_cast<uint32_t>(static_cast<uint8_t>(fourcc[2])) << 8 |
+         static_cast<uint32_t>(static_cast<uint8_t>(fourcc[3]));
+}
+
+// Big-endian fields, as every ISO BMFF integer is stored.
+inline uint16_t Mp4ReadU16(const uint8_t* p) {
+  return static_cast<uint16_t>(p[0] << 8 | p[1]);
+}
+inline uint32_t Mp4ReadU32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) << 24 | static_cast<uint32_t>(p[1]) << 16 |
+         static_cast<uint32_t>(p[2]) << 8 | p[3];
+}
+inline uint64_t Mp4ReadU64(const uint8_t* p) {
+  return static_cast<uint64_t>(Mp4ReadU32(p)) << 32 | Mp4ReadU32(p + 4);
+}
+
+// "mp4a" for Mp4Type("mp4a").
+std::string Mp4TypeName(uint32_t type);
+
+struct Mp4Box {
+  uint32_t type = 0;
+  uint64_t offset = 0;  // Of the header.
+  uint64_t header_size = 0;
+  uint64_t size = 0;  // Header included.
+
+  uint64_t payload_offset() const { return offset + header_size; }
+  uint64_t payload_size() const { return size - header_size; }
+  uint64_t end() const { return offset + size; }
+};
+
+// Reads the header of the box at |offset|, which must lie before |end|, the
+// end of its parent. A size of 0 (to the end) becomes |end| - |offset|.
+// Returns false when the header is cut short or the box overruns |end|.
+bool ReadMp4Box(const uint8_t* data, uint64_t offset, uint64_t end,
+                Mp4Box* box);
+
+// The children of |parent|, which must hold nothing but boxes. Returns
+// false, with what was read so far, when one of them is malformed.
+bool ReadMp4Children(const uint8_t* data, const Mp4Box& parent,
+                     std::vector<Mp4Box>* children);
+
+struct Mp4Track {
+  uint32_t id = 0;
+  uint32_t handler = 0;  // Mp4Type("soun"), Mp4Type("vide")...
+  uint32_t codec = 0;    // The first sample entry: "mp4a", "avc1"...
+  uint32_t timescale = 0;
+  int64_t duration_us = 0;
+  uint32_t sample_count = 0;
+  uint32_t chunk_count = 0;
+  // Audio.
+  uint32_t sample_rate = 0;
+  uint16_t channels = 0;
+  // Video.
+  uint16_t width = 0;
+  uint16_t height = 0;
+};
+
+struct Mp4Info {
+  uint32_t major_brand = 0;
+  int64_t duration_us = 0;
+  // moov comes before the first mdat, so a player can start before the
+  // whole file has arrived.
+  bool faststart = false;
+  // Movie fragments (moof) carry their own sample tables.
+  bool fragmented = false;
+  uint64_t moov_offset = 0;
+  uint64_t moov_size = 0;
+  uint64_t mdat_offset = 0;  // The first one.
+  uint64_t mdat_bytes = 0;   // All of them.
+  std::vector<Mp4Track> tracks;
+};
+
+// Fills |info| from the |size| bytes at |data|. Returns false with |error|
+// for anything that is not a usable file: no ftyp first, no moov or mdat,
+// boxes that overrun their parent, a track without sample tables, or chunk
+// offsets that point outside the file.
+bool InspectMp4(const uint8_t* data, size_t size, Mp4Info* info,
+                std::string* error);
+
+#endif  // NATIVE_MEDIA_MP4_INSPECTOR_H_
@@ -0,0 +1,74 @@
+#include "memory/memory_api.h"
+
+#include "memory/memory_manager.h"
+#include "memory/process_memory.h"
+
+namespace {
+
+void ToC(const MemoryTrimReport& report, SsMemoryTrimReport* out) {
+  out->rss_before_bytes = report.rss_before_bytes;
+  out->rss_after_bytes = report.rss_after_bytes;
+  out->native_released_bytes = report.native_released_bytes;
+  out->duration_us = report.duration_us;
+  out->reason = static_cast<int32_t>(report.reason);
+}
+
+}  // namespace
+
+bool ss_memory_read_stats(SsMemoryStats* out) {
+  if (out == nullptr) {
+    return false;
+  }
+  *out = SsMemoryStats();
+  ProcessMemory memory;
+  if (!ReadProcessMemory(&memory)) {
+    return false;
+  }
+  out->rss_bytes = memory.rss_bytes;
+  out->anon_bytes = memory.anon_bytes;
+  out->file_bytes = memory.file_bytes;
+  out->swap_bytes = memory.swap_bytes;
+  MemoryPressure pressure;
+  if (ReadMemoryPressure(&pressure)) {
+    out->pressure_some_avg10 = pressure.some.avg10;
+    out->pressure_full_avg10 = pressure.full.avg10;
+  }
+  CgroupMemory cgroup;
+  if (ReadCgroupMemory(&cgroup)) {
+    out->cgroup_current_bytes = cgroup.current_bytes;
+    out->cgroup_limit_bytes = cgroup.limit_bytes();
+  }
+  return true;
+}
+
+void ss_memory_set_hidden(bool hidden) {
+  MemoryManager::Get().SetHidden(hidden);
+}
+
+void ss_memory_set_idle(bool idle) {
+  MemoryManager::Get().SetIdle(idle);
+}
+
+int32_t ss_memory_poll(void) {
+  return static_cast<int32_t>(MemoryManager::Get().Poll());
+}
+
+void ss_memory_trim(int32_t reason, SsMemoryTrimReport* report) {
+  if (reason < SS_MEMORY_TRIM_NONE || reason > SS_MEMORY_TRIM_CGROUP_LIMIT) {
+    reason = SS_MEMORY_TRIM_NONE;
+  }
+  MemoryTrimReport result;
+  MemoryManager::Get().Trim(static_cast<TrimReason>(reason), &result);
+  if (report != nullptr) {
+    ToC(result, report);
+  }
+}
+
+bool ss_memory_last_trim(SsMemoryTrimReport* report) {
+  MemoryTrimReport result;
+  if (report == nullptr || !MemoryManager::Get().LastTrim(&result)) {
+    return false;
+  }
+  ToC(result, report);
+  return true;
+}
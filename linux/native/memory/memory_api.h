@@ -0,0 +1,65 @@
+#ifndef NATIVE_MEMORY_MEMORY_API_H_
+#define NATIVE_MEMORY_MEMORY_API_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/native_export.h"
+
+// C interface to the memory manager (memory/memory_manager.h), for the
+// runner (linux/runner/memory_control.cc) and Dart.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// What ss_memory_read_stats() could read; missing parts are zero. Pressure
+// values are PSI averages in percent; a cgroup limit of 0 means none.
+typedef struct {
+  uint64_t rss_bytes;
+  uint64_t anon_bytes;
+  uint64_t file_bytes;
+  uint64_t swap_bytes;
+  double pressure_some_avg10;
+  double pressure_full_avg10;
+  uint64_t cgroup_current_bytes;
+  uint64_t cgroup_limit_bytes;
+} SsMemoryStats;
+
+// Mirrors MemoryTrimReport. |reason| is a TrimReason.
+typedef struct {
+  uint64_t rss_before_bytes;
+  uint64_t rss_after_bytes;
+  uint64_t native_released_bytes;
+  int64_t duration_us;
+  int32_t reason;
+} SsMemoryTrimReport;
+
+// TrimReason values.
+#define SS_MEMORY_TRIM_NONE 0
+#define SS_MEMORY_TRIM_BACKGROUND 1
+#define SS_MEMORY_TRIM_PRESSURE 2
+#define SS_MEMORY_TRIM_CGROUP_LIMIT 3
+
+SS_EXPORT bool ss_memory_read_stats(SsMemoryStats* out);
+
+// Whether the window is hidden or minimized (runner), and whether the app
+// sits idle in floating mode (Dart). Either counts as the background.
+SS_EXPORT void ss_memory_set_hidden(bool hidden);
+SS_EXPORT void ss_memory_set_idle(bool idle);
+
+// Samples PSI and the cgroup. Returns the reason to trim now, or
+// SS_MEMORY_TRIM_NONE.
+SS_EXPORT int32_t ss_memory_poll(void);
+
+// Releases native buffers and free heap. Blocks for a few milliseconds.
+// |report| may be null.
+SS_EXPORT void ss_memory_trim(int32_t reason, SsMemoryTrimReport* report);
+// Returns false before the first trim.
+SS_EXPORT bool ss_memory_last_trim(SsMemoryTrimReport* report);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // NATIVE_MEMORY_MEMORY_API_H_
@@ -0,0 +1,148 @@
+#include "memory/memory_manager.h"
+
+#include <malloc.h>
+#include <time.h>
+
+#include "logging/logger.h"
+#include "stream/stream_registry.h"
+#include "tracing/tracer.h"
+
+const char* TrimReasonName(TrimReason reason) {
+  switch (reason) {
+    case TrimReason::kNone:
+      return "none";
+    case TrimReason::kBackground:
+      return "background";
+    case TrimReason::kPressure:
+      return "pressure";
+    case TrimReason::kCgroupLimit:
+      return "cgroup limit";
+  }
+  return "unknown";
+}
+
+void MemoryPolicy::SetBackground(bool background, int64_t now_ms) {
+  if (background == background_) {
+    return;
+  }
+  background_ = background;
+  background_since_ms_ = now_ms;
+  background_trimmed_ = false;
+}
+
+TrimReason MemoryPolicy::Evaluate(const MemorySample& sample,
+                                  int64_t now_ms) {
+  TrimReason reason = TrimReason::kNone;
+  const uint64_t limit = sample.cgroup.limit_bytes();
+  if (sample.has_pressure &&
+      sample.pressure.some.avg10 >= options_.pressure_some_avg10) {
+    reason = TrimReason::kPressure;
+  } else if (sample.has_cgroup && limit > 0 &&
+             sample.cgroup.current_bytes >=
+                 limit * options_.cgroup_usage_ratio) {
+    reason = TrimReason::kCgroupLimit;
+  }
+  if (reason != TrimReason::kNone && !CooledDown(now_ms)) {
+    reason = TrimReason::kNone;
+  }
+
+  if (reason == TrimReason::kNone && background_ && !background_trimmed_ &&
+      now_ms - background_since_ms_ >= options_.background_grace_ms) {
+    reason = TrimReason::kBackground;
+  }
+  if (reason == TrimReason::kNone) {
+    return reason;
+  }
+
+  // Any trim while in the background covers the one it was owed.
+  background_trimmed_ = background_;
+  trimmed_before_ = true;
+  last_trim_ms_ = now_ms;
+  return reason;
+}
+
+bool MemoryPolicy::CooledDown(int64_t now_ms) const {
+  return !trimmed_before_ ||
+         now_ms - last_trim_ms_ >= options_.pressure_cooldown_ms;
+}
+
+MemoryManager& MemoryManager::Get() {
+  static MemoryManager* manager = new MemoryManager(MemoryPolicyOptions());
+  return *manager;
+}
+
+MemoryManager::MemoryManager(const MemoryPolicyOptions& options)
+    : policy_(options) {}
+
+int64_t MemoryManager::NowMs() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+}
+
+void MemoryManager::SetHidden(bool hidden) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  hidden_ = hidden;
+  UpdateBackground();
+}
+
+void MemoryManager::SetIdle(bool idle) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  idle_ = idle;
+  UpdateBackground();
+}
+
+void MemoryManager::UpdateBackground() {
+  policy_.SetBackground(hidden_ || idle_, NowMs());
+}
+
+TrimReason MemoryManager::Poll() {
+  MemorySample sample;
+  sample.has_pressure = ReadMemoryPressure(&sample.pressure);
+  sample.has_cgroup = ReadCgroupMemory(&sample.cgroup);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return policy_.Evaluate(sample, NowMs());
+}
+
+void MemoryManager::Trim(TrimReason reason, MemoryTrimReport* report) {
+  SS_TRACE_SCOPE("memory", "trim");
+  const int64_t start_us = static_cast<int64_t>(Tracer::NowNs() / 1000);
+  MemoryTrimReport result;
+  result.reason = reason;
+  ProcessMemory memory;
+  if (ReadProcessMemory(&memory)) {
+    result.rss_before_bytes = memory.rss_bytes;
+  }
+
+  result.native_released_bytes = Tracer::Get().ReleaseMemory() +
+                                 StreamRegistry::Get().ReleaseMemory();
+  malloc_trim(0);
+
+  if (ReadProcessMemory(&memory)) {
+    result.rss_after_bytes = memory.rss_bytes;
+  }
+  result.duration_us = static_cast<int64_t>(Tracer::NowNs() / 1000) - start_us;
+
+  SS_LOG(LogLevel::kInfo, "memory",
+         "trim ({}): rss {} -> {} bytes, {} from native buffers, {} us",
+         TrimReasonName(reason), result.rss_before_bytes,
+         result.rss_after_bytes, result.native_released_bytes,
+         result.duration_us);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    last_trim_ = result;
+    has_last_trim_ = true;
+  }
+  if (report != nullptr) {
+    *report = result;
+  }
+}
+
+bool MemoryManager::LastTrim(MemoryTrimReport* report) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!has_last_trim_) {
+    return false;
+  }
+  *report = last_trim_;
+  return true;
+}
@@ -0,0 +1,122 @@
+#ifndef NATIVE_MEMORY_MEMORY_MANAGER_H_
+#define NATIVE_MEMORY_MEMORY_MANAGER_H_
+
+#include <cstdint>
+#include <mutex>
+
+#include "memory/process_memory.h"
+
+// Why memory is being given back. Values are shared with memory_api.h.
+enum class TrimReason : int32_t {
+  kNone = 0,
+  // The window has been hidden, or the app idle in floating mode, for a
+  // while.
+  kBackground = 1,
+  // The system is stalling on memory (PSI).
+  kPressure = 2,
+  // The cgroup is close to memory.high or memory.max.
+  kCgroupLimit = 3,
+};
+
+const char* TrimReasonName(TrimReason reason);
+
+struct MemoryPolicyOptions {
+  // How long the app must stay in the background before it trims, so
+  // a quick minimize and restore costs nothing.
+  int64_t background_grace_ms = 10000;
+  // Minimum time between trims caused by pressure or the cgroup limit.
+  int64_t pressure_cooldown_ms = 60000;
+  // PSI "some" avg10, in percent, at which the system counts as under
+  // pressure.
+  double pressure_some_avg10 = 10.0;
+  // Share of the cgroup limit at which to trim.
+  double cgroup_usage_ratio = 0.9;
+};
+
+// What the policy sees of the system; either part may be missing.
+struct MemorySample {
+  bool has_pressure = false;
+  MemoryPressure pressure;
+  bool has_cgroup = false;
+  CgroupMemory cgroup;
+};
+
+// Decides when to trim. No I/O and no clock of its own, so it can be
+// driven by tests.
+//
+// Going to the background earns one trim once the grace period has passed;
+// coming back resets that. Pressure and the cgroup limit trim whatever the
+// visibility, at most once per cooldown.
+class MemoryPolicy {
+ public:
+  explicit MemoryPolicy(const MemoryPolicyOptions& options)
+      : options_(options) {}
+
+  void SetBackground(bool background, int64_t now_ms);
+  bool background() const { return background_; }
+
+  // Returns the reason to trim now, if any, and counts that trim as done.
+  TrimReason Evaluate(const MemorySample& sample, int64_t now_ms);
+
+ private:
+  bool CooledDown(int64_t now_ms) const;
+
+  const MemoryPolicyOptions options_;
+  bool background_ = false;
+  int64_t background_since_ms_ = 0;
+  bool background_trimmed_ = false;
+  bool trimmed_before_ = false;
+  int64_t last_trim_ms_ = 0;
+};
+
+struct MemoryTrimReport {
+  TrimReason reason = TrimReason::kNone;
+  uint64_t rss_before_bytes = 0;
+  uint64_t rss_after_bytes = 0;
+  // Released by the native services' own buffers, before malloc_trim().
+  uint64_t native_released_bytes = 0;
+  int64_t duration_us = 0;
+};
+
+// Process-wide memory manager. The runner reports whether the window is
+// visible, Dart whether the app sits idle in floating mode, and the runner
+// polls it to learn when to trim.
+class MemoryManager {
+ public:
+  // The shared manager. Never destroyed.
+  static MemoryManager& Get();
+
+  explicit MemoryManager(const MemoryPolicyOptions& options);
+
+  MemoryManager(const MemoryManager&) = delete;
+  MemoryManager& operator=(const MemoryManager&) = delete;
+
+  void SetHidden(bool hidden);
+  void SetIdle(bool idle);
+
+  // Samples PSI and the cgroup and returns the reason to trim now, if any.
+  TrimReason Poll();
+
+  // Gives back what the native services hold that they can do without
+  // (finished trace buffers, unread streams), then returns free heap to
+  // the kernel with malloc_trim(). Takes a few milliseconds; best run off
+  // the platform thread.
+  void Trim(TrimReason reason, MemoryTrimReport* report);
+
+  // The most recent Trim(). Returns false before the first.
+  bool LastTrim(MemoryTrimReport* report) const;
+
+  static int64_t NowMs();
+
+ private:
+  void UpdateBackground();
+
+  mutable std::mutex mutex_;
+  MemoryPolicy policy_;
+  bool hidden_ = false;
+  bool idle_ = false;
+  bool has_last_trim_ = false;
+  MemoryTrimReport last_trim_;
+};
+
+#endif  // NATIVE_MEMORY_MEMORY_MANAGER_H_
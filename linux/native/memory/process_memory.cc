@@ -0,0 +1,174 @@
+#include "memory/process_memory.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <sstream>
+
+#include "common/proc_file.h"
+
+namespace {
+
+// "VmRSS:\t  123456 kB" -> bytes.
+bool ParseStatusField(const std::string& line, const char* name,
+                      uint64_t* bytes) {
+  const size_t length = std::char_traits<char>::length(name);
+  if (line.compare(0, length, name) != 0 || line.size() <= length ||
+      line[length] != ':') {
+    return false;
+  }
+  *bytes = std::strtoull(line.c_str() + length + 1, nullptr, 10) * 1024;
+  return true;
+}
+
+bool ParseStall(std::istringstream* fields, PressureStall* out) {
+  bool has_avg10 = false;
+  std::string field;
+  while (*fields >> field) {
+    const size_t equals = field.find('=');
+    if (equals == std::string::npos) {
+      return false;
+    }
+    const std::string key = field.substr(0, equals);
+    const char* value = field.c_str() + equals + 1;
+    if (key == "avg10") {
+      out->avg10 = std::strtod(value, nullptr);
+      has_avg10 = true;
+    } else if (key == "avg60") {
+      out->avg60 = std::strtod(value, nullptr);
+    } else if (key == "total") {
+      out->total_us = std::strtoull(value, nullptr, 10);
+    }
+  }
+  return has_avg10;
+}
+
+}  // namespace
+
+uint64_t CgroupMemory::limit_bytes() const {
+  if (high_bytes == 0) {
+    return max_bytes;
+  }
+  if (max_bytes == 0) {
+    return high_bytes;
+  }
+  return high_bytes < max_bytes ? high_bytes : max_bytes;
+}
+
+bool ReadProcessMemory(ProcessMemory* out) {
+  std::string text;
+  return ReadProcFile("/proc/self/status", &text) &&
+         ParseProcessStatus(text, out);
+}
+
+bool ReadMemoryPressure(MemoryPressure* out) {
+  std::string text;
+  return ReadProcFile("/proc/pressure/memory", &text) &&
+         ParseMemoryPressure(text, out);
+}
+
+bool ReadCgroupMemory(CgroupMemory* out) {
+  std::string text;
+  std::string path;
+  if (!ReadProcFile("/proc/self/cgroup", &text) ||
+      !ParseCgroupPath(text, &path)) {
+    return false;
+  }
+  const std::string directory = "/sys/fs/cgroup" + path;
+  CgroupMemory memory;
+  if (!ReadProcFile(directory + "/memory.current", &text)) {
+    return false;
+  }
+  memory.current_bytes = std::strtoull(text.c_str(), nullptr, 10);
+  // Either limit file may be absent, e.g. in the root cgroup.
+  if (ReadProcFile(directory + "/memory.high", &text)) {
+    ParseCgroupLimit(text, &memory.high_bytes);
+  }
+  if (ReadProcFile(directory + "/memory.max", &text)) {
+    ParseCgroupLimit(text, &memory.max_bytes);
+  }
+  *out = memory;
+  return true;
+}
+
+bool ParseProcessStatus(const std::string& text, ProcessMemory* out) {
+  ProcessMemory memory;
+  bool has_rss = false;
+  std::istringstream lines(text);
+  std::string line;
+  while (std::getline(lines, line)) {
+    has_rss |= ParseStatusField(line, "VmRSS", &memory.rss_bytes);
+    ParseStatusField(line, "RssAnon", &memory.anon_bytes);
+    ParseStatusField(line, "RssFile", &memory.file_bytes);
+    ParseStatusField(line, "VmSwap", &memory.swap_bytes);
+  }
+  if (!has_rss) {
+    return false;
+  }
+  *out = memory;
+  return true;
+}
+
+bool ParseMemoryPressure(const std::string& text, MemoryPressure* out) {
+  MemoryPressure pressure;
+  bool has_some = false;
+  std::istringstream lines(text);
+  std::string line;
+  while (std::getline(lines, line)) {
+    std::istringstream fields(line);
+    std::string kind;
+    fields >> kind;
+    if (kind == "some") {
+      has_some = ParseStall(&fields, &pressure.some);
+    } else if (kind == "full") {
+      ParseStall(&fields, &pressure.full);
+    }
+  }
+  if (!has_some) {
+    return false;
+  }
+  *out = pressure;
+  return true;
+}
+
+bool ParseCgroupPath(const std::string& text, std::string* path) {
+  std::istringstream lines(text);
+  std::string line;
+  while (std::getline(lines, line)) {
+    if (line.compare(0, 3, "0::") == 0) {
+      *path = line.substr(3);
+      return !path->empty();
+    }
+  }
+  return false;
+}
+
+bool ParseCgroupLimit(const std::string& text, uint64_t* bytes) {
+  if (text.compare(0, 3, "max") == 0) {
+    *bytes = 0;
+    return true;
+  }
+  char* end = nullptr;
+  const uint64_t value = std::strtoull(text.c_str(), &end, 10);
+  if (end == text.c_str()) {
+    return false;
+  }
+  *bytes = value;
+  return true;
+}
+
+size_t ReleasePages(void* data, size_t size) {
+  const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  const uintptr_t address = reinterpret_cast<uintptr_t>(data);
+  const uintptr_t begin = (address + page - 1) & ~(page - 1);
+  const uintptr_t end = (address + size) & ~(page - 1);
+  if (end <= begin) {
+    return 0;
+  }
+  if (madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED) !=
+      0) {
+    return 0;
+  }
+  return end - begin;
+}
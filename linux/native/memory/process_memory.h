@@ -0,0 +1,58 @@
+#ifndef NATIVE_MEMORY_PROCESS_MEMORY_H_
+#define NATIVE_MEMORY_PROCESS_MEMORY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Resident memory of this process, from /proc/self/status.
+struct ProcessMemory {
+  uint64_t rss_bytes = 0;
+  uint64_t anon_bytes = 0;  // Heap, stacks, anonymous mappings.
+  uint64_t file_bytes = 0;  // Mapped files: code, assets.
+  uint64_t swap_bytes = 0;
+};
+
+// One line of /proc/pressure/memory: the share of time some (or all)
+// runnable tasks were stalled waiting for memory, in percent.
+struct PressureStall {
+  double avg10 = 0;
+  double avg60 = 0;
+  uint64_t total_us = 0;
+};
+
+struct MemoryPressure {
+  PressureStall some;
+  PressureStall full;
+};
+
+// Usage and limits of the cgroup v2 this process runs in. A limit of 0 means
+// there is none.
+struct CgroupMemory {
+  uint64_t current_bytes = 0;
+  uint64_t high_bytes = 0;
+  uint64_t max_bytes = 0;
+
+  // The lower of the two limits, or 0.
+  uint64_t limit_bytes() const;
+};
+
+// Each returns false if the file is missing or unreadable, e.g. on kernels
+// without PSI or under cgroup v1.
+bool ReadProcessMemory(ProcessMemory* out);
+bool ReadMemoryPressure(MemoryPressure* out);
+bool ReadCgroupMemory(CgroupMemory* out);
+
+// The parsers behind them, on the file contents.
+bool ParseProcessStatus(const std::string& text, ProcessMemory* out);
+bool ParseMemoryPressure(const std::string& text, MemoryPressure* out);
+// Returns the cgroup v2 path from /proc/self/cgroup ("0::<path>").
+bool ParseCgroupPath(const std::string& text, std::string* path);
+// A memory.high / memory.max value: bytes, or "max" for none (0).
+bool ParseCgroupLimit(const std::string& text, uint64_t* bytes);
+
+// Hands the whole pages inside [data, data + size) back to the kernel; they
+// read as zeros when next touched. Returns the bytes released.
+size_t ReleasePages(void* data, size_t size);
+
+#endif  // NATIVE_MEMORY_PROCESS_MEMORY_H_
@@ -0,0 +1,186 @@
+#include "runner/audio_recorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <sstream>
+#include <system_error>
+#include <utility>
+
+namespace {
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Follows the blocks' timestamps through a recording.
+class BlockTimeline {
+ public:
+  void Add(const AudioBlock& block, int64_t now_us, AudioRecorderStats* stats) {
+    if (block.discontinuity) {
+      stats->xruns++;
+    }
+    if (block.timestamp_us < 0) {
+      return;
+    }
+    const int64_t end_us = block.timestamp_us + block.duration_us;
+    if (first_start_us_ < 0) {
+      first_start_us_ = block.timestamp_us;
+      first_end_us_ = end_us;
+      first_wall_us_ = now_us;
+    } else {
+      const int64_t gap_us = block.timestamp_us - last_end_us_;
+      if (gap_us > AudioRecorderStats::kGapToleranceUs) {
+        stats->timestamp_gaps++;
+        stats->missing_us += gap_us;
+        stats->max_gap_us = std::max(stats->max_gap_us, gap_us);
+      }
+      const int64_t backlog_us =
+          (now_us - first_wall_us_) - (end_us - first_end_us_);
+      stats->max_backlog_us = std::max(stats->max_backlog_us, backlog_us);
+    }
+    last_end_us_ = end_us;
+    stats->media_us = end_us - first_start_us_;
+  }
+
+ private:
+  int64_t first_start_us_ = -1;
+  int64_t first_end_us_ = 0;
+  int64_t first_wall_us_ = 0;
+  int64_t last_end_us_ = 0;
+};
+
+}  // namespace
+
+void LatencyHistogram::Record(uint64_t us) {
+  int bucket = 0;
+  while (bucket < kBuckets - 1 && (us >> (bucket + 1)) != 0) {
+    bucket++;
+  }
+  counts[bucket]++;
+  count++;
+  max_us = std::max(max_us, us);
+}
+
+uint64_t LatencyHistogram::PercentileUs(double percentile) const {
+  if (count == 0) {
+    return 0;
+  }
+  const double wanted = count * std::min(std::max(percentile, 0.0), 100.0) /
+                        100.0;
+  uint64_t seen = 0;
+  for (int bucket = 0; bucket < kBuckets - 1; ++bucket) {
+    seen += counts[bucket];
+    if (seen > 0 && seen >= wanted) {
+      return std::min(max_us, (uint64_t{2} << bucket) - 1);
+    }
+  }
+  return max_us;
+}
+
+std::string DescribeAudioRecorderStats(const AudioRecorderStats& stats) {
+  std::ostringstream out;
+  out << stats.samples << " blocks, " << stats.media_us / 1000 << " ms, "
+      << stats.file_bytes << " bytes; " << stats.xruns << " xruns, "
+      << stats.timestamp_gaps << " gaps (" << stats.missing_us / 1000
+      << " ms missing, longest " << stats.max_gap_us / 1000 << " ms), "
+      << stats.empty_reads << " empty reads; backlog up to "
+      << stats.max_backlog_us / 1000 << " ms; write p50 "
+      << stats.write_latency.PercentileUs(50) << " us, p99 "
+      << stats.write_latency.PercentileUs(99) << " us, max "
+      << stats.write_latency.max_us << " us; finish "
+      << stats.finish_us / 1000 << " ms"
+      << (stats.failed ? "; ended with an error" : "");
+  return out.str();
+}
+
+AudioRecorder::AudioRecorder(std::unique_ptr<AudioCaptureBackend> backend)
+    : backend_(std::move(backend)) {}
+
+AudioRecorder::~AudioRecorder() { Stop(); }
+
+bool AudioRecorder::Start(const std::string& path) {
+  if (recording_) {
+    return false;
+  }
+  // A loop that failed on its own leaves a finished thread behind;
+  // assigning over a joinable std::thread would terminate.
+  JoinThread();
+  path_ = path;
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_ = AudioRecorderStats();
+  }
+  stop_requested_ = false;
+  recording_ = true;
+  thread_ = std::thread(&AudioRecorder::Run, this);
+  return true;
+}
+
+std::string AudioRecorder::Stop() {
+  if (!recording_) {
+    JoinThread();
+    return std::string();
+  }
+  stop_requested_ = true;
+  JoinThread();
+  recording_ = false;
+  return std::exchange(path_, std::string());
+}
+
+AudioRecorderStats AudioRecorder::last_stats() const {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  return stats_;
+}
+
+void AudioRecorder::Run() {
+  if (!backend_->Open(path_)) {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.failed = true;
+    recording_ = false;
+    return;
+  }
+
+  AudioRecorderStats stats;
+  BlockTimeline timeline;
+  while (!stop_requested_) {
+    AudioBlock block;
+    const AudioCaptureBackend::Step step = backend_->Read(&block);
+    if (step == AudioCaptureBackend::Step::kNoSample) {
+      stats.empty_reads++;
+      continue;
+    }
+    if (step != AudioCaptureBackend::Step::kBlock) {
+      stats.failed = step == AudioCaptureBackend::Step::kError;
+      break;
+    }
+    const int64_t read_us = NowUs();
+    timeline.Add(block, read_us, &stats);
+    if (!backend_->Write()) {
+      stats.failed = true;
+      break;
+    }
+    stats.write_latency.Record(static_cast<uint64_t>(NowUs() - read_us));
+    stats.samples++;
+  }
+  // Whatever ended the loop, the file is finished so what was captured
+  // stays playable.
+  const int64_t close_us = NowUs();
+  backend_->Close();
+  stats.finish_us = NowUs() - close_us;
+  std::error_code error;
+  const uintmax_t size =
+      std::filesystem::file_size(std::filesystem::u8path(path_), error);
+  stats.file_bytes = error ? 0 : static_cast<uint64_t>(size);
+
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  stats_ = stats;
+}
+
+void AudioRecorder::JoinThread() {
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
@@ -0,0 +1,130 @@
+#ifndef NATIVE_RUNNER_AUDIO_RECORDER_H_
+#define NATIVE_RUNNER_AUDIO_RECORDER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// What a capture API says about one block of audio.
+struct AudioBlock {
+  // Capture time of the first frame on the device clock, or -1 when the
+  // API does not give one; the block's length, or 0.
+  int64_t timestamp_us = -1;
+  int64_t duration_us = 0;
+  // The API flagged audio as lost before this block: the device buffer
+  // overran (an xrun).
+  bool discontinuity = false;
+};
+
+// One capture session of a platform audio API: the Windows runner wraps a
+// Media Foundation source reader and sink writer, tests a fake.
+class AudioCaptureBackend {
+ public:
+  enum class Step {
+    kBlock,        // Read a block; Write() it next.
+    kNoSample,     // Nothing this time (a gap in the stream); keep going.
+    kEndOfStream,  // The device went away.
+    kError,
+  };
+
+  virtual ~AudioCaptureBackend() = default;
+
+  // Opens the default input device and the output file.
+  virtual bool Open(const std::string& path) = 0;
+  // Blocks for the next block of audio and describes it in |block|.
+  virtual Step Read(AudioBlock* block) = 0;
+  // Encodes the block Read() returned and hands it to the file.
+  virtual bool Write() = 0;
+  // Finishes the file and releases everything Open() acquired.
+  virtual void Close() = 0;
+};
+
+// Latencies in power-of-two buckets of microseconds: enough to tell a
+// 100 us encode from a 50 ms stall, for the cost of an increment.
+struct LatencyHistogram {
+  static constexpr int kBuckets = 24;  // The last one takes 8 s and up.
+
+  // Bucket 0 counts 0 and 1 us, bucket i values from 2^i to 2^(i+1) - 1.
+  uint32_t counts[kBuckets] = {};
+  uint64_t count = 0;
+  uint64_t max_us = 0;
+
+  void Record(uint64_t us);
+  // The upper bound of the bucket holding |percentile| (0-100), capped at
+  // the maximum; 0 when empty.
+  uint64_t PercentileUs(double percentile) const;
+};
+
+// The health of one recording, for "my voice note cut off" reports.
+struct AudioRecorderStats {
+  uint64_t samples = 0;      // Blocks written.
+  uint64_t empty_reads = 0;  // Reads that came back without a block.
+  uint64_t xruns = 0;        // Blocks the API flagged as following lost audio.
+  // Blocks that started more than kGapToleranceUs after the previous one
+  // ended, and the audio missing between them.
+  uint64_t timestamp_gaps = 0;
+  int64_t missing_us = 0;
+  int64_t max_gap_us = 0;
+  // The most audio the API held queued: how far a block's end lagged the
+  // wall clock, relative to the first block. Grows when writes stall.
+  int64_t max_backlog_us = 0;
+  // From the start of the first block to the end of the last.
+  int64_t media_us = 0;
+  // Write(): encoding a block and handing it to the file.
+  LatencyHistogram write_latency;
+  // Close(): flushing the encoder and finishing the file.
+  int64_t finish_us = 0;
+  uint64_t file_bytes = 0;
+  bool failed = false;  // Open() failed or the loop ended with an error.
+
+  static constexpr int64_t kGapToleranceUs = 1000;
+};
+
+// One line for the runner's log.
+std::string DescribeAudioRecorderStats(const AudioRecorderStats& stats);
+
+// The record/stop logic of the audio recorder channel: a capture loop on
+// its own thread, reading and writing |backend| until Stop(). The loop
+// keeps AudioRecorderStats as it goes, in locals of the capture thread.
+class AudioRecorder {
+ public:
+  explicit AudioRecorder(std::unique_ptr<AudioCaptureBackend> backend);
+  // Stops a recording still running.
+  ~AudioRecorder();
+
+  AudioRecorder(const AudioRecorder&) = delete;
+  AudioRecorder& operator=(const AudioRecorder&) = delete;
+
+  // Starts recording to |path|. Returns false if a recording is running.
+  // The device is opened on the capture thread, so a failure to open shows
+  // up as IsRecording() turning false rather than here.
+  bool Start(const std::string& path);
+
+  // Stops the recording and returns its path, or "" if nothing was
+  // recording (including when the capture loop had already failed).
+  std::string Stop();
+
+  bool IsRecording() const { return recording_; }
+
+  // Of the last recording; read after Stop().
+  AudioRecorderStats last_stats() const;
+
+ private:
+  void Run();
+  // Joins a capture thread that ended on its own.
+  void JoinThread();
+
+  std::unique_ptr<AudioCaptureBackend> backend_;
+  std::string path_;
+  std::thread thread_;
+  std::atomic<bool> recording_{false};
+  std::atomic<bool> stop_requested_{false};
+
+  mutable std::mutex stats_mutex_;
+  AudioRecorderStats stats_;
+};
+
+#endif  // NATIVE_RUNNER_AUDIO_RECORDER_H_
@@ -0,0 +1,51 @@
+#include "runner/click_through.h"
+
+ClickThroughController::ClickThroughController(ClickThroughBackend* backend,
+                                               ClickThroughOptions options)
+    : backend_(backend), options_(options) {}
+
+void ClickThroughController::SetEnabled(bool enabled) {
+  if (enabled) {
+    // The flag goes first so a poll that is already queued sees it.
+    enabled_ = true;
+    if (!polling_) {
+      backend_->StartPolling(options_.poll_interval_ms);
+      polling_ = true;
+    }
+    backend_->SetTransparent(true);
+    transparent_ = true;
+  } else {
+    enabled_ = false;
+    if (polling_) {
+      backend_->StopPolling();
+      polling_ = false;
+    }
+    backend_->SetTransparent(false);
+    transparent_ = false;
+    backend_->RefreshFrame();
+  }
+}
+
+void ClickThroughController::Poll() {
+  if (!enabled_) {
+    return;
+  }
+  ScreenPoint cursor;
+  ScreenRect window;
+  ScreenRect client;
+  if (!backend_->GetCursorPosition(&cursor) ||
+      !backend_->GetWindowRect(&window)) {
+    return;
+  }
+  const bool over_strip = window.Contains(cursor) &&
+                          backend_->GetClientRect(&client) &&
+                          cursor.x >= client.right - options_.visible_width;
+  SetTransparent(!over_strip);
+}
+
+void ClickThroughController::SetTransparent(bool transparent) {
+  if (transparent != transparent_) {
+    backend_->SetTransparent(transparent);
+    transparent_ = transparent;
+  }
+}
@@ -0,0 +1,81 @@
+#ifndef NATIVE_RUNNER_CLICK_THROUGH_H_
+#define NATIVE_RUNNER_CLICK_THROUGH_H_
+
+// Click-through for the collapsed floating window: while it is enabled,
+// clicks pass through the window except over the strip along its right edge
+// that stays visible. The decisions live here; the window system calls are
+// behind ClickThroughBackend, which the Windows runner implements with
+// WS_EX_TRANSPARENT and a polling timer, and tests with a fake.
+
+struct ScreenPoint {
+  int x = 0;
+  int y = 0;
+};
+
+// Half-open: [left, right) x [top, bottom).
+struct ScreenRect {
+  int left = 0;
+  int top = 0;
+  int right = 0;
+  int bottom = 0;
+
+  bool Contains(const ScreenPoint& point) const {
+    return point.x >= left && point.x < right && point.y >= top &&
+           point.y < bottom;
+  }
+};
+
+class ClickThroughBackend {
+ public:
+  virtual ~ClickThroughBackend() = default;
+
+  // Each returns false when the window or cursor is not available.
+  virtual bool GetCursorPosition(ScreenPoint* point) = 0;
+  virtual bool GetWindowRect(ScreenRect* rect) = 0;
+  // The client area, in screen coordinates.
+  virtual bool GetClientRect(ScreenRect* rect) = 0;
+
+  // Lets mouse input through the window, or not.
+  virtual void SetTransparent(bool transparent) = 0;
+  // Makes a style change take effect at once.
+  virtual void RefreshFrame() = 0;
+
+  // Calls ClickThroughController::Poll() every |interval_ms| until stopped.
+  virtual void StartPolling(int interval_ms) = 0;
+  virtual void StopPolling() = 0;
+};
+
+struct ClickThroughOptions {
+  // Width of the strip that stays clickable while collapsed.
+  int visible_width = 85;
+  int poll_interval_ms = 30;
+};
+
+class ClickThroughController {
+ public:
+  explicit ClickThroughController(ClickThroughBackend* backend,
+                                  ClickThroughOptions options = {});
+
+  // Enabling makes the window transparent right away, so a click landing
+  // during the mode switch already passes through, and starts polling.
+  // Disabling always clears transparency, whatever the cached state says.
+  void SetEnabled(bool enabled);
+
+  // Follows the cursor: opaque over the visible strip, transparent
+  // elsewhere. Touches the window style only when that changes.
+  void Poll();
+
+  bool enabled() const { return enabled_; }
+  bool transparent() const { return transparent_; }
+
+ private:
+  void SetTransparent(bool transparent);
+
+  ClickThroughBackend* backend_;
+  ClickThroughOptions options_;
+  bool enabled_ = false;
+  bool polling_ = false;
+  bool transparent_ = false;
+};
+
+#endif  // NATIVE_RUNNER_CLICK_THROUGH_H_
@@ -0,0 +1,120 @@
+#include "runner/monitor_topology.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+namespace {
+
+bool SameRect(const ScreenRect& a, const ScreenRect& b) {
+  return a.left == b.left && a.top == b.top && a.right == b.right &&
+         a.bottom == b.bottom;
+}
+
+int64_t OverlapArea(const ScreenRect& a, const ScreenRect& b) {
+  const int64_t width = std::min(a.right, b.right) - std::max(a.left, b.left);
+  const int64_t height = std::min(a.bottom, b.bottom) - std::max(a.top, b.top);
+  return width > 0 && height > 0 ? width * height : 0;
+}
+
+// How far |value| is outside [low, high).
+int64_t Outside(int value, int low, int high) {
+  if (value < low) {
+    return static_cast<int64_t>(low) - value;
+  }
+  if (value >= high) {
+    return static_cast<int64_t>(value) - high + 1;
+  }
+  return 0;
+}
+
+// Squared distance from |point| to the nearest pixel of |rect|.
+int64_t DistanceSquared(const ScreenRect& rect, const ScreenPoint& point) {
+  const int64_t dx = Outside(point.x, rect.left, rect.right);
+  const int64_t dy = Outside(point.y, rect.top, rect.bottom);
+  return dx * dx + dy * dy;
+}
+
+// |offset| in [low, high], or |low| when the range is empty.
+int ClampOffset(int offset, int low, int high) {
+  return high < low ? low : std::clamp(offset, low, high);
+}
+
+}  // namespace
+
+bool MonitorInfo::operator==(const MonitorInfo& other) const {
+  return SameRect(geometry, other.geometry) &&
+         SameRect(workarea, other.workarea) &&
+         scale_factor == other.scale_factor && primary == other.primary &&
+         model == other.model;
+}
+
+bool MonitorTopology::Update(std::vector<MonitorInfo> monitors) {
+  if (monitors == monitors_) {
+    return false;
+  }
+  monitors_ = std::move(monitors);
+  ++generation_;
+  return true;
+}
+
+const MonitorInfo* MonitorTopology::Primary() const {
+  for (const MonitorInfo& monitor : monitors_) {
+    if (monitor.primary) {
+      return &monitor;
+    }
+  }
+  return monitors_.empty() ? nullptr : &monitors_.front();
+}
+
+const MonitorInfo* MonitorTopology::MonitorFor(const ScreenRect& rect) const {
+  const MonitorInfo* best = nullptr;
+  int64_t best_overlap = 0;
+  for (const MonitorInfo& monitor : monitors_) {
+    const int64_t overlap = OverlapArea(rect, monitor.geometry);
+    if (overlap > best_overlap) {
+      best = &monitor;
+      best_overlap = overlap;
+    }
+  }
+  if (best != nullptr) {
+    return best;
+  }
+  const ScreenPoint centre = {rect.left + (rect.right - rect.left) / 2,
+                              rect.top + (rect.bottom - rect.top) / 2};
+  int64_t best_distance = INT64_MAX;
+  for (const MonitorInfo& monitor : monitors_) {
+    const int64_t distance = DistanceSquared(monitor.geometry, centre);
+    if (distance < best_distance) {
+      best = &monitor;
+      best_distance = distance;
+    }
+  }
+  return best;
+}
+
+ScreenRect MonitorTopology::Clamp(const ScreenRect& rect) const {
+  const MonitorInfo* monitor = MonitorFor(rect);
+  if (monitor == nullptr) {
+    return rect;
+  }
+  const ScreenRect& area = monitor->workarea;
+  const int width = rect.right - rect.left;
+  const int height = rect.bottom - rect.top;
+  const int left = ClampOffset(rect.left, area.left, area.right - width);
+  const int top = ClampOffset(rect.top, area.top, area.bottom - height);
+  return {left, top, left + width, top + height};
+}
+
+ScreenRect MonitorTopology::SnapToRightEdge(const ScreenRect& rect) const {
+  ScreenRect clamped = Clamp(rect);
+  const MonitorInfo* monitor = MonitorFor(clamped);
+  if (monitor == nullptr) {
+    return clamped;
+  }
+  const int width = clamped.right - clamped.left;
+  clamped.left = std::max(monitor->workarea.left,
+                          monitor->workarea.right - width);
+  clamped.right = clamped.left + width;
+  return clamped;
+}
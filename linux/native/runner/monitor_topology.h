@@ -0,0 +1,58 @@
+#ifndef NATIVE_RUNNER_MONITOR_TOPOLOGY_H_
+#define NATIVE_RUNNER_MONITOR_TOPOLOGY_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "runner/click_through.h"
+
+// The monitors as the window system last described them, kept by the runner
+// and updated from display signals, so placing the floating window never has
+// to ask for them. Coordinates are logical pixels on the whole desktop.
+
+struct MonitorInfo {
+  ScreenRect geometry;
+  // The part not taken by panels and docks.
+  ScreenRect workarea;
+  int scale_factor = 1;
+  bool primary = false;
+  std::string model;
+
+  bool operator==(const MonitorInfo& other) const;
+  bool operator!=(const MonitorInfo& other) const { return !(*this == other); }
+};
+
+class MonitorTopology {
+ public:
+  // Replaces the monitors. Returns true, and bumps generation(), only when
+  // something differs from what was there; displays signal a good deal more
+  // often than the layout actually changes.
+  bool Update(std::vector<MonitorInfo> monitors);
+
+  const std::vector<MonitorInfo>& monitors() const { return monitors_; }
+  uint64_t generation() const { return generation_; }
+
+  // The primary monitor, the first one when none is marked, or null when
+  // there are none.
+  const MonitorInfo* Primary() const;
+
+  // The monitor |rect| overlaps most; when it is off every monitor, the one
+  // nearest its centre. Null when there are none.
+  const MonitorInfo* MonitorFor(const ScreenRect& rect) const;
+
+  // |rect| moved, not resized, to lie inside the work area of MonitorFor().
+  // Too big to fit, it keeps to the work area's top left. Unchanged when
+  // there are no monitors.
+  ScreenRect Clamp(const ScreenRect& rect) const;
+
+  // Clamp(), then against the work area's right edge: where the floating
+  // widget goes after a drag.
+  ScreenRect SnapToRightEdge(const ScreenRect& rect) const;
+
+ private:
+  std::vector<MonitorInfo> monitors_;
+  uint64_t generation_ = 0;
+};
+
+#endif  // NATIVE_RUNNER_MONITOR_TOPOLOGY_H_
@@ -0,0 +1,201 @@
+#include "runner/notification_dispatcher.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// What a digest lists for one event.
+const std::string& DigestLine(const NotificationEvent& event) {
+  return event.title.empty() ? event.body : event.title;
+}
+
+}  // namespace
+
+NotificationDispatcher::NotificationDispatcher(
+    NotificationBackend* backend, NotificationDispatcherOptions options)
+    : backend_(backend), options_(options), tokens_(options.burst) {}
+
+void NotificationDispatcher::Submit(NotificationEvent event, int64_t now_ms) {
+  stats_.submitted++;
+  const int lane = std::clamp(static_cast<int>(event.priority), 0,
+                              kNotificationLanes - 1);
+  std::vector<Group>& groups = lanes_[lane];
+  auto group = std::find_if(groups.begin(), groups.end(), [&](const Group& g) {
+    return g.events.front().type == event.type;
+  });
+  if (group != groups.end()) {
+    group->events.push_back(std::move(event));
+  } else {
+    Group added;
+    added.due_ms = now_ms + options_.coalesce_window_ms[lane];
+    added.events.push_back(std::move(event));
+    groups.push_back(std::move(added));
+  }
+  Pump(now_ms);
+}
+
+void NotificationDispatcher::Tick(int64_t now_ms) {
+  // The backend's request has fired.
+  scheduled_ms_ = kNoTick;
+  Pump(now_ms);
+}
+
+void NotificationDispatcher::OnShown(uint64_t handle, uint32_t server_id) {
+  auto popup = std::find_if(popups_.begin(), popups_.end(),
+                            [&](const Popup& p) { return p.handle == handle; });
+  if (popup == popups_.end()) {
+    return;
+  }
+  if (server_id == 0) {
+    stats_.failed++;
+    popups_.erase(popup);
+  } else {
+    popup->server_id = server_id;
+  }
+}
+
+bool NotificationDispatcher::OnAction(uint32_t server_id,
+                                      std::string_view action,
+                                      NotificationResponse* out) {
+  Popup* popup = FindPopup(server_id);
+  if (popup == nullptr) {
+    return false;
+  }
+  out->action = std::string(action);
+  out->event_ids = std::move(popup->event_ids);
+  // Used up; the close that follows has nothing left to do.
+  popups_.erase(popups_.begin() + (popup - popups_.data()));
+  return true;
+}
+
+void NotificationDispatcher::OnClosed(uint32_t server_id) {
+  Popup* popup = FindPopup(server_id);
+  if (popup != nullptr) {
+    popups_.erase(popups_.begin() + (popup - popups_.data()));
+  }
+}
+
+NotificationStats NotificationDispatcher::stats() const {
+  NotificationStats stats = stats_;
+  for (const std::vector<Group>& groups : lanes_) {
+    for (const Group& group : groups) {
+      stats.pending += group.events.size();
+    }
+  }
+  return stats;
+}
+
+void NotificationDispatcher::Refill(int64_t now_ms) {
+  if (!started_ || tokens_ >= options_.burst) {
+    // A full bucket starts counting when the first token is spent.
+    started_ = true;
+    refilled_ms_ = now_ms;
+    return;
+  }
+  const int64_t gained = (now_ms - refilled_ms_) / options_.refill_interval_ms;
+  if (gained <= 0) {
+    return;
+  }
+  if (gained >= options_.burst - tokens_) {
+    tokens_ = options_.burst;
+    refilled_ms_ = now_ms;
+  } else {
+    tokens_ += static_cast<int>(gained);
+    refilled_ms_ += gained * options_.refill_interval_ms;
+  }
+}
+
+void NotificationDispatcher::Pump(int64_t now_ms) {
+  Refill(now_ms);
+  while (tokens_ > 0) {
+    // A lane's window is fixed, so its first group is due first.
+    std::vector<Group>* due = nullptr;
+    for (std::vector<Group>& groups : lanes_) {
+      if (!groups.empty() && groups.front().due_ms <= now_ms) {
+        due = &groups;
+        break;
+      }
+    }
+    if (due == nullptr) {
+      break;
+    }
+    std::vector<NotificationEvent> events = std::move(due->front().events);
+    due->erase(due->begin());
+    tokens_--;
+
+    stats_.popups++;
+    stats_.coalesced += events.size() - 1;
+    Popup popup;
+    popup.handle = next_handle_++;
+    for (const NotificationEvent& event : events) {
+      popup.event_ids.push_back(event.id);
+    }
+    if (popups_.size() >= options_.tracked_popups) {
+      popups_.erase(popups_.begin());
+    }
+    popups_.push_back(std::move(popup));
+    // The backend may report back at once.
+    backend_->Show(popups_.back().handle, MakeDigest(std::move(events)));
+  }
+
+  int64_t next_ms = kNoTick;
+  for (const std::vector<Group>& groups : lanes_) {
+    if (!groups.empty() &&
+        (next_ms == kNoTick || groups.front().due_ms < next_ms)) {
+      next_ms = groups.front().due_ms;
+    }
+  }
+  if (next_ms != kNoTick && tokens_ == 0) {
+    next_ms = std::max(next_ms, refilled_ms_ + options_.refill_interval_ms);
+  }
+  if (next_ms != scheduled_ms_) {
+    scheduled_ms_ = next_ms;
+    backend_->ScheduleTick(next_ms);
+  }
+}
+
+NotificationDigest NotificationDispatcher::MakeDigest(
+    std::vector<NotificationEvent> events) const {
+  NotificationEvent& first = events.front();
+  NotificationDigest digest;
+  digest.type = first.type;
+  digest.priority = first.priority;
+  digest.buttons = std::move(first.buttons);
+  for (const NotificationEvent& event : events) {
+    digest.event_ids.push_back(event.id);
+  }
+  if (events.size() == 1) {
+    digest.title = first.title.empty() ? first.group_title : first.title;
+    digest.body = first.body;
+    return digest;
+  }
+
+  digest.title = first.group_title.empty() ? first.title : first.group_title;
+  digest.title += " (" + std::to_string(events.size()) + ")";
+  // Newest first.
+  const size_t listed = std::min(events.size(), options_.digest_lines);
+  for (size_t i = 0; i < listed; i++) {
+    if (i > 0) {
+      digest.body += '\n';
+    }
+    digest.body += DigestLine(events[events.size() - 1 - i]);
+  }
+  if (listed < events.size()) {
+    digest.body += "\nand " + std::to_string(events.size() - listed) + " more";
+  }
+  return digest;
+}
+
+NotificationDispatcher::Popup* NotificationDispatcher::FindPopup(
+    uint32_t server_id) {
+  if (server_id == 0) {
+    return nullptr;
+  }
+  for (Popup& popup : popups_) {
+    if (popup.server_id == server_id) {
+      return &popup;
+    }
+  }
+  return nullptr;
+}
@@ -0,0 +1,159 @@
+#ifndef NATIVE_RUNNER_NOTIFICATION_DISPATCHER_H_
+#define NATIVE_RUNNER_NOTIFICATION_DISPATCHER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Desktop notifications for server events, throttled. Events wait in one of
+// three priority lanes for a short coalescing window, during which later
+// events of the same type join them; each group then goes out as a single
+// popup (a digest when it holds more than one event). Popups spend tokens
+// from a bucket, so a storm of events after a reconnect or a bulk
+// assignment becomes a handful of digests instead of hundreds of popups.
+// Groups that find the bucket empty keep absorbing events until a token
+// frees up, and higher lanes go first.
+//
+// The decisions live here; showing popups and waking up are behind
+// NotificationBackend, which the Linux runner implements over
+// org.freedesktop.Notifications and a GLib timeout, and tests with a fake.
+// Times are milliseconds on a monotonic clock.
+
+enum class NotificationPriority : int {
+  kHigh = 0,    // Needs the user: approvals, attendance.
+  kNormal = 1,
+  kLow = 2,     // Announcements.
+};
+constexpr int kNotificationLanes = 3;
+
+struct NotificationButton {
+  std::string key;    // Reported back when used.
+  std::string label;
+};
+
+struct NotificationEvent {
+  std::string id;
+  // Events of one type coalesce.
+  std::string type;
+  std::string title;
+  std::string body;
+  // Title of a digest of this type, e.g. "Approval Needed".
+  std::string group_title;
+  NotificationPriority priority = NotificationPriority::kNormal;
+  std::vector<NotificationButton> buttons;
+};
+
+// One popup.
+struct NotificationDigest {
+  std::string type;
+  NotificationPriority priority = NotificationPriority::kNormal;
+  std::string title;
+  std::string body;
+  // The first event's.
+  std::vector<NotificationButton> buttons;
+  // Oldest first.
+  std::vector<std::string> event_ids;
+};
+
+struct NotificationResponse {
+  std::string action;
+  std::vector<std::string> event_ids;
+};
+
+class NotificationBackend {
+ public:
+  virtual ~NotificationBackend() = default;
+
+  // Puts |digest| on screen, then reports the server's id for it with
+  // NotificationDispatcher::OnShown(|handle|, ...).
+  virtual void Show(uint64_t handle, const NotificationDigest& digest) = 0;
+
+  // Calls NotificationDispatcher::Tick() at |due_ms|, replacing the
+  // previous request; kNoTick cancels it.
+  virtual void ScheduleTick(int64_t due_ms) = 0;
+};
+
+struct NotificationDispatcherOptions {
+  // Token bucket: popups in a burst, then one per refill interval.
+  int burst = 3;
+  int64_t refill_interval_ms = 4000;
+  // How long the first event of a group waits for others, per lane.
+  int64_t coalesce_window_ms[kNotificationLanes] = {250, 1500, 5000};
+  // Event titles listed in a digest's body.
+  size_t digest_lines = 3;
+  // Popups remembered for routing their actions.
+  size_t tracked_popups = 32;
+};
+
+struct NotificationStats {
+  uint64_t submitted = 0;
+  uint64_t popups = 0;
+  // Events that went out inside another event's popup.
+  uint64_t coalesced = 0;
+  // Popups the backend could not show.
+  uint64_t failed = 0;
+  // Events still waiting.
+  uint64_t pending = 0;
+};
+
+class NotificationDispatcher {
+ public:
+  static constexpr int64_t kNoTick = -1;
+
+  explicit NotificationDispatcher(NotificationBackend* backend,
+                                  NotificationDispatcherOptions options = {});
+
+  void Submit(NotificationEvent event, int64_t now_ms);
+
+  // Sends the groups that are due and have a token.
+  void Tick(int64_t now_ms);
+
+  // The server's id for the popup of |handle|; 0 if it failed.
+  void OnShown(uint64_t handle, uint32_t server_id);
+
+  // |action| was used on popup |server_id|. Fills |out| with the events it
+  // stood for; false if the popup is not ours or long gone.
+  bool OnAction(uint32_t server_id, std::string_view action,
+                NotificationResponse* out);
+
+  // Popup |server_id| went away.
+  void OnClosed(uint32_t server_id);
+
+  NotificationStats stats() const;
+
+ private:
+  struct Group {
+    int64_t due_ms = 0;
+    std::vector<NotificationEvent> events;
+  };
+  struct Popup {
+    uint64_t handle = 0;
+    uint32_t server_id = 0;
+    std::vector<std::string> event_ids;
+  };
+
+  void Refill(int64_t now_ms);
+  // Sends what it can, then asks for the next wakeup.
+  void Pump(int64_t now_ms);
+  NotificationDigest MakeDigest(std::vector<NotificationEvent> events) const;
+  Popup* FindPopup(uint32_t server_id);
+
+  NotificationBackend* backend_;
+  NotificationDispatcherOptions options_;
+
+  // Per lane, in order of arrival; at most one group per type.
+  std::vector<Group> lanes_[kNotificationLanes];
+
+  int tokens_;
+  int64_t refilled_ms_ = 0;
+  bool started_ = false;
+
+  std::vector<Popup> popups_;  // Oldest first.
+  uint64_t next_handle_ = 1;
+  int64_t scheduled_ms_ = kNoTick;
+  NotificationStats stats_;
+};
+
+#endif  // NATIVE_RUNNER_NOTIFICATION_DISPATCHER_H_
@@ -0,0 +1,114 @@
+#include "runner/utf16.h"
+
+#include <cstdint>
+
+namespace {
+
+bool IsHighSurrogate(char16_t unit) {
+  return unit >= 0xD800 && unit <= 0xDBFF;
+}
+
+bool IsLowSurrogate(char16_t unit) {
+  return unit >= 0xDC00 && unit <= 0xDFFF;
+}
+
+void AppendUtf8(std::string* out, uint32_t code_point) {
+  if (code_point < 0x80) {
+    out->push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    out->push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    out->push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    out->push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+}  // namespace
+
+std::string Utf8FromUtf16(std::u16string_view utf16) {
+  std::string out;
+  // Most runner strings are paths and arguments, which are mostly ASCII.
+  out.reserve(utf16.size());
+  for (size_t i = 0; i < utf16.size(); i++) {
+    const char16_t unit = utf16[i];
+    if (unit < 0x80) {
+      out.push_back(static_cast<char>(unit));
+      continue;
+    }
+    uint32_t code_point = unit;
+    if (IsHighSurrogate(unit)) {
+      if (i + 1 == utf16.size() || !IsLowSurrogate(utf16[i + 1])) {
+        return std::string();
+      }
+      code_point = 0x10000 + ((static_cast<uint32_t>(unit) - 0xD800) << 10) +
+                   (static_cast<uint32_t>(utf16[++i]) - 0xDC00);
+    } else if (IsLowSurrogate(unit)) {
+      return std::string();
+    }
+    AppendUtf8(&out, code_point);
+  }
+  return out;
+}
+
+std::u16string Utf16FromUtf8(std::string_view utf8) {
+  std::u16string out;
+  out.reserve(utf8.size());
+  size_t i = 0;
+  while (i < utf8.size()) {
+    const uint8_t lead = static_cast<uint8_t>(utf8[i]);
+    if (lead < 0x80) {
+      out.push_back(lead);
+      i++;
+      continue;
+    }
+    size_t length;
+    uint32_t code_point;
+    uint32_t min;
+    if ((lead & 0xE0) == 0xC0) {
+      length = 2;
+      code_point = lead & 0x1F;
+      min = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+      length = 3;
+      code_point = lead & 0x0F;
+      min = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+      length = 4;
+      code_point = lead & 0x07;
+      min = 0x10000;
+    } else {
+      return std::u16string();
+    }
+    if (utf8.size() - i < length) {
+      return std::u16string();
+    }
+    for (size_t k = 1; k < length; k++) {
+      const uint8_t next = static_cast<uint8_t>(utf8[i + k]);
+      if ((next & 0xC0) != 0x80) {
+        return std::u16string();
+      }
+      code_point = (code_point << 6) | (next & 0x3F);
+    }
+    // Overlong forms, surrogates and values past U+10FFFF are not UTF-8.
+    if (code_point < min || code_point > 0x10FFFF ||
+        (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+      return std::u16string();
+    }
+    if (code_point >= 0x10000) {
+      code_point -= 0x10000;
+      out.push_back(static_cast<char16_t>(0xD800 + (code_point >> 10)));
+      out.push_back(static_cast<char16_t>(0xDC00 + (code_point & 0x3FF)));
+    } else {
+      out.push_back(static_cast<char16_t>(code_point));
+    }
+    i += length;
+  }
+  return out;
+}
@@ -0,0 +1,15 @@
+#ifndef NATIVE_RUNNER_UTF16_H_
+#define NATIVE_RUNNER_UTF16_H_
+
+#include <string>
+#include <string_view>
+
+// UTF-16 <-> UTF-8 for the Windows runner, whose APIs speak UTF-16. Written
+// out here rather than with WideCharToMultiByte so it builds and is tested
+// on any platform. Both reject malformed input (an unpaired surrogate, a bad
+// UTF-8 sequence) by returning an empty string, as WC_ERR_INVALID_CHARS
+// does.
+std::string Utf8FromUtf16(std::u16string_view utf16);
+std::u16string Utf16FromUtf8(std::string_view utf8);
+
+#endif  // NATIVE_RUNNER_UTF16_H_
@@ -0,0 +1,74 @@
+#include "scheduler/main_thread_queue.h"
+
+#include <time.h>
+
+namespace {
+
+int64_t MonotonicNs() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+}  // namespace
+
+MainThreadQueue& MainThreadQueue::Get() {
+  static MainThreadQueue* queue = new MainThreadQueue();
+  return *queue;
+}
+
+void MainThreadQueue::SetWakeFunction(WakeFunction wake, void* data) {
+  bool wake_now = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    wake_ = wake;
+    wake_data_ = data;
+    if (wake_ != nullptr && !queue_.empty() && !wake_pending_) {
+      wake_pending_ = true;
+      wake_now = true;
+    }
+  }
+  if (wake_now) {
+    wake(data);
+  }
+}
+
+void MainThreadQueue::Post(std::function<void()> callback) {
+  WakeFunction wake = nullptr;
+  void* data = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(std::move(callback));
+    if (!wake_pending_ && wake_ != nullptr) {
+      wake_pending_ = true;
+      wake = wake_;
+      data = wake_data_;
+    }
+  }
+  if (wake != nullptr) {
+    wake(data);
+  }
+}
+
+bool MainThreadQueue::Drain(int64_t budget_ns) {
+  const int64_t deadline = MonotonicNs() + budget_ns;
+  while (true) {
+    if (batch_next_ == batch_.size()) {
+      batch_.clear();
+      batch_next_ = 0;
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (queue_.empty()) {
+        wake_pending_ = false;
+        return false;
+      }
+      batch_.swap(queue_);
+    }
+    // Moved out first: the callback may post, or drain recursively from a
+    // nested main loop.
+    std::function<void()> callback = std::move(batch_[batch_next_++]);
+    callback();
+    if (MonotonicNs() >= deadline) {
+      return true;
+    }
+  }
+}
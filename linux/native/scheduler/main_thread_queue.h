@@ -0,0 +1,51 @@
+#ifndef NATIVE_SCHEDULER_MAIN_THREAD_QUEUE_H_
+#define NATIVE_SCHEDULER_MAIN_THREAD_QUEUE_H_
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Hands results from worker threads to the platform (GTK main) thread.
+//
+// Callbacks are run in batches: the first Post() after the queue went empty
+// calls the wake function, which the runner points at its main loop, and
+// the main loop then calls Drain() until it returns false. Posts that
+// arrive meanwhile join the current batch without another wakeup.
+class MainThreadQueue {
+ public:
+  using WakeFunction = void (*)(void* data);
+
+  // The shared queue. Never destroyed.
+  static MainThreadQueue& Get();
+
+  MainThreadQueue() = default;
+
+  MainThreadQueue(const MainThreadQueue&) = delete;
+  MainThreadQueue& operator=(const MainThreadQueue&) = delete;
+
+  // Wakes right away if callbacks are already waiting.
+  void SetWakeFunction(WakeFunction wake, void* data);
+
+  // Any thread.
+  void Post(std::function<void()> callback);
+
+  // Main thread only. Runs queued callbacks until none are left or
+  // |budget_ns| has passed, so a flood of results cannot hold up a frame.
+  // Returns true if callbacks remain; the caller should drain again soon.
+  bool Drain(int64_t budget_ns);
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::function<void()>> queue_;
+  // Set from the wakeup until a Drain() empties the queue.
+  bool wake_pending_ = false;
+  WakeFunction wake_ = nullptr;
+  void* wake_data_ = nullptr;
+
+  // The batch being run; main thread only.
+  std::vector<std::function<void()>> batch_;
+  size_t batch_next_ = 0;
+};
+
+#endif  // NATIVE_SCHEDULER_MAIN_THREAD_QUEUE_H_
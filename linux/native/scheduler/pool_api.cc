@@ -0,0 +1,112 @@
+#include "scheduler/pool_api.h"
+
+#include <memory>
+
+#include "scheduler/main_thread_queue.h"
+#include "scheduler/thread_pool.h"
+
+struct SsTask {
+  TaskHandle handle;
+};
+
+namespace {
+
+// Calls |destroy| when the last copy of the task function goes away, which
+// is after it ran or when a cancelled task is dropped.
+struct CallbackData {
+  CallbackData(SsCallback destroy_function, void* callback_data)
+      : destroy(destroy_function), data(callback_data) {}
+  ~CallbackData() {
+    if (destroy != nullptr) {
+      destroy(data);
+    }
+  }
+
+  SsCallback destroy;
+  void* data;
+};
+
+TaskPriority ToPriority(int32_t priority) {
+  if (priority <= static_cast<int32_t>(TaskPriority::kInteractive)) {
+    return TaskPriority::kInteractive;
+  }
+  if (priority >= static_cast<int32_t>(TaskPriority::kIdle)) {
+    return TaskPriority::kIdle;
+  }
+  return TaskPriority::kBackground;
+}
+
+TaskHandle Submit(int32_t priority, SsTaskRun run, SsCallback destroy,
+                  void* data) {
+  auto callback = std::make_shared<CallbackData>(destroy, data);
+  return ThreadPool::Get().Submit(
+      ToPriority(priority),
+      [run, callback](const CancellationToken& token) {
+        run(callback->data, reinterpret_cast<const SsCancelToken*>(&token));
+      });
+}
+
+}  // namespace
+
+bool ss_pool_configure(const SsPoolOptions* options) {
+  if (options == nullptr) {
+    return false;
+  }
+  ThreadPoolOptions pool_options;
+  pool_options.interactive_threads = options->interactive_threads;
+  pool_options.background_threads = options->background_threads;
+  pool_options.background_nice = options->background_nice;
+  for (int cpu = 0; cpu < 64; cpu++) {
+    if (options->background_cpu_mask & (uint64_t{1} << cpu)) {
+      pool_options.background_cpus.push_back(cpu);
+    }
+  }
+  return ThreadPool::Configure(pool_options);
+}
+
+void ss_pool_post(int32_t priority, SsTaskRun run, SsCallback destroy,
+                  void* data) {
+  if (run != nullptr) {
+    Submit(priority, run, destroy, data);
+  }
+}
+
+SsTask* ss_pool_submit(int32_t priority, SsTaskRun run, SsCallback destroy,
+                       void* data) {
+  if (run == nullptr) {
+    return nullptr;
+  }
+  return new SsTask{Submit(priority, run, destroy, data)};
+}
+
+bool ss_task_cancel(SsTask* task) {
+  return task != nullptr && task->handle.Cancel();
+}
+
+int32_t ss_task_status(const SsTask* task) {
+  return static_cast<int32_t>(task != nullptr ? task->handle.status()
+                                              : TaskStatus::kDone);
+}
+
+void ss_task_release(SsTask* task) {
+  delete task;
+}
+
+bool ss_cancel_token_is_cancelled(const SsCancelToken* token) {
+  return token != nullptr &&
+         reinterpret_cast<const CancellationToken*>(token)->IsCancelled();
+}
+
+void ss_pool_post_to_main(SsCallback callback, void* data) {
+  if (callback != nullptr) {
+    MainThreadQueue::Get().Post([callback, data] { callback(data); });
+  }
+}
+
+void ss_pool_set_main_wakeup(SsCallback wake, void* data) {
+  MainThreadQueue::Get().SetWakeFunction(wake, data);
+}
+
+bool ss_pool_drain_main(int64_t budget_ns) {
+  return MainThreadQueue::Get().Drain(budget_ns);
+}
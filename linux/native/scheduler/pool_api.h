@@ -0,0 +1,66 @@
+#ifndef NATIVE_SCHEDULER_POOL_API_H_
+#define NATIVE_SCHEDULER_POOL_API_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/native_export.h"
+
+// C interface to the shared ThreadPool and MainThreadQueue, for the runner
+// (linux/runner/worker_pool.cc). Priorities are TaskPriority values.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SsTask SsTask;
+typedef struct SsCancelToken SsCancelToken;
+
+typedef void (*SsTaskRun)(void* data, const SsCancelToken* token);
+typedef void (*SsCallback)(void* data);
+
+// Mirrors ThreadPoolOptions. Zero thread counts pick the defaults;
+// |background_cpu_mask| has bit N set for CPU N, or is 0 for all CPUs.
+typedef struct {
+  int32_t interactive_threads;
+  int32_t background_threads;
+  int32_t background_nice;
+  uint64_t background_cpu_mask;
+} SsPoolOptions;
+
+// Must come before anything uses the pool. Returns false once it runs.
+SS_EXPORT bool ss_pool_configure(const SsPoolOptions* options);
+
+// Queues |run|. |destroy| (may be null) is called with |data| exactly once:
+// after |run| returns, or instead of it if the task is cancelled first.
+// ss_pool_submit() returns a handle to release with ss_task_release().
+SS_EXPORT void ss_pool_post(int32_t priority,
+                            SsTaskRun run,
+                            SsCallback destroy,
+                            void* data);
+SS_EXPORT SsTask* ss_pool_submit(int32_t priority,
+                                 SsTaskRun run,
+                                 SsCallback destroy,
+                                 void* data);
+
+// Returns true if the task had not started and now never will.
+SS_EXPORT bool ss_task_cancel(SsTask* task);
+// A TaskStatus value.
+SS_EXPORT int32_t ss_task_status(const SsTask* task);
+SS_EXPORT void ss_task_release(SsTask* task);
+
+SS_EXPORT bool ss_cancel_token_is_cancelled(const SsCancelToken* token);
+
+// Runs |callback| on the main thread in the next batch.
+SS_EXPORT void ss_pool_post_to_main(SsCallback callback, void* data);
+// |wake| is called from any thread when a batch is waiting; it should
+// arrange for ss_pool_drain_main() to run on the main thread.
+SS_EXPORT void ss_pool_set_main_wakeup(SsCallback wake, void* data);
+// Returns true if callbacks remain after |budget_ns|.
+SS_EXPORT bool ss_pool_drain_main(int64_t budget_ns);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // NATIVE_SCHEDULER_POOL_API_H_
@@ -0,0 +1,85 @@
+#ifndef NATIVE_SCHEDULER_TASK_H_
+#define NATIVE_SCHEDULER_TASK_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+// Scheduling class of a task. Interactive tasks have workers of their own;
+// background and idle tasks share a second set of workers that run at a
+// lower nice level, and idle tasks only run there when no background task
+// is waiting.
+enum class TaskPriority {
+  kInteractive = 0,
+  kBackground = 1,
+  kIdle = 2,
+};
+
+constexpr int kTaskPriorityCount = 3;
+
+enum class TaskStatus {
+  kQueued = 0,
+  kRunning = 1,
+  kDone = 2,
+  kCancelled = 3,
+};
+
+// Shared between a queued task and its handles.
+struct TaskState {
+  std::atomic<int> status{static_cast<int>(TaskStatus::kQueued)};
+  std::atomic<bool> cancel_requested{false};
+};
+
+// Passed to a running task so long work can stop early once cancelled.
+class CancellationToken {
+ public:
+  explicit CancellationToken(const TaskState* state) : state_(state) {}
+
+  bool IsCancelled() const {
+    return state_ != nullptr &&
+           state_->cancel_requested.load(std::memory_order_relaxed);
+  }
+
+ private:
+  const TaskState* state_;
+};
+
+using TaskFunction = std::function<void(const CancellationToken&)>;
+
+// Refers to a submitted task. Copies refer to the same task.
+class TaskHandle {
+ public:
+  TaskHandle() = default;
+  explicit TaskHandle(std::shared_ptr<TaskState> state)
+      : state_(std::move(state)) {}
+
+  // Asks the task to stop. Returns true if it had not started, in which case
+  // it never will; a running task sees its token cancelled.
+  bool Cancel() {
+    if (!state_) {
+      return false;
+    }
+    state_->cancel_requested.store(true, std::memory_order_relaxed);
+    int expected = static_cast<int>(TaskStatus::kQueued);
+    return state_->status.compare_exchange_strong(
+        expected, static_cast<int>(TaskStatus::kCancelled));
+  }
+
+  TaskStatus status() const {
+    return state_ ? static_cast<TaskStatus>(state_->status.load())
+                  : TaskStatus::kDone;
+  }
+
+ private:
+  std::shared_ptr<TaskState> state_;
+};
+
+// A queued unit of work. Owned by the pool from Submit() until it has run
+// or been skipped.
+struct PoolTask {
+  TaskFunction function;
+  std::shared_ptr<TaskState> state;
+  TaskPriority priority;
+};
+
+#endif  // NATIVE_SCHEDULER_TASK_H_
@@ -0,0 +1,375 @@
+#include "scheduler/thread_pool.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include "common/thread_id.h"
+#include "logging/logger.h"
+#include "tracing/tracer.h"
+
+namespace {
+
+// Rounds of looking for work, with a yield in between, before a worker goes
+// to sleep. Bursts of small tasks then find workers already awake.
+constexpr int kSpinRounds = 32;
+
+std::mutex shared_mutex;
+ThreadPoolOptions shared_options;
+std::atomic<ThreadPool*> shared_pool{nullptr};
+
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local void* current_worker = nullptr;
+
+int DefaultThreads(int divisor) {
+  int cores = static_cast<int>(std::thread::hardware_concurrency());
+  return std::max(1, cores / divisor);
+}
+
+bool ApplyAffinity(pthread_t thread, const std::vector<int>& cpus) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (cpus.empty()) {
+    long count = sysconf(_SC_NPROCESSORS_CONF);
+    for (long cpu = 0; cpu < count && cpu < CPU_SETSIZE; cpu++) {
+      CPU_SET(cpu, &set);
+    }
+  } else {
+    for (int cpu : cpus) {
+      if (cpu >= 0 && cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &set);
+      }
+    }
+  }
+  return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+}
+
+uint32_t NextRandom(uint32_t* state) {
+  // xorshift32; only spreads steal attempts across victims.
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+}  // namespace
+
+ThreadPool& ThreadPool::Get() {
+  ThreadPool* pool = shared_pool.load(std::memory_order_acquire);
+  if (pool != nullptr) {
+    return *pool;
+  }
+  std::lock_guard<std::mutex> lock(shared_mutex);
+  pool = shared_pool.load(std::memory_order_relaxed);
+  if (pool == nullptr) {
+    pool = new ThreadPool(shared_options);
+    shared_pool.store(pool, std::memory_order_release);
+  }
+  return *pool;
+}
+
+bool ThreadPool::Configure(const ThreadPoolOptions& options) {
+  std::lock_guard<std::mutex> lock(shared_mutex);
+  if (shared_pool.load(std::memory_order_relaxed) != nullptr) {
+    return false;
+  }
+  shared_options = options;
+  return true;
+}
+
+ThreadPool::ThreadPool(const ThreadPoolOptions& options) : options_(options) {
+  interactive_.name = "pool";
+  interactive_.first = TaskPriority::kInteractive;
+  interactive_.last = TaskPriority::kInteractive;
+  background_.name = "bg";
+  background_.first = TaskPriority::kBackground;
+  background_.last = TaskPriority::kIdle;
+
+  StartGroup(&interactive_, options.interactive_threads > 0
+                                ? options.interactive_threads
+                                : DefaultThreads(1));
+  StartGroup(&background_, options.background_threads > 0
+                               ? options.background_threads
+                               : DefaultThreads(2));
+}
+
+ThreadPool::~ThreadPool() {
+  stopping_.store(true);
+  for (Group* group : {&interactive_, &background_}) {
+    {
+      std::lock_guard<std::mutex> lock(group->mutex);
+      group->wake.notify_all();
+    }
+    for (auto& worker : group->workers) {
+      worker->thread.join();
+    }
+  }
+  // Tasks that never ran.
+  for (Group* group : {&interactive_, &background_}) {
+    for (int p = 0; p < kTaskPriorityCount; p++) {
+      for (PoolTask* task : group->injected[p]) {
+        delete task;
+      }
+      for (auto& worker : group->workers) {
+        while (PoolTask* task = worker->deques[p].Pop()) {
+          delete task;
+        }
+      }
+    }
+  }
+}
+
+void ThreadPool::StartGroup(Group* group, int threads) {
+  for (int i = 0; i < threads; i++) {
+    auto worker = std::make_unique<Worker>();
+    worker->group = group;
+    worker->index = i;
+    worker->random = 0x9e3779b9u * static_cast<uint32_t>(i + 1);
+    group->workers.push_back(std::move(worker));
+  }
+  // Start only once the vector is complete; workers index into it to steal.
+  for (auto& worker : group->workers) {
+    worker->thread = std::thread(&ThreadPool::WorkerMain, this, worker.get());
+  }
+}
+
+ThreadPool::Group& ThreadPool::GroupFor(TaskPriority priority) {
+  return priority == TaskPriority::kInteractive ? interactive_ : background_;
+}
+
+TaskHandle ThreadPool::Submit(TaskPriority priority, TaskFunction function) {
+  PoolTask* task =
+      new PoolTask{std::move(function), std::make_shared<TaskState>(), priority};
+  TaskHandle handle(task->state);
+  Group& group = GroupFor(priority);
+  const int p = static_cast<int>(priority);
+
+  // Counted before it is visible so a worker that takes it never sees the
+  // count go negative.
+  group.pending.fetch_add(1);
+  Worker* worker = static_cast<Worker*>(current_worker);
+  if (current_pool == this && worker->group == &group) {
+    worker->deques[p].Push(task);
+  } else {
+    std::lock_guard<std::mutex> lock(group.mutex);
+    group.injected[p].push_back(task);
+    group.injected_size[p].fetch_add(1, std::memory_order_relaxed);
+  }
+  if (group.sleepers.load() > 0) {
+    std::lock_guard<std::mutex> lock(group.mutex);
+    group.wake.notify_one();
+  }
+  return handle;
+}
+
+bool ThreadPool::IsWorkerThread() const {
+  return current_pool == this;
+}
+
+bool ThreadPool::RunPendingTask() {
+  if (current_pool != this) {
+    return false;
+  }
+  PoolTask* task = FindTask(static_cast<Worker*>(current_worker));
+  if (task == nullptr) {
+    return false;
+  }
+  Execute(task);
+  return true;
+}
+
+void ThreadPool::WorkerMain(Worker* worker) {
+  current_pool = this;
+  current_worker = worker;
+  worker->thread_id.store(CurrentThreadId());
+  Group* group = worker->group;
+
+  const std::string name =
+      "ss-" + group->name + "-" + std::to_string(worker->index);
+  pthread_setname_np(pthread_self(), name.c_str());
+  Tracer::Get().SetThreadName(name);
+  if (group == &background_) {
+    if (setpriority(PRIO_PROCESS, CurrentThreadId(),
+                    options_.background_nice) != 0) {
+      SS_LOG(LogLevel::kWarning, "scheduler",
+             "Cannot set nice {} on background worker {}",
+             options_.background_nice, worker->index);
+    }
+    if (!options_.background_cpus.empty() &&
+        !ApplyAffinity(pthread_self(), options_.background_cpus)) {
+      SS_LOG(LogLevel::kWarning, "scheduler",
+             "Cannot set CPU affinity of background worker {}",
+             worker->index);
+    }
+  }
+
+  int idle_rounds = 0;
+  while (!stopping_.load(std::memory_order_relaxed)) {
+    if (PoolTask* task = FindTask(worker)) {
+      Execute(task);
+      idle_rounds = 0;
+      continue;
+    }
+    if (++idle_rounds < kSpinRounds) {
+      std::this_thread::yield();
+      continue;
+    }
+    idle_rounds = 0;
+    // A submitter that sees no sleepers skips the notify, so announce the
+    // sleep before the final check under the lock.
+    group->sleepers.fetch_add(1);
+    {
+      std::unique_lock<std::mutex> lock(group->mutex);
+      group->wake.wait(lock, [this, group] {
+        return group->pending.load() > 0 || stopping_.load();
+      });
+    }
+    group->sleepers.fetch_sub(1);
+  }
+}
+
+PoolTask* ThreadPool::FindTask(Worker* worker) {
+  Group* group = worker->group;
+  for (int p = static_cast<int>(group->first);
+       p <= static_cast<int>(group->last); p++) {
+    PoolTask* task = worker->deques[p].Pop();
+    if (task == nullptr) {
+      task = TakeInjected(group, p);
+    }
+    if (task == nullptr) {
+      task = StealFrom(worker, p);
+    }
+    if (task != nullptr) {
+      // More work than awake workers: pass the wakeup along.
+      if (group->pending.fetch_sub(1) > 1 && group->sleepers.load() > 0) {
+        std::lock_guard<std::mutex> lock(group->mutex);
+        group->wake.notify_one();
+      }
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+PoolTask* ThreadPool::TakeInjected(Group* group, int priority) {
+  if (group->injected_size[priority].load(std::memory_order_relaxed) == 0) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(group->mutex);
+  std::deque<PoolTask*>& queue = group->injected[priority];
+  if (queue.empty()) {
+    return nullptr;
+  }
+  PoolTask* task = queue.front();
+  queue.pop_front();
+  group->injected_size[priority].fetch_sub(1, std::memory_order_relaxed);
+  return task;
+}
+
+PoolTask* ThreadPool::StealFrom(Worker* worker, int priority) {
+  const auto& workers = worker->group->workers;
+  const size_t count = workers.size();
+  if (count < 2) {
+    return nullptr;
+  }
+  const size_t start = NextRandom(&worker->random) % count;
+  for (size_t i = 0; i < count; i++) {
+    Worker* victim = workers[(start + i) % count].get();
+    if (victim == worker) {
+      continue;
+    }
+    if (PoolTask* task = victim->deques[priority].Steal()) {
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+void ThreadPool::Execute(PoolTask* task) {
+  int expected = static_cast<int>(TaskStatus::kQueued);
+  if (task->state->status.compare_exchange_strong(
+          expected, static_cast<int>(TaskStatus::kRunning))) {
+    SS_TRACE_SCOPE("scheduler", "task");
+    task->function(CancellationToken(task->state.get()));
+    task->state->status.store(static_cast<int>(TaskStatus::kDone));
+  }
+  delete task;
+}
+
+bool ThreadPool::SetBackgroundNice(int nice) {
+  bool ok = true;
+  for (auto& worker : background_.workers) {
+    uint32_t thread_id = worker->thread_id.load();
+    if (thread_id == 0 || setpriority(PRIO_PROCESS, thread_id, nice) != 0) {
+      ok = false;
+    }
+  }
+  if (ok) {
+    options_.background_nice = nice;
+  }
+  return ok;
+}
+
+bool ThreadPool::SetBackgroundAffinity(const std::vector<int>& cpus) {
+  bool ok = true;
+  for (auto& worker : background_.workers) {
+    if (!ApplyAffinity(worker->thread.native_handle(), cpus)) {
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+int ThreadPool::interactive_threads() const {
+  return static_cast<int>(interactive_.workers.size());
+}
+
+int ThreadPool::background_threads() const {
+  return static_cast<int>(background_.workers.size());
+}
+
+TaskGroup::TaskGroup(ThreadPool* pool, TaskPriority priority)
+    : pool_(pool), priority_(priority) {}
+
+TaskGroup::~TaskGroup() {
+  Wait();
+}
+
+void TaskGroup::Run(std::function<void()> function) {
+  pending_.fetch_add(1);
+  pool_->Submit(priority_,
+                [this, function = std::move(function)](
+                    const CancellationToken&) {
+                  function();
+                  Done();
+                });
+}
+
+void TaskGroup::Done() {
+  // Under the lock so Wait() cannot return, and the group go away, between
+  // the decrement and the notify.
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (pending_.fetch_sub(1) == 1) {
+    done_.notify_all();
+  }
+}
+
+void TaskGroup::Wait() {
+  if (pool_->IsWorkerThread()) {
+    while (pending_.load() > 0) {
+      if (!pool_->RunPendingTask()) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait_for(lock, std::chrono::milliseconds(1),
+                       [this] { return pending_.load() == 0; });
+      }
+    }
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this] { return pending_.load() == 0; });
+}
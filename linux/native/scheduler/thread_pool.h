@@ -0,0 +1,134 @@
+#ifndef NATIVE_SCHEDULER_THREAD_POOL_H_
+#define NATIVE_SCHEDULER_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "scheduler/task.h"
+#include "scheduler/work_stealing_deque.h"
+
+struct ThreadPoolOptions {
+  // 0 picks one per core.
+  int interactive_threads = 0;
+  // 0 picks one per two cores.
+  int background_threads = 0;
+  // Nice level of the background workers; only ever raised (made nicer)
+  // unless the process may lower it.
+  int background_nice = 10;
+  // CPUs the background workers may run on; empty for all.
+  std::vector<int> background_cpus;
+};
+
+// The process-wide work-stealing scheduler for native services.
+//
+// Each scheduling class is served by its own set of workers (see
+// TaskPriority). A task submitted from one of the workers that serve its
+// class goes onto that worker's deque; others go onto a shared injection
+// queue. Idle workers take from their own deque, then the injection queue,
+// then steal from siblings, and sleep once there is nothing left.
+class ThreadPool {
+ public:
+  // The shared pool, started on first use. Never destroyed.
+  static ThreadPool& Get();
+
+  // Options for the shared pool. Returns false once it has started.
+  static bool Configure(const ThreadPoolOptions& options);
+
+  explicit ThreadPool(const ThreadPoolOptions& options);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  TaskHandle Submit(TaskPriority priority, TaskFunction function);
+
+  // Runs one queued task of the calling worker's classes, if there is one.
+  // Lets a worker make progress while it waits for other tasks. Returns
+  // false on threads outside the pool.
+  bool RunPendingTask();
+
+  // Whether the calling thread is one of this pool's workers.
+  bool IsWorkerThread() const;
+
+  // Changes the nice level or CPU set of the running background workers.
+  // Returns false if the kernel refused it for any of them.
+  bool SetBackgroundNice(int nice);
+  bool SetBackgroundAffinity(const std::vector<int>& cpus);
+
+  int interactive_threads() const;
+  int background_threads() const;
+
+ private:
+  struct Group;
+
+  struct Worker {
+    Group* group = nullptr;
+    int index = 0;
+    uint32_t random = 0;
+    std::atomic<uint32_t> thread_id{0};
+    WorkStealingDeque deques[kTaskPriorityCount];
+    std::thread thread;
+  };
+
+  struct Group {
+    std::string name;
+    TaskPriority first;
+    TaskPriority last;
+    std::vector<std::unique_ptr<Worker>> workers;
+    // Tasks queued anywhere in the group and not yet taken.
+    std::atomic<int64_t> pending{0};
+    std::atomic<int> sleepers{0};
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<PoolTask*> injected[kTaskPriorityCount];
+    std::atomic<size_t> injected_size[kTaskPriorityCount] = {};
+  };
+
+  Group& GroupFor(TaskPriority priority);
+  void StartGroup(Group* group, int threads);
+  void WorkerMain(Worker* worker);
+  PoolTask* FindTask(Worker* worker);
+  PoolTask* TakeInjected(Group* group, int priority);
+  PoolTask* StealFrom(Worker* worker, int priority);
+  void Execute(PoolTask* task);
+
+  ThreadPoolOptions options_;
+  Group interactive_;
+  Group background_;
+  std::atomic<bool> stopping_{false};
+};
+
+// Runs a set of functions on the pool and waits for all of them.
+//
+// Wait() on a pool worker runs other queued tasks instead of blocking the
+// worker, so groups may nest.
+class TaskGroup {
+ public:
+  TaskGroup(ThreadPool* pool, TaskPriority priority);
+  ~TaskGroup();
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  void Run(std::function<void()> function);
+  void Wait();
+
+ private:
+  void Done();
+
+  ThreadPool* pool_;
+  const TaskPriority priority_;
+  std::atomic<int> pending_{0};
+  std::mutex mutex_;
+  std::condition_variable done_;
+};
+
+#endif  // NATIVE_SCHEDULER_THREAD_POOL_H_
@@ -0,0 +1,86 @@
+#include "scheduler/work_stealing_deque.h"
+
+WorkStealingDeque::Ring::Ring(size_t ring_capacity)
+    : capacity(ring_capacity),
+      mask(static_cast<int64_t>(ring_capacity) - 1),
+      slots(new std::atomic<PoolTask*>[ring_capacity]) {}
+
+WorkStealingDeque::WorkStealingDeque(size_t capacity) {
+  size_t rounded = 16;
+  while (rounded < capacity) {
+    rounded <<= 1;
+  }
+  rings_.push_back(std::make_unique<Ring>(rounded));
+  ring_.store(rings_.back().get(), std::memory_order_relaxed);
+}
+
+WorkStealingDeque::~WorkStealingDeque() = default;
+
+WorkStealingDeque::Ring* WorkStealingDeque::Grow(Ring* ring, int64_t top,
+                                                 int64_t bottom) {
+  auto grown = std::make_unique<Ring>(ring->capacity * 2);
+  for (int64_t i = top; i < bottom; i++) {
+    grown->Put(i, ring->Get(i));
+  }
+  Ring* result = grown.get();
+  rings_.push_back(std::move(grown));
+  ring_.store(result, std::memory_order_release);
+  return result;
+}
+
+void WorkStealingDeque::Push(PoolTask* task) {
+  const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+  const int64_t top = top_.load(std::memory_order_acquire);
+  Ring* ring = ring_.load(std::memory_order_relaxed);
+  if (bottom - top > static_cast<int64_t>(ring->capacity) - 1) {
+    ring = Grow(ring, top, bottom);
+  }
+  ring->Put(bottom, task);
+  // Publishes the slot (and the task it points to) to thieves.
+  bottom_.store(bottom + 1, std::memory_order_release);
+}
+
+PoolTask* WorkStealingDeque::Pop() {
+  const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+  Ring* ring = ring_.load(std::memory_order_relaxed);
+  bottom_.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t top = top_.load(std::memory_order_relaxed);
+
+  if (top > bottom) {
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  PoolTask* task = ring->Get(bottom);
+  if (top == bottom) {
+    // Last task: race the thieves for it.
+    if (!top_.compare_exchange_strong(top, top + 1,
+                                      std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      task = nullptr;
+    }
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+  return task;
+}
+
+PoolTask* WorkStealingDeque::Steal() {
+  int64_t top = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const int64_t bottom = bottom_.load(std::memory_order_acquire);
+  if (top >= bottom) {
+    return nullptr;
+  }
+  Ring* ring = ring_.load(std::memory_order_acquire);
+  PoolTask* task = ring->Get(top);
+  if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                    std::memory_order_relaxed)) {
+    return nullptr;
+  }
+  return task;
+}
+
+bool WorkStealingDeque::Empty() const {
+  return top_.load(std::memory_order_relaxed) >=
+         bottom_.load(std::memory_order_relaxed);
+}
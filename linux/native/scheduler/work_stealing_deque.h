@@ -0,0 +1,62 @@
+#ifndef NATIVE_SCHEDULER_WORK_STEALING_DEQUE_H_
+#define NATIVE_SCHEDULER_WORK_STEALING_DEQUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct PoolTask;
+
+// Chase-Lev deque of task pointers (Le et al., "Correct and Efficient
+// Work-Stealing for Weak Memory Models", 2013).
+//
+// The owning worker pushes and pops at the bottom without locks, newest
+// first, so a task it spawns runs while its data is still in cache. Other
+// workers steal the oldest task from the top. The ring doubles when full;
+// replaced rings stay allocated until the deque is destroyed because a
+// thief may still be reading one.
+class WorkStealingDeque {
+ public:
+  explicit WorkStealingDeque(size_t capacity = 256);
+  ~WorkStealingDeque();
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  // Owner only.
+  void Push(PoolTask* task);
+  PoolTask* Pop();
+
+  // Any thread. Returns null when empty or when another thread won the race
+  // for the last task.
+  PoolTask* Steal();
+
+  // Approximate; exact only on the owner with no thieves.
+  bool Empty() const;
+
+ private:
+  struct Ring {
+    explicit Ring(size_t capacity);
+
+    PoolTask* Get(int64_t index) const {
+      return slots[index & mask].load(std::memory_order_relaxed);
+    }
+    void Put(int64_t index, PoolTask* task) {
+      slots[index & mask].store(task, std::memory_order_relaxed);
+    }
+
+    const size_t capacity;
+    const int64_t mask;
+    std::unique_ptr<std::atomic<PoolTask*>[]> slots;
+  };
+
+  Ring* Grow(Ring* ring, int64_t top, int64_t bottom);
+
+  alignas(64) std::atomic<int64_t> top_{0};
+  alignas(64) std::atomic<int64_t> bottom_{0};
+  std::atomic<Ring*> ring_;
+  std::vector<std::unique_ptr<Ring>> rings_;  // Owner only.
+};
+
+#endif  // NATIVE_SCHEDULER_WORK_STEALING_DEQUE_H_
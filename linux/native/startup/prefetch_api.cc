@@ -0,0 +1,88 @@
+#include "startup/prefetch_api.h"
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "startup/prefetch_plan.h"
+#include "startup/startup_prefetcher.h"
+
+namespace {
+
+// Cached runs of pages closer than this are read as one; the kernel reads
+// ahead about this much around a fault anyway.
+constexpr uint64_t kMergeGap = 128 * 1024;
+
+std::mutex mutex;
+StartupPrefetcher* prefetcher = nullptr;
+std::thread recorder;
+std::string bundle;
+std::string plan_file;
+bool recording = false;
+bool first_frame_seen = false;
+
+void RecordPlan(std::string bundle_root, std::string path) {
+  PrefetchPlan plan;
+  RecordCachedRanges(bundle_root, ListStartupFiles(bundle_root), kMergeGap,
+                     &plan);
+  SavePrefetchPlan(path, plan);
+}
+
+}  // namespace
+
+bool ss_prefetch_start(const char* bundle_root, const char* plan_path) {
+  if (bundle_root == nullptr || plan_path == nullptr) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  if (prefetcher != nullptr || recording) {
+    return false;
+  }
+  bundle = bundle_root;
+  plan_file = plan_path;
+  PrefetchPlan plan;
+  if (!LoadPrefetchPlan(plan_file, &plan) || plan.files.empty() ||
+      !IsPlanCurrent(plan, bundle)) {
+    recording = true;
+    return false;
+  }
+  prefetcher = new StartupPrefetcher();
+  prefetcher->Start(bundle, std::move(plan));
+  return true;
+}
+
+void ss_prefetch_first_frame(void) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (first_frame_seen) {
+    return;
+  }
+  first_frame_seen = true;
+  if (recording) {
+    recorder = std::thread(RecordPlan, bundle, plan_file);
+  }
+}
+
+void ss_prefetch_get_stats(SsPrefetchStats* stats) {
+  if (stats == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  const PrefetchStats current =
+      prefetcher != nullptr ? prefetcher->stats() : PrefetchStats();
+  stats->files = current.files;
+  stats->bytes = current.bytes;
+  stats->start_ns = current.start_ns;
+  stats->end_ns = current.end_ns;
+  stats->recording = recording;
+}
+
+void ss_prefetch_stop(void) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (prefetcher != nullptr) {
+    prefetcher->Stop();
+  }
+  if (recorder.joinable()) {
+    recorder.join();
+  }
+}
@@ -0,0 +1,48 @@
+#ifndef NATIVE_STARTUP_PREFETCH_API_H_
+#define NATIVE_STARTUP_PREFETCH_API_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/native_export.h"
+
+// C interface for the runner's startup prefetch (linux/runner/
+// startup_prefetch.cc). One per process.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Mirrors PrefetchStats. |recording| is set for a start that had no usable
+// plan and records one instead of reading ahead.
+typedef struct {
+  uint32_t files;
+  uint64_t bytes;
+  uint64_t start_ns;
+  uint64_t end_ns;
+  bool recording;
+} SsPrefetchStats;
+
+// Starts reading ahead the parts of |bundle_root|'s files that the plan at
+// |plan_path| lists, on a thread of its own, and returns at once. Without a
+// plan, or when a file it names has changed since, nothing is read and
+// ss_prefetch_first_frame() records a new one. Returns whether it is
+// reading.
+SS_EXPORT bool ss_prefetch_start(const char* bundle_root,
+                                 const char* plan_path);
+
+// When recording, notes which pages of the startup files are in the page
+// cache now and writes the plan, on a thread of its own. Call once the
+// first frame is up; later calls do nothing.
+SS_EXPORT void ss_prefetch_first_frame(void);
+
+SS_EXPORT void ss_prefetch_get_stats(SsPrefetchStats* stats);
+
+// Stops reading and waits for a plan being written.
+SS_EXPORT void ss_prefetch_stop(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // NATIVE_STARTUP_PREFETCH_API_H_
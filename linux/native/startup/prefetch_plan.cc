@@ -0,0 +1,262 @@
+#include "startup/prefetch_plan.h"
+
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "common/buffered_file.h"
+#include "common/mapped_file.h"
+#include "update/bundle_manifest.h"
+
+namespace {
+
+constexpr char kHeader[] = "ss-prefetch 1";
+constexpr char kEngineLibrary[] = "lib/libflutter_linux_gtk.so";
+constexpr char kIcuData[] = "data/icudtl.dat";
+constexpr char kAotLibrary[] = "lib/libapp.so";
+constexpr char kAssets[] = "data/flutter_assets";
+
+bool StatFile(const std::string& path, uint64_t* size, int64_t* mtime_ns) {
+  struct stat info;
+  if (::stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+    return false;
+  }
+  *size = static_cast<uint64_t>(info.st_size);
+  *mtime_ns = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 +
+              info.st_mtim.tv_nsec;
+  return true;
+}
+
+bool IsFile(const std::string& path) {
+  uint64_t size;
+  int64_t mtime_ns;
+  return StatFile(path, &size, &mtime_ns);
+}
+
+// Regular files under |root|/|dir|, relative to |root|.
+void ListFiles(const std::string& root, const std::string& dir,
+               std::vector<std::string>* out) {
+  DIR* stream = ::opendir((root + "/" + dir).c_str());
+  if (stream == nullptr) {
+    return;
+  }
+  while (const dirent* entry = ::readdir(stream)) {
+    if (std::strcmp(entry->d_name, ".") == 0 ||
+        std::strcmp(entry->d_name, "..") == 0) {
+      continue;
+    }
+    const std::string path = dir + "/" + entry->d_name;
+    struct stat info;
+    if (::lstat((root + "/" + path).c_str(), &info) != 0) {
+      continue;
+    }
+    if (S_ISDIR(info.st_mode)) {
+      ListFiles(root, path, out);
+    } else if (S_ISREG(info.st_mode)) {
+      out->push_back(path);
+    }
+  }
+  ::closedir(stream);
+}
+
+// Lower comes first: what the engine reads while starting, then fonts and
+// shaders the first frame needs, then the rest.
+int AssetRank(const std::string& path) {
+  const std::string name = path.substr(sizeof(kAssets));
+  if (name.rfind("AssetManifest", 0) == 0 || name == "FontManifest.json") {
+    return 0;
+  }
+  if (name.rfind("fonts/", 0) == 0 || name.rfind("shaders/", 0) == 0) {
+    return 1;
+  }
+  return 2;
+}
+
+}  // namespace
+
+uint64_t PrefetchPlan::TotalBytes() const {
+  uint64_t total = 0;
+  for (const PrefetchFile& file : files) {
+    for (const PrefetchRange& range : file.ranges) {
+      total += range.length;
+    }
+  }
+  return total;
+}
+
+std::vector<std::string> ListStartupFiles(const std::string& bundle_root) {
+  std::vector<std::string> files;
+  if (IsFile(bundle_root + "/" + kEngineLibrary)) {
+    files.push_back(kEngineLibrary);
+  }
+  std::vector<std::string> libraries;
+  ListFiles(bundle_root, "lib", &libraries);
+  std::sort(libraries.begin(), libraries.end());
+  for (const std::string& library : libraries) {
+    if (library != kEngineLibrary && library != kAotLibrary) {
+      files.push_back(library);
+    }
+  }
+  for (const char* path : {kIcuData, kAotLibrary}) {
+    if (IsFile(bundle_root + "/" + path)) {
+      files.push_back(path);
+    }
+  }
+  std::vector<std::string> assets;
+  ListFiles(bundle_root, kAssets, &assets);
+  assets.erase(std::remove_if(assets.begin(), assets.end(),
+                              [](const std::string& path) {
+                                return path.rfind("/NOTICES") ==
+                                       sizeof(kAssets) - 1;
+                              }),
+               assets.end());
+  std::sort(assets.begin(), assets.end(),
+            [](const std::string& a, const std::string& b) {
+              const int rank_a = AssetRank(a);
+              const int rank_b = AssetRank(b);
+              return rank_a != rank_b ? rank_a < rank_b : a < b;
+            });
+  files.insert(files.end(), assets.begin(), assets.end());
+  return files;
+}
+
+void RecordCachedRanges(const std::string& bundle_root,
+                        const std::vector<std::string>& files,
+                        uint64_t merge_gap, PrefetchPlan* plan) {
+  plan->files.clear();
+  const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  std::vector<unsigned char> cached;
+  for (const std::string& path : files) {
+    PrefetchFile file;
+    file.path = path;
+    const std::string full_path = bundle_root + "/" + path;
+    MappedFile mapped;
+    if (!StatFile(full_path, &file.size, &file.mtime_ns) ||
+        !mapped.Open(full_path) || mapped.size() == 0) {
+      continue;
+    }
+    const size_t pages = (mapped.size() + page - 1) / page;
+    cached.assign(pages, 0);
+    if (::mincore(const_cast<uint8_t*>(mapped.data()), mapped.size(),
+                  cached.data()) != 0) {
+      continue;
+    }
+    for (size_t i = 0; i < pages;) {
+      if ((cached[i] & 1) == 0) {
+        i++;
+        continue;
+      }
+      size_t end = i + 1;
+      while (end < pages && (cached[end] & 1) != 0) {
+        end++;
+      }
+      const uint64_t offset = static_cast<uint64_t>(i) * page;
+      const uint64_t limit =
+          std::min<uint64_t>(static_cast<uint64_t>(end) * page, file.size);
+      if (!file.ranges.empty() &&
+          offset - (file.ranges.back().offset + file.ranges.back().length) <
+              merge_gap) {
+        file.ranges.back().length = limit - file.ranges.back().offset;
+      } else {
+        file.ranges.push_back({offset, limit - offset});
+      }
+      i = end;
+    }
+    if (!file.ranges.empty()) {
+      plan->files.push_back(std::move(file));
+    }
+  }
+}
+
+bool IsPlanCurrent(const PrefetchPlan& plan, const std::string& bundle_root) {
+  for (const PrefetchFile& file : plan.files) {
+    uint64_t size;
+    int64_t mtime_ns;
+    if (!StatFile(bundle_root + "/" + file.path, &size, &mtime_ns) ||
+        size != file.size || mtime_ns != file.mtime_ns) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string SerializePrefetchPlan(const PrefetchPlan& plan) {
+  std::string text = std::string(kHeader) + "\n";
+  char line[96];
+  for (const PrefetchFile& file : plan.files) {
+    std::snprintf(line, sizeof(line), "file %" PRIu64 " %" PRId64 " ",
+                  file.size, file.mtime_ns);
+    text += line;
+    text += file.path;
+    text += '\n';
+    for (const PrefetchRange& range : file.ranges) {
+      std::snprintf(line, sizeof(line), "range %" PRIu64 " %" PRIu64 "\n",
+                    range.offset, range.length);
+      text += line;
+    }
+  }
+  return text;
+}
+
+bool ParsePrefetchPlan(const std::string& text, PrefetchPlan* plan) {
+  plan->files.clear();
+  std::istringstream lines(text);
+  std::string line;
+  if (!std::getline(lines, line) || line != kHeader) {
+    return false;
+  }
+  while (std::getline(lines, line)) {
+    uint64_t a;
+    uint64_t b;
+    int64_t mtime_ns;
+    int used = 0;
+    if (std::sscanf(line.c_str(), "file %" SCNu64 " %" SCNd64 " %n", &a,
+                    &mtime_ns, &used) == 2 &&
+        used > 0 && IsSafeBundlePath(line.substr(used))) {
+      PrefetchFile file;
+      file.path = line.substr(used);
+      file.size = a;
+      file.mtime_ns = mtime_ns;
+      plan->files.push_back(std::move(file));
+    } else if (std::sscanf(line.c_str(), "range %" SCNu64 " %" SCNu64 "%n",
+                           &a, &b, &used) == 2 &&
+               static_cast<size_t>(used) == line.size() &&
+               !plan->files.empty() && b > 0 &&
+               b <= plan->files.back().size &&
+               a <= plan->files.back().size - b) {
+      plan->files.back().ranges.push_back({a, b});
+    } else {
+      plan->files.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool LoadPrefetchPlan(const std::string& path, PrefetchPlan* plan) {
+  plan->files.clear();
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  std::ostringstream text;
+  text << in.rdbuf();
+  return ParsePrefetchPlan(text.str(), plan);
+}
+
+bool SavePrefetchPlan(const std::string& path, const PrefetchPlan& plan) {
+  BufferedFile file;
+  if (!file.Open(path) || !file.Write(SerializePrefetchPlan(plan))) {
+    file.Abort();
+    return false;
+  }
+  return file.Commit();
+}
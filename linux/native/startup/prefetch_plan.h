@@ -0,0 +1,58 @@
+#ifndef NATIVE_STARTUP_PREFETCH_PLAN_H_
+#define NATIVE_STARTUP_PREFETCH_PLAN_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Which parts of which bundle files a start reads, so the next start can
+// have them read ahead before the engine faults them in a page at a time.
+// A plan is recorded from the page cache once the first frame is up and is
+// only trusted while every file it names is unchanged.
+
+struct PrefetchRange {
+  uint64_t offset = 0;
+  uint64_t length = 0;
+};
+
+struct PrefetchFile {
+  std::string path;  // Relative to the bundle root, '/'-separated.
+  // As recorded; the plan is stale when either differs.
+  uint64_t size = 0;
+  int64_t mtime_ns = 0;
+  std::vector<PrefetchRange> ranges;
+};
+
+struct PrefetchPlan {
+  // In the order they are first needed.
+  std::vector<PrefetchFile> files;
+
+  uint64_t TotalBytes() const;
+};
+
+// The files a start may read, relative to |bundle_root|, in the order the
+// process needs them: the engine library and plugin libraries (mapped by
+// the loader before main()), ICU data, the AOT snapshot, then the asset
+// manifests, fonts and shaders ahead of the other assets. Licenses are
+// left out; only the about page reads them.
+std::vector<std::string> ListStartupFiles(const std::string& bundle_root);
+
+// Fills |plan| with the parts of |files| that are in the page cache now,
+// keeping their order. Runs of cached pages less than |merge_gap| bytes
+// apart become one range; files with nothing cached are left out.
+void RecordCachedRanges(const std::string& bundle_root,
+                        const std::vector<std::string>& files,
+                        uint64_t merge_gap, PrefetchPlan* plan);
+
+// True when every file of |plan| still has its recorded size and mtime.
+bool IsPlanCurrent(const PrefetchPlan& plan, const std::string& bundle_root);
+
+std::string SerializePrefetchPlan(const PrefetchPlan& plan);
+// Returns false, leaving |plan| empty, for anything malformed.
+bool ParsePrefetchPlan(const std::string& text, PrefetchPlan* plan);
+
+// The plan file; written to a temporary name and renamed into place.
+bool LoadPrefetchPlan(const std::string& path, PrefetchPlan* plan);
+bool SavePrefetchPlan(const std::string& path, const PrefetchPlan& plan);
+
+#endif  // NATIVE_STARTUP_PREFETCH_PLAN_H_
@@ -0,0 +1,60 @@
+#ifndef NATIVE_STARTUP_STARTUP_PREFETCHER_H_
+#define NATIVE_STARTUP_STARTUP_PREFETCHER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "startup/prefetch_plan.h"
+
+struct PrefetchStats {
+  uint32_t files = 0;
+  uint64_t bytes = 0;
+  // CLOCK_MONOTONIC; |end_ns| is 0 while the thread is still reading.
+  uint64_t start_ns = 0;
+  uint64_t end_ns = 0;
+};
+
+// Reads |ranges| of |path| into the page cache: posix_fadvise(WILLNEED)
+// over all of them first, so the kernel can queue the I/O, then a pread
+// through each, so what comes first is in memory first. Checks |stop| (may
+// be null) between reads. Returns the bytes read.
+uint64_t PrefetchFileRanges(const std::string& path,
+                            const std::vector<PrefetchRange>& ranges,
+                            const std::atomic<bool>* stop);
+
+// Reads a PrefetchPlan on a thread of its own, started from main() before
+// the engine exists; the shared worker pool is not up yet, and the reads
+// should not queue behind its tasks once it is.
+class StartupPrefetcher {
+ public:
+  StartupPrefetcher() = default;
+  ~StartupPrefetcher();
+
+  StartupPrefetcher(const StartupPrefetcher&) = delete;
+  StartupPrefetcher& operator=(const StartupPrefetcher&) = delete;
+
+  // Starts reading the files of |plan| under |bundle_root| in plan order.
+  // Only once per instance.
+  void Start(std::string bundle_root, PrefetchPlan plan);
+
+  // Stops after the read in progress and joins the thread.
+  void Stop();
+
+  PrefetchStats stats() const;
+
+ private:
+  void Run();
+
+  std::string bundle_root_;
+  PrefetchPlan plan_;
+  std::thread thread_;
+  std::atomic<bool> stop_{false};
+  mutable std::mutex mutex_;
+  PrefetchStats stats_;
+};
+
+#endif  // NATIVE_STARTUP_STARTUP_PREFETCHER_H_
@@ -0,0 +1,109 @@
+#include "stream/record_ring.h"
+
+#include <cstring>
+
+#include "memory/process_memory.h"
+
+namespace {
+
+uint64_t RoundUpToPowerOfTwo(uint64_t value) {
+  uint64_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+}  // namespace
+
+RecordRing::RecordRing(uint32_t record_size, uint32_t capacity)
+    : record_size_(record_size),
+      mask_(RoundUpToPowerOfTwo(capacity < 2 ? 2 : capacity) - 1),
+      storage_(new uint64_t[(mask_ + 1) * record_size / sizeof(uint64_t)]()) {}
+
+bool RecordRing::Push(const void* record) {
+  const uint64_t write = write_.load(std::memory_order_relaxed);
+  if (write - cached_read_ > mask_) {
+    cached_read_ = read_.load(std::memory_order_acquire);
+    if (write - cached_read_ > mask_) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+  }
+  uint8_t* slot = reinterpret_cast<uint8_t*>(storage_.get()) +
+                  (write & mask_) * record_size_;
+  std::memcpy(slot, record, record_size_);
+  // Sequentially consistent, with the armed_ load below and the two in
+  // Arm(): either the reader sees this record or the writer sees the
+  // doorbell armed.
+  write_.store(write + 1, std::memory_order_seq_cst);
+  if (armed_.load(std::memory_order_seq_cst) &&
+      armed_.exchange(false, std::memory_order_acq_rel)) {
+    Ring();
+  }
+  return true;
+}
+
+bool RecordRing::Attach(Doorbell doorbell, void* data) {
+  bool expected = false;
+  if (!attached_.compare_exchange_strong(expected, true)) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(doorbell_mutex_);
+    doorbell_ = doorbell;
+    doorbell_data_ = data;
+  }
+  read_.store(write_.load(std::memory_order_acquire),
+              std::memory_order_release);
+  return true;
+}
+
+void RecordRing::Detach() {
+  armed_.store(false, std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> lock(doorbell_mutex_);
+    doorbell_ = nullptr;
+    doorbell_data_ = nullptr;
+  }
+  attached_.store(false, std::memory_order_release);
+}
+
+size_t RecordRing::ReleaseMemory() {
+  // Attach() takes the lock before it moves the read index, so holding it
+  // keeps a reader from starting on half-released storage.
+  std::lock_guard<std::mutex> lock(doorbell_mutex_);
+  if (attached_.load(std::memory_order_acquire)) {
+    return 0;
+  }
+  return ReleasePages(storage_.get(), (mask_ + 1) * record_size_);
+}
+
+uint32_t RecordRing::Acquire(uint64_t* first) {
+  const uint64_t read = read_.load(std::memory_order_relaxed);
+  *first = read;
+  return static_cast<uint32_t>(write_.load(std::memory_order_acquire) - read);
+}
+
+void RecordRing::Release(uint32_t count) {
+  read_.store(read_.load(std::memory_order_relaxed) + count,
+              std::memory_order_release);
+}
+
+bool RecordRing::Arm() {
+  armed_.store(true, std::memory_order_seq_cst);
+  if (write_.load(std::memory_order_seq_cst) ==
+      read_.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  // Records are waiting. Take the doorbell back unless a push has already
+  // claimed it, in which case the reader is about to be woken anyway.
+  return armed_.exchange(false, std::memory_order_acq_rel);
+}
+
+void RecordRing::Ring() {
+  std::lock_guard<std::mutex> lock(doorbell_mutex_);
+  if (doorbell_ != nullptr) {
+    doorbell_(doorbell_data_);
+  }
+}
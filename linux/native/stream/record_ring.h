@@ -0,0 +1,112 @@
+#ifndef NATIVE_STREAM_RECORD_RING_H_
+#define NATIVE_STREAM_RECORD_RING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+// Single-producer, single-consumer ring of fixed-size records for streams
+// that are too chatty for a platform channel.
+//
+// The records sit in one flat array so a Dart reader can decode them in
+// place through dart:ffi pointers: it acquires the published span, reads it
+// and releases it, with only the two index updates crossing into native
+// code. The writer never blocks; when the reader falls a whole ring behind,
+// new records are dropped and counted.
+//
+// Rather than being told about every record, the reader arms a doorbell and
+// is called once when the next record lands. It re-arms after draining, so
+// one that drains once per frame is woken at most once per frame however
+// fast records arrive.
+class RecordRing {
+ public:
+  using Doorbell = void (*)(void* data);
+
+  // |record_size| must be a non-zero multiple of 8 so every record is
+  // aligned for its int64 fields. |capacity| is rounded up to a power of two.
+  RecordRing(uint32_t record_size, uint32_t capacity);
+
+  RecordRing(const RecordRing&) = delete;
+  RecordRing& operator=(const RecordRing&) = delete;
+
+  // Writer side; one thread at a time. Copies |record_size| bytes from
+  // |record|. Returns false, and counts a drop, when the ring is full.
+  bool Push(const void* record);
+
+  template <typename Record>
+  bool Push(const Record& record) {
+    static_assert(std::is_trivially_copyable<Record>::value &&
+                      !std::is_pointer<Record>::value,
+                  "records are copied as bytes");
+    return sizeof(Record) == record_size_ &&
+           Push(static_cast<const void*>(&record));
+  }
+
+  // Whether a reader is attached; writers can skip building records
+  // otherwise.
+  bool attached() const { return attached_.load(std::memory_order_relaxed); }
+
+  // Reader side. Attach() fails while another reader is attached. The
+  // reader starts at the next record written; anything older is skipped.
+  // Once Detach() returns the doorbell is not called again.
+  bool Attach(Doorbell doorbell, void* data);
+  void Detach();
+
+  // Number of published records not yet released, starting at index
+  // |*first|. The span stays untouched by the writer until Release().
+  uint32_t Acquire(uint64_t* first);
+  // Hands the oldest |count| acquired records back to the writer.
+  void Release(uint32_t count);
+
+  // Arms the doorbell for the next Push(). Returns true instead, leaving it
+  // disarmed, if records are already waiting; the reader should then drain
+  // them without waiting to be woken.
+  bool Arm();
+
+  // Gives the storage's pages back to the kernel while no reader is
+  // attached; a reader skips everything written before it attaches, so
+  // nothing is lost. Returns the bytes released.
+  size_t ReleaseMemory();
+
+  // Record |index| of the sequence, wrapped onto the ring.
+  const uint8_t* RecordAt(uint64_t index) const {
+    return records() + (index & mask_) * record_size_;
+  }
+
+  const uint8_t* records() const {
+    return reinterpret_cast<const uint8_t*>(storage_.get());
+  }
+  uint32_t record_size() const { return record_size_; }
+  uint32_t capacity() const { return static_cast<uint32_t>(mask_ + 1); }
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  void Ring();
+
+  const uint32_t record_size_;
+  const uint64_t mask_;
+  // uint64_t so the records are 8-byte aligned.
+  std::unique_ptr<uint64_t[]> storage_;
+
+  // Written by the writer.
+  alignas(64) std::atomic<uint64_t> write_{0};
+  std::atomic<uint64_t> dropped_{0};
+  // The writer's last look at read_, so a push only reads the reader's
+  // cache line when the ring seems full.
+  uint64_t cached_read_ = 0;
+
+  // Written by the reader.
+  alignas(64) std::atomic<uint64_t> read_{0};
+  std::atomic<bool> armed_{false};
+  std::atomic<bool> attached_{false};
+
+  // Guards the doorbell against Detach(); only taken to ring it.
+  std::mutex doorbell_mutex_;
+  Doorbell doorbell_ = nullptr;
+  void* doorbell_data_ = nullptr;
+};
+
+#endif  // NATIVE_STREAM_RECORD_RING_H_
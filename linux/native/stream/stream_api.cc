@@ -0,0 +1,65 @@
+#include "stream/stream_api.h"
+
+#include "stream/record_ring.h"
+#include "stream/stream_registry.h"
+
+namespace {
+
+RecordRing* Ring(SsStream* stream) {
+  return reinterpret_cast<RecordRing*>(stream);
+}
+
+const RecordRing* Ring(const SsStream* stream) {
+  return reinterpret_cast<const RecordRing*>(stream);
+}
+
+}  // namespace
+
+SsStream* ss_stream_open(const char* name, uint32_t record_size,
+                         uint32_t capacity) {
+  if (name == nullptr) {
+    return nullptr;
+  }
+  return reinterpret_cast<SsStream*>(
+      StreamRegistry::Get().Open(name, record_size, capacity));
+}
+
+void ss_stream_layout(const SsStream* stream, SsStreamLayout* out) {
+  if (stream == nullptr || out == nullptr) {
+    return;
+  }
+  out->records = Ring(stream)->records();
+  out->record_size = Ring(stream)->record_size();
+  out->capacity = Ring(stream)->capacity();
+}
+
+bool ss_stream_attach(SsStream* stream, SsStreamDoorbell doorbell,
+                      void* data) {
+  return stream != nullptr && Ring(stream)->Attach(doorbell, data);
+}
+
+void ss_stream_detach(SsStream* stream) {
+  if (stream != nullptr) {
+    Ring(stream)->Detach();
+  }
+}
+
+uint32_t ss_stream_acquire(SsStream* stream, uint64_t* first) {
+  return Ring(stream)->Acquire(first);
+}
+
+void ss_stream_release(SsStream* stream, uint32_t count) {
+  Ring(stream)->Release(count);
+}
+
+bool ss_stream_arm(SsStream* stream) {
+  return Ring(stream)->Arm();
+}
+
+uint64_t ss_stream_dropped(const SsStream* stream) {
+  return stream != nullptr ? Ring(stream)->dropped() : 0;
+}
+
+bool ss_stream_write(SsStream* stream, const void* record) {
+  return stream != nullptr && Ring(stream)->Push(record);
+}
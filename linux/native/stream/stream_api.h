@@ -0,0 +1,54 @@
+#ifndef NATIVE_STREAM_STREAM_API_H_
+#define NATIVE_STREAM_STREAM_API_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/native_export.h"
+
+// C interface to the record streams (stream/record_ring.h), read from Dart
+// by lib/services/native_record_stream.dart. Record |i| of a stream is at
+// records + (i & (capacity - 1)) * record_size.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SsStream SsStream;
+
+typedef void (*SsStreamDoorbell)(void* data);
+
+typedef struct {
+  const uint8_t* records;
+  uint32_t record_size;
+  uint32_t capacity;
+} SsStreamLayout;
+
+// Returns the stream called |name|, creating it on first use. Null if
+// |record_size| is not a multiple of 8 or differs from the stream's.
+SS_EXPORT SsStream* ss_stream_open(const char* name,
+                                   uint32_t record_size,
+                                   uint32_t capacity);
+SS_EXPORT void ss_stream_layout(const SsStream* stream, SsStreamLayout* out);
+
+// Reader side. |doorbell| is called from the writer's thread, once per
+// ss_stream_arm(). Returns false if another reader is attached.
+SS_EXPORT bool ss_stream_attach(SsStream* stream,
+                                SsStreamDoorbell doorbell,
+                                void* data);
+SS_EXPORT void ss_stream_detach(SsStream* stream);
+// Returns the number of readable records, starting at |*first|.
+SS_EXPORT uint32_t ss_stream_acquire(SsStream* stream, uint64_t* first);
+SS_EXPORT void ss_stream_release(SsStream* stream, uint32_t count);
+// Returns true, without arming, if records are already waiting.
+SS_EXPORT bool ss_stream_arm(SsStream* stream);
+SS_EXPORT uint64_t ss_stream_dropped(const SsStream* stream);
+
+// Writer side; one thread at a time. Returns false if the ring was full.
+SS_EXPORT bool ss_stream_write(SsStream* stream, const void* record);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // NATIVE_STREAM_STREAM_API_H_
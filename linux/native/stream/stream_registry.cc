@@ -0,0 +1,37 @@
+#include "stream/stream_registry.h"
+
+#include "logging/logger.h"
+
+StreamRegistry& StreamRegistry::Get() {
+  static StreamRegistry* registry = new StreamRegistry();
+  return *registry;
+}
+
+size_t StreamRegistry::ReleaseMemory() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t released = 0;
+  for (const auto& stream : streams_) {
+    released += stream.second->ReleaseMemory();
+  }
+  return released;
+}
+
+RecordRing* StreamRegistry::Open(const std::string& name, uint32_t record_size,
+                                 uint32_t capacity) {
+  if (record_size == 0 || record_size % sizeof(uint64_t) != 0) {
+    SS_LOG(LogLevel::kError, "stream", "{}: bad record size {}", name,
+           static_cast<uint64_t>(record_size));
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::unique_ptr<RecordRing>& ring = streams_[name];
+  if (!ring) {
+    ring = std::make_unique<RecordRing>(record_size, capacity);
+  } else if (ring->record_size() != record_size) {
+    SS_LOG(LogLevel::kError, "stream", "{}: record size {} opened as {}", name,
+           static_cast<uint64_t>(ring->record_size()),
+           static_cast<uint64_t>(record_size));
+    return nullptr;
+  }
+  return ring.get();
+}
@@ -0,0 +1,39 @@
+#ifndef NATIVE_STREAM_STREAM_REGISTRY_H_
+#define NATIVE_STREAM_STREAM_REGISTRY_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "stream/record_ring.h"
+
+// Named record streams, so a writer in native code and a reader in Dart can
+// find the same ring without either having to start first.
+class StreamRegistry {
+ public:
+  // The shared registry. Never destroyed.
+  static StreamRegistry& Get();
+
+  StreamRegistry() = default;
+
+  StreamRegistry(const StreamRegistry&) = delete;
+  StreamRegistry& operator=(const StreamRegistry&) = delete;
+
+  // Returns the stream called |name|, creating it with |capacity| records on
+  // first use. Returns null if |record_size| is unusable (see RecordRing)
+  // or does not match the stream's. Streams live for the whole process.
+  RecordRing* Open(const std::string& name, uint32_t record_size,
+                   uint32_t capacity);
+
+  // RecordRing::ReleaseMemory() for every stream. Returns the bytes
+  // released.
+  size_t ReleaseMemory();
+
+ private:
+  std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<RecordRing>> streams_;
+};
+
+#endif  // NATIVE_STREAM_STREAM_REGISTRY_H_
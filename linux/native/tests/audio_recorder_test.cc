@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "runner/audio_recorder.h"
+#include "tests/runner_fakes.h"
+
+namespace {
+
+using Step = AudioCaptureBackend::Step;
+
+std::unique_ptr<AudioRecorder> MakeRecorder(
+    FakeAudioCaptureBackend::State* state) {
+  return std::make_unique<AudioRecorder>(
+      std::make_unique<FakeAudioCaptureBackend>(state));
+}
+
+void WaitFor(const std::atomic<uint64_t>& counter, uint64_t value) {
+  while (counter < value) {
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+}
+
+TEST(AudioRecorderTest, RecordsUntilStopped) {
+  FakeAudioCaptureBackend::State state;
+  state.sample_interval = std::chrono::microseconds(50);
+  auto recorder = MakeRecorder(&state);
+
+  ASSERT_TRUE(recorder->Start("/tmp/take1.m4a"));
+  EXPECT_TRUE(recorder->IsRecording());
+  EXPECT_FALSE(recorder->Start("/tmp/take2.m4a"));
+  WaitFor(state.reads, 20);
+
+  EXPECT_EQ(recorder->Stop(), "/tmp/take1.m4a");
+  EXPECT_FALSE(recorder->IsRecording());
+  EXPECT_EQ(state.path, "/tmp/take1.m4a");
+  EXPECT_EQ(state.opens, 1);
+  EXPECT_EQ(state.closes, 1);
+  const AudioRecorderStats stats = recorder->last_stats();
+  EXPECT_GE(stats.samples, 20u);
+  EXPECT_FALSE(stats.failed);
+
+  EXPECT_EQ(recorder->Stop(), "");
+}
+
+TEST(AudioRecorderTest, CountsGapsAndFinishesTheFileAtEndOfStream) {
+  FakeAudioCaptureBackend::State state;
+  state.script = {Step::kBlock, Step::kNoSample, Step::kBlock,
+                  Step::kEndOfStream};
+  auto recorder = MakeRecorder(&state);
+
+  ASSERT_TRUE(recorder->Start("/tmp/take.m4a"));
+  WaitFor(state.reads, 4);
+  // The loop has ended, but the recording is only over on Stop().
+  EXPECT_EQ(recorder->Stop(), "/tmp/take.m4a");
+  EXPECT_EQ(state.closes, 1);
+  const AudioRecorderStats stats = recorder->last_stats();
+  EXPECT_EQ(stats.samples, 2u);
+  EXPECT_EQ(stats.empty_reads, 1u);
+  EXPECT_FALSE(stats.failed);
+}
+
+TEST(AudioRecorderTest, ReportsAnErrorAndCanRecordAgain) {
+  FakeAudioCaptureBackend::State state;
+  state.script = {Step::kBlock, Step::kError};
+  auto recorder = MakeRecorder(&state);
+
+  ASSERT_TRUE(recorder->Start("/tmp/a.m4a"));
+  WaitFor(state.reads, 2);
+  EXPECT_EQ(recorder->Stop(), "/tmp/a.m4a");
+  EXPECT_TRUE(recorder->last_stats().failed);
+
+  ASSERT_TRUE(recorder->Start("/tmp/b.m4a"));
+  EXPECT_EQ(recorder->Stop(), "/tmp/b.m4a");
+  EXPECT_EQ(state.opens, 2);
+  EXPECT_EQ(state.closes, 2);
+}
+
+TEST(AudioRecorderTest, FailedOpenEndsTheRecording) {
+  FakeAudioCaptureBackend::State state;
+  state.fail_open = true;
+  auto recorder = MakeRecorder(&state);
+
+  ASSERT_TRUE(recorder->Start("/tmp/a.m4a"));
+  while (recorder->IsRecording()) {
+    std::this_thread::yield();
+  }
+  EXPECT_TRUE(recorder->last_stats().failed);
+  EXPECT_EQ(state.closes, 0);
+
+  // The failed capture thread is out of the way of the next one.
+  state.fail_open = false;
+  ASSERT_TRUE(recorder->Start("/tmp/b.m4a"));
+  EXPECT_EQ(recorder->Stop(), "/tmp/b.m4a");
+}
+
+TEST(AudioRecorderTest, TracksXrunsAndTimestampGaps) {
+  char path[] = "/tmp/audio_recorder_testXXXXXX";
+  const int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(write(fd, "0123456789", 10), 10);
+  close(fd);
+
+  FakeAudioCaptureBackend::State state;
+  state.script = {Step::kBlock, Step::kBlock, Step::kNoSample, Step::kBlock,
+                  Step::kBlock, Step::kBlock, Step::kEndOfStream};
+  state.blocks = {{0, 10000, false},
+                  {10000, 10000, false},
+                  {},
+                  // 10 ms lost, and the API says so.
+                  {30000, 10000, true},
+                  {40000, 10000, false},
+                  // Jitter under the tolerance.
+                  {50500, 10000, false}};
+  auto recorder = MakeRecorder(&state);
+
+  ASSERT_TRUE(recorder->Start(path));
+  WaitFor(state.reads, 7);
+  EXPECT_EQ(recorder->Stop(), path);
+  const AudioRecorderStats stats = recorder->last_stats();
+  EXPECT_EQ(stats.samples, 5u);
+  EXPECT_EQ(stats.empty_reads, 1u);
+  EXPECT_EQ(stats.xruns, 1u);
+  EXPECT_EQ(stats.timestamp_gaps, 1u);
+  EXPECT_EQ(stats.missing_us, 10000);
+  EXPECT_EQ(stats.max_gap_us, 10000);
+  EXPECT_EQ(stats.media_us, 60500);
+  EXPECT_EQ(stats.write_latency.count, 5u);
+  EXPECT_EQ(stats.file_bytes, 10u);
+  EXPECT_FALSE(stats.failed);
+  std::remove(path);
+}
+
+TEST(AudioRecorderTest, MeasuresWritesAndBacklog) {
+  FakeAudioCaptureBackend::State state;
+  // Writes take twice as long as the audio they carry, so the API's queue
+  // grows by a millisecond a block.
+  state.write_time = std::chrono::milliseconds(2);
+  for (int i = 0; i < 10; ++i) {
+    state.blocks.push_back({i * 1000, 1000, false});
+    state.script.push_back(Step::kBlock);
+  }
+  state.script.push_back(Step::kEndOfStream);
+  auto recorder = MakeRecorder(&state);
+
+  ASSERT_TRUE(recorder->Start("/tmp/missing/take.m4a"));
+  WaitFor(state.reads, 11);
+  recorder->Stop();
+  const AudioRecorderStats stats = recorder->last_stats();
+  EXPECT_EQ(stats.write_latency.count, 10u);
+  EXPECT_GE(stats.write_latency.PercentileUs(50), 2000u);
+  EXPECT_GE(stats.write_latency.max_us, 2000u);
+  EXPECT_GE(stats.max_backlog_us, 8000);
+  EXPECT_EQ(stats.media_us, 10000);
+  EXPECT_EQ(stats.file_bytes, 0u);
+}
+
+TEST(AudioRecorderTest, FailedWriteEndsTheRecording) {
+  FakeAudioCaptureBackend::State state;
+  state.fail_write = 3;
+  auto recorder = MakeRecorder(&state);
+
+  ASSERT_TRUE(recorder->Start("/tmp/a.m4a"));
+  WaitFor(state.writes, 3);
+  EXPECT_EQ(recorder->Stop(), "/tmp/a.m4a");
+  const AudioRecorderStats stats = recorder->last_stats();
+  EXPECT_EQ(stats.samples, 2u);
+  EXPECT_TRUE(stats.failed);
+  EXPECT_EQ(state.closes, 1);
+}
+
+TEST(LatencyHistogramTest, ReportsBucketBounds) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.PercentileUs(50), 0u);
+  for (uint64_t us : {1, 3, 100, 100}) {
+    histogram.Record(us);
+  }
+  EXPECT_EQ(histogram.count, 4u);
+  EXPECT_EQ(histogram.PercentileUs(0), 1u);
+  EXPECT_EQ(histogram.PercentileUs(50), 3u);
+  // 64 to 127, capped at the largest value seen.
+  EXPECT_EQ(histogram.PercentileUs(75), 100u);
+  EXPECT_EQ(histogram.PercentileUs(100), 100u);
+
+  histogram.Record(uint64_t{1} << 40);
+  EXPECT_EQ(histogram.counts[LatencyHistogram::kBuckets - 1], 1u);
+  EXPECT_EQ(histogram.PercentileUs(100), uint64_t{1} << 40);
+}
+
+TEST(AudioRecorderTest, DestructorStopsTheLoop) {
+  FakeAudioCaptureBackend::State state;
+  {
+    auto recorder = MakeRecorder(&state);
+    ASSERT_TRUE(recorder->Start("/tmp/a.m4a"));
+    WaitFor(state.reads, 1);
+  }
+  EXPECT_EQ(state.closes, 1);
+}
+
+}  // namespace
@@ -0,0 +1,516 @@
+#include <gtest/gtest.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "tests/temp_dir.h"
+#include "update/binary_delta.h"
+#include "update/bundle_manifest.h"
+#include "update/bundle_patch.h"
+#include "update/staged_update.h"
+
+namespace {
+
+// Deterministic bytes that deflate cannot squeeze to nothing.
+std::vector<uint8_t> Noise(size_t size, uint32_t seed) {
+  std::vector<uint8_t> bytes(size);
+  uint32_t state = seed * 2654435761u + 1;
+  for (uint8_t& byte : bytes) {
+    state = state * 1664525u + 1013904223u;
+    byte = static_cast<uint8_t>(state >> 24);
+  }
+  return bytes;
+}
+
+void PutInt64(std::vector<uint8_t>* delta, int field, uint64_t value) {
+  for (int i = 0; i < 8; i++) {
+    (*delta)[8 + field * 8 + i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+std::vector<uint8_t> Deflate(const std::vector<uint8_t>& raw) {
+  uLongf size = compressBound(raw.size());
+  std::vector<uint8_t> out(size);
+  compress2(out.data(), &size, raw.data(), raw.size(), Z_BEST_SPEED);
+  out.resize(size);
+  return out;
+}
+
+// A delta made of |control| triples, with a zero diff stream as long as the
+// copies and no extra stream, as a hostile server could write it.
+std::vector<uint8_t> MakeDelta(uint64_t new_size,
+                               const std::vector<int64_t>& control) {
+  std::vector<uint8_t> raw_control;
+  uint64_t copied = 0;
+  for (size_t i = 0; i < control.size(); i++) {
+    for (int byte = 0; byte < 8; byte++) {
+      raw_control.push_back(
+          static_cast<uint8_t>(static_cast<uint64_t>(control[i]) >> (8 * byte)));
+    }
+    if (i % 3 == 0) {
+      copied += control[i];
+    }
+  }
+  const std::vector<uint8_t> streams[3] = {
+      Deflate(raw_control), Deflate(std::vector<uint8_t>(copied)),
+      Deflate(std::vector<uint8_t>())};
+  std::vector<uint8_t> delta = {'S', 'S', 'D', 'E', 'L', 'T', 'A', '1'};
+  delta.resize(64);
+  PutInt64(&delta, 0, new_size);
+  const uint64_t raw_sizes[3] = {raw_control.size(), copied, 0};
+  for (int i = 0; i < 3; i++) {
+    PutInt64(&delta, 1 + 2 * i, raw_sizes[i]);
+    PutInt64(&delta, 2 + 2 * i, streams[i].size());
+    delta.insert(delta.end(), streams[i].begin(), streams[i].end());
+  }
+  return delta;
+}
+
+TEST(BinaryDeltaTest, RoundTripsAnEditedFile) {
+  const std::vector<uint8_t> old_file = Noise(200000, 1);
+  std::vector<uint8_t> new_file = old_file;
+  // Code that moved, a patched constant, and something appended.
+  new_file.insert(new_file.begin() + 1000, old_file.begin() + 50000,
+                  old_file.begin() + 60000);
+  new_file[150000] ^= 0x5a;
+  const std::vector<uint8_t> tail = Noise(3000, 2);
+  new_file.insert(new_file.end(), tail.begin(), tail.end());
+
+  std::vector<uint8_t> delta;
+  ASSERT_TRUE(CreateBinaryDelta(old_file.data(), old_file.size(),
+                                new_file.data(), new_file.size(), &delta));
+  EXPECT_LT(delta.size(), new_file.size() / 10);
+  std::vector<uint8_t> rebuilt;
+  ASSERT_TRUE(ApplyBinaryDelta(old_file.data(), old_file.size(), delta.data(),
+                               delta.size(), &rebuilt));
+  EXPECT_EQ(rebuilt, new_file);
+}
+
+TEST(BinaryDeltaTest, RoundTripsAgainstAnEmptyFile) {
+  const std::vector<uint8_t> new_file = Noise(5000, 3);
+  std::vector<uint8_t> delta;
+  ASSERT_TRUE(CreateBinaryDelta(nullptr, 0, new_file.data(), new_file.size(),
+                                &delta));
+  std::vector<uint8_t> rebuilt;
+  ASSERT_TRUE(
+      ApplyBinaryDelta(nullptr, 0, delta.data(), delta.size(), &rebuilt));
+  EXPECT_EQ(rebuilt, new_file);
+}
+
+class CorruptDeltaTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    old_ = Noise(20000, 4);
+    std::vector<uint8_t> new_file = old_;
+    new_file[100] ^= 1;
+    ASSERT_TRUE(CreateBinaryDelta(old_.data(), old_.size(), new_file.data(),
+                                  new_file.size(), &delta_));
+  }
+
+  bool Apply(const std::vector<uint8_t>& delta) {
+    std::vector<uint8_t> out;
+    return ApplyBinaryDelta(old_.data(), old_.size(), delta.data(),
+                            delta.size(), &out);
+  }
+
+  std::vector<uint8_t> old_;
+  std::vector<uint8_t> delta_;
+};
+
+TEST_F(CorruptDeltaTest, RefusesATruncatedDelta) {
+  std::vector<uint8_t> delta = delta_;
+  delta.pop_back();
+  EXPECT_FALSE(Apply(delta));
+  delta.resize(20);
+  EXPECT_FALSE(Apply(delta));
+}
+
+TEST_F(CorruptDeltaTest, RefusesBadMagic) {
+  std::vector<uint8_t> delta = delta_;
+  delta[0] = 'X';
+  EXPECT_FALSE(Apply(delta));
+}
+
+TEST_F(CorruptDeltaTest, RefusesCompressedLengthsThatWrapAround) {
+  // Fields: new size, then raw and compressed length of control, diff and
+  // extra. The three compressed lengths add up to the real total modulo 2^64.
+  std::vector<uint8_t> delta = delta_;
+  PutInt64(&delta, 4, UINT64_MAX - 100);
+  PutInt64(&delta, 6, 101 + (delta.size() - 64));
+  EXPECT_FALSE(Apply(delta));
+}
+
+TEST_F(CorruptDeltaTest, RefusesHugeSizesWithoutAllocating) {
+  std::vector<uint8_t> delta = delta_;
+  PutInt64(&delta, 0, uint64_t{1} << 40);
+  EXPECT_FALSE(Apply(delta));
+  // A raw stream deflate could not have produced from so few bytes.
+  delta = delta_;
+  PutInt64(&delta, 5, uint64_t{1} << 40);
+  EXPECT_FALSE(Apply(delta));
+}
+
+TEST_F(CorruptDeltaTest, SeeksWithinReach) {
+  // Keeps MakeDelta() honest: copy ten bytes, seek back, copy them again.
+  std::vector<uint8_t> out;
+  const std::vector<uint8_t> delta = MakeDelta(20, {10, 0, -10, 10, 0, 0});
+  ASSERT_TRUE(
+      ApplyBinaryDelta(old_.data(), old_.size(), delta.data(), delta.size(),
+                       &out));
+  std::vector<uint8_t> expected(old_.begin(), old_.begin() + 10);
+  expected.insert(expected.end(), old_.begin(), old_.begin() + 10);
+  EXPECT_EQ(out, expected);
+}
+
+TEST_F(CorruptDeltaTest, RefusesSeeksFarOffTheOldFile) {
+  // Adding either of these to the old position would overflow.
+  EXPECT_FALSE(Apply(MakeDelta(20, {10, 0, INT64_MAX, 10, 0, 0})));
+  EXPECT_FALSE(Apply(MakeDelta(20, {10, 0, INT64_MIN, 10, 0, 0})));
+  // Each seek in reach on its own, but together further than any run.
+  const int64_t far = static_cast<int64_t>(old_.size()) + 2;
+  EXPECT_FALSE(Apply(MakeDelta(2, {1, 0, far, 1, 0, 0})));
+}
+
+TEST_F(CorruptDeltaTest, RefusesDamagedStreams) {
+  // Inside the deflated control stream, right after the header.
+  std::vector<uint8_t> delta = delta_;
+  delta[66] ^= 0xff;
+  EXPECT_FALSE(Apply(delta));
+}
+
+class BundlePatchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_FALSE(temp_.path().empty());
+    root_ = temp_.path();
+    installed_ = root_ + "/bundle";
+    staging_ = StagingPathFor(installed_);
+    patch_ = root_ + "/update.sspatch";
+  }
+
+  static void Write(const std::string& path, const std::vector<uint8_t>& data,
+                    mode_t mode = 0644) {
+    for (size_t slash = path.find('/', 1); slash != std::string::npos;
+         slash = path.find('/', slash + 1)) {
+      mkdir(path.substr(0, slash).c_str(), 0755);
+    }
+    std::ofstream(path, std::ios::binary)
+        .write(reinterpret_cast<const char*>(data.data()), data.size());
+    chmod(path.c_str(), mode);
+  }
+
+  static std::vector<uint8_t> Read(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in),
+                                std::istreambuf_iterator<char>());
+  }
+
+  static bool Exists(const std::string& path) {
+    struct stat info;
+    return lstat(path.c_str(), &info) == 0;
+  }
+
+  // A bundle as `flutter build linux` lays it out, at release |release|.
+  static void WriteBundle(const std::string& bundle, int release) {
+    Write(bundle + "/silver_stone", Noise(4000, 10), 0755);
+    std::vector<uint8_t> app = Noise(60000, 11);
+    app[release * 97] ^= 0x33;
+    Write(bundle + "/lib/libapp.so", app, 0755);
+    Write(bundle + "/lib/libflutter_linux_gtk.so", Noise(80000, 12), 0755);
+    Write(bundle + "/data/icudtl.dat", Noise(30000, 13));
+    if (release == 1) {
+      Write(bundle + "/data/flutter_assets/old_asset.bin", Noise(500, 14));
+    } else {
+      Write(bundle + "/data/flutter_assets/new_asset.bin", Noise(700, 15));
+    }
+    ASSERT_EQ(symlink("lib/libapp.so", (bundle + "/app").c_str()), 0);
+  }
+
+  // Release 2 built next to the installed release 1, with the patch between
+  // them written to |patch_|.
+  void MakePatch(BundlePatchStats* stats) {
+    WriteBundle(installed_, 1);
+    next_ = root_ + "/next";
+    WriteBundle(next_, 2);
+    std::string error;
+    ASSERT_TRUE(CreateBundlePatch(installed_, next_, patch_, stats, &error))
+        << error;
+  }
+
+  struct RawEntry {
+    BundleEntryType type;
+    std::string path;
+    std::string payload;  // A symlink's target, or a file's contents.
+  };
+
+  // Writes |entries| to |patch_| the way a hostile server could, bypassing
+  // the checks CreateBundlePatch() makes. Files are stored whole.
+  void WriteRawPatch(const std::vector<RawEntry>& entries) {
+    std::vector<uint8_t> body;
+    auto put = [](std::vector<uint8_t>* out, uint64_t value, int bytes) {
+      for (int i = 0; i < bytes; i++) {
+        out->push_back(static_cast<uint8_t>(value >> (8 * i)));
+      }
+    };
+    for (const RawEntry& entry : entries) {
+      const bool file = entry.type == BundleEntryType::kFile;
+      uint8_t digest[Sha256::kDigestBytes] = {};
+      std::vector<uint8_t> payload(entry.payload.begin(), entry.payload.end());
+      if (file) {
+        Sha256 hash;
+        hash.Update(entry.payload.data(), entry.payload.size());
+        hash.Final(digest);
+        uLongf size = compressBound(entry.payload.size());
+        payload.resize(size);
+        ASSERT_EQ(compress2(payload.data(), &size,
+                            reinterpret_cast<const Bytef*>(entry.payload.data()),
+                            entry.payload.size(), Z_BEST_SPEED),
+                  Z_OK);
+        payload.resize(size);
+      }
+      put(&body, static_cast<uint8_t>(entry.type), 1);
+      put(&body, file ? 2 : 0, 1);  // Stored whole.
+      put(&body, entry.path.size(), 2);
+      put(&body, file ? 0644 : 0755, 4);
+      put(&body, file ? entry.payload.size() : 0, 8);
+      body.insert(body.end(), digest, digest + sizeof(digest));
+      put(&body, payload.size(), 8);
+      body.insert(body.end(), entry.path.begin(), entry.path.end());
+      body.insert(body.end(), payload.begin(), payload.end());
+    }
+    std::vector<uint8_t> patch = {'S', 'S', 'B', 'P', 'A', 'T', 'C', 'H'};
+    put(&patch, 1, 4);
+    put(&patch, entries.size(), 4);
+    put(&patch, body.size(), 8);
+    uint8_t digest[Sha256::kDigestBytes];
+    Sha256 hash;
+    hash.Update(body.data(), body.size());
+    hash.Final(digest);
+    patch.insert(patch.end(), digest, digest + sizeof(digest));
+    patch.insert(patch.end(), body.begin(), body.end());
+    Write(patch_, patch);
+  }
+
+  // Applies |patch_| to an empty installed bundle.
+  bool ApplyRawPatch(std::string* error) {
+    mkdir(installed_.c_str(), 0755);
+    BundlePatchStats stats;
+    return ApplyBundlePatch(installed_, patch_, staging_, 1, &stats, error);
+  }
+
+  void ExpectSameFiles(const std::string& a, const std::string& b) {
+    for (const char* path :
+         {"silver_stone", "lib/libapp.so", "lib/libflutter_linux_gtk.so",
+          "data/icudtl.dat", "data/flutter_assets/new_asset.bin"}) {
+      EXPECT_EQ(Read(a + "/" + path), Read(b + "/" + path)) << path;
+    }
+  }
+
+  TempDir temp_{"bundle_patch_test"};
+  std::string root_;
+  std::string installed_;
+  std::string staging_;
+  std::string patch_;
+  std::string next_;
+};
+
+TEST_F(BundlePatchTest, StagesTheNextReleaseAndSwapsItIn) {
+  BundlePatchStats created;
+  MakePatch(&created);
+  EXPECT_EQ(created.files, 5u);
+  EXPECT_EQ(created.patched, 1u);
+  EXPECT_EQ(created.added, 1u);
+  EXPECT_EQ(created.kept, 3u);
+
+  BundlePatchStats applied;
+  std::string error;
+  ASSERT_TRUE(
+      ApplyBundlePatch(installed_, patch_, staging_, 2, &applied, &error))
+      << error;
+  EXPECT_EQ(applied.files, created.files);
+  EXPECT_EQ(applied.patched, 1u);
+  ExpectSameFiles(staging_, next_);
+  EXPECT_FALSE(Exists(staging_ + "/data/flutter_assets/old_asset.bin"));
+  struct stat info;
+  ASSERT_EQ(stat((staging_ + "/lib/libapp.so").c_str(), &info), 0);
+  EXPECT_EQ(info.st_mode & 07777, 0755u);
+  char target[64] = {};
+  ASSERT_GT(readlink((staging_ + "/app").c_str(), target, sizeof(target) - 1),
+            0);
+  EXPECT_STREQ(target, "lib/libapp.so");
+
+  ASSERT_TRUE(MarkStagedUpdateReady(staging_, "2.0.0"));
+  std::string version;
+  ASSERT_EQ(ApplyStagedUpdate(installed_, &version, &error),
+            StagedUpdateResult::kApplied)
+      << error;
+  EXPECT_EQ(version, "2.0.0");
+  ExpectSameFiles(installed_, next_);
+  EXPECT_FALSE(Exists(staging_));
+  EXPECT_FALSE(Exists(installed_ + "/.ss-update-ready"));
+  EXPECT_FALSE(Exists(installed_ + ".old"));
+
+  // Nothing left to apply.
+  EXPECT_EQ(ApplyStagedUpdate(installed_, &version, &error),
+            StagedUpdateResult::kNone);
+}
+
+TEST_F(BundlePatchTest, SwapsOnlyAReadyStagingDirectory) {
+  BundlePatchStats stats;
+  MakePatch(&stats);
+  std::string error;
+  ASSERT_TRUE(ApplyBundlePatch(installed_, patch_, staging_, 1, &stats,
+                               &error));
+  std::string version;
+  EXPECT_EQ(ApplyStagedUpdate(installed_, &version, &error),
+            StagedUpdateResult::kNone);
+  EXPECT_TRUE(Exists(installed_ + "/data/flutter_assets/old_asset.bin"));
+}
+
+TEST_F(BundlePatchTest, RefusesACorruptPatch) {
+  BundlePatchStats stats;
+  MakePatch(&stats);
+  const std::vector<uint8_t> patch = Read(patch_);
+  std::string error;
+
+  std::vector<uint8_t> damaged = patch;
+  damaged[damaged.size() - 10] ^= 0x01;
+  Write(patch_, damaged);
+  EXPECT_FALSE(
+      ApplyBundlePatch(installed_, patch_, staging_, 1, &stats, &error));
+  EXPECT_EQ(error, "patch checksum mismatch");
+  EXPECT_FALSE(Exists(staging_));
+
+  damaged.assign(patch.begin(), patch.end() - 1);
+  Write(patch_, damaged);
+  EXPECT_FALSE(
+      ApplyBundlePatch(installed_, patch_, staging_, 1, &stats, &error));
+  EXPECT_EQ(error, "not a bundle patch, or truncated");
+
+  damaged.assign(patch.begin(), patch.begin() + 16);
+  Write(patch_, damaged);
+  EXPECT_FALSE(
+      ApplyBundlePatch(installed_, patch_, staging_, 1, &stats, &error));
+  EXPECT_EQ(error, "patch is truncated");
+}
+
+TEST_F(BundlePatchTest, RefusesAnInstalledBundleThatChanged) {
+  BundlePatchStats stats;
+  MakePatch(&stats);
+  // The delta for libapp.so now applies to different bytes.
+  std::vector<uint8_t> app = Read(installed_ + "/lib/libapp.so");
+  app[30000] ^= 0xff;
+  Write(installed_ + "/lib/libapp.so", app, 0755);
+  std::string error;
+  EXPECT_FALSE(
+      ApplyBundlePatch(installed_, patch_, staging_, 1, &stats, &error));
+  EXPECT_NE(error.find("libapp.so"), std::string::npos) << error;
+  EXPECT_FALSE(Exists(staging_));
+}
+
+TEST_F(BundlePatchTest, RestoresABundleParkedByAnInterruptedSwap) {
+  // The fallback swap renames the bundle to <root>.old before moving the
+  // staged one in; a crash in between leaves no bundle at the root.
+  WriteBundle(installed_, 1);
+  ASSERT_EQ(rename(installed_.c_str(), (installed_ + ".old").c_str()), 0);
+  std::string version;
+  std::string error;
+  EXPECT_EQ(ApplyStagedUpdate(installed_, &version, &error),
+            StagedUpdateResult::kNone);
+  EXPECT_TRUE(Exists(installed_ + "/lib/libapp.so"));
+  EXPECT_FALSE(Exists(installed_ + ".old"));
+}
+
+TEST_F(BundlePatchTest, RemovesTheOldBundleLeftByACompletedSwap) {
+  // A crash after the staged bundle moved in leaves the replaced one parked.
+  WriteBundle(installed_, 2);
+  WriteBundle(installed_ + ".old", 1);
+  std::string version;
+  std::string error;
+  EXPECT_EQ(ApplyStagedUpdate(installed_, &version, &error),
+            StagedUpdateResult::kNone);
+  EXPECT_TRUE(Exists(installed_ + "/data/flutter_assets/new_asset.bin"));
+  EXPECT_FALSE(Exists(installed_ + ".old"));
+}
+
+TEST_F(BundlePatchTest, AppliesAHandWrittenPatch) {
+  // Keeps WriteRawPatch() honest for the tests below.
+  WriteRawPatch({{BundleEntryType::kDirectory, "lib", ""},
+                 {BundleEntryType::kFile, "lib/libapp.so", "code"},
+                 {BundleEntryType::kSymlink, "lib/current", "libapp.so"},
+                 {BundleEntryType::kSymlink, "app", "lib/current"},
+                 {BundleEntryType::kSymlink, "up", "lib/.."}});
+  std::string error;
+  ASSERT_TRUE(ApplyRawPatch(&error)) << error;
+  const std::vector<uint8_t> code = {'c', 'o', 'd', 'e'};
+  EXPECT_EQ(Read(staging_ + "/app"), code);
+  EXPECT_EQ(Read(staging_ + "/up/lib/libapp.so"), code);
+}
+
+TEST_F(BundlePatchTest, RefusesLinksThatLeaveTheBundle) {
+  const std::string outside = root_ + "/outside";
+  for (const std::string& target :
+       {outside, std::string("/"), std::string("../.."),
+        std::string("../../outside"), std::string("lib/../../..")}) {
+    WriteRawPatch({{BundleEntryType::kDirectory, "lib", ""},
+                   {BundleEntryType::kSymlink, "lib/escape", target}});
+    std::string error;
+    EXPECT_FALSE(ApplyRawPatch(&error)) << target;
+    EXPECT_EQ(error, "unsafe link in patch: lib/escape -> " + target);
+    EXPECT_FALSE(Exists(staging_));
+  }
+
+  // Lexically inside, but through a link that itself points at the root.
+  WriteRawPatch({{BundleEntryType::kSymlink, "here", "."},
+                 {BundleEntryType::kSymlink, "there", "here/.."}});
+  std::string error;
+  EXPECT_FALSE(ApplyRawPatch(&error));
+  EXPECT_EQ(error, "unsafe link in patch: there -> here/..");
+}
+
+TEST_F(BundlePatchTest, NeverWritesThroughALink) {
+  const std::string outside = root_ + "/outside";
+  ASSERT_EQ(mkdir(outside.c_str(), 0755), 0);
+
+  // A link followed by entries below it.
+  WriteRawPatch({{BundleEntryType::kSymlink, "lib", outside},
+                 {BundleEntryType::kFile, "lib/evil", "payload"}});
+  std::string error;
+  EXPECT_FALSE(ApplyRawPatch(&error));
+  EXPECT_EQ(error, "unsafe path in patch: lib/evil");
+  EXPECT_FALSE(Exists(outside + "/evil"));
+
+  WriteRawPatch({{BundleEntryType::kSymlink, "lib", "."},
+                 {BundleEntryType::kDirectory, "lib/data", ""}});
+  EXPECT_FALSE(ApplyRawPatch(&error));
+  EXPECT_EQ(error, "unsafe path in patch: lib/data");
+
+  // A link followed by a file at the same path.
+  WriteRawPatch({{BundleEntryType::kSymlink, "app", outside + "/victim"},
+                 {BundleEntryType::kFile, "app", "payload"}});
+  EXPECT_FALSE(ApplyRawPatch(&error));
+  EXPECT_EQ(error, "cannot stage app");
+  EXPECT_FALSE(Exists(outside + "/victim"));
+  EXPECT_FALSE(Exists(staging_));
+}
+
+TEST_F(BundlePatchTest, WillNotCreateAPatchWithAnEscapingLink) {
+  WriteBundle(installed_, 1);
+  next_ = root_ + "/next";
+  WriteBundle(next_, 2);
+  ASSERT_EQ(symlink("/etc", (next_ + "/lib/etc").c_str()), 0);
+  BundlePatchStats stats;
+  std::string error;
+  EXPECT_FALSE(CreateBundlePatch(installed_, next_, patch_, &stats, &error));
+  EXPECT_EQ(error, "link leaves the bundle: lib/etc -> /etc");
+}
+
+}  // namespace
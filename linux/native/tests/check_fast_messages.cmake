@@ -0,0 +1,28 @@
+# Regenerates the fast-path codecs from codec/fast_messages.schema and fails
+# if the checked-in copies differ. Run by ctest as fast_messages_up_to_date.
+
+file(MAKE_DIRECTORY "${OUTPUT_DIR}/codec")
+execute_process(
+  COMMAND "${GENERATOR}" "${SOURCE_DIR}/codec/fast_messages.schema"
+          "${OUTPUT_DIR}/codec/fast_messages.g.h"
+          "${OUTPUT_DIR}/fast_messages.g.dart"
+  RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "ss_codec_gen failed")
+endif()
+
+foreach(pair
+    "codec/fast_messages.g.h|${SOURCE_DIR}/codec/fast_messages.g.h"
+    "fast_messages.g.dart|${SOURCE_DIR}/../../lib/native/fast_messages.g.dart")
+  string(REPLACE "|" ";" paths "${pair}")
+  list(GET paths 0 generated)
+  list(GET paths 1 checked_in)
+  execute_process(
+    COMMAND ${CMAKE_COMMAND} -E compare_files
+            "${OUTPUT_DIR}/${generated}" "${checked_in}"
+    RESULT_VARIABLE different)
+  if(different)
+    message(FATAL_ERROR "${checked_in} is out of date; regenerate it with "
+                        "ss_codec_gen (see codec/fast_messages.schema)")
+  endif()
+endforeach()
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include "runner/click_through.h"
+#include "tests/runner_fakes.h"
+
+namespace {
+
+TEST(ClickThroughTest, EnablingIsTransparentAtOnce) {
+  FakeClickThroughBackend backend;
+  ClickThroughController controller(&backend);
+  controller.SetEnabled(true);
+  EXPECT_TRUE(backend.polling);
+  EXPECT_TRUE(backend.transparent);
+  EXPECT_TRUE(controller.transparent());
+}
+
+TEST(ClickThroughTest, OpaqueOnlyOverTheVisibleStrip) {
+  FakeClickThroughBackend backend;
+  ClickThroughController controller(&backend);
+  controller.SetEnabled(true);
+
+  // Left part of the window: clicks go through.
+  backend.cursor = {200, 150};
+  controller.Poll();
+  EXPECT_TRUE(backend.transparent);
+
+  // The strip is the last 85 px of the client area (x >= 414).
+  backend.cursor = {414, 150};
+  controller.Poll();
+  EXPECT_FALSE(backend.transparent);
+  backend.cursor = {413, 150};
+  controller.Poll();
+  EXPECT_TRUE(backend.transparent);
+
+  // Right of the strip but outside the window.
+  backend.cursor = {600, 150};
+  controller.Poll();
+  EXPECT_TRUE(backend.transparent);
+  backend.cursor = {450, 250};
+  controller.Poll();
+  EXPECT_TRUE(backend.transparent);
+}
+
+TEST(ClickThroughTest, ChangesTheStyleOnlyOnTransitions) {
+  FakeClickThroughBackend backend;
+  ClickThroughController controller(&backend);
+  controller.SetEnabled(true);
+  const int after_enable = backend.style_changes;
+
+  backend.cursor = {200, 150};
+  for (int i = 0; i < 10; i++) {
+    controller.Poll();
+  }
+  EXPECT_EQ(backend.style_changes, after_enable);
+
+  backend.cursor = {450, 150};
+  for (int i = 0; i < 10; i++) {
+    controller.Poll();
+  }
+  EXPECT_EQ(backend.style_changes, after_enable + 1);
+}
+
+TEST(ClickThroughTest, DisablingAlwaysClearsTransparency) {
+  FakeClickThroughBackend backend;
+  ClickThroughController controller(&backend);
+  controller.SetEnabled(true);
+  controller.SetEnabled(false);
+  EXPECT_FALSE(backend.polling);
+  EXPECT_FALSE(backend.transparent);
+  EXPECT_EQ(backend.frame_refreshes, 1);
+
+  // Even if the window got out of step with the cached state.
+  backend.transparent = true;
+  controller.SetEnabled(false);
+  EXPECT_FALSE(backend.transparent);
+
+  // A poll that was already queued does nothing once disabled.
+  backend.transparent = false;
+  backend.cursor = {200, 150};
+  controller.Poll();
+  EXPECT_FALSE(backend.transparent);
+}
+
+TEST(ClickThroughTest, RepeatedSwitchesKeepOnePollTimer) {
+  FakeClickThroughBackend backend;
+  ClickThroughController controller(&backend);
+  for (int i = 0; i < 5; i++) {
+    controller.SetEnabled(true);
+    controller.SetEnabled(true);
+    EXPECT_TRUE(backend.polling);
+    controller.SetEnabled(false);
+    EXPECT_FALSE(backend.polling);
+  }
+}
+
+}  // namespace
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "coro/awaitables.h"
+#include "coro/file_io.h"
+#include "coro/task.h"
+
+namespace {
+
+// Stands in for the runner's GLib main loop: sleeps until the pool posts
+// results and drains them in batches on the test thread.
+class HeadlessMainLoop {
+ public:
+  HeadlessMainLoop() { ss_pool_set_main_wakeup(&HeadlessMainLoop::Wake, this); }
+  ~HeadlessMainLoop() { ss_pool_set_main_wakeup(nullptr, nullptr); }
+
+  // Returns false if |done| did not become true within |timeout|.
+  bool RunUntil(const std::function<bool()>& done,
+                std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!done()) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!woken_.wait_until(lock, deadline, [this] { return wake_; })) {
+          return false;
+        }
+        wake_ = false;
+      }
+      while (ss_pool_drain_main(4 * 1000 * 1000)) {
+      }
+    }
+    return true;
+  }
+
+ private:
+  static void Wake(void* data) {
+    HeadlessMainLoop* self = static_cast<HeadlessMainLoop*>(data);
+    std::lock_guard<std::mutex> lock(self->mutex_);
+    self->wake_ = true;
+    self->woken_.notify_one();
+  }
+
+  std::mutex mutex_;
+  std::condition_variable woken_;
+  bool wake_ = false;
+};
+
+Task<int> Add(int a, int b) {
+  co_return a + b;
+}
+
+Task<int> AddTwice(int a, int b) {
+  int first = co_await Add(a, b);
+  int second = co_await Add(first, b);
+  co_return second;
+}
+
+TEST(CoroTaskTest, ChainsWithoutSuspendingRunSynchronously) {
+  int result = 0;
+  Spawn([](int* out) -> Task<void> { *out = co_await AddTwice(1, 2); }(
+      &result));
+  EXPECT_EQ(result, 5);
+}
+
+TEST(CoroTaskTest, UnawaitedTaskNeverRuns) {
+  bool ran = false;
+  {
+    Task<void> task = [](bool* flag) -> Task<void> {
+      *flag = true;
+      co_return;
+    }(&ran);
+    EXPECT_TRUE(task.valid());
+  }
+  EXPECT_FALSE(ran);
+}
+
+TEST(CoroTaskTest, MovesOnlyResults) {
+  std::string result;
+  Spawn([](std::string* out) -> Task<void> {
+    auto make = []() -> Task<std::unique_ptr<std::string>> {
+      co_return std::make_unique<std::string>("moved");
+    };
+    std::unique_ptr<std::string> value = co_await make();
+    *out = *value;
+  }(&result));
+  EXPECT_EQ(result, "moved");
+}
+
+TEST(CoroSchedulingTest, HopsBetweenMainThreadAndPool) {
+  HeadlessMainLoop loop;
+  const std::thread::id main_thread = std::this_thread::get_id();
+  std::thread::id on_pool;
+  std::thread::id back_on_main;
+  std::atomic<bool> done{false};
+
+  Spawn([](std::thread::id* pool_thread, std::thread::id* main,
+           std::atomic<bool>* finished) -> Task<void> {
+    co_await ResumeOnPool(TaskPriority::kInteractive);
+    *pool_thread = std::this_thread::get_id();
+    co_await ResumeOnMain();
+    *main = std::this_thread::get_id();
+    finished->store(true);
+  }(&on_pool, &back_on_main, &done));
+
+  ASSERT_TRUE(loop.RunUntil([&] { return done.load(); }));
+  EXPECT_NE(on_pool, main_thread);
+  EXPECT_EQ(back_on_main, main_thread);
+}
+
+TEST(CoroSchedulingTest, RunInBackgroundReturnsToMainWithResult) {
+  HeadlessMainLoop loop;
+  const std::thread::id main_thread = std::this_thread::get_id();
+  std::thread::id worker;
+  std::thread::id resumed;
+  int value = 0;
+  bool done = false;
+
+  Spawn([](std::thread::id* worker_thread, std::thread::id* resumed_thread,
+           int* out, bool* finished) -> Task<void> {
+    *out = co_await RunInBackground([worker_thread] {
+      *worker_thread = std::this_thread::get_id();
+      return 42;
+    });
+    *resumed_thread = std::this_thread::get_id();
+    *finished = true;
+  }(&worker, &resumed, &value, &done));
+
+  ASSERT_TRUE(loop.RunUntil([&] { return done; }));
+  EXPECT_EQ(value, 42);
+  EXPECT_NE(worker, main_thread);
+  EXPECT_EQ(resumed, main_thread);
+}
+
+TEST(CoroSchedulingTest, ManyConcurrentCoroutinesAllFinish) {
+  HeadlessMainLoop loop;
+  constexpr int kCoroutines = 2000;
+  int finished = 0;
+  std::atomic<int> on_pool{0};
+
+  for (int i = 0; i < kCoroutines; i++) {
+    Spawn([](int* count, std::atomic<int>* pool_count) -> Task<void> {
+      co_await ResumeOnPool(TaskPriority::kBackground);
+      pool_count->fetch_add(1);
+      co_await ResumeOnMain();
+      // Only the main thread touches |count|.
+      (*count)++;
+    }(&finished, &on_pool));
+  }
+
+  ASSERT_TRUE(loop.RunUntil([&] { return finished == kCoroutines; }));
+  EXPECT_EQ(on_pool.load(), kCoroutines);
+}
+
+class CoroFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char pattern[] = "/tmp/coro_test_XXXXXX";
+    ASSERT_NE(mkdtemp(pattern), nullptr);
+    directory_ = pattern;
+  }
+  void TearDown() override {
+    unlink((directory_ + "/file").c_str());
+    rmdir(directory_.c_str());
+  }
+
+  std::string directory_;
+};
+
+TEST_F(CoroFileTest, WritesThenReadsBack) {
+  HeadlessMainLoop loop;
+  const std::string path = directory_ + "/file";
+  FileResult written;
+  FileResult read;
+  bool done = false;
+
+  Spawn([](std::string file, FileResult* write_result,
+           FileResult* read_result, bool* finished) -> Task<void> {
+    *write_result = co_await WriteFileAsync(file, std::string(100000, 'x'));
+    *read_result = co_await ReadFileAsync(file);
+    *finished = true;
+  }(path, &written, &read, &done));
+
+  ASSERT_TRUE(loop.RunUntil([&] { return done; }));
+  EXPECT_TRUE(written.ok());
+  ASSERT_TRUE(read.ok());
+  EXPECT_EQ(read.data, std::string(100000, 'x'));
+  EXPECT_NE(access((path + ".tmp").c_str(), F_OK), 0);
+}
+
+TEST_F(CoroFileTest, ReportsMissingFile) {
+  HeadlessMainLoop loop;
+  FileResult read;
+  bool done = false;
+
+  Spawn([](std::string file, FileResult* result, bool* finished)
+            -> Task<void> {
+    *result = co_await ReadFileAsync(file);
+    *finished = true;
+  }(directory_ + "/missing", &read, &done));
+
+  ASSERT_TRUE(loop.RunUntil([&] { return done; }));
+  EXPECT_EQ(read.error, ENOENT);
+}
+
+}  // namespace
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "update/binary_delta.h"
+#include "update/delta_kernels.h"
+
+namespace {
+
+std::vector<SimdLevel> SupportedLevels() {
+  std::vector<SimdLevel> levels = {SimdLevel::kScalar};
+  if (DetectSimdLevel() >= SimdLevel::kAvx2) {
+    levels.push_back(SimdLevel::kAvx2);
+  }
+  if (DetectSimdLevel() >= SimdLevel::kAvx512) {
+    levels.push_back(SimdLevel::kAvx512);
+  }
+  return levels;
+}
+
+std::vector<uint8_t> RandomBytes(size_t size, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::vector<uint8_t> data(size);
+  for (uint8_t& byte : data) {
+    byte = static_cast<uint8_t>(rng() % 4);  // Many equal bytes.
+  }
+  return data;
+}
+
+// Every length around the vector widths, every position of the first
+// difference.
+TEST(DeltaKernelsTest, MismatchMatchesScalar) {
+  const DeltaKernels& scalar = DeltaKernelsFor(SimdLevel::kScalar);
+  for (SimdLevel level : SupportedLevels()) {
+    const DeltaKernels& kernels = DeltaKernelsFor(level);
+    for (int64_t size = 0; size <= 200; size++) {
+      std::vector<uint8_t> a = RandomBytes(size, 1);
+      std::vector<uint8_t> b = a;
+      EXPECT_EQ(kernels.mismatch(a.data(), b.data(), size), size);
+      for (int64_t at = 0; at < size; at++) {
+        b[at] ^= 0x80;
+        EXPECT_EQ(kernels.mismatch(a.data(), b.data(), size), at)
+            << SimdLevelName(level) << " size " << size;
+        EXPECT_EQ(scalar.mismatch(a.data(), b.data(), size), at);
+        b[at] ^= 0x80;
+      }
+    }
+  }
+}
+
+TEST(DeltaKernelsTest, CountEqualAndAddMatchScalar) {
+  const DeltaKernels& scalar = DeltaKernelsFor(SimdLevel::kScalar);
+  for (SimdLevel level : SupportedLevels()) {
+    const DeltaKernels& kernels = DeltaKernelsFor(level);
+    for (int64_t size : {0, 1, 31, 32, 33, 63, 64, 65, 127, 1000, 4099}) {
+      const std::vector<uint8_t> a = RandomBytes(size, 2);
+      const std::vector<uint8_t> b = RandomBytes(size, 3);
+      EXPECT_EQ(kernels.count_equal(a.data(), b.data(), size),
+                scalar.count_equal(a.data(), b.data(), size))
+          << SimdLevelName(level) << " size " << size;
+
+      std::vector<uint8_t> expected(size);
+      std::vector<uint8_t> actual(size + 1, 0xEE);
+      scalar.add(a.data(), b.data(), expected.data(), size);
+      kernels.add(a.data(), b.data(), actual.data(), size);
+      EXPECT_EQ(std::vector<uint8_t>(actual.begin(), actual.end() - 1),
+                expected);
+      EXPECT_EQ(actual.back(), 0xEE) << "wrote past the end";
+
+      // In place, as ApplyBinaryDelta may.
+      std::vector<uint8_t> in_place = a;
+      kernels.add(in_place.data(), b.data(), in_place.data(), size);
+      EXPECT_EQ(in_place, expected);
+    }
+  }
+}
+
+TEST(DeltaKernelsTest, DeltaRoundTrips) {
+  std::vector<uint8_t> old_data = RandomBytes(50000, 4);
+  std::vector<uint8_t> new_data = old_data;
+  // An insertion, so later bytes move, and a few edits.
+  new_data.insert(new_data.begin() + 1000, 300, 7);
+  for (size_t i = 5000; i < new_data.size(); i += 997) {
+    new_data[i] += 1;
+  }
+  std::vector<uint8_t> delta;
+  ASSERT_TRUE(CreateBinaryDelta(old_data.data(), old_data.size(),
+                                new_data.data(), new_data.size(), &delta));
+  EXPECT_LT(delta.size(), new_data.size() / 4);
+  std::vector<uint8_t> rebuilt;
+  ASSERT_TRUE(ApplyBinaryDelta(old_data.data(), old_data.size(), delta.data(),
+                               delta.size(), &rebuilt));
+  EXPECT_EQ(rebuilt, new_data);
+}
+
+}  // namespace
@@ -0,0 +1,262 @@
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "export/csv_writer.h"
+#include "export/pdf_writer.h"
+#include "export/xlsx_writer.h"
+#include "export/xml_escape.h"
+#include "export/zip_writer.h"
+#include "tests/temp_dir.h"
+
+namespace {
+
+uint32_t ReadU16(const std::string& data, size_t at) {
+  return static_cast<uint8_t>(data[at]) |
+         static_cast<uint8_t>(data[at + 1]) << 8;
+}
+
+uint32_t ReadU32(const std::string& data, size_t at) {
+  return ReadU16(data, at) | ReadU16(data, at + 2) << 16;
+}
+
+std::string Inflate(const std::string& compressed, int window_bits,
+                    size_t expected_size) {
+  std::string out(expected_size, '\0');
+  z_stream stream = {};
+  if (inflateInit2(&stream, window_bits) != Z_OK) {
+    return std::string();
+  }
+  stream.next_in =
+      reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+  stream.avail_in = static_cast<uInt>(compressed.size());
+  stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+  stream.avail_out = static_cast<uInt>(out.size());
+  const int result = inflate(&stream, Z_FINISH);
+  out.resize(stream.total_out);
+  inflateEnd(&stream);
+  return result == Z_STREAM_END ? out : std::string();
+}
+
+// Reads an archive back through its central directory, checking each
+// entry's CRC and sizes. Returns the entries by name, in archive order in
+// |names|; empty when the archive is malformed.
+std::map<std::string, std::string> ReadZip(const std::string& archive,
+                                           std::vector<std::string>* names) {
+  std::map<std::string, std::string> entries;
+  if (archive.size() < 22 ||
+      ReadU32(archive, archive.size() - 22) != 0x06054b50) {
+    ADD_FAILURE() << "no end of central directory record";
+    return entries;
+  }
+  const size_t end = archive.size() - 22;
+  const uint32_t count = ReadU16(archive, end + 10);
+  size_t at = ReadU32(archive, end + 16);
+  EXPECT_EQ(at + ReadU32(archive, end + 12), end);
+  for (uint32_t i = 0; i < count; i++) {
+    if (ReadU32(archive, at) != 0x02014b50) {
+      ADD_FAILURE() << "bad central directory record " << i;
+      return {};
+    }
+    const uint32_t method = ReadU16(archive, at + 10);
+    const uint32_t crc = ReadU32(archive, at + 16);
+    const uint32_t compressed_size = ReadU32(archive, at + 20);
+    const uint32_t size = ReadU32(archive, at + 24);
+    const uint32_t name_size = ReadU16(archive, at + 28);
+    const uint32_t extra_size = ReadU16(archive, at + 30);
+    const uint32_t comment_size = ReadU16(archive, at + 32);
+    const uint32_t local = ReadU32(archive, at + 42);
+    const std::string name = archive.substr(at + 46, name_size);
+    at += 46 + name_size + extra_size + comment_size;
+
+    EXPECT_EQ(ReadU32(archive, local), 0x04034b50u) << name;
+    EXPECT_EQ(archive.substr(local + 30, ReadU16(archive, local + 26)), name);
+    const size_t data = local + 30 + ReadU16(archive, local + 26) +
+                        ReadU16(archive, local + 28);
+    EXPECT_EQ(method, 8u) << name;
+    const std::string content =
+        Inflate(archive.substr(data, compressed_size), -MAX_WBITS, size);
+    EXPECT_EQ(content.size(), size) << name;
+    EXPECT_EQ(crc32(0, reinterpret_cast<const Bytef*>(content.data()),
+                    static_cast<uInt>(content.size())),
+              crc)
+        << name;
+    names->push_back(name);
+    entries[name] = content;
+  }
+  return entries;
+}
+
+class ExportWritersTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_FALSE(temp_.path().empty());
+    root_ = temp_.path();
+  }
+
+  static std::string Read(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in),
+                       std::istreambuf_iterator<char>());
+  }
+
+  // Everything a writer has to escape, in one row.
+  static ExportRow AwkwardRow() {
+    ExportRow row;
+    row.date = "2024-03-05";
+    row.project = "=HYPERLINK(\"x\")";
+    row.title = "Fix <b> & \"quotes\", (parens) \\ too";
+    row.description = "line one\nline two\x01\x1f\tend";
+    row.duration_seconds = 5400;
+    return row;
+  }
+
+  TempDir temp_{"export_writers_test"};
+  std::string root_;
+};
+
+TEST(XmlEscapeTest, EscapesMarkupAndDropsControlCharacters) {
+  std::string out;
+  AppendXmlEscaped("a & b <c> \"d\" 'e'", &out);
+  EXPECT_EQ(out, "a &amp; b &lt;c&gt; &quot;d&quot; 'e'");
+  out.clear();
+  AppendXmlEscaped(std::string("x\x01y\x1f\x7f\tz\r\n\xC3\xA9", 11), &out);
+  EXPECT_EQ(out, "xy\x7f\tz\r\n\xC3\xA9");
+}
+
+TEST_F(ExportWritersTest, CsvQuotesEscapesAndDefusesFormulas) {
+  const std::string path = root_ + "/report.csv";
+  CsvWriter writer(path);
+  ASSERT_TRUE(writer.Begin());
+  ASSERT_TRUE(writer.WriteRow(AwkwardRow()));
+  ExportRow plain;
+  plain.date = "2024-03-06";
+  plain.project = "Plain";
+  plain.title = "-1 is negative";
+  plain.duration_seconds = 900;
+  ASSERT_TRUE(writer.WriteRow(plain));
+  ASSERT_TRUE(writer.Finish());
+
+  EXPECT_EQ(Read(path),
+            "\xEF\xBB\xBF"
+            "Date,Project,Task,Description,Start,End,Duration,Hours\r\n"
+            "2024-03-05,\"'=HYPERLINK(\"\"x\"\")\","
+            "\"Fix <b> & \"\"quotes\"\", (parens) \\ too\","
+            "\"line one\nline two\x01\x1f\tend\",,,1h 30m,1.50\r\n"
+            "2024-03-06,Plain,'-1 is negative,,,,15m,0.25\r\n"
+            "Total,,,,,,1h 45m,1.75\r\n");
+}
+
+TEST_F(ExportWritersTest, AbortLeavesNoFile) {
+  const std::string path = root_ + "/report.csv";
+  CsvWriter writer(path);
+  ASSERT_TRUE(writer.Begin());
+  ASSERT_TRUE(writer.WriteRow(AwkwardRow()));
+  writer.Abort();
+  EXPECT_FALSE(std::ifstream(path).good());
+}
+
+TEST_F(ExportWritersTest, ZipEntriesRoundTrip) {
+  const std::string path = root_ + "/archive.zip";
+  std::string large;
+  for (int i = 0; i < 100000; i++) {
+    large += "row " + std::to_string(i) + "\n";
+  }
+  ZipWriter zip;
+  ASSERT_TRUE(zip.Open(path));
+  ASSERT_TRUE(zip.BeginEntry("empty.txt"));
+  ASSERT_TRUE(zip.EndEntry());
+  ASSERT_TRUE(zip.BeginEntry("dir/large.txt"));
+  // In pieces, the way the worksheet is streamed.
+  for (size_t at = 0; at < large.size(); at += 7000) {
+    ASSERT_TRUE(zip.Write(large.substr(at, 7000)));
+  }
+  // Starting an entry closes the previous one.
+  ASSERT_TRUE(zip.BeginEntry("small.txt"));
+  ASSERT_TRUE(zip.Write("hello"));
+  ASSERT_TRUE(zip.Finish());
+  EXPECT_EQ(zip.bytes_written(), Read(path).size());
+  EXPECT_LT(zip.bytes_written(), large.size() / 4);
+
+  std::vector<std::string> names;
+  auto entries = ReadZip(Read(path), &names);
+  EXPECT_EQ(names, (std::vector<std::string>{"empty.txt", "dir/large.txt",
+                                             "small.txt"}));
+  EXPECT_EQ(entries["empty.txt"], "");
+  EXPECT_EQ(entries["dir/large.txt"], large);
+  EXPECT_EQ(entries["small.txt"], "hello");
+}
+
+TEST_F(ExportWritersTest, XlsxEscapesCellsAndSheetName) {
+  const std::string path = root_ + "/report.xlsx";
+  XlsxWriter writer(path, "Q1 [draft] & <final>: a/b");
+  ASSERT_TRUE(writer.Begin());
+  ASSERT_TRUE(writer.WriteRow(AwkwardRow()));
+  ASSERT_TRUE(writer.Finish());
+
+  std::vector<std::string> names;
+  auto entries = ReadZip(Read(path), &names);
+  ASSERT_EQ(names.size(), 6u);
+  EXPECT_EQ(names[0], "[Content_Types].xml");
+  EXPECT_NE(entries["xl/workbook.xml"].find(
+                "<sheet name=\"Q1 draft &amp; &lt;final&gt; ab\""),
+            std::string::npos)
+      << entries["xl/workbook.xml"];
+
+  const std::string& sheet = entries["xl/worksheets/sheet1.xml"];
+  EXPECT_NE(sheet.find("<t xml:space=\"preserve\">=HYPERLINK(&quot;x&quot;)"
+                       "</t>"),
+            std::string::npos);
+  EXPECT_NE(sheet.find("<t xml:space=\"preserve\">Fix &lt;b&gt; &amp; "
+                       "&quot;quotes&quot;, (parens) \\ too</t>"),
+            std::string::npos);
+  // Control characters other than tab and newlines cannot appear in XML.
+  EXPECT_NE(sheet.find("<t xml:space=\"preserve\">line one\nline two\tend"
+                       "</t>"),
+            std::string::npos);
+  EXPECT_NE(sheet.find("<c r=\"G2\" s=\"2\"><v>1.50</v></c>"),
+            std::string::npos);
+  EXPECT_NE(sheet.find("<f>SUM(G2:G2)</f>"), std::string::npos);
+  EXPECT_EQ(sheet.substr(sheet.size() - 24), "</sheetData></worksheet>");
+}
+
+TEST_F(ExportWritersTest, PdfEscapesStringsAndIndexesObjects) {
+  const std::string path = root_ + "/report.pdf";
+  PdfWriter writer(path, "Report (March)");
+  ASSERT_TRUE(writer.Begin());
+  ASSERT_TRUE(writer.WriteRow(AwkwardRow()));
+  ASSERT_TRUE(writer.Finish());
+  const std::string pdf = Read(path);
+
+  ASSERT_EQ(pdf.compare(0, 5, "%PDF-"), 0);
+  ASSERT_GE(pdf.size(), 6u);
+  EXPECT_EQ(pdf.substr(pdf.size() - 6), "%%EOF\n");
+  // startxref points at the cross-reference table.
+  const size_t startxref = pdf.rfind("startxref\n");
+  ASSERT_NE(startxref, std::string::npos);
+  const size_t xref = std::stoul(pdf.substr(startxref + 10));
+  EXPECT_EQ(pdf.compare(xref, 4, "xref"), 0);
+
+  std::string text;
+  for (size_t at = pdf.find("stream\n"); at != std::string::npos;
+       at = pdf.find("stream\n", at + 1)) {
+    if (at >= 3 && pdf.compare(at - 3, 3, "end") == 0) {
+      continue;
+    }
+    const size_t begin = at + 7;
+    const size_t end = pdf.find("\nendstream", begin);
+    ASSERT_NE(end, std::string::npos);
+    text += Inflate(pdf.substr(begin, end - begin), MAX_WBITS, 1 << 20);
+  }
+  EXPECT_NE(text.find("(Report \\(March\\))"), std::string::npos);
+  EXPECT_NE(text.find("\\(parens\\) \\\\ too"), std::string::npos);
+  EXPECT_EQ(text.find('\x01'), std::string::npos);
+}
+
+}  // namespace
@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "codec/fast_codec.h"
+#include "codec/fast_messages.g.h"
+#include "diagnostics/channel_metrics.h"
+
+namespace {
+
+namespace audio = fast_messages::audio_recorder;
+
+class FakeAudioRecorder : public audio::Handler {
+ public:
+  bool HasPermission(const audio::HasPermissionArgs& args,
+                     audio::HasPermissionResult* result,
+                     FastError* error) override {
+    result->granted = true;
+    return true;
+  }
+
+  bool StartRecording(const audio::StartRecordingArgs& args,
+                      audio::StartRecordingResult* result,
+                      FastError* error) override {
+    path_data = args.path.data;
+    path = args.path.ToString();
+    recording = true;
+    result->started = true;
+    return true;
+  }
+
+  bool StopRecording(const audio::StopRecordingArgs& args,
+                     audio::StopRecordingResult* result,
+                     FastError* error) override {
+    if (!recording) {
+      *error = {"NO_RECORDER", "No active recording"};
+      return false;
+    }
+    recording = false;
+    result->path = path;
+    return true;
+  }
+
+  bool IsRecording(const audio::IsRecordingArgs& args,
+                   audio::IsRecordingResult* result,
+                   FastError* error) override {
+    result->recording = recording;
+    return true;
+  }
+
+  const char* path_data = nullptr;
+  std::string path;
+  bool recording = false;
+};
+
+TEST(FastCodecTest, ScalarsRoundTrip) {
+  FastWriter writer;
+  writer.WriteBool(true);
+  writer.WriteInt32(-123456);
+  writer.WriteInt64(INT64_MIN + 5);
+  writer.WriteFloat64(-2.5e-300);
+  writer.WriteString(std::string("grüße"));
+  const std::vector<uint8_t> bytes = writer.Take();
+
+  FastReader reader(bytes.data(), bytes.size());
+  bool flag = false;
+  int32_t small = 0;
+  int64_t large = 0;
+  double real = 0;
+  std::string text;
+  ASSERT_TRUE(reader.ReadBool(&flag));
+  ASSERT_TRUE(reader.ReadInt32(&small));
+  ASSERT_TRUE(reader.ReadInt64(&large));
+  ASSERT_TRUE(reader.ReadFloat64(&real));
+  ASSERT_TRUE(reader.ReadString(&text));
+  EXPECT_TRUE(reader.AtEnd());
+  EXPECT_TRUE(flag);
+  EXPECT_EQ(small, -123456);
+  EXPECT_EQ(large, INT64_MIN + 5);
+  EXPECT_EQ(real, -2.5e-300);
+  EXPECT_EQ(text, "grüße");
+}
+
+TEST(FastCodecTest, IsLittleEndian) {
+  FastWriter writer;
+  writer.WriteInt32(0x01020304);
+  EXPECT_EQ(writer.bytes(), (std::vector<uint8_t>{4, 3, 2, 1}));
+}
+
+TEST(FastCodecTest, BytesAreReadInPlace) {
+  const uint8_t payload[] = {9, 8, 7, 6, 5};
+  FastWriter writer;
+  writer.WriteBytes(payload, sizeof(payload));
+  const std::vector<uint8_t> bytes = writer.Take();
+
+  FastReader reader(bytes.data(), bytes.size());
+  FastByteView view;
+  ASSERT_TRUE(reader.ReadBytes(&view));
+  EXPECT_EQ(view.data, bytes.data() + 4);
+  EXPECT_EQ(std::vector<uint8_t>(view.data, view.data + view.size),
+            std::vector<uint8_t>(payload, payload + sizeof(payload)));
+}
+
+TEST(FastCodecTest, RejectsMalformedValues) {
+  const uint8_t bad_bool[] = {2};
+  FastReader bool_reader(bad_bool, sizeof(bad_bool));
+  bool flag;
+  EXPECT_FALSE(bool_reader.ReadBool(&flag));
+  EXPECT_TRUE(bool_reader.failed());
+
+  // Claims 100 bytes, has 2.
+  const uint8_t short_bytes[] = {100, 0, 0, 0, 1, 2};
+  FastReader bytes_reader(short_bytes, sizeof(short_bytes));
+  FastByteView view;
+  EXPECT_FALSE(bytes_reader.ReadBytes(&view));
+
+  FastReader empty(nullptr, 0);
+  int64_t value;
+  EXPECT_FALSE(empty.ReadInt64(&value));
+  EXPECT_FALSE(empty.AtEnd());
+}
+
+TEST(FastMessagesTest, DispatchesCallsAndEncodesResults) {
+  FakeAudioRecorder recorder;
+  const std::string path = "/tmp/task_audio_1.m4a";
+  audio::StartRecordingArgs args;
+  args.path = {path.data(), path.size()};
+  const std::vector<uint8_t> call = audio::EncodeStartRecording(args);
+
+  const std::vector<uint8_t> reply =
+      audio::Dispatch(&recorder, call.data(), call.size());
+  audio::StartRecordingResult result;
+  FastError error;
+  ASSERT_TRUE(audio::DecodeStartRecordingReply(reply.data(), reply.size(),
+                                               &result, &error))
+      << error.code;
+  EXPECT_TRUE(result.started);
+  EXPECT_EQ(recorder.path, path);
+  // The handler saw the path inside the message, not a copy.
+  EXPECT_GE(recorder.path_data,
+            reinterpret_cast<const char*>(call.data()));
+  EXPECT_LT(recorder.path_data,
+            reinterpret_cast<const char*>(call.data() + call.size()));
+
+  const std::vector<uint8_t> stop = audio::EncodeStopRecording({});
+  const std::vector<uint8_t> stop_reply =
+      audio::Dispatch(&recorder, stop.data(), stop.size());
+  audio::StopRecordingResult stopped;
+  ASSERT_TRUE(audio::DecodeStopRecordingReply(
+      stop_reply.data(), stop_reply.size(), &stopped, &error));
+  EXPECT_EQ(stopped.path, path);
+}
+
+TEST(FastMessagesTest, HandlerErrorsBecomeErrorReplies) {
+  FakeAudioRecorder recorder;
+  const std::vector<uint8_t> call = audio::EncodeStopRecording({});
+  const std::vector<uint8_t> reply =
+      audio::Dispatch(&recorder, call.data(), call.size());
+  ASSERT_FALSE(reply.empty());
+  EXPECT_EQ(reply[0], kFastReplyError);
+  EXPECT_EQ(StatusFromResponse(reply.data(), reply.size()),
+            ChannelCallStatus::kError);
+
+  audio::StopRecordingResult result;
+  FastError error;
+  EXPECT_FALSE(audio::DecodeStopRecordingReply(reply.data(), reply.size(),
+                                               &result, &error));
+  EXPECT_EQ(error.code, "NO_RECORDER");
+  EXPECT_EQ(error.message, "No active recording");
+}
+
+FastError DispatchError(const std::vector<uint8_t>& call) {
+  FakeAudioRecorder recorder;
+  const std::vector<uint8_t> reply =
+      audio::Dispatch(&recorder, call.data(), call.size());
+  audio::IsRecordingResult result;
+  FastError error;
+  EXPECT_FALSE(audio::DecodeIsRecordingReply(reply.data(), reply.size(),
+                                             &result, &error));
+  return error;
+}
+
+TEST(FastMessagesTest, RejectsBadCalls) {
+  std::vector<uint8_t> call = audio::EncodeIsRecording({});
+  call.push_back(0);
+  EXPECT_EQ(DispatchError(call).code, "INVALID_ARGS");
+
+  // Path length runs past the end of the message.
+  std::vector<uint8_t> truncated =
+      audio::EncodeStartRecording({{"/tmp/a.m4a", 10}});
+  truncated.resize(truncated.size() - 3);
+  EXPECT_EQ(DispatchError(truncated).code, "INVALID_ARGS");
+
+  std::vector<uint8_t> old_version = audio::EncodeIsRecording({});
+  old_version[1] = fast_messages::kVersion + 1;
+  EXPECT_EQ(DispatchError(old_version).code, "VERSION_MISMATCH");
+
+  // A StandardMethodCodec call sent to the wrong channel.
+  EXPECT_EQ(DispatchError({7, 11, 'i', 's', 'R', 'e', 'c', 'o', 'r', 'd',
+                           'i', 'n', 'g', 0})
+                .code,
+            "BAD_MESSAGE");
+}
+
+TEST(FastMessagesTest, UnknownCallsGetAnEmptyReply) {
+  FakeAudioRecorder recorder;
+  std::vector<uint8_t> call = audio::EncodeIsRecording({});
+  call[2] = 200;
+  EXPECT_TRUE(audio::Dispatch(&recorder, call.data(), call.size()).empty());
+  EXPECT_EQ(DispatchError(call).code, "NOT_IMPLEMENTED");
+}
+
+TEST(FastMessagesTest, ChannelMetricsNameCallsById) {
+  const std::vector<uint8_t> call = audio::EncodeIsRecording({});
+  EXPECT_EQ(MethodNameFromMessage(call.data(), call.size()), "call 4");
+}
+
+}  // namespace
@@ -0,0 +1,370 @@
+#include <gtest/gtest.h>
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ingest/file_ingest.h"
+#include "ingest/ingest_job.h"
+#include "tests/temp_dir.h"
+
+namespace {
+
+std::vector<uint8_t> Bytes(const std::string& text) {
+  return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+// Keeps embedded NULs.
+template <size_t N>
+std::vector<uint8_t> Bytes(const char (&text)[N]) {
+  return std::vector<uint8_t>(text, text + N - 1);
+}
+
+void PutBe32(std::vector<uint8_t>* data, size_t offset, uint32_t value) {
+  (*data)[offset] = value >> 24;
+  (*data)[offset + 1] = value >> 16;
+  (*data)[offset + 2] = value >> 8;
+  (*data)[offset + 3] = value;
+}
+
+void PutLe32(std::vector<uint8_t>* data, size_t offset, uint32_t value) {
+  (*data)[offset] = value;
+  (*data)[offset + 1] = value >> 8;
+  (*data)[offset + 2] = value >> 16;
+  (*data)[offset + 3] = value >> 24;
+}
+
+std::vector<uint8_t> Png(uint32_t width, uint32_t height) {
+  std::vector<uint8_t> data = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n',
+                               0,    0,   0,   13,  'I',  'H',  'D',  'R'};
+  data.resize(33);
+  PutBe32(&data, 16, width);
+  PutBe32(&data, 20, height);
+  return data;
+}
+
+// SOI, an APP0 segment to walk over, then a baseline frame header.
+std::vector<uint8_t> Jpeg(uint16_t width, uint16_t height) {
+  std::vector<uint8_t> data = {0xFF, 0xD8, 0xFF, 0xE0, 0, 16, 'J', 'F', 'I',
+                               'F',  0,    1,    1,    0, 0,  1,   0,   1,
+                               0,    0,    0xFF, 0xC0, 0, 17, 8};
+  data.push_back(height >> 8);
+  data.push_back(height & 0xFF);
+  data.push_back(width >> 8);
+  data.push_back(width & 0xFF);
+  data.resize(data.size() + 12);
+  return data;
+}
+
+std::vector<uint8_t> Bmp(int32_t width, int32_t height) {
+  std::vector<uint8_t> data(54);
+  data[0] = 'B';
+  data[1] = 'M';
+  PutLe32(&data, 14, 40);
+  PutLe32(&data, 18, static_cast<uint32_t>(width));
+  PutLe32(&data, 22, static_cast<uint32_t>(height));
+  return data;
+}
+
+std::string Hex(const uint8_t digest[Sha256::kDigestBytes]) {
+  return DigestToHex(digest);
+}
+
+std::string HashOf(const std::vector<uint8_t>& data) {
+  Sha256 hash;
+  hash.Update(data.data(), data.size());
+  uint8_t digest[Sha256::kDigestBytes];
+  hash.Final(digest);
+  return Hex(digest);
+}
+
+int32_t CountPages(const std::string& pdf, size_t piece) {
+  PdfPageCounter counter;
+  for (size_t i = 0; i < pdf.size(); i += piece) {
+    const size_t n = std::min(piece, pdf.size() - i);
+    counter.Update(reinterpret_cast<const uint8_t*>(pdf.data()) + i, n);
+  }
+  return counter.pages();
+}
+
+TEST(FileIngestTest, SniffsMagicBytes) {
+  struct Case {
+    std::vector<uint8_t> data;
+    IngestKind kind;
+  };
+  const Case cases[] = {
+      {Png(1, 1), IngestKind::kPng},
+      {Jpeg(1, 1), IngestKind::kJpeg},
+      {Bytes("GIF89a\x01\x00\x01\x00"), IngestKind::kGif},
+      {Bmp(1, 1), IngestKind::kBmp},
+      {Bytes("RIFF\x10\x00\x00\x00WEBPVP8X"), IngestKind::kWebp},
+      {Bytes("\0\0\0\x18" "ftypheic"), IngestKind::kHeif},
+      {Bytes("%PDF-1.7\n"), IngestKind::kPdf},
+      {Bytes("PK\x03\x04[Content_Types].xml"), IngestKind::kZip},
+      {Bytes("Site visit notes\r\n\tday 2\n"), IngestKind::kText},
+      // Text that happens to start like a bitmap.
+      {Bytes("BMW service invoice\n"), IngestKind::kText},
+      {Bytes("\x7F" "ELF\x02\x01\x01\0\0\0"), IngestKind::kUnknown},
+  };
+  for (const Case& c : cases) {
+    EXPECT_EQ(SniffKind(c.data.data(), c.data.size()), c.kind)
+        << IngestMimeType(c.kind);
+  }
+  EXPECT_STREQ(IngestMimeType(IngestKind::kPdf), "application/pdf");
+  EXPECT_TRUE(IsImageKind(IngestKind::kHeif));
+  EXPECT_FALSE(IsImageKind(IngestKind::kPdf));
+}
+
+TEST(FileIngestTest, ReadsImageSizes) {
+  int32_t width = 0;
+  int32_t height = 0;
+  std::vector<uint8_t> png = Png(4032, 3024);
+  ASSERT_TRUE(
+      ReadImageSize(IngestKind::kPng, png.data(), png.size(), &width,
+                    &height));
+  EXPECT_EQ(width, 4032);
+  EXPECT_EQ(height, 3024);
+
+  std::vector<uint8_t> jpeg = Jpeg(1920, 1080);
+  ASSERT_TRUE(ReadImageSize(IngestKind::kJpeg, jpeg.data(), jpeg.size(),
+                            &width, &height));
+  EXPECT_EQ(width, 1920);
+  EXPECT_EQ(height, 1080);
+  // Cut before the frame header.
+  EXPECT_FALSE(
+      ReadImageSize(IngestKind::kJpeg, jpeg.data(), 20, &width, &height));
+
+  std::vector<uint8_t> bmp = Bmp(640, -480);  // Top-down.
+  ASSERT_TRUE(ReadImageSize(IngestKind::kBmp, bmp.data(), bmp.size(), &width,
+                            &height));
+  EXPECT_EQ(width, 640);
+  EXPECT_EQ(height, 480);
+
+  std::vector<uint8_t> gif = Bytes("GIF89a\x2C\x01\xC8\x00");
+  ASSERT_TRUE(ReadImageSize(IngestKind::kGif, gif.data(), gif.size(), &width,
+                            &height));
+  EXPECT_EQ(width, 300);
+  EXPECT_EQ(height, 200);
+
+  // VP8X stores width - 1 and height - 1 in 24 bits.
+  std::vector<uint8_t> webp = Bytes("RIFF\0\0\0\0WEBPVP8X");
+  webp.resize(30);
+  webp[24] = 0xFF;  // 1280 - 1 = 0x4FF.
+  webp[25] = 0x04;
+  webp[27] = 0xCF;  // 720 - 1 = 0x2CF.
+  webp[28] = 0x02;
+  ASSERT_TRUE(ReadImageSize(IngestKind::kWebp, webp.data(), webp.size(),
+                            &width, &height));
+  EXPECT_EQ(width, 1280);
+  EXPECT_EQ(height, 720);
+
+  EXPECT_FALSE(ReadImageSize(IngestKind::kPdf, png.data(), png.size(), &width,
+                             &height));
+}
+
+TEST(FileIngestTest, CountsPdfPagesAcrossPieces) {
+  const std::string pdf =
+      "%PDF-1.4\n"
+      "1 0 obj << /Type /Catalog /Pages 2 0 R >> endobj\n"
+      "2 0 obj << /Type /Pages /Kids [3 0 R 4 0 R 5 0 R] /Count 3 >> endobj\n"
+      "3 0 obj << /Type /Page /Parent 2 0 R >> endobj\n"
+      "4 0 obj <</Type/Page/Parent 2 0 R>> endobj\n"
+      "5 0 obj << /Type\r\n/Page>> endobj\n"
+      "6 0 obj << /Type /PageLabel >> endobj\n"
+      "7 0 obj << /Subtype /Page >> endobj\n"
+      "trailer << /Root 1 0 R >>\n"
+      "%%EOF /Type /Page";
+  for (size_t piece : {1, 2, 3, 7, 64, 4096}) {
+    EXPECT_EQ(CountPages(pdf, piece), 4) << piece;
+  }
+}
+
+TEST(FileIngestTest, FitsThumbnails) {
+  int32_t width;
+  int32_t height;
+  FitThumbnail(4032, 3024, 120, &width, &height);
+  EXPECT_EQ(width, 120);
+  EXPECT_EQ(height, 90);
+  FitThumbnail(1080, 1920, 120, &width, &height);
+  EXPECT_EQ(width, 68);
+  EXPECT_EQ(height, 120);
+  // Never enlarged, never zero.
+  FitThumbnail(64, 48, 120, &width, &height);
+  EXPECT_EQ(width, 64);
+  EXPECT_EQ(height, 48);
+  FitThumbnail(100000, 2, 120, &width, &height);
+  EXPECT_EQ(width, 120);
+  EXPECT_EQ(height, 1);
+  FitThumbnail(0, 10, 120, &width, &height);
+  EXPECT_EQ(width, 0);
+  EXPECT_EQ(height, 0);
+}
+
+class FileIngestFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_FALSE(temp_.path().empty());
+    root_ = temp_.path();
+  }
+
+  std::string Write(const std::string& name,
+                    const std::vector<uint8_t>& data) {
+    const std::string path = root_ + "/" + name;
+    std::ofstream(path, std::ios::binary)
+        .write(reinterpret_cast<const char*>(data.data()), data.size());
+    return path;
+  }
+
+  TempDir temp_{"file_ingest_test"};
+  std::string root_;
+};
+
+TEST_F(FileIngestFileTest, IngestsAnImage) {
+  // Larger than one read block, so the hash spans several.
+  std::vector<uint8_t> png = Png(4000, 3000);
+  png.resize(700 * 1024);
+  for (size_t i = 33; i < png.size(); i++) {
+    png[i] = static_cast<uint8_t>(i * 31);
+  }
+  // Named as something else; the content decides.
+  const std::string path = Write("photo.jpg", png);
+
+  IngestResult result;
+  IngestFile(path, IngestLimits(), nullptr, &result);
+  EXPECT_EQ(result.status, IngestStatus::kOk);
+  EXPECT_EQ(result.kind, IngestKind::kPng);
+  EXPECT_EQ(result.size, png.size());
+  EXPECT_EQ(result.width, 4000);
+  EXPECT_EQ(result.height, 3000);
+  EXPECT_EQ(result.thumbnail_width, 120);
+  EXPECT_EQ(result.thumbnail_height, 90);
+  EXPECT_EQ(Hex(result.sha256), HashOf(png));
+}
+
+TEST_F(FileIngestFileTest, IngestsAPdf) {
+  std::string pdf = "%PDF-1.7\n";
+  for (int i = 0; i < 40; i++) {
+    pdf += "<< /Type /Page >>\nstream\n" + std::string(10000, 'x') +
+           "\nendstream\n";
+  }
+  IngestResult result;
+  IngestFile(Write("plans.pdf", Bytes(pdf)), IngestLimits(), nullptr,
+             &result);
+  EXPECT_EQ(result.status, IngestStatus::kOk);
+  EXPECT_EQ(result.kind, IngestKind::kPdf);
+  EXPECT_EQ(result.pages, 40);
+  EXPECT_EQ(result.thumbnail_width, 0);
+  EXPECT_EQ(Hex(result.sha256), HashOf(Bytes(pdf)));
+}
+
+TEST_F(FileIngestFileTest, AppliesTheLimitForTheKind) {
+  IngestLimits limits;
+  limits.max_image_bytes = 1000;
+  limits.max_file_bytes = 2000;
+  std::vector<uint8_t> png = Png(10, 10);
+  png.resize(1500);
+  std::vector<uint8_t> text(1500, 'a');
+
+  IngestResult result;
+  IngestFile(Write("big.png", png), limits, nullptr, &result);
+  EXPECT_EQ(result.status, IngestStatus::kTooLarge);
+  EXPECT_EQ(result.kind, IngestKind::kPng);
+  EXPECT_EQ(result.size, 1500u);
+  IngestFile(Write("notes.txt", text), limits, nullptr, &result);
+  EXPECT_EQ(result.status, IngestStatus::kOk);
+  EXPECT_EQ(result.kind, IngestKind::kText);
+}
+
+TEST_F(FileIngestFileTest, ReportsMissingAndDirectories) {
+  IngestResult result;
+  IngestFile(root_ + "/missing.png", IngestLimits(), nullptr, &result);
+  EXPECT_EQ(result.status, IngestStatus::kMissing);
+  IngestFile(root_, IngestLimits(), nullptr, &result);
+  EXPECT_EQ(result.status, IngestStatus::kNotAFile);
+  // Empty files are fine, and text.
+  IngestFile(Write("empty", {}), IngestLimits(), nullptr, &result);
+  EXPECT_EQ(result.status, IngestStatus::kOk);
+  EXPECT_EQ(result.kind, IngestKind::kText);
+  EXPECT_EQ(Hex(result.sha256), HashOf({}));
+}
+
+TEST_F(FileIngestFileTest, StopsWhenCancelled) {
+  TaskState state;
+  state.cancel_requested = true;
+  CancellationToken token(&state);
+  IngestResult result;
+  IngestFile(Write("a.txt", Bytes("hello")), IngestLimits(), &token, &result);
+  EXPECT_EQ(result.status, IngestStatus::kCancelled);
+}
+
+TEST_F(FileIngestFileTest, JobReportsEveryFile) {
+  std::vector<std::string> paths;
+  for (int i = 0; i < 24; i++) {
+    paths.push_back(Write("file" + std::to_string(i),
+                          Png(100 + i, 50 + i)));
+  }
+  paths.push_back(root_ + "/missing");
+
+  std::mutex mutex;
+  std::vector<int> seen(paths.size());
+  std::vector<IngestResult> results(paths.size());
+  std::atomic<int> done{0};
+  auto job = IngestJob::Start(
+      paths, IngestLimits(),
+      [&](size_t index, const IngestResult& result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        seen[index]++;
+        results[index] = result;
+      },
+      [&] { done++; });
+  job->Wait();
+  EXPECT_EQ(done.load(), 1);
+  EXPECT_EQ(job->size(), paths.size());
+  for (size_t i = 0; i + 1 < paths.size(); i++) {
+    EXPECT_EQ(seen[i], 1) << i;
+    EXPECT_EQ(results[i].width, static_cast<int32_t>(100 + i));
+  }
+  EXPECT_EQ(results.back().status, IngestStatus::kMissing);
+}
+
+TEST_F(FileIngestFileTest, NothingIsReportedAfterCancel) {
+  // One worker, blocked, so every file is still queued.
+  ThreadPoolOptions options;
+  options.interactive_threads = 1;
+  options.background_threads = 1;
+  ThreadPool pool(options);
+  std::atomic<bool> release{false};
+  pool.Submit(TaskPriority::kBackground, [&](const CancellationToken&) {
+    while (!release.load()) {
+      std::this_thread::yield();
+    }
+  });
+
+  std::vector<std::string> paths(50, Write("a.txt", Bytes("hello")));
+  std::atomic<int> reported{0};
+  std::atomic<int> done{0};
+  auto job = IngestJob::Start(
+      paths, IngestLimits(),
+      [&](size_t, const IngestResult&) { reported++; }, [&] { done++; },
+      &pool);
+  job->Cancel();
+  release = true;
+  job->Wait();
+  EXPECT_EQ(reported.load(), 0);
+  EXPECT_EQ(done.load(), 0);
+}
+
+TEST(FileIngestJobTest, EmptyDropFinishesAtOnce) {
+  int done = 0;
+  auto job = IngestJob::Start({}, IngestLimits(), nullptr, [&] { done++; });
+  job->Wait();
+  EXPECT_EQ(done, 1);
+}
+
+}  // namespace
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "diagnostics/hdr_histogram.h"
+
+namespace {
+
+// The value at |percentile| of |sorted| by the rank the histogram uses.
+uint64_t ExactPercentile(const std::vector<uint64_t>& sorted,
+                         double percentile) {
+  uint64_t target =
+      static_cast<uint64_t>(percentile / 100.0 * sorted.size() + 0.5);
+  return sorted[std::max<uint64_t>(target, 1) - 1];
+}
+
+TEST(HdrHistogramTest, EmptyHistogramReportsZero) {
+  HdrHistogram histogram;
+  EXPECT_EQ(histogram.count(), 0u);
+  EXPECT_EQ(histogram.max(), 0u);
+  EXPECT_EQ(histogram.Mean(), 0.0);
+  EXPECT_EQ(histogram.ValueAtPercentile(50), 0u);
+}
+
+TEST(HdrHistogramTest, SmallValuesAreExact) {
+  HdrHistogram histogram;
+  for (uint64_t value = 0; value < 128; value++) {
+    histogram.Record(value);
+  }
+  for (uint64_t rank = 1; rank <= 128; rank++) {
+    EXPECT_EQ(histogram.ValueAtPercentile(rank * 100.0 / 128), rank - 1);
+  }
+  EXPECT_EQ(histogram.ValueAtPercentile(0), 0u);
+  EXPECT_EQ(histogram.max(), 127u);
+  EXPECT_DOUBLE_EQ(histogram.Mean(), 63.5);
+}
+
+TEST(HdrHistogramTest, PercentilesAreWithinOneSixtyFourth) {
+  // Latencies in microseconds spread over several orders of magnitude.
+  std::mt19937_64 random(42);
+  std::lognormal_distribution<double> latency(std::log(5000.0), 1.5);
+  HdrHistogram histogram;
+  std::vector<uint64_t> values;
+  uint64_t sum = 0;
+  for (int i = 0; i < 100000; i++) {
+    const uint64_t value = static_cast<uint64_t>(latency(random));
+    values.push_back(value);
+    sum += value;
+    histogram.Record(value);
+  }
+  std::sort(values.begin(), values.end());
+
+  EXPECT_EQ(histogram.count(), values.size());
+  EXPECT_EQ(histogram.max(), values.back());
+  EXPECT_DOUBLE_EQ(histogram.Mean(), static_cast<double>(sum) / values.size());
+  for (double percentile :
+       {0.1, 1.0, 10.0, 25.0, 50.0, 75.0, 90.0, 99.0, 99.9, 99.99, 100.0}) {
+    const uint64_t exact = ExactPercentile(values, percentile);
+    const uint64_t reported = histogram.ValueAtPercentile(percentile);
+    // The highest value sharing the exact value's sub-bucket.
+    EXPECT_GE(reported, exact) << "p" << percentile;
+    EXPECT_LE(reported, exact + exact / 64) << "p" << percentile;
+  }
+  EXPECT_EQ(histogram.ValueAtPercentile(100), values.back());
+}
+
+TEST(HdrHistogramTest, SubBucketBoundaries) {
+  // Each power-of-two range splits into 64 sub-buckets.
+  for (uint64_t low : {uint64_t{128}, uint64_t{1} << 20, uint64_t{1} << 35}) {
+    const uint64_t width = low / 64;
+    HdrHistogram histogram;
+    histogram.Record(low);
+    histogram.Record(low + width - 1);
+    histogram.Record(low + width);
+    histogram.Record(low + 10 * width);
+    EXPECT_EQ(histogram.ValueAtPercentile(25), low + width - 1) << low;
+    EXPECT_EQ(histogram.ValueAtPercentile(50), low + width - 1) << low;
+    EXPECT_EQ(histogram.ValueAtPercentile(75), low + 2 * width - 1) << low;
+    // Never above the largest value recorded.
+    EXPECT_EQ(histogram.ValueAtPercentile(100), low + 10 * width) << low;
+  }
+}
+
+TEST(HdrHistogramTest, ClampsValuesAboveHighestTrackable) {
+  HdrHistogram histogram(1000000);
+  histogram.Record(10);
+  histogram.Record(UINT64_MAX);
+  histogram.Record(5000000);
+  EXPECT_EQ(histogram.count(), 3u);
+  EXPECT_EQ(histogram.max(), 1000000u);
+  EXPECT_EQ(histogram.ValueAtPercentile(100), 1000000u);
+  EXPECT_DOUBLE_EQ(histogram.Mean(), (10 + 2 * 1000000) / 3.0);
+}
+
+TEST(HdrHistogramTest, ResetForgetsEverything) {
+  HdrHistogram histogram;
+  for (uint64_t value = 1; value <= 1000; value++) {
+    histogram.Record(value * 1000);
+  }
+  histogram.Reset();
+  EXPECT_EQ(histogram.count(), 0u);
+  EXPECT_EQ(histogram.max(), 0u);
+  EXPECT_EQ(histogram.ValueAtPercentile(99), 0u);
+  histogram.Record(7);
+  EXPECT_EQ(histogram.ValueAtPercentile(50), 7u);
+  EXPECT_DOUBLE_EQ(histogram.Mean(), 7.0);
+}
+
+}  // namespace
@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logging/log_query.h"
+#include "logging/logger.h"
+#include "tests/temp_dir.h"
+
+namespace {
+
+constexpr int kBatches = 3;
+constexpr int kPerBatch = 200;
+
+class LogQueryTest : public ::testing::Test {
+ protected:
+  // Writes three batches a few milliseconds apart through the real logger.
+  // Small segments leave most of them archived and indexed, with the tail
+  // of the last batch in current.sslog.
+  static void SetUpTestSuite() {
+    directory_ = new TempDir("log_query_test");
+    ASSERT_FALSE(directory_->path().empty());
+
+    LoggerConfig config;
+    config.directory = directory_->path();
+    config.min_level = LogLevel::kTrace;
+    config.rotation.max_segment_bytes = 2048;
+    config.rotation.max_archived_segments = 1000;
+    ASSERT_TRUE(Logger::Get().Open(config));
+    for (int batch = 0; batch < kBatches; batch++) {
+      for (int i = 0; i < kPerBatch; i++) {
+        SS_LOG(LogLevel::kDebug, "sync", "pull {} of batch {}", i, batch);
+        if (i % 10 == 0) {
+          SS_LOG(LogLevel::kWarning, "export", "slow write {} in batch {}", i,
+                 batch);
+        }
+        if (i % 50 == 0) {
+          SS_LOG(LogLevel::kError, "update", "retry {} in batch {}", i,
+                 batch);
+        }
+      }
+      Logger::Get().Flush();
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    const LoggerStats stats = Logger::Get().stats();
+    Logger::Get().Close();
+    ASSERT_EQ(stats.records_dropped, 0u);
+    ASSERT_GT(stats.segments_rotated, 3u * kBatches);
+  }
+
+  static void TearDownTestSuite() {
+    delete directory_;
+    directory_ = nullptr;
+  }
+
+  static std::vector<LogEntry> Run(const LogQuery& query,
+                                   LogQueryStats* stats = nullptr) {
+    LogQueryCursor cursor(directory_->path(), query);
+    std::vector<LogEntry> entries;
+    LogEntry entry;
+    while (cursor.Next(&entry)) {
+      entries.push_back(entry);
+    }
+    if (stats != nullptr) {
+      *stats = cursor.stats();
+    }
+    return entries;
+  }
+
+  static TempDir* directory_;
+};
+
+TempDir* LogQueryTest::directory_ = nullptr;
+
+TEST_F(LogQueryTest, ReturnsEveryRecordOldestFirst) {
+  std::vector<std::string> expected;
+  for (int batch = 0; batch < kBatches; batch++) {
+    for (int i = 0; i < kPerBatch; i++) {
+      const std::string suffix = " of batch " + std::to_string(batch);
+      expected.push_back("pull " + std::to_string(i) + suffix);
+      if (i % 10 == 0) {
+        expected.push_back("slow write " + std::to_string(i) + " in batch " +
+                           std::to_string(batch));
+      }
+      if (i % 50 == 0) {
+        expected.push_back("retry " + std::to_string(i) + " in batch " +
+                           std::to_string(batch));
+      }
+    }
+  }
+
+  LogQueryStats stats;
+  const std::vector<LogEntry> entries = Run(LogQuery(), &stats);
+  std::vector<std::string> messages;
+  for (size_t i = 0; i < entries.size(); i++) {
+    messages.push_back(entries[i].message);
+    if (i > 0) {
+      EXPECT_LE(entries[i - 1].timestamp_us, entries[i].timestamp_us);
+    }
+  }
+  EXPECT_EQ(messages, expected);
+  EXPECT_GT(stats.segments, 3u * kBatches);
+  EXPECT_EQ(stats.segments_skipped, 0u);
+  EXPECT_EQ(stats.records_matched, expected.size());
+}
+
+TEST_F(LogQueryTest, FiltersByMinimumLevel) {
+  LogQuery query;
+  query.min_level = LogLevel::kWarning;
+  std::vector<LogEntry> entries = Run(query);
+  EXPECT_EQ(entries.size(), kBatches * (kPerBatch / 10 + kPerBatch / 50));
+  for (const LogEntry& entry : entries) {
+    EXPECT_GE(entry.level, LogLevel::kWarning) << entry.message;
+  }
+
+  query.min_level = LogLevel::kError;
+  entries = Run(query);
+  EXPECT_EQ(entries.size(), kBatches * (kPerBatch / 50));
+  for (const LogEntry& entry : entries) {
+    EXPECT_EQ(entry.level, LogLevel::kError) << entry.message;
+    EXPECT_EQ(entry.subsystem, "update");
+  }
+}
+
+TEST_F(LogQueryTest, FiltersBySubsystem) {
+  LogQuery query;
+  query.subsystems = {"export", "update"};
+  std::vector<LogEntry> entries = Run(query);
+  EXPECT_EQ(entries.size(), kBatches * (kPerBatch / 10 + kPerBatch / 50));
+  for (const LogEntry& entry : entries) {
+    EXPECT_NE(entry.subsystem, "sync") << entry.message;
+  }
+
+  // No archive can match, so only the live segment is read.
+  LogQueryStats stats;
+  query.subsystems = {"missing"};
+  EXPECT_TRUE(Run(query, &stats).empty());
+  EXPECT_EQ(stats.segments_skipped, stats.segments - 1);
+  EXPECT_EQ(stats.blocks_inflated, 0u);
+}
+
+TEST_F(LogQueryTest, FiltersByText) {
+  LogQuery query;
+  query.text = "slow write 10 in batch 1";
+  std::vector<LogEntry> entries = Run(query);
+  ASSERT_EQ(entries.size(), 1u);
+  EXPECT_EQ(entries[0].subsystem, "export");
+  EXPECT_EQ(entries[0].level, LogLevel::kWarning);
+
+  query.text = "of batch 2";
+  query.min_level = LogLevel::kWarning;
+  EXPECT_TRUE(Run(query).empty());
+}
+
+TEST_F(LogQueryTest, FiltersByInclusiveTimeRange) {
+  const std::vector<LogEntry> all = Run(LogQuery());
+  ASSERT_FALSE(all.empty());
+  // The middle batch, by the timestamps the logger gave it.
+  std::vector<std::string> middle;
+  LogQuery query;
+  query.from_us = UINT64_MAX;
+  query.to_us = 0;
+  for (const LogEntry& entry : all) {
+    if (entry.message.find("batch 1") != std::string::npos) {
+      middle.push_back(entry.message);
+      query.from_us = std::min(query.from_us, entry.timestamp_us);
+      query.to_us = std::max(query.to_us, entry.timestamp_us);
+    }
+  }
+  ASSERT_EQ(middle.size(), kPerBatch + kPerBatch / 10 + kPerBatch / 50);
+
+  LogQueryStats stats;
+  std::vector<std::string> messages;
+  for (const LogEntry& entry : Run(query, &stats)) {
+    EXPECT_GE(entry.timestamp_us, query.from_us);
+    EXPECT_LE(entry.timestamp_us, query.to_us);
+    messages.push_back(entry.message);
+  }
+  EXPECT_EQ(messages, middle);
+  // Archives holding only the first or last batch are ruled out by their
+  // index.
+  EXPECT_GT(stats.segments_skipped, 0u);
+
+  // A range of one microsecond still matches the records stamped with it.
+  query.from_us = query.to_us = all.back().timestamp_us;
+  const std::vector<LogEntry> last = Run(query);
+  ASSERT_FALSE(last.empty());
+  EXPECT_EQ(last.back().message, all.back().message);
+
+  query.from_us = all.back().timestamp_us + 1;
+  query.to_us = UINT64_MAX;
+  EXPECT_TRUE(Run(query).empty());
+}
+
+}  // namespace
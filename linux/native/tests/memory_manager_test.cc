@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#include "memory/memory_manager.h"
+#include "memory/process_memory.h"
+#include "stream/record_ring.h"
+#include "tracing/tracer.h"
+
+namespace {
+
+constexpr char kStatus[] =
+    "Name:\tsilver_stone\n"
+    "VmPeak:\t 2100000 kB\n"
+    "VmRSS:\t  412000 kB\n"
+    "RssAnon:\t  300000 kB\n"
+    "RssFile:\t  110000 kB\n"
+    "RssShmem:\t    2000 kB\n"
+    "VmSwap:\t    1024 kB\n";
+
+constexpr char kPressure[] =
+    "some avg10=12.50 avg60=3.25 avg300=0.80 total=9876543\n"
+    "full avg10=4.00 avg60=1.00 avg300=0.20 total=123456\n";
+
+TEST(ProcessMemoryTest, ParsesProcessStatus) {
+  ProcessMemory memory;
+  ASSERT_TRUE(ParseProcessStatus(kStatus, &memory));
+  EXPECT_EQ(memory.rss_bytes, 412000u * 1024);
+  EXPECT_EQ(memory.anon_bytes, 300000u * 1024);
+  EXPECT_EQ(memory.file_bytes, 110000u * 1024);
+  EXPECT_EQ(memory.swap_bytes, 1024u * 1024);
+  EXPECT_FALSE(ParseProcessStatus("Name:\tx\n", &memory));
+}
+
+TEST(ProcessMemoryTest, ParsesPressure) {
+  MemoryPressure pressure;
+  ASSERT_TRUE(ParseMemoryPressure(kPressure, &pressure));
+  EXPECT_DOUBLE_EQ(pressure.some.avg10, 12.5);
+  EXPECT_DOUBLE_EQ(pressure.some.avg60, 3.25);
+  EXPECT_EQ(pressure.some.total_us, 9876543u);
+  EXPECT_DOUBLE_EQ(pressure.full.avg10, 4.0);
+  EXPECT_FALSE(ParseMemoryPressure("", &pressure));
+}
+
+TEST(ProcessMemoryTest, ParsesCgroupPathAndLimits) {
+  std::string path;
+  EXPECT_TRUE(ParseCgroupPath(
+      "0::/user.slice/user-1000.slice/app-silver_stone.scope\n", &path));
+  EXPECT_EQ(path, "/user.slice/user-1000.slice/app-silver_stone.scope");
+  // cgroup v1 only.
+  EXPECT_FALSE(ParseCgroupPath("4:memory:/user.slice\n", &path));
+
+  uint64_t bytes = 1;
+  EXPECT_TRUE(ParseCgroupLimit("max\n", &bytes));
+  EXPECT_EQ(bytes, 0u);
+  EXPECT_TRUE(ParseCgroupLimit("536870912\n", &bytes));
+  EXPECT_EQ(bytes, 536870912u);
+  EXPECT_FALSE(ParseCgroupLimit("", &bytes));
+
+  CgroupMemory cgroup;
+  cgroup.max_bytes = 800;
+  EXPECT_EQ(cgroup.limit_bytes(), 800u);
+  cgroup.high_bytes = 600;
+  EXPECT_EQ(cgroup.limit_bytes(), 600u);
+  cgroup.max_bytes = 0;
+  EXPECT_EQ(cgroup.limit_bytes(), 600u);
+}
+
+TEST(ProcessMemoryTest, ReadsOwnStatus) {
+  ProcessMemory memory;
+  ASSERT_TRUE(ReadProcessMemory(&memory));
+  EXPECT_GT(memory.rss_bytes, 0u);
+}
+
+TEST(ProcessMemoryTest, ReleasesOnlyWholePagesAndZeroesThem) {
+  const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  void* mapping = mmap(nullptr, page * 4, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  ASSERT_NE(mapping, MAP_FAILED);
+  uint8_t* bytes = static_cast<uint8_t*>(mapping);
+  std::memset(bytes, 0xab, page * 4);
+
+  // Starts one byte into the first page, so only pages 1 and 2 go.
+  EXPECT_EQ(ReleasePages(bytes + 1, page * 3), page * 2);
+  EXPECT_EQ(bytes[page - 1], 0xab);
+  EXPECT_EQ(bytes[page], 0);
+  EXPECT_EQ(bytes[page * 3 - 1], 0);
+  EXPECT_EQ(bytes[page * 3], 0xab);
+  EXPECT_EQ(ReleasePages(bytes + 1, page / 2), 0u);
+  munmap(mapping, page * 4);
+}
+
+MemoryPolicyOptions TestOptions() {
+  MemoryPolicyOptions options;
+  options.background_grace_ms = 1000;
+  options.pressure_cooldown_ms = 5000;
+  options.pressure_some_avg10 = 10;
+  options.cgroup_usage_ratio = 0.9;
+  return options;
+}
+
+TEST(MemoryPolicyTest, TrimsOnceAfterTheBackgroundGrace) {
+  MemoryPolicy policy(TestOptions());
+  const MemorySample quiet;
+  EXPECT_EQ(policy.Evaluate(quiet, 0), TrimReason::kNone);
+
+  policy.SetBackground(true, 100);
+  EXPECT_EQ(policy.Evaluate(quiet, 900), TrimReason::kNone);
+  EXPECT_EQ(policy.Evaluate(quiet, 1100), TrimReason::kBackground);
+  EXPECT_EQ(policy.Evaluate(quiet, 60000), TrimReason::kNone);
+
+  // A quick trip to the foreground and back starts the grace again.
+  policy.SetBackground(false, 61000);
+  policy.SetBackground(true, 61500);
+  EXPECT_EQ(policy.Evaluate(quiet, 62000), TrimReason::kNone);
+  EXPECT_EQ(policy.Evaluate(quiet, 62500), TrimReason::kBackground);
+}
+
+TEST(MemoryPolicyTest, ForegroundNeverTrimsWithoutPressure) {
+  MemoryPolicy policy(TestOptions());
+  policy.SetBackground(true, 0);
+  policy.SetBackground(false, 500);
+  EXPECT_EQ(policy.Evaluate(MemorySample(), 10000), TrimReason::kNone);
+}
+
+TEST(MemoryPolicyTest, PressureTrimsAtMostOncePerCooldown) {
+  MemoryPolicy policy(TestOptions());
+  MemorySample stalled;
+  stalled.has_pressure = true;
+  stalled.pressure.some.avg10 = 25;
+  EXPECT_EQ(policy.Evaluate(stalled, 0), TrimReason::kPressure);
+  EXPECT_EQ(policy.Evaluate(stalled, 4000), TrimReason::kNone);
+  EXPECT_EQ(policy.Evaluate(stalled, 5000), TrimReason::kPressure);
+
+  stalled.pressure.some.avg10 = 5;
+  EXPECT_EQ(policy.Evaluate(stalled, 20000), TrimReason::kNone);
+}
+
+TEST(MemoryPolicyTest, TrimsNearTheCgroupLimit) {
+  MemoryPolicy policy(TestOptions());
+  MemorySample sample;
+  sample.has_cgroup = true;
+  sample.cgroup.current_bytes = 850;
+  sample.cgroup.max_bytes = 1000;
+  EXPECT_EQ(policy.Evaluate(sample, 0), TrimReason::kNone);
+  sample.cgroup.current_bytes = 950;
+  EXPECT_EQ(policy.Evaluate(sample, 0), TrimReason::kCgroupLimit);
+  // No limit at all.
+  sample.cgroup.max_bytes = 0;
+  EXPECT_EQ(policy.Evaluate(sample, 10000), TrimReason::kNone);
+}
+
+TEST(MemoryPolicyTest, PressureTrimInTheBackgroundCoversTheBackgroundOne) {
+  MemoryPolicy policy(TestOptions());
+  MemorySample stalled;
+  stalled.has_pressure = true;
+  stalled.pressure.some.avg10 = 25;
+  policy.SetBackground(true, 0);
+  EXPECT_EQ(policy.Evaluate(stalled, 200), TrimReason::kPressure);
+  EXPECT_EQ(policy.Evaluate(MemorySample(), 2000), TrimReason::kNone);
+}
+
+TEST(MemoryManagerTest, KeepsTraceBuffersUntilCollected) {
+  Tracer& tracer = Tracer::Get();
+  const uint32_t category = Tracer::Intern("test");
+  const uint32_t name = Tracer::Intern("event");
+  tracer.Start();
+  std::thread([&] {
+    for (int i = 0; i < 20000; i++) {
+      tracer.Instant(category, name);
+    }
+  }).join();
+  tracer.Stop();
+
+  // Stopped but not written yet.
+  EXPECT_EQ(tracer.ReleaseMemory(), 0u);
+  TraceStats stats;
+  tracer.Collect(&stats);
+  EXPECT_GT(stats.events, 0u);
+  EXPECT_GT(tracer.ReleaseMemory(), 0u);
+  tracer.Collect(&stats);
+  EXPECT_EQ(stats.events, 0u);
+}
+
+TEST(MemoryManagerTest, ReleasesOnlyDetachedRings) {
+  struct Record {
+    uint64_t value[64];
+  };
+  RecordRing ring(sizeof(Record), 1024);
+  ASSERT_TRUE(ring.Attach(nullptr, nullptr));
+  ASSERT_TRUE(ring.Push(Record{{1}}));
+  EXPECT_EQ(ring.ReleaseMemory(), 0u);
+  ring.Detach();
+  EXPECT_GT(ring.ReleaseMemory(), 0u);
+
+  // Still usable afterwards.
+  ASSERT_TRUE(ring.Attach(nullptr, nullptr));
+  ASSERT_TRUE(ring.Push(Record{{7}}));
+  uint64_t first;
+  ASSERT_EQ(ring.Acquire(&first), 1u);
+  EXPECT_EQ(reinterpret_cast<const Record*>(ring.RecordAt(first))->value[0],
+            7u);
+  ring.Detach();
+}
+
+TEST(MemoryManagerTest, ReportsTheLastTrim) {
+  MemoryManager manager(TestOptions());
+  MemoryTrimReport report;
+  EXPECT_FALSE(manager.LastTrim(&report));
+  manager.Trim(TrimReason::kBackground, &report);
+  EXPECT_GT(report.rss_before_bytes, 0u);
+  EXPECT_GT(report.rss_after_bytes, 0u);
+  MemoryTrimReport last;
+  ASSERT_TRUE(manager.LastTrim(&last));
+  EXPECT_EQ(last.reason, TrimReason::kBackground);
+  EXPECT_EQ(last.rss_after_bytes, report.rss_after_bytes);
+}
+
+}  // namespace
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "runner/monitor_topology.h"
+
+namespace {
+
+// A 1920x1080 laptop panel with a 32 px top bar, and a 2560x1440 monitor
+// to its right, marked primary, with a 48 px dock along its bottom.
+std::vector<MonitorInfo> TwoMonitors() {
+  MonitorInfo laptop;
+  laptop.geometry = {0, 0, 1920, 1080};
+  laptop.workarea = {0, 32, 1920, 1080};
+  laptop.model = "eDP-1";
+  MonitorInfo external;
+  external.geometry = {1920, 0, 4480, 1440};
+  external.workarea = {1920, 0, 4480, 1392};
+  external.scale_factor = 2;
+  external.primary = true;
+  external.model = "DP-2";
+  return {laptop, external};
+}
+
+TEST(MonitorTopologyTest, UpdateReportsOnlyChanges) {
+  MonitorTopology topology;
+  EXPECT_EQ(topology.generation(), 0u);
+  EXPECT_TRUE(topology.Update(TwoMonitors()));
+  EXPECT_EQ(topology.generation(), 1u);
+  // The same layout again, as a workarea signal with nothing moved sends.
+  EXPECT_FALSE(topology.Update(TwoMonitors()));
+  EXPECT_EQ(topology.generation(), 1u);
+
+  std::vector<MonitorInfo> monitors = TwoMonitors();
+  monitors[1].scale_factor = 1;
+  EXPECT_TRUE(topology.Update(monitors));
+  EXPECT_EQ(topology.generation(), 2u);
+  monitors.pop_back();
+  EXPECT_TRUE(topology.Update(monitors));
+  EXPECT_EQ(topology.monitors().size(), 1u);
+}
+
+TEST(MonitorTopologyTest, PrimaryFallsBackToTheFirst) {
+  MonitorTopology topology;
+  EXPECT_EQ(topology.Primary(), nullptr);
+  topology.Update(TwoMonitors());
+  EXPECT_EQ(topology.Primary()->model, "DP-2");
+
+  std::vector<MonitorInfo> monitors = TwoMonitors();
+  monitors[1].primary = false;
+  topology.Update(monitors);
+  EXPECT_EQ(topology.Primary()->model, "eDP-1");
+}
+
+TEST(MonitorTopologyTest, MonitorForPicksTheLargestOverlap) {
+  MonitorTopology topology;
+  EXPECT_EQ(topology.MonitorFor({0, 0, 10, 10}), nullptr);
+  topology.Update(TwoMonitors());
+  EXPECT_EQ(topology.MonitorFor({100, 100, 380, 180})->model, "eDP-1");
+  // Straddling the boundary, mostly on the right.
+  EXPECT_EQ(topology.MonitorFor({1900, 100, 2180, 180})->model, "DP-2");
+  EXPECT_EQ(topology.MonitorFor({1700, 100, 1980, 180})->model, "eDP-1");
+  // Off both: below the laptop panel, which ends higher than the external.
+  EXPECT_EQ(topology.MonitorFor({100, 1200, 380, 1280})->model, "eDP-1");
+  EXPECT_EQ(topology.MonitorFor({5000, 100, 5280, 180})->model, "DP-2");
+}
+
+TEST(MonitorTopologyTest, ClampKeepsTheRectInTheWorkArea) {
+  MonitorTopology topology;
+  const ScreenRect rect = {-50, 10, 230, 90};
+  EXPECT_EQ(topology.Clamp(rect).left, -50);
+  topology.Update(TwoMonitors());
+
+  // Under the top bar and off the left edge.
+  ScreenRect clamped = topology.Clamp(rect);
+  EXPECT_EQ(clamped.left, 0);
+  EXPECT_EQ(clamped.top, 32);
+  EXPECT_EQ(clamped.right, 280);
+  EXPECT_EQ(clamped.bottom, 112);
+
+  // Into the dock on the external monitor.
+  clamped = topology.Clamp({3000, 1380, 3280, 1460});
+  EXPECT_EQ(clamped.left, 3000);
+  EXPECT_EQ(clamped.top, 1312);
+  EXPECT_EQ(clamped.bottom, 1392);
+
+  // Taller than the work area: pinned to its top.
+  clamped = topology.Clamp({100, 500, 380, 2000});
+  EXPECT_EQ(clamped.top, 32);
+  EXPECT_EQ(clamped.bottom, 1532);
+}
+
+TEST(MonitorTopologyTest, SnapToRightEdgeStaysOnTheSameMonitor) {
+  MonitorTopology topology;
+  topology.Update(TwoMonitors());
+
+  ScreenRect snapped = topology.SnapToRightEdge({500, 400, 780, 480});
+  EXPECT_EQ(snapped.left, 1640);
+  EXPECT_EQ(snapped.right, 1920);
+  EXPECT_EQ(snapped.top, 400);
+
+  snapped = topology.SnapToRightEdge({3000, -40, 3280, 40});
+  EXPECT_EQ(snapped.left, 4200);
+  EXPECT_EQ(snapped.right, 4480);
+  EXPECT_EQ(snapped.top, 0);
+}
+
+}  // namespace
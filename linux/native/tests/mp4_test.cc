@@ -0,0 +1,368 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "media/mp4_faststart.h"
+#include "media/mp4_file.h"
+#include "media/mp4_inspector.h"
+#include "tests/temp_dir.h"
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+void PutU16(uint16_t value, Bytes* out) {
+  out->push_back(static_cast<uint8_t>(value >> 8));
+  out->push_back(static_cast<uint8_t>(value));
+}
+
+void PutU32(uint32_t value, Bytes* out) {
+  PutU16(static_cast<uint16_t>(value >> 16), out);
+  PutU16(static_cast<uint16_t>(value), out);
+}
+
+void PutU64(uint64_t value, Bytes* out) {
+  PutU32(static_cast<uint32_t>(value >> 32), out);
+  PutU32(static_cast<uint32_t>(value), out);
+}
+
+Bytes Box(const char (&type)[5], const Bytes& payload) {
+  Bytes box;
+  PutU32(static_cast<uint32_t>(8 + payload.size()), &box);
+  PutU32(Mp4Type(type), &box);
+  box.insert(box.end(), payload.begin(), payload.end());
+  return box;
+}
+
+Bytes Concat(const std::vector<Bytes>& parts) {
+  Bytes all;
+  for (const Bytes& part : parts) {
+    all.insert(all.end(), part.begin(), part.end());
+  }
+  return all;
+}
+
+constexpr int kChunks = 4;
+constexpr int kChunkBytes = 100;
+constexpr int kSamplesPerChunk = 5;
+
+// An AAC recording as the recorders write it: ftyp, free, mdat, then moov
+// with one sound track whose chunks fill the mdat. Two seconds and a half
+// at 44.1 kHz.
+struct TestFile {
+  bool moov_first = false;
+  bool wide_offsets = false;
+
+  Bytes Build() const {
+    Bytes media;
+    for (int i = 0; i < kChunks * kChunkBytes; ++i) {
+      media.push_back(static_cast<uint8_t>(i * 7 + i / kChunkBytes));
+    }
+    Bytes ftyp = Box("ftyp", {'M', '4', 'A', ' ', 0, 0, 0, 0, 'M', '4', 'A',
+                              ' ', 'i', 's', 'o', 'm'});
+    Bytes free = Box("free", Bytes(12, 0));
+    Bytes mdat = Box("mdat", media);
+    // The moov size does not depend on the offsets in it.
+    const uint64_t moov_size = Moov(0).size();
+    const uint64_t media_offset = ftyp.size() + free.size() + 8 +
+                                  (moov_first ? moov_size : 0);
+    Bytes moov = Moov(media_offset);
+    return moov_first ? Concat({ftyp, free, moov, mdat})
+                      : Concat({ftyp, free, mdat, moov});
+  }
+
+  Bytes Moov(uint64_t media_offset) const {
+    Bytes mvhd = {0, 0, 0, 0};
+    PutU32(0, &mvhd);  // Creation.
+    PutU32(0, &mvhd);  // Modification.
+    PutU32(1000, &mvhd);
+    PutU32(2500, &mvhd);
+    mvhd.resize(100);
+
+    Bytes tkhd = {0, 0, 0, 7};
+    PutU32(0, &tkhd);
+    PutU32(0, &tkhd);
+    PutU32(1, &tkhd);  // Track ID.
+    tkhd.resize(84);
+
+    Bytes mdhd = {0, 0, 0, 0};
+    PutU32(0, &mdhd);
+    PutU32(0, &mdhd);
+    PutU32(44100, &mdhd);
+    PutU32(110250, &mdhd);
+    PutU32(0x55c40000, &mdhd);  // "und", no predefined.
+
+    Bytes hdlr = {0, 0, 0, 0, 0, 0, 0, 0};
+    PutU32(Mp4Type("soun"), &hdlr);
+    hdlr.resize(hdlr.size() + 13);
+
+    Bytes mp4a = {0, 0, 0, 0, 0, 0};
+    PutU16(1, &mp4a);  // Data reference.
+    PutU64(0, &mp4a);
+    PutU16(2, &mp4a);   // Channels.
+    PutU16(16, &mp4a);  // Sample size.
+    PutU32(0, &mp4a);
+    PutU32(44100u << 16, &mp4a);
+    Bytes stsd = {0, 0, 0, 0};
+    PutU32(1, &stsd);
+    const Bytes entry = Box("mp4a", mp4a);
+    stsd.insert(stsd.end(), entry.begin(), entry.end());
+
+    Bytes stsz = {0, 0, 0, 0};
+    PutU32(0, &stsz);
+    PutU32(kChunks * kSamplesPerChunk, &stsz);
+    for (int i = 0; i < kChunks * kSamplesPerChunk; ++i) {
+      PutU32(kChunkBytes / kSamplesPerChunk, &stsz);
+    }
+    Bytes stsc = {0, 0, 0, 0};
+    PutU32(1, &stsc);
+    PutU32(1, &stsc);
+    PutU32(kSamplesPerChunk, &stsc);
+    PutU32(1, &stsc);
+    Bytes stco = {0, 0, 0, 0};
+    PutU32(kChunks, &stco);
+    for (int i = 0; i < kChunks; ++i) {
+      if (wide_offsets) {
+        PutU64(media_offset + i * kChunkBytes, &stco);
+      } else {
+        PutU32(static_cast<uint32_t>(media_offset + i * kChunkBytes), &stco);
+      }
+    }
+
+    Bytes stbl = Box("stbl", Concat({Box("stsd", stsd), Box("stsc", stsc),
+                                     Box("stsz", stsz),
+                                     wide_offsets ? Box("co64", stco)
+                                                  : Box("stco", stco)}));
+    Bytes minf = Box("minf", Concat({Box("smhd", Bytes(8, 0)), stbl}));
+    Bytes mdia =
+        Box("mdia", Concat({Box("mdhd", mdhd), Box("hdlr", hdlr), minf}));
+    Bytes trak = Box("trak", Concat({Box("tkhd", tkhd), mdia}));
+    return Box("moov", Concat({Box("mvhd", mvhd), trak,
+                               Box("udta", Bytes(20, 'u'))}));
+  }
+};
+
+// The chunk offsets of the only track of |file|.
+std::vector<uint64_t> ChunkOffsets(const Bytes& file) {
+  Mp4Box box;
+  box.size = file.size();
+  for (uint32_t type : {Mp4Type("moov"), Mp4Type("trak"), Mp4Type("mdia"),
+                        Mp4Type("minf"), Mp4Type("stbl"), 0u}) {
+    std::vector<Mp4Box> children;
+    EXPECT_TRUE(ReadMp4Children(file.data(), box, &children));
+    for (const Mp4Box& child : children) {
+      if (child.type == type ||
+          (type == 0 && (child.type == Mp4Type("stco") ||
+                         child.type == Mp4Type("co64")))) {
+        box = child;
+        break;
+      }
+    }
+  }
+  const bool wide = box.type == Mp4Type("co64");
+  const uint8_t* entries = file.data() + box.payload_offset() + 8;
+  std::vector<uint64_t> offsets;
+  for (uint32_t i = 0; i < Mp4ReadU32(entries - 4); ++i) {
+    offsets.push_back(wide ? Mp4ReadU64(entries + i * 8)
+                           : Mp4ReadU32(entries + i * 4));
+  }
+  return offsets;
+}
+
+FaststartResult Faststart(const Bytes& input, Bytes* output,
+                          std::string* error) {
+  output->clear();
+  return FaststartMp4(
+      input.data(), input.size(),
+      [output](const uint8_t* bytes, size_t count) {
+        output->insert(output->end(), bytes, bytes + count);
+        return true;
+      },
+      error);
+}
+
+TEST(Mp4InspectorTest, ReadsTheSoundTrack) {
+  const Bytes file = TestFile().Build();
+  Mp4Info info;
+  std::string error;
+  ASSERT_TRUE(InspectMp4(file.data(), file.size(), &info, &error)) << error;
+  EXPECT_EQ(Mp4TypeName(info.major_brand), "M4A ");
+  EXPECT_EQ(info.duration_us, 2500000);
+  EXPECT_FALSE(info.faststart);
+  EXPECT_FALSE(info.fragmented);
+  EXPECT_EQ(info.mdat_bytes, static_cast<uint64_t>(kChunks * kChunkBytes));
+  EXPECT_GT(info.moov_offset, info.mdat_offset);
+  EXPECT_EQ(info.moov_offset + info.moov_size, file.size());
+  ASSERT_EQ(info.tracks.size(), 1u);
+  const Mp4Track& track = info.tracks[0];
+  EXPECT_EQ(track.id, 1u);
+  EXPECT_EQ(track.handler, Mp4Type("soun"));
+  EXPECT_EQ(Mp4TypeName(track.codec), "mp4a");
+  EXPECT_EQ(track.timescale, 44100u);
+  EXPECT_EQ(track.duration_us, 2500000);
+  EXPECT_EQ(track.sample_count,
+            static_cast<uint32_t>(kChunks * kSamplesPerChunk));
+  EXPECT_EQ(track.chunk_count, static_cast<uint32_t>(kChunks));
+  EXPECT_EQ(track.sample_rate, 44100u);
+  EXPECT_EQ(track.channels, 2);
+}
+
+TEST(Mp4InspectorTest, RejectsEveryTruncation) {
+  for (bool moov_first : {false, true}) {
+    TestFile test;
+    test.moov_first = moov_first;
+    const Bytes file = test.Build();
+    Mp4Info info;
+    std::string error;
+    for (size_t size = 0; size < file.size(); ++size) {
+      EXPECT_FALSE(InspectMp4(file.data(), size, &info, &error)) << size;
+    }
+  }
+}
+
+TEST(Mp4InspectorTest, RejectsChunksOutsideTheFile) {
+  Bytes file = TestFile().Build();
+  // The last chunk offset is the last four bytes before the udta box.
+  const size_t last = file.size() - 28 - 4;
+  file[last] = 0x7f;
+  Mp4Info info;
+  std::string error;
+  EXPECT_FALSE(InspectMp4(file.data(), file.size(), &info, &error));
+  EXPECT_EQ(error, "track 1 has a chunk outside the file");
+}
+
+TEST(Mp4FaststartTest, MovesMoovAndItsChunkOffsets) {
+  for (bool wide : {false, true}) {
+    TestFile test;
+    test.wide_offsets = wide;
+    const Bytes input = test.Build();
+    Bytes output;
+    std::string error;
+    ASSERT_EQ(Faststart(input, &output, &error), FaststartResult::kRewritten)
+        << error;
+    ASSERT_EQ(output.size(), input.size());
+
+    Mp4Info info;
+    ASSERT_TRUE(InspectMp4(output.data(), output.size(), &info, &error))
+        << error;
+    EXPECT_TRUE(info.faststart);
+    EXPECT_EQ(info.duration_us, 2500000);
+    EXPECT_EQ(Mp4TypeName(info.tracks[0].codec), "mp4a");
+
+    // Every chunk still points at its own bytes.
+    const std::vector<uint64_t> before = ChunkOffsets(input);
+    const std::vector<uint64_t> after = ChunkOffsets(output);
+    ASSERT_EQ(after.size(), static_cast<size_t>(kChunks));
+    for (int i = 0; i < kChunks; ++i) {
+      EXPECT_EQ(after[i], before[i] + info.moov_size);
+      EXPECT_TRUE(std::equal(input.begin() + before[i],
+                             input.begin() + before[i] + kChunkBytes,
+                             output.begin() + after[i]));
+    }
+    // Exactly what the recorder would have written with moov first.
+    test.moov_first = true;
+    EXPECT_EQ(output, test.Build());
+
+    Bytes again;
+    EXPECT_EQ(Faststart(output, &again, &error),
+              FaststartResult::kAlreadyFaststart);
+    EXPECT_TRUE(again.empty());
+  }
+}
+
+TEST(Mp4FaststartTest, RefusesFragmentedFiles) {
+  Bytes file = TestFile().Build();
+  const Bytes moof = Box("moof", Bytes(8, 0));
+  file.insert(file.end(), moof.begin(), moof.end());
+  Bytes output;
+  std::string error;
+  EXPECT_EQ(Faststart(file, &output, &error), FaststartResult::kFailed);
+  EXPECT_EQ(error, "fragmented files are not rewritten");
+  EXPECT_TRUE(output.empty());
+}
+
+// What the fuzzer (fuzz/mp4_fuzzer.cc) checks, over a fixed set of
+// mutations so it runs with the other tests.
+TEST(Mp4FaststartTest, SurvivesCorruptedFiles) {
+  const Bytes original = TestFile().Build();
+  std::mt19937 random(20261018);
+  int rewritten = 0;
+  for (int round = 0; round < 20000; ++round) {
+    Bytes file = original;
+    const int edits = 1 + static_cast<int>(random() % 4);
+    for (int i = 0; i < edits; ++i) {
+      // Mostly in moov, where the structure is.
+      const size_t at = random() % 4 != 0
+                            ? file.size() - 1 - random() % 400
+                            : random() % file.size();
+      file[at] = static_cast<uint8_t>(random() % 4 == 0 ? 0 : random());
+    }
+    if (random() % 8 == 0) {
+      file.resize(random() % file.size());
+    }
+
+    Mp4Info info;
+    std::string error;
+    const bool valid = InspectMp4(file.data(), file.size(), &info, &error);
+    Bytes output;
+    const FaststartResult result = Faststart(file, &output, &error);
+    if (!valid) {
+      EXPECT_EQ(result, FaststartResult::kFailed);
+    }
+    if (result == FaststartResult::kRewritten) {
+      ++rewritten;
+      ASSERT_TRUE(InspectMp4(output.data(), output.size(), &info, &error))
+          << round << ": " << error;
+      EXPECT_TRUE(info.faststart);
+    }
+  }
+  EXPECT_GT(rewritten, 0);
+}
+
+class Mp4FileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_FALSE(temp_.path().empty());
+    root_ = temp_.path();
+  }
+
+  TempDir temp_{"mp4_test"};
+  std::string root_;
+};
+
+TEST_F(Mp4FileTest, RewritesInPlace) {
+  const std::string path = root_ + "/recording.m4a";
+  const Bytes input = TestFile().Build();
+  std::ofstream(path, std::ios::binary)
+      .write(reinterpret_cast<const char*>(input.data()), input.size());
+
+  std::string error;
+  ASSERT_EQ(FaststartMp4File(path, &error), FaststartResult::kRewritten)
+      << error;
+  EXPECT_NE(access((path + ".part").c_str(), F_OK), 0);
+  std::ifstream stream(path, std::ios::binary);
+  const Bytes output{std::istreambuf_iterator<char>(stream),
+                     std::istreambuf_iterator<char>()};
+  TestFile moov_first;
+  moov_first.moov_first = true;
+  EXPECT_EQ(output, moov_first.Build());
+
+  Mp4Info info;
+  ASSERT_TRUE(InspectMp4File(path, &info, &error)) << error;
+  EXPECT_TRUE(info.faststart);
+  EXPECT_EQ(FaststartMp4File(path, &error),
+            FaststartResult::kAlreadyFaststart);
+  EXPECT_NE(access((path + ".part").c_str(), F_OK), 0);
+
+  EXPECT_EQ(FaststartMp4File(root_ + "/missing.m4a", &error),
+            FaststartResult::kFailed);
+  EXPECT_FALSE(InspectMp4File(root_ + "/missing.m4a", &info, &error));
+}
+
+}  // namespace
@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+#include "runner/notification_dispatcher.h"
+#include "tests/runner_fakes.h"
+
+namespace {
+
+NotificationEvent Event(const std::string& id, const std::string& type,
+                        NotificationPriority priority =
+                            NotificationPriority::kNormal) {
+  NotificationEvent event;
+  event.id = id;
+  event.type = type;
+  event.title = "Title " + id;
+  event.body = "Body " + id;
+  event.group_title = type + " updates";
+  event.priority = priority;
+  event.buttons = {{"open", "Open"}};
+  return event;
+}
+
+struct Harness {
+  explicit Harness(NotificationDispatcherOptions options = {})
+      : dispatcher(&backend, options) {
+    backend.dispatcher = &dispatcher;
+  }
+
+  void Submit(NotificationEvent event, int64_t at_ms) {
+    backend.RunUntil(at_ms);
+    dispatcher.Submit(std::move(event), at_ms);
+  }
+
+  FakeNotificationBackend backend;
+  NotificationDispatcher dispatcher;
+};
+
+TEST(NotificationDispatcherTest, SingleEventWaitsForItsWindow) {
+  Harness h;
+  h.Submit(Event("1", "news"), 0);
+  EXPECT_TRUE(h.backend.shown.empty());
+  EXPECT_EQ(h.backend.tick_ms, 1500);
+
+  h.backend.RunUntil(1500);
+  ASSERT_EQ(h.backend.shown.size(), 1u);
+  const NotificationDigest& digest = h.backend.shown[0].digest;
+  EXPECT_EQ(digest.title, "Title 1");
+  EXPECT_EQ(digest.body, "Body 1");
+  ASSERT_EQ(digest.buttons.size(), 1u);
+  EXPECT_EQ(digest.buttons[0].key, "open");
+  // Nothing left, so nothing to wake up for.
+  EXPECT_EQ(h.backend.tick_ms, NotificationDispatcher::kNoTick);
+}
+
+TEST(NotificationDispatcherTest, SameTypeCoalescesIntoADigest) {
+  Harness h;
+  for (int i = 1; i <= 5; i++) {
+    h.Submit(Event(std::to_string(i), "approval"), i * 100);
+  }
+  h.Submit(Event("other", "news"), 600);
+  h.backend.RunUntil(2100);
+
+  ASSERT_EQ(h.backend.shown.size(), 2u);
+  const NotificationDigest& digest = h.backend.shown[0].digest;
+  EXPECT_EQ(h.backend.shown[0].at_ms, 1600);
+  EXPECT_EQ(digest.title, "approval updates (5)");
+  EXPECT_EQ(digest.body, "Title 5\nTitle 4\nTitle 3\nand 2 more");
+  EXPECT_EQ(digest.event_ids,
+            (std::vector<std::string>{"1", "2", "3", "4", "5"}));
+  EXPECT_EQ(h.backend.shown[1].digest.event_ids,
+            std::vector<std::string>{"other"});
+
+  const NotificationStats stats = h.dispatcher.stats();
+  EXPECT_EQ(stats.submitted, 6u);
+  EXPECT_EQ(stats.popups, 2u);
+  EXPECT_EQ(stats.coalesced, 4u);
+  EXPECT_EQ(stats.pending, 0u);
+}
+
+TEST(NotificationDispatcherTest, BucketLimitsTheRate) {
+  Harness h;
+  for (int i = 0; i < 6; i++) {
+    h.Submit(Event(std::to_string(i), "type" + std::to_string(i)), 0);
+  }
+  h.backend.Drain();
+
+  ASSERT_EQ(h.backend.shown.size(), 6u);
+  const int64_t expected[] = {1500, 1500, 1500, 5500, 9500, 13500};
+  for (size_t i = 0; i < 6; i++) {
+    EXPECT_EQ(h.backend.shown[i].at_ms, expected[i]) << i;
+  }
+}
+
+TEST(NotificationDispatcherTest, HigherLanesGoFirst) {
+  NotificationDispatcherOptions options;
+  options.burst = 1;
+  Harness h(options);
+  h.Submit(Event("first", "a"), 0);
+  h.backend.RunUntil(1500);
+  ASSERT_EQ(h.backend.shown.size(), 1u);
+
+  // The next token comes at 5500, when all three are due or nearly.
+  h.Submit(Event("low", "b", NotificationPriority::kLow), 1600);
+  h.Submit(Event("normal", "c"), 1700);
+  h.Submit(Event("high", "d", NotificationPriority::kHigh), 5000);
+  h.backend.Drain();
+
+  ASSERT_EQ(h.backend.shown.size(), 4u);
+  EXPECT_EQ(h.backend.shown[1].digest.event_ids[0], "high");
+  EXPECT_EQ(h.backend.shown[1].at_ms, 5500);
+  EXPECT_EQ(h.backend.shown[2].digest.event_ids[0], "normal");
+  EXPECT_EQ(h.backend.shown[2].at_ms, 9500);
+  EXPECT_EQ(h.backend.shown[3].digest.event_ids[0], "low");
+  EXPECT_EQ(h.backend.shown[3].at_ms, 13500);
+}
+
+TEST(NotificationDispatcherTest, WaitingGroupKeepsAbsorbing) {
+  NotificationDispatcherOptions options;
+  options.burst = 1;
+  Harness h(options);
+  h.Submit(Event("0", "a"), 0);
+  h.backend.RunUntil(1500);
+
+  // Due at 3500, but the token only comes at 5500.
+  h.Submit(Event("1", "a"), 2000);
+  h.Submit(Event("2", "a"), 4000);
+  h.Submit(Event("3", "a"), 5400);
+  h.backend.Drain();
+
+  ASSERT_EQ(h.backend.shown.size(), 2u);
+  EXPECT_EQ(h.backend.shown[1].at_ms, 5500);
+  EXPECT_EQ(h.backend.shown[1].digest.event_ids,
+            (std::vector<std::string>{"1", "2", "3"}));
+}
+
+TEST(NotificationDispatcherTest, ActionReportsEveryEventOnce) {
+  Harness h;
+  h.Submit(Event("1", "a"), 0);
+  h.Submit(Event("2", "a"), 10);
+  h.Submit(Event("3", "a"), 20);
+  h.backend.Drain();
+  ASSERT_EQ(h.backend.shown.size(), 1u);
+  const uint32_t server_id = h.backend.shown[0].server_id;
+
+  NotificationResponse response;
+  ASSERT_TRUE(h.dispatcher.OnAction(server_id, "open", &response));
+  EXPECT_EQ(response.action, "open");
+  EXPECT_EQ(response.event_ids, (std::vector<std::string>{"1", "2", "3"}));
+  EXPECT_FALSE(h.dispatcher.OnAction(server_id, "open", &response));
+  EXPECT_FALSE(h.dispatcher.OnAction(server_id + 1, "open", &response));
+}
+
+TEST(NotificationDispatcherTest, ClosedAndFailedPopupsAreForgotten) {
+  Harness h;
+  h.Submit(Event("1", "a"), 0);
+  h.backend.Drain();
+  const uint32_t server_id = h.backend.shown[0].server_id;
+  h.dispatcher.OnClosed(server_id);
+  NotificationResponse response;
+  EXPECT_FALSE(h.dispatcher.OnAction(server_id, "default", &response));
+
+  h.backend.fail = true;
+  h.Submit(Event("2", "a"), 2000);
+  h.backend.Drain();
+  EXPECT_EQ(h.dispatcher.stats().failed, 1u);
+  EXPECT_EQ(h.backend.shown.size(), 1u);
+}
+
+TEST(NotificationDispatcherTest, OnlyRememberedPopupsRoute) {
+  NotificationDispatcherOptions options;
+  options.burst = 100;
+  options.tracked_popups = 2;
+  Harness h(options);
+  for (int i = 0; i < 3; i++) {
+    h.Submit(Event(std::to_string(i), "type" + std::to_string(i)), 0);
+  }
+  h.backend.Drain();
+  ASSERT_EQ(h.backend.shown.size(), 3u);
+
+  NotificationResponse response;
+  EXPECT_FALSE(
+      h.dispatcher.OnAction(h.backend.shown[0].server_id, "open", &response));
+  EXPECT_TRUE(
+      h.dispatcher.OnAction(h.backend.shown[2].server_id, "open", &response));
+}
+
+// A reconnect replay and a bulk assignment: 1000 events of 12 types in five
+// bursts of 200, each within 100 ms, 20 s apart.
+TEST(NotificationDispatcherTest, StormOfAThousandEvents) {
+  Harness h;
+  const NotificationPriority priorities[] = {NotificationPriority::kHigh,
+                                            NotificationPriority::kNormal,
+                                            NotificationPriority::kLow};
+  uint32_t seed = 12345;
+  auto next_random = [&seed]() {
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 16) & 0x7FFF;
+  };
+  std::map<std::string, int> submitted;
+  for (int burst = 0; burst < 5; burst++) {
+    for (int i = 0; i < 200; i++) {
+      const int type = next_random() % 12;
+      const std::string id = std::to_string(burst * 200 + i);
+      h.Submit(Event(id, "type" + std::to_string(type), priorities[type % 3]),
+               burst * 20000 + i / 2);
+      submitted[id] = 0;
+    }
+  }
+  h.backend.Drain();
+
+  const NotificationStats stats = h.dispatcher.stats();
+  EXPECT_EQ(stats.submitted, 1000u);
+  EXPECT_EQ(stats.pending, 0u);
+  EXPECT_EQ(stats.popups + stats.coalesced, 1000u);
+  EXPECT_EQ(stats.popups, h.backend.shown.size());
+  // At most one popup per type and burst.
+  EXPECT_LE(h.backend.shown.size(), 60u);
+
+  // Every event in exactly one popup.
+  for (const FakeNotificationBackend::Shown& shown : h.backend.shown) {
+    for (const std::string& id : shown.digest.event_ids) {
+      submitted.at(id)++;
+    }
+  }
+  for (const auto& [id, count] : submitted) {
+    EXPECT_EQ(count, 1) << id;
+  }
+
+  // Never more than the bucket allows in any minute.
+  const size_t limit = 3 + 60000 / 4000;
+  for (size_t i = 0; i < h.backend.shown.size(); i++) {
+    size_t in_window = 0;
+    for (size_t j = i; j < h.backend.shown.size() &&
+                       h.backend.shown[j].at_ms <
+                           h.backend.shown[i].at_ms + 60000;
+         j++) {
+      in_window++;
+    }
+    EXPECT_LE(in_window, limit) << "from popup " << i;
+  }
+
+  // One wakeup per popup or window at most, and none once drained.
+  EXPECT_LE(h.backend.tick_requests, 2 * static_cast<int>(stats.popups) + 10);
+  EXPECT_EQ(h.backend.tick_ms, NotificationDispatcher::kNoTick);
+}
+
+}  // namespace
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "diagnostics/process_telemetry.h"
+#include "tests/temp_dir.h"
+
+namespace {
+
+// Field 2 is the command name, which may hold spaces and parentheses.
+constexpr char kStat[] =
+    "4242 (silver (stone) x) S 1 4242 4242 0 -1 4194304 15000 0 12 0 "
+    "250 75 0 0 20 0 17 0 1234 2147483648 30000 18446744073709551615\n";
+
+constexpr char kIo[] =
+    "rchar: 90000\n"
+    "wchar: 4000\n"
+    "syscr: 80\n"
+    "syscw: 12\n"
+    "read_bytes: 8192\n"
+    "write_bytes: 4096\n"
+    "cancelled_write_bytes: 0\n";
+
+constexpr char kThreadStatus[] =
+    "Name:\tgmain\n"
+    "State:\tS (sleeping)\n"
+    "voluntary_ctxt_switches:\t120\n"
+    "nonvoluntary_ctxt_switches:\t7\n";
+
+TEST(ProcessTelemetryTest, ParsesStat) {
+  ProcessSample sample;
+  ASSERT_TRUE(ParseProcStat(kStat, 100, 4096, &sample));
+  EXPECT_EQ(sample.cpu_user_us, 2500000);
+  EXPECT_EQ(sample.cpu_system_us, 750000);
+  EXPECT_EQ(sample.threads, 17u);
+  EXPECT_EQ(sample.rss_bytes, 30000u * 4096);
+  EXPECT_FALSE(ParseProcStat("4242 (x) S 1", 100, 4096, &sample));
+}
+
+TEST(ProcessTelemetryTest, ParsesIoPssAndThreads) {
+  ProcessSample sample;
+  ASSERT_TRUE(ParseProcIo(kIo, &sample));
+  EXPECT_EQ(sample.read_bytes, 8192u);
+  EXPECT_EQ(sample.write_bytes, 4096u);
+
+  uint64_t pss = 0;
+  ASSERT_TRUE(ParseSmapsRollupPss(
+      "00400000-7ffd0000 ---p 00000000 00:00 0 [rollup]\n"
+      "Rss:              120000 kB\n"
+      "Pss:               98000 kB\n",
+      &pss));
+  EXPECT_EQ(pss, 98000u * 1024);
+
+  std::string name;
+  uint64_t voluntary = 0;
+  uint64_t involuntary = 0;
+  ASSERT_TRUE(ParseThreadStatus(kThreadStatus, &name, &voluntary,
+                                &involuntary));
+  EXPECT_EQ(name, "gmain");
+  EXPECT_EQ(voluntary, 120u);
+  EXPECT_EQ(involuntary, 7u);
+
+  uint64_t cpu_ns = 0;
+  ASSERT_TRUE(ParseSchedstat("123456789 5000 42\n", &cpu_ns));
+  EXPECT_EQ(cpu_ns, 123456789u);
+}
+
+void WriteFile(const std::string& path, const std::string& text) {
+  std::ofstream(path) << text;
+}
+
+// A fake /proc/self with one thread, so deltas are exact.
+class FakeProcTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_FALSE(temp_.path().empty());
+    root_ = temp_.path();
+    mkdir((root_ + "/fd").c_str(), 0700);
+    for (int fd = 0; fd < 5; fd++) {
+      WriteFile(root_ + "/fd/" + std::to_string(fd), "");
+    }
+    mkdir((root_ + "/task").c_str(), 0700);
+    mkdir((root_ + "/task/4242").c_str(), 0700);
+    WriteFile(root_ + "/stat", kStat);
+    WriteFile(root_ + "/io", kIo);
+    WriteFile(root_ + "/smaps_rollup", "Pss: 2048 kB\n");
+    SetThread(1000000, 10);
+  }
+
+  void SetThread(uint64_t cpu_ns, uint64_t voluntary) {
+    WriteFile(root_ + "/task/4242/schedstat",
+              std::to_string(cpu_ns) + " 0 1\n");
+    WriteFile(root_ + "/task/4242/status",
+              "Name:\tworker\nvoluntary_ctxt_switches:\t" +
+                  std::to_string(voluntary) +
+                  "\nnonvoluntary_ctxt_switches:\t1\n");
+  }
+
+  ProcessTelemetryOptions Options() {
+    ProcessTelemetryOptions options;
+    options.window = 3;
+    options.pss_every = 2;
+    options.proc_self = root_;
+    return options;
+  }
+
+  TempDir temp_{"process_telemetry_test"};
+  std::string root_;
+};
+
+TEST_F(FakeProcTest, KeepsARollingWindow) {
+  ProcessTelemetry telemetry(Options());
+  for (int i = 0; i < 5; i++) {
+    ASSERT_TRUE(telemetry.Sample());
+  }
+  std::vector<ProcessSample> window = telemetry.Window();
+  ASSERT_EQ(window.size(), 3u);
+  EXPECT_LE(window[0].time_us, window[1].time_us);
+  EXPECT_LE(window[1].time_us, window[2].time_us);
+  // The directory read itself is not counted.
+  EXPECT_EQ(window[2].fds, 4u);
+  EXPECT_EQ(window[2].pss_bytes, 2048u * 1024);
+  EXPECT_EQ(window[2].voluntary_switches, 10u);
+}
+
+TEST_F(FakeProcTest, ReportsPerThreadDeltas) {
+  ProcessTelemetry telemetry(Options());
+  ASSERT_TRUE(telemetry.Sample());
+  std::vector<ThreadActivity> threads = telemetry.Threads();
+  ASSERT_EQ(threads.size(), 1u);
+  EXPECT_EQ(threads[0].cpu_delta_us, 0);
+
+  SetThread(4000000, 25);
+  ASSERT_TRUE(telemetry.Sample());
+  threads = telemetry.Threads();
+  ASSERT_EQ(threads.size(), 1u);
+  EXPECT_EQ(threads[0].thread_id, 4242u);
+  EXPECT_EQ(threads[0].name, "worker");
+  EXPECT_EQ(threads[0].cpu_us, 4000);
+  EXPECT_EQ(threads[0].cpu_delta_us, 3000);
+  EXPECT_EQ(threads[0].wakeups_delta, 15u);
+
+  const std::string json = telemetry.ToJson();
+  EXPECT_NE(json.find("\"window_size\":3"), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"worker\",\"cpu_us\":4000,"
+                      "\"cpu_delta_us\":3000,\"wakeups_delta\":15"),
+            std::string::npos);
+}
+
+TEST_F(FakeProcTest, FailsWithoutStat) {
+  ProcessTelemetryOptions options = Options();
+  options.proc_self = root_ + "/missing";
+  ProcessTelemetry telemetry(options);
+  EXPECT_FALSE(telemetry.Sample());
+  EXPECT_TRUE(telemetry.Window().empty());
+}
+
+TEST(ProcessTelemetryTest, SamplesThisProcess) {
+  ProcessTelemetry telemetry{ProcessTelemetryOptions()};
+  std::thread busy([] {
+    volatile uint64_t sum = 0;
+    for (int i = 0; i < 20000000; i++) {
+      sum = sum + i;
+    }
+  });
+  ASSERT_TRUE(telemetry.Sample());
+  busy.join();
+  ASSERT_TRUE(telemetry.Sample());
+  const ProcessSample sample = telemetry.Window().back();
+  EXPECT_GT(sample.rss_bytes, 0u);
+  EXPECT_GT(sample.pss_bytes, 0u);
+  EXPECT_GE(sample.threads, 1u);
+  EXPECT_GE(sample.fds, 3u);
+  EXPECT_FALSE(telemetry.Threads().empty());
+}
+
+}  // namespace
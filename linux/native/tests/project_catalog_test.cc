@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "catalog/project_catalog.h"
+
+namespace {
+
+CatalogProject Project(const std::string& id, const std::string& name,
+                       const std::string& status = "active") {
+  CatalogProject project;
+  project.id = id;
+  project.name = name;
+  project.client = "Client";
+  project.status = status;
+  return project;
+}
+
+CatalogDelta Upsert(std::vector<CatalogProject> projects,
+                    bool reset = false) {
+  CatalogDelta delta;
+  delta.reset = reset;
+  delta.upserts = std::move(projects);
+  return delta;
+}
+
+TEST(ProjectCatalogTest, FoldsCase) {
+  EXPECT_EQ(FoldCase("Villa JUMEIRAH 12"), "villa jumeirah 12");
+  EXPECT_EQ(FoldCase("ÉCOLE Ÿ Ĳ Ł"), "école ÿ ĳ ł");
+  EXPECT_EQ(FoldCase("ΑΘΉΝΑ МОСКВА Ёж"), "αθήνα москва ёж");
+  // No case, and bytes that are not UTF-8, stay as they are.
+  EXPECT_EQ(FoldCase("مشروع 1"), "مشروع 1");
+  EXPECT_EQ(FoldCase("A\xC3"), "a\xC3");
+  EXPECT_EQ(FoldCase("\xC3(B"), "\xC3(b");
+}
+
+TEST(ProjectCatalogTest, FindsByIdAndFoldedName) {
+  ProjectCatalog catalog;
+  EXPECT_EQ(catalog.Snapshot()->FindByName("x"), CatalogSnapshot::kNotFound);
+  catalog.Apply(Upsert({Project("a1", "Marina Tower"),
+                        Project("b2", "Palm Villa"),
+                        Project("c3", "marina tower")}));
+  auto snapshot = catalog.Snapshot();
+  EXPECT_EQ(snapshot->version(), 1u);
+  ASSERT_EQ(snapshot->size(), 3);
+  EXPECT_EQ(snapshot->FindById("b2"), 1);
+  EXPECT_EQ(snapshot->FindById("B2"), CatalogSnapshot::kNotFound);
+  // The first of two names that differ in case only, like the list scan.
+  EXPECT_EQ(snapshot->FindByName("MARINA TOWER"), 0);
+  EXPECT_EQ(snapshot->FindByName("palm villa"), 1);
+  EXPECT_EQ(snapshot->FindByName("Palm"), CatalogSnapshot::kNotFound);
+  EXPECT_EQ(snapshot->name(2), "marina tower");
+  EXPECT_EQ(snapshot->client(2), "Client");
+}
+
+TEST(ProjectCatalogTest, InternsRepeatedStrings) {
+  ProjectCatalog catalog;
+  std::vector<CatalogProject> projects;
+  for (int i = 0; i < 100; i++) {
+    projects.push_back(Project("id" + std::to_string(i),
+                               "P" + std::to_string(i),
+                               i % 2 ? "active" : "paused"));
+  }
+  catalog.Apply(Upsert(projects));
+  // 100 ids, 100 names, 100 folded names, one client, two statuses.
+  EXPECT_EQ(catalog.Snapshot()->string_count(), 303u);
+}
+
+TEST(ProjectCatalogTest, AppliesDeltas) {
+  ProjectCatalog catalog;
+  catalog.Apply(Upsert({Project("a", "A"), Project("b", "B"),
+                        Project("c", "C")}));
+
+  CatalogDelta delta = Upsert({Project("b", "Renamed"), Project("d", "D")});
+  delta.removals = {"a", "missing"};
+  EXPECT_EQ(catalog.Apply(delta), 2u);
+  auto snapshot = catalog.Snapshot();
+  ASSERT_EQ(snapshot->size(), 3);
+  EXPECT_EQ(snapshot->id(0), "b");
+  EXPECT_EQ(snapshot->name(0), "Renamed");
+  EXPECT_EQ(snapshot->FindByName("B"), CatalogSnapshot::kNotFound);
+  EXPECT_EQ(snapshot->FindByName("renamed"), 0);
+  EXPECT_EQ(snapshot->id(2), "d");
+  EXPECT_EQ(snapshot->FindById("a"), CatalogSnapshot::kNotFound);
+
+  // Removed and added back in one delta: the upsert wins, at the end.
+  delta = Upsert({Project("b", "Back")});
+  delta.removals = {"b"};
+  catalog.Apply(delta);
+  EXPECT_EQ(catalog.Snapshot()->id(2), "b");
+
+  catalog.Apply(Upsert({Project("z", "Z")}, /*reset=*/true));
+  EXPECT_EQ(catalog.Snapshot()->size(), 1);
+  EXPECT_EQ(catalog.Snapshot()->version(), 4u);
+}
+
+TEST(ProjectCatalogTest, SnapshotsDoNotChange) {
+  ProjectCatalog catalog;
+  catalog.Apply(Upsert({Project("a", "Old")}));
+  auto before = catalog.Snapshot();
+  const std::string_view name = before->name(0);
+  catalog.Apply(Upsert({Project("a", "New")}, /*reset=*/true));
+  EXPECT_EQ(name, "Old");
+  EXPECT_EQ(before->version(), 1u);
+  EXPECT_EQ(catalog.Snapshot()->name(0), "New");
+}
+
+TEST(ProjectCatalogTest, RoundTripsDeltas) {
+  CatalogDelta delta = Upsert({Project("a", "Ä"), Project("b", "")}, true);
+  delta.upserts[0].last_active_ms = 1700000000000;
+  delta.removals = {"c"};
+  const std::vector<uint8_t> bytes = EncodeCatalogDelta(delta);
+
+  CatalogDelta decoded;
+  ASSERT_TRUE(DecodeCatalogDelta(bytes.data(), bytes.size(), &decoded));
+  EXPECT_TRUE(decoded.reset);
+  ASSERT_EQ(decoded.upserts.size(), 2u);
+  EXPECT_EQ(decoded.upserts[0].name, "Ä");
+  EXPECT_EQ(decoded.upserts[0].last_active_ms, 1700000000000);
+  EXPECT_EQ(decoded.removals, std::vector<std::string>{"c"});
+
+  for (size_t size = 0; size < bytes.size(); size++) {
+    EXPECT_FALSE(DecodeCatalogDelta(bytes.data(), size, &decoded));
+  }
+  std::vector<uint8_t> longer = bytes;
+  longer.push_back(0);
+  EXPECT_FALSE(DecodeCatalogDelta(longer.data(), longer.size(), &decoded));
+}
+
+// Readers always see a whole version: here every version has the same
+// number of rows, each named after its version.
+TEST(ProjectCatalogTest, ReadersSeeWholeVersions) {
+  ProjectCatalog catalog;
+  constexpr int kRows = 50;
+  auto version = [](int v) {
+    std::vector<CatalogProject> projects;
+    for (int i = 0; i < kRows; i++) {
+      projects.push_back(
+          Project(std::to_string(i), "v" + std::to_string(v)));
+    }
+    return Upsert(projects, /*reset=*/true);
+  };
+  catalog.Apply(version(1));
+
+  std::atomic<bool> done(false);
+  std::atomic<int> torn(0);
+  std::thread reader([&] {
+    while (!done.load()) {
+      auto snapshot = catalog.Snapshot();
+      const std::string expected = "v" + std::to_string(snapshot->version());
+      for (int64_t row = 0; row < snapshot->size(); row++) {
+        if (snapshot->name(row) != expected) {
+          torn++;
+        }
+      }
+    }
+  });
+  for (int v = 2; v <= 200; v++) {
+    catalog.Apply(version(v));
+  }
+  done = true;
+  reader.join();
+  EXPECT_EQ(torn.load(), 0);
+}
+
+}  // namespace
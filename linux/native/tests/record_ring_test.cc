@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include "stream/record_ring.h"
+#include "stream/stream_registry.h"
+
+namespace {
+
+struct TestRecord {
+  uint64_t sequence;
+  uint64_t payload;
+};
+
+// Counts doorbell calls and lets a reader thread sleep until one comes.
+class DoorbellCounter {
+ public:
+  static void Ring(void* data) {
+    DoorbellCounter* self = static_cast<DoorbellCounter*>(data);
+    std::lock_guard<std::mutex> lock(self->mutex_);
+    self->rings_++;
+    self->rung_.notify_one();
+  }
+
+  int rings() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rings_;
+  }
+
+  // Returns false if no new ring came within a second.
+  bool WaitForRing(int seen) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return rung_.wait_for(lock, std::chrono::seconds(1),
+                          [&] { return rings_ > seen; });
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable rung_;
+  int rings_ = 0;
+};
+
+TestRecord ReadRecord(const RecordRing& ring, uint64_t index) {
+  TestRecord record;
+  std::memcpy(&record, ring.RecordAt(index), sizeof(record));
+  return record;
+}
+
+TEST(RecordRingTest, ReadsRecordsInOrderAcrossTheWrap) {
+  RecordRing ring(sizeof(TestRecord), 8);
+  ASSERT_TRUE(ring.Attach(nullptr, nullptr));
+  uint64_t next = 0;
+  for (int round = 0; round < 5; round++) {
+    for (int i = 0; i < 6; i++) {
+      ASSERT_TRUE(ring.Push(TestRecord{next + i, (next + i) * 3}));
+    }
+    uint64_t first = 0;
+    ASSERT_EQ(ring.Acquire(&first), 6u);
+    EXPECT_EQ(first, next);
+    for (uint64_t index = first; index < first + 6; index++) {
+      TestRecord record = ReadRecord(ring, index);
+      EXPECT_EQ(record.sequence, index);
+      EXPECT_EQ(record.payload, index * 3);
+    }
+    ring.Release(6);
+    next += 6;
+  }
+  EXPECT_EQ(ring.dropped(), 0u);
+}
+
+TEST(RecordRingTest, DropsAndCountsWhenFull) {
+  RecordRing ring(sizeof(TestRecord), 5);
+  ASSERT_EQ(ring.capacity(), 8u);
+  ASSERT_TRUE(ring.Attach(nullptr, nullptr));
+  for (uint64_t i = 0; i < 10; i++) {
+    EXPECT_EQ(ring.Push(TestRecord{i, 0}), i < 8);
+  }
+  EXPECT_EQ(ring.dropped(), 2u);
+
+  uint64_t first = 0;
+  ASSERT_EQ(ring.Acquire(&first), 8u);
+  ring.Release(3);
+  EXPECT_TRUE(ring.Push(TestRecord{8, 0}));
+  ASSERT_EQ(ring.Acquire(&first), 6u);
+  EXPECT_EQ(ReadRecord(ring, first + 5).sequence, 8u);
+}
+
+TEST(RecordRingTest, RejectsRecordsOfTheWrongSize) {
+  RecordRing ring(sizeof(TestRecord), 8);
+  EXPECT_FALSE(ring.Push(uint64_t{1}));
+}
+
+TEST(RecordRingTest, SecondReaderCannotAttach) {
+  RecordRing ring(sizeof(TestRecord), 8);
+  EXPECT_TRUE(ring.Attach(nullptr, nullptr));
+  EXPECT_FALSE(ring.Attach(nullptr, nullptr));
+  ring.Detach();
+  EXPECT_TRUE(ring.Attach(nullptr, nullptr));
+}
+
+TEST(RecordRingTest, AttachSkipsOlderRecords) {
+  RecordRing ring(sizeof(TestRecord), 8);
+  ring.Push(TestRecord{1, 0});
+  ring.Push(TestRecord{2, 0});
+  ASSERT_TRUE(ring.Attach(nullptr, nullptr));
+  ring.Push(TestRecord{3, 0});
+  uint64_t first = 0;
+  ASSERT_EQ(ring.Acquire(&first), 1u);
+  EXPECT_EQ(ReadRecord(ring, first).sequence, 3u);
+}
+
+TEST(RecordRingTest, DoorbellRingsOncePerArm) {
+  RecordRing ring(sizeof(TestRecord), 64);
+  DoorbellCounter doorbell;
+  ASSERT_TRUE(ring.Attach(&DoorbellCounter::Ring, &doorbell));
+
+  // Not armed yet.
+  ring.Push(TestRecord{0, 0});
+  EXPECT_EQ(doorbell.rings(), 0);
+
+  // Records are waiting, so arming hands the drain straight back.
+  EXPECT_TRUE(ring.Arm());
+  uint64_t first = 0;
+  ring.Release(ring.Acquire(&first));
+
+  EXPECT_FALSE(ring.Arm());
+  for (uint64_t i = 1; i < 20; i++) {
+    ring.Push(TestRecord{i, 0});
+  }
+  EXPECT_EQ(doorbell.rings(), 1);
+
+  ring.Release(ring.Acquire(&first));
+  EXPECT_FALSE(ring.Arm());
+  ring.Push(TestRecord{20, 0});
+  EXPECT_EQ(doorbell.rings(), 2);
+
+  ring.Detach();
+  ring.Push(TestRecord{21, 0});
+  EXPECT_EQ(doorbell.rings(), 2);
+}
+
+// The reader only ever waits for the doorbell, as the Dart reader does, so a
+// lost wakeup hangs the test rather than passing.
+TEST(RecordRingTest, ReaderWokenByDoorbellSeesEveryRecord) {
+  constexpr uint64_t kRecords = 200000;
+  RecordRing ring(sizeof(TestRecord), 1024);
+  DoorbellCounter doorbell;
+  ASSERT_TRUE(ring.Attach(&DoorbellCounter::Ring, &doorbell));
+
+  std::thread writer([&ring] {
+    for (uint64_t i = 0; i < kRecords;) {
+      if (ring.Push(TestRecord{i, ~i})) {
+        i++;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  // The writer retries when the ring is full, so nothing is lost.
+  uint64_t expected = 0;
+  int seen_rings = 0;
+  while (expected < kRecords) {
+    uint64_t first = 0;
+    uint32_t count = ring.Acquire(&first);
+    for (uint32_t i = 0; i < count; i++) {
+      TestRecord record = ReadRecord(ring, first + i);
+      ASSERT_EQ(record.sequence, expected);
+      ASSERT_EQ(record.payload, ~expected);
+      expected++;
+    }
+    ring.Release(count);
+    if (expected < kRecords && !ring.Arm()) {
+      ASSERT_TRUE(doorbell.WaitForRing(seen_rings))
+          << "no doorbell after record " << expected;
+      seen_rings = doorbell.rings();
+    }
+  }
+  writer.join();
+  EXPECT_EQ(expected, kRecords);
+  ring.Detach();
+}
+
+TEST(StreamRegistryTest, OpensTheSameStreamByName) {
+  StreamRegistry registry;
+  RecordRing* ring = registry.Open("levels", 16, 32);
+  ASSERT_NE(ring, nullptr);
+  EXPECT_EQ(registry.Open("levels", 16, 1024), ring);
+  EXPECT_EQ(ring->capacity(), 32u);
+  EXPECT_EQ(registry.Open("levels", 24, 32), nullptr);
+  EXPECT_EQ(registry.Open("odd", 12, 32), nullptr);
+  EXPECT_NE(registry.Open("other", 16, 32), ring);
+}
+
+}  // namespace
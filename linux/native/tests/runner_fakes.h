@@ -0,0 +1,165 @@
+#ifndef NATIVE_TESTS_RUNNER_FAKES_H_
+#define NATIVE_TESTS_RUNNER_FAKES_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "runner/audio_recorder.h"
+#include "runner/click_through.h"
+#include "runner/notification_dispatcher.h"
+
+// Stand-ins for the window system and audio APIs behind the runner logic,
+// for the tests and benchmarks.
+
+// A window at a fixed place with a movable cursor. Records what the
+// controller asked of it.
+class FakeClickThroughBackend : public ClickThroughBackend {
+ public:
+  ScreenPoint cursor;
+  ScreenRect window{100, 100, 500, 200};
+  // The client area sits inside a 1 px frame.
+  ScreenRect client{101, 101, 499, 199};
+
+  bool polling = false;
+  bool transparent = false;
+  int style_changes = 0;
+  int frame_refreshes = 0;
+
+  bool GetCursorPosition(ScreenPoint* point) override {
+    *point = cursor;
+    return true;
+  }
+  bool GetWindowRect(ScreenRect* rect) override {
+    *rect = window;
+    return true;
+  }
+  bool GetClientRect(ScreenRect* rect) override {
+    *rect = client;
+    return true;
+  }
+  void SetTransparent(bool value) override {
+    transparent = value;
+    style_changes++;
+  }
+  void RefreshFrame() override { frame_refreshes++; }
+  void StartPolling(int interval_ms) override { polling = true; }
+  void StopPolling() override { polling = false; }
+};
+
+// Produces blocks until told to fail or run dry, at an optional pace.
+class FakeAudioCaptureBackend : public AudioCaptureBackend {
+ public:
+  struct State {
+    bool fail_open = false;
+    // Read() results to replay first; then kBlock forever.
+    std::vector<Step> script;
+    // What the blocks say, by read; then blocks without timestamps.
+    std::vector<AudioBlock> blocks;
+    std::chrono::microseconds sample_interval{0};
+    // How long each Write() takes, and the one to fail (0 for none).
+    std::chrono::microseconds write_time{0};
+    uint64_t fail_write = 0;
+
+    std::atomic<int> opens{0};
+    std::atomic<int> closes{0};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> writes{0};
+    std::string path;
+  };
+
+  // |state| outlives the backend, which the recorder owns.
+  explicit FakeAudioCaptureBackend(State* state) : state_(state) {}
+
+  bool Open(const std::string& path) override {
+    state_->opens++;
+    state_->path = path;
+    return !state_->fail_open;
+  }
+
+  Step Read(AudioBlock* block) override {
+    const uint64_t index = state_->reads++;
+    if (state_->sample_interval.count() > 0) {
+      std::this_thread::sleep_for(state_->sample_interval);
+    }
+    if (index < state_->blocks.size()) {
+      *block = state_->blocks[index];
+    }
+    if (index < state_->script.size()) {
+      return state_->script[index];
+    }
+    return Step::kBlock;
+  }
+
+  bool Write() override {
+    const uint64_t count = ++state_->writes;
+    if (state_->write_time.count() > 0) {
+      std::this_thread::sleep_for(state_->write_time);
+    }
+    return count != state_->fail_write;
+  }
+
+  void Close() override { state_->closes++; }
+
+ private:
+  State* state_;
+};
+
+// A notification server that accepts everything, numbering popups from 1.
+// The dispatcher is set after construction, since each needs the other.
+class FakeNotificationBackend : public NotificationBackend {
+ public:
+  struct Shown {
+    int64_t at_ms = 0;
+    uint32_t server_id = 0;
+    NotificationDigest digest;
+  };
+
+  NotificationDispatcher* dispatcher = nullptr;
+  bool fail = false;
+  int64_t now_ms = 0;
+  int64_t tick_ms = NotificationDispatcher::kNoTick;
+  int tick_requests = 0;
+  std::vector<Shown> shown;
+
+  void Show(uint64_t handle, const NotificationDigest& digest) override {
+    const uint32_t server_id = fail ? 0 : next_id_++;
+    if (!fail) {
+      shown.push_back({now_ms, server_id, digest});
+    }
+    dispatcher->OnShown(handle, server_id);
+  }
+  void ScheduleTick(int64_t due_ms) override {
+    tick_ms = due_ms;
+    tick_requests++;
+  }
+
+  // Advances to |until_ms|, running the ticks requested on the way.
+  void RunUntil(int64_t until_ms) {
+    while (tick_ms != NotificationDispatcher::kNoTick && tick_ms <= until_ms) {
+      now_ms = tick_ms;
+      // Fired, as a GLib timeout would be.
+      tick_ms = NotificationDispatcher::kNoTick;
+      dispatcher->Tick(now_ms);
+    }
+    now_ms = std::max(now_ms, until_ms);
+  }
+
+  // Runs the requested ticks until nothing waits.
+  void Drain() {
+    while (tick_ms != NotificationDispatcher::kNoTick) {
+      now_ms = tick_ms;
+      // Fired, as a GLib timeout would be.
+      tick_ms = NotificationDispatcher::kNoTick;
+      dispatcher->Tick(now_ms);
+    }
+  }
+
+ private:
+  uint32_t next_id_ = 1;
+};
+
+#endif  // NATIVE_TESTS_RUNNER_FAKES_H_
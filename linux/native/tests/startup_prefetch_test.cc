@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+
+#include <sys/stat.h>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "startup/prefetch_plan.h"
+#include "startup/startup_prefetcher.h"
+#include "tests/temp_dir.h"
+
+namespace {
+
+class StartupPrefetchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_FALSE(temp_.path().empty());
+    root_ = temp_.path();
+  }
+
+  // Creates |name| and its directories under the root with |size| bytes.
+  void Write(const std::string& name, size_t size) {
+    for (size_t slash = name.find('/'); slash != std::string::npos;
+         slash = name.find('/', slash + 1)) {
+      mkdir((root_ + "/" + name.substr(0, slash)).c_str(), 0755);
+    }
+    std::ofstream(root_ + "/" + name, std::ios::binary)
+        << std::string(size, 'x');
+  }
+
+  // A bundle as `flutter build linux` lays it out.
+  void WriteBundle() {
+    Write("silver_stone", 100);
+    Write("lib/libapp.so", 300000);
+    Write("lib/libflutter_linux_gtk.so", 500000);
+    Write("lib/libscreen_retriever_plugin.so", 2000);
+    Write("data/icudtl.dat", 200000);
+    Write("data/flutter_assets/NOTICES.Z", 1000);
+    Write("data/flutter_assets/AssetManifest.bin", 500);
+    Write("data/flutter_assets/FontManifest.json", 100);
+    Write("data/flutter_assets/assets/images/background.png", 40000);
+    Write("data/flutter_assets/fonts/MaterialIcons-Regular.otf", 8000);
+    Write("data/flutter_assets/shaders/ink_sparkle.frag", 3000);
+  }
+
+  TempDir temp_{"startup_prefetch_test"};
+  std::string root_;
+};
+
+TEST_F(StartupPrefetchTest, ListsFilesInTheOrderTheyAreNeeded) {
+  WriteBundle();
+  EXPECT_EQ(ListStartupFiles(root_),
+            (std::vector<std::string>{
+                "lib/libflutter_linux_gtk.so",
+                "lib/libscreen_retriever_plugin.so",
+                "data/icudtl.dat",
+                "lib/libapp.so",
+                "data/flutter_assets/AssetManifest.bin",
+                "data/flutter_assets/FontManifest.json",
+                "data/flutter_assets/fonts/MaterialIcons-Regular.otf",
+                "data/flutter_assets/shaders/ink_sparkle.frag",
+                "data/flutter_assets/assets/images/background.png",
+            }));
+}
+
+TEST_F(StartupPrefetchTest, RecordsWhatIsCached) {
+  WriteBundle();
+  // Just written, so in the page cache.
+  PrefetchPlan plan;
+  RecordCachedRanges(root_, {"data/icudtl.dat", "missing.so"}, 128 * 1024,
+                     &plan);
+  ASSERT_EQ(plan.files.size(), 1u);
+  EXPECT_EQ(plan.files[0].path, "data/icudtl.dat");
+  EXPECT_EQ(plan.files[0].size, 200000u);
+  ASSERT_EQ(plan.files[0].ranges.size(), 1u);
+  EXPECT_EQ(plan.files[0].ranges[0].offset, 0u);
+  EXPECT_EQ(plan.files[0].ranges[0].length, 200000u);
+  EXPECT_EQ(plan.TotalBytes(), 200000u);
+  EXPECT_TRUE(IsPlanCurrent(plan, root_));
+}
+
+TEST_F(StartupPrefetchTest, ChangedFilesMakeThePlanStale) {
+  WriteBundle();
+  PrefetchPlan plan;
+  RecordCachedRanges(root_, ListStartupFiles(root_), 128 * 1024, &plan);
+  ASSERT_TRUE(IsPlanCurrent(plan, root_));
+
+  // An update replaces the snapshot with one of another size.
+  Write("lib/libapp.so", 310000);
+  EXPECT_FALSE(IsPlanCurrent(plan, root_));
+  RecordCachedRanges(root_, ListStartupFiles(root_), 128 * 1024, &plan);
+  ASSERT_TRUE(IsPlanCurrent(plan, root_));
+
+  ASSERT_EQ(std::remove((root_ + "/data/icudtl.dat").c_str()), 0);
+  EXPECT_FALSE(IsPlanCurrent(plan, root_));
+}
+
+TEST_F(StartupPrefetchTest, PlanRoundTrips) {
+  PrefetchPlan plan;
+  plan.files.push_back({"lib/libapp.so", 300000, 1700000000123456789, {}});
+  plan.files[0].ranges = {{0, 4096}, {65536, 200000}};
+  plan.files.push_back({"data/flutter_assets/my assets/a b.png", 10, -5, {}});
+  plan.files[1].ranges = {{0, 10}};
+
+  const std::string path = root_ + "/prefetch.plan";
+  ASSERT_TRUE(SavePrefetchPlan(path, plan));
+  PrefetchPlan loaded;
+  ASSERT_TRUE(LoadPrefetchPlan(path, &loaded));
+  ASSERT_EQ(loaded.files.size(), 2u);
+  EXPECT_EQ(loaded.files[0].path, "lib/libapp.so");
+  EXPECT_EQ(loaded.files[0].size, 300000u);
+  EXPECT_EQ(loaded.files[0].mtime_ns, 1700000000123456789);
+  ASSERT_EQ(loaded.files[0].ranges.size(), 2u);
+  EXPECT_EQ(loaded.files[0].ranges[1].offset, 65536u);
+  EXPECT_EQ(loaded.files[0].ranges[1].length, 200000u);
+  EXPECT_EQ(loaded.files[1].path, "data/flutter_assets/my assets/a b.png");
+  EXPECT_EQ(loaded.files[1].mtime_ns, -5);
+  EXPECT_EQ(SerializePrefetchPlan(loaded), SerializePrefetchPlan(plan));
+
+  EXPECT_FALSE(LoadPrefetchPlan(root_ + "/none.plan", &loaded));
+}
+
+TEST_F(StartupPrefetchTest, RejectsMalformedPlans) {
+  PrefetchPlan plan;
+  EXPECT_TRUE(ParsePrefetchPlan("ss-prefetch 1\n", &plan));
+  EXPECT_FALSE(ParsePrefetchPlan("", &plan));
+  EXPECT_FALSE(ParsePrefetchPlan("ss-prefetch 2\n", &plan));
+  // A range needs a file before it.
+  EXPECT_FALSE(ParsePrefetchPlan("ss-prefetch 1\nrange 0 10\n", &plan));
+  // Past the end of the file.
+  EXPECT_FALSE(ParsePrefetchPlan(
+      "ss-prefetch 1\nfile 100 1 lib/libapp.so\nrange 90 20\n", &plan));
+  EXPECT_FALSE(ParsePrefetchPlan(
+      "ss-prefetch 1\nfile 100 1 lib/libapp.so\nrange 0 0\n", &plan));
+  // Outside the bundle.
+  EXPECT_FALSE(ParsePrefetchPlan("ss-prefetch 1\nfile 100 1 ../secret\n",
+                                 &plan));
+  EXPECT_FALSE(ParsePrefetchPlan("ss-prefetch 1\nfile 100 1 /etc/passwd\n",
+                                 &plan));
+  EXPECT_TRUE(plan.files.empty());
+}
+
+TEST_F(StartupPrefetchTest, ReadsTheRanges) {
+  Write("data/icudtl.dat", 3 << 20);
+  const std::string path = root_ + "/data/icudtl.dat";
+  EXPECT_EQ(PrefetchFileRanges(path, {{0, 4096}, {1 << 20, 2 << 20}},
+                               nullptr),
+            4096u + (2 << 20));
+  // Recorded longer than the file now is.
+  EXPECT_EQ(PrefetchFileRanges(path, {{(3 << 20) - 10, 100}}, nullptr), 10u);
+  EXPECT_EQ(PrefetchFileRanges(root_ + "/missing", {{0, 10}}, nullptr), 0u);
+
+  std::atomic<bool> stop{true};
+  EXPECT_EQ(PrefetchFileRanges(path, {{0, 4096}}, &stop), 0u);
+}
+
+TEST_F(StartupPrefetchTest, PrefetcherReadsThePlanInTheBackground) {
+  WriteBundle();
+  PrefetchPlan plan;
+  RecordCachedRanges(root_, ListStartupFiles(root_), 128 * 1024, &plan);
+  const uint64_t total = plan.TotalBytes();
+  const size_t files = plan.files.size();
+
+  StartupPrefetcher prefetcher;
+  prefetcher.Start(root_, std::move(plan));
+  // Stops at once or after a few reads; either way it has finished.
+  prefetcher.Stop();
+  const PrefetchStats stats = prefetcher.stats();
+  EXPECT_LE(stats.files, files);
+  EXPECT_LE(stats.bytes, total);
+  EXPECT_GT(stats.start_ns, 0u);
+  EXPECT_GE(stats.end_ns, stats.start_ns);
+}
+
+TEST_F(StartupPrefetchTest, PrefetcherFinishesOnItsOwn) {
+  WriteBundle();
+  PrefetchPlan plan;
+  RecordCachedRanges(root_, ListStartupFiles(root_), 128 * 1024, &plan);
+  const uint64_t total = plan.TotalBytes();
+
+  StartupPrefetcher prefetcher;
+  prefetcher.Start(root_, std::move(plan));
+  while (prefetcher.stats().end_ns == 0) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(prefetcher.stats().files, 9u);
+  EXPECT_EQ(prefetcher.stats().bytes, total);
+}
+
+}  // namespace
@@ -0,0 +1,46 @@
+#ifndef NATIVE_TESTS_TEMP_DIR_H_
+#define NATIVE_TESTS_TEMP_DIR_H_
+
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string>
+
+// A fresh directory under /tmp for a test, removed with everything in it
+// when the TempDir goes away. Links inside it are removed, not followed.
+class TempDir {
+ public:
+  // |prefix| names the directory, e.g. "mp4_test" for /tmp/mp4_testXXXXXX.
+  explicit TempDir(const std::string& prefix) {
+    std::string pattern = "/tmp/" + prefix + "XXXXXX";
+    if (mkdtemp(&pattern[0]) != nullptr) {
+      path_ = pattern;
+    }
+  }
+
+  ~TempDir() {
+    if (!path_.empty()) {
+      nftw(path_.c_str(), &RemoveEntry, 16, FTW_DEPTH | FTW_PHYS);
+    }
+  }
+
+  TempDir(const TempDir&) = delete;
+  TempDir& operator=(const TempDir&) = delete;
+
+  // Empty if the directory could not be created.
+  const std::string& path() const { return path_; }
+
+ private:
+  // Children come before their directory; one that cannot be removed does
+  // not stop the rest.
+  static int RemoveEntry(const char* path, const struct stat*, int,
+                         struct FTW*) {
+    remove(path);
+    return 0;
+  }
+
+  std::string path_;
+};
+
+#endif  // NATIVE_TESTS_TEMP_DIR_H_
@@ -0,0 +1,279 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "scheduler/task.h"
+#include "scheduler/thread_pool.h"
+#include "scheduler/work_stealing_deque.h"
+
+namespace {
+
+ThreadPoolOptions SmallPool(int interactive, int background) {
+  ThreadPoolOptions options;
+  options.interactive_threads = interactive;
+  options.background_threads = background;
+  return options;
+}
+
+// Holds the workers of one group in a task until Open(), so tasks can be
+// queued behind it deterministically.
+class Gate {
+ public:
+  void Enter() {
+    entered_.fetch_add(1);
+    while (!open_.load()) {
+      std::this_thread::yield();
+    }
+  }
+  void WaitForEntered(int count) {
+    while (entered_.load() < count) {
+      std::this_thread::yield();
+    }
+  }
+  void Open() { open_.store(true); }
+
+ private:
+  std::atomic<int> entered_{0};
+  std::atomic<bool> open_{false};
+};
+
+// Waits for a task submitted after everything else in a one-worker group.
+void Drain(ThreadPool* pool, TaskPriority priority) {
+  std::atomic<bool> done{false};
+  pool->Submit(priority, [&done](const CancellationToken&) { done = true; });
+  while (!done.load()) {
+    std::this_thread::yield();
+  }
+}
+
+TEST(WorkStealingDequeTest, PopsNewestFirstAndStealsOldest) {
+  WorkStealingDeque deque;
+  PoolTask tasks[3];
+  for (PoolTask& task : tasks) {
+    deque.Push(&task);
+  }
+  EXPECT_EQ(deque.Pop(), &tasks[2]);
+  EXPECT_EQ(deque.Steal(), &tasks[0]);
+  EXPECT_EQ(deque.Pop(), &tasks[1]);
+  EXPECT_EQ(deque.Pop(), nullptr);
+  EXPECT_EQ(deque.Steal(), nullptr);
+  EXPECT_TRUE(deque.Empty());
+}
+
+TEST(WorkStealingDequeTest, EveryTaskIsTakenOnceUnderContention) {
+  constexpr int kTasks = 100000;
+  constexpr int kThieves = 3;
+  // Starts small so the owner grows the ring while thieves read it.
+  WorkStealingDeque deque(16);
+  std::vector<PoolTask> tasks(kTasks);
+  std::unique_ptr<std::atomic<int>[]> taken(new std::atomic<int>[kTasks]);
+  for (int i = 0; i < kTasks; i++) {
+    taken[i].store(0);
+  }
+  auto take = [&](PoolTask* task) { taken[task - tasks.data()].fetch_add(1); };
+
+  std::atomic<bool> owner_done{false};
+  std::vector<std::thread> thieves;
+  for (int t = 0; t < kThieves; t++) {
+    thieves.emplace_back([&] {
+      while (!owner_done.load() || !deque.Empty()) {
+        if (PoolTask* task = deque.Steal()) {
+          take(task);
+        }
+      }
+    });
+  }
+  // The owner pushes in bursts and pops some back, racing the thieves for
+  // the last task of each burst.
+  for (int i = 0; i < kTasks;) {
+    for (int burst = 0; burst < 64 && i < kTasks; burst++) {
+      deque.Push(&tasks[i++]);
+    }
+    for (int pops = 0; pops < 16; pops++) {
+      if (PoolTask* task = deque.Pop()) {
+        take(task);
+      }
+    }
+  }
+  while (PoolTask* task = deque.Pop()) {
+    take(task);
+  }
+  owner_done.store(true);
+  for (std::thread& thief : thieves) {
+    thief.join();
+  }
+  for (int i = 0; i < kTasks; i++) {
+    ASSERT_EQ(taken[i].load(), 1) << "task " << i;
+  }
+}
+
+TEST(ThreadPoolTest, RunsTasksSubmittedFromManyThreads) {
+  ThreadPool pool(SmallPool(4, 2));
+  constexpr int kPerThread = 2000;
+  std::atomic<int> ran{0};
+  std::vector<std::thread> submitters;
+  for (TaskPriority priority :
+       {TaskPriority::kInteractive, TaskPriority::kBackground,
+        TaskPriority::kIdle}) {
+    submitters.emplace_back([&pool, &ran, priority] {
+      for (int i = 0; i < kPerThread; i++) {
+        pool.Submit(priority,
+                    [&ran](const CancellationToken&) { ran.fetch_add(1); });
+      }
+    });
+  }
+  for (std::thread& submitter : submitters) {
+    submitter.join();
+  }
+  while (ran.load() < 3 * kPerThread) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(ran.load(), 3 * kPerThread);
+}
+
+TEST(ThreadPoolTest, CancelledTaskNeverStarts) {
+  ThreadPool pool(SmallPool(1, 1));
+  Gate gate;
+  pool.Submit(TaskPriority::kInteractive,
+              [&gate](const CancellationToken&) { gate.Enter(); });
+  gate.WaitForEntered(1);
+
+  std::atomic<bool> ran{false};
+  TaskHandle handle = pool.Submit(
+      TaskPriority::kInteractive,
+      [&ran](const CancellationToken&) { ran = true; });
+  EXPECT_EQ(handle.status(), TaskStatus::kQueued);
+  EXPECT_TRUE(handle.Cancel());
+  EXPECT_EQ(handle.status(), TaskStatus::kCancelled);
+
+  gate.Open();
+  Drain(&pool, TaskPriority::kInteractive);
+  EXPECT_FALSE(ran.load());
+  EXPECT_EQ(handle.status(), TaskStatus::kCancelled);
+  EXPECT_FALSE(handle.Cancel());
+}
+
+TEST(ThreadPoolTest, RunningTaskSeesCancellation) {
+  ThreadPool pool(SmallPool(1, 1));
+  std::atomic<bool> started{false};
+  std::atomic<bool> stopped{false};
+  TaskHandle handle = pool.Submit(
+      TaskPriority::kBackground,
+      [&](const CancellationToken& token) {
+        started = true;
+        while (!token.IsCancelled()) {
+          std::this_thread::yield();
+        }
+        stopped = true;
+      });
+  while (!started.load()) {
+    std::this_thread::yield();
+  }
+  EXPECT_FALSE(handle.Cancel());  // Already running.
+  while (!stopped.load()) {
+    std::this_thread::yield();
+  }
+  Drain(&pool, TaskPriority::kBackground);
+  EXPECT_EQ(handle.status(), TaskStatus::kDone);
+}
+
+TEST(ThreadPoolTest, BackgroundTasksRunBeforeIdleOnes) {
+  ThreadPool pool(SmallPool(1, 1));
+  Gate gate;
+  pool.Submit(TaskPriority::kBackground,
+              [&gate](const CancellationToken&) { gate.Enter(); });
+  gate.WaitForEntered(1);
+
+  std::mutex mutex;
+  std::vector<TaskPriority> order;
+  auto record = [&](TaskPriority priority) {
+    return [&, priority](const CancellationToken&) {
+      std::lock_guard<std::mutex> lock(mutex);
+      order.push_back(priority);
+    };
+  };
+  // Interleaved, with the idle ones queued first.
+  for (int i = 0; i < 5; i++) {
+    pool.Submit(TaskPriority::kIdle, record(TaskPriority::kIdle));
+    pool.Submit(TaskPriority::kBackground, record(TaskPriority::kBackground));
+  }
+  gate.Open();
+  Drain(&pool, TaskPriority::kIdle);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ(order.size(), 10u);
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(order[i],
+              i < 5 ? TaskPriority::kBackground : TaskPriority::kIdle)
+        << "task " << i;
+  }
+}
+
+TEST(ThreadPoolTest, NestedTaskGroupsRunOnASingleWorker) {
+  // With one worker, the inner Wait() only finishes if the worker runs the
+  // inner tasks itself instead of blocking.
+  ThreadPool pool(SmallPool(1, 1));
+  std::atomic<int> sum{0};
+  TaskGroup outer(&pool, TaskPriority::kInteractive);
+  for (int i = 0; i < 4; i++) {
+    outer.Run([&pool, &sum] {
+      EXPECT_TRUE(pool.IsWorkerThread());
+      TaskGroup inner(&pool, TaskPriority::kInteractive);
+      for (int j = 1; j <= 10; j++) {
+        inner.Run([&sum, j] { sum.fetch_add(j); });
+      }
+      inner.Wait();
+    });
+  }
+  outer.Wait();
+  EXPECT_EQ(sum.load(), 4 * 55);
+}
+
+TEST(ThreadPoolTest, RunPendingTaskIsFalseOutsideThePool) {
+  ThreadPool pool(SmallPool(1, 1));
+  EXPECT_FALSE(pool.IsWorkerThread());
+  EXPECT_FALSE(pool.RunPendingTask());
+}
+
+TEST(ThreadPoolTest, ShutdownFreesTasksThatNeverRan) {
+  auto token = std::make_shared<int>(0);
+  std::atomic<int> ran{0};
+  constexpr int kQueued = 50;
+  {
+    auto pool = std::make_unique<ThreadPool>(SmallPool(1, 1));
+    Gate gate;
+    for (TaskPriority priority :
+         {TaskPriority::kInteractive, TaskPriority::kBackground}) {
+      pool->Submit(priority,
+                   [&gate](const CancellationToken&) { gate.Enter(); });
+    }
+    gate.WaitForEntered(2);
+    for (int i = 0; i < kQueued; i++) {
+      for (TaskPriority priority :
+           {TaskPriority::kInteractive, TaskPriority::kBackground,
+            TaskPriority::kIdle}) {
+        pool->Submit(priority, [token, &ran](const CancellationToken&) {
+          ran.fetch_add(1);
+        });
+      }
+    }
+    EXPECT_EQ(token.use_count(), 1 + 3 * kQueued);
+    // The destructor waits for the gated workers; let them go once it has
+    // started.
+    std::thread opener([&gate] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      gate.Open();
+    });
+    pool.reset();
+    opener.join();
+  }
+  EXPECT_LE(ran.load(), 3 * kQueued);
+  EXPECT_EQ(token.use_count(), 1);
+}
+
+}  // namespace
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "tracing/trace_buffer.h"
+
+namespace {
+
+// An event whose every field is derived from |sequence|, so a torn copy
+// shows.
+TraceEvent EventFor(uint64_t sequence) {
+  TraceEvent event;
+  event.timestamp_ns = sequence * 1000;
+  event.payload = sequence;
+  event.category_id = static_cast<uint32_t>(sequence % 0x1000000);
+  event.name_id = static_cast<uint32_t>(sequence * 7);
+  event.phase = static_cast<TracePhase>(sequence % 7);
+  return event;
+}
+
+void ExpectEventFor(const TraceEvent& event, uint64_t sequence) {
+  const TraceEvent expected = EventFor(sequence);
+  EXPECT_EQ(event.timestamp_ns, expected.timestamp_ns) << sequence;
+  EXPECT_EQ(event.payload, expected.payload) << sequence;
+  EXPECT_EQ(event.category_id, expected.category_id) << sequence;
+  EXPECT_EQ(event.name_id, expected.name_id) << sequence;
+  EXPECT_EQ(event.phase, expected.phase) << sequence;
+}
+
+TEST(TraceBufferTest, RoundsCapacityUpToAPowerOfTwo) {
+  EXPECT_EQ(TraceBuffer(1, 0).capacity(), 2u);
+  EXPECT_EQ(TraceBuffer(1, 5).capacity(), 8u);
+  EXPECT_EQ(TraceBuffer(1, 8).capacity(), 8u);
+  EXPECT_EQ(TraceBuffer(1, 1000).capacity(), 1024u);
+}
+
+TEST(TraceBufferTest, KeepsEverythingUntilFull) {
+  TraceBuffer buffer(1, 8);
+  std::vector<TraceEvent> events;
+  EXPECT_EQ(buffer.Snapshot(&events), 0u);
+  EXPECT_TRUE(events.empty());
+  for (uint64_t i = 0; i < 8; i++) {
+    buffer.Append(EventFor(i));
+  }
+  EXPECT_EQ(buffer.Snapshot(&events), 0u);
+  ASSERT_EQ(events.size(), 8u);
+  for (uint64_t i = 0; i < 8; i++) {
+    ExpectEventFor(events[i], i);
+  }
+}
+
+TEST(TraceBufferTest, WraparoundKeepsTheNewestOldestFirst) {
+  TraceBuffer buffer(1, 8);
+  for (uint64_t i = 0; i < 21; i++) {
+    buffer.Append(EventFor(i));
+  }
+  // Snapshot() appends to what is already there.
+  std::vector<TraceEvent> events(1);
+  EXPECT_EQ(buffer.Snapshot(&events), 13u);
+  ASSERT_EQ(events.size(), 9u);
+  for (uint64_t i = 0; i < 8; i++) {
+    ExpectEventFor(events[i + 1], 13 + i);
+  }
+}
+
+TEST(TraceBufferTest, ClearForgetsEarlierEvents) {
+  TraceBuffer buffer(1, 8);
+  for (uint64_t i = 0; i < 20; i++) {
+    buffer.Append(EventFor(i));
+  }
+  buffer.Clear();
+  std::vector<TraceEvent> events;
+  EXPECT_EQ(buffer.Snapshot(&events), 0u);
+  EXPECT_TRUE(events.empty());
+
+  for (uint64_t i = 20; i < 23; i++) {
+    buffer.Append(EventFor(i));
+  }
+  EXPECT_EQ(buffer.Snapshot(&events), 0u);
+  ASSERT_EQ(events.size(), 3u);
+  ExpectEventFor(events[0], 20);
+  ExpectEventFor(events[2], 22);
+
+  // Only what was overwritten since the Clear() counts as lost.
+  for (uint64_t i = 23; i < 30; i++) {
+    buffer.Append(EventFor(i));
+  }
+  events.clear();
+  EXPECT_EQ(buffer.Snapshot(&events), 2u);
+  ASSERT_EQ(events.size(), 8u);
+  ExpectEventFor(events.front(), 22);
+  ExpectEventFor(events.back(), 29);
+}
+
+TEST(TraceBufferTest, SnapshotsWhileTheOwnerWraps) {
+  // A small ring the writer laps many times over while another thread
+  // copies it: every snapshot must be a run of whole events, with the
+  // overwritten ones counted rather than returned.
+  constexpr uint64_t kEvents = 1000000;
+  TraceBuffer buffer(1, 64);
+  std::atomic<bool> done{false};
+  std::thread writer([&] {
+    for (uint64_t i = 0; i < kEvents; i++) {
+      buffer.Append(EventFor(i));
+    }
+    done.store(true);
+  });
+
+  int snapshots = 0;
+  std::vector<TraceEvent> events;
+  while (!done.load() || snapshots == 0) {
+    events.clear();
+    const uint64_t lost = buffer.Snapshot(&events);
+    snapshots++;
+    ASSERT_LE(events.size(), buffer.capacity());
+    for (size_t i = 0; i < events.size(); i++) {
+      ExpectEventFor(events[i], lost + i);
+      if (HasFailure()) {
+        break;
+      }
+    }
+    if (HasFailure()) {
+      break;
+    }
+  }
+  writer.join();
+
+  events.clear();
+  EXPECT_EQ(buffer.Snapshot(&events), kEvents - buffer.capacity());
+  ASSERT_EQ(events.size(), buffer.capacity());
+  ExpectEventFor(events.back(), kEvents - 1);
+}
+
+}  // namespace
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "tray/tray_api.h"
+#include "tray/tray_state.h"
+
+namespace {
+
+TEST(TrayStateTest, Initials) {
+  EXPECT_EQ(TrayInitials("Villa project"), "VP");
+  EXPECT_EQ(TrayInitials("marina tower phase 2"), "MT");
+  EXPECT_EQ(TrayInitials("  Al-Barsha"), "AB");
+  EXPECT_EQ(TrayInitials("Jumeirah"), "JU");
+  EXPECT_EQ(TrayInitials("X"), "X");
+  EXPECT_EQ(TrayInitials(""), "");
+  EXPECT_EQ(TrayInitials("مشروع النخلة"), "ما");
+  EXPECT_EQ(TrayInitials("Éclat"), "ÉC");
+}
+
+TEST(TrayStateTest, ElapsedAtMinuteGranularity) {
+  EXPECT_EQ(TrayElapsedLabel(0), "0:00");
+  EXPECT_EQ(TrayElapsedLabel(59999), "0:00");
+  EXPECT_EQ(TrayElapsedLabel(60000), "0:01");
+  EXPECT_EQ(TrayElapsedLabel((10 * 60 + 5) * 60000LL + 1), "10:05");
+  EXPECT_EQ(TrayElapsedLabel(-5000), "0:00");
+
+  EXPECT_EQ(TrayNextUpdateDelayMs(0), 60000);
+  EXPECT_EQ(TrayNextUpdateDelayMs(59999), 1);
+  EXPECT_EQ(TrayNextUpdateDelayMs(60000), 60000);
+  // A start time slightly in the future (clock skew with the server).
+  EXPECT_EQ(TrayNextUpdateDelayMs(-1500), 1500);
+}
+
+TEST(TrayStateTest, View) {
+  TrayStatus status;
+  TrayView view = MakeTrayView(status, 1000);
+  EXPECT_EQ(view.initials, "");
+  EXPECT_EQ(view.tooltip_body, "No timer running");
+  EXPECT_EQ(view.next_update_ms, 0);
+
+  status.running = true;
+  status.project = "Palm Villa";
+  status.started_at_ms = 1000;
+  view = MakeTrayView(status, 1000 + 90 * 60000 + 2000);
+  EXPECT_EQ(view.initials, "PV");
+  EXPECT_EQ(view.elapsed, "1:30");
+  EXPECT_EQ(view.tooltip_title, "Palm Villa");
+  EXPECT_EQ(view.tooltip_body, "1:30 elapsed");
+  EXPECT_EQ(view.next_update_ms, 58000);
+}
+
+void CountChange(void* data) {
+  ++*static_cast<int*>(data);
+}
+
+TEST(TrayStateTest, NotifiesOnlyOnChange) {
+  TrayState state;
+  int changes = 0;
+  state.SetListener(CountChange, &changes);
+  state.SetVisible(true);
+  state.SetVisible(true);
+  state.SetSession("A", 5);
+  state.SetSession("A", 5);
+  state.SetSession("", 0);
+  EXPECT_EQ(changes, 3);
+
+  TrayStatus status;
+  EXPECT_EQ(state.Read(&status), 3u);
+  EXPECT_TRUE(status.visible);
+  EXPECT_FALSE(status.running);
+}
+
+TEST(TrayStateTest, CApiCutsLongTextAtCharacterBoundary) {
+  std::string project(126, 'a');
+  project += "é";  // Bytes 126 and 127; only 127 bytes fit.
+  ss_tray_set_session(project.c_str(), 0);
+  SsTrayView view;
+  ss_tray_read(0, &view);
+  EXPECT_TRUE(view.running);
+  EXPECT_EQ(std::strlen(view.tooltip_title), 126u);
+  ss_tray_set_session(nullptr, 0);
+  ss_tray_read(0, &view);
+  EXPECT_FALSE(view.running);
+}
+
+}  // namespace
@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "runner/utf16.h"
+
+namespace {
+
+TEST(Utf16Test, ConvertsAsciiAndMultibyte) {
+  EXPECT_EQ(Utf8FromUtf16(u""), "");
+  EXPECT_EQ(Utf8FromUtf16(u"--trace"), "--trace");
+  EXPECT_EQ(Utf8FromUtf16(u"caf\u00e9"), "caf\xc3\xa9");
+  EXPECT_EQ(Utf8FromUtf16(u"\u0627\u0644\u0639\u064a\u0646"),
+            "\xd8\xa7\xd9\x84\xd8\xb9\xd9\x8a\xd9\x86");
+  EXPECT_EQ(Utf8FromUtf16(u"\u20ac"), "\xe2\x82\xac");
+  // U+1F600, a surrogate pair.
+  EXPECT_EQ(Utf8FromUtf16(u"\U0001F600"), "\xf0\x9f\x98\x80");
+}
+
+TEST(Utf16Test, RejectsUnpairedSurrogates) {
+  const char16_t lone_high[] = {u'a', 0xD83D, u'b'};
+  const char16_t lone_low[] = {0xDE00, u'a'};
+  const char16_t trailing_high[] = {u'a', 0xD83D};
+  EXPECT_EQ(Utf8FromUtf16(std::u16string_view(lone_high, 3)), "");
+  EXPECT_EQ(Utf8FromUtf16(std::u16string_view(lone_low, 2)), "");
+  EXPECT_EQ(Utf8FromUtf16(std::u16string_view(trailing_high, 2)), "");
+}
+
+TEST(Utf16Test, RoundTrips) {
+  const std::u16string text =
+      u"C:\\Users\\\u00c5sa\\AppData\\\u6587\u4ef6\\\U0001F3A4.m4a";
+  EXPECT_EQ(Utf16FromUtf8(Utf8FromUtf16(text)), text);
+}
+
+TEST(Utf16Test, RejectsMalformedUtf8) {
+  EXPECT_EQ(Utf16FromUtf8("ok"), u"ok");
+  EXPECT_EQ(Utf16FromUtf8("\x80"), u"");              // Stray continuation.
+  EXPECT_EQ(Utf16FromUtf8("\xc3"), u"");              // Truncated.
+  EXPECT_EQ(Utf16FromUtf8("\xc0\xaf"), u"");          // Overlong '/'.
+  EXPECT_EQ(Utf16FromUtf8("\xed\xa0\x80"), u"");      // Encoded surrogate.
+  EXPECT_EQ(Utf16FromUtf8("\xf4\x90\x80\x80"), u"");  // Past U+10FFFF.
+}
+
+}  // namespace
@@ -0,0 +1,91 @@
+#!/bin/bash
+# Builds the native targets three ways and compares them on the benchmarks:
+#
+#   build/pgo-baseline   -O3, as the app builds them today
+#   build/pgo-generate   instrumented; the benchmarks run once as training
+#   build/pgo-use        LTO plus the training profiles
+#
+# Usage: tools/pgo_build.sh [benchmark min time in seconds, default 0.5]
+#
+# The same profiles work for an app build, which configures this directory
+# from linux/CMakeLists.txt:
+#
+#   SS_NATIVE_PGO=generate SS_NATIVE_PGO_DIR=$PWD/build/pgo \
+#       flutter build linux
+#   dart run scripts/linux_bench.dart    # trains the runner as well
+#   SS_NATIVE_PGO=use SS_NATIVE_PGO_DIR=$PWD/build/pgo flutter build linux
+
+set -euo pipefail
+
+cd "$(dirname "$0")/.."
+MIN_TIME="${1:-0.5}"
+BUILD="$PWD/build"
+PROFILES="$BUILD/pgo"
+JOBS="$(nproc)"
+
+configure() {
+  local dir="$1"
+  shift
+  cmake -S . -B "$dir" -DCMAKE_BUILD_TYPE=Release \
+    -DSS_NATIVE_BENCHMARKS=ON "$@" > /dev/null
+  cmake --build "$dir" -j"$JOBS" > /dev/null
+}
+
+benchmarks() {
+  find "$1" -maxdepth 1 -name '*_benchmark' -type f -perm -u+x | sort
+}
+
+echo "Building the instrumented targets"
+rm -rf "$PROFILES"
+configure "$BUILD/pgo-generate" -DSS_NATIVE_PGO=generate \
+  -DSS_NATIVE_PGO_DIR="$PROFILES" -DSS_NATIVE_LTO=OFF
+
+echo "Training"
+for benchmark in $(benchmarks "$BUILD/pgo-generate"); do
+  echo "  $(basename "$benchmark")"
+  "$benchmark" --benchmark_min_time=0.05 > /dev/null 2>&1
+done
+if [[ "$(cmake -LA -N "$BUILD/pgo-generate" | grep CMAKE_CXX_COMPILER:)" \
+      == *clang* ]]; then
+  llvm-profdata merge -o "$PROFILES/merged.profdata" "$PROFILES"/*.profraw
+fi
+
+echo "Building the optimized and baseline targets"
+configure "$BUILD/pgo-use" -DSS_NATIVE_PGO=use \
+  -DSS_NATIVE_PGO_DIR="$PROFILES" -DSS_NATIVE_LTO=ON
+configure "$BUILD/pgo-baseline" -DSS_NATIVE_PGO= -DSS_NATIVE_LTO=OFF
+
+# Real time per benchmark, baseline against optimized. JSON rather than CSV:
+# the CSV reporter aborts when runs of one binary have different counters.
+names=()
+for benchmark in $(benchmarks "$BUILD/pgo-baseline"); do
+  name="$(basename "$benchmark")"
+  names+=("$name")
+  for variant in baseline use; do
+    "$BUILD/pgo-$variant/$name" --benchmark_min_time="$MIN_TIME" \
+      --benchmark_format=json > "$BUILD/pgo-$variant/$name.json" 2> /dev/null
+  done
+done
+python3 - "$BUILD" "${names[@]}" <<'PY'
+import json
+import sys
+
+build = sys.argv[1]
+
+
+def real_times(variant, name):
+    with open(f"{build}/pgo-{variant}/{name}.json") as f:
+        runs = json.load(f)["benchmarks"]
+    return {run["name"]: run["real_time"] for run in runs
+            if not run.get("error_occurred")}
+
+
+print(f"\n{'benchmark':64} {'baseline':>12} {'pgo+lto':>12} {'speedup':>8}")
+for name in sys.argv[2:]:
+    optimized = real_times("use", name)
+    for run, before in real_times("baseline", name).items():
+        after = optimized.get(run)
+        if after:
+            print(f"{run[:64]:64} {before:12.0f} {after:12.0f} "
+                  f"{before / after:7.2f}x")
+PY
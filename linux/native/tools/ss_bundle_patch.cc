@@ -0,0 +1,82 @@
+// Release tool for bundle patches (see update/bundle_patch.h).
+//
+//   ss_bundle_patch create OLD_BUNDLE NEW_BUNDLE PATCH
+//   ss_bundle_patch apply INSTALLED_BUNDLE PATCH OUTPUT_DIR
+//   ss_bundle_patch hash FILE
+//
+// "create" runs in CI for each supported upgrade path; its output is
+// uploaded as silver_stone-linux-FROM-to-TO.sspatch. "apply" builds the
+// target bundle the same way the app does and is useful to check a patch
+// before publishing it.
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "update/bundle_patch.h"
+#include "update/sha256.h"
+
+namespace {
+
+void PrintStats(const BundlePatchStats& stats, double seconds) {
+  fprintf(stderr,
+          "%u files (%u kept, %u patched, %u stored), %" PRIu64
+          " bytes -> %" PRIu64 " byte patch, %.2f s\n",
+          stats.files, stats.kept, stats.patched, stats.added,
+          stats.target_bytes, stats.patch_bytes, seconds);
+}
+
+int Usage() {
+  fprintf(stderr,
+          "usage: ss_bundle_patch create OLD_BUNDLE NEW_BUNDLE PATCH\n"
+          "       ss_bundle_patch apply INSTALLED_BUNDLE PATCH OUTPUT_DIR\n"
+          "       ss_bundle_patch hash FILE\n");
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    return Usage();
+  }
+  const std::string command = argv[1];
+  const auto start = std::chrono::steady_clock::now();
+  auto elapsed = [&start] {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+  };
+
+  if (command == "hash" && argc == 3) {
+    uint8_t digest[Sha256::kDigestBytes];
+    if (!Sha256File(argv[2], digest)) {
+      fprintf(stderr, "cannot read %s\n", argv[2]);
+      return 1;
+    }
+    printf("%s\n", DigestToHex(digest).c_str());
+    return 0;
+  }
+
+  BundlePatchStats stats;
+  std::string error;
+  if (command == "create" && argc == 5) {
+    if (!CreateBundlePatch(argv[2], argv[3], argv[4], &stats, &error)) {
+      fprintf(stderr, "%s\n", error.c_str());
+      return 1;
+    }
+    PrintStats(stats, elapsed());
+    return 0;
+  }
+  if (command == "apply" && argc == 5) {
+    if (!ApplyBundlePatch(argv[2], argv[3], argv[4], 0, &stats, &error)) {
+      fprintf(stderr, "%s\n", error.c_str());
+      return 1;
+    }
+    PrintStats(stats, elapsed());
+    return 0;
+  }
+  return Usage();
+}
@@ -0,0 +1,573 @@
+// Generates the fast-path channel codecs (see codec/fast_codec.h) from a
+// schema such as codec/fast_messages.schema.
+//
+//   ss_codec_gen SCHEMA CPP_HEADER DART_FILE
+//
+// The outputs are checked in, so building the app needs neither this tool
+// nor the schema; the fast_messages_up_to_date test catches stale copies.
+
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Field {
+  std::string type;
+  std::string name;  // lowerCamelCase, as written.
+};
+
+struct Call {
+  int id = 0;
+  std::string name;
+  std::vector<Field> args;
+  std::vector<Field> results;
+};
+
+struct Channel {
+  std::string name;  // UpperCamelCase.
+  std::string channel;
+  std::vector<Call> calls;
+};
+
+struct Schema {
+  int version = 0;
+  std::vector<Channel> channels;
+};
+
+bool IsKnownType(const std::string& type) {
+  return type == "bool" || type == "int32" || type == "int64" ||
+         type == "float64" || type == "string" || type == "bytes";
+}
+
+class Parser {
+ public:
+  explicit Parser(const std::string& text) : text_(text) {}
+
+  bool Parse(Schema* schema, std::string* error) {
+    Next();
+    while (!token_.empty()) {
+      if (token_ == "version") {
+        Next();
+        if (!Number(&schema->version)) {
+          return Error("expected a version number", error);
+        }
+      } else if (token_ == "channel") {
+        Channel channel;
+        if (!ParseChannel(&channel, schema, error)) {
+          return false;
+        }
+        schema->channels.push_back(channel);
+      } else {
+        return Error("unexpected '" + token_ + "'", error);
+      }
+    }
+    if (schema->version <= 0 || schema->version > 255) {
+      return Error("missing or bad version", error);
+    }
+    return true;
+  }
+
+ private:
+  bool ParseChannel(Channel* channel, const Schema* schema,
+                    std::string* error) {
+    Next();
+    channel->name = token_;
+    if (!Identifier() || !isupper(channel->name[0])) {
+      return Error("expected a channel name", error);
+    }
+    if (token_.size() < 2 || token_[0] != '"') {
+      return Error("expected the quoted channel string", error);
+    }
+    channel->channel = token_.substr(1, token_.size() - 2);
+    Next();
+    if (!Expect("{", error)) {
+      return false;
+    }
+    while (token_ != "}") {
+      Call call;
+      if (!Number(&call.id) || call.id <= 0 || call.id > 255) {
+        return Error("expected a call id from 1 to 255", error);
+      }
+      for (const Call& other : channel->calls) {
+        if (other.id == call.id || other.name == token_) {
+          return Error("duplicate call " + token_, error);
+        }
+      }
+      call.name = token_;
+      if (!Identifier() || !islower(call.name[0])) {
+        return Error("expected a call name", error);
+      }
+      if (!ParseFields(&call.args, error)) {
+        return false;
+      }
+      if (token_ == "->") {
+        Next();
+        if (!ParseFields(&call.results, error)) {
+          return false;
+        }
+      }
+      channel->calls.push_back(call);
+    }
+    Next();
+    return true;
+  }
+
+  bool ParseFields(std::vector<Field>* fields, std::string* error) {
+    if (!Expect("(", error)) {
+      return false;
+    }
+    while (token_ != ")") {
+      Field field;
+      field.type = token_;
+      if (!IsKnownType(field.type)) {
+        return Error("unknown type '" + field.type + "'", error);
+      }
+      Next();
+      field.name = token_;
+      if (!Identifier() || !islower(field.name[0])) {
+        return Error("expected a field name", error);
+      }
+      fields->push_back(field);
+      if (token_ == ",") {
+        Next();
+      } else if (token_ != ")") {
+        return Error("expected ',' or ')'", error);
+      }
+    }
+    Next();
+    return true;
+  }
+
+  bool Expect(const std::string& expected, std::string* error) {
+    if (token_ != expected) {
+      return Error("expected '" + expected + "'", error);
+    }
+    Next();
+    return true;
+  }
+
+  bool Identifier() {
+    if (token_.empty() || !isalpha(static_cast<unsigned char>(token_[0]))) {
+      return false;
+    }
+    for (char c : token_) {
+      if (!isalnum(static_cast<unsigned char>(c))) {
+        return false;
+      }
+    }
+    Next();
+    return true;
+  }
+
+  bool Number(int* value) {
+    if (token_.empty() || token_.size() > 3 ||
+        !isdigit(static_cast<unsigned char>(token_[0]))) {
+      return false;
+    }
+    for (char c : token_) {
+      if (!isdigit(static_cast<unsigned char>(c))) {
+        return false;
+      }
+    }
+    *value = std::stoi(token_);
+    Next();
+    return true;
+  }
+
+  bool Error(const std::string& message, std::string* error) {
+    *error = "line " + std::to_string(line_) + ": " + message;
+    return false;
+  }
+
+  void Next() {
+    token_.clear();
+    while (position_ < text_.size()) {
+      char c = text_[position_];
+      if (c == '#') {
+        while (position_ < text_.size() && text_[position_] != '\n') {
+          position_++;
+        }
+      } else if (isspace(static_cast<unsigned char>(c))) {
+        line_ += c == '\n';
+        position_++;
+      } else {
+        break;
+      }
+    }
+    if (position_ >= text_.size()) {
+      return;
+    }
+    const size_t start = position_;
+    const char c = text_[position_];
+    if (c == '"') {
+      position_ = text_.find('"', start + 1);
+      position_ = position_ == std::string::npos ? text_.size() : position_ + 1;
+    } else if (c == '-' && text_.compare(start, 2, "->") == 0) {
+      position_ += 2;
+    } else if (isalnum(static_cast<unsigned char>(c))) {
+      while (position_ < text_.size() &&
+             isalnum(static_cast<unsigned char>(text_[position_]))) {
+        position_++;
+      }
+    } else {
+      position_++;
+    }
+    token_ = text_.substr(start, position_ - start);
+  }
+
+  const std::string& text_;
+  size_t position_ = 0;
+  int line_ = 1;
+  std::string token_;
+};
+
+std::string UpperFirst(const std::string& name) {
+  std::string result = name;
+  result[0] = static_cast<char>(toupper(result[0]));
+  return result;
+}
+
+std::string SnakeCase(const std::string& name) {
+  std::string result;
+  for (size_t i = 0; i < name.size(); i++) {
+    if (isupper(static_cast<unsigned char>(name[i]))) {
+      if (i > 0) {
+        result += '_';
+      }
+      result += static_cast<char>(tolower(name[i]));
+    } else {
+      result += name[i];
+    }
+  }
+  return result;
+}
+
+// C++ --------------------------------------------------------------------
+
+// Arguments are views into the message; results are owned, except for
+// bytes, which must stay valid until the handler's caller has encoded them.
+std::string CppType(const std::string& type, bool argument) {
+  if (type == "bool") return "bool";
+  if (type == "int32") return "int32_t";
+  if (type == "int64") return "int64_t";
+  if (type == "float64") return "double";
+  if (type == "string") return argument ? "FastStringView" : "std::string";
+  return "FastByteView";
+}
+
+std::string CppDefault(const std::string& type) {
+  if (type == "bool") return " = false";
+  if (type == "int32" || type == "int64") return " = 0";
+  if (type == "float64") return " = 0.0";
+  return "";
+}
+
+std::string CppMethod(const std::string& type) {
+  if (type == "bool") return "Bool";
+  if (type == "int32") return "Int32";
+  if (type == "int64") return "Int64";
+  if (type == "float64") return "Float64";
+  if (type == "string") return "String";
+  return "Bytes";
+}
+
+void EmitCppStruct(std::ostringstream& out, const std::string& name,
+                   const std::vector<Field>& fields, bool argument) {
+  if (fields.empty()) {
+    out << "struct " << name << " {};\n";
+    return;
+  }
+  out << "struct " << name << " {\n";
+  for (const Field& field : fields) {
+    out << "  " << CppType(field.type, argument) << " "
+        << SnakeCase(field.name) << CppDefault(field.type) << ";\n";
+  }
+  out << "};\n";
+}
+
+void EmitCppReads(std::ostringstream& out, const std::vector<Field>& fields,
+                  const std::string& target, const std::string& indent) {
+  for (const Field& field : fields) {
+    out << indent << "reader.Read" << CppMethod(field.type) << "(&" << target
+        << SnakeCase(field.name) << ");\n";
+  }
+}
+
+void EmitCppWrites(std::ostringstream& out, const std::vector<Field>& fields,
+                   const std::string& source, const std::string& indent) {
+  for (const Field& field : fields) {
+    out << indent << "writer.Write" << CppMethod(field.type) << "(" << source
+        << SnakeCase(field.name) << ");\n";
+  }
+}
+
+std::string GenerateCpp(const Schema& schema, const std::string& schema_path,
+                        const std::string& guard) {
+  std::ostringstream out;
+  out << "// Generated by tools/ss_codec_gen.cc from " << schema_path
+      << ".\n// Do not edit.\n\n";
+  out << "#ifndef " << guard << "\n#define " << guard << "\n\n";
+  out << "#include <cstddef>\n#include <cstdint>\n#include <string>\n"
+         "#include <vector>\n\n#include \"codec/fast_codec.h\"\n\n";
+  out << "namespace fast_messages {\n\n";
+  out << "constexpr uint8_t kVersion = " << schema.version << ";\n";
+
+  for (const Channel& channel : schema.channels) {
+    out << "\nnamespace " << SnakeCase(channel.name) << " {\n\n";
+    out << "constexpr char kChannel[] = \"" << channel.channel << "\";\n\n";
+    for (const Call& call : channel.calls) {
+      const std::string type = UpperFirst(call.name);
+      EmitCppStruct(out, type + "Args", call.args, true);
+      EmitCppStruct(out, type + "Result", call.results, false);
+      out << "\n";
+    }
+
+    out << "// Implemented by the runner. Arguments point into the message and "
+           "are\n// only valid during the call. Return false with |error| set "
+           "to reply\n// with an error.\n";
+    out << "class Handler {\n public:\n  virtual ~Handler() = default;\n\n";
+    for (const Call& call : channel.calls) {
+      const std::string type = UpperFirst(call.name);
+      out << "  virtual bool " << type << "(\n"
+          << "      const " << type << "Args& args,\n"
+          << "      " << type << "Result* result,\n"
+          << "      FastError* error) = 0;\n";
+    }
+    out << "};\n\n";
+
+    out << "// Decodes |message|, runs the handler and returns the reply, "
+           "which is\n// empty for calls this version does not know.\n";
+    out << "inline std::vector<uint8_t> Dispatch(Handler* handler,\n"
+           "                                     const uint8_t* message,\n"
+           "                                     size_t size) {\n";
+    out << "  FastReader reader(message, size);\n"
+           "  uint8_t magic = 0;\n  uint8_t version = 0;\n  uint8_t call = 0;\n"
+           "  if (!reader.ReadUint8(&magic) || magic != kFastCallMagic ||\n"
+           "      !reader.ReadUint8(&version) || !reader.ReadUint8(&call)) {\n"
+           "    return FastErrorReply({\"BAD_MESSAGE\", \"not a fast-path "
+           "call\"});\n  }\n"
+           "  if (version != kVersion) {\n"
+           "    return FastErrorReply({\"VERSION_MISMATCH\",\n"
+           "                           \"expected version \" + "
+           "std::to_string(kVersion)});\n  }\n"
+           "  FastError error;\n  FastWriter writer;\n"
+           "  switch (call) {\n";
+    for (const Call& call : channel.calls) {
+      const std::string type = UpperFirst(call.name);
+      out << "    case " << call.id << ": {\n";
+      out << "      " << type << "Args args;\n";
+      EmitCppReads(out, call.args, "args.", "      ");
+      out << "      if (!reader.AtEnd()) {\n"
+          << "        return FastErrorReply({\"INVALID_ARGS\", \"" << call.name
+          << "\"});\n      }\n";
+      out << "      " << type << "Result result;\n";
+      out << "      if (!handler->" << type << "(args, &result, &error)) {\n"
+          << "        return FastErrorReply(error);\n      }\n";
+      out << "      writer.WriteUint8(kFastReplySuccess);\n";
+      EmitCppWrites(out, call.results, "result.", "      ");
+      out << "      return writer.Take();\n    }\n";
+    }
+    out << "  }\n  return {};\n}\n\n";
+
+    out << "// Client side, as in Dart; for tests and benchmarks.\n";
+    for (const Call& call : channel.calls) {
+      const std::string type = UpperFirst(call.name);
+      out << "inline std::vector<uint8_t> Encode" << type << "(\n"
+          << "    const " << type << "Args& args) {\n";
+      out << "  FastWriter writer;\n"
+             "  writer.WriteUint8(kFastCallMagic);\n"
+             "  writer.WriteUint8(kVersion);\n"
+          << "  writer.WriteUint8(" << call.id << ");\n";
+      EmitCppWrites(out, call.args, "args.", "  ");
+      out << "  return writer.Take();\n}\n\n";
+
+      out << "inline bool Decode" << type << "Reply(const uint8_t* reply,\n"
+          << "    size_t size,\n"
+          << "    " << type << "Result* result,\n"
+          << "    FastError* error) {\n";
+      out << "  FastReader reader(reply, size);\n"
+             "  uint8_t status = 0;\n"
+             "  if (!reader.ReadUint8(&status)) {\n"
+             "    error->code = \"NOT_IMPLEMENTED\";\n    return false;\n  }\n"
+             "  if (status != kFastReplySuccess) {\n"
+             "    reader.ReadString(&error->code);\n"
+             "    reader.ReadString(&error->message);\n"
+             "    return false;\n  }\n";
+      EmitCppReads(out, call.results, "result->", "  ");
+      out << "  if (!reader.AtEnd()) {\n"
+             "    error->code = \"BAD_REPLY\";\n    return false;\n  }\n"
+             "  return true;\n}\n\n";
+    }
+    out << "}  // namespace " << SnakeCase(channel.name) << "\n";
+  }
+  out << "\n}  // namespace fast_messages\n\n#endif  // " << guard << "\n";
+  return out.str();
+}
+
+// Dart -------------------------------------------------------------------
+
+std::string DartType(const std::string& type) {
+  if (type == "bool") return "bool";
+  if (type == "int32" || type == "int64") return "int";
+  if (type == "float64") return "double";
+  if (type == "string") return "String";
+  return "Uint8List";
+}
+
+std::string DartResultType(const Call& call) {
+  if (call.results.empty()) {
+    return "void";
+  }
+  if (call.results.size() == 1) {
+    return DartType(call.results[0].type);
+  }
+  std::string type = "({";
+  for (size_t i = 0; i < call.results.size(); i++) {
+    type += (i > 0 ? ", " : "") + DartType(call.results[i].type) + " " +
+            call.results[i].name;
+  }
+  return type + "})";
+}
+
+std::string GenerateDart(const Schema& schema,
+                         const std::string& schema_path) {
+  std::ostringstream out;
+  out << "// Generated by linux/native/tools/ss_codec_gen.cc from\n// "
+      << schema_path << ". Do not edit.\n\n";
+  bool uses_bytes = false;
+  for (const Channel& channel : schema.channels) {
+    for (const Call& call : channel.calls) {
+      for (const auto* fields : {&call.args, &call.results}) {
+        for (const Field& field : *fields) {
+          uses_bytes |= field.type == "bytes";
+        }
+      }
+    }
+  }
+  if (uses_bytes) {
+    out << "import 'dart:typed_data';\n";
+  }
+  out << "import 'package:flutter/services.dart';\n"
+         "import 'fast_codec.dart';\n\n";
+  out << "const int fastMessagesVersion = " << schema.version << ";\n";
+
+  for (const Channel& channel : schema.channels) {
+    const std::string class_name = channel.name + "FastChannel";
+    out << "\n/// Client for `" << channel.channel << "`.\n";
+    out << "class " << class_name << " {\n";
+    out << "  static const name = '" << channel.channel << "';\n\n";
+    out << "  final BinaryMessenger? _messenger;\n\n";
+    out << "  const " << class_name << "([this._messenger]);\n\n";
+    out << "  BinaryMessenger get _binaryMessenger =>\n"
+           "      _messenger ?? "
+           "ServicesBinding.instance.defaultBinaryMessenger;\n";
+    for (const Call& call : channel.calls) {
+      out << "\n  Future<" << DartResultType(call) << "> " << call.name << "(";
+      for (size_t i = 0; i < call.args.size(); i++) {
+        out << (i > 0 ? ", " : "") << DartType(call.args[i].type) << " "
+            << call.args[i].name;
+      }
+      out << ") async {\n";
+      out << "    final writer = FastWriter.forCall(fastMessagesVersion, "
+          << call.id << ")";
+      for (const Field& field : call.args) {
+        out << "\n      ..write" << CppMethod(field.type) << "(" << field.name
+            << ")";
+      }
+      out << ";\n";
+      out << "    final reader = await fastCall(_binaryMessenger, name, "
+             "writer);\n";
+      for (const Field& field : call.results) {
+        out << "    final " << field.name << " = reader.read"
+            << CppMethod(field.type) << "();\n";
+      }
+      out << "    reader.expectEnd();\n";
+      if (call.results.size() == 1) {
+        out << "    return " << call.results[0].name << ";\n";
+      } else if (call.results.size() > 1) {
+        out << "    return (";
+        for (size_t i = 0; i < call.results.size(); i++) {
+          out << (i > 0 ? ", " : "") << call.results[i].name << ": "
+              << call.results[i].name;
+        }
+        out << ");\n";
+      }
+      out << "  }\n";
+    }
+    out << "}\n";
+  }
+  return out.str();
+}
+
+bool ReadFile(const std::string& path, std::string* text) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  std::ostringstream buffer;
+  buffer << in.rdbuf();
+  *text = buffer.str();
+  return true;
+}
+
+bool WriteFile(const std::string& path, const std::string& text) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out << text;
+  return static_cast<bool>(out);
+}
+
+// NATIVE_CODEC_FAST_MESSAGES_G_H_ for ".../codec/fast_messages.g.h".
+std::string GuardFor(const std::string& header_path) {
+  size_t start = header_path.rfind('/');
+  start = header_path.rfind('/', start == std::string::npos || start == 0
+                                     ? std::string::npos
+                                     : start - 1);
+  std::string relative =
+      start == std::string::npos ? header_path : header_path.substr(start + 1);
+  std::string guard = "NATIVE_";
+  for (char c : relative) {
+    guard += isalnum(static_cast<unsigned char>(c))
+                 ? static_cast<char>(toupper(c))
+                 : '_';
+  }
+  return guard + "_";
+}
+
+// Path as written in the generated comments: relative to linux/native.
+std::string DisplayPath(const std::string& path) {
+  const std::string marker = "linux/native/";
+  size_t found = path.rfind(marker);
+  return found == std::string::npos ? path : path.substr(found + marker.size());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 4) {
+    fprintf(stderr, "usage: ss_codec_gen SCHEMA CPP_HEADER DART_FILE\n");
+    return 2;
+  }
+  std::string text;
+  if (!ReadFile(argv[1], &text)) {
+    fprintf(stderr, "cannot read %s\n", argv[1]);
+    return 1;
+  }
+  Schema schema;
+  std::string error;
+  if (!Parser(text).Parse(&schema, &error)) {
+    fprintf(stderr, "%s: %s\n", argv[1], error.c_str());
+    return 1;
+  }
+  const std::string schema_path = DisplayPath(argv[1]);
+  const std::string cpp = GenerateCpp(schema, schema_path, GuardFor(argv[2]));
+  const std::string dart = GenerateDart(schema, "linux/native/" + schema_path);
+  if (!WriteFile(argv[2], cpp) || !WriteFile(argv[3], dart)) {
+    fprintf(stderr, "cannot write the outputs\n");
+    return 1;
+  }
+  return 0;
+}
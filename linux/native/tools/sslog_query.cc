@@ -0,0 +1,187 @@
+// Command-line reader for the binary log archive.
+//
+//   sslog_query [options] [log directory]
+//
+//   --since T       Only records at or after T.
+//   --until T       Only records at or before T.
+//   --level L       Minimum level: trace, debug, info, warn, error, fatal.
+//   --subsystem S   Comma-separated subsystems, e.g. api,timer.
+//   --grep TEXT     Only messages containing TEXT.
+//   --limit N       Stop after N records.
+//   --stats         Print index and scan statistics to stderr.
+//
+// T is either relative to now ("90s", "30m", "2h", "7d") or a UTC time
+// "YYYY-MM-DDTHH:MM:SS". The directory defaults to the app's log folder.
+
+#include <sys/time.h>
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+#include "logging/log_query.h"
+#include "logging/log_reader.h"
+
+namespace {
+
+uint64_t NowMicros() {
+  struct timeval now;
+  gettimeofday(&now, nullptr);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000 + now.tv_usec;
+}
+
+bool ParseTime(const char* text, uint64_t* out_us) {
+  char* end = nullptr;
+  unsigned long long amount = strtoull(text, &end, 10);
+  if (end != text && end[0] != '\0' && end[1] == '\0') {
+    uint64_t unit;
+    switch (end[0]) {
+      case 's':
+        unit = 1;
+        break;
+      case 'm':
+        unit = 60;
+        break;
+      case 'h':
+        unit = 3600;
+        break;
+      case 'd':
+        unit = 86400;
+        break;
+      default:
+        return false;
+    }
+    uint64_t delta = amount * unit * 1000000;
+    uint64_t now = NowMicros();
+    *out_us = delta < now ? now - delta : 0;
+    return true;
+  }
+  struct tm utc;
+  std::memset(&utc, 0, sizeof(utc));
+  const char* rest = strptime(text, "%Y-%m-%dT%H:%M:%S", &utc);
+  if (rest == nullptr || (*rest != '\0' && std::strcmp(rest, "Z") != 0)) {
+    return false;
+  }
+  *out_us = static_cast<uint64_t>(timegm(&utc)) * 1000000;
+  return true;
+}
+
+bool ParseLevel(const char* text, LogLevel* level) {
+  static const char* const kNames[] = {"trace", "debug", "info",
+                                       "warn",  "error", "fatal"};
+  for (int i = 0; i < 6; i++) {
+    if (std::strcmp(text, kNames[i]) == 0) {
+      *level = static_cast<LogLevel>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string DefaultDirectory() {
+  const char* data_home = getenv("XDG_DATA_HOME");
+  std::string base;
+  if (data_home != nullptr && data_home[0] != '\0') {
+    base = data_home;
+  } else {
+    const char* home = getenv("HOME");
+    base = std::string(home != nullptr ? home : "") + "/.local/share";
+  }
+  return base + "/com.example.silver_stone/logs";
+}
+
+void PrintEntry(const LogEntry& entry) {
+  time_t seconds = static_cast<time_t>(entry.timestamp_us / 1000000);
+  struct tm utc;
+  gmtime_r(&seconds, &utc);
+  char stamp[32];
+  strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", &utc);
+  printf("%s.%06" PRIu64 "Z %-5s %-8s [%u] %s\n", stamp,
+         entry.timestamp_us % 1000000, LogLevelName(entry.level),
+         entry.subsystem.c_str(), entry.thread_id, entry.message.c_str());
+}
+
+int Usage(const char* program) {
+  fprintf(stderr,
+          "usage: %s [--since T] [--until T] [--level L] [--subsystem S]\n"
+          "          [--grep TEXT] [--limit N] [--stats] [directory]\n",
+          program);
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  LogQuery query;
+  std::string directory = DefaultDirectory();
+  uint64_t limit = UINT64_MAX;
+  bool print_stats = false;
+
+  for (int i = 1; i < argc; i++) {
+    std::string flag = argv[i];
+    bool has_value = i + 1 < argc;
+    if (flag == "--stats") {
+      print_stats = true;
+    } else if (flag == "--since" && has_value) {
+      if (!ParseTime(argv[++i], &query.from_us)) {
+        return Usage(argv[0]);
+      }
+    } else if (flag == "--until" && has_value) {
+      if (!ParseTime(argv[++i], &query.to_us)) {
+        return Usage(argv[0]);
+      }
+    } else if (flag == "--level" && has_value) {
+      if (!ParseLevel(argv[++i], &query.min_level)) {
+        return Usage(argv[0]);
+      }
+    } else if (flag == "--subsystem" && has_value) {
+      std::string list = argv[++i];
+      size_t start = 0;
+      while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        if (comma == std::string::npos) {
+          comma = list.size();
+        }
+        if (comma > start) {
+          query.subsystems.push_back(list.substr(start, comma - start));
+        }
+        start = comma + 1;
+      }
+    } else if (flag == "--grep" && has_value) {
+      query.text = argv[++i];
+    } else if (flag == "--limit" && has_value) {
+      limit = strtoull(argv[++i], nullptr, 10);
+    } else if (!flag.empty() && flag[0] != '-') {
+      directory = flag;
+    } else {
+      return Usage(argv[0]);
+    }
+  }
+
+  auto started = std::chrono::steady_clock::now();
+  LogQueryCursor cursor(directory, query);
+  LogEntry entry;
+  uint64_t printed = 0;
+  while (printed < limit && cursor.Next(&entry)) {
+    PrintEntry(entry);
+    printed++;
+  }
+
+  if (print_stats) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started);
+    const LogQueryStats& stats = cursor.stats();
+    fprintf(stderr,
+            "%u segments (%u skipped by index), %u blocks inflated, "
+            "%u skipped, %" PRIu64 " records scanned, %" PRIu64
+            " matched in %.3f ms\n",
+            stats.segments, stats.segments_skipped, stats.blocks_inflated,
+            stats.blocks_skipped, stats.records_scanned, stats.records_matched,
+            elapsed.count() / 1000.0);
+  }
+  return 0;
+}
@@ -0,0 +1,178 @@
+#include "tracing/chrome_trace.h"
+
+#include <errno.h>
+#include <unistd.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+#include "common/buffered_file.h"
+
+namespace {
+
+void AppendJsonString(std::string* out, const std::string& value) {
+  out->push_back('"');
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      out->push_back('\\');
+      out->push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out->append(escaped);
+    } else {
+      out->push_back(c);
+    }
+  }
+  out->push_back('"');
+}
+
+char PhaseLetter(TracePhase phase) {
+  switch (phase) {
+    case TracePhase::kBegin:
+      return 'B';
+    case TracePhase::kEnd:
+      return 'E';
+    case TracePhase::kComplete:
+      return 'X';
+    case TracePhase::kCounter:
+      return 'C';
+    case TracePhase::kInstant:
+      return 'i';
+    case TracePhase::kAsyncBegin:
+      return 'b';
+    case TracePhase::kAsyncEnd:
+      return 'e';
+  }
+  return 'i';
+}
+
+// Quoted, escaped strings by interned id.
+class NameCache {
+ public:
+  const std::string& Get(uint32_t id) {
+    auto it = names_.find(id);
+    if (it != names_.end()) {
+      return it->second;
+    }
+    std::string text;
+    if (!Tracer::LookupString(id, &text)) {
+      text = "?";
+    }
+    std::string quoted;
+    AppendJsonString(&quoted, text);
+    return names_.emplace(id, std::move(quoted)).first->second;
+  }
+
+ private:
+  std::unordered_map<uint32_t, std::string> names_;
+};
+
+void AppendMetadata(std::string* out, const char* kind, int pid,
+                    uint32_t tid, const std::string& name) {
+  char buffer[128];
+  snprintf(buffer, sizeof(buffer),
+           "{\"ph\":\"M\",\"name\":\"%s\",\"pid\":%d,\"tid\":%" PRIu32
+           ",\"args\":{\"name\":",
+           kind, pid, tid);
+  out->append(buffer);
+  AppendJsonString(out, name);
+  out->append("}}");
+}
+
+void AppendEvent(std::string* out, NameCache* names, int pid, uint32_t tid,
+                 const TraceEvent& event) {
+  char buffer[160];
+  out->append("{\"ph\":\"");
+  out->push_back(PhaseLetter(event.phase));
+  out->append("\",\"cat\":");
+  out->append(names->Get(event.category_id));
+  out->append(",\"name\":");
+  out->append(names->Get(event.name_id));
+  // Microseconds, keeping the nanoseconds as decimals.
+  snprintf(buffer, sizeof(buffer),
+           ",\"ts\":%" PRIu64 ".%03u,\"pid\":%d,\"tid\":%" PRIu32,
+           event.timestamp_ns / 1000,
+           static_cast<unsigned>(event.timestamp_ns % 1000), pid, tid);
+  out->append(buffer);
+
+  switch (event.phase) {
+    case TracePhase::kComplete:
+      snprintf(buffer, sizeof(buffer), ",\"dur\":%" PRIu64 ".%03u",
+               event.payload / 1000,
+               static_cast<unsigned>(event.payload % 1000));
+      out->append(buffer);
+      break;
+    case TracePhase::kCounter: {
+      double value;
+      std::memcpy(&value, &event.payload, sizeof(value));
+      snprintf(buffer, sizeof(buffer), ",\"args\":{\"value\":%.17g}", value);
+      out->append(buffer);
+      break;
+    }
+    case TracePhase::kInstant:
+      out->append(",\"s\":\"t\"");
+      break;
+    case TracePhase::kAsyncBegin:
+    case TracePhase::kAsyncEnd:
+      snprintf(buffer, sizeof(buffer), ",\"id\":\"0x%" PRIx64 "\"",
+               event.payload);
+      out->append(buffer);
+      break;
+    case TracePhase::kBegin:
+    case TracePhase::kEnd:
+      break;
+  }
+  out->push_back('}');
+}
+
+}  // namespace
+
+bool WriteChromeTrace(const std::string& path,
+                      const std::vector<TraceThread>& threads,
+                      const TraceStats& stats) {
+  BufferedFile file;
+  if (!file.Open(path)) {
+    return false;
+  }
+
+  const int pid = static_cast<int>(getpid());
+  NameCache names;
+  std::string chunk;
+  char buffer[128];
+  snprintf(buffer, sizeof(buffer),
+           "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"events_overwritten\":"
+           "%" PRIu64 "},\"traceEvents\":[\n",
+           stats.events_overwritten);
+  chunk.append(buffer);
+  AppendMetadata(&chunk, "process_name", pid, pid,
+                 program_invocation_short_name);
+
+  for (const TraceThread& thread : threads) {
+    if (!thread.name.empty()) {
+      chunk.append(",\n");
+      AppendMetadata(&chunk, "thread_name", pid, thread.thread_id,
+                     thread.name);
+    }
+    for (const TraceEvent& event : thread.events) {
+      chunk.append(",\n");
+      AppendEvent(&chunk, &names, pid, thread.thread_id, event);
+      if (chunk.size() >= 32 * 1024) {
+        if (!file.Write(chunk)) {
+          file.Abort();
+          return false;
+        }
+        chunk.clear();
+      }
+    }
+  }
+  chunk.append("\n]}\n");
+
+  if (!file.Write(chunk) || !file.Commit()) {
+    file.Abort();
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,16 @@
+#ifndef NATIVE_TRACING_CHROME_TRACE_H_
+#define NATIVE_TRACING_CHROME_TRACE_H_
+
+#include <string>
+#include <vector>
+
+#include "tracing/tracer.h"
+
+// Writes |threads| as Chrome trace-event JSON ("JSON Object Format"), which
+// both chrome://tracing and ui.perfetto.dev open. Names are resolved through
+// Tracer::LookupString(). The file only appears once it is complete.
+bool WriteChromeTrace(const std::string& path,
+                      const std::vector<TraceThread>& threads,
+                      const TraceStats& stats);
+
+#endif  // NATIVE_TRACING_CHROME_TRACE_H_
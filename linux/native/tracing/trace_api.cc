@@ -0,0 +1,76 @@
+#include "tracing/trace_api.h"
+
+#include "tracing/tracer.h"
+
+void ss_trace_start(void) {
+  Tracer::Get().Start();
+}
+
+void ss_trace_stop(void) {
+  Tracer::Get().Stop();
+}
+
+bool ss_trace_enabled(void) {
+  return Tracer::Get().enabled();
+}
+
+uint32_t ss_trace_intern(const char* text) {
+  return text != nullptr ? Tracer::Intern(text) : 0;
+}
+
+int64_t ss_trace_now_ns(void) {
+  return static_cast<int64_t>(Tracer::NowNs());
+}
+
+void ss_trace_begin(uint32_t category_id, uint32_t name_id) {
+  Tracer::Get().Begin(category_id, name_id);
+}
+
+void ss_trace_end(uint32_t category_id, uint32_t name_id) {
+  Tracer::Get().End(category_id, name_id);
+}
+
+void ss_trace_complete(uint32_t category_id, uint32_t name_id,
+                       int64_t start_ns, int64_t duration_ns) {
+  if (start_ns < 0 || duration_ns < 0) {
+    return;
+  }
+  Tracer::Get().Complete(category_id, name_id, start_ns, duration_ns);
+}
+
+void ss_trace_counter(uint32_t category_id, uint32_t name_id, double value) {
+  Tracer::Get().Counter(category_id, name_id, value);
+}
+
+void ss_trace_instant(uint32_t category_id, uint32_t name_id) {
+  Tracer::Get().Instant(category_id, name_id);
+}
+
+void ss_trace_async_begin(uint32_t category_id, uint32_t name_id,
+                          uint64_t id) {
+  Tracer::Get().AsyncBegin(category_id, name_id, id);
+}
+
+void ss_trace_async_end(uint32_t category_id, uint32_t name_id, uint64_t id) {
+  Tracer::Get().AsyncEnd(category_id, name_id, id);
+}
+
+void ss_trace_set_thread_name(const char* name) {
+  if (name != nullptr) {
+    Tracer::Get().SetThreadName(name);
+  }
+}
+
+bool ss_trace_write_chrome_json(const char* path, SsTraceStats* stats) {
+  if (path == nullptr) {
+    return false;
+  }
+  TraceStats totals;
+  bool ok = Tracer::Get().WriteChromeTrace(path, &totals);
+  if (stats != nullptr) {
+    stats->events = totals.events;
+    stats->events_overwritten = totals.events_overwritten;
+    stats->threads = totals.threads;
+  }
+  return ok;
+}
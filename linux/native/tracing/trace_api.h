@@ -0,0 +1,61 @@
+#ifndef NATIVE_TRACING_TRACE_API_H_
+#define NATIVE_TRACING_TRACE_API_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/native_export.h"
+
+// C interface to the process-wide Tracer, for the runner and for Dart
+// (lib/native/native_trace_bindings.dart). Category and name ids come from
+// ss_trace_intern(); every recording call is a no-op while no session runs.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Mirrors TraceStats.
+typedef struct {
+  uint64_t events;
+  uint64_t events_overwritten;
+  uint32_t threads;
+} SsTraceStats;
+
+SS_EXPORT void ss_trace_start(void);
+SS_EXPORT void ss_trace_stop(void);
+SS_EXPORT bool ss_trace_enabled(void);
+
+SS_EXPORT uint32_t ss_trace_intern(const char* text);
+
+// CLOCK_MONOTONIC, the clock every event is stamped with.
+SS_EXPORT int64_t ss_trace_now_ns(void);
+
+SS_EXPORT void ss_trace_begin(uint32_t category_id, uint32_t name_id);
+SS_EXPORT void ss_trace_end(uint32_t category_id, uint32_t name_id);
+SS_EXPORT void ss_trace_complete(uint32_t category_id,
+                                 uint32_t name_id,
+                                 int64_t start_ns,
+                                 int64_t duration_ns);
+SS_EXPORT void ss_trace_counter(uint32_t category_id,
+                                uint32_t name_id,
+                                double value);
+SS_EXPORT void ss_trace_instant(uint32_t category_id, uint32_t name_id);
+SS_EXPORT void ss_trace_async_begin(uint32_t category_id,
+                                    uint32_t name_id,
+                                    uint64_t id);
+SS_EXPORT void ss_trace_async_end(uint32_t category_id,
+                                  uint32_t name_id,
+                                  uint64_t id);
+
+SS_EXPORT void ss_trace_set_thread_name(const char* name);
+
+// Writes what the current or last session recorded to |path| as Chrome
+// trace JSON. |stats| may be null.
+SS_EXPORT bool ss_trace_write_chrome_json(const char* path,
+                                          SsTraceStats* stats);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // NATIVE_TRACING_TRACE_API_H_
@@ -0,0 +1,82 @@
+#include "tracing/trace_buffer.h"
+
+#include <algorithm>
+
+#include "memory/process_memory.h"
+
+namespace {
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+}  // namespace
+
+TraceBuffer::TraceBuffer(uint32_t thread_id, size_t capacity)
+    : thread_id_(thread_id),
+      mask_(RoundUpToPowerOfTwo(std::max<size_t>(capacity, 2)) - 1),
+      slots_(new Slot[mask_ + 1]) {}
+
+void TraceBuffer::Clear() {
+  floor_.store(next_.load(std::memory_order_acquire),
+               std::memory_order_relaxed);
+}
+
+size_t TraceBuffer::ReleaseMemory() {
+  Clear();
+  return ReleasePages(slots_.get(), (mask_ + 1) * sizeof(Slot));
+}
+
+uint64_t TraceBuffer::Snapshot(std::vector<TraceEvent>* out) const {
+  const uint64_t capacity = mask_ + 1;
+  const uint64_t floor = floor_.load(std::memory_order_relaxed);
+  const uint64_t end = next_.load(std::memory_order_acquire);
+  uint64_t begin = end > capacity ? std::max(floor, end - capacity) : floor;
+  if (begin >= end) {
+    return 0;
+  }
+
+  const size_t first = out->size();
+  out->reserve(first + (end - begin));
+  for (uint64_t i = begin; i < end; i++) {
+    const Slot& slot = slots_[i & mask_];
+    TraceEvent event;
+    event.timestamp_ns = slot.timestamp_ns.load(std::memory_order_relaxed);
+    event.payload = slot.payload.load(std::memory_order_relaxed);
+    uint64_t meta = slot.meta.load(std::memory_order_relaxed);
+    event.name_id = static_cast<uint32_t>(meta >> 32);
+    event.category_id = static_cast<uint32_t>(meta >> 8) & 0xffffff;
+    event.phase = static_cast<TracePhase>(meta & 0xff);
+    out->push_back(event);
+  }
+
+  // Any slot below |claimed| - capacity may have been rewritten while it
+  // was being copied.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const uint64_t claimed = claimed_.load(std::memory_order_relaxed);
+  uint64_t valid_begin = begin;
+  if (claimed > capacity) {
+    valid_begin = std::max(begin, claimed - capacity);
+  }
+  valid_begin = std::min(valid_begin, end);
+  if (valid_begin > begin) {
+    out->erase(out->begin() + first,
+               out->begin() + first + (valid_begin - begin));
+  }
+  // Everything between the floor and the first kept event was lost.
+  return valid_begin - floor;
+}
+
+void TraceBuffer::set_thread_name(const std::string& name) {
+  std::lock_guard<std::mutex> lock(name_mutex_);
+  thread_name_ = name;
+}
+
+std::string TraceBuffer::thread_name() const {
+  std::lock_guard<std::mutex> lock(name_mutex_);
+  return thread_name_;
+}
@@ -0,0 +1,98 @@
+#ifndef NATIVE_TRACING_TRACE_BUFFER_H_
+#define NATIVE_TRACING_TRACE_BUFFER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Event types, named after their Chrome trace-event "ph" letters.
+enum class TracePhase : uint8_t {
+  kBegin = 0,       // B
+  kEnd = 1,         // E
+  kComplete = 2,    // X, payload is the duration in ns.
+  kCounter = 3,     // C, payload holds the double value's bits.
+  kInstant = 4,     // i
+  kAsyncBegin = 5,  // b, payload is the async id.
+  kAsyncEnd = 6,    // e, payload is the async id.
+};
+
+struct TraceEvent {
+  uint64_t timestamp_ns = 0;  // CLOCK_MONOTONIC.
+  uint64_t payload = 0;
+  uint32_t category_id = 0;  // Interned through Tracer::Intern().
+  uint32_t name_id = 0;
+  TracePhase phase = TracePhase::kInstant;
+};
+
+// The events of one thread. Once full, the oldest are overwritten.
+//
+// Only the owning thread appends, with no lock and no read-modify-write.
+// Snapshot() may run on any thread meanwhile: it copies the slots and then
+// drops whatever the writer could have lapped during the copy.
+class TraceBuffer {
+ public:
+  // |capacity| is rounded up to a power of two.
+  TraceBuffer(uint32_t thread_id, size_t capacity);
+
+  TraceBuffer(const TraceBuffer&) = delete;
+  TraceBuffer& operator=(const TraceBuffer&) = delete;
+
+  // Owning thread only.
+  void Append(const TraceEvent& event) {
+    uint64_t index = next_.load(std::memory_order_relaxed);
+    claimed_.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Slot& slot = slots_[index & mask_];
+    slot.timestamp_ns.store(event.timestamp_ns, std::memory_order_relaxed);
+    slot.payload.store(event.payload, std::memory_order_relaxed);
+    slot.meta.store(PackMeta(event), std::memory_order_relaxed);
+    next_.store(index + 1, std::memory_order_release);
+  }
+
+  // Forgets everything appended so far. Any thread.
+  void Clear();
+
+  // Clear()s and gives the slots' pages back to the kernel until they are
+  // next written. Returns the bytes released. Only while nothing appends.
+  size_t ReleaseMemory();
+
+  // Appends the events kept since the last Clear() to |out|, oldest first,
+  // and returns how many of those were overwritten before they could be
+  // copied. Any thread.
+  uint64_t Snapshot(std::vector<TraceEvent>* out) const;
+
+  uint32_t thread_id() const { return thread_id_; }
+  size_t capacity() const { return mask_ + 1; }
+
+  void set_thread_name(const std::string& name);
+  std::string thread_name() const;
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> timestamp_ns{0};
+    std::atomic<uint64_t> payload{0};
+    std::atomic<uint64_t> meta{0};  // Name id, category id and phase.
+  };
+
+  static uint64_t PackMeta(const TraceEvent& event) {
+    return static_cast<uint64_t>(event.name_id) << 32 |
+           static_cast<uint64_t>(event.category_id & 0xffffff) << 8 |
+           static_cast<uint64_t>(event.phase);
+  }
+
+  const uint32_t thread_id_;
+  const size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<uint64_t> next_{0};     // Published events.
+  std::atomic<uint64_t> claimed_{0};  // Slots the writer may be filling.
+  std::atomic<uint64_t> floor_{0};    // First index since Clear().
+
+  mutable std::mutex name_mutex_;
+  std::string thread_name_;
+};
+
+#endif  // NATIVE_TRACING_TRACE_BUFFER_H_
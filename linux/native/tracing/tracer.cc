@@ -0,0 +1,145 @@
+#include "tracing/tracer.h"
+
+#include <time.h>
+
+#include "common/thread_id.h"
+#include "logging/string_interner.h"
+#include "tracing/chrome_trace.h"
+
+namespace {
+
+StringInterner& Interner() {
+  static StringInterner* interner = new StringInterner();
+  return *interner;
+}
+
+}  // namespace
+
+Tracer& Tracer::Get() {
+  // Leaked on purpose: threads may still record while statics are torn down.
+  static Tracer* tracer = new Tracer();
+  return *tracer;
+}
+
+uint32_t Tracer::Intern(const std::string& text) {
+  return Interner().Intern(text);
+}
+
+bool Tracer::LookupString(uint32_t id, std::string* text) {
+  return Interner().Lookup(id, text);
+}
+
+uint64_t Tracer::NowNs() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+void Tracer::Start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& buffer : buffers_) {
+    buffer->Clear();
+  }
+  collected_ = false;
+  enabled_.store(true, std::memory_order_release);
+}
+
+void Tracer::Stop() {
+  enabled_.store(false, std::memory_order_release);
+}
+
+void Tracer::Record(TracePhase phase, uint32_t category_id, uint32_t name_id,
+                    uint64_t timestamp_ns, uint64_t payload) {
+  TraceEvent event;
+  event.timestamp_ns = timestamp_ns;
+  event.payload = payload;
+  event.category_id = category_id;
+  event.name_id = name_id;
+  event.phase = phase;
+  CurrentBuffer()->Append(event);
+}
+
+TraceBuffer* Tracer::CurrentBuffer() {
+  static thread_local TraceBuffer* buffer = nullptr;
+  if (buffer != nullptr) {
+    return buffer;
+  }
+
+  const uint32_t thread_id = CurrentThreadId();
+  std::lock_guard<std::mutex> lock(mutex_);
+  buffers_.push_back(
+      std::make_unique<TraceBuffer>(thread_id, buffer_capacity_.load()));
+  buffer = buffers_.back().get();
+  for (auto it = pending_names_.begin(); it != pending_names_.end(); ++it) {
+    if (it->first == thread_id) {
+      buffer->set_thread_name(it->second);
+      pending_names_.erase(it);
+      break;
+    }
+  }
+  return buffer;
+}
+
+void Tracer::SetThreadName(const std::string& name) {
+  const uint32_t thread_id = CurrentThreadId();
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& buffer : buffers_) {
+    if (buffer->thread_id() == thread_id) {
+      buffer->set_thread_name(name);
+      return;
+    }
+  }
+  for (auto& pending : pending_names_) {
+    if (pending.first == thread_id) {
+      pending.second = name;
+      return;
+    }
+  }
+  pending_names_.emplace_back(thread_id, name);
+}
+
+std::vector<TraceThread> Tracer::Collect(TraceStats* stats) const {
+  std::vector<TraceThread> threads;
+  TraceStats totals;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& buffer : buffers_) {
+    TraceThread thread;
+    uint64_t overwritten = buffer->Snapshot(&thread.events);
+    totals.events_overwritten += overwritten;
+    if (thread.events.empty()) {
+      continue;
+    }
+    thread.thread_id = buffer->thread_id();
+    thread.name = buffer->thread_name();
+    totals.events += thread.events.size();
+    totals.threads++;
+    threads.push_back(std::move(thread));
+  }
+  if (stats != nullptr) {
+    *stats = totals;
+  }
+  collected_ = !enabled();
+  return threads;
+}
+
+size_t Tracer::ReleaseMemory() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (enabled() || !collected_) {
+    return 0;
+  }
+  size_t released = 0;
+  for (const auto& buffer : buffers_) {
+    released += buffer->ReleaseMemory();
+  }
+  return released;
+}
+
+bool Tracer::WriteChromeTrace(const std::string& path,
+                              TraceStats* stats) const {
+  TraceStats totals;
+  std::vector<TraceThread> threads = Collect(&totals);
+  if (stats != nullptr) {
+    *stats = totals;
+  }
+  return ::WriteChromeTrace(path, threads, totals);
+}
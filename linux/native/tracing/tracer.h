@@ -0,0 +1,179 @@
+#ifndef NATIVE_TRACING_TRACER_H_
+#define NATIVE_TRACING_TRACER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "tracing/trace_buffer.h"
+
+struct TraceStats {
+  uint64_t events = 0;
+  uint64_t events_overwritten = 0;
+  uint32_t threads = 0;
+};
+
+// Everything one thread recorded during a session.
+struct TraceThread {
+  uint32_t thread_id = 0;
+  std::string name;
+  std::vector<TraceEvent> events;
+};
+
+// Process-wide trace recorder shared by the runner, the native services and
+// Dart (through trace_api.h), so one timeline shows all of them.
+//
+// Each thread records into its own TraceBuffer, created the first time it
+// records while a session is running. While no session is running every
+// call returns after one relaxed load.
+class Tracer {
+ public:
+  static Tracer& Get();
+
+  // Interned ids are valid before Start() and across sessions.
+  static uint32_t Intern(const std::string& text);
+  static bool LookupString(uint32_t id, std::string* text);
+
+  static uint64_t NowNs();
+
+  // Starts a session, dropping whatever the previous one recorded.
+  void Start();
+  // Stops recording; the events stay available to Collect().
+  void Stop();
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  void Begin(uint32_t category_id, uint32_t name_id) {
+    if (enabled()) {
+      Record(TracePhase::kBegin, category_id, name_id, NowNs(), 0);
+    }
+  }
+  void End(uint32_t category_id, uint32_t name_id) {
+    if (enabled()) {
+      Record(TracePhase::kEnd, category_id, name_id, NowNs(), 0);
+    }
+  }
+  // A span measured by the caller, e.g. one that ended on another thread.
+  void Complete(uint32_t category_id, uint32_t name_id, uint64_t start_ns,
+                uint64_t duration_ns) {
+    if (enabled()) {
+      Record(TracePhase::kComplete, category_id, name_id, start_ns,
+             duration_ns);
+    }
+  }
+  void Counter(uint32_t category_id, uint32_t name_id, double value) {
+    if (enabled()) {
+      uint64_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      Record(TracePhase::kCounter, category_id, name_id, NowNs(), bits);
+    }
+  }
+  void Instant(uint32_t category_id, uint32_t name_id) {
+    if (enabled()) {
+      Record(TracePhase::kInstant, category_id, name_id, NowNs(), 0);
+    }
+  }
+  // Spans that may overlap on one thread (Dart futures, replies that arrive
+  // after the handler returned). |id| pairs the two ends.
+  void AsyncBegin(uint32_t category_id, uint32_t name_id, uint64_t id) {
+    if (enabled()) {
+      Record(TracePhase::kAsyncBegin, category_id, name_id, NowNs(), id);
+    }
+  }
+  void AsyncEnd(uint32_t category_id, uint32_t name_id, uint64_t id) {
+    if (enabled()) {
+      Record(TracePhase::kAsyncEnd, category_id, name_id, NowNs(), id);
+    }
+  }
+
+  // Labels the calling thread in the trace. Cheap enough to call whether
+  // or not a session is running.
+  void SetThreadName(const std::string& name);
+
+  // Copies what the current or last session recorded, one entry per thread
+  // that recorded anything.
+  std::vector<TraceThread> Collect(TraceStats* stats) const;
+
+  // Collect() written out as Chrome trace JSON.
+  bool WriteChromeTrace(const std::string& path, TraceStats* stats) const;
+
+  // Gives the buffers' memory back while no session runs and the last one
+  // has been collected. Returns the bytes released.
+  size_t ReleaseMemory();
+
+  // Per-thread capacity for buffers created from now on.
+  void set_buffer_capacity(size_t events) { buffer_capacity_ = events; }
+
+ private:
+  Tracer() = default;
+
+  void Record(TracePhase phase, uint32_t category_id, uint32_t name_id,
+              uint64_t timestamp_ns, uint64_t payload);
+  TraceBuffer* CurrentBuffer();
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<size_t> buffer_capacity_{16384};
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<TraceBuffer>> buffers_;
+  // Whether Collect() has run since the last Start().
+  mutable bool collected_ = false;
+  // Names set before the thread's first event.
+  std::vector<std::pair<uint32_t, std::string>> pending_names_;
+};
+
+// Records a B/E pair around the enclosing block.
+class TraceScope {
+ public:
+  TraceScope(uint32_t category_id, uint32_t name_id)
+      : category_id_(category_id), name_id_(name_id) {
+    Tracer& tracer = Tracer::Get();
+    if (tracer.enabled()) {
+      active_ = true;
+      tracer.Begin(category_id, name_id);
+    }
+  }
+  ~TraceScope() {
+    if (active_) {
+      Tracer::Get().End(category_id_, name_id_);
+    }
+  }
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  const uint32_t category_id_;
+  const uint32_t name_id_;
+  bool active_ = false;
+};
+
+#define SS_TRACE_CONCAT_INNER(a, b) a##b
+#define SS_TRACE_CONCAT(a, b) SS_TRACE_CONCAT_INNER(a, b)
+
+// Traces the enclosing block, e.g. SS_TRACE_SCOPE("export", "write batch").
+// Both strings are interned once per call site.
+#define SS_TRACE_SCOPE(category, name)                                     \
+  static const uint32_t SS_TRACE_CONCAT(ss_trace_category_, __LINE__) =    \
+      Tracer::Intern(category);                                            \
+  static const uint32_t SS_TRACE_CONCAT(ss_trace_name_, __LINE__) =        \
+      Tracer::Intern(name);                                                \
+  TraceScope SS_TRACE_CONCAT(ss_trace_scope_, __LINE__)(                   \
+      SS_TRACE_CONCAT(ss_trace_category_, __LINE__),                       \
+      SS_TRACE_CONCAT(ss_trace_name_, __LINE__))
+
+// Records a counter sample, e.g. SS_TRACE_COUNTER("log", "queued", n).
+#define SS_TRACE_COUNTER(category, name, value)                          \
+  do {                                                                   \
+    Tracer& ss_tracer = Tracer::Get();                                   \
+    if (ss_tracer.enabled()) {                                           \
+      static const uint32_t ss_category_id = Tracer::Intern(category);   \
+      static const uint32_t ss_name_id = Tracer::Intern(name);           \
+      ss_tracer.Counter(ss_category_id, ss_name_id, value);              \
+    }                                                                    \
+  } while (0)
+
+#endif  // NATIVE_TRACING_TRACER_H_
@@ -0,0 +1,54 @@
+#include "tray/tray_api.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "tray/tray_state.h"
+
+namespace {
+
+template <size_t N>
+void CopyString(const std::string& text, char (&out)[N]) {
+  size_t size = std::min(text.size(), N - 1);
+  // Back up to the start of a character.
+  while (size < text.size() && size > 0 &&
+         (static_cast<uint8_t>(text[size]) & 0xC0) == 0x80) {
+    size--;
+  }
+  std::memcpy(out, text.data(), size);
+  out[size] = '\0';
+}
+
+}  // namespace
+
+void ss_tray_set_visible(bool visible) {
+  TrayState::Get().SetVisible(visible);
+}
+
+void ss_tray_set_session(const char* project, int64_t started_at_ms) {
+  TrayState::Get().SetSession(project != nullptr ? project : "",
+                              started_at_ms);
+}
+
+bool ss_tray_has_indicator(void) {
+  return TrayState::Get().HasListener();
+}
+
+void ss_tray_set_listener(SsTrayListener listener, void* data) {
+  TrayState::Get().SetListener(listener, data);
+}
+
+uint64_t ss_tray_read(int64_t now_ms, SsTrayView* out) {
+  TrayStatus status;
+  const uint64_t generation = TrayState::Get().Read(&status);
+  const TrayView view = MakeTrayView(status, now_ms);
+  out->visible = status.visible;
+  out->running = status.running;
+  out->next_update_ms = view.next_update_ms;
+  CopyString(view.initials, out->initials);
+  CopyString(view.elapsed, out->elapsed);
+  CopyString(view.tooltip_title, out->tooltip_title);
+  CopyString(view.tooltip_body, out->tooltip_body);
+  return generation;
+}
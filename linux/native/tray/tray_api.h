@@ -0,0 +1,49 @@
+#ifndef NATIVE_TRAY_TRAY_API_H_
+#define NATIVE_TRAY_TRAY_API_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/native_export.h"
+
+// C interface to the tray state (tray/tray_state.h). Dart writes it; the
+// runner's indicator listens and reads.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*SsTrayListener)(void* data);
+
+// Mirrors TrayView, plus the visibility. Strings are UTF-8, NUL-terminated
+// and cut at a character boundary if too long.
+typedef struct {
+  bool visible;
+  bool running;
+  int64_t next_update_ms;
+  char initials[16];
+  char elapsed[16];
+  char tooltip_title[128];
+  char tooltip_body[64];
+} SsTrayView;
+
+SS_EXPORT void ss_tray_set_visible(bool visible);
+
+// |project| is UTF-8; null or empty means no timer runs.
+SS_EXPORT void ss_tray_set_session(const char* project,
+                                   int64_t started_at_ms);
+
+// Whether the runner draws the tray itself. Without it, Dart falls back to
+// the system_tray plugin.
+SS_EXPORT bool ss_tray_has_indicator(void);
+
+// Runner side. |listener| runs on the writer's thread after each change.
+SS_EXPORT void ss_tray_set_listener(SsTrayListener listener, void* data);
+// What to draw at |now_ms| (Unix epoch). Returns the state's generation.
+SS_EXPORT uint64_t ss_tray_read(int64_t now_ms, SsTrayView* out);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // NATIVE_TRAY_TRAY_API_H_
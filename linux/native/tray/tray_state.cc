@@ -0,0 +1,149 @@
+#include "tray/tray_state.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+constexpr int64_t kMinuteMs = 60 * 1000;
+
+// Length of the UTF-8 character starting at |text[i]|.
+size_t CharLength(std::string_view text, size_t i) {
+  const uint8_t lead = static_cast<uint8_t>(text[i]);
+  size_t length = 1;
+  if (lead >= 0xF0) {
+    length = 4;
+  } else if (lead >= 0xE0) {
+    length = 3;
+  } else if (lead >= 0xC0) {
+    length = 2;
+  }
+  return std::min(length, text.size() - i);
+}
+
+void AppendUpper(std::string_view text, size_t i, std::string* out) {
+  const size_t length = CharLength(text, i);
+  if (length == 1 && text[i] >= 'a' && text[i] <= 'z') {
+    out->push_back(static_cast<char>(text[i] - 'a' + 'A'));
+  } else {
+    out->append(text.substr(i, length));
+  }
+}
+
+}  // namespace
+
+TrayState& TrayState::Get() {
+  static TrayState* state = new TrayState();
+  return *state;
+}
+
+void TrayState::SetVisible(bool visible) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (status_.visible == visible) {
+    return;
+  }
+  status_.visible = visible;
+  Changed(std::move(lock));
+}
+
+void TrayState::SetSession(std::string_view project, int64_t started_at_ms) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const bool running = !project.empty();
+  if (status_.running == running && status_.project == project &&
+      status_.started_at_ms == started_at_ms) {
+    return;
+  }
+  status_.running = running;
+  status_.project.assign(project.data(), project.size());
+  status_.started_at_ms = running ? started_at_ms : 0;
+  Changed(std::move(lock));
+}
+
+uint64_t TrayState::Read(TrayStatus* out) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  *out = status_;
+  return generation_;
+}
+
+void TrayState::SetListener(Listener listener, void* data) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  listener_ = listener;
+  listener_data_ = data;
+}
+
+bool TrayState::HasListener() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return listener_ != nullptr;
+}
+
+void TrayState::Changed(std::unique_lock<std::mutex> lock) {
+  generation_++;
+  const Listener listener = listener_;
+  void* data = listener_data_;
+  lock.unlock();
+  if (listener != nullptr) {
+    listener(data);
+  }
+}
+
+std::string TrayInitials(std::string_view project) {
+  std::string initials;
+  int letters = 0;
+  size_t i = 0;
+  // First letters of the first two words.
+  while (i < project.size() && letters < 2) {
+    while (i < project.size() && (project[i] == ' ' || project[i] == '-')) {
+      i++;
+    }
+    if (i == project.size()) {
+      break;
+    }
+    AppendUpper(project, i, &initials);
+    letters++;
+    while (i < project.size() && project[i] != ' ' && project[i] != '-') {
+      i++;
+    }
+  }
+  if (letters == 1) {
+    // One word: its second character too.
+    size_t start = project.find_first_not_of(" -");
+    size_t second = start + CharLength(project, start);
+    if (second < project.size() && project[second] != ' ' &&
+        project[second] != '-') {
+      AppendUpper(project, second, &initials);
+    }
+  }
+  return initials;
+}
+
+std::string TrayElapsedLabel(int64_t elapsed_ms) {
+  const int64_t minutes = std::max<int64_t>(elapsed_ms, 0) / kMinuteMs;
+  char label[32];
+  snprintf(label, sizeof(label), "%lld:%02lld",
+           static_cast<long long>(minutes / 60),
+           static_cast<long long>(minutes % 60));
+  return label;
+}
+
+int64_t TrayNextUpdateDelayMs(int64_t elapsed_ms) {
+  if (elapsed_ms < 0) {
+    return -elapsed_ms;
+  }
+  return kMinuteMs - elapsed_ms % kMinuteMs;
+}
+
+TrayView MakeTrayView(const TrayStatus& status, int64_t now_ms) {
+  TrayView view;
+  if (!status.running) {
+    view.tooltip_title = "Silver Stone";
+    view.tooltip_body = "No timer running";
+    return view;
+  }
+  const int64_t elapsed_ms = now_ms - status.started_at_ms;
+  view.initials = TrayInitials(status.project);
+  view.elapsed = TrayElapsedLabel(elapsed_ms);
+  view.tooltip_title = status.project;
+  view.tooltip_body = view.elapsed + " elapsed";
+  view.next_update_ms = TrayNextUpdateDelayMs(elapsed_ms);
+  return view;
+}
@@ -0,0 +1,71 @@
+#ifndef NATIVE_TRAY_TRAY_STATE_H_
+#define NATIVE_TRAY_TRAY_STATE_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+// What the tray indicator shows: whether it is up, and the running timer.
+//
+// Dart writes it through dart:ffi when the window mode or the timer
+// changes; the runner's indicator (linux/runner/tray_indicator.cc) reads it
+// when told of a change and once a minute while a timer runs. Nothing is
+// sent over a platform channel, and nothing wakes up while no timer runs.
+
+struct TrayStatus {
+  bool visible = false;
+  bool running = false;
+  int64_t started_at_ms = 0;  // Unix epoch.
+  std::string project;
+};
+
+class TrayState {
+ public:
+  using Listener = void (*)(void* data);
+
+  static TrayState& Get();
+
+  void SetVisible(bool visible);
+  // An empty |project| means no timer runs.
+  void SetSession(std::string_view project, int64_t started_at_ms);
+
+  // Returns the generation, which every change bumps.
+  uint64_t Read(TrayStatus* out) const;
+
+  // Called on the writer's thread after each change; null to stop.
+  void SetListener(Listener listener, void* data);
+  bool HasListener() const;
+
+ private:
+  void Changed(std::unique_lock<std::mutex> lock);
+
+  mutable std::mutex mutex_;
+  TrayStatus status_;
+  uint64_t generation_ = 0;
+  Listener listener_ = nullptr;
+  void* listener_data_ = nullptr;
+};
+
+// Up to two letters for the icon: the first letters of the first two
+// words, or the first two of a single word, in upper case.
+std::string TrayInitials(std::string_view project);
+
+// Elapsed time at minute granularity, "h:mm".
+std::string TrayElapsedLabel(int64_t elapsed_ms);
+
+// Milliseconds until TrayElapsedLabel() changes.
+int64_t TrayNextUpdateDelayMs(int64_t elapsed_ms);
+
+// Everything the indicator draws for a status at one moment.
+struct TrayView {
+  std::string initials;  // Empty without a timer: the indicator shows a logo.
+  std::string elapsed;
+  std::string tooltip_title;
+  std::string tooltip_body;
+  int64_t next_update_ms = 0;  // 0 if the view does not change with time.
+};
+
+TrayView MakeTrayView(const TrayStatus& status, int64_t now_ms);
+
+#endif  // NATIVE_TRAY_TRAY_STATE_H_
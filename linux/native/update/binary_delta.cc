@@ -0,0 +1,531 @@
+#include "update/binary_delta.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "update/delta_kernels.h"
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'S', 'D', 'E', 'L', 'T', 'A', '1'};
+
+struct DeltaHeader {
+  uint64_t new_size;
+  uint64_t control_raw;
+  uint64_t control_compressed;
+  uint64_t diff_raw;
+  uint64_t diff_compressed;
+  uint64_t extra_raw;
+  uint64_t extra_compressed;
+};
+
+constexpr size_t kHeaderBytes = sizeof(kMagic) + 7 * sizeof(uint64_t);
+
+// Old and new files alike.
+constexpr uint64_t kMaxFileSize = std::numeric_limits<int32_t>::max();
+
+// deflate never shrinks data by more than this, so a stream claiming more
+// raw bytes per compressed byte is corrupt.
+constexpr uint64_t kMaxDeflateRatio = 1032;
+
+// Larsson-Sadakane suffix sorting, as in bsdiff. |index| ends up holding the
+// start offsets of all suffixes of |data| (including the empty one) in
+// sorted order.
+class SuffixSorter {
+ public:
+  SuffixSorter(const uint8_t* data, int32_t size)
+      : index_(size + 1), rank_(size + 1) {
+    Sort(data, size);
+  }
+
+  const std::vector<int32_t>& index() const { return index_; }
+
+ private:
+  void Sort(const uint8_t* data, int32_t size) {
+    int32_t* I = index_.data();
+    int32_t* V = rank_.data();
+    int32_t buckets[256] = {};
+    for (int32_t i = 0; i < size; i++) {
+      buckets[data[i]]++;
+    }
+    for (int i = 1; i < 256; i++) {
+      buckets[i] += buckets[i - 1];
+    }
+    for (int i = 255; i > 0; i--) {
+      buckets[i] = buckets[i - 1];
+    }
+    buckets[0] = 0;
+
+    for (int32_t i = 0; i < size; i++) {
+      I[++buckets[data[i]]] = i;
+    }
+    I[0] = size;
+    for (int32_t i = 0; i < size; i++) {
+      V[i] = buckets[data[i]];
+    }
+    V[size] = 0;
+    for (int i = 1; i < 256; i++) {
+      if (buckets[i] == buckets[i - 1] + 1) {
+        I[buckets[i]] = -1;
+      }
+    }
+    I[0] = -1;
+
+    for (int32_t h = 1; I[0] != -(size + 1); h += h) {
+      int32_t len = 0;
+      int32_t i = 0;
+      while (i < size + 1) {
+        if (I[i] < 0) {
+          len -= I[i];
+          i -= I[i];
+        } else {
+          if (len != 0) {
+            I[i - len] = -len;
+          }
+          len = V[I[i]] + 1 - i;
+          Split(i, len, h);
+          i += len;
+          len = 0;
+        }
+      }
+      if (len != 0) {
+        I[i - len] = -len;
+      }
+    }
+
+    for (int32_t i = 0; i < size + 1; i++) {
+      I[V[i]] = i;
+    }
+  }
+
+  void Split(int32_t start, int32_t len, int32_t h) {
+    int32_t* I = index_.data();
+    int32_t* V = rank_.data();
+    if (len < 16) {
+      int32_t j;
+      for (int32_t k = start; k < start + len; k += j) {
+        j = 1;
+        int32_t x = V[I[k] + h];
+        for (int32_t i = 1; k + i < start + len; i++) {
+          if (V[I[k + i] + h] < x) {
+            x = V[I[k + i] + h];
+            j = 0;
+          }
+          if (V[I[k + i] + h] == x) {
+            std::swap(I[k + j], I[k + i]);
+            j++;
+          }
+        }
+        for (int32_t i = 0; i < j; i++) {
+          V[I[k + i]] = k + j - 1;
+        }
+        if (j == 1) {
+          I[k] = -1;
+        }
+      }
+      return;
+    }
+
+    const int32_t x = V[I[start + len / 2] + h];
+    int32_t jj = 0;
+    int32_t kk = 0;
+    for (int32_t i = start; i < start + len; i++) {
+      if (V[I[i] + h] < x) {
+        jj++;
+      }
+      if (V[I[i] + h] == x) {
+        kk++;
+      }
+    }
+    jj += start;
+    kk += jj;
+
+    int32_t i = start;
+    int32_t j = 0;
+    int32_t k = 0;
+    while (i < jj) {
+      if (V[I[i] + h] < x) {
+        i++;
+      } else if (V[I[i] + h] == x) {
+        std::swap(I[i], I[jj + j]);
+        j++;
+      } else {
+        std::swap(I[i], I[kk + k]);
+        k++;
+      }
+    }
+    while (jj + j < kk) {
+      if (V[I[jj + j] + h] == x) {
+        j++;
+      } else {
+        std::swap(I[jj + j], I[kk + k]);
+        k++;
+      }
+    }
+
+    if (jj > start) {
+      Split(start, jj - start, h);
+    }
+    for (i = 0; i < kk - jj; i++) {
+      V[I[jj + i]] = kk - 1;
+    }
+    if (jj == kk - 1) {
+      I[jj] = -1;
+    }
+    if (start + len > kk) {
+      Split(kk, start + len - kk, h);
+    }
+  }
+
+  std::vector<int32_t> index_;
+  std::vector<int32_t> rank_;
+};
+
+int64_t MatchLength(const uint8_t* a, int64_t a_size, const uint8_t* b,
+                    int64_t b_size) {
+  return ActiveDeltaKernels().mismatch(a, b, std::min(a_size, b_size));
+}
+
+// Longest match for |target| among the sorted suffixes in [start, end].
+int64_t Search(const std::vector<int32_t>& index, const uint8_t* old_data,
+               int64_t old_size, const uint8_t* target, int64_t target_size,
+               int64_t start, int64_t end, int64_t* position) {
+  while (end - start >= 2) {
+    int64_t middle = start + (end - start) / 2;
+    int64_t offset = index[middle];
+    if (std::memcmp(old_data + offset, target,
+                    std::min(old_size - offset, target_size)) < 0) {
+      start = middle;
+    } else {
+      end = middle;
+    }
+  }
+  int64_t x = MatchLength(old_data + index[start], old_size - index[start],
+                          target, target_size);
+  int64_t y = MatchLength(old_data + index[end], old_size - index[end],
+                          target, target_size);
+  if (x > y) {
+    *position = index[start];
+    return x;
+  }
+  *position = index[end];
+  return y;
+}
+
+void AppendInt64(std::vector<uint8_t>* out, int64_t value) {
+  uint64_t bits = static_cast<uint64_t>(value);
+  for (int i = 0; i < 8; i++) {
+    out->push_back(static_cast<uint8_t>(bits >> (8 * i)));
+  }
+}
+
+int64_t ReadInt64(const uint8_t* in) {
+  uint64_t bits = 0;
+  for (int i = 0; i < 8; i++) {
+    bits |= static_cast<uint64_t>(in[i]) << (8 * i);
+  }
+  return static_cast<int64_t>(bits);
+}
+
+bool Deflate(const std::vector<uint8_t>& raw, std::vector<uint8_t>* out) {
+  uLongf size = compressBound(raw.size());
+  out->resize(size);
+  if (compress2(out->data(), &size, raw.data(), raw.size(),
+                Z_BEST_COMPRESSION) != Z_OK) {
+    return false;
+  }
+  out->resize(size);
+  return true;
+}
+
+bool Inflate(const uint8_t* data, size_t size, size_t raw_size,
+             std::vector<uint8_t>* out) {
+  out->resize(raw_size);
+  uLongf produced = raw_size;
+  if (raw_size == 0) {
+    return true;
+  }
+  return uncompress(out->data(), &produced, data, size) == Z_OK &&
+         produced == raw_size;
+}
+
+}  // namespace
+
+bool CreateBinaryDelta(const uint8_t* old_data, size_t old_size,
+                       const uint8_t* new_data, size_t new_size,
+                       std::vector<uint8_t>* delta) {
+  if (old_size >= kMaxFileSize || new_size > kMaxFileSize) {
+    return false;
+  }
+  const int64_t old_len = static_cast<int64_t>(old_size);
+  const int64_t new_len = static_cast<int64_t>(new_size);
+
+  std::vector<uint8_t> control;
+  std::vector<uint8_t> diff;
+  std::vector<uint8_t> extra;
+  diff.reserve(new_size);
+
+  if (old_size == 0) {
+    AppendInt64(&control, 0);
+    AppendInt64(&control, new_len);
+    AppendInt64(&control, 0);
+    extra.assign(new_data, new_data + new_size);
+  } else {
+    SuffixSorter sorter(old_data, static_cast<int32_t>(old_size));
+    const DeltaKernels& kernels = ActiveDeltaKernels();
+    const std::vector<int32_t>& index = sorter.index();
+
+    int64_t scan = 0;
+    int64_t len = 0;
+    int64_t position = 0;
+    int64_t last_scan = 0;
+    int64_t last_position = 0;
+    int64_t last_offset = 0;
+    while (scan < new_len) {
+      int64_t old_score = 0;
+      int64_t scored = scan += len;
+      for (; scan < new_len; scan++) {
+        len = Search(index, old_data, old_len, new_data + scan, new_len - scan,
+                     0, old_len, &position);
+        // Bytes of the new match that the previous alignment also covers.
+        if (scored < scan + len) {
+          const int64_t scored_end =
+              std::min(scan + len, old_len - last_offset);
+          if (scored_end > scored) {
+            old_score += kernels.count_equal(old_data + scored + last_offset,
+                                             new_data + scored,
+                                             scored_end - scored);
+          }
+          scored = scan + len;
+        }
+        if ((len == old_score && len != 0) || len > old_score + 8) {
+          break;
+        }
+        if (scan + last_offset < old_len &&
+            old_data[scan + last_offset] == new_data[scan]) {
+          old_score--;
+        }
+      }
+
+      if (len == old_score && scan != new_len) {
+        continue;
+      }
+
+      // Extend the previous match forwards and this one backwards while
+      // more than half the bytes agree.
+      int64_t score = 0;
+      int64_t best_forward_score = 0;
+      int64_t forward = 0;
+      for (int64_t i = 0;
+           last_scan + i < scan && last_position + i < old_len;) {
+        if (old_data[last_position + i] == new_data[last_scan + i]) {
+          score++;
+        }
+        i++;
+        if (score * 2 - i > best_forward_score * 2 - forward) {
+          best_forward_score = score;
+          forward = i;
+        }
+      }
+
+      int64_t backward = 0;
+      if (scan < new_len) {
+        score = 0;
+        int64_t best_backward_score = 0;
+        for (int64_t i = 1; scan >= last_scan + i && position >= i; i++) {
+          if (old_data[position - i] == new_data[scan - i]) {
+            score++;
+          }
+          if (score * 2 - i > best_backward_score * 2 - backward) {
+            best_backward_score = score;
+            backward = i;
+          }
+        }
+      }
+
+      // The two extensions overlap: split them where it pays most.
+      if (last_scan + forward > scan - backward) {
+        int64_t overlap = (last_scan + forward) - (scan - backward);
+        score = 0;
+        int64_t best_score = 0;
+        int64_t split = 0;
+        for (int64_t i = 0; i < overlap; i++) {
+          if (new_data[last_scan + forward - overlap + i] ==
+              old_data[last_position + forward - overlap + i]) {
+            score++;
+          }
+          if (new_data[scan - backward + i] ==
+              old_data[position - backward + i]) {
+            score--;
+          }
+          if (score > best_score) {
+            best_score = score;
+            split = i + 1;
+          }
+        }
+        forward += split - overlap;
+        backward -= split;
+      }
+
+      for (int64_t i = 0; i < forward; i++) {
+        diff.push_back(new_data[last_scan + i] - old_data[last_position + i]);
+      }
+      const int64_t extra_len = (scan - backward) - (last_scan + forward);
+      extra.insert(extra.end(), new_data + last_scan + forward,
+                   new_data + last_scan + forward + extra_len);
+
+      AppendInt64(&control, forward);
+      AppendInt64(&control, extra_len);
+      AppendInt64(&control,
+                  (position - backward) - (last_position + forward));
+
+      last_scan = scan - backward;
+      last_position = position - backward;
+      last_offset = position - scan;
+    }
+  }
+
+  std::vector<uint8_t> control_z;
+  std::vector<uint8_t> diff_z;
+  std::vector<uint8_t> extra_z;
+  if (!Deflate(control, &control_z) || !Deflate(diff, &diff_z) ||
+      !Deflate(extra, &extra_z)) {
+    return false;
+  }
+
+  delta->clear();
+  delta->reserve(kHeaderBytes + control_z.size() + diff_z.size() +
+                 extra_z.size());
+  delta->insert(delta->end(), kMagic, kMagic + sizeof(kMagic));
+  for (uint64_t value :
+       {static_cast<uint64_t>(new_size), static_cast<uint64_t>(control.size()),
+        static_cast<uint64_t>(control_z.size()),
+        static_cast<uint64_t>(diff.size()),
+        static_cast<uint64_t>(diff_z.size()),
+        static_cast<uint64_t>(extra.size()),
+        static_cast<uint64_t>(extra_z.size())}) {
+    AppendInt64(delta, static_cast<int64_t>(value));
+  }
+  delta->insert(delta->end(), control_z.begin(), control_z.end());
+  delta->insert(delta->end(), diff_z.begin(), diff_z.end());
+  delta->insert(delta->end(), extra_z.begin(), extra_z.end());
+  return true;
+}
+
+bool ApplyBinaryDelta(const uint8_t* old_data, size_t old_size,
+                      const uint8_t* delta, size_t delta_size,
+                      std::vector<uint8_t>* new_data) {
+  if (delta_size < kHeaderBytes ||
+      std::memcmp(delta, kMagic, sizeof(kMagic)) != 0) {
+    return false;
+  }
+  uint64_t fields[7];
+  for (int i = 0; i < 7; i++) {
+    fields[i] = static_cast<uint64_t>(
+        ReadInt64(delta + sizeof(kMagic) + i * 8));
+  }
+  DeltaHeader header = {fields[0], fields[1], fields[2], fields[3],
+                        fields[4], fields[5], fields[6]};
+  // Every size is checked before anything is allocated for it: a corrupt
+  // header must not be able to ask for more memory than the delta could
+  // describe.
+  uint64_t remaining = delta_size - kHeaderBytes;
+  const uint64_t streams[3][2] = {
+      {header.control_raw, header.control_compressed},
+      {header.diff_raw, header.diff_compressed},
+      {header.extra_raw, header.extra_compressed}};
+  for (const auto& stream : streams) {
+    if (stream[1] > remaining || stream[0] / kMaxDeflateRatio > stream[1]) {
+      return false;
+    }
+    remaining -= stream[1];
+  }
+  if (header.new_size > kMaxFileSize || header.control_raw % 24 != 0 ||
+      header.diff_raw > header.new_size ||
+      header.extra_raw > header.new_size) {
+    return false;
+  }
+
+  const uint8_t* cursor = delta + kHeaderBytes;
+  std::vector<uint8_t> control;
+  std::vector<uint8_t> diff;
+  std::vector<uint8_t> extra;
+  if (!Inflate(cursor, header.control_compressed, header.control_raw,
+               &control)) {
+    return false;
+  }
+  cursor += header.control_compressed;
+  if (!Inflate(cursor, header.diff_compressed, header.diff_raw, &diff)) {
+    return false;
+  }
+  cursor += header.diff_compressed;
+  if (!Inflate(cursor, header.extra_compressed, header.extra_raw, &extra)) {
+    return false;
+  }
+
+  const int64_t new_len = static_cast<int64_t>(header.new_size);
+  const int64_t old_len = static_cast<int64_t>(old_size);
+  new_data->assign(header.new_size, 0);
+  const DeltaKernels& kernels = ActiveDeltaKernels();
+  uint8_t* out = new_data->data();
+  size_t diff_used = 0;
+  size_t extra_used = 0;
+  int64_t new_position = 0;
+  int64_t old_position = 0;
+  for (size_t c = 0; c < control.size(); c += 24) {
+    const int64_t copy = ReadInt64(&control[c]);
+    const int64_t literal = ReadInt64(&control[c + 8]);
+    const int64_t seek = ReadInt64(&control[c + 16]);
+    if (copy < 0 || literal < 0 || copy > new_len - new_position ||
+        static_cast<uint64_t>(copy) > diff.size() - diff_used) {
+      return false;
+    }
+    // Diff bytes are added to the old bytes in [begin, end) of the run;
+    // outside the old file they are taken as they are.
+    int64_t begin = copy;
+    int64_t end = copy;
+    if (old_position < old_len && old_position > -copy) {
+      begin = old_position < 0 ? -old_position : 0;
+      end = std::min(copy, old_len - old_position);
+    }
+    const uint8_t* diff_run = diff.data() + diff_used;
+    uint8_t* out_run = out + new_position;
+    if (begin > 0) {
+      std::memcpy(out_run, diff_run, begin);
+    }
+    if (end > begin) {
+      kernels.add(diff_run + begin, old_data + old_position + begin,
+                  out_run + begin, end - begin);
+    }
+    if (end < copy) {
+      std::memcpy(out_run + end, diff_run + end, copy - end);
+    }
+    diff_used += copy;
+    new_position += copy;
+    old_position += copy;
+
+    if (literal > new_len - new_position ||
+        static_cast<uint64_t>(literal) > extra.size() - extra_used) {
+      return false;
+    }
+    if (literal > 0) {
+      std::memcpy(out + new_position, extra.data() + extra_used, literal);
+    }
+    extra_used += literal;
+    new_position += literal;
+    // No encoder moves further off the old file than a run could reach back
+    // from; bounding both terms also keeps the untrusted sum from
+    // overflowing.
+    if (seek < -(old_len + new_len) || seek > old_len + new_len) {
+      return false;
+    }
+    old_position += seek;
+    if (old_position < -new_len || old_position > old_len + new_len) {
+      return false;
+    }
+  }
+  return new_position == new_len;
+}
@@ -0,0 +1,34 @@
+#ifndef NATIVE_UPDATE_BINARY_DELTA_H_
+#define NATIVE_UPDATE_BINARY_DELTA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// bsdiff-style binary deltas.
+//
+// The new file is described as runs copied from the old one with small
+// bytewise differences (the "diff" stream, mostly zeros when code only
+// moved) plus literal runs (the "extra" stream). Each stream is deflated
+// separately. Creating a delta sorts the suffixes of the old file and needs
+// about 8 bytes of memory per old byte, so it is done at release time;
+// applying one is a single linear pass.
+//
+// Layout: "SSDELTA1", then the new size and the raw and compressed lengths
+// of the control, diff and extra streams as little-endian uint64s, then the
+// three compressed streams. Control entries are triples of int64s: bytes to
+// take from diff, bytes to take from extra, and how far to move in the old
+// file afterwards.
+
+// Old and new files must be smaller than 2 GiB.
+bool CreateBinaryDelta(const uint8_t* old_data, size_t old_size,
+                       const uint8_t* new_data, size_t new_size,
+                       std::vector<uint8_t>* delta);
+
+// Returns false if |delta| is malformed or does not fit |old_data|, without
+// allocating more than a well-formed delta of its size could need.
+bool ApplyBinaryDelta(const uint8_t* old_data, size_t old_size,
+                      const uint8_t* delta, size_t delta_size,
+                      std::vector<uint8_t>* new_data);
+
+#endif  // NATIVE_UPDATE_BINARY_DELTA_H_
@@ -0,0 +1,173 @@
+#include "update/bundle_manifest.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include "scheduler/thread_pool.h"
+
+namespace {
+
+bool ListDirectory(const std::string& root, const std::string& relative,
+                   std::vector<BundleEntry>* entries, std::string* error) {
+  const std::string directory =
+      relative.empty() ? root : root + "/" + relative;
+  DIR* dir = opendir(directory.c_str());
+  if (dir == nullptr) {
+    *error = "cannot open " + directory;
+    return false;
+  }
+  std::vector<std::string> names;
+  while (struct dirent* item = readdir(dir)) {
+    if (std::strcmp(item->d_name, ".") != 0 &&
+        std::strcmp(item->d_name, "..") != 0) {
+      names.push_back(item->d_name);
+    }
+  }
+  closedir(dir);
+  std::sort(names.begin(), names.end());
+
+  for (const std::string& name : names) {
+    BundleEntry entry;
+    entry.path = relative.empty() ? name : relative + "/" + name;
+    const std::string full = root + "/" + entry.path;
+    struct stat info;
+    if (lstat(full.c_str(), &info) != 0) {
+      *error = "cannot stat " + full;
+      return false;
+    }
+    entry.mode = info.st_mode & 07777;
+    if (S_ISDIR(info.st_mode)) {
+      entry.type = BundleEntryType::kDirectory;
+      entries->push_back(entry);
+      if (!ListDirectory(root, entry.path, entries, error)) {
+        return false;
+      }
+    } else if (S_ISLNK(info.st_mode)) {
+      entry.type = BundleEntryType::kSymlink;
+      char target[4096];
+      ssize_t length = readlink(full.c_str(), target, sizeof(target));
+      if (length < 0 || static_cast<size_t>(length) == sizeof(target)) {
+        *error = "cannot read link " + full;
+        return false;
+      }
+      entry.link_target.assign(target, length);
+      entries->push_back(entry);
+    } else if (S_ISREG(info.st_mode)) {
+      entry.type = BundleEntryType::kFile;
+      entry.size = static_cast<uint64_t>(info.st_size);
+      entries->push_back(entry);
+    }
+    // Sockets, fifos and devices have no business in a bundle; skip them.
+  }
+  return true;
+}
+
+}  // namespace
+
+bool ScanBundle(const std::string& root, int threads,
+                std::vector<BundleEntry>* entries, std::string* error) {
+  entries->clear();
+  if (!ListDirectory(root, "", entries, error)) {
+    return false;
+  }
+
+  std::vector<std::string> paths;
+  std::vector<BundleEntry*> files;
+  for (BundleEntry& entry : *entries) {
+    if (entry.type == BundleEntryType::kFile) {
+      paths.push_back(root + "/" + entry.path);
+      files.push_back(&entry);
+    }
+  }
+  std::vector<Digest> digests;
+  std::string failed;
+  if (!HashFilesParallel(paths, threads, &digests, &failed)) {
+    *error = "cannot read " + failed;
+    return false;
+  }
+  for (size_t i = 0; i < files.size(); i++) {
+    files[i]->digest = digests[i];
+  }
+  return true;
+}
+
+bool HashFilesParallel(const std::vector<std::string>& paths, int threads,
+                       std::vector<Digest>* digests, std::string* failed) {
+  digests->assign(paths.size(), Digest());
+
+  std::vector<std::pair<uint64_t, size_t>> order;
+  order.reserve(paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    struct stat info;
+    uint64_t size = stat(paths[i].c_str(), &info) == 0 ? info.st_size : 0;
+    order.emplace_back(size, i);
+  }
+  std::sort(order.begin(), order.end(),
+            [](const std::pair<uint64_t, size_t>& a,
+               const std::pair<uint64_t, size_t>& b) {
+              return a.first > b.first;
+            });
+
+  if (threads <= 0) {
+    threads =
+        static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  }
+  threads = std::min<int>(threads, std::max<size_t>(order.size(), 1));
+
+  std::atomic<size_t> next{0};
+  std::mutex failure_mutex;
+  size_t first_failure = paths.size();
+  auto work = [&] {
+    for (size_t n = next.fetch_add(1); n < order.size();
+         n = next.fetch_add(1)) {
+      const size_t i = order[n].second;
+      if (!Sha256File(paths[i], (*digests)[i].data())) {
+        std::lock_guard<std::mutex> lock(failure_mutex);
+        first_failure = std::min(first_failure, i);
+      }
+    }
+  };
+
+  // The calling thread takes part, so this finishes even when every
+  // background worker is busy.
+  TaskGroup group(&ThreadPool::Get(), TaskPriority::kBackground);
+  for (int t = 1; t < threads; t++) {
+    group.Run(work);
+  }
+  work();
+  group.Wait();
+
+  if (first_failure < paths.size()) {
+    if (failed != nullptr) {
+      *failed = paths[first_failure];
+    }
+    return false;
+  }
+  return true;
+}
+
+bool IsSafeBundlePath(const std::string& path) {
+  if (path.empty() || path[0] == '/') {
+    return false;
+  }
+  size_t start = 0;
+  while (start <= path.size()) {
+    size_t end = path.find('/', start);
+    if (end == std::string::npos) {
+      end = path.size();
+    }
+    const std::string part = path.substr(start, end - start);
+    if (part.empty() || part == "." || part == "..") {
+      return false;
+    }
+    start = end + 1;
+  }
+  return true;
+}
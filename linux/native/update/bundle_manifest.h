@@ -0,0 +1,47 @@
+#ifndef NATIVE_UPDATE_BUNDLE_MANIFEST_H_
+#define NATIVE_UPDATE_BUNDLE_MANIFEST_H_
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "update/sha256.h"
+
+using Digest = std::array<uint8_t, Sha256::kDigestBytes>;
+
+enum class BundleEntryType : uint8_t {
+  kFile = 0,
+  kDirectory = 1,
+  kSymlink = 2,
+};
+
+// One item of an installed app bundle (the directory `flutter build linux`
+// produces: the binary, lib/ and data/).
+struct BundleEntry {
+  std::string path;  // Relative to the bundle root, '/'-separated.
+  BundleEntryType type = BundleEntryType::kFile;
+  uint32_t mode = 0;  // Permission bits.
+  uint64_t size = 0;
+  Digest digest = {};  // Files only.
+  std::string link_target;  // Symlinks only.
+};
+
+// Lists everything under |root| in path order, so directories come before
+// their contents, and hashes the files with HashFilesParallel().
+bool ScanBundle(const std::string& root, int threads,
+                std::vector<BundleEntry>* entries, std::string* error);
+
+// Hashes |paths| on the calling thread plus up to |threads| - 1 background
+// tasks of the shared ThreadPool (0 picks one per core). Files are
+// handed out largest first so one big library does not end up last on a
+// single worker. On failure, |failed| is the first path that could not be
+// read.
+bool HashFilesParallel(const std::vector<std::string>& paths, int threads,
+                       std::vector<Digest>* digests, std::string* failed);
+
+// Rejects absolute paths and ".." components, which a patch must never use
+// to reach outside the bundle.
+bool IsSafeBundlePath(const std::string& path);
+
+#endif  // NATIVE_UPDATE_BUNDLE_MANIFEST_H_
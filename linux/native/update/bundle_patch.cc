@@ -0,0 +1,497 @@
+#include "update/bundle_patch.h"
+
+#include <fcntl.h>
+#include <ftw.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "common/buffered_file.h"
+#include "common/mapped_file.h"
+#include "logging/logger.h"
+#include "tracing/tracer.h"
+#include "update/binary_delta.h"
+#include "update/bundle_manifest.h"
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'S', 'B', 'P', 'A', 'T', 'C', 'H'};
+constexpr uint32_t kFormatVersion = 1;
+
+// deflate never shrinks data by more than this; a full file claiming a
+// bigger size than its payload could hold is corrupt, and is refused
+// before the buffer for it is allocated.
+constexpr uint64_t kMaxDeflateRatio = 1032;
+
+enum class PatchOp : uint8_t {
+  kKeep = 0,   // No payload.
+  kDelta = 1,  // Binary delta against the installed file at the same path.
+  kFull = 2,   // Deflated contents.
+};
+
+#pragma pack(push, 1)
+struct PatchFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t entry_count;
+  uint64_t body_size;
+  uint8_t body_digest[Sha256::kDigestBytes];
+};
+
+struct PatchEntryHeader {
+  uint8_t type;  // BundleEntryType.
+  uint8_t op;    // PatchOp; files only.
+  uint16_t path_size;
+  uint32_t mode;
+  uint64_t size;
+  uint8_t digest[Sha256::kDigestBytes];
+  uint64_t payload_size;  // Link target for symlinks.
+};
+#pragma pack(pop)
+
+bool ReadWholeFile(const std::string& path, std::vector<uint8_t>* out) {
+  MappedFile file;
+  if (!file.Open(path)) {
+    return false;
+  }
+  out->assign(file.data(), file.data() + file.size());
+  return true;
+}
+
+// Creates |path|, which must not exist yet; an existing file or symlink
+// there is never followed or overwritten.
+bool WriteWholeFile(const std::string& path, const uint8_t* data, size_t size,
+                    uint32_t mode) {
+  int fd = open(path.c_str(),
+                O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+  if (fd < 0) {
+    return false;
+  }
+  size_t done = 0;
+  while (done < size) {
+    ssize_t written = write(fd, data + done, size - done);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      close(fd);
+      return false;
+    }
+    done += static_cast<size_t>(written);
+  }
+  bool ok = fchmod(fd, mode) == 0;
+  return close(fd) == 0 && ok;
+}
+
+bool CopyFile(const std::string& from, const std::string& to, uint32_t mode) {
+  MappedFile source;
+  return source.Open(from) &&
+         WriteWholeFile(to, source.data(), source.size(), mode);
+}
+
+// Whether a parent directory of |path| is one of |links|.
+bool HasSymlinkParent(const std::string& path,
+                      const std::set<std::string>& links) {
+  for (size_t slash = path.find('/'); slash != std::string::npos;
+       slash = path.find('/', slash + 1)) {
+    if (links.count(path.substr(0, slash)) != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Whether |target|, the target of the symlink at |path|, resolves inside the
+// bundle. Resolved lexically, so a target that goes through another symlink
+// of the bundle (|links|) is refused: what lies behind that one is unknown.
+// Naming a symlink as the last component is fine, since it is checked too.
+bool IsContainedLinkTarget(const std::string& path, const std::string& target,
+                           const std::set<std::string>& links) {
+  if (target.empty() || target[0] == '/') {
+    return false;
+  }
+  std::string resolved;
+  const size_t slash = path.rfind('/');
+  if (slash != std::string::npos) {
+    resolved = path.substr(0, slash);
+  }
+  size_t start = 0;
+  while (start <= target.size()) {
+    if (links.count(resolved) != 0) {
+      return false;
+    }
+    size_t end = target.find('/', start);
+    if (end == std::string::npos) {
+      end = target.size();
+    }
+    const std::string part = target.substr(start, end - start);
+    start = end + 1;
+    if (part.empty() || part == ".") {
+      continue;
+    }
+    if (part == "..") {
+      if (resolved.empty()) {
+        return false;
+      }
+      const size_t parent = resolved.rfind('/');
+      resolved.erase(parent == std::string::npos ? 0 : parent);
+    } else {
+      resolved += (resolved.empty() ? "" : "/") + part;
+    }
+  }
+  return true;
+}
+
+int RemoveTreeEntry(const char* path, const struct stat* info, int type,
+                    struct FTW* walk) {
+  return remove(path) == 0 || errno == ENOENT ? 0 : -1;
+}
+
+}  // namespace
+
+bool RemoveTree(const std::string& path) {
+  struct stat info;
+  if (lstat(path.c_str(), &info) != 0) {
+    return errno == ENOENT;
+  }
+  return nftw(path.c_str(), RemoveTreeEntry, 16, FTW_DEPTH | FTW_PHYS) == 0;
+}
+
+bool CreateBundlePatch(const std::string& old_root,
+                       const std::string& new_root,
+                       const std::string& patch_path,
+                       BundlePatchStats* stats, std::string* error) {
+  SS_TRACE_SCOPE("update", "create bundle patch");
+  std::vector<BundleEntry> old_entries;
+  std::vector<BundleEntry> new_entries;
+  if (!ScanBundle(old_root, 0, &old_entries, error) ||
+      !ScanBundle(new_root, 0, &new_entries, error)) {
+    return false;
+  }
+  // ApplyBundlePatch() refuses links that leave the bundle; fail here
+  // rather than ship a patch no client can install.
+  std::set<std::string> links;
+  for (const BundleEntry& entry : new_entries) {
+    if (entry.type == BundleEntryType::kSymlink) {
+      links.insert(entry.path);
+    }
+  }
+  for (const BundleEntry& entry : new_entries) {
+    if (entry.type == BundleEntryType::kSymlink &&
+        !IsContainedLinkTarget(entry.path, entry.link_target, links)) {
+      *error = "link leaves the bundle: " + entry.path + " -> " +
+               entry.link_target;
+      return false;
+    }
+  }
+  std::map<std::string, const BundleEntry*> old_files;
+  for (const BundleEntry& entry : old_entries) {
+    if (entry.type == BundleEntryType::kFile) {
+      old_files[entry.path] = &entry;
+    }
+  }
+
+  BundlePatchStats totals;
+  std::vector<uint8_t> body;
+  std::vector<uint8_t> new_data;
+  std::vector<uint8_t> old_data;
+  std::vector<uint8_t> payload;
+  for (const BundleEntry& entry : new_entries) {
+    PatchEntryHeader header = {};
+    header.type = static_cast<uint8_t>(entry.type);
+    header.path_size = static_cast<uint16_t>(entry.path.size());
+    header.mode = entry.mode;
+    header.size = entry.size;
+    payload.clear();
+
+    if (entry.type == BundleEntryType::kSymlink) {
+      payload.assign(entry.link_target.begin(), entry.link_target.end());
+    } else if (entry.type == BundleEntryType::kFile) {
+      std::memcpy(header.digest, entry.digest.data(), sizeof(header.digest));
+      totals.files++;
+      totals.target_bytes += entry.size;
+      auto old_file = old_files.find(entry.path);
+      if (old_file != old_files.end() &&
+          old_file->second->digest == entry.digest) {
+        header.op = static_cast<uint8_t>(PatchOp::kKeep);
+        totals.kept++;
+      } else {
+        if (!ReadWholeFile(new_root + "/" + entry.path, &new_data)) {
+          *error = "cannot read " + new_root + "/" + entry.path;
+          return false;
+        }
+        // Deflated contents as the baseline; a delta has to beat it.
+        uLongf bound = compressBound(new_data.size());
+        payload.resize(bound);
+        if (compress2(payload.data(), &bound, new_data.data(),
+                      new_data.size(), Z_BEST_COMPRESSION) != Z_OK) {
+          *error = "cannot compress " + entry.path;
+          return false;
+        }
+        payload.resize(bound);
+        header.op = static_cast<uint8_t>(PatchOp::kFull);
+
+        std::vector<uint8_t> delta;
+        if (old_file != old_files.end() &&
+            ReadWholeFile(old_root + "/" + entry.path, &old_data) &&
+            CreateBinaryDelta(old_data.data(), old_data.size(),
+                              new_data.data(), new_data.size(), &delta) &&
+            delta.size() < payload.size()) {
+          payload.swap(delta);
+          header.op = static_cast<uint8_t>(PatchOp::kDelta);
+          totals.patched++;
+        } else {
+          totals.added++;
+        }
+      }
+    }
+    header.payload_size = payload.size();
+
+    const uint8_t* raw = reinterpret_cast<const uint8_t*>(&header);
+    body.insert(body.end(), raw, raw + sizeof(header));
+    body.insert(body.end(), entry.path.begin(), entry.path.end());
+    body.insert(body.end(), payload.begin(), payload.end());
+  }
+
+  PatchFileHeader file_header = {};
+  std::memcpy(file_header.magic, kMagic, sizeof(kMagic));
+  file_header.version = kFormatVersion;
+  file_header.entry_count = static_cast<uint32_t>(new_entries.size());
+  file_header.body_size = body.size();
+  Sha256 hash;
+  hash.Update(body.data(), body.size());
+  hash.Final(file_header.body_digest);
+
+  BufferedFile out;
+  if (!out.Open(patch_path) || !out.Write(&file_header, sizeof(file_header)) ||
+      !out.Write(body.data(), body.size()) || !out.Commit()) {
+    out.Abort();
+    *error = "cannot write " + patch_path;
+    return false;
+  }
+  totals.patch_bytes = sizeof(file_header) + body.size();
+  if (stats != nullptr) {
+    *stats = totals;
+  }
+  return true;
+}
+
+bool ApplyBundlePatch(const std::string& installed_root,
+                      const std::string& patch_path,
+                      const std::string& staging_root, int threads,
+                      BundlePatchStats* stats, std::string* error) {
+  SS_TRACE_SCOPE("update", "apply bundle patch");
+  error->clear();
+  MappedFile patch;
+  if (!patch.Open(patch_path)) {
+    *error = "cannot open " + patch_path;
+    return false;
+  }
+  patch.AdviseSequential();
+  PatchFileHeader file_header;
+  if (patch.size() < sizeof(file_header)) {
+    *error = "patch is truncated";
+    return false;
+  }
+  std::memcpy(&file_header, patch.data(), sizeof(file_header));
+  if (std::memcmp(file_header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      file_header.version != kFormatVersion ||
+      file_header.body_size != patch.size() - sizeof(file_header)) {
+    *error = "not a bundle patch, or truncated";
+    return false;
+  }
+  const uint8_t* body = patch.data() + sizeof(file_header);
+  const size_t body_size = file_header.body_size;
+  {
+    SS_TRACE_SCOPE("update", "hash patch");
+    uint8_t digest[Sha256::kDigestBytes];
+    Sha256 hash;
+    hash.Update(body, body_size);
+    hash.Final(digest);
+    if (std::memcmp(digest, file_header.body_digest, sizeof(digest)) != 0) {
+      *error = "patch checksum mismatch";
+      return false;
+    }
+  }
+
+  if (!RemoveTree(staging_root) || mkdir(staging_root.c_str(), 0755) != 0) {
+    *error = "cannot create " + staging_root;
+    return false;
+  }
+
+  BundlePatchStats totals;
+  totals.patch_bytes = patch.size();
+  std::vector<std::string> staged_files;
+  std::vector<Digest> expected;
+  std::vector<std::pair<std::string, uint32_t>> directories;
+  std::vector<uint8_t> output;
+  std::set<std::string> links;
+  std::vector<std::pair<std::string, std::string>> link_targets;
+  size_t offset = 0;
+  bool ok = true;
+  for (uint32_t n = 0; ok && n < file_header.entry_count; n++) {
+    PatchEntryHeader header;
+    if (body_size - offset < sizeof(header)) {
+      *error = "patch entry truncated";
+      ok = false;
+      break;
+    }
+    std::memcpy(&header, body + offset, sizeof(header));
+    offset += sizeof(header);
+    if (body_size - offset < header.path_size ||
+        body_size - offset - header.path_size < header.payload_size) {
+      *error = "patch entry truncated";
+      ok = false;
+      break;
+    }
+    const std::string path(reinterpret_cast<const char*>(body + offset),
+                           header.path_size);
+    offset += header.path_size;
+    const uint8_t* payload = body + offset;
+    offset += header.payload_size;
+    // The staging directory is new, so the only symlinks in it are the
+    // ones this patch made; nothing is ever created through them.
+    if (!IsSafeBundlePath(path) || HasSymlinkParent(path, links)) {
+      *error = "unsafe path in patch: " + path;
+      ok = false;
+      break;
+    }
+
+    const std::string target = staging_root + "/" + path;
+    const std::string source = installed_root + "/" + path;
+    const uint32_t mode = header.mode & 07777;
+    switch (static_cast<BundleEntryType>(header.type)) {
+      case BundleEntryType::kDirectory:
+        // Writable until everything below it has been created.
+        ok = mkdir(target.c_str(), mode | 0700) == 0;
+        directories.emplace_back(target, mode);
+        break;
+      case BundleEntryType::kSymlink: {
+        const std::string link_target(reinterpret_cast<const char*>(payload),
+                                      header.payload_size);
+        ok = symlink(link_target.c_str(), target.c_str()) == 0;
+        links.insert(path);
+        link_targets.emplace_back(path, link_target);
+        break;
+      }
+      case BundleEntryType::kFile: {
+        totals.files++;
+        totals.target_bytes += header.size;
+        switch (static_cast<PatchOp>(header.op)) {
+          case PatchOp::kKeep: {
+            // The installed bundle goes away once the update is in place, so
+            // sharing its inodes is safe; copy only if the mode changed.
+            struct stat info;
+            ok = lstat(source.c_str(), &info) == 0;
+            if (ok && ((info.st_mode & 07777) != mode ||
+                       link(source.c_str(), target.c_str()) != 0)) {
+              ok = CopyFile(source, target, mode);
+            }
+            totals.kept++;
+            break;
+          }
+          case PatchOp::kDelta: {
+            MappedFile old_file;
+            ok = old_file.Open(source) &&
+                 ApplyBinaryDelta(old_file.data(), old_file.size(), payload,
+                                  header.payload_size, &output) &&
+                 WriteWholeFile(target, output.data(), output.size(), mode);
+            totals.patched++;
+            break;
+          }
+          case PatchOp::kFull: {
+            totals.added++;
+            if (header.size / kMaxDeflateRatio > header.payload_size) {
+              ok = false;
+              break;
+            }
+            output.resize(header.size);
+            uLongf produced = header.size;
+            ok = (header.size == 0 ||
+                  uncompress(output.data(), &produced, payload,
+                             header.payload_size) == Z_OK) &&
+                 produced == header.size &&
+                 WriteWholeFile(target, output.data(), output.size(), mode);
+            break;
+          }
+          default:
+            ok = false;
+        }
+        Digest digest;
+        std::memcpy(digest.data(), header.digest, digest.size());
+        staged_files.push_back(target);
+        expected.push_back(digest);
+        break;
+      }
+      default:
+        ok = false;
+    }
+    if (!ok && error->empty()) {
+      *error = "cannot stage " + path;
+    }
+  }
+
+  // Checked once every symlink is known, as targets may name later ones.
+  for (size_t i = 0; ok && i < link_targets.size(); i++) {
+    if (!IsContainedLinkTarget(link_targets[i].first, link_targets[i].second,
+                               links)) {
+      *error = "unsafe link in patch: " + link_targets[i].first + " -> " +
+               link_targets[i].second;
+      ok = false;
+    }
+  }
+
+  if (ok) {
+    SS_TRACE_SCOPE("update", "verify staged bundle");
+    std::vector<Digest> digests;
+    std::string failed;
+    if (!HashFilesParallel(staged_files, threads, &digests, &failed)) {
+      *error = "cannot read " + failed;
+      ok = false;
+    } else {
+      for (size_t i = 0; i < digests.size(); i++) {
+        if (digests[i] != expected[i]) {
+          *error = "checksum mismatch for " + staged_files[i];
+          ok = false;
+          break;
+        }
+      }
+    }
+  }
+
+  for (auto it = directories.rbegin(); ok && it != directories.rend(); ++it) {
+    ok = chmod(it->first.c_str(), it->second) == 0;
+  }
+  if (!ok && error->empty()) {
+    *error = "cannot set permissions in " + staging_root;
+  }
+
+  if (ok) {
+    // One sync for the whole tree instead of one per file.
+    int fd = open(staging_root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    ok = fd >= 0 && syncfs(fd) == 0;
+    if (fd >= 0) {
+      close(fd);
+    }
+    if (!ok) {
+      *error = "cannot sync " + staging_root;
+    }
+  }
+
+  if (!ok) {
+    SS_LOG(LogLevel::kError, "update", "applying {} failed: {}", patch_path,
+           *error);
+    RemoveTree(staging_root);
+    return false;
+  }
+  if (stats != nullptr) {
+    *stats = totals;
+  }
+  return true;
+}
@@ -0,0 +1,49 @@
+#ifndef NATIVE_UPDATE_BUNDLE_PATCH_H_
+#define NATIVE_UPDATE_BUNDLE_PATCH_H_
+
+#include <cstdint>
+#include <string>
+
+// Turns one installed app bundle into the next release.
+//
+// A patch lists every entry of the target bundle in path order. Files are
+// either kept (same content at the same path in the installed bundle),
+// rebuilt from the installed file with a binary delta, or stored whole and
+// deflated when there is nothing to diff against. Entries the target lacks
+// are simply not produced, since the target is built in a fresh directory.
+//
+// File layout: a PatchFileHeader (magic "SSBPATCH", version, entry count,
+// body size and the SHA-256 of the body), then per entry a PatchEntryHeader,
+// the path, and the payload.
+
+struct BundlePatchStats {
+  uint32_t files = 0;
+  uint32_t kept = 0;
+  uint32_t patched = 0;
+  uint32_t added = 0;  // Stored whole.
+  uint64_t target_bytes = 0;
+  uint64_t patch_bytes = 0;
+};
+
+// Writes the patch from |old_root| to |new_root| to |patch_path|. Fails if
+// a symlink in |new_root| points outside it.
+bool CreateBundlePatch(const std::string& old_root,
+                       const std::string& new_root,
+                       const std::string& patch_path,
+                       BundlePatchStats* stats, std::string* error);
+
+// Builds the target bundle of |patch_path| in |staging_root| from
+// |installed_root|, replacing whatever |staging_root| held, then checks the
+// SHA-256 of every file on |threads| workers (0: one per core). Unchanged
+// files are hard links into the installed bundle where possible. Symlinks
+// must resolve inside the bundle, and no entry is created through one. On
+// failure |staging_root| is removed.
+bool ApplyBundlePatch(const std::string& installed_root,
+                      const std::string& patch_path,
+                      const std::string& staging_root, int threads,
+                      BundlePatchStats* stats, std::string* error);
+
+// Removes |path| and everything below it. Missing paths count as removed.
+bool RemoveTree(const std::string& path);
+
+#endif  // NATIVE_UPDATE_BUNDLE_PATCH_H_
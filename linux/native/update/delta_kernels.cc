@@ -0,0 +1,214 @@
+#include "update/delta_kernels.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SS_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+int64_t MismatchScalar(const uint8_t* a, const uint8_t* b, int64_t size) {
+  int64_t i = 0;
+  // Eight bytes at a time until the word that differs.
+  for (; i + 8 <= size; i += 8) {
+    uint64_t x;
+    uint64_t y;
+    memcpy(&x, a + i, 8);
+    memcpy(&y, b + i, 8);
+    if (x != y) {
+      break;
+    }
+  }
+  while (i < size && a[i] == b[i]) {
+    i++;
+  }
+  return i;
+}
+
+int64_t CountEqualScalar(const uint8_t* a, const uint8_t* b, int64_t size) {
+  int64_t count = 0;
+  for (int64_t i = 0; i < size; i++) {
+    count += a[i] == b[i];
+  }
+  return count;
+}
+
+void AddScalar(const uint8_t* a, const uint8_t* b, uint8_t* out,
+               int64_t size) {
+  for (int64_t i = 0; i < size; i++) {
+    out[i] = static_cast<uint8_t>(a[i] + b[i]);
+  }
+}
+
+#ifdef SS_X86_KERNELS
+
+__attribute__((target("avx2"))) inline __m256i Load256(const uint8_t* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+__attribute__((target("avx2"))) int64_t MismatchAvx2(const uint8_t* a,
+                                                      const uint8_t* b,
+                                                      int64_t size) {
+  int64_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const __m256i x = Load256(a + i);
+    const __m256i y = Load256(b + i);
+    const uint32_t equal =
+        static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+    if (equal != 0xFFFFFFFFu) {
+      return i + __builtin_ctz(~equal);
+    }
+  }
+  return i + MismatchScalar(a + i, b + i, size - i);
+}
+
+__attribute__((target("avx2"))) int64_t CountEqualAvx2(const uint8_t* a,
+                                                        const uint8_t* b,
+                                                        int64_t size) {
+  int64_t count = 0;
+  int64_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const __m256i x = Load256(a + i);
+    const __m256i y = Load256(b + i);
+    count += __builtin_popcount(
+        static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y))));
+  }
+  return count + CountEqualScalar(a + i, b + i, size - i);
+}
+
+__attribute__((target("avx2"))) void AddAvx2(const uint8_t* a,
+                                             const uint8_t* b, uint8_t* out,
+                                             int64_t size) {
+  int64_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const __m256i x = Load256(a + i);
+    const __m256i y = Load256(b + i);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                        _mm256_add_epi8(x, y));
+  }
+  AddScalar(a + i, b + i, out + i, size - i);
+}
+
+// The tails use masked loads rather than a scalar loop.
+
+__attribute__((target("avx512f,avx512bw,bmi2"))) int64_t MismatchAvx512(
+    const uint8_t* a, const uint8_t* b, int64_t size) {
+  int64_t i = 0;
+  for (; i < size; i += 64) {
+    const int64_t left = size - i;
+    const __mmask64 mask =
+        left >= 64 ? ~__mmask64{0} : _bzhi_u64(~uint64_t{0}, left);
+    const __m512i x = _mm512_maskz_loadu_epi8(mask, a + i);
+    const __m512i y = _mm512_maskz_loadu_epi8(mask, b + i);
+    const __mmask64 differ = _mm512_mask_cmpneq_epu8_mask(mask, x, y);
+    if (differ != 0) {
+      return i + __builtin_ctzll(differ);
+    }
+  }
+  return size;
+}
+
+__attribute__((target("avx512f,avx512bw,bmi2"))) int64_t CountEqualAvx512(
+    const uint8_t* a, const uint8_t* b, int64_t size) {
+  int64_t count = 0;
+  for (int64_t i = 0; i < size; i += 64) {
+    const int64_t left = size - i;
+    const __mmask64 mask =
+        left >= 64 ? ~__mmask64{0} : _bzhi_u64(~uint64_t{0}, left);
+    const __m512i x = _mm512_maskz_loadu_epi8(mask, a + i);
+    const __m512i y = _mm512_maskz_loadu_epi8(mask, b + i);
+    count += __builtin_popcountll(_mm512_mask_cmpeq_epu8_mask(mask, x, y));
+  }
+  return count;
+}
+
+__attribute__((target("avx512f,avx512bw,bmi2"))) void AddAvx512(
+    const uint8_t* a, const uint8_t* b, uint8_t* out, int64_t size) {
+  for (int64_t i = 0; i < size; i += 64) {
+    const int64_t left = size - i;
+    const __mmask64 mask =
+        left >= 64 ? ~__mmask64{0} : _bzhi_u64(~uint64_t{0}, left);
+    const __m512i x = _mm512_maskz_loadu_epi8(mask, a + i);
+    const __m512i y = _mm512_maskz_loadu_epi8(mask, b + i);
+    _mm512_mask_storeu_epi8(out + i, mask, _mm512_add_epi8(x, y));
+  }
+}
+
+#endif  // SS_X86_KERNELS
+
+const DeltaKernels kScalarKernels = {MismatchScalar, CountEqualScalar,
+                                     AddScalar};
+#ifdef SS_X86_KERNELS
+const DeltaKernels kAvx2Kernels = {MismatchAvx2, CountEqualAvx2, AddAvx2};
+const DeltaKernels kAvx512Kernels = {MismatchAvx512, CountEqualAvx512,
+                                     AddAvx512};
+#endif
+
+SimdLevel Detect() {
+#ifdef SS_X86_KERNELS
+  __builtin_cpu_init();
+  // The masked tails use BZHI, which comes with BMI2.
+  if (__builtin_cpu_supports("avx512f") &&
+      __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("bmi2")) {
+    return SimdLevel::kAvx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::kAvx2;
+  }
+#endif
+  return SimdLevel::kScalar;
+}
+
+SimdLevel ActiveLevel() {
+  SimdLevel level = DetectSimdLevel();
+  const char* forced = getenv("SS_SIMD_LEVEL");
+  if (forced == nullptr) {
+    return level;
+  }
+  SimdLevel wanted = level;
+  if (strcmp(forced, "scalar") == 0) {
+    wanted = SimdLevel::kScalar;
+  } else if (strcmp(forced, "avx2") == 0) {
+    wanted = SimdLevel::kAvx2;
+  }
+  return wanted < level ? wanted : level;
+}
+
+}  // namespace
+
+SimdLevel DetectSimdLevel() {
+  static const SimdLevel level = Detect();
+  return level;
+}
+
+const char* SimdLevelName(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::kScalar:
+      return "scalar";
+    case SimdLevel::kAvx2:
+      return "avx2";
+    case SimdLevel::kAvx512:
+      return "avx512";
+  }
+  return "?";
+}
+
+const DeltaKernels& DeltaKernelsFor(SimdLevel level) {
+#ifdef SS_X86_KERNELS
+  if (level == SimdLevel::kAvx512) {
+    return kAvx512Kernels;
+  }
+  if (level == SimdLevel::kAvx2) {
+    return kAvx2Kernels;
+  }
+#endif
+  return kScalarKernels;
+}
+
+const DeltaKernels& ActiveDeltaKernels() {
+  static const DeltaKernels& kernels = DeltaKernelsFor(ActiveLevel());
+  return kernels;
+}
@@ -0,0 +1,39 @@
+#ifndef NATIVE_UPDATE_DELTA_KERNELS_H_
+#define NATIVE_UPDATE_DELTA_KERNELS_H_
+
+#include <cstdint>
+
+// The byte loops binary deltas spend their time in, in a scalar version and
+// AVX2 and AVX-512BW versions picked at run time from what the CPU supports.
+// The vector versions are compiled with per-function target attributes, so
+// the library still runs on any x86-64 (and elsewhere only the scalar ones
+// exist).
+
+enum class SimdLevel {
+  kScalar,
+  kAvx2,
+  kAvx512,
+};
+
+struct DeltaKernels {
+  // Index of the first byte where |a| and |b| differ, or |size|.
+  int64_t (*mismatch)(const uint8_t* a, const uint8_t* b, int64_t size);
+  // Number of positions where |a| and |b| hold the same byte.
+  int64_t (*count_equal)(const uint8_t* a, const uint8_t* b, int64_t size);
+  // out[i] = a[i] + b[i] (mod 256). |out| may alias |a|.
+  void (*add)(const uint8_t* a, const uint8_t* b, uint8_t* out,
+              int64_t size);
+};
+
+// The best level this CPU supports; detected once.
+SimdLevel DetectSimdLevel();
+const char* SimdLevelName(SimdLevel level);
+
+// The kernels of |level|, which must not be above DetectSimdLevel().
+const DeltaKernels& DeltaKernelsFor(SimdLevel level);
+
+// The kernels of DetectSimdLevel(), or of SS_SIMD_LEVEL (scalar, avx2 or
+// avx512) when that is set lower, to compare or rule out the vector code.
+const DeltaKernels& ActiveDeltaKernels();
+
+#endif  // NATIVE_UPDATE_DELTA_KERNELS_H_
@@ -0,0 +1,38 @@
+#ifndef NATIVE_UPDATE_SHA256_H_
+#define NATIVE_UPDATE_SHA256_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Incremental SHA-256 (FIPS 180-4).
+class Sha256 {
+ public:
+  static constexpr size_t kDigestBytes = 32;
+
+  Sha256();
+
+  void Update(const void* data, size_t size);
+  // Writes the digest and leaves the object unusable until Reset().
+  void Final(uint8_t digest[kDigestBytes]);
+  void Reset();
+
+ private:
+  void Compress(const uint8_t block[64]);
+
+  uint32_t state_[8];
+  uint8_t buffer_[64];
+  size_t buffered_ = 0;
+  uint64_t total_bytes_ = 0;
+};
+
+// Lowercase hex of a digest.
+std::string DigestToHex(const uint8_t digest[Sha256::kDigestBytes]);
+// Parses 64 hex characters. Returns false on anything else.
+bool DigestFromHex(const std::string& hex,
+                   uint8_t digest[Sha256::kDigestBytes]);
+
+// Hashes a whole file. Returns false if it cannot be read.
+bool Sha256File(const std::string& path, uint8_t digest[Sha256::kDigestBytes]);
+
+#endif  // NATIVE_UPDATE_SHA256_H_
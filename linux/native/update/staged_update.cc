@@ -0,0 +1,126 @@
+#include "update/staged_update.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include "logging/logger.h"
+#include "update/bundle_patch.h"
+
+namespace {
+
+constexpr char kReadyMarker[] = ".ss-update-ready";
+
+std::string TrimTrailingSlashes(std::string path) {
+  while (path.size() > 1 && path.back() == '/') {
+    path.pop_back();
+  }
+  return path;
+}
+
+enum class Exchange {
+  kFailed,     // Both directories are where they were.
+  kExchanged,  // |a| holds what was |b| and the other way round.
+  kParked,     // |b| holds what was |a|; what was |b| is left at |b|.old.
+};
+
+// Exchanges two directories atomically. Falls back to renames on
+// filesystems without RENAME_EXCHANGE; a crash between them leaves the
+// bundle under |b|.old, which the next ApplyStagedUpdate() restores.
+Exchange ExchangeDirectories(const std::string& a, const std::string& b) {
+#ifdef RENAME_EXCHANGE
+  if (renameat2(AT_FDCWD, a.c_str(), AT_FDCWD, b.c_str(), RENAME_EXCHANGE) ==
+      0) {
+    return Exchange::kExchanged;
+  }
+  if (errno != EINVAL && errno != ENOSYS) {
+    return Exchange::kFailed;
+  }
+#endif
+  const std::string parked = b + ".old";
+  if (rename(b.c_str(), parked.c_str()) != 0) {
+    return Exchange::kFailed;
+  }
+  if (rename(a.c_str(), b.c_str()) != 0) {
+    rename(parked.c_str(), b.c_str());
+    return Exchange::kFailed;
+  }
+  // |b| is in place; moving the old one out of the way is only tidying up.
+  return rename(parked.c_str(), a.c_str()) == 0 ? Exchange::kExchanged
+                                                : Exchange::kParked;
+}
+
+}  // namespace
+
+std::string StagingPathFor(const std::string& bundle_root) {
+  const std::string root = TrimTrailingSlashes(bundle_root);
+  const size_t slash = root.rfind('/');
+  if (slash == std::string::npos) {
+    return "./." + root + ".staged";
+  }
+  return root.substr(0, slash) + "/." + root.substr(slash + 1) + ".staged";
+}
+
+bool MarkStagedUpdateReady(const std::string& staging_root,
+                           const std::string& version) {
+  const std::string marker = staging_root + "/" + kReadyMarker;
+  int fd = open(marker.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  bool ok = write(fd, version.data(), version.size()) ==
+                static_cast<ssize_t>(version.size()) &&
+            fsync(fd) == 0;
+  return close(fd) == 0 && ok;
+}
+
+StagedUpdateResult ApplyStagedUpdate(const std::string& bundle_root,
+                                     std::string* version,
+                                     std::string* error) {
+  const std::string root = TrimTrailingSlashes(bundle_root);
+  const std::string staging = StagingPathFor(root);
+
+  // An interrupted fallback swap left the bundle parked; put it back. With
+  // the bundle in place, what is parked is the one it replaced.
+  struct stat info;
+  const std::string parked = root + ".old";
+  if (lstat(parked.c_str(), &info) == 0) {
+    if (lstat(root.c_str(), &info) != 0) {
+      rename(parked.c_str(), root.c_str());
+    } else {
+      RemoveTree(parked);
+    }
+  }
+
+  std::ifstream marker(staging + "/" + kReadyMarker);
+  if (!marker) {
+    return StagedUpdateResult::kNone;
+  }
+  std::getline(marker, *version);
+  marker.close();
+
+  const Exchange exchange = ExchangeDirectories(staging, root);
+  if (exchange == Exchange::kFailed) {
+    *error = "cannot swap " + staging + " into " + root + ": " +
+             strerror(errno);
+    SS_LOG(LogLevel::kError, "update", "{}", *error);
+    return StagedUpdateResult::kFailed;
+  }
+  // The marker came along with the new bundle.
+  unlink((root + "/" + kReadyMarker).c_str());
+  if (exchange == Exchange::kExchanged) {
+    // The old bundle is now in the staging directory.
+    RemoveTree(staging);
+  } else {
+    // The new bundle is in place either way; the old one stays parked
+    // until the next start removes it.
+    SS_LOG(LogLevel::kWarning, "update", "old bundle left at {}.old", root);
+  }
+  SS_LOG(LogLevel::kInfo, "update", "installed staged update {}", *version);
+  return StagedUpdateResult::kApplied;
+}
@@ -0,0 +1,30 @@
+#ifndef NATIVE_UPDATE_STAGED_UPDATE_H_
+#define NATIVE_UPDATE_STAGED_UPDATE_H_
+
+#include <string>
+
+// A downloaded update is built next to the installed bundle, in
+// "<parent>/.<bundle name>.staged", so that putting it in place is a rename
+// within one filesystem. Only a staging directory carrying the ready marker
+// is ever swapped in; anything else is a leftover of an interrupted apply.
+
+std::string StagingPathFor(const std::string& bundle_root);
+
+// Marks |staging_root| as complete and verified, for |version|.
+bool MarkStagedUpdateReady(const std::string& staging_root,
+                           const std::string& version);
+
+enum class StagedUpdateResult {
+  kNone = 0,     // Nothing staged.
+  kApplied = 1,  // |bundle_root| now holds the update; restart from it.
+  kFailed = 2,   // Staged but could not be swapped in; left untouched.
+};
+
+// Swaps a ready staged update into |bundle_root| with one atomic exchange
+// and removes the previous bundle. Must run before the bundle's libraries
+// are used for anything but the current process image.
+StagedUpdateResult ApplyStagedUpdate(const std::string& bundle_root,
+                                     std::string* version,
+                                     std::string* error);
+
+#endif  // NATIVE_UPDATE_STAGED_UPDATE_H_
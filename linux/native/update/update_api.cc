@@ -0,0 +1,77 @@
+#include "update/update_api.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "update/bundle_patch.h"
+#include "update/sha256.h"
+#include "update/staged_update.h"
+
+namespace {
+
+int32_t CopyOut(const std::string& text, char* buffer, int32_t size) {
+  if (buffer != nullptr && size > 0) {
+    size_t count = std::min(text.size(), static_cast<size_t>(size - 1));
+    std::memcpy(buffer, text.data(), count);
+    buffer[count] = '\0';
+  }
+  return static_cast<int32_t>(text.size());
+}
+
+}  // namespace
+
+bool ss_update_hash_file(const char* path, char* hex) {
+  uint8_t digest[Sha256::kDigestBytes];
+  if (path == nullptr || hex == nullptr || !Sha256File(path, digest)) {
+    return false;
+  }
+  CopyOut(DigestToHex(digest), hex, Sha256::kDigestBytes * 2 + 1);
+  return true;
+}
+
+bool ss_update_stage_patch(const char* bundle_root, const char* patch_path,
+                           const char* version, int32_t threads,
+                           SsBundlePatchStats* stats, char* error,
+                           int32_t error_size) {
+  if (bundle_root == nullptr || patch_path == nullptr || version == nullptr) {
+    CopyOut("missing argument", error, error_size);
+    return false;
+  }
+  const std::string staging_root = StagingPathFor(bundle_root);
+  BundlePatchStats totals;
+  std::string message;
+  if (!ApplyBundlePatch(bundle_root, patch_path, staging_root, threads,
+                        &totals, &message)) {
+    CopyOut(message, error, error_size);
+    return false;
+  }
+  if (!MarkStagedUpdateReady(staging_root, version)) {
+    RemoveTree(staging_root);
+    CopyOut("cannot mark the staged update ready", error, error_size);
+    return false;
+  }
+  if (stats != nullptr) {
+    stats->files = totals.files;
+    stats->kept = totals.kept;
+    stats->patched = totals.patched;
+    stats->added = totals.added;
+    stats->target_bytes = totals.target_bytes;
+    stats->patch_bytes = totals.patch_bytes;
+  }
+  return true;
+}
+
+int32_t ss_update_apply_staged(const char* bundle_root, char* message,
+                               int32_t message_size) {
+  if (bundle_root == nullptr) {
+    return static_cast<int32_t>(StagedUpdateResult::kNone);
+  }
+  std::string new_version;
+  std::string error;
+  StagedUpdateResult result =
+      ApplyStagedUpdate(bundle_root, &new_version, &error);
+  CopyOut(result == StagedUpdateResult::kFailed ? error : new_version,
+          message, message_size);
+  return static_cast<int32_t>(result);
+}
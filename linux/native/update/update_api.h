@@ -0,0 +1,53 @@
+#ifndef NATIVE_UPDATE_UPDATE_API_H_
+#define NATIVE_UPDATE_UPDATE_API_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/native_export.h"
+
+// C interface for lib/native/native_update_bindings.dart and for the
+// runner's launch-time swap (linux/runner/update_launcher.cc).
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Mirrors BundlePatchStats.
+typedef struct {
+  uint32_t files;
+  uint32_t kept;
+  uint32_t patched;
+  uint32_t added;
+  uint64_t target_bytes;
+  uint64_t patch_bytes;
+} SsBundlePatchStats;
+
+// Writes the lowercase hex SHA-256 of |path| and a NUL into |hex| (65
+// bytes). Returns false if the file cannot be read.
+SS_EXPORT bool ss_update_hash_file(const char* path, char* hex);
+
+// Builds and verifies the patched bundle next to |bundle_root| (see
+// staged_update.h) and marks it ready for |version|. On failure copies the
+// reason into |error| and returns false. Blocking; takes seconds for a full
+// bundle.
+SS_EXPORT bool ss_update_stage_patch(const char* bundle_root,
+                                     const char* patch_path,
+                                     const char* version,
+                                     int32_t threads,
+                                     SsBundlePatchStats* stats,
+                                     char* error,
+                                     int32_t error_size);
+
+// Swaps a ready staged update into |bundle_root|. Returns a
+// StagedUpdateResult and copies the new version, or for kFailed the reason,
+// into |message|.
+SS_EXPORT int32_t ss_update_apply_staged(const char* bundle_root,
+                                         char* message,
+                                         int32_t message_size);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // NATIVE_UPDATE_UPDATE_API_H_
@@ -0,0 +1,290 @@
+#include "channel_instrumentation.h"
+
+#include <string>
+
+#include "diagnostics/diagnostics_api.h"
+#include "glib_coroutine.h"
+#include "tracing/trace_api.h"
+
+namespace {
+
+constexpr char kDiagnosticsChannel[] = "com.silverstone/diagnostics";
+
+// How often the platform-thread lag probe fires.
+constexpr guint kLagProbeIntervalMs = 100;
+
+// How often a summary goes to the persistent log while enabled.
+constexpr guint kDumpIntervalSeconds = 60;
+
+// Original vfuncs of the messenger implementation.
+void (*original_set_message_handler)(FlBinaryMessenger*,
+                                     const gchar*,
+                                     FlBinaryMessengerMessageHandler,
+                                     gpointer,
+                                     GDestroyNotify) = nullptr;
+gboolean (*original_send_response)(FlBinaryMessenger*,
+                                   FlBinaryMessengerResponseHandle*,
+                                   GBytes*,
+                                   GError**) = nullptr;
+
+gboolean metrics_enabled = FALSE;
+guint lag_probe_source = 0;
+guint dump_source = 0;
+gint64 last_probe_us = 0;
+GQuark call_quark = 0;
+uint32_t trace_category = 0;
+uint64_t next_trace_id = 0;
+FlMethodChannel* diagnostics_channel = nullptr;
+
+// A registered handler and the data it was registered with.
+struct WrappedHandler {
+  FlBinaryMessengerMessageHandler handler;
+  gpointer user_data;
+  GDestroyNotify destroy_notify;
+};
+
+// An in-flight call, attached to its response handle. The handler may
+// reply before it returns or long after, so whichever of the two happens
+// last records the sample.
+struct InFlightCall {
+  SsChannelMethod* method;
+  gint64 start_us;
+  gboolean in_handler;
+  gboolean responded;
+  gboolean measured;  // Metrics were on when the call arrived.
+  SsChannelCallSample sample;
+  // Set while a trace session runs: the reply is an async span, since it
+  // may come long after the handler returned.
+  uint64_t trace_id;
+  uint32_t trace_name;
+};
+
+// Records the call's sample once both the handler and the reply are done.
+void finish_call(InFlightCall* call) {
+  if (call->measured) {
+    ss_diag_record_call(call->method, &call->sample);
+  }
+}
+
+void wrapped_handler_free(gpointer data) {
+  WrappedHandler* wrapped = static_cast<WrappedHandler*>(data);
+  if (wrapped->destroy_notify != nullptr) {
+    wrapped->destroy_notify(wrapped->user_data);
+  }
+  g_free(wrapped);
+}
+
+void instrumented_message_handler(FlBinaryMessenger* messenger,
+                                  const gchar* channel,
+                                  GBytes* message,
+                                  FlBinaryMessengerResponseHandle* handle,
+                                  gpointer user_data) {
+  WrappedHandler* wrapped = static_cast<WrappedHandler*>(user_data);
+  const bool tracing = ss_trace_enabled();
+  if ((!metrics_enabled && !tracing) || handle == nullptr) {
+    wrapped->handler(messenger, channel, message, handle, wrapped->user_data);
+    return;
+  }
+
+  gsize size = 0;
+  const uint8_t* data = message != nullptr
+                            ? static_cast<const uint8_t*>(
+                                  g_bytes_get_data(message, &size))
+                            : nullptr;
+  InFlightCall* call = g_new0(InFlightCall, 1);
+  call->method = ss_diag_channel_method(channel, data, size);
+  call->start_us = g_get_monotonic_time();
+  call->in_handler = TRUE;
+  call->measured = metrics_enabled;
+  call->sample.request_bytes = size;
+  int64_t trace_start_ns = 0;
+  if (tracing) {
+    call->trace_id = ++next_trace_id;
+    call->trace_name = ss_diag_method_trace_name(call->method);
+    trace_start_ns = ss_trace_now_ns();
+    ss_trace_async_begin(trace_category, call->trace_name, call->trace_id);
+  }
+
+  g_autoptr(FlBinaryMessengerResponseHandle) handle_ref =
+      FL_BINARY_MESSENGER_RESPONSE_HANDLE(g_object_ref(handle));
+  g_object_set_qdata_full(G_OBJECT(handle), call_quark, call, g_free);
+  wrapped->handler(messenger, channel, message, handle, wrapped->user_data);
+
+  call->in_handler = FALSE;
+  call->sample.handler_us = g_get_monotonic_time() - call->start_us;
+  if (tracing) {
+    ss_trace_complete(trace_category, call->trace_name, trace_start_ns,
+                      ss_trace_now_ns() - trace_start_ns);
+  }
+  if (call->responded) {
+    finish_call(call);
+    g_object_set_qdata(G_OBJECT(handle), call_quark, nullptr);
+  }
+}
+
+gboolean instrumented_send_response(FlBinaryMessenger* messenger,
+                                    FlBinaryMessengerResponseHandle* handle,
+                                    GBytes* response,
+                                    GError** error) {
+  InFlightCall* call = handle != nullptr
+                           ? static_cast<InFlightCall*>(g_object_get_qdata(
+                                 G_OBJECT(handle), call_quark))
+                           : nullptr;
+  if (call != nullptr && !call->responded) {
+    gsize size = 0;
+    const uint8_t* data = response != nullptr
+                              ? static_cast<const uint8_t*>(
+                                    g_bytes_get_data(response, &size))
+                              : nullptr;
+    call->responded = TRUE;
+    call->sample.response_us = g_get_monotonic_time() - call->start_us;
+    call->sample.response_bytes = size;
+    call->sample.status = ss_diag_response_status(data, size);
+    if (call->trace_id != 0) {
+      ss_trace_async_end(trace_category, call->trace_name, call->trace_id);
+    }
+    if (!call->in_handler) {
+      finish_call(call);
+      g_object_set_qdata(G_OBJECT(handle), call_quark, nullptr);
+    }
+  }
+  return original_send_response(messenger, handle, response, error);
+}
+
+void instrumented_set_message_handler(FlBinaryMessenger* messenger,
+                                      const gchar* channel,
+                                      FlBinaryMessengerMessageHandler handler,
+                                      gpointer user_data,
+                                      GDestroyNotify destroy_notify) {
+  if (handler == nullptr) {
+    original_set_message_handler(messenger, channel, handler, user_data,
+                                 destroy_notify);
+    return;
+  }
+  WrappedHandler* wrapped = g_new0(WrappedHandler, 1);
+  wrapped->handler = handler;
+  wrapped->user_data = user_data;
+  wrapped->destroy_notify = destroy_notify;
+  original_set_message_handler(messenger, channel,
+                               instrumented_message_handler, wrapped,
+                               wrapped_handler_free);
+}
+
+// Measures how late a periodic timer fires on the platform thread. Channel
+// messages are dispatched by the same main loop, so this is the time they
+// spend queued before their handler runs.
+gboolean lag_probe_cb(gpointer user_data) {
+  gint64 now = g_get_monotonic_time();
+  gint64 lag = now - last_probe_us - kLagProbeIntervalMs * 1000;
+  ss_diag_record_platform_lag(lag > 0 ? lag : 0);
+  last_probe_us = now;
+  return G_SOURCE_CONTINUE;
+}
+
+gboolean dump_cb(gpointer user_data) {
+  ss_diag_log_summary();
+  return G_SOURCE_CONTINUE;
+}
+
+void set_enabled(gboolean enabled) {
+  metrics_enabled = enabled;
+  ss_diag_set_enabled(enabled);
+  if (enabled && lag_probe_source == 0) {
+    last_probe_us = g_get_monotonic_time();
+    lag_probe_source =
+        g_timeout_add(kLagProbeIntervalMs, lag_probe_cb, nullptr);
+    dump_source =
+        g_timeout_add_seconds(kDumpIntervalSeconds, dump_cb, nullptr);
+  } else if (!enabled && lag_probe_source != 0) {
+    g_source_remove(lag_probe_source);
+    g_source_remove(dump_source);
+    lag_probe_source = 0;
+    dump_source = 0;
+  }
+}
+
+FlMethodResponse* diagnostics_call(FlMethodCall* method_call) {
+  const gchar* method = fl_method_call_get_name(method_call);
+  FlValue* args = fl_method_call_get_args(method_call);
+
+  if (g_strcmp0(method, "setEnabled") == 0) {
+    if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_BOOL) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new(
+          "INVALID_ARGS", "Expected boolean argument", nullptr));
+    }
+    set_enabled(fl_value_get_bool(args));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+  }
+  if (g_strcmp0(method, "reset") == 0) {
+    ss_diag_reset();
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+  }
+  return FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+}
+
+// Serializing every method's histograms takes a while with many channels,
+// and the telemetry window holds hundreds of samples, so both happen on a
+// worker. |read_json| is ss_diag_get_json() or ss_diag_get_process_json().
+Task<FlMethodResponse*> get_json(int32_t (*read_json)(char*, int32_t)) {
+  std::string json = co_await RunInBackground([read_json] {
+    std::string text;
+    int32_t length = read_json(nullptr, 0);
+    do {
+      // Retried if the data grew between the two calls.
+      text.assign(length + 1, '\0');
+      length = read_json(text.data(), static_cast<int32_t>(text.size()));
+    } while (static_cast<size_t>(length) >= text.size());
+    text.resize(length);
+    return text;
+  });
+  g_autoptr(FlValue) result = fl_value_new_string(json.c_str());
+  co_return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+void diagnostics_method_cb(FlMethodChannel* channel,
+                           FlMethodCall* method_call,
+                           gpointer user_data) {
+  const gchar* method = fl_method_call_get_name(method_call);
+  if (g_strcmp0(method, "getChannelMetrics") == 0) {
+    method_call_respond_async(method_call, get_json(ss_diag_get_json));
+    return;
+  }
+  if (g_strcmp0(method, "getProcessTelemetry") == 0) {
+    method_call_respond_async(method_call,
+                              get_json(ss_diag_get_process_json));
+    return;
+  }
+  g_autoptr(FlMethodResponse) response = diagnostics_call(method_call);
+  g_autoptr(GError) error = nullptr;
+  if (!fl_method_call_respond(method_call, response, &error)) {
+    g_warning("Failed to send diagnostics response: %s", error->message);
+  }
+}
+
+}  // namespace
+
+void channel_instrumentation_install(FlBinaryMessenger* messenger) {
+  if (original_set_message_handler == nullptr) {
+    // The interface struct is shared by every messenger of this class, so
+    // this wraps the engine's messenger and anything created later.
+    FlBinaryMessengerInterface* iface =
+        FL_BINARY_MESSENGER_GET_IFACE(messenger);
+    original_set_message_handler = iface->set_message_handler_on_channel;
+    original_send_response = iface->send_response;
+    iface->set_message_handler_on_channel = instrumented_set_message_handler;
+    iface->send_response = instrumented_send_response;
+    call_quark = g_quark_from_static_string("ss-channel-call");
+    trace_category = ss_trace_intern("channel");
+  }
+
+  g_autoptr(FlStandardMethodCodec) codec = fl_standard_method_codec_new();
+  g_clear_object(&diagnostics_channel);
+  diagnostics_channel = fl_method_channel_new(
+      messenger, kDiagnosticsChannel, FL_METHOD_CODEC(codec));
+  fl_method_channel_set_method_call_handler(
+      diagnostics_channel, diagnostics_method_cb, nullptr, nullptr);
+
+  if (g_strcmp0(g_getenv("SS_CHANNEL_METRICS"), "1") == 0) {
+    set_enabled(TRUE);
+  }
+}
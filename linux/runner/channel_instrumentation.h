@@ -0,0 +1,23 @@
+#ifndef FLUTTER_CHANNEL_INSTRUMENTATION_H_
+#define FLUTTER_CHANNEL_INSTRUMENTATION_H_
+
+#include <flutter_linux/flutter_linux.h>
+
+/**
+ * channel_instrumentation_install:
+ * @messenger: the engine's binary messenger.
+ *
+ * Wraps every platform-channel handler registered on @messenger from now on
+ * so calls are counted and timed (see linux/native/diagnostics), and
+ * registers the "com.silverstone/diagnostics" channel. Must run before
+ * plugins are registered.
+ *
+ * Metrics are off until enabled through the diagnostics channel or by
+ * starting the app with SS_CHANNEL_METRICS=1. While a trace session runs
+ * (see trace_control.h) each call also shows up in the trace, as a span for
+ * the handler and an async span until the reply. With both off, each
+ * message costs two extra branches.
+ */
+void channel_instrumentation_install(FlBinaryMessenger* messenger);
+
+#endif  // FLUTTER_CHANNEL_INSTRUMENTATION_H_
@@ -0,0 +1,266 @@
+#include "desktop_notifications.h"
+
+#include <gio/gio.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#include "runner/notification_dispatcher.h"
+
+namespace {
+
+constexpr char kNotificationsChannel[] = "com.silverstone/notifications";
+constexpr char kServerName[] = "org.freedesktop.Notifications";
+constexpr char kServerPath[] = "/org/freedesktop/Notifications";
+// The name the local_notifier toasts go by on other platforms.
+constexpr char kAppName[] = "Work Tracker";
+
+class DesktopNotificationBackend;
+
+GtkWindow* main_window = nullptr;
+FlMethodChannel* notifications_channel = nullptr;
+GDBusConnection* connection = nullptr;
+guint signal_subscription = 0;
+DesktopNotificationBackend* backend = nullptr;
+NotificationDispatcher* dispatcher = nullptr;
+guint tick_source = 0;
+
+gint64 now_ms() {
+  return g_get_monotonic_time() / 1000;
+}
+
+guchar urgency(NotificationPriority priority) {
+  switch (priority) {
+    case NotificationPriority::kHigh:
+      return 2;
+    case NotificationPriority::kLow:
+      return 0;
+    default:
+      return 1;
+  }
+}
+
+gboolean tick_cb(gpointer user_data) {
+  tick_source = 0;
+  if (dispatcher != nullptr) {
+    dispatcher->Tick(now_ms());
+  }
+  return G_SOURCE_REMOVE;
+}
+
+void notify_cb(GObject* source, GAsyncResult* result, gpointer user_data) {
+  const uint64_t handle = GPOINTER_TO_SIZE(user_data);
+  g_autoptr(GError) error = nullptr;
+  g_autoptr(GVariant) reply = g_dbus_connection_call_finish(
+      G_DBUS_CONNECTION(source), result, &error);
+  guint32 server_id = 0;
+  if (reply != nullptr) {
+    g_variant_get(reply, "(u)", &server_id);
+  } else {
+    g_warning("Notification not shown: %s", error->message);
+  }
+  if (dispatcher != nullptr) {
+    dispatcher->OnShown(handle, server_id);
+  }
+}
+
+class DesktopNotificationBackend : public NotificationBackend {
+ public:
+  void Show(uint64_t handle, const NotificationDigest& digest) override {
+    GVariantBuilder actions;
+    g_variant_builder_init(&actions, G_VARIANT_TYPE_STRARRAY);
+    // Clicking the popup itself.
+    g_variant_builder_add(&actions, "s", "default");
+    g_variant_builder_add(&actions, "s", "");
+    for (const NotificationButton& button : digest.buttons) {
+      g_variant_builder_add(&actions, "s", button.key.c_str());
+      g_variant_builder_add(&actions, "s", button.label.c_str());
+    }
+    GVariantBuilder hints;
+    g_variant_builder_init(&hints, G_VARIANT_TYPE_VARDICT);
+    g_variant_builder_add(&hints, "{sv}", "urgency",
+                          g_variant_new_byte(urgency(digest.priority)));
+    g_variant_builder_add(&hints, "{sv}", "desktop-entry",
+                          g_variant_new_string(APPLICATION_ID));
+    g_dbus_connection_call(
+        connection, kServerName, kServerPath, kServerName, "Notify",
+        g_variant_new("(susssasa{sv}i)", kAppName, 0u, "",
+                      digest.title.c_str(), digest.body.c_str(), &actions,
+                      &hints, -1),
+        G_VARIANT_TYPE("(u)"), G_DBUS_CALL_FLAGS_NONE, -1, nullptr,
+        notify_cb, GSIZE_TO_POINTER(handle));
+  }
+
+  void ScheduleTick(int64_t due_ms) override {
+    if (tick_source != 0) {
+      g_source_remove(tick_source);
+      tick_source = 0;
+    }
+    if (due_ms != NotificationDispatcher::kNoTick) {
+      const int64_t delay_ms = std::max<int64_t>(0, due_ms - now_ms());
+      tick_source =
+          g_timeout_add(static_cast<guint>(delay_ms), tick_cb, nullptr);
+    }
+  }
+};
+
+void send_action(const NotificationResponse& response) {
+  g_autoptr(FlValue) ids = fl_value_new_list();
+  for (const std::string& id : response.event_ids) {
+    fl_value_append_take(ids, fl_value_new_string(id.c_str()));
+  }
+  g_autoptr(FlValue) args = fl_value_new_map();
+  fl_value_set_string_take(args, "action",
+                           fl_value_new_string(response.action.c_str()));
+  fl_value_set_string(args, "ids", ids);
+  fl_method_channel_invoke_method(notifications_channel, "action", args,
+                                  nullptr, nullptr, nullptr);
+}
+
+void server_signal_cb(GDBusConnection* bus, const gchar* sender_name,
+                      const gchar* object_path, const gchar* interface_name,
+                      const gchar* signal_name, GVariant* parameters,
+                      gpointer user_data) {
+  if (dispatcher == nullptr) {
+    return;
+  }
+  if (g_strcmp0(signal_name, "ActionInvoked") == 0 &&
+      g_variant_is_of_type(parameters, G_VARIANT_TYPE("(us)"))) {
+    guint32 server_id;
+    const gchar* action;
+    g_variant_get(parameters, "(u&s)", &server_id, &action);
+    NotificationResponse response;
+    if (!dispatcher->OnAction(server_id, action, &response)) {
+      // Another application's popup; the signal goes to everyone.
+      return;
+    }
+    gtk_widget_show(GTK_WIDGET(main_window));
+    gtk_window_present(main_window);
+    send_action(response);
+  } else if (g_strcmp0(signal_name, "NotificationClosed") == 0 &&
+             g_variant_is_of_type(parameters, G_VARIANT_TYPE("(uu)"))) {
+    guint32 server_id;
+    g_variant_get(parameters, "(uu)", &server_id, nullptr);
+    dispatcher->OnClosed(server_id);
+  }
+}
+
+// Returns a string member of |args|, or "" if missing.
+std::string lookup_string(FlValue* args, const char* key) {
+  FlValue* value = fl_value_lookup_string(args, key);
+  if (value == nullptr || fl_value_get_type(value) != FL_VALUE_TYPE_STRING) {
+    return std::string();
+  }
+  return fl_value_get_string(value);
+}
+
+FlMethodResponse* show(FlValue* args) {
+  if (dispatcher == nullptr) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "UNAVAILABLE", "No session bus", nullptr));
+  }
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "INVALID_ARGS", "Expected a map", nullptr));
+  }
+  NotificationEvent event;
+  event.id = lookup_string(args, "id");
+  event.type = lookup_string(args, "type");
+  event.title = lookup_string(args, "title");
+  event.body = lookup_string(args, "body");
+  event.group_title = lookup_string(args, "groupTitle");
+  FlValue* priority = fl_value_lookup_string(args, "priority");
+  if (priority != nullptr &&
+      fl_value_get_type(priority) == FL_VALUE_TYPE_INT) {
+    event.priority = static_cast<NotificationPriority>(std::clamp<int64_t>(
+        fl_value_get_int(priority), 0, kNotificationLanes - 1));
+  }
+  // Flat: key, label, key, label...
+  FlValue* buttons = fl_value_lookup_string(args, "buttons");
+  if (buttons != nullptr && fl_value_get_type(buttons) == FL_VALUE_TYPE_LIST) {
+    for (size_t i = 0; i + 1 < fl_value_get_length(buttons); i += 2) {
+      FlValue* key = fl_value_get_list_value(buttons, i);
+      FlValue* label = fl_value_get_list_value(buttons, i + 1);
+      if (fl_value_get_type(key) == FL_VALUE_TYPE_STRING &&
+          fl_value_get_type(label) == FL_VALUE_TYPE_STRING) {
+        event.buttons.push_back(
+            {fl_value_get_string(key), fl_value_get_string(label)});
+      }
+    }
+  }
+  dispatcher->Submit(std::move(event), now_ms());
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+}
+
+void notifications_method_cb(FlMethodChannel* channel,
+                             FlMethodCall* method_call, gpointer user_data) {
+  const gchar* method = fl_method_call_get_name(method_call);
+  g_autoptr(FlMethodResponse) response = nullptr;
+  if (g_strcmp0(method, "show") == 0) {
+    response = show(fl_method_call_get_args(method_call));
+  } else {
+    response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+  }
+  g_autoptr(GError) error = nullptr;
+  if (!fl_method_call_respond(method_call, response, &error)) {
+    g_warning("Failed to send notifications response: %s", error->message);
+  }
+}
+
+}  // namespace
+
+void desktop_notifications_attach(GtkWindow* window, FlEngine* engine) {
+  main_window = window;
+  g_autoptr(FlStandardMethodCodec) codec = fl_standard_method_codec_new();
+  notifications_channel =
+      fl_method_channel_new(fl_engine_get_binary_messenger(engine),
+                            kNotificationsChannel, FL_METHOD_CODEC(codec));
+  fl_method_channel_set_method_call_handler(
+      notifications_channel, notifications_method_cb, nullptr, nullptr);
+
+  // The application's own connection, so attaching never blocks.
+  GApplication* application =
+      G_APPLICATION(gtk_window_get_application(window));
+  GDBusConnection* bus = application != nullptr
+                             ? g_application_get_dbus_connection(application)
+                             : nullptr;
+  if (bus == nullptr) {
+    g_message("Notifications: no session bus, Dart shows toasts itself");
+    return;
+  }
+  connection = G_DBUS_CONNECTION(g_object_ref(bus));
+  signal_subscription = g_dbus_connection_signal_subscribe(
+      connection, kServerName, kServerName, nullptr, kServerPath, nullptr,
+      G_DBUS_SIGNAL_FLAGS_NONE, server_signal_cb, nullptr, nullptr);
+  backend = new DesktopNotificationBackend();
+  dispatcher = new NotificationDispatcher(backend);
+}
+
+void desktop_notifications_detach() {
+  if (dispatcher != nullptr) {
+    const NotificationStats stats = dispatcher->stats();
+    if (stats.submitted > 0) {
+      g_message("Notifications: %" G_GUINT64_FORMAT " events in %"
+                G_GUINT64_FORMAT " popups (%" G_GUINT64_FORMAT
+                " failed, %" G_GUINT64_FORMAT " dropped at exit)",
+                stats.submitted, stats.popups, stats.failed, stats.pending);
+    }
+  }
+  if (tick_source != 0) {
+    g_source_remove(tick_source);
+    tick_source = 0;
+  }
+  // Replies still in flight see the null dispatcher and do nothing.
+  delete dispatcher;
+  dispatcher = nullptr;
+  delete backend;
+  backend = nullptr;
+  if (signal_subscription != 0) {
+    g_dbus_connection_signal_unsubscribe(connection, signal_subscription);
+    signal_subscription = 0;
+  }
+  g_clear_object(&connection);
+  g_clear_object(&notifications_channel);
+  main_window = nullptr;
+}
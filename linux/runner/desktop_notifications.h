@@ -0,0 +1,33 @@
+#ifndef FLUTTER_DESKTOP_NOTIFICATIONS_H_
+#define FLUTTER_DESKTOP_NOTIFICATIONS_H_
+
+#include <flutter_linux/flutter_linux.h>
+#include <gtk/gtk.h>
+
+/**
+ * desktop_notifications_attach:
+ * @window: the main window.
+ * @engine: the engine running in @window.
+ *
+ * Shows the toasts Dart asks for with "show" on the
+ * "com.silverstone/notifications" channel, through the native dispatcher
+ * (linux/native/runner/notification_dispatcher.h): same-type events that
+ * arrive close together become one digest, a token bucket caps the popup
+ * rate and approvals go before announcements. Popups are sent straight to
+ * org.freedesktop.Notifications with an "Open" button; nothing polls, the
+ * only timer is the dispatcher's next deadline.
+ *
+ * When a popup or its button is used, @window is presented and Dart gets a
+ * single "action" call with the action and the ids of every event in the
+ * popup. Without a session bus "show" fails and Dart shows toasts itself.
+ */
+void desktop_notifications_attach(GtkWindow* window, FlEngine* engine);
+
+/**
+ * desktop_notifications_detach:
+ *
+ * Drops whatever is still waiting and stops listening to the server.
+ */
+void desktop_notifications_detach();
+
+#endif  // FLUTTER_DESKTOP_NOTIFICATIONS_H_
@@ -0,0 +1,243 @@
+#include "display_monitors.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "tracing/trace_api.h"
+
+namespace {
+
+constexpr char kMonitorsChannel[] = "com.silverstone/monitors";
+
+GdkDisplay* display = nullptr;
+GdkScreen* screen = nullptr;
+FlMethodChannel* monitors_channel = nullptr;
+MonitorTopology* topology = nullptr;
+guint refresh_source = 0;
+
+uint32_t category_window = 0;
+uint32_t name_changed = 0;
+
+ScreenRect to_screen_rect(const GdkRectangle& rect) {
+  return {rect.x, rect.y, rect.x + rect.width, rect.y + rect.height};
+}
+
+std::vector<MonitorInfo> read_monitors() {
+  std::vector<MonitorInfo> monitors;
+  const int count = gdk_display_get_n_monitors(display);
+  monitors.reserve(count);
+  for (int i = 0; i < count; i++) {
+    GdkMonitor* monitor = gdk_display_get_monitor(display, i);
+    GdkRectangle rect;
+    MonitorInfo info;
+    gdk_monitor_get_geometry(monitor, &rect);
+    info.geometry = to_screen_rect(rect);
+    gdk_monitor_get_workarea(monitor, &rect);
+    info.workarea = to_screen_rect(rect);
+    info.scale_factor = gdk_monitor_get_scale_factor(monitor);
+    info.primary = gdk_monitor_is_primary(monitor);
+    const char* model = gdk_monitor_get_model(monitor);
+    info.model = model != nullptr ? model : "";
+    monitors.push_back(std::move(info));
+  }
+  return monitors;
+}
+
+FlValue* rect_value(const ScreenRect& rect) {
+  FlValue* value = fl_value_new_map();
+  fl_value_set_string_take(value, "x", fl_value_new_float(rect.left));
+  fl_value_set_string_take(value, "y", fl_value_new_float(rect.top));
+  fl_value_set_string_take(value, "width",
+                           fl_value_new_float(rect.right - rect.left));
+  fl_value_set_string_take(value, "height",
+                           fl_value_new_float(rect.bottom - rect.top));
+  return value;
+}
+
+FlValue* topology_value() {
+  FlValue* list = fl_value_new_list();
+  for (const MonitorInfo& monitor : topology->monitors()) {
+    FlValue* value = fl_value_new_map();
+    fl_value_set_string_take(value, "geometry", rect_value(monitor.geometry));
+    fl_value_set_string_take(value, "workarea", rect_value(monitor.workarea));
+    fl_value_set_string_take(value, "scaleFactor",
+                             fl_value_new_int(monitor.scale_factor));
+    fl_value_set_string_take(value, "primary",
+                             fl_value_new_bool(monitor.primary));
+    fl_value_set_string_take(value, "model",
+                             fl_value_new_string(monitor.model.c_str()));
+    fl_value_append_take(list, value);
+  }
+  FlValue* value = fl_value_new_map();
+  fl_value_set_string_take(
+      value, "generation",
+      fl_value_new_int(static_cast<int64_t>(topology->generation())));
+  fl_value_set_string_take(value, "monitors", list);
+  return value;
+}
+
+gboolean refresh_cb(gpointer user_data) {
+  refresh_source = 0;
+  if (topology == nullptr || !topology->Update(read_monitors())) {
+    return G_SOURCE_REMOVE;
+  }
+  ss_trace_instant(category_window, name_changed);
+  g_autoptr(FlValue) value = topology_value();
+  fl_method_channel_invoke_method(monitors_channel, "changed", value, nullptr,
+                                  nullptr, nullptr);
+  return G_SOURCE_REMOVE;
+}
+
+// A hotplug or mode change sends a burst of these; one refresh covers it.
+void schedule_refresh() {
+  if (refresh_source == 0) {
+    refresh_source = g_idle_add(refresh_cb, nullptr);
+  }
+}
+
+void monitor_notify_cb(GObject* object, GParamSpec* pspec,
+                       gpointer user_data) {
+  schedule_refresh();
+}
+
+void watch_monitor(GdkMonitor* monitor) {
+  g_signal_connect(monitor, "notify", G_CALLBACK(monitor_notify_cb),
+                   nullptr);
+}
+
+void unwatch_monitor(GdkMonitor* monitor) {
+  g_signal_handlers_disconnect_by_func(
+      monitor, reinterpret_cast<gpointer>(monitor_notify_cb), nullptr);
+}
+
+void monitor_added_cb(GdkDisplay* source, GdkMonitor* monitor,
+                      gpointer user_data) {
+  watch_monitor(monitor);
+  schedule_refresh();
+}
+
+void monitor_removed_cb(GdkDisplay* source, GdkMonitor* monitor,
+                        gpointer user_data) {
+  unwatch_monitor(monitor);
+  schedule_refresh();
+}
+
+// The primary monitor and, on X11, the work area only show up here.
+void screen_changed_cb(GdkScreen* source, gpointer user_data) {
+  schedule_refresh();
+}
+
+// Returns a number member of |args| rounded to whole pixels, or 0.
+int lookup_pixels(FlValue* args, const char* key) {
+  FlValue* value = fl_value_lookup_string(args, key);
+  if (value == nullptr) {
+    return 0;
+  }
+  switch (fl_value_get_type(value)) {
+    case FL_VALUE_TYPE_FLOAT:
+      return static_cast<int>(fl_value_get_float(value) + 0.5);
+    case FL_VALUE_TYPE_INT:
+      return static_cast<int>(fl_value_get_int(value));
+    default:
+      return 0;
+  }
+}
+
+FlMethodResponse* place(FlValue* args, bool snap) {
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "INVALID_ARGS", "Expected a map", nullptr));
+  }
+  const int x = lookup_pixels(args, "x");
+  const int y = lookup_pixels(args, "y");
+  const ScreenRect rect = {x, y, x + lookup_pixels(args, "width"),
+                           y + lookup_pixels(args, "height")};
+  const ScreenRect placed =
+      snap ? topology->SnapToRightEdge(rect) : topology->Clamp(rect);
+  g_autoptr(FlValue) value = fl_value_new_map();
+  fl_value_set_string_take(value, "x", fl_value_new_float(placed.left));
+  fl_value_set_string_take(value, "y", fl_value_new_float(placed.top));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(value));
+}
+
+void monitors_method_cb(FlMethodChannel* channel, FlMethodCall* method_call,
+                        gpointer user_data) {
+  const gchar* method = fl_method_call_get_name(method_call);
+  FlValue* args = fl_method_call_get_args(method_call);
+  g_autoptr(FlMethodResponse) response = nullptr;
+  if (g_strcmp0(method, "get") == 0) {
+    g_autoptr(FlValue) value = topology_value();
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(value));
+  } else if (g_strcmp0(method, "clamp") == 0) {
+    response = place(args, false);
+  } else if (g_strcmp0(method, "snapToRightEdge") == 0) {
+    response = place(args, true);
+  } else {
+    response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+  }
+  g_autoptr(GError) error = nullptr;
+  if (!fl_method_call_respond(method_call, response, &error)) {
+    g_warning("Failed to send monitors response: %s", error->message);
+  }
+}
+
+}  // namespace
+
+void display_monitors_attach(GtkWindow* window, FlEngine* engine) {
+  category_window = ss_trace_intern("window");
+  name_changed = ss_trace_intern("monitors changed");
+
+  display =
+      GDK_DISPLAY(g_object_ref(gtk_widget_get_display(GTK_WIDGET(window))));
+  screen = GDK_SCREEN(g_object_ref(gtk_window_get_screen(window)));
+  topology = new MonitorTopology();
+  topology->Update(read_monitors());
+  for (int i = 0; i < gdk_display_get_n_monitors(display); i++) {
+    watch_monitor(gdk_display_get_monitor(display, i));
+  }
+  g_signal_connect(display, "monitor-added", G_CALLBACK(monitor_added_cb),
+                   nullptr);
+  g_signal_connect(display, "monitor-removed",
+                   G_CALLBACK(monitor_removed_cb), nullptr);
+  g_signal_connect(screen, "monitors-changed", G_CALLBACK(screen_changed_cb),
+                   nullptr);
+  g_signal_connect(screen, "size-changed", G_CALLBACK(screen_changed_cb),
+                   nullptr);
+
+  g_autoptr(FlStandardMethodCodec) codec = fl_standard_method_codec_new();
+  monitors_channel =
+      fl_method_channel_new(fl_engine_get_binary_messenger(engine),
+                            kMonitorsChannel, FL_METHOD_CODEC(codec));
+  fl_method_channel_set_method_call_handler(
+      monitors_channel, monitors_method_cb, nullptr, nullptr);
+}
+
+const MonitorTopology* display_monitors_topology() {
+  return topology;
+}
+
+void display_monitors_detach() {
+  if (refresh_source != 0) {
+    g_source_remove(refresh_source);
+    refresh_source = 0;
+  }
+  g_clear_object(&monitors_channel);
+  if (display != nullptr) {
+    for (int i = 0; i < gdk_display_get_n_monitors(display); i++) {
+      unwatch_monitor(gdk_display_get_monitor(display, i));
+    }
+    g_signal_handlers_disconnect_by_func(
+        display, reinterpret_cast<gpointer>(monitor_added_cb), nullptr);
+    g_signal_handlers_disconnect_by_func(
+        display, reinterpret_cast<gpointer>(monitor_removed_cb), nullptr);
+  }
+  if (screen != nullptr) {
+    g_signal_handlers_disconnect_by_func(
+        screen, reinterpret_cast<gpointer>(screen_changed_cb), nullptr);
+  }
+  g_clear_object(&display);
+  g_clear_object(&screen);
+  delete topology;
+  topology = nullptr;
+}
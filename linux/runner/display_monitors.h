@@ -0,0 +1,44 @@
+#ifndef FLUTTER_DISPLAY_MONITORS_H_
+#define FLUTTER_DISPLAY_MONITORS_H_
+
+#include <flutter_linux/flutter_linux.h>
+#include <gtk/gtk.h>
+
+#include "runner/monitor_topology.h"
+
+/**
+ * display_monitors_attach:
+ * @window: the main window.
+ * @engine: the engine running in @window.
+ *
+ * Keeps the monitors of @window's display in a #MonitorTopology
+ * (linux/native/runner/monitor_topology.h): geometry, work area, scale
+ * factor and which is primary. It is refreshed from the display's
+ * monitor-added and monitor-removed signals, the screen's monitors-changed
+ * and size-changed, and each monitor's property notifications, coalesced
+ * into one refresh per main loop iteration. Nothing polls.
+ *
+ * Serves "com.silverstone/monitors": "get" returns the topology and its
+ * generation. "clamp" and "snapToRightEdge" take a rect ("x", "y",
+ * "width", "height", logical pixels) and return where it should go, as
+ * "x" and "y", computed here in one call. When the layout actually
+ * changes, Dart gets "changed" with the same map "get" returns.
+ */
+void display_monitors_attach(GtkWindow* window, FlEngine* engine);
+
+/**
+ * display_monitors_topology:
+ *
+ * Returns: (nullable): the current topology, for placing windows in the
+ * runner; %NULL before attaching.
+ */
+const MonitorTopology* display_monitors_topology();
+
+/**
+ * display_monitors_detach:
+ *
+ * Stops following the display.
+ */
+void display_monitors_detach();
+
+#endif  // FLUTTER_DISPLAY_MONITORS_H_
@@ -0,0 +1,238 @@
+#include "drop_ingest.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "ingest/ingest_api.h"
+#include "scheduler/pool_api.h"
+
+namespace {
+
+constexpr char kIngestChannel[] = "com.silverstone/ingest";
+
+// A drop being read. |results| collects what arrived since the last
+// "results" call.
+struct Drop {
+  int64_t id;
+  SsIngestJob* job;
+  FlValue* results;
+  gboolean done;
+  guint flush_source;
+};
+
+// A result on its way from a worker to the platform thread.
+struct IngestMessage {
+  guint key;
+  gboolean done;
+  SsIngestResult result;
+};
+
+FlMethodChannel* ingest_channel = nullptr;
+// Drops by key, a serial that is never reused, so messages for a drop that
+// has since been cancelled find nothing.
+GHashTable* drops = nullptr;
+guint next_key = 1;
+
+void drop_free(gpointer data) {
+  Drop* drop = static_cast<Drop*>(data);
+  // Cancels first; no callback runs after this.
+  ss_ingest_release(drop->job);
+  if (drop->flush_source != 0) {
+    g_source_remove(drop->flush_source);
+  }
+  fl_value_unref(drop->results);
+  g_free(drop);
+}
+
+FlValue* result_to_value(const SsIngestResult& result) {
+  FlValue* value = fl_value_new_map();
+  fl_value_set_string_take(value, "index", fl_value_new_int(result.index));
+  fl_value_set_string_take(value, "status", fl_value_new_int(result.status));
+  fl_value_set_string_take(value, "kind", fl_value_new_int(result.kind));
+  fl_value_set_string_take(value, "mime", fl_value_new_string(result.mime));
+  fl_value_set_string_take(value, "size",
+                           fl_value_new_int(static_cast<int64_t>(result.size)));
+  fl_value_set_string_take(value, "width", fl_value_new_int(result.width));
+  fl_value_set_string_take(value, "height", fl_value_new_int(result.height));
+  fl_value_set_string_take(value, "thumbnailWidth",
+                           fl_value_new_int(result.thumbnail_width));
+  fl_value_set_string_take(value, "thumbnailHeight",
+                           fl_value_new_int(result.thumbnail_height));
+  fl_value_set_string_take(value, "pages", fl_value_new_int(result.pages));
+  if (result.status == 0) {  // IngestStatus::kOk; the hash is unset otherwise.
+    fl_value_set_string_take(
+        value, "sha256",
+        fl_value_new_uint8_list(result.sha256, sizeof(result.sha256)));
+  }
+  return value;
+}
+
+// Sends everything that arrived in this main loop iteration as one call.
+gboolean flush_cb(gpointer user_data) {
+  const guint key = GPOINTER_TO_UINT(user_data);
+  Drop* drop = static_cast<Drop*>(
+      g_hash_table_lookup(drops, GUINT_TO_POINTER(key)));
+  drop->flush_source = 0;
+  g_autoptr(FlValue) args = fl_value_new_map();
+  fl_value_set_string_take(args, "id", fl_value_new_int(drop->id));
+  fl_value_set_string(args, "results", drop->results);
+  fl_value_set_string_take(args, "done", fl_value_new_bool(drop->done));
+  fl_method_channel_invoke_method(ingest_channel, "results", args, nullptr,
+                                  nullptr, nullptr);
+  fl_value_unref(drop->results);
+  drop->results = fl_value_new_list();
+  if (drop->done) {
+    g_hash_table_remove(drops, GUINT_TO_POINTER(key));
+  }
+  return G_SOURCE_REMOVE;
+}
+
+void message_cb(void* data) {
+  IngestMessage* message = static_cast<IngestMessage*>(data);
+  Drop* drop = drops != nullptr
+                   ? static_cast<Drop*>(g_hash_table_lookup(
+                         drops, GUINT_TO_POINTER(message->key)))
+                   : nullptr;
+  if (drop != nullptr) {
+    if (message->done) {
+      drop->done = TRUE;
+    } else {
+      fl_value_append_take(drop->results, result_to_value(message->result));
+    }
+    if (drop->flush_source == 0) {
+      drop->flush_source =
+          g_idle_add(flush_cb, GUINT_TO_POINTER(message->key));
+    }
+  }
+  g_free(message);
+}
+
+// On a pool worker.
+void result_cb(const SsIngestResult* result, void* user_data) {
+  IngestMessage* message = g_new0(IngestMessage, 1);
+  message->key = GPOINTER_TO_UINT(user_data);
+  message->result = *result;
+  ss_pool_post_to_main(message_cb, message);
+}
+
+// On a pool worker, after the last result.
+void done_cb(void* user_data) {
+  IngestMessage* message = g_new0(IngestMessage, 1);
+  message->key = GPOINTER_TO_UINT(user_data);
+  message->done = TRUE;
+  ss_pool_post_to_main(message_cb, message);
+}
+
+Drop* find_drop(int64_t id, guint* key) {
+  GHashTableIter iter;
+  gpointer k;
+  gpointer value;
+  g_hash_table_iter_init(&iter, drops);
+  while (g_hash_table_iter_next(&iter, &k, &value)) {
+    Drop* drop = static_cast<Drop*>(value);
+    if (drop->id == id) {
+      *key = GPOINTER_TO_UINT(k);
+      return drop;
+    }
+  }
+  return nullptr;
+}
+
+// Returns an int member of |args|, or |fallback| if missing.
+int64_t lookup_int(FlValue* args, const char* key, int64_t fallback) {
+  FlValue* value = fl_value_lookup_string(args, key);
+  if (value == nullptr || fl_value_get_type(value) != FL_VALUE_TYPE_INT) {
+    return fallback;
+  }
+  return fl_value_get_int(value);
+}
+
+FlMethodResponse* start(FlValue* args) {
+  FlValue* id = args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                    ? fl_value_lookup_string(args, "id")
+                    : nullptr;
+  FlValue* paths = id != nullptr ? fl_value_lookup_string(args, "paths")
+                                 : nullptr;
+  if (id == nullptr || fl_value_get_type(id) != FL_VALUE_TYPE_INT ||
+      paths == nullptr || fl_value_get_type(paths) != FL_VALUE_TYPE_LIST) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "INVALID_ARGS", "Expected {id, paths}", nullptr));
+  }
+  std::vector<const char*> path_list;
+  for (size_t i = 0; i < fl_value_get_length(paths); i++) {
+    FlValue* path = fl_value_get_list_value(paths, i);
+    path_list.push_back(fl_value_get_type(path) == FL_VALUE_TYPE_STRING
+                            ? fl_value_get_string(path)
+                            : "");
+  }
+  SsIngestLimits limits;
+  limits.max_image_bytes = lookup_int(args, "maxImageBytes", 20 << 20);
+  limits.max_file_bytes = lookup_int(args, "maxFileBytes", 50 << 20);
+  limits.thumbnail_size =
+      static_cast<int32_t>(lookup_int(args, "thumbnailSize", 120));
+
+  const guint key = next_key++;
+  Drop* drop = g_new0(Drop, 1);
+  drop->id = fl_value_get_int(id);
+  drop->results = fl_value_new_list();
+  // In the table before any result can be posted.
+  g_hash_table_insert(drops, GUINT_TO_POINTER(key), drop);
+  drop->job = ss_ingest_start(path_list.data(),
+                              static_cast<int32_t>(path_list.size()), &limits,
+                              result_cb, done_cb, GUINT_TO_POINTER(key));
+  if (drop->job == nullptr) {
+    g_hash_table_remove(drops, GUINT_TO_POINTER(key));
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "FAILED", "Could not start ingesting", nullptr));
+  }
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+}
+
+FlMethodResponse* cancel(FlValue* args) {
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "INVALID_ARGS", "Expected {id}", nullptr));
+  }
+  guint key;
+  if (find_drop(lookup_int(args, "id", -1), &key) != nullptr) {
+    g_hash_table_remove(drops, GUINT_TO_POINTER(key));
+  }
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+}
+
+void ingest_method_cb(FlMethodChannel* channel, FlMethodCall* method_call,
+                      gpointer user_data) {
+  const gchar* method = fl_method_call_get_name(method_call);
+  FlValue* args = fl_method_call_get_args(method_call);
+  g_autoptr(FlMethodResponse) response = nullptr;
+  if (g_strcmp0(method, "start") == 0) {
+    response = start(args);
+  } else if (g_strcmp0(method, "cancel") == 0) {
+    response = cancel(args);
+  } else {
+    response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+  }
+  g_autoptr(GError) error = nullptr;
+  if (!fl_method_call_respond(method_call, response, &error)) {
+    g_warning("Failed to send ingest response: %s", error->message);
+  }
+}
+
+}  // namespace
+
+void drop_ingest_attach(FlEngine* engine) {
+  drops = g_hash_table_new_full(g_direct_hash, g_direct_equal, nullptr,
+                                drop_free);
+  g_autoptr(FlStandardMethodCodec) codec = fl_standard_method_codec_new();
+  ingest_channel =
+      fl_method_channel_new(fl_engine_get_binary_messenger(engine),
+                            kIngestChannel, FL_METHOD_CODEC(codec));
+  fl_method_channel_set_method_call_handler(ingest_channel, ingest_method_cb,
+                                            nullptr, nullptr);
+}
+
+void drop_ingest_detach() {
+  // Messages still queued for the main thread find no drop.
+  g_clear_pointer(&drops, g_hash_table_unref);
+  g_clear_object(&ingest_channel);
+}
@@ -0,0 +1,28 @@
+#ifndef FLUTTER_DROP_INGEST_H_
+#define FLUTTER_DROP_INGEST_H_
+
+#include <flutter_linux/flutter_linux.h>
+
+/**
+ * drop_ingest_attach:
+ * @engine: the engine running in the main window.
+ *
+ * Handles the "com.silverstone/ingest" channel, which the task dialogs use
+ * for files dropped on them. "start" takes a map with the drop's "id", its
+ * "paths" and optionally "maxImageBytes", "maxFileBytes" and
+ * "thumbnailSize"; every file is sniffed, size-checked and hashed on the
+ * shared worker pool (linux/native/ingest/ingest_api.h). Results go back as
+ * "results" calls with the id, the files finished since the last call and
+ * whether the drop is done, so the first files show up while large ones are
+ * still being read. "cancel" with the id drops the rest.
+ */
+void drop_ingest_attach(FlEngine* engine);
+
+/**
+ * drop_ingest_detach:
+ *
+ * Cancels the drops still being read.
+ */
+void drop_ingest_detach();
+
+#endif  // FLUTTER_DROP_INGEST_H_
@@ -0,0 +1,84 @@
+#include "floating_layer_shell.h"
+
+#ifdef HAVE_GTK_LAYER_SHELL
+#include <gtk-layer-shell.h>
+#endif
+
+#ifdef HAVE_GTK_LAYER_SHELL
+namespace {
+
+// The monitor the surface is on once mapped, the first one before.
+GdkMonitor* window_monitor(GtkWindow* window) {
+  GdkDisplay* display = gtk_widget_get_display(GTK_WIDGET(window));
+  GdkWindow* gdk_window = gtk_widget_get_window(GTK_WIDGET(window));
+  GdkMonitor* monitor = gtk_layer_get_monitor(window);
+  if (monitor == nullptr && gdk_window != nullptr &&
+      gtk_widget_get_mapped(GTK_WIDGET(window))) {
+    monitor = gdk_display_get_monitor_at_window(display, gdk_window);
+  }
+  if (monitor == nullptr) {
+    monitor = gdk_display_get_monitor(display, 0);
+  }
+  return monitor;
+}
+
+void monitor_geometry(GtkWindow* window, GdkRectangle* geometry) {
+  GdkMonitor* monitor = window_monitor(window);
+  if (monitor != nullptr) {
+    gdk_monitor_get_geometry(monitor, geometry);
+  } else {
+    *geometry = {0, 0, 0, 0};
+  }
+}
+
+}  // namespace
+#endif
+
+gboolean floating_layer_shell_init(GtkWindow* window) {
+#ifdef HAVE_GTK_LAYER_SHELL
+  if (!gtk_layer_is_supported()) {
+    return FALSE;
+  }
+  gtk_layer_init_for_window(window);
+  gtk_layer_set_namespace(window, APPLICATION_ID);
+  gtk_layer_set_layer(window, GTK_LAYER_SHELL_LAYER_OVERLAY);
+  gtk_layer_set_anchor(window, GTK_LAYER_SHELL_EDGE_RIGHT, TRUE);
+  gtk_layer_set_anchor(window, GTK_LAYER_SHELL_EDGE_TOP, TRUE);
+  // Floats over panels rather than pushing windows aside.
+  gtk_layer_set_exclusive_zone(window, 0);
+  // The project search field needs the keyboard, but only when clicked.
+  gtk_layer_set_keyboard_mode(window,
+                              GTK_LAYER_SHELL_KEYBOARD_MODE_ON_DEMAND);
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+void floating_layer_shell_move(GtkWindow* window, gint y) {
+#ifdef HAVE_GTK_LAYER_SHELL
+  GdkRectangle geometry;
+  monitor_geometry(window, &geometry);
+  gint width;
+  gint height;
+  gtk_window_get_size(window, &width, &height);
+  const gint top = CLAMP(y - geometry.y, 0, MAX(0, geometry.height - height));
+  gtk_layer_set_margin(window, GTK_LAYER_SHELL_EDGE_TOP, top);
+#endif
+}
+
+void floating_layer_shell_get_position(GtkWindow* window, gint* x, gint* y) {
+#ifdef HAVE_GTK_LAYER_SHELL
+  GdkRectangle geometry;
+  monitor_geometry(window, &geometry);
+  gint width;
+  gint height;
+  gtk_window_get_size(window, &width, &height);
+  *x = geometry.x + geometry.width - width -
+       gtk_layer_get_margin(window, GTK_LAYER_SHELL_EDGE_RIGHT);
+  *y = geometry.y + gtk_layer_get_margin(window, GTK_LAYER_SHELL_EDGE_TOP);
+#else
+  *x = 0;
+  *y = 0;
+#endif
+}
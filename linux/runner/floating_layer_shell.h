@@ -0,0 +1,42 @@
+#ifndef FLUTTER_FLOATING_LAYER_SHELL_H_
+#define FLUTTER_FLOATING_LAYER_SHELL_H_
+
+#include <gtk/gtk.h>
+
+/**
+ * floating_layer_shell_init:
+ * @window: the floating window, not yet realized.
+ *
+ * On a Wayland compositor with wlr-layer-shell, turns @window into a
+ * layer surface: overlay layer, anchored to the top and right edges, no
+ * exclusive zone, keyboard focus on demand. The compositor keeps it above
+ * everything and where it was put, with no configure round trips or
+ * keep-above hints. Does nothing on X11, on compositors without the
+ * protocol, or when built without gtk-layer-shell.
+ *
+ * Returns: %TRUE if @window is now a layer surface, in which case it is
+ * moved with floating_layer_shell_move() instead of gtk_window_move().
+ */
+gboolean floating_layer_shell_init(GtkWindow* window);
+
+/**
+ * floating_layer_shell_move:
+ * @window: a window set up by floating_layer_shell_init().
+ * @y: the top edge, in the same coordinates as gdk_monitor_get_geometry().
+ *
+ * Keeps @window against the right edge of its monitor at height @y.
+ */
+void floating_layer_shell_move(GtkWindow* window, gint y);
+
+/**
+ * floating_layer_shell_get_position:
+ * @window: a window set up by floating_layer_shell_init().
+ * @x: (out): the left edge.
+ * @y: (out): the top edge.
+ *
+ * Where @window is, worked out from its anchors and margins, since layer
+ * surfaces cannot ask for their position.
+ */
+void floating_layer_shell_get_position(GtkWindow* window, gint* x, gint* y);
+
+#endif  // FLUTTER_FLOATING_LAYER_SHELL_H_
@@ -0,0 +1,310 @@
+#include "floating_view.h"
+
+#include "display_monitors.h"
+#include "floating_layer_shell.h"
+#include "tracing/trace_api.h"
+
+namespace {
+
+constexpr char kFloatingViewChannel[] = "com.silverstone/floating_view";
+// FloatingWidgetConstants.fixedWidgetWidth and baseHeight.
+constexpr gint kDefaultWidth = 280;
+constexpr gint kDefaultHeight = 80;
+
+GtkWindow* main_window = nullptr;
+GtkWindow* floating_window = nullptr;
+FlView* floating_view = nullptr;
+FlMethodChannel* floating_channel = nullptr;
+gboolean placed = FALSE;
+// Positioned through wlr-layer-shell rather than gtk_window_move().
+gboolean layer_shell = FALSE;
+// Pointer events reach only this many pixels at the right edge; -1 for
+// the whole window.
+gint input_width = -1;
+
+uint32_t category_window = 0;
+uint32_t name_swap = 0;
+uint32_t name_blank = 0;
+
+// The swap in progress: the window being shown and when the other one
+// went away, so the gap between the two can be reported.
+GtkWidget* incoming = nullptr;
+gint64 outgoing_unmapped_us = 0;
+gboolean swap_traced = FALSE;
+
+// Right edge, vertically centred, on the primary monitor's work area.
+void place_at_right_edge() {
+  const MonitorTopology* topology = display_monitors_topology();
+  const MonitorInfo* monitor =
+      topology != nullptr ? topology->Primary() : nullptr;
+  if (monitor == nullptr) {
+    return;
+  }
+  const ScreenRect& area = monitor->workarea;
+  gint width;
+  gint height;
+  gtk_window_get_size(floating_window, &width, &height);
+  const gint y = area.top + (area.bottom - area.top - height) / 2;
+  if (layer_shell) {
+    floating_layer_shell_move(floating_window, y);
+  } else {
+    gtk_window_move(floating_window, area.right - width, y);
+  }
+}
+
+void get_position(gint* x, gint* y) {
+  if (layer_shell) {
+    floating_layer_shell_get_position(floating_window, x, y);
+  } else {
+    gtk_window_get_position(floating_window, x, y);
+  }
+}
+
+// The collapsed widget is a strip at the right edge; the rest of the
+// window lets clicks through to whatever is under it. The shape goes to
+// the server once per change (XShape, or wl_surface.set_input_region).
+void apply_input_region() {
+  if (input_width < 0) {
+    gtk_widget_input_shape_combine_region(GTK_WIDGET(floating_window),
+                                          nullptr);
+    return;
+  }
+  GtkAllocation allocation;
+  gtk_widget_get_allocation(GTK_WIDGET(floating_window), &allocation);
+  const cairo_rectangle_int_t strip = {
+      MAX(0, allocation.width - input_width), 0,
+      MIN(input_width, allocation.width), allocation.height};
+  cairo_region_t* region = cairo_region_create_rectangle(&strip);
+  gtk_widget_input_shape_combine_region(GTK_WIDGET(floating_window),
+                                        region);
+  cairo_region_destroy(region);
+}
+
+void size_allocate_cb(GtkWidget* widget, GdkRectangle* allocation,
+                      gpointer user_data) {
+  if (input_width >= 0) {
+    apply_input_region();
+  }
+}
+
+gboolean map_event_cb(GtkWidget* widget, GdkEvent* event,
+                      gpointer user_data) {
+  if (widget != incoming) {
+    return FALSE;
+  }
+  incoming = nullptr;
+  if (outgoing_unmapped_us != 0) {
+    ss_trace_counter(
+        category_window, name_blank,
+        (g_get_monotonic_time() - outgoing_unmapped_us) / 1000.0);
+  } else {
+    ss_trace_counter(category_window, name_blank, 0);
+  }
+  if (swap_traced) {
+    ss_trace_end(category_window, name_swap);
+    swap_traced = FALSE;
+  }
+  return FALSE;
+}
+
+gboolean unmap_event_cb(GtkWidget* widget, GdkEvent* event,
+                        gpointer user_data) {
+  // Still waiting for the other one: this is the start of a blank.
+  if (incoming != nullptr && widget != incoming) {
+    outgoing_unmapped_us = g_get_monotonic_time();
+  }
+  return FALSE;
+}
+
+// Maps |show| before unmapping |hide|, so there is never a moment with
+// neither on screen unless the server is slower to map than to unmap.
+void swap(GtkWindow* show, GtkWindow* hide) {
+  if (gtk_widget_get_visible(GTK_WIDGET(show)) &&
+      !gtk_widget_get_visible(GTK_WIDGET(hide))) {
+    return;
+  }
+  if (ss_trace_enabled()) {
+    if (swap_traced) {
+      ss_trace_end(category_window, name_swap);
+    }
+    ss_trace_begin(category_window, name_swap);
+    swap_traced = TRUE;
+  }
+  incoming = GTK_WIDGET(show);
+  outgoing_unmapped_us = 0;
+  gtk_widget_show(GTK_WIDGET(show));
+  if (show == main_window) {
+    gtk_window_present(main_window);
+  }
+  gtk_widget_hide(GTK_WIDGET(hide));
+}
+
+FlValue* frame_value() {
+  gint x;
+  gint y;
+  gint width;
+  gint height;
+  get_position(&x, &y);
+  gtk_window_get_size(floating_window, &width, &height);
+  FlValue* value = fl_value_new_map();
+  fl_value_set_string_take(value, "x", fl_value_new_float(x));
+  fl_value_set_string_take(value, "y", fl_value_new_float(y));
+  fl_value_set_string_take(value, "width", fl_value_new_float(width));
+  fl_value_set_string_take(value, "height", fl_value_new_float(height));
+  return value;
+}
+
+// Returns a number member of |args| rounded to whole pixels, or |fallback|.
+gint lookup_pixels(FlValue* args, const char* key, gint fallback) {
+  FlValue* value = args != nullptr &&
+                           fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                       ? fl_value_lookup_string(args, key)
+                       : nullptr;
+  if (value == nullptr) {
+    return fallback;
+  }
+  switch (fl_value_get_type(value)) {
+    case FL_VALUE_TYPE_FLOAT:
+      return static_cast<gint>(fl_value_get_float(value) + 0.5);
+    case FL_VALUE_TYPE_INT:
+      return static_cast<gint>(fl_value_get_int(value));
+    default:
+      return fallback;
+  }
+}
+
+void floating_method_cb(FlMethodChannel* channel, FlMethodCall* method_call,
+                        gpointer user_data) {
+  const gchar* method = fl_method_call_get_name(method_call);
+  FlValue* args = fl_method_call_get_args(method_call);
+  g_autoptr(FlMethodResponse) response = nullptr;
+  if (g_strcmp0(method, "viewId") == 0) {
+    g_autoptr(FlValue) id = fl_value_new_int(fl_view_get_id(floating_view));
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(id));
+  } else if (g_strcmp0(method, "show") == 0) {
+    if (!placed) {
+      place_at_right_edge();
+      placed = TRUE;
+    }
+    swap(floating_window, main_window);
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+  } else if (g_strcmp0(method, "hide") == 0) {
+    swap(main_window, floating_window);
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+  } else if (g_strcmp0(method, "getFrame") == 0) {
+    g_autoptr(FlValue) frame = frame_value();
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(frame));
+  } else if (g_strcmp0(method, "setSize") == 0) {
+    gint width;
+    gint height;
+    gtk_window_get_size(floating_window, &width, &height);
+    gtk_window_resize(floating_window, lookup_pixels(args, "width", width),
+                      lookup_pixels(args, "height", height));
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+  } else if (g_strcmp0(method, "setPosition") == 0) {
+    gint x;
+    gint y;
+    get_position(&x, &y);
+    if (layer_shell) {
+      // Anchored to the right edge; only the height can change.
+      floating_layer_shell_move(floating_window, lookup_pixels(args, "y", y));
+    } else {
+      gtk_window_move(floating_window, lookup_pixels(args, "x", x),
+                      lookup_pixels(args, "y", y));
+    }
+    placed = TRUE;
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+  } else if (g_strcmp0(method, "setClickThrough") == 0) {
+    input_width = lookup_pixels(args, "visibleWidth", -1);
+    apply_input_region();
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+  } else {
+    response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+  }
+  g_autoptr(GError) error = nullptr;
+  if (!fl_method_call_respond(method_call, response, &error)) {
+    g_warning("Failed to send floating view response: %s", error->message);
+  }
+}
+
+GtkWindow* create_floating_window() {
+  // A managed window rather than an override-redirect one: those never
+  // get keyboard focus, and the widget has a project search field.
+  GtkWindow* window = GTK_WINDOW(gtk_window_new(GTK_WINDOW_TOPLEVEL));
+  gtk_window_set_title(window, "Silver Stone");
+  gtk_window_set_decorated(window, FALSE);
+  gtk_window_set_resizable(window, FALSE);
+  gtk_window_set_keep_above(window, TRUE);
+  gtk_window_set_skip_taskbar_hint(window, TRUE);
+  gtk_window_set_skip_pager_hint(window, TRUE);
+  gtk_window_set_type_hint(window, GDK_WINDOW_TYPE_HINT_UTILITY);
+  gtk_window_set_default_size(window, kDefaultWidth, kDefaultHeight);
+  layer_shell = floating_layer_shell_init(window);
+  // The widget slides in from the edge over a transparent background.
+  GdkScreen* screen = gtk_window_get_screen(window);
+  GdkVisual* visual = gdk_screen_get_rgba_visual(screen);
+  if (visual != nullptr && gdk_screen_is_composited(screen)) {
+    gtk_widget_set_visual(GTK_WIDGET(window), visual);
+    gtk_widget_set_app_paintable(GTK_WIDGET(window), TRUE);
+  }
+  return window;
+}
+
+}  // namespace
+
+void floating_view_attach(GtkWindow* window, FlView* view) {
+  main_window = window;
+  category_window = ss_trace_intern("window");
+  name_swap = ss_trace_intern("window: swap");
+  name_blank = ss_trace_intern("swap blank ms");
+
+  floating_window = create_floating_window();
+  floating_view = fl_view_new_for_engine(fl_view_get_engine(view));
+  GdkRGBA transparent = {0, 0, 0, 0};
+  fl_view_set_background_color(floating_view, &transparent);
+  gtk_widget_show(GTK_WIDGET(floating_view));
+  gtk_container_add(GTK_CONTAINER(floating_window),
+                    GTK_WIDGET(floating_view));
+  // Realized now so the first "show" only has to map it.
+  gtk_widget_realize(GTK_WIDGET(floating_window));
+  g_signal_connect(floating_window, "size-allocate",
+                   G_CALLBACK(size_allocate_cb), nullptr);
+  if (layer_shell) {
+    ss_trace_instant(category_window, ss_trace_intern("floating layer shell"));
+    g_message("Floating widget: wlr-layer-shell overlay");
+  }
+
+  for (GtkWidget* widget :
+       {GTK_WIDGET(main_window), GTK_WIDGET(floating_window)}) {
+    gtk_widget_add_events(widget, GDK_STRUCTURE_MASK);
+    g_signal_connect(widget, "map-event", G_CALLBACK(map_event_cb), nullptr);
+    g_signal_connect(widget, "unmap-event", G_CALLBACK(unmap_event_cb),
+                     nullptr);
+  }
+
+  g_autoptr(FlStandardMethodCodec) codec = fl_standard_method_codec_new();
+  floating_channel = fl_method_channel_new(
+      fl_engine_get_binary_messenger(fl_view_get_engine(view)),
+      kFloatingViewChannel, FL_METHOD_CODEC(codec));
+  fl_method_channel_set_method_call_handler(
+      floating_channel, floating_method_cb, nullptr, nullptr);
+}
+
+void floating_view_detach() {
+  g_clear_object(&floating_channel);
+  if (main_window != nullptr) {
+    g_signal_handlers_disconnect_by_func(
+        main_window, reinterpret_cast<gpointer>(map_event_cb), nullptr);
+    g_signal_handlers_disconnect_by_func(
+        main_window, reinterpret_cast<gpointer>(unmap_event_cb), nullptr);
+  }
+  if (floating_window != nullptr) {
+    gtk_widget_destroy(GTK_WIDGET(floating_window));
+    floating_window = nullptr;
+  }
+  floating_view = nullptr;
+  incoming = nullptr;
+  layer_shell = FALSE;
+  input_width = -1;
+  main_window = nullptr;
+}
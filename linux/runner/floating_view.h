@@ -0,0 +1,41 @@
+#ifndef FLUTTER_FLOATING_VIEW_H_
+#define FLUTTER_FLOATING_VIEW_H_
+
+#include <flutter_linux/flutter_linux.h>
+#include <gtk/gtk.h>
+
+/**
+ * floating_view_attach:
+ * @window: the main window.
+ * @view: the view in @window.
+ *
+ * Creates the floating widget's window up front, hidden, with a second
+ * #FlView on @view's engine in it: an undecorated, always-on-top utility
+ * window, off the taskbar and transparent; under Wayland a wlr-layer-shell
+ * overlay surface instead when the compositor has it
+ * (floating_layer_shell.h). Dart renders the floating widget into that
+ * view (multi-view), so switching modes shows one window and hides the
+ * other instead of reshaping the main window.
+ *
+ * Serves "com.silverstone/floating_view": "viewId" returns the view's id;
+ * "show" maps the floating window (at the right edge of the primary
+ * monitor the first time, where it was left after that) and then hides
+ * @window; "hide" does the opposite. "getFrame", "setSize" and
+ * "setPosition" move and size the floating window, in logical pixels.
+ * "setClickThrough" with "visibleWidth" limits pointer input to that many
+ * pixels at the right edge, so the collapsed widget does not block what is
+ * behind the rest of the window; without it the whole window takes input.
+ *
+ * Each swap is traced as "window: swap" with a "swap blank ms" counter,
+ * the time neither window was mapped, which is what shows as flicker.
+ */
+void floating_view_attach(GtkWindow* window, FlView* view);
+
+/**
+ * floating_view_detach:
+ *
+ * Destroys the floating window.
+ */
+void floating_view_detach();
+
+#endif  // FLUTTER_FLOATING_VIEW_H_
@@ -0,0 +1,29 @@
+#include "glib_coroutine.h"
+
+namespace {
+
+Task<void> respond_when_done(FlMethodCall* method_call,
+                             Task<FlMethodResponse*> response_task) {
+  FlMethodResponse* response = co_await std::move(response_task);
+  // Responses must go out on the platform thread.
+  co_await ResumeOnContext(g_main_context_default());
+
+  if (response == nullptr) {
+    response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+  }
+  g_autoptr(GError) error = nullptr;
+  if (!fl_method_call_respond(method_call, response, &error)) {
+    g_warning("Failed to send response to %s: %s",
+              fl_method_call_get_name(method_call), error->message);
+  }
+  g_object_unref(response);
+  g_object_unref(method_call);
+}
+
+}  // namespace
+
+void method_call_respond_async(FlMethodCall* method_call,
+                               Task<FlMethodResponse*> response) {
+  Spawn(respond_when_done(FL_METHOD_CALL(g_object_ref(method_call)),
+                          std::move(response)));
+}
@@ -0,0 +1,87 @@
+#ifndef FLUTTER_GLIB_COROUTINE_H_
+#define FLUTTER_GLIB_COROUTINE_H_
+
+#include <flutter_linux/flutter_linux.h>
+
+#include <coroutine>
+
+#include "coro/awaitables.h"
+#include "coro/file_io.h"
+#include "coro/task.h"
+
+// GLib glue for the coroutines in linux/native/coro: awaitables that resume
+// on a GMainContext, and an adaptor that answers a method call when its
+// handler coroutine finishes. Handlers written this way return to the main
+// loop at every co_await instead of blocking the platform thread:
+//
+//   Task<FlMethodResponse*> load_settings(std::string path) {
+//     FileResult file = co_await ReadFileAsync(path);  // On a worker.
+//     ...                                              // Back on main.
+//     co_return FL_METHOD_RESPONSE(fl_method_success_response_new(value));
+//   }
+//   method_call_respond_async(method_call, load_settings(path));
+
+/**
+ * ResumeOnContext:
+ * @context: a #GMainContext.
+ *
+ * co_await ResumeOnContext(context) continues in an iteration of @context,
+ * or right away if the calling thread already owns it.
+ */
+inline auto ResumeOnContext(GMainContext* context) {
+  struct Awaiter {
+    GMainContext* context;
+    bool await_ready() noexcept { return g_main_context_is_owner(context); }
+    void await_suspend(std::coroutine_handle<> handle) noexcept {
+      g_main_context_invoke_full(
+          context, G_PRIORITY_DEFAULT,
+          [](gpointer data) -> gboolean {
+            std::coroutine_handle<>::from_address(data).resume();
+            return G_SOURCE_REMOVE;
+          },
+          handle.address(), nullptr);
+    }
+    void await_resume() noexcept {}
+  };
+  return Awaiter{context};
+}
+
+/**
+ * SleepFor:
+ * @milliseconds: how long to wait.
+ *
+ * co_await SleepFor(ms) continues on the default main context after
+ * @milliseconds, without blocking it meanwhile.
+ */
+inline auto SleepFor(guint milliseconds) {
+  struct Awaiter {
+    guint milliseconds;
+    bool await_ready() noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) noexcept {
+      g_timeout_add_full(
+          G_PRIORITY_DEFAULT, milliseconds,
+          [](gpointer data) -> gboolean {
+            std::coroutine_handle<>::from_address(data).resume();
+            return G_SOURCE_REMOVE;
+          },
+          handle.address(), nullptr);
+    }
+    void await_resume() noexcept {}
+  };
+  return Awaiter{milliseconds};
+}
+
+/**
+ * method_call_respond_async:
+ * @method_call: the call to answer.
+ * @response: (transfer full): coroutine producing the response; a %NULL
+ *   result answers "not implemented".
+ *
+ * Starts @response and answers @method_call with its result on the
+ * platform thread once it finishes, wherever it finished. Keeps
+ * @method_call alive until then, so the handler can return right away.
+ */
+void method_call_respond_async(FlMethodCall* method_call,
+                               Task<FlMethodResponse*> response);
+
+#endif  // FLUTTER_GLIB_COROUTINE_H_
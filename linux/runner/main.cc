@@ -1,6 +1,13 @@
 #include "my_application.h"
+#include "startup_prefetch.h"
+#include "update_launcher.h"
 
 int main(int argc, char** argv) {
+  update_launcher_apply_staged(argv);
+  startup_prefetch_begin();
+
   g_autoptr(MyApplication) app = my_application_new();
-  return g_application_run(G_APPLICATION(app), argc, argv);
+  const int status = g_application_run(G_APPLICATION(app), argc, argv);
+  startup_prefetch_end();
+  return status;
 }
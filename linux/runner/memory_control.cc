@@ -0,0 +1,217 @@
+#include "memory_control.h"
+
+#include <fcntl.h>
+#include <glib-unix.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "memory/memory_api.h"
+#include "scheduler/pool_api.h"
+#include "scheduler/task.h"
+#include "tracing/trace_api.h"
+
+namespace {
+
+// How often pressure and the background grace period are checked.
+constexpr guint kPollIntervalSeconds = 5;
+
+// Wakes us when tasks stalled on memory for 150 ms in a 2 s window.
+// Unprivileged triggers need the window to be a multiple of 2 s.
+constexpr char kPsiTrigger[] = "some 150000 2000000";
+
+// Between telling Flutter and trimming, so what it lets go of is free by
+// the time malloc_trim() runs.
+constexpr guint kTrimDelayMs = 500;
+
+constexpr double kMiB = 1024.0 * 1024.0;
+
+FlBasicMessageChannel* system_channel = nullptr;
+GtkWindow* watched_window = nullptr;
+guint poll_source = 0;
+guint psi_source = 0;
+int psi_fd = -1;
+gboolean trim_running = FALSE;
+gboolean iconified = FALSE;
+gboolean unmapped = FALSE;
+
+const char* reason_name(int32_t reason) {
+  switch (reason) {
+    case SS_MEMORY_TRIM_BACKGROUND:
+      return "background";
+    case SS_MEMORY_TRIM_PRESSURE:
+      return "memory pressure";
+    case SS_MEMORY_TRIM_CGROUP_LIMIT:
+      return "cgroup limit";
+    default:
+      return "requested";
+  }
+}
+
+struct TrimJob {
+  int32_t reason;
+  // RSS before Flutter was told, so its share shows in the report too.
+  uint64_t rss_before_bytes;
+  SsMemoryTrimReport report;
+};
+
+void report_trim_cb(void* data) {
+  TrimJob* job = static_cast<TrimJob*>(data);
+  g_message("Memory trim (%s): RSS %.1f -> %.1f MiB (%.1f MiB at "
+            "malloc_trim, %.1f MiB from native buffers, %" G_GINT64_FORMAT
+            " us)",
+            reason_name(job->reason), job->rss_before_bytes / kMiB,
+            job->report.rss_after_bytes / kMiB,
+            job->report.rss_before_bytes / kMiB,
+            job->report.native_released_bytes / kMiB,
+            job->report.duration_us);
+  trim_running = FALSE;
+  g_free(job);
+}
+
+void trim_task(void* data, const SsCancelToken* token) {
+  TrimJob* job = static_cast<TrimJob*>(data);
+  ss_memory_trim(job->reason, &job->report);
+}
+
+void trim_done(void* data) {
+  // Reported, and freed, back on the platform thread.
+  ss_pool_post_to_main(report_trim_cb, data);
+}
+
+gboolean start_native_trim_cb(gpointer data) {
+  ss_pool_post(static_cast<int32_t>(TaskPriority::kBackground), trim_task,
+               trim_done, data);
+  return G_SOURCE_REMOVE;
+}
+
+void notify_flutter() {
+  if (system_channel == nullptr) {
+    return;
+  }
+  g_autoptr(FlValue) message = fl_value_new_map();
+  fl_value_set_string_take(message, "type",
+                           fl_value_new_string("memoryPressure"));
+  fl_basic_message_channel_send(system_channel, message, nullptr, nullptr,
+                                nullptr);
+}
+
+void poll_memory() {
+  if (trim_running) {
+    return;
+  }
+  const int32_t reason = ss_memory_poll();
+  if (reason == SS_MEMORY_TRIM_NONE) {
+    return;
+  }
+  ss_trace_instant(ss_trace_intern("memory"),
+                   ss_trace_intern("memory pressure"));
+
+  trim_running = TRUE;
+  TrimJob* job = g_new0(TrimJob, 1);
+  job->reason = reason;
+  SsMemoryStats stats;
+  if (ss_memory_read_stats(&stats)) {
+    job->rss_before_bytes = stats.rss_bytes;
+  }
+  notify_flutter();
+  g_timeout_add(kTrimDelayMs, start_native_trim_cb, job);
+}
+
+gboolean poll_cb(gpointer user_data) {
+  poll_memory();
+  return G_SOURCE_CONTINUE;
+}
+
+gboolean psi_cb(gint fd, GIOCondition condition, gpointer user_data) {
+  if (condition & G_IO_ERR) {
+    // The trigger went away with the cgroup; the timer still polls.
+    psi_source = 0;
+    close(psi_fd);
+    psi_fd = -1;
+    return G_SOURCE_REMOVE;
+  }
+  poll_memory();
+  return G_SOURCE_CONTINUE;
+}
+
+// Registers the PSI trigger, where the kernel has PSI and lets us.
+void watch_pressure() {
+  psi_fd = open("/proc/pressure/memory", O_RDWR | O_NONBLOCK | O_CLOEXEC);
+  if (psi_fd < 0) {
+    return;
+  }
+  if (write(psi_fd, kPsiTrigger, strlen(kPsiTrigger) + 1) < 0) {
+    close(psi_fd);
+    psi_fd = -1;
+    return;
+  }
+  psi_source = g_unix_fd_add(psi_fd,
+                             static_cast<GIOCondition>(G_IO_PRI | G_IO_ERR),
+                             psi_cb, nullptr);
+}
+
+void update_hidden() {
+  ss_memory_set_hidden(iconified || unmapped);
+}
+
+gboolean window_state_cb(GtkWidget* widget, GdkEventWindowState* event,
+                         gpointer user_data) {
+  iconified = (event->new_window_state & GDK_WINDOW_STATE_ICONIFIED) != 0;
+  update_hidden();
+  return FALSE;
+}
+
+gboolean map_cb(GtkWidget* widget, GdkEvent* event, gpointer user_data) {
+  unmapped = FALSE;
+  update_hidden();
+  return FALSE;
+}
+
+// Hiding to the tray unmaps the window without iconifying it.
+gboolean unmap_cb(GtkWidget* widget, GdkEvent* event, gpointer user_data) {
+  unmapped = TRUE;
+  update_hidden();
+  return FALSE;
+}
+
+}  // namespace
+
+void memory_control_attach(GtkWindow* window, FlEngine* engine) {
+  g_autoptr(FlJsonMessageCodec) codec = fl_json_message_codec_new();
+  system_channel = fl_basic_message_channel_new(
+      fl_engine_get_binary_messenger(engine), "flutter/system",
+      FL_MESSAGE_CODEC(codec));
+
+  watched_window = window;
+  g_object_add_weak_pointer(G_OBJECT(window),
+                            reinterpret_cast<gpointer*>(&watched_window));
+  g_signal_connect(window, "window-state-event", G_CALLBACK(window_state_cb),
+                   nullptr);
+  g_signal_connect(window, "map-event", G_CALLBACK(map_cb), nullptr);
+  g_signal_connect(window, "unmap-event", G_CALLBACK(unmap_cb), nullptr);
+
+  watch_pressure();
+  poll_source = g_timeout_add_seconds(kPollIntervalSeconds, poll_cb, nullptr);
+}
+
+void memory_control_detach() {
+  g_clear_handle_id(&poll_source, g_source_remove);
+  g_clear_handle_id(&psi_source, g_source_remove);
+  if (psi_fd >= 0) {
+    close(psi_fd);
+    psi_fd = -1;
+  }
+  if (watched_window != nullptr) {
+    g_signal_handlers_disconnect_by_func(
+        watched_window, reinterpret_cast<gpointer>(window_state_cb), nullptr);
+    g_signal_handlers_disconnect_by_func(
+        watched_window, reinterpret_cast<gpointer>(map_cb), nullptr);
+    g_signal_handlers_disconnect_by_func(
+        watched_window, reinterpret_cast<gpointer>(unmap_cb), nullptr);
+    g_object_remove_weak_pointer(G_OBJECT(watched_window),
+                                 reinterpret_cast<gpointer*>(&watched_window));
+    watched_window = nullptr;
+  }
+  g_clear_object(&system_channel);
+}
@@ -0,0 +1,32 @@
+#ifndef FLUTTER_MEMORY_CONTROL_H_
+#define FLUTTER_MEMORY_CONTROL_H_
+
+#include <flutter_linux/flutter_linux.h>
+#include <gtk/gtk.h>
+
+/**
+ * memory_control_attach:
+ * @window: the main window.
+ * @engine: the engine running in @window.
+ *
+ * Gives memory back while the application is in the background or the
+ * system runs short. Whether @window is minimized or hidden (to the tray)
+ * is reported to the native memory manager, which Dart also tells about
+ * floating mode; it is polled every few seconds and, through a PSI trigger
+ * where the kernel allows one, as soon as memory stalls set in.
+ *
+ * When the manager asks for a trim, @engine gets the "memoryPressure"
+ * system message (Flutter clears its image cache), then the native
+ * services drop their idle buffers and free heap is returned with
+ * malloc_trim() on a background worker. RSS before and after is logged.
+ */
+void memory_control_attach(GtkWindow* window, FlEngine* engine);
+
+/**
+ * memory_control_detach:
+ *
+ * Stops watching; a trim already running finishes on its own.
+ */
+void memory_control_detach();
+
+#endif  // FLUTTER_MEMORY_CONTROL_H_
@@ -5,7 +5,20 @@
 #include <gdk/gdkx.h>
 #endif
 
+#include "channel_instrumentation.h"
+#include "desktop_notifications.h"
+#include "display_monitors.h"
+#include "drop_ingest.h"
+#include "floating_view.h"
 #include "flutter/generated_plugin_registrant.h"
+#include "logging/log_api.h"
+#include "memory_control.h"
+#include "startup_prefetch.h"
+#include "telemetry_sampler.h"
+#include "trace_control.h"
+#include "tray_indicator.h"
+#include "tracing/trace_api.h"
+#include "worker_pool.h"
 
 struct _MyApplication {
   GtkApplication parent_instance;
@@ -16,14 +29,20 @@ G_DEFINE_TYPE(MyApplication, my_application, GTK_TYPE_APPLICATION)
 
 // Called when first Flutter frame received.
 static void first_frame_cb(MyApplication* self, FlView* view) {
+  ss_trace_instant(ss_trace_intern("runner"), ss_trace_intern("first frame"));
+  startup_prefetch_first_frame();
   gtk_widget_show(gtk_widget_get_toplevel(GTK_WIDGET(view)));
 }
 
 // Implements GApplication::activate.
 static void my_application_activate(GApplication* application) {
   MyApplication* self = MY_APPLICATION(application);
+  const uint32_t trace_category = ss_trace_intern("runner");
+  const uint32_t trace_name = ss_trace_intern("activate");
+  ss_trace_begin(trace_category, trace_name);
   GtkWindow* window =
       GTK_WINDOW(gtk_application_window_new(GTK_APPLICATION(application)));
+  trace_control_attach(window);
 
   // Use a header bar when running in GNOME as this is the common style used
   // by applications and is the setup most users will be using (e.g. Ubuntu
@@ -73,9 +92,19 @@ static void my_application_activate(GApplication* application) {
                            self);
   gtk_widget_realize(GTK_WIDGET(view));
 
+  // Before plugins register their channels, so those get wrapped too.
+  channel_instrumentation_install(
+      fl_engine_get_binary_messenger(fl_view_get_engine(view)));
   fl_register_plugins(FL_PLUGIN_REGISTRY(view));
+  memory_control_attach(window, fl_view_get_engine(view));
+  tray_indicator_attach(window, fl_view_get_engine(view));
+  desktop_notifications_attach(window, fl_view_get_engine(view));
+  drop_ingest_attach(fl_view_get_engine(view));
+  display_monitors_attach(window, fl_view_get_engine(view));
+  floating_view_attach(window, view);
 
   gtk_widget_grab_focus(GTK_WIDGET(view));
+  ss_trace_end(trace_category, trace_name);
 }
 
 // Implements GApplication::local_command_line.
@@ -85,6 +114,7 @@ static gboolean my_application_local_command_line(GApplication* application,
   MyApplication* self = MY_APPLICATION(application);
   // Strip out the first argument as it is the binary name.
   self->dart_entrypoint_arguments = g_strdupv(*arguments + 1);
+  trace_control_take_arguments(self->dart_entrypoint_arguments);
 
   g_autoptr(GError) error = nullptr;
   if (!g_application_register(application, nullptr, &error)) {
@@ -104,6 +134,8 @@ static void my_application_startup(GApplication* application) {
   // MyApplication* self = MY_APPLICATION(object);
 
   // Perform any actions required at application startup.
+  worker_pool_attach(g_main_context_default());
+  telemetry_sampler_start();
 
   G_APPLICATION_CLASS(my_application_parent_class)->startup(application);
 }
@@ -113,6 +145,17 @@ static void my_application_shutdown(GApplication* application) {
   // MyApplication* self = MY_APPLICATION(object);
 
   // Perform any actions required at application shutdown.
+  trace_control_shutdown();
+  memory_control_detach();
+  tray_indicator_detach();
+  desktop_notifications_detach();
+  drop_ingest_detach();
+  floating_view_detach();
+  display_monitors_detach();
+  telemetry_sampler_stop();
+  worker_pool_detach();
+  // Drain whatever Dart logged last so it is on disk before exit.
+  ss_log_close();
 
   G_APPLICATION_CLASS(my_application_parent_class)->shutdown(application);
 }
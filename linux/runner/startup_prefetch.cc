@@ -0,0 +1,48 @@
+#include "startup_prefetch.h"
+
+#include <glib.h>
+
+#include "startup/prefetch_api.h"
+#include "tracing/trace_api.h"
+
+void startup_prefetch_begin() {
+  g_autoptr(GError) error = nullptr;
+  g_autofree gchar* executable = g_file_read_link("/proc/self/exe", &error);
+  if (executable == nullptr) {
+    g_warning("Cannot locate the bundle to prefetch: %s", error->message);
+    return;
+  }
+  g_autofree gchar* bundle_root = g_path_get_dirname(executable);
+  g_autofree gchar* directory =
+      g_build_filename(g_get_user_cache_dir(), APPLICATION_ID, nullptr);
+  g_mkdir_with_parents(directory, 0700);
+  g_autofree gchar* plan_path =
+      g_build_filename(directory, "startup_prefetch.plan", nullptr);
+  ss_prefetch_start(bundle_root, plan_path);
+}
+
+void startup_prefetch_first_frame() {
+  ss_prefetch_first_frame();
+  SsPrefetchStats stats;
+  ss_prefetch_get_stats(&stats);
+  const uint32_t category = ss_trace_intern("runner");
+  if (stats.recording) {
+    ss_trace_instant(category, ss_trace_intern("startup prefetch recording"));
+    return;
+  }
+  // Still reading assets the first frame did not need, most likely.
+  const int64_t start_ns = static_cast<int64_t>(stats.start_ns);
+  const int64_t end_ns = stats.end_ns != 0
+                             ? static_cast<int64_t>(stats.end_ns)
+                             : ss_trace_now_ns();
+  ss_trace_complete(category, ss_trace_intern("startup prefetch"), start_ns,
+                    end_ns - start_ns);
+  ss_trace_counter(category, ss_trace_intern("prefetch MiB"),
+                   stats.bytes / (1024.0 * 1024.0));
+  g_debug("Startup prefetch: %u files, %" G_GUINT64_FORMAT " bytes%s",
+          stats.files, stats.bytes, stats.end_ns != 0 ? "" : " so far");
+}
+
+void startup_prefetch_end() {
+  ss_prefetch_stop();
+}
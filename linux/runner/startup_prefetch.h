@@ -0,0 +1,33 @@
+#ifndef FLUTTER_STARTUP_PREFETCH_H_
+#define FLUTTER_STARTUP_PREFETCH_H_
+
+/**
+ * startup_prefetch_begin:
+ *
+ * Starts reading the bundle's engine library, ICU data, AOT snapshot and
+ * assets into the page cache on a thread of its own, in the order and
+ * ranges recorded by an earlier start (linux/native/startup/
+ * prefetch_plan.h), so a cold start waits on a few large reads instead of
+ * a page fault at a time. The plan lives under
+ * $XDG_CACHE_HOME/APPLICATION_ID; without one, or once the bundle has
+ * changed, this start records a new one instead. Call from main() right
+ * after update_launcher_apply_staged().
+ */
+void startup_prefetch_begin();
+
+/**
+ * startup_prefetch_first_frame:
+ *
+ * Records the plan when this start has none, and traces what the prefetch
+ * did as "startup prefetch", with "prefetch MiB" read so far.
+ */
+void startup_prefetch_first_frame();
+
+/**
+ * startup_prefetch_end:
+ *
+ * Stops reading and waits for a plan being written.
+ */
+void startup_prefetch_end();
+
+#endif  // FLUTTER_STARTUP_PREFETCH_H_
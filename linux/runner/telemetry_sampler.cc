@@ -0,0 +1,68 @@
+#include "telemetry_sampler.h"
+
+#include "diagnostics/diagnostics_api.h"
+#include "scheduler/pool_api.h"
+#include "scheduler/task.h"
+
+namespace {
+
+constexpr guint kDefaultIntervalSeconds = 10;
+constexpr guint kSummaryIntervalSeconds = 300;
+
+guint sample_source = 0;
+guint summary_source = 0;
+// Set while a sample is queued or running, so a stalled pool does not
+// pile them up.
+gint sample_pending = 0;
+
+void sample_task(void* data, const SsCancelToken* token) {
+  ss_diag_sample_process();
+}
+
+void sample_done(void* data) {
+  g_atomic_int_set(&sample_pending, 0);
+}
+
+gboolean sample_cb(gpointer user_data) {
+  if (g_atomic_int_compare_and_exchange(&sample_pending, 0, 1)) {
+    ss_pool_post(static_cast<int32_t>(TaskPriority::kBackground), sample_task,
+                 sample_done, nullptr);
+  }
+  return G_SOURCE_CONTINUE;
+}
+
+gboolean summary_cb(gpointer user_data) {
+  ss_diag_log_process_summary();
+  return G_SOURCE_CONTINUE;
+}
+
+guint interval_seconds() {
+  const gchar* value = g_getenv("SS_TELEMETRY_INTERVAL");
+  if (value == nullptr) {
+    return kDefaultIntervalSeconds;
+  }
+  return static_cast<guint>(g_ascii_strtoull(value, nullptr, 10));
+}
+
+}  // namespace
+
+void telemetry_sampler_start() {
+  const guint interval = interval_seconds();
+  if (interval == 0 || sample_source != 0) {
+    return;
+  }
+  // A first sample right away, so the window is never empty.
+  sample_cb(nullptr);
+  sample_source = g_timeout_add_seconds(interval, sample_cb, nullptr);
+  summary_source =
+      g_timeout_add_seconds(kSummaryIntervalSeconds, summary_cb, nullptr);
+}
+
+void telemetry_sampler_stop() {
+  if (sample_source == 0) {
+    return;
+  }
+  ss_diag_log_process_summary();
+  g_clear_handle_id(&sample_source, g_source_remove);
+  g_clear_handle_id(&summary_source, g_source_remove);
+}
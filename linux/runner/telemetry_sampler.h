@@ -0,0 +1,28 @@
+#ifndef FLUTTER_TELEMETRY_SAMPLER_H_
+#define FLUTTER_TELEMETRY_SAMPLER_H_
+
+#include <glib.h>
+
+/**
+ * telemetry_sampler_start:
+ *
+ * Samples what the process costs the machine (RSS and PSS, CPU time per
+ * thread, wakeups, open file descriptors, disk I/O; see
+ * linux/native/diagnostics/process_telemetry.h) every ten seconds on a
+ * background worker, and writes a summary to the log every five minutes.
+ * Dart reads the rolling window with "getProcessTelemetry" on the
+ * "com.silverstone/diagnostics" channel.
+ *
+ * SS_TELEMETRY_INTERVAL=<seconds> changes the sampling rate; 0 turns it
+ * off.
+ */
+void telemetry_sampler_start();
+
+/**
+ * telemetry_sampler_stop:
+ *
+ * Logs a last summary and stops sampling.
+ */
+void telemetry_sampler_stop();
+
+#endif  // FLUTTER_TELEMETRY_SAMPLER_H_
@@ -0,0 +1,172 @@
+#include "trace_control.h"
+
+#include <gdk/gdkkeysyms.h>
+
+#include "scheduler/pool_api.h"
+#include "scheduler/task.h"
+#include "tracing/trace_api.h"
+
+namespace {
+
+constexpr char kTraceFlag[] = "--trace";
+
+// Output of the running session; null means the default location.
+gchar* output_path = nullptr;
+
+uint32_t category_window = 0;
+uint32_t name_width = 0;
+uint32_t name_height = 0;
+uint32_t name_state = 0;
+
+void intern_names() {
+  if (category_window == 0) {
+    category_window = ss_trace_intern("window");
+    name_width = ss_trace_intern("width");
+    name_height = ss_trace_intern("height");
+    name_state = ss_trace_intern("window state");
+  }
+}
+
+gchar* default_output_path() {
+  g_autoptr(GDateTime) now = g_date_time_new_now_local();
+  g_autofree gchar* stamp = g_date_time_format(now, "%Y%m%d-%H%M%S");
+  g_autofree gchar* directory = g_build_filename(
+      g_get_user_data_dir(), APPLICATION_ID, "traces", nullptr);
+  if (g_mkdir_with_parents(directory, 0700) != 0) {
+    g_warning("Cannot create trace directory %s", directory);
+  }
+  g_autofree gchar* file_name = g_strdup_printf("trace-%s.json", stamp);
+  return g_build_filename(directory, file_name, nullptr);
+}
+
+void start_session(const gchar* path) {
+  g_free(output_path);
+  output_path = path != nullptr && *path != '\0' ? g_strdup(path) : nullptr;
+  intern_names();
+  ss_trace_start();
+  g_message("Trace started");
+}
+
+struct TraceWrite {
+  gchar* path;
+  gboolean ok;
+  SsTraceStats stats;
+};
+
+void trace_write_free(void* data) {
+  TraceWrite* write = static_cast<TraceWrite*>(data);
+  g_free(write->path);
+  g_free(write);
+}
+
+void report_trace_write(TraceWrite* write) {
+  if (write->ok) {
+    g_message("Trace written to %s (%" G_GUINT64_FORMAT " events, %u threads, "
+              "%" G_GUINT64_FORMAT " overwritten)",
+              write->path, write->stats.events, write->stats.threads,
+              write->stats.events_overwritten);
+  } else {
+    g_warning("Failed to write trace to %s", write->path);
+  }
+}
+
+void report_trace_write_cb(void* data) {
+  report_trace_write(static_cast<TraceWrite*>(data));
+  trace_write_free(data);
+}
+
+void write_trace_task(void* data, const SsCancelToken* token) {
+  TraceWrite* write = static_cast<TraceWrite*>(data);
+  write->ok = ss_trace_write_chrome_json(write->path, &write->stats);
+}
+
+void write_trace_done(void* data) {
+  // Reported, and freed, back on the platform thread.
+  ss_pool_post_to_main(report_trace_write_cb, data);
+}
+
+// Stops the session and writes it. The file can take a moment for a long
+// session, so it is written on a background worker unless |wait|.
+void stop_session(gboolean wait) {
+  ss_trace_stop();
+  TraceWrite* write = g_new0(TraceWrite, 1);
+  write->path = output_path != nullptr ? output_path : default_output_path();
+  output_path = nullptr;
+
+  if (wait) {
+    write_trace_task(write, nullptr);
+    report_trace_write_cb(write);
+  } else {
+    ss_pool_post(static_cast<int32_t>(TaskPriority::kBackground),
+                 write_trace_task, write_trace_done, write);
+  }
+}
+
+gboolean key_press_cb(GtkWidget* widget, GdkEventKey* event,
+                      gpointer user_data) {
+  const guint modifiers =
+      event->state & gtk_accelerator_get_default_mod_mask();
+  if (event->keyval != GDK_KEY_F12 ||
+      modifiers != static_cast<guint>(GDK_CONTROL_MASK | GDK_SHIFT_MASK)) {
+    return FALSE;
+  }
+  if (ss_trace_enabled()) {
+    stop_session(FALSE);
+  } else {
+    start_session(nullptr);
+  }
+  return TRUE;
+}
+
+gboolean configure_cb(GtkWidget* widget, GdkEventConfigure* event,
+                      gpointer user_data) {
+  if (ss_trace_enabled()) {
+    ss_trace_counter(category_window, name_width, event->width);
+    ss_trace_counter(category_window, name_height, event->height);
+  }
+  return FALSE;
+}
+
+gboolean window_state_cb(GtkWidget* widget, GdkEventWindowState* event,
+                         gpointer user_data) {
+  if (ss_trace_enabled()) {
+    ss_trace_instant(category_window, name_state);
+  }
+  return FALSE;
+}
+
+}  // namespace
+
+void trace_control_take_arguments(gchar** arguments) {
+  ss_trace_set_thread_name("platform");
+
+  gchar** out = arguments;
+  for (gchar** arg = arguments; *arg != nullptr; arg++) {
+    if (g_strcmp0(*arg, kTraceFlag) == 0) {
+      start_session(nullptr);
+      g_free(*arg);
+    } else if (g_str_has_prefix(*arg, "--trace=")) {
+      start_session(*arg + sizeof(kTraceFlag));
+      g_free(*arg);
+    } else {
+      *out++ = *arg;
+    }
+  }
+  *out = nullptr;
+}
+
+void trace_control_attach(GtkWindow* window) {
+  intern_names();
+  g_signal_connect(window, "key-press-event", G_CALLBACK(key_press_cb),
+                   nullptr);
+  g_signal_connect(window, "configure-event", G_CALLBACK(configure_cb),
+                   nullptr);
+  g_signal_connect(window, "window-state-event", G_CALLBACK(window_state_cb),
+                   nullptr);
+}
+
+void trace_control_shutdown() {
+  if (ss_trace_enabled()) {
+    stop_session(TRUE);
+  }
+}
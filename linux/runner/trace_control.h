@@ -0,0 +1,37 @@
+#ifndef FLUTTER_TRACE_CONTROL_H_
+#define FLUTTER_TRACE_CONTROL_H_
+
+#include <gtk/gtk.h>
+
+/**
+ * trace_control_take_arguments:
+ * @arguments: (inout): the Dart entrypoint arguments, a %NULL-terminated
+ *   array owned by the caller.
+ *
+ * Removes "--trace" and "--trace=PATH" from @arguments and, if either was
+ * given, starts a trace session right away so startup is captured. The
+ * session is written when it is stopped with the hotkey or when the
+ * application shuts down; PATH overrides the default file under
+ * $XDG_DATA_HOME/APPLICATION_ID/traces.
+ */
+void trace_control_take_arguments(gchar** arguments);
+
+/**
+ * trace_control_attach:
+ * @window: the main window.
+ *
+ * Makes Ctrl+Shift+F12 in @window start a trace session, or stop the
+ * running one and write it as Chrome trace JSON (open it in
+ * chrome://tracing or ui.perfetto.dev). Also records window resizes and
+ * state changes, which is what mode switches look like from here.
+ */
+void trace_control_attach(GtkWindow* window);
+
+/**
+ * trace_control_shutdown:
+ *
+ * Stops and writes a session that is still running.
+ */
+void trace_control_shutdown();
+
+#endif  // FLUTTER_TRACE_CONTROL_H_
@@ -0,0 +1,713 @@
+#include "tray_indicator.h"
+
+#include <cairo.h>
+#include <gio/gio.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "tray/tray_api.h"
+
+namespace {
+
+constexpr char kItemInterface[] = "org.kde.StatusNotifierItem";
+constexpr char kItemPath[] = "/StatusNotifierItem";
+constexpr char kMenuInterface[] = "com.canonical.dbusmenu";
+constexpr char kMenuPath[] = "/MenuBar";
+constexpr char kWatcherName[] = "org.kde.StatusNotifierWatcher";
+constexpr char kWatcherPath[] = "/StatusNotifierWatcher";
+constexpr char kTrayChannel[] = "com.silverstone/tray";
+
+// Offered to the panel, which scales the closest one.
+constexpr int kIconSizes[] = {22, 32, 48, 64};
+
+// dbusmenu item ids; 0 is the root.
+enum MenuId : gint32 {
+  kMenuRoot = 0,
+  kMenuShow = 1,
+  kMenuDashboard = 2,
+  kMenuSeparator = 3,
+  kMenuExit = 4,
+};
+constexpr gint32 kMenuItems[] = {kMenuShow, kMenuDashboard, kMenuSeparator,
+                                 kMenuExit};
+
+const char kItemXml[] = R"xml(<node>
+  <interface name="org.kde.StatusNotifierItem">
+    <property name="Category" type="s" access="read"/>
+    <property name="Id" type="s" access="read"/>
+    <property name="Title" type="s" access="read"/>
+    <property name="Status" type="s" access="read"/>
+    <property name="IconName" type="s" access="read"/>
+    <property name="IconPixmap" type="a(iiay)" access="read"/>
+    <property name="ToolTip" type="(sa(iiay)ss)" access="read"/>
+    <property name="ItemIsMenu" type="b" access="read"/>
+    <property name="Menu" type="o" access="read"/>
+    <method name="ContextMenu">
+      <arg name="x" type="i" direction="in"/>
+      <arg name="y" type="i" direction="in"/>
+    </method>
+    <method name="Activate">
+      <arg name="x" type="i" direction="in"/>
+      <arg name="y" type="i" direction="in"/>
+    </method>
+    <method name="SecondaryActivate">
+      <arg name="x" type="i" direction="in"/>
+      <arg name="y" type="i" direction="in"/>
+    </method>
+    <method name="Scroll">
+      <arg name="delta" type="i" direction="in"/>
+      <arg name="orientation" type="s" direction="in"/>
+    </method>
+    <signal name="NewIcon"/>
+    <signal name="NewToolTip"/>
+  </interface>
+</node>)xml";
+
+const char kMenuXml[] = R"xml(<node>
+  <interface name="com.canonical.dbusmenu">
+    <property name="Version" type="u" access="read"/>
+    <property name="TextDirection" type="s" access="read"/>
+    <property name="Status" type="s" access="read"/>
+    <property name="IconThemePath" type="as" access="read"/>
+    <method name="GetLayout">
+      <arg name="parentId" type="i" direction="in"/>
+      <arg name="recursionDepth" type="i" direction="in"/>
+      <arg name="propertyNames" type="as" direction="in"/>
+      <arg name="revision" type="u" direction="out"/>
+      <arg name="layout" type="(ia{sv}av)" direction="out"/>
+    </method>
+    <method name="GetGroupProperties">
+      <arg name="ids" type="ai" direction="in"/>
+      <arg name="propertyNames" type="as" direction="in"/>
+      <arg name="properties" type="a(ia{sv})" direction="out"/>
+    </method>
+    <method name="GetProperty">
+      <arg name="id" type="i" direction="in"/>
+      <arg name="name" type="s" direction="in"/>
+      <arg name="value" type="v" direction="out"/>
+    </method>
+    <method name="Event">
+      <arg name="id" type="i" direction="in"/>
+      <arg name="eventId" type="s" direction="in"/>
+      <arg name="data" type="v" direction="in"/>
+      <arg name="timestamp" type="u" direction="in"/>
+    </method>
+    <method name="EventGroup">
+      <arg name="events" type="a(isvu)" direction="in"/>
+      <arg name="idErrors" type="ai" direction="out"/>
+    </method>
+    <method name="AboutToShow">
+      <arg name="id" type="i" direction="in"/>
+      <arg name="needUpdate" type="b" direction="out"/>
+    </method>
+    <method name="AboutToShowGroup">
+      <arg name="ids" type="ai" direction="in"/>
+      <arg name="updatesNeeded" type="ai" direction="out"/>
+      <arg name="idErrors" type="ai" direction="out"/>
+    </method>
+    <signal name="ItemsPropertiesUpdated">
+      <arg name="updatedProps" type="a(ia{sv})"/>
+      <arg name="removedProps" type="a(ias)"/>
+    </signal>
+    <signal name="LayoutUpdated">
+      <arg name="revision" type="u"/>
+      <arg name="parent" type="i"/>
+    </signal>
+  </interface>
+</node>)xml";
+
+GtkWindow* main_window = nullptr;
+FlMethodChannel* tray_channel = nullptr;
+GDBusNodeInfo* item_info = nullptr;
+GDBusNodeInfo* menu_info = nullptr;
+
+// Set while the item is (being) exported.
+guint owner_id = 0;
+GDBusConnection* connection = nullptr;
+gchar* bus_name = nullptr;
+guint item_registration = 0;
+guint menu_registration = 0;
+guint watcher_watch = 0;
+
+// What is on the bus now.
+SsTrayView shown = {};
+GVariant* icon_pixmaps = nullptr;
+
+guint tick_source = 0;
+gint refresh_pending = 0;
+gboolean warned_no_watcher = FALSE;
+
+gint64 now_ms() {
+  return g_get_real_time() / 1000;
+}
+
+// Surface of the bundled logo, for when no timer runs; null if missing.
+cairo_surface_t* logo_surface() {
+  static cairo_surface_t* logo = nullptr;
+  static gboolean loaded = FALSE;
+  if (!loaded) {
+    loaded = TRUE;
+    g_autofree gchar* exe = g_file_read_link("/proc/self/exe", nullptr);
+    if (exe != nullptr) {
+      g_autofree gchar* dir = g_path_get_dirname(exe);
+      g_autofree gchar* path =
+          g_build_filename(dir, "data", "flutter_assets", "assets", "images",
+                           "logo.png", nullptr);
+      logo = cairo_image_surface_create_from_png(path);
+      if (cairo_surface_status(logo) != CAIRO_STATUS_SUCCESS) {
+        cairo_surface_destroy(logo);
+        logo = nullptr;
+      }
+    }
+  }
+  return logo;
+}
+
+// Draws |text| centred on |center_y|, as large as fits |width| x |height|.
+void draw_text(cairo_t* cr, const char* text, double center_x,
+               double center_y, double width, double height) {
+  cairo_set_font_size(cr, height);
+  cairo_text_extents_t extents;
+  cairo_text_extents(cr, text, &extents);
+  if (extents.width > width) {
+    cairo_set_font_size(cr, height * width / extents.width);
+    cairo_text_extents(cr, text, &extents);
+  }
+  cairo_move_to(cr, center_x - extents.width / 2 - extents.x_bearing,
+                center_y - extents.height / 2 - extents.y_bearing);
+  cairo_show_text(cr, text);
+}
+
+void draw_icon(cairo_t* cr, int size, const SsTrayView& view) {
+  cairo_surface_t* logo = logo_surface();
+  if (!view.running && logo != nullptr) {
+    const double scale =
+        static_cast<double>(size) / cairo_image_surface_get_width(logo);
+    cairo_scale(cr, scale, scale);
+    cairo_set_source_surface(cr, logo, 0, 0);
+    cairo_paint(cr);
+    return;
+  }
+
+  // Rounded square, brighter while a timer runs.
+  const double radius = size * 0.2;
+  cairo_new_sub_path(cr);
+  cairo_arc(cr, size - radius, radius, radius, -G_PI / 2, 0);
+  cairo_arc(cr, size - radius, size - radius, radius, 0, G_PI / 2);
+  cairo_arc(cr, radius, size - radius, radius, G_PI / 2, G_PI);
+  cairo_arc(cr, radius, radius, radius, G_PI, 3 * G_PI / 2);
+  cairo_close_path(cr);
+  if (view.running) {
+    cairo_set_source_rgb(cr, 0.10, 0.46, 0.82);
+  } else {
+    cairo_set_source_rgb(cr, 0.45, 0.47, 0.50);
+  }
+  cairo_fill(cr);
+
+  cairo_set_source_rgb(cr, 1, 1, 1);
+  cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL,
+                         CAIRO_FONT_WEIGHT_BOLD);
+  const double inner = size * 0.84;
+  if (!view.running) {
+    draw_text(cr, "SS", size / 2.0, size / 2.0, inner, size * 0.5);
+    return;
+  }
+  draw_text(cr, view.initials, size / 2.0, size * 0.34, inner, size * 0.42);
+  cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL,
+                         CAIRO_FONT_WEIGHT_NORMAL);
+  draw_text(cr, view.elapsed, size / 2.0, size * 0.75, inner, size * 0.3);
+}
+
+// One IconPixmap entry: ARGB32 in network byte order, not premultiplied.
+GVariant* render_pixmap(int size, const SsTrayView& view) {
+  cairo_surface_t* surface =
+      cairo_image_surface_create(CAIRO_FORMAT_ARGB32, size, size);
+  cairo_t* cr = cairo_create(surface);
+  draw_icon(cr, size, view);
+  cairo_destroy(cr);
+  cairo_surface_flush(surface);
+
+  const int stride = cairo_image_surface_get_stride(surface);
+  const guint8* data = cairo_image_surface_get_data(surface);
+  g_autofree guint8* pixels = static_cast<guint8*>(g_malloc(size * size * 4));
+  guint8* out = pixels;
+  for (int y = 0; y < size; y++) {
+    const guint32* row = reinterpret_cast<const guint32*>(data + y * stride);
+    for (int x = 0; x < size; x++) {
+      const guint32 pixel = row[x];
+      const guint alpha = pixel >> 24;
+      guint red = (pixel >> 16) & 0xFF;
+      guint green = (pixel >> 8) & 0xFF;
+      guint blue = pixel & 0xFF;
+      if (alpha != 0 && alpha != 0xFF) {
+        red = red * 0xFF / alpha;
+        green = green * 0xFF / alpha;
+        blue = blue * 0xFF / alpha;
+      }
+      *out++ = alpha;
+      *out++ = red;
+      *out++ = green;
+      *out++ = blue;
+    }
+  }
+  cairo_surface_destroy(surface);
+
+  GVariant* bytes = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, pixels,
+                                              size * size * 4, 1);
+  return g_variant_new("(ii@ay)", size, size, bytes);
+}
+
+void render_icon(const SsTrayView& view) {
+  GVariantBuilder builder;
+  g_variant_builder_init(&builder, G_VARIANT_TYPE("a(iiay)"));
+  for (int size : kIconSizes) {
+    g_variant_builder_add_value(&builder, render_pixmap(size, view));
+  }
+  g_clear_pointer(&icon_pixmaps, g_variant_unref);
+  icon_pixmaps = g_variant_ref_sink(g_variant_builder_end(&builder));
+}
+
+void emit_item_signal(const char* name) {
+  if (connection == nullptr || item_registration == 0) {
+    return;
+  }
+  g_dbus_connection_emit_signal(connection, nullptr, kItemPath,
+                                kItemInterface, name, nullptr, nullptr);
+}
+
+// The tray is only up in floating mode, where mapping the main window here
+// would leave the floating window on screen too. Dart leaves floating mode
+// instead, which swaps the windows (floating_view.h).
+void send_menu_action(const gchar* action) {
+  g_autoptr(FlValue) args = fl_value_new_string(action);
+  fl_method_channel_invoke_method(tray_channel, "menuAction", args, nullptr,
+                                  nullptr, nullptr);
+}
+
+void activate_menu_item(gint32 id) {
+  switch (id) {
+    case kMenuShow:
+      send_menu_action("showWindow");
+      break;
+    case kMenuDashboard:
+      send_menu_action("openDashboard");
+      break;
+    case kMenuExit:
+      // Same path as the close button, so Dart still gets to clean up.
+      gtk_window_close(main_window);
+      break;
+  }
+}
+
+gboolean is_menu_item(gint32 id) {
+  return id >= kMenuRoot && id <= kMenuExit;
+}
+
+// The a{sv} properties of one menu item.
+GVariant* menu_item_properties(gint32 id) {
+  GVariantBuilder builder;
+  g_variant_builder_init(&builder, G_VARIANT_TYPE("a{sv}"));
+  switch (id) {
+    case kMenuRoot:
+      g_variant_builder_add(&builder, "{sv}", "children-display",
+                            g_variant_new_string("submenu"));
+      break;
+    case kMenuSeparator:
+      g_variant_builder_add(&builder, "{sv}", "type",
+                            g_variant_new_string("separator"));
+      break;
+    default: {
+      const char* label = id == kMenuShow        ? "Show Window"
+                          : id == kMenuDashboard ? "Open Dashboard"
+                                                 : "Exit";
+      g_variant_builder_add(&builder, "{sv}", "label",
+                            g_variant_new_string(label));
+      break;
+    }
+  }
+  return g_variant_builder_end(&builder);
+}
+
+// (ia{sv}av) for |id|, with the root's children when |id| is the root.
+GVariant* menu_layout(gint32 id) {
+  GVariantBuilder children;
+  g_variant_builder_init(&children, G_VARIANT_TYPE("av"));
+  if (id == kMenuRoot) {
+    for (gint32 child : kMenuItems) {
+      g_variant_builder_add(&children, "v", menu_layout(child));
+    }
+  }
+  return g_variant_new("(i@a{sv}av)", id, menu_item_properties(id),
+                       &children);
+}
+
+void menu_method_cb(GDBusConnection* bus, const gchar* sender,
+                    const gchar* object_path, const gchar* interface_name,
+                    const gchar* method_name, GVariant* parameters,
+                    GDBusMethodInvocation* invocation, gpointer user_data) {
+  if (g_strcmp0(method_name, "GetLayout") == 0) {
+    gint32 parent;
+    gint32 depth;
+    g_variant_get(parameters, "(ii@as)", &parent, &depth, nullptr);
+    if (!is_menu_item(parent)) {
+      g_dbus_method_invocation_return_dbus_error(
+          invocation, "com.canonical.dbusmenu.Error", "No such item");
+      return;
+    }
+    g_dbus_method_invocation_return_value(
+        invocation, g_variant_new("(u@(ia{sv}av))", 1u, menu_layout(parent)));
+  } else if (g_strcmp0(method_name, "GetGroupProperties") == 0) {
+    g_autoptr(GVariant) ids = g_variant_get_child_value(parameters, 0);
+    gsize count = 0;
+    const gint32* requested = static_cast<const gint32*>(
+        g_variant_get_fixed_array(ids, &count, sizeof(gint32)));
+    GVariantBuilder builder;
+    g_variant_builder_init(&builder, G_VARIANT_TYPE("a(ia{sv})"));
+    if (count == 0) {
+      // Empty means every item.
+      g_variant_builder_add(&builder, "(i@a{sv})", kMenuRoot,
+                            menu_item_properties(kMenuRoot));
+      for (gint32 id : kMenuItems) {
+        g_variant_builder_add(&builder, "(i@a{sv})", id,
+                              menu_item_properties(id));
+      }
+    }
+    for (gsize i = 0; i < count; i++) {
+      if (is_menu_item(requested[i])) {
+        g_variant_builder_add(&builder, "(i@a{sv})", requested[i],
+                              menu_item_properties(requested[i]));
+      }
+    }
+    g_dbus_method_invocation_return_value(invocation,
+                                          g_variant_new("(a(ia{sv}))",
+                                                        &builder));
+  } else if (g_strcmp0(method_name, "GetProperty") == 0) {
+    gint32 id;
+    const gchar* name;
+    g_variant_get(parameters, "(i&s)", &id, &name);
+    g_autoptr(GVariant) properties =
+        is_menu_item(id) ? g_variant_ref_sink(menu_item_properties(id))
+                         : nullptr;
+    GVariant* value = properties != nullptr
+                          ? g_variant_lookup_value(properties, name, nullptr)
+                          : nullptr;
+    if (value == nullptr) {
+      g_dbus_method_invocation_return_dbus_error(
+          invocation, "com.canonical.dbusmenu.Error", "No such property");
+      return;
+    }
+    g_dbus_method_invocation_return_value(invocation,
+                                          g_variant_new("(v)", value));
+    g_variant_unref(value);
+  } else if (g_strcmp0(method_name, "Event") == 0) {
+    gint32 id;
+    const gchar* event;
+    g_variant_get(parameters, "(i&svu)", &id, &event, nullptr, nullptr);
+    if (g_strcmp0(event, "clicked") == 0) {
+      activate_menu_item(id);
+    }
+    g_dbus_method_invocation_return_value(invocation, nullptr);
+  } else if (g_strcmp0(method_name, "EventGroup") == 0) {
+    GVariantIter* events;
+    g_variant_get(parameters, "(a(isvu))", &events);
+    GVariantBuilder errors;
+    g_variant_builder_init(&errors, G_VARIANT_TYPE("ai"));
+    gint32 id;
+    const gchar* event;
+    while (g_variant_iter_loop(events, "(i&svu)", &id, &event, nullptr,
+                               nullptr)) {
+      if (!is_menu_item(id)) {
+        g_variant_builder_add(&errors, "i", id);
+      } else if (g_strcmp0(event, "clicked") == 0) {
+        activate_menu_item(id);
+      }
+    }
+    g_variant_iter_free(events);
+    g_dbus_method_invocation_return_value(invocation,
+                                          g_variant_new("(ai)", &errors));
+  } else if (g_strcmp0(method_name, "AboutToShow") == 0) {
+    g_dbus_method_invocation_return_value(invocation,
+                                          g_variant_new("(b)", FALSE));
+  } else if (g_strcmp0(method_name, "AboutToShowGroup") == 0) {
+    g_dbus_method_invocation_return_value(
+        invocation, g_variant_new("(@ai@ai)",
+                                  g_variant_new_array(G_VARIANT_TYPE_INT32,
+                                                      nullptr, 0),
+                                  g_variant_new_array(G_VARIANT_TYPE_INT32,
+                                                      nullptr, 0)));
+  } else {
+    g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR,
+                                          G_DBUS_ERROR_UNKNOWN_METHOD,
+                                          "Unknown method %s", method_name);
+  }
+}
+
+GVariant* menu_property_cb(GDBusConnection* bus, const gchar* sender,
+                           const gchar* object_path,
+                           const gchar* interface_name,
+                           const gchar* property_name, GError** error,
+                           gpointer user_data) {
+  if (g_strcmp0(property_name, "Version") == 0) {
+    return g_variant_new_uint32(3);
+  }
+  if (g_strcmp0(property_name, "TextDirection") == 0) {
+    return g_variant_new_string(
+        gtk_widget_get_default_direction() == GTK_TEXT_DIR_RTL ? "rtl"
+                                                               : "ltr");
+  }
+  if (g_strcmp0(property_name, "Status") == 0) {
+    return g_variant_new_string("normal");
+  }
+  if (g_strcmp0(property_name, "IconThemePath") == 0) {
+    return g_variant_new_strv(nullptr, 0);
+  }
+  return nullptr;
+}
+
+void item_method_cb(GDBusConnection* bus, const gchar* sender,
+                    const gchar* object_path, const gchar* interface_name,
+                    const gchar* method_name, GVariant* parameters,
+                    GDBusMethodInvocation* invocation, gpointer user_data) {
+  // The menu opens from ItemIsMenu; a click that still gets here shows the
+  // window, as the plugin's menu would.
+  if (g_strcmp0(method_name, "Activate") == 0 ||
+      g_strcmp0(method_name, "SecondaryActivate") == 0) {
+    send_menu_action("showWindow");
+  }
+  g_dbus_method_invocation_return_value(invocation, nullptr);
+}
+
+GVariant* item_property_cb(GDBusConnection* bus, const gchar* sender,
+                           const gchar* object_path,
+                           const gchar* interface_name,
+                           const gchar* property_name, GError** error,
+                           gpointer user_data) {
+  if (g_strcmp0(property_name, "Category") == 0) {
+    return g_variant_new_string("ApplicationStatus");
+  }
+  if (g_strcmp0(property_name, "Id") == 0) {
+    return g_variant_new_string(APPLICATION_ID);
+  }
+  if (g_strcmp0(property_name, "Title") == 0) {
+    return g_variant_new_string("Silver Stone");
+  }
+  if (g_strcmp0(property_name, "Status") == 0) {
+    return g_variant_new_string("Active");
+  }
+  if (g_strcmp0(property_name, "IconName") == 0) {
+    return g_variant_new_string("");
+  }
+  if (g_strcmp0(property_name, "IconPixmap") == 0) {
+    if (icon_pixmaps == nullptr) {
+      render_icon(shown);
+    }
+    return g_variant_ref(icon_pixmaps);
+  }
+  if (g_strcmp0(property_name, "ToolTip") == 0) {
+    return g_variant_new("(s@a(iiay)ss)", "",
+                         g_variant_new_array(G_VARIANT_TYPE("(iiay)"),
+                                             nullptr, 0),
+                         shown.tooltip_title, shown.tooltip_body);
+  }
+  if (g_strcmp0(property_name, "ItemIsMenu") == 0) {
+    return g_variant_new_boolean(TRUE);
+  }
+  if (g_strcmp0(property_name, "Menu") == 0) {
+    return g_variant_new_object_path(kMenuPath);
+  }
+  return nullptr;
+}
+
+const GDBusInterfaceVTable item_vtable = {item_method_cb, item_property_cb,
+                                          nullptr};
+const GDBusInterfaceVTable menu_vtable = {menu_method_cb, menu_property_cb,
+                                          nullptr};
+
+void register_item_cb(GObject* source, GAsyncResult* result,
+                      gpointer user_data) {
+  g_autoptr(GError) error = nullptr;
+  g_autoptr(GVariant) reply = g_dbus_connection_call_finish(
+      G_DBUS_CONNECTION(source), result, &error);
+  if (reply == nullptr) {
+    g_warning("Tray: StatusNotifierWatcher refused the item: %s",
+              error->message);
+  }
+}
+
+// The panel's watcher appeared, or came back after a restart.
+void watcher_appeared_cb(GDBusConnection* bus, const gchar* name,
+                         const gchar* name_owner, gpointer user_data) {
+  g_dbus_connection_call(bus, kWatcherName, kWatcherPath, kWatcherName,
+                         "RegisterStatusNotifierItem",
+                         g_variant_new("(s)", bus_name), nullptr,
+                         G_DBUS_CALL_FLAGS_NONE, -1, nullptr,
+                         register_item_cb, nullptr);
+}
+
+void watcher_vanished_cb(GDBusConnection* bus, const gchar* name,
+                         gpointer user_data) {
+  if (!warned_no_watcher) {
+    warned_no_watcher = TRUE;
+    g_message("Tray: no StatusNotifierWatcher on the session bus; the "
+              "indicator shows once a panel provides one");
+  }
+}
+
+void bus_acquired_cb(GDBusConnection* bus, const gchar* name,
+                     gpointer user_data) {
+  connection = G_DBUS_CONNECTION(g_object_ref(bus));
+  g_autoptr(GError) error = nullptr;
+  item_registration = g_dbus_connection_register_object(
+      bus, kItemPath, item_info->interfaces[0], &item_vtable, nullptr,
+      nullptr, &error);
+  if (item_registration == 0) {
+    g_warning("Tray: cannot export the item: %s", error->message);
+    return;
+  }
+  menu_registration = g_dbus_connection_register_object(
+      bus, kMenuPath, menu_info->interfaces[0], &menu_vtable, nullptr,
+      nullptr, &error);
+  if (menu_registration == 0) {
+    g_warning("Tray: cannot export the menu: %s", error->message);
+  }
+}
+
+void name_acquired_cb(GDBusConnection* bus, const gchar* name,
+                      gpointer user_data) {
+  watcher_watch = g_bus_watch_name_on_connection(
+      bus, kWatcherName, G_BUS_NAME_WATCHER_FLAGS_NONE, watcher_appeared_cb,
+      watcher_vanished_cb, nullptr, nullptr);
+}
+
+void name_lost_cb(GDBusConnection* bus, const gchar* name,
+                  gpointer user_data) {
+  if (bus == nullptr) {
+    g_warning("Tray: no session bus");
+  }
+}
+
+void export_item() {
+  bus_name = g_strdup_printf("org.kde.StatusNotifierItem-%d-1", getpid());
+  owner_id = g_bus_own_name(G_BUS_TYPE_SESSION, bus_name,
+                            G_BUS_NAME_OWNER_FLAGS_NONE, bus_acquired_cb,
+                            name_acquired_cb, name_lost_cb, nullptr, nullptr);
+}
+
+void unexport_item() {
+  if (watcher_watch != 0) {
+    g_bus_unwatch_name(watcher_watch);
+    watcher_watch = 0;
+  }
+  if (connection != nullptr) {
+    if (item_registration != 0) {
+      g_dbus_connection_unregister_object(connection, item_registration);
+    }
+    if (menu_registration != 0) {
+      g_dbus_connection_unregister_object(connection, menu_registration);
+    }
+    g_clear_object(&connection);
+  }
+  item_registration = 0;
+  menu_registration = 0;
+  if (owner_id != 0) {
+    g_bus_unown_name(owner_id);
+    owner_id = 0;
+  }
+  g_clear_pointer(&bus_name, g_free);
+}
+
+void schedule_tick(const SsTrayView& view);
+
+void refresh() {
+  SsTrayView view;
+  ss_tray_read(now_ms(), &view);
+
+  if (view.visible && owner_id == 0) {
+    shown = view;
+    g_clear_pointer(&icon_pixmaps, g_variant_unref);
+    export_item();
+  } else if (!view.visible && owner_id != 0) {
+    unexport_item();
+  } else if (view.visible) {
+    const bool icon_changed = view.running != shown.running ||
+                              strcmp(view.initials, shown.initials) != 0 ||
+                              strcmp(view.elapsed, shown.elapsed) != 0;
+    const bool tooltip_changed =
+        strcmp(view.tooltip_title, shown.tooltip_title) != 0 ||
+        strcmp(view.tooltip_body, shown.tooltip_body) != 0;
+    shown = view;
+    if (icon_changed) {
+      render_icon(view);
+      emit_item_signal("NewIcon");
+    }
+    if (tooltip_changed) {
+      emit_item_signal("NewToolTip");
+    }
+  }
+  schedule_tick(view);
+}
+
+gboolean tick_cb(gpointer user_data) {
+  tick_source = 0;
+  refresh();
+  return G_SOURCE_REMOVE;
+}
+
+// Wakes up for the next minute of a running timer, and not otherwise.
+void schedule_tick(const SsTrayView& view) {
+  if (tick_source != 0) {
+    g_source_remove(tick_source);
+    tick_source = 0;
+  }
+  if (view.visible && view.next_update_ms > 0) {
+    // Whole seconds, rounded up so the label has changed when we wake;
+    // the second-granular timers let GLib batch wakeups.
+    tick_source = g_timeout_add_seconds(
+        static_cast<guint>((view.next_update_ms + 999) / 1000), tick_cb,
+        nullptr);
+  }
+}
+
+gboolean refresh_cb(gpointer user_data) {
+  g_atomic_int_set(&refresh_pending, 0);
+  if (main_window != nullptr) {
+    refresh();
+  }
+  return G_SOURCE_REMOVE;
+}
+
+// Runs on whichever thread changed the state, usually Dart's.
+void state_changed_cb(void* data) {
+  if (g_atomic_int_compare_and_exchange(&refresh_pending, 0, 1)) {
+    g_idle_add(refresh_cb, nullptr);
+  }
+}
+
+}  // namespace
+
+void tray_indicator_attach(GtkWindow* window, FlEngine* engine) {
+  main_window = window;
+  g_autoptr(FlStandardMethodCodec) codec = fl_standard_method_codec_new();
+  tray_channel =
+      fl_method_channel_new(fl_engine_get_binary_messenger(engine),
+                            kTrayChannel, FL_METHOD_CODEC(codec));
+  item_info = g_dbus_node_info_new_for_xml(kItemXml, nullptr);
+  menu_info = g_dbus_node_info_new_for_xml(kMenuXml, nullptr);
+  ss_tray_set_listener(state_changed_cb, nullptr);
+  refresh();
+}
+
+void tray_indicator_detach() {
+  ss_tray_set_listener(nullptr, nullptr);
+  if (tick_source != 0) {
+    g_source_remove(tick_source);
+    tick_source = 0;
+  }
+  unexport_item();
+  g_clear_pointer(&icon_pixmaps, g_variant_unref);
+  g_clear_pointer(&item_info, g_dbus_node_info_unref);
+  g_clear_pointer(&menu_info, g_dbus_node_info_unref);
+  g_clear_object(&tray_channel);
+  main_window = nullptr;
+}
@@ -0,0 +1,35 @@
+#ifndef FLUTTER_TRAY_INDICATOR_H_
+#define FLUTTER_TRAY_INDICATOR_H_
+
+#include <flutter_linux/flutter_linux.h>
+#include <gtk/gtk.h>
+
+/**
+ * tray_indicator_attach:
+ * @window: the main window.
+ * @engine: the engine running in @window.
+ *
+ * Puts a StatusNotifierItem on the session bus while Dart says the tray is
+ * up (floating mode), in place of the system_tray plugin. The icon shows
+ * the running project's initials and the elapsed time, drawn with cairo;
+ * the tooltip names the project. Both come from the native tray state
+ * (linux/native/tray/tray_state.h), which Dart writes through dart:ffi, and
+ * are redrawn when it changes and at each new minute of a running timer.
+ * Without a timer nothing wakes up.
+ *
+ * The menu is served over com.canonical.dbusmenu. "Exit" closes @window
+ * directly; "Show Window" and "Open Dashboard", and a click on the icon,
+ * are sent to Dart as "menuAction" ("showWindow", "openDashboard") on the
+ * "com.silverstone/tray" channel, since leaving floating mode swaps the
+ * floating window for @window.
+ */
+void tray_indicator_attach(GtkWindow* window, FlEngine* engine);
+
+/**
+ * tray_indicator_detach:
+ *
+ * Removes the item from the bus and stops listening.
+ */
+void tray_indicator_detach();
+
+#endif  // FLUTTER_TRAY_INDICATOR_H_
@@ -0,0 +1,35 @@
+#include "update_launcher.h"
+
+#include <errno.h>
+#include <glib.h>
+#include <unistd.h>
+
+#include "update/staged_update.h"
+#include "update/update_api.h"
+
+void update_launcher_apply_staged(char** argv) {
+  g_autoptr(GError) error = nullptr;
+  g_autofree gchar* executable =
+      g_file_read_link("/proc/self/exe", &error);
+  if (executable == nullptr) {
+    g_warning("Cannot locate the application binary: %s", error->message);
+    return;
+  }
+  g_autofree gchar* bundle_root = g_path_get_dirname(executable);
+
+  char message[512];
+  auto result = static_cast<StagedUpdateResult>(
+      ss_update_apply_staged(bundle_root, message, sizeof(message)));
+  if (result == StagedUpdateResult::kNone) {
+    return;
+  }
+  if (result == StagedUpdateResult::kFailed) {
+    g_warning("Staged update was not applied: %s", message);
+    return;
+  }
+
+  g_message("Updated to version %s, restarting", message);
+  // The binary's path is unchanged; it is now the one from the new bundle.
+  execv(executable, argv);
+  g_warning("Cannot restart after update: %s", g_strerror(errno));
+}
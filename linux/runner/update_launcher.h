@@ -0,0 +1,17 @@
+#ifndef FLUTTER_UPDATE_LAUNCHER_H_
+#define FLUTTER_UPDATE_LAUNCHER_H_
+
+/**
+ * update_launcher_apply_staged:
+ * @argv: the arguments main() was called with.
+ *
+ * Swaps in an update that a previous run downloaded and staged next to
+ * the bundle, then re-executes the new binary with @argv, so this returns
+ * only when there was nothing to apply or applying failed. Must run before
+ * anything else in main(): once GTK and the engine are up, the libraries of
+ * the old bundle are mapped. A failed swap leaves the installed bundle in
+ * place and is logged.
+ */
+void update_launcher_apply_staged(char** argv);
+
+#endif  // FLUTTER_UPDATE_LAUNCHER_H_
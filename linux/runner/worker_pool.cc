@@ -0,0 +1,45 @@
+#include "worker_pool.h"
+
+#include "scheduler/pool_api.h"
+
+namespace {
+
+// Longest a single dispatch may spend running posted results; the rest wait
+// for the next iteration of the main loop.
+constexpr gint64 kDrainBudgetNs = 4 * 1000 * 1000;
+
+gboolean drain_cb(gpointer user_data) {
+  return ss_pool_drain_main(kDrainBudgetNs) ? G_SOURCE_CONTINUE
+                                            : G_SOURCE_REMOVE;
+}
+
+// Called on whichever thread posted first since the queue went empty.
+void wake_cb(void* data) {
+  GMainContext* context = static_cast<GMainContext*>(data);
+  g_autoptr(GSource) source = g_idle_source_new();
+  // Ahead of GTK's redraw (G_PRIORITY_HIGH_IDLE + 20), so results land in
+  // the next frame.
+  g_source_set_priority(source, G_PRIORITY_HIGH_IDLE);
+  g_source_set_callback(source, drain_cb, nullptr, nullptr);
+  g_source_set_name(source, "ss_pool_drain_main");
+  g_source_attach(source, context);
+}
+
+GMainContext* attached_context = nullptr;
+
+}  // namespace
+
+void worker_pool_attach(GMainContext* context) {
+  worker_pool_detach();
+  attached_context = g_main_context_ref(context);
+  ss_pool_set_main_wakeup(wake_cb, attached_context);
+}
+
+void worker_pool_detach() {
+  if (attached_context == nullptr) {
+    return;
+  }
+  ss_pool_set_main_wakeup(nullptr, nullptr);
+  // Leaked on purpose: a worker may be inside wake_cb with the old pointer.
+  attached_context = nullptr;
+}
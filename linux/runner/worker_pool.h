@@ -0,0 +1,25 @@
+#ifndef FLUTTER_WORKER_POOL_H_
+#define FLUTTER_WORKER_POOL_H_
+
+#include <glib.h>
+
+/**
+ * worker_pool_attach:
+ * @context: the main context of the platform thread.
+ *
+ * Makes results that native services post from the shared worker pool
+ * (ss_pool_post_to_main()) run on @context. They are run in batches from a
+ * single idle source, each dispatch bounded to a few milliseconds so a burst
+ * of results cannot delay a frame.
+ */
+void worker_pool_attach(GMainContext* context);
+
+/**
+ * worker_pool_detach:
+ *
+ * Stops dispatching posted results; ones still queued are dropped with the
+ * process.
+ */
+void worker_pool_detach();
+
+#endif  // FLUTTER_WORKER_POOL_H_
@@ -0,0 +1,558 @@
+/// Headless performance benchmark for the Linux bundle.
+///
+/// Build the bundle first (flutter build linux --release), then run:
+///   dart run scripts/linux_bench.dart [--runs=10] [--switches=5]
+///       [--bundle=build/linux/x64/release/bundle]
+///       [--baseline=scripts/linux_bench_baseline.json] [--threshold=0.25]
+///       [--out=build/linux_bench.json] [--update-baseline] [--wayland]
+///       [--cold]
+///
+/// Starts Xvfb (needs `Xvfb` on the PATH) and a stand-in for the API server,
+/// then launches the bundle --runs times, each with a fresh profile. Every
+/// launch runs the scenarios in lib/services/bench_driver.dart and quits;
+/// timings come from the trace the runner writes with --trace. Cold start is
+/// the time from launch to the runner's first frame. With the floating view
+/// each mode switch also reports the window swap itself and its blank time,
+/// the flicker between one window going and the other appearing.
+///
+/// Writes min/mean/p50/p90/p95/max per scenario to --out and exits with 1
+/// when a run failed, when there is no baseline, or when any p50 is more
+/// than --threshold slower than the baseline. With --update-baseline the
+/// results become the new baseline instead, as long as every run succeeded;
+/// record it on the machine that runs the check.
+///
+/// With --wayland the bundle runs under a headless sway (needs `sway` on the
+/// PATH; weston has no layer-shell) instead of Xvfb, and a run only counts
+/// when the floating view came up on the layer-shell backend
+/// (linux/runner/floating_layer_shell.h). Keep a separate --baseline for it.
+///
+/// With --cold the bundle's files are dropped from the page cache before
+/// every launch (GNU dd's iflag=nocache, no root needed), and the runs share
+/// a cache directory so they start with the startup prefetch plan
+/// (linux/runner/startup_prefetch.h) that an uncounted first launch
+/// records. Each run then also reports the prefetch itself. Also keep a
+/// separate --baseline for it.
+
+import 'dart:async';
+import 'dart:convert';
+import 'dart:ffi';
+import 'dart:io';
+import 'package:ffi/ffi.dart';
+
+const _coldStart = 'cold start to first frame';
+// From the runner's floating view (linux/runner/floating_view.h): a mode
+// switch's map and unmap, and how long neither window was on screen.
+const _windowSwap = 'window swap';
+const _swapBlank = 'window swap blank';
+const _layerShell = 'floating layer shell';
+const _startupPrefetch = 'startup prefetch';
+
+Future<void> main(List<String> arguments) async {
+  final options = _Options.parse(arguments);
+  final bundle = Directory(options.bundle);
+  final executable = File('${bundle.path}/silver_stone');
+  if (!executable.existsSync()) {
+    stderr.writeln('No bundle at ${bundle.path}; '
+        'run flutter build linux --release first');
+    exit(2);
+  }
+
+  final display = options.wayland
+      ? await _startSway()
+      : await _startXvfb(options.display);
+  final server = await _StandInServer.start();
+  final work = await Directory.systemTemp.createTemp('linux_bench');
+  final samples = <String, List<double>>{};
+  final skipped = <String>{};
+  var failedRuns = 0;
+
+  try {
+    final sharedCache = options.cold
+        ? await Directory('${work.path}/cache').create()
+        : null;
+    if (sharedCache != null) {
+      stdout.writeln('recording the startup prefetch plan...');
+      await _dropFromPageCache(bundle);
+      await _launch(executable, work, 0, display, server, options.switches,
+          cache: sharedCache);
+    }
+    for (var run = 1; run <= options.runs; run++) {
+      if (options.cold) await _dropFromPageCache(bundle);
+      final result = await _launch(
+          executable, work, run, display, server, options.switches,
+          cache: sharedCache);
+      if (result == null) {
+        failedRuns++;
+        continue;
+      }
+      result.samples.forEach(
+          (name, values) => samples.putIfAbsent(name, () => []).addAll(values));
+      skipped.addAll(result.skipped);
+      stdout.writeln('run $run/${options.runs}: '
+          '${result.samples[_coldStart]?.first.toStringAsFixed(1)} ms '
+          'to first frame');
+    }
+  } finally {
+    await server.close();
+    await display.close();
+    await work.delete(recursive: true);
+  }
+
+  final report = {
+    'runs': options.runs,
+    'failedRuns': failedRuns,
+    'scenarios': {
+      for (final entry in samples.entries)
+        entry.key: _Summary.of(entry.value).toJson(),
+    },
+    'skipped': skipped.toList()..sort(),
+  };
+  final out = File(options.out);
+  await out.parent.create(recursive: true);
+  await out.writeAsString(const JsonEncoder.withIndent('  ').convert(report));
+  stdout.writeln('Results written to ${out.path}');
+
+  // A failed run fails the check whatever the timings, and is no baseline.
+  if (failedRuns > 0) {
+    stderr.writeln('$failedRuns of ${options.runs} runs failed');
+    exit(1);
+  }
+  final baseline = File(options.baseline);
+  if (options.updateBaseline) {
+    await baseline.writeAsString(
+        const JsonEncoder.withIndent('  ').convert(report));
+    stdout.writeln('Baseline updated: ${baseline.path}');
+    return;
+  }
+  if (!baseline.existsSync()) {
+    stderr.writeln('No baseline at ${baseline.path}; '
+        'run with --update-baseline to record one');
+    exit(1);
+  }
+  final regressions = _compare(
+      jsonDecode(await baseline.readAsString()) as Map<String, dynamic>,
+      report['scenarios'] as Map<String, dynamic>,
+      options.threshold);
+  if (regressions.isNotEmpty) exit(1);
+}
+
+class _Options {
+  int runs = 10;
+  int switches = 5;
+  String bundle = 'build/linux/x64/release/bundle';
+  String baseline = 'scripts/linux_bench_baseline.json';
+  String out = 'build/linux_bench.json';
+  double threshold = 0.25;
+  String display = ':99';
+  bool updateBaseline = false;
+  bool wayland = false;
+  bool cold = false;
+
+  static _Options parse(List<String> arguments) {
+    final options = _Options();
+    for (final argument in arguments) {
+      final split = argument.indexOf('=');
+      final name = split < 0 ? argument : argument.substring(0, split);
+      final value = split < 0 ? '' : argument.substring(split + 1);
+      switch (name) {
+        case '--runs':
+          options.runs = int.parse(value);
+        case '--switches':
+          options.switches = int.parse(value);
+        case '--bundle':
+          options.bundle = value;
+        case '--baseline':
+          options.baseline = value;
+        case '--out':
+          options.out = value;
+        case '--threshold':
+          options.threshold = double.parse(value);
+        case '--display':
+          options.display = value;
+        case '--update-baseline':
+          options.updateBaseline = true;
+        case '--wayland':
+          options.wayland = true;
+        case '--cold':
+          options.cold = true;
+        default:
+          stderr.writeln('Unknown option $argument');
+          exit(2);
+      }
+    }
+    return options;
+  }
+}
+
+/// The display server the bundle runs on and how to reach it.
+class _Display {
+  final Process? process;
+  final Map<String, String> environment;
+  final bool wayland;
+  final Directory? runtimeDir;
+
+  _Display(this.process, this.environment,
+      {this.wayland = false, this.runtimeDir});
+
+  Future<void> close() async {
+    process?.kill();
+    await process?.exitCode;
+    await runtimeDir?.delete(recursive: true);
+  }
+}
+
+/// Starts a virtual X server on [display], unless one is already there.
+Future<_Display> _startXvfb(String display) async {
+  final environment = {'DISPLAY': display, 'GDK_BACKEND': 'x11'};
+  final socket = File('/tmp/.X11-unix/X${display.substring(1)}');
+  if (socket.existsSync()) return _Display(null, environment);
+  final process = await Process.start(
+      'Xvfb', [display, '-screen', '0', '1920x1080x24', '-nolisten', 'tcp']);
+  for (var i = 0; i < 50 && !socket.existsSync(); i++) {
+    await Future<void>.delayed(const Duration(milliseconds: 100));
+  }
+  if (!socket.existsSync()) {
+    process.kill();
+    throw StateError('Xvfb did not start on $display');
+  }
+  return _Display(process, environment);
+}
+
+/// Starts sway on its headless backend in a runtime directory of its own,
+/// so its socket cannot be mistaken for the desktop's.
+Future<_Display> _startSway() async {
+  final runtimeDir = await Directory.systemTemp.createTemp('linux_bench_wl');
+  await Process.run('chmod', ['700', runtimeDir.path]);
+  final config = File('${runtimeDir.path}/sway.conf')
+    ..writeAsStringSync('xwayland disable\n'
+        'output HEADLESS-1 resolution 1920x1080\n');
+  final process = await Process.start(
+    'sway',
+    ['--config', config.path],
+    environment: {
+      'XDG_RUNTIME_DIR': runtimeDir.path,
+      'WLR_BACKENDS': 'headless',
+      'WLR_LIBINPUT_NO_DEVICES': '1',
+      'WLR_RENDERER': 'pixman',
+    },
+    includeParentEnvironment: false,
+  );
+  final log = StringBuffer();
+  process.stderr.transform(utf8.decoder).listen(log.write);
+  process.stdout.drain<void>();
+
+  String? socket;
+  for (var i = 0; i < 50 && socket == null; i++) {
+    await Future<void>.delayed(const Duration(milliseconds: 100));
+    socket = runtimeDir
+        .listSync()
+        .map((entry) => entry.uri.pathSegments.last)
+        .where((name) => name.startsWith('wayland-') && !name.endsWith('.lock'))
+        .firstOrNull;
+  }
+  if (socket == null) {
+    process.kill();
+    await runtimeDir.delete(recursive: true);
+    throw StateError('sway did not start:\n$log');
+  }
+  return _Display(
+    process,
+    {
+      'WAYLAND_DISPLAY': socket,
+      'XDG_RUNTIME_DIR': runtimeDir.path,
+      'GDK_BACKEND': 'wayland',
+    },
+    wayland: true,
+    runtimeDir: runtimeDir,
+  );
+}
+
+class _RunResult {
+  final Map<String, List<double>> samples;
+  final Set<String> skipped;
+  final bool layerShell;
+
+  _RunResult(this.samples, this.skipped, {this.layerShell = false});
+}
+
+/// Evicts every file of [bundle] from the page cache, so the next launch
+/// reads them from disk as after a reboot.
+Future<void> _dropFromPageCache(Directory bundle) async {
+  await for (final entity in bundle.list(recursive: true)) {
+    if (entity is! File) continue;
+    final result = await Process.run(
+        'dd', ['if=${entity.path}', 'iflag=nocache', 'count=0']);
+    if (result.exitCode != 0) {
+      throw StateError('Cannot drop ${entity.path} from the page cache: '
+          '${result.stderr}');
+    }
+  }
+}
+
+/// Launches the bundle once with an empty profile and reads its trace back.
+/// [cache], when given, replaces the profile's cache directory.
+Future<_RunResult?> _launch(File executable, Directory work, int run,
+    _Display display, _StandInServer server, int switches,
+    {Directory? cache}) async {
+  final home = await Directory('${work.path}/run$run').create();
+  final tracePath = '${home.path}/trace.json';
+  final environment = {
+    ...display.environment,
+    'HOME': home.path,
+    'XDG_CONFIG_HOME': '${home.path}/config',
+    'XDG_DATA_HOME': '${home.path}/data',
+    'XDG_CACHE_HOME': cache?.path ?? '${home.path}/cache',
+  };
+
+  final launchedUs = _monotonicMicros();
+  final process = await Process.start(
+    executable.path,
+    [
+      '--trace=$tracePath',
+      '--bench',
+      '--bench-api=${server.origin}',
+      '--bench-switches=$switches',
+    ],
+    environment: environment,
+  );
+  final log = StringBuffer();
+  process.stdout.transform(utf8.decoder).listen(log.write);
+  process.stderr.transform(utf8.decoder).listen(log.write);
+  final exitCode = await process.exitCode.timeout(
+    const Duration(minutes: 2),
+    onTimeout: () {
+      process.kill();
+      return -1;
+    },
+  );
+
+  final trace = File(tracePath);
+  if (exitCode != 0 || !trace.existsSync()) {
+    stderr.writeln('run $run failed (exit code $exitCode):\n$log');
+    return null;
+  }
+  final result = _readTrace(
+      jsonDecode(await trace.readAsString()) as Map<String, dynamic>,
+      launchedUs);
+  if (result == null) {
+    stderr.writeln('run $run did not finish its scenarios:\n$log');
+  } else if (display.wayland && !result.layerShell) {
+    stderr.writeln('run $run: the floating view is not on layer-shell:\n$log');
+    return null;
+  }
+  return result;
+}
+
+/// Collects the `bench: ...` spans of one run, in milliseconds. Null when
+/// the driver reported a failure or the first frame is missing.
+_RunResult? _readTrace(Map<String, dynamic> trace, int launchedUs) {
+  final samples = <String, List<double>>{};
+  final skipped = <String>{};
+  final open = <String, double>{};
+  double? swapBegin;
+  var layerShell = false;
+  const prefix = 'bench: ';
+  const skippedSuffix = ' skipped';
+
+  for (final event in (trace['traceEvents'] as List).cast<Map>()) {
+    final name = event['name'] as String? ?? '';
+    final ts = (event['ts'] as num?)?.toDouble();
+    switch (event['ph']) {
+      case 'i' when event['cat'] == 'runner' && name == 'first frame':
+        samples
+            .putIfAbsent(_coldStart, () => [])
+            .add((ts! - launchedUs) / 1000);
+      case 'B' when name == 'window: swap':
+        swapBegin = ts;
+      case 'E' when name == 'window: swap' && swapBegin != null:
+        samples
+            .putIfAbsent(_windowSwap, () => [])
+            .add((ts! - swapBegin) / 1000);
+        swapBegin = null;
+      case 'X' when name == _startupPrefetch:
+        samples
+            .putIfAbsent(_startupPrefetch, () => [])
+            .add((event['dur'] as num).toDouble() / 1000);
+      case 'C' when name == 'swap blank ms':
+        samples
+            .putIfAbsent(_swapBlank, () => [])
+            .add(((event['args'] as Map)['value'] as num).toDouble());
+      case 'i' when name == _layerShell:
+        layerShell = true;
+      case 'i' when name == 'bench: failed':
+        return null;
+      case 'i' when name.startsWith(prefix) && name.endsWith(skippedSuffix):
+        skipped.add(name.substring(
+            prefix.length, name.length - skippedSuffix.length));
+      case 'b' when name.startsWith(prefix):
+        open['${event['id']}'] = ts!;
+      case 'e' when name.startsWith(prefix):
+        final begin = open.remove('${event['id']}');
+        if (begin != null) {
+          samples
+              .putIfAbsent(name.substring(prefix.length), () => [])
+              .add((ts! - begin) / 1000);
+        }
+    }
+  }
+  if (!samples.containsKey(_coldStart)) return null;
+  // A skipped scenario still leaves a span, which timed nothing.
+  samples.removeWhere((name, _) => skipped.contains(name));
+  return _RunResult(samples, skipped, layerShell: layerShell);
+}
+
+class _Summary {
+  final int count;
+  final double min, mean, p50, p90, p95, max;
+
+  _Summary(this.count, this.min, this.mean, this.p50, this.p90, this.p95,
+      this.max);
+
+  factory _Summary.of(List<double> values) {
+    final sorted = [...values]..sort();
+    final mean = sorted.reduce((a, b) => a + b) / sorted.length;
+    return _Summary(sorted.length, sorted.first, mean, _percentile(sorted, 50),
+        _percentile(sorted, 90), _percentile(sorted, 95), sorted.last);
+  }
+
+  /// Linear interpolation between the closest ranks.
+  static double _percentile(List<double> sorted, double p) {
+    final rank = (sorted.length - 1) * p / 100;
+    final low = rank.floor();
+    final high = rank.ceil();
+    return sorted[low] + (sorted[high] - sorted[low]) * (rank - low);
+  }
+
+  Map<String, Object> toJson() => {
+        'count': count,
+        'min': _round(min),
+        'mean': _round(mean),
+        'p50': _round(p50),
+        'p90': _round(p90),
+        'p95': _round(p95),
+        'max': _round(max),
+      };
+
+  static double _round(double ms) => (ms * 100).roundToDouble() / 100;
+}
+
+/// Prints each scenario against the baseline and returns the ones whose
+/// median regressed by more than [threshold].
+List<String> _compare(Map<String, dynamic> baseline,
+    Map<String, dynamic> current, double threshold) {
+  final expected = baseline['scenarios'] as Map<String, dynamic>? ?? {};
+  final regressions = <String>[];
+  for (final name in current.keys.toList()..sort()) {
+    final now = (current[name] as Map<String, Object>)['p50'] as double;
+    final before = (expected[name] as Map<String, dynamic>?)?['p50'] as num?;
+    if (before == null) {
+      stdout.writeln('  $name: p50 ${now.toStringAsFixed(1)} ms (new)');
+      continue;
+    }
+    if (before <= 0) {
+      // A blank time of zero has no relative change to compare.
+      stdout.writeln('  $name: p50 ${now.toStringAsFixed(1)} ms, '
+          'baseline ${before.toStringAsFixed(1)} ms');
+      continue;
+    }
+    final change = now / before - 1;
+    final regressed = change > threshold;
+    if (regressed) regressions.add(name);
+    stdout.writeln('  $name: p50 ${now.toStringAsFixed(1)} ms, '
+        'baseline ${before.toStringAsFixed(1)} ms '
+        '(${change >= 0 ? '+' : ''}${(change * 100).toStringAsFixed(1)}%)'
+        '${regressed ? '  REGRESSION' : ''}');
+  }
+  for (final name in expected.keys) {
+    if (!current.containsKey(name)) {
+      stdout.writeln('  $name: in the baseline but not measured');
+    }
+  }
+  return regressions;
+}
+
+/// A stand-in for the API server: login succeeds for any address and every
+/// list comes back empty, so the scenarios time the app rather than the
+/// network. WebSocket upgrades are refused, which fails the Socket.IO
+/// connect at once.
+class _StandInServer {
+  final HttpServer _server;
+
+  _StandInServer._(this._server) {
+    _server.listen(_handle);
+  }
+
+  static Future<_StandInServer> start() async => _StandInServer._(
+      await HttpServer.bind(InternetAddress.loopbackIPv4, 0));
+
+  String get origin => 'http://127.0.0.1:${_server.port}';
+
+  static const _user = {
+    'id': 'bench-user',
+    'email': 'bench@example.com',
+    'firstName': 'Bench',
+    'lastName': 'User',
+    'role': 'employee',
+    'permissions': <String>[],
+  };
+
+  Future<void> _handle(HttpRequest request) async {
+    await request.drain<void>();
+    final path = request.uri.path.replaceFirst('/api/v1', '');
+    final Object body;
+    var status = HttpStatus.ok;
+    switch (path) {
+      case '/auth/login':
+        body = {'success': true, 'loginSessionToken': 'bench-session'};
+      case '/auth/verify-login-otp':
+      case '/auth/refresh-token':
+        body = {
+          'success': true,
+          'accessToken': 'bench-access',
+          'refreshToken': 'bench-refresh',
+          'user': _user,
+        };
+      case '/users/me':
+        body = {'success': true, 'user': _user};
+      case '/projects':
+        body = {'success': true, 'projects': <Object>[]};
+      default:
+        if (path.startsWith('/socket.io')) {
+          status = HttpStatus.notFound;
+          body = {'success': false};
+        } else {
+          body = {'success': true, 'data': <Object>[]};
+        }
+    }
+    request.response
+      ..statusCode = status
+      ..headers.contentType = ContentType.json
+      ..write(jsonEncode(body));
+    await request.response.close();
+  }
+
+  Future<void> close() => _server.close(force: true);
+}
+
+final class _Timespec extends Struct {
+  @Int64()
+  external int seconds;
+  @Int64()
+  external int nanoseconds;
+}
+
+final _clockGettime = DynamicLibrary.process().lookupFunction<
+    Int32 Function(Int32, Pointer<_Timespec>),
+    int Function(int, Pointer<_Timespec>)>('clock_gettime');
+
+/// CLOCK_MONOTONIC, the clock the runner stamps trace events with.
+int _monotonicMicros() {
+  const clockMonotonic = 1;
+  final now = calloc<_Timespec>();
+  try {
+    _clockGettime(clockMonotonic, now);
+    return now.ref.seconds * 1000000 + now.ref.nanoseconds ~/ 1000;
+  } finally {
+    calloc.free(now);
+  }
+}
@@ -0,0 +1,163 @@
+import 'dart:convert';
+import 'dart:io';
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:silver_stone/services/resumable_download.dart';
+
+/// A stand-in for the release download server that speaks just enough HTTP
+/// to honour Range/If-Range and can drop the connection mid-body.
+class _FakeServer {
+  final ServerSocket _socket;
+  Uint8List body;
+  String etag;
+
+  /// Bytes of the body to send before closing the connection, per request;
+  /// requests past the end of the list get the whole body.
+  List<int> cutAfter = [];
+
+  final requests = <Map<String, String>>[];
+
+  _FakeServer._(this._socket, this.body, this.etag) {
+    _socket.listen(_handle);
+  }
+
+  static Future<_FakeServer> start(Uint8List body, String etag) async {
+    final socket = await ServerSocket.bind(InternetAddress.loopbackIPv4, 0);
+    return _FakeServer._(socket, body, etag);
+  }
+
+  Uri get url => Uri.parse('http://127.0.0.1:${_socket.port}/update.sspatch');
+
+  Future<void> _handle(Socket client) async {
+    final head = StringBuffer();
+    await for (final data in client) {
+      head.write(latin1.decode(data));
+      if (head.toString().contains('\r\n\r\n')) break;
+    }
+    final headers = <String, String>{};
+    for (final line in head.toString().split('\r\n').skip(1)) {
+      final colon = line.indexOf(':');
+      if (colon > 0) {
+        headers[line.substring(0, colon).toLowerCase()] =
+            line.substring(colon + 1).trim();
+      }
+    }
+    final index = requests.length;
+    requests.add(headers);
+
+    var start = 0;
+    final range = RegExp(r'bytes=(\d+)-').firstMatch(headers['range'] ?? '');
+    if (range != null && headers['if-range'] == etag) {
+      start = int.parse(range.group(1)!);
+    }
+    final status = start > 0 ? '206 Partial Content' : '200 OK';
+    final response = StringBuffer()
+      ..write('HTTP/1.1 $status\r\n')
+      ..write('Content-Length: ${body.length - start}\r\n')
+      ..write('ETag: $etag\r\n')
+      ..write('Connection: close\r\n');
+    if (start > 0) {
+      response.write(
+          'Content-Range: bytes $start-${body.length - 1}/${body.length}\r\n');
+    }
+    response.write('\r\n');
+    client.add(latin1.encode(response.toString()));
+
+    var end = body.length;
+    if (index < cutAfter.length) end = start + cutAfter[index];
+    client.add(body.sublist(start, end));
+    await client.flush();
+    client.destroy();
+  }
+
+  Future<void> close() => _socket.close();
+}
+
+Uint8List _bytes(int length, int seed) =>
+    Uint8List.fromList(List.generate(length, (i) => (i * 31 + seed) & 0xff));
+
+void main() {
+  late Directory dir;
+  late _FakeServer server;
+
+  setUp(() async {
+    dir = await Directory.systemTemp.createTemp('resumable_download_test');
+    server = await _FakeServer.start(_bytes(300000, 1), '"v1"');
+  });
+
+  tearDown(() async {
+    await server.close();
+    await dir.delete(recursive: true);
+  });
+
+  ResumableDownload download() => ResumableDownload(
+        url: server.url,
+        target: File('${dir.path}/update.sspatch'),
+        retryDelay: (_) => Duration.zero,
+      );
+
+  test('resumes after the connection drops mid-body', () async {
+    server.cutAfter = [100000, 50000];
+    var lastReceived = 0;
+    final file = await download().run(
+      onProgress: (received, total) {
+        expect(total, 300000);
+        lastReceived = received;
+      },
+    );
+
+    expect(await file.readAsBytes(), server.body);
+    expect(lastReceived, 300000);
+    expect(server.requests, hasLength(3));
+    expect(server.requests[0].containsKey('range'), isFalse);
+    expect(server.requests[1]['range'], 'bytes=100000-');
+    expect(server.requests[1]['if-range'], '"v1"');
+    expect(server.requests[2]['range'], 'bytes=150000-');
+    expect(File('${file.path}.part').existsSync(), isFalse);
+  });
+
+  test('resumes a partial file left by an earlier run', () async {
+    server.cutAfter = [120000];
+    final first = ResumableDownload(
+      url: server.url,
+      target: File('${dir.path}/update.sspatch'),
+      maxAttempts: 1,
+    );
+    await expectLater(first.run(), throwsA(isA<HttpException>()));
+    expect(File('${dir.path}/update.sspatch.part').lengthSync(), 120000);
+
+    final file = await download().run();
+    expect(await file.readAsBytes(), server.body);
+    expect(server.requests.last['range'], 'bytes=120000-');
+  });
+
+  test('starts over when the file changed on the server', () async {
+    server.cutAfter = [80000];
+    final first = ResumableDownload(
+      url: server.url,
+      target: File('${dir.path}/update.sspatch'),
+      maxAttempts: 1,
+    );
+    await expectLater(first.run(), throwsA(isA<HttpException>()));
+
+    server
+      ..body = _bytes(200000, 7)
+      ..etag = '"v2"';
+    final file = await download().run();
+
+    expect(await file.readAsBytes(), server.body);
+    expect(server.requests.last['if-range'], '"v1"');
+  });
+
+  test('gives up after maxAttempts failures', () async {
+    server.cutAfter = [10, 10, 10];
+    final failing = ResumableDownload(
+      url: server.url,
+      target: File('${dir.path}/update.sspatch'),
+      maxAttempts: 3,
+      retryDelay: (_) => Duration.zero,
+    );
+    await expectLater(failing.run(), throwsA(isA<HttpException>()));
+    expect(server.requests, hasLength(3));
+  });
+}
@@ -1,19 +1,119 @@
 #include "audio_recorder_plugin.h"
 
+#include "channel_instrumentation.h"
+#include "media/mp4_faststart.h"
+#include "runner/utf16.h"
+
+#include <fstream>
 #include <iostream>
 #include <shlobj.h>
-#include <codecvt>
-#include <locale>
-
-// Helper to convert std::string to std::wstring
-static std::wstring StringToWString(const std::string& str) {
-    if (str.empty()) return std::wstring();
-    int size_needed = MultiByteToWideChar(CP_UTF8, 0, &str[0], (int)str.size(), NULL, 0);
-    std::wstring wstrTo(size_needed, 0);
-    MultiByteToWideChar(CP_UTF8, 0, &str[0], (int)str.size(), &wstrTo[0], size_needed);
-    return wstrTo;
+#include <vector>
+
+namespace {
+
+// One recording through Media Foundation: the default capture device,
+// decoded to PCM, into an AAC sink writer. AudioRecorder runs the loop.
+class MediaFoundationCapture : public AudioCaptureBackend {
+public:
+    ~MediaFoundationCapture() override { Release(); }
+
+    bool Open(const std::string& path) override;
+    Step Read(AudioBlock* block) override;
+    bool Write() override;
+    void Close() override;
+
+private:
+    void Release();
+
+    IMFSourceReader* source_reader_ = nullptr;
+    IMFSinkWriter* sink_writer_ = nullptr;
+    DWORD stream_index_ = 0;
+    // Read() and not yet written.
+    IMFSample* pending_sample_ = nullptr;
+};
+
+// The sink writer puts the index (moov) after the audio. Rewrites |path|
+// with it first, so the upload can be read as it arrives, the way Linux
+// does before uploading (lib/services/media_container_service.dart). The
+// recording is mapped rather than read in, so only the pages being copied
+// are resident, and the new file is written out as it is produced, next to
+// the recording and then moved over it; a failure leaves the recording as
+// it was. Runs on a worker thread.
+void MoveIndexFirst(const std::string& path) {
+    std::u16string utf16_path = Utf16FromUtf8(path);
+    std::wstring wpath(utf16_path.begin(), utf16_path.end());
+    std::wstring temp_path = wpath + L".faststart";
+
+    std::string error = "cannot read the recording";
+    FaststartResult result = FaststartResult::kFailed;
+    HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    LARGE_INTEGER size = {};
+    HANDLE mapping = nullptr;
+    const uint8_t* data = nullptr;
+    if (file != INVALID_HANDLE_VALUE && GetFileSizeEx(file, &size) &&
+        size.QuadPart > 0) {
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0,
+                                     nullptr);
+    }
+    if (mapping != nullptr) {
+        data = static_cast<const uint8_t*>(
+            MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (data != nullptr) {
+        std::ofstream output(temp_path, std::ios::binary | std::ios::trunc);
+        result = FaststartMp4(
+            data, static_cast<size_t>(size.QuadPart),
+            [&output](const uint8_t* bytes, size_t count) {
+                output.write(reinterpret_cast<const char*>(bytes),
+                             static_cast<std::streamsize>(count));
+                return output.good();
+            },
+            &error);
+        output.close();
+        if (result == FaststartResult::kRewritten && output.fail()) {
+            result = FaststartResult::kFailed;
+            error = "write failed";
+        }
+    }
+    // The recording cannot be replaced while it is open.
+    if (data != nullptr) {
+        UnmapViewOfFile(data);
+    }
+    if (mapping != nullptr) {
+        CloseHandle(mapping);
+    }
+    if (file != INVALID_HANDLE_VALUE) {
+        CloseHandle(file);
+    }
+
+    if (result == FaststartResult::kRewritten &&
+        !MoveFileExW(temp_path.c_str(), wpath.c_str(),
+                     MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        result = FaststartResult::kFailed;
+        error = "cannot replace the recording";
+    }
+    if (result != FaststartResult::kRewritten) {
+        DeleteFileW(temp_path.c_str());
+    }
+    if (result == FaststartResult::kFailed) {
+        std::cerr << "AudioRecorderPlugin: Index left at the end of " << path
+                  << ": " << error << std::endl;
+    }
 }
 
+// Call number of stopRecording in codec/fast_messages.schema.
+constexpr uint8_t kFastStopRecordingCall = 3;
+
+bool IsFastStopRecording(const std::vector<uint8_t>& call) {
+    // Magic, version, call number; Dispatch() checks the rest.
+    return call.size() >= 3 && call[0] == kFastCallMagic &&
+           call[2] == kFastStopRecordingCall;
+}
+
+}  // namespace
+
 void AudioRecorderPlugin::RegisterWithRegistrar(
     FlutterDesktopPluginRegistrarRef registrar_ref) {
     // Wrap the registrar ref
@@ -23,9 +123,11 @@ void AudioRecorderPlugin::RegisterWithRegistrar(
         std::make_unique<AudioRecorderPlugin>(registrar.get());
 }
 
-AudioRecorderPlugin::AudioRecorderPlugin(flutter::PluginRegistrarWindows* registrar) {
+AudioRecorderPlugin::AudioRecorderPlugin(flutter::PluginRegistrarWindows* registrar)
+    : registrar_(registrar),
+      recorder_(std::make_unique<MediaFoundationCapture>()) {
     channel_ = std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
-        registrar->messenger(),
+        InstrumentedMessengerFor(registrar->messenger()),
         "com.silverstone.audio_recorder",
         &flutter::StandardMethodCodec::GetInstance());
 
@@ -35,6 +137,37 @@ AudioRecorderPlugin::AudioRecorderPlugin(flutter::PluginRegistrarWindows* regist
             HandleMethodCall(call, std::move(result));
         });
 
+    // As SetFastChannelHandler() (fast_channel.h), except that stopRecording
+    // is answered once the recording has been rewritten, which the
+    // generated dispatcher cannot wait for.
+    InstrumentedMessengerFor(registrar->messenger())->SetMessageHandler(
+        fast_messages::audio_recorder::kChannel,
+        [this](const uint8_t* message, size_t size, flutter::BinaryReply reply) {
+            std::vector<uint8_t> call(message, message + size);
+            auto answer = [this, call, reply]() {
+                std::vector<uint8_t> response = fast_messages::audio_recorder::Dispatch(
+                    this, call.data(), call.size());
+                reply(response.empty() ? nullptr : response.data(), response.size());
+            };
+            if (!IsFastStopRecording(call)) {
+                answer();
+                return;
+            }
+            StopRecording([this, answer](const std::string& path,
+                                         const AudioRecorderStats& stats) {
+                stopped_path_ = path;
+                stopped_stats_ = stats;
+                answer();
+            });
+        });
+
+    // Lets the faststart worker hand its result back to the platform thread.
+    run_tasks_message_ = RegisterWindowMessageW(L"SilverStoneAudioRecorderTasks");
+    window_proc_id_ = registrar->RegisterTopLevelWindowProcDelegate(
+        [this](HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam) {
+            return HandleWindowMessage(hwnd, message, wparam, lparam);
+        });
+
     // Initialize Media Foundation
     HRESULT hr = MFStartup(MF_VERSION);
     if (FAILED(hr)) {
@@ -43,12 +176,12 @@ AudioRecorderPlugin::AudioRecorderPlugin(flutter::PluginRegistrarWindows* regist
 }
 
 AudioRecorderPlugin::~AudioRecorderPlugin() {
-    if (is_recording_) {
-        stop_requested_ = true;
-        if (recording_thread_.joinable()) {
-            recording_thread_.join();
-        }
+    // The file is finished before Media Foundation goes away.
+    recorder_.Stop();
+    if (faststart_thread_.joinable()) {
+        faststart_thread_.join();
     }
+    registrar_->UnregisterTopLevelWindowProcDelegate(window_proc_id_);
     MFShutdown();
 }
 
@@ -78,12 +211,16 @@ void AudioRecorderPlugin::HandleMethodCall(
         result->Error("INVALID_ARGS", "Path is required");
     }
     else if (method == "stopRecording") {
-        std::string path = StopRecording();
-        if (!path.empty()) {
-            result->Success(flutter::EncodableValue(path));
-        } else {
-            result->Error("NO_RECORDER", "No active recording");
-        }
+        // Answered once the recording has been rewritten.
+        std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>> pending =
+            std::move(result);
+        StopRecording([pending](const std::string& path, const AudioRecorderStats&) {
+            if (!path.empty()) {
+                pending->Success(flutter::EncodableValue(path));
+            } else {
+                pending->Error("NO_RECORDER", "No active recording");
+            }
+        });
     }
     else if (method == "isRecording") {
         result->Success(flutter::EncodableValue(IsRecording()));
@@ -101,46 +238,122 @@ bool AudioRecorderPlugin::HasPermission() {
 }
 
 bool AudioRecorderPlugin::StartRecording(const std::string& path) {
-    if (is_recording_) {
+    if (!recorder_.Start(path)) {
         std::cerr << "AudioRecorderPlugin: Already recording" << std::endl;
         return false;
     }
-
-    current_file_path_ = path;
-    stop_requested_ = false;
-    is_recording_ = true;
-
-    // Start recording in a background thread
-    recording_thread_ = std::thread(&AudioRecorderPlugin::RecordingThread, this);
-
     std::cout << "AudioRecorderPlugin: Recording started to " << path << std::endl;
     return true;
 }
 
-std::string AudioRecorderPlugin::StopRecording() {
-    if (!is_recording_) {
-        return "";
+void AudioRecorderPlugin::StopRecording(
+    std::function<void(const std::string& path,
+                       const AudioRecorderStats& stats)> done) {
+    const std::string path = recorder_.Stop();
+    const AudioRecorderStats stats = recorder_.last_stats();
+    if (path.empty()) {
+        done(path, stats);
+        return;
     }
+    std::cout << "AudioRecorderPlugin: Recording stopped, file: " << path
+              << " (" << DescribeAudioRecorderStats(stats) << ")" << std::endl;
 
-    stop_requested_ = true;
+    flutter::FlutterView* view = registrar_->GetView();
+    HWND window = view != nullptr ? GetAncestor(view->GetNativeWindow(), GA_ROOT)
+                                  : nullptr;
+    if (window == nullptr) {
+        // Nothing to post the answer to; rewrite in place.
+        MoveIndexFirst(path);
+        done(path, stats);
+        return;
+    }
+    // A long recording takes a while to rewrite; the UI keeps running.
+    if (faststart_thread_.joinable()) {
+        faststart_thread_.join();
+    }
+    faststart_thread_ = std::thread([this, window, path, stats, done]() {
+        MoveIndexFirst(path);
+        {
+            std::lock_guard<std::mutex> lock(tasks_mutex_);
+            platform_tasks_.push_back([path, stats, done]() { done(path, stats); });
+        }
+        PostMessage(window, run_tasks_message_, 0, 0);
+    });
+}
 
-    if (recording_thread_.joinable()) {
-        recording_thread_.join();
+std::optional<LRESULT> AudioRecorderPlugin::HandleWindowMessage(
+    HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam) {
+    if (message != run_tasks_message_) {
+        return std::nullopt;
+    }
+    std::vector<std::function<void()>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex_);
+        tasks.swap(platform_tasks_);
+    }
+    for (const std::function<void()>& task : tasks) {
+        task();
     }
+    return 0;
+}
 
-    is_recording_ = false;
-    std::string path = current_file_path_;
-    current_file_path_.clear();
+bool AudioRecorderPlugin::IsRecording() {
+    return recorder_.IsRecording();
+}
 
-    std::cout << "AudioRecorderPlugin: Recording stopped, file: " << path << std::endl;
-    return path;
+bool AudioRecorderPlugin::HasPermission(
+    const fast_messages::audio_recorder::HasPermissionArgs& args,
+    fast_messages::audio_recorder::HasPermissionResult* result,
+    FastError* error) {
+    result->granted = HasPermission();
+    return true;
 }
 
-bool AudioRecorderPlugin::IsRecording() {
-    return is_recording_;
+bool AudioRecorderPlugin::StartRecording(
+    const fast_messages::audio_recorder::StartRecordingArgs& args,
+    fast_messages::audio_recorder::StartRecordingResult* result,
+    FastError* error) {
+    result->started = StartRecording(args.path.ToString());
+    return true;
+}
+
+bool AudioRecorderPlugin::StopRecording(
+    const fast_messages::audio_recorder::StopRecordingArgs& args,
+    fast_messages::audio_recorder::StopRecordingResult* result,
+    FastError* error) {
+    // Dispatched only once StopRecording() above has called back.
+    result->path = stopped_path_;
+    if (result->path.empty()) {
+        *error = {"NO_RECORDER", "No active recording"};
+        return false;
+    }
+    const AudioRecorderStats& stats = stopped_stats_;
+    result->samples = static_cast<int64_t>(stats.samples);
+    result->empty_reads = static_cast<int64_t>(stats.empty_reads);
+    result->xruns = static_cast<int64_t>(stats.xruns);
+    result->timestamp_gaps = static_cast<int64_t>(stats.timestamp_gaps);
+    result->missing_us = stats.missing_us;
+    result->max_gap_us = stats.max_gap_us;
+    result->max_backlog_us = stats.max_backlog_us;
+    result->media_us = stats.media_us;
+    result->write_p50_us = static_cast<int64_t>(stats.write_latency.PercentileUs(50));
+    result->write_p99_us = static_cast<int64_t>(stats.write_latency.PercentileUs(99));
+    result->write_max_us = static_cast<int64_t>(stats.write_latency.max_us);
+    result->finish_us = stats.finish_us;
+    result->file_bytes = static_cast<int64_t>(stats.file_bytes);
+    result->failed = stats.failed;
+    return true;
 }
 
-void AudioRecorderPlugin::RecordingThread() {
+bool AudioRecorderPlugin::IsRecording(
+    const fast_messages::audio_recorder::IsRecordingArgs& args,
+    fast_messages::audio_recorder::IsRecordingResult* result,
+    FastError* error) {
+    result->recording = IsRecording();
+    return true;
+}
+
+bool MediaFoundationCapture::Open(const std::string& path) {
     HRESULT hr = S_OK;
     IMFMediaSource* pSource = nullptr;
     IMFAttributes* pAttributes = nullptr;
@@ -151,8 +364,7 @@ void AudioRecorderPlugin::RecordingThread() {
     hr = MFCreateAttributes(&pAttributes, 1);
     if (FAILED(hr)) {
         std::cerr << "AudioRecorderPlugin: Failed to create attributes" << std::endl;
-        is_recording_ = false;
-        return;
+        return false;
     }
 
     // Request audio capture devices
@@ -161,8 +373,7 @@ void AudioRecorderPlugin::RecordingThread() {
     if (FAILED(hr)) {
         std::cerr << "AudioRecorderPlugin: Failed to set device type" << std::endl;
         pAttributes->Release();
-        is_recording_ = false;
-        return;
+        return false;
     }
 
     // Enumerate audio capture devices
@@ -171,8 +382,7 @@ void AudioRecorderPlugin::RecordingThread() {
 
     if (FAILED(hr) || deviceCount == 0) {
         std::cerr << "AudioRecorderPlugin: No audio capture devices found" << std::endl;
-        is_recording_ = false;
-        return;
+        return false;
     }
 
     // Activate the first audio device
@@ -186,8 +396,7 @@ void AudioRecorderPlugin::RecordingThread() {
 
     if (FAILED(hr)) {
         std::cerr << "AudioRecorderPlugin: Failed to activate audio device" << std::endl;
-        is_recording_ = false;
-        return;
+        return false;
     }
 
     // Create source reader
@@ -196,8 +405,7 @@ void AudioRecorderPlugin::RecordingThread() {
 
     if (FAILED(hr)) {
         std::cerr << "AudioRecorderPlugin: Failed to create source reader" << std::endl;
-        is_recording_ = false;
-        return;
+        return false;
     }
 
     // Configure the source reader to decode to PCM
@@ -219,10 +427,8 @@ void AudioRecorderPlugin::RecordingThread() {
 
     if (FAILED(hr)) {
         std::cerr << "AudioRecorderPlugin: Failed to configure audio format" << std::endl;
-        source_reader_->Release();
-        source_reader_ = nullptr;
-        is_recording_ = false;
-        return;
+        Release();
+        return false;
     }
 
     // Get the actual format
@@ -230,14 +436,13 @@ void AudioRecorderPlugin::RecordingThread() {
     hr = source_reader_->GetCurrentMediaType(static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM), &pActualType);
     if (FAILED(hr)) {
         std::cerr << "AudioRecorderPlugin: Failed to get media type" << std::endl;
-        source_reader_->Release();
-        source_reader_ = nullptr;
-        is_recording_ = false;
-        return;
+        Release();
+        return false;
     }
 
     // Create sink writer for AAC output
-    std::wstring wpath = StringToWString(current_file_path_);
+    std::u16string utf16_path = Utf16FromUtf8(path);
+    std::wstring wpath(utf16_path.begin(), utf16_path.end());
 
     IMFAttributes* pSinkAttributes = nullptr;
     MFCreateAttributes(&pSinkAttributes, 1);
@@ -253,10 +458,8 @@ void AudioRecorderPlugin::RecordingThread() {
     if (FAILED(hr)) {
         std::cerr << "AudioRecorderPlugin: Failed to create sink writer: " << std::hex << hr << std::endl;
         pActualType->Release();
-        source_reader_->Release();
-        source_reader_ = nullptr;
-        is_recording_ = false;
-        return;
+        Release();
+        return false;
     }
 
     // Create AAC output type
@@ -281,9 +484,8 @@ void AudioRecorderPlugin::RecordingThread() {
         hr = pOutputType->SetUINT32(MF_MT_AUDIO_AVG_BYTES_PER_SECOND, 16000);
     }
 
-    DWORD streamIndex = 0;
     if (SUCCEEDED(hr)) {
-        hr = sink_writer_->AddStream(pOutputType, &streamIndex);
+        hr = sink_writer_->AddStream(pOutputType, &stream_index_);
     }
     if (pOutputType) {
         pOutputType->Release();
@@ -292,90 +494,106 @@ void AudioRecorderPlugin::RecordingThread() {
     if (FAILED(hr)) {
         std::cerr << "AudioRecorderPlugin: Failed to add output stream: " << std::hex << hr << std::endl;
         pActualType->Release();
-        sink_writer_->Release();
-        sink_writer_ = nullptr;
-        source_reader_->Release();
-        source_reader_ = nullptr;
-        is_recording_ = false;
-        return;
+        Release();
+        return false;
     }
 
     // Set input type on sink writer
-    hr = sink_writer_->SetInputMediaType(streamIndex, pActualType, nullptr);
+    hr = sink_writer_->SetInputMediaType(stream_index_, pActualType, nullptr);
     pActualType->Release();
 
     if (FAILED(hr)) {
         std::cerr << "AudioRecorderPlugin: Failed to set input media type: " << std::hex << hr << std::endl;
-        sink_writer_->Release();
-        sink_writer_ = nullptr;
-        source_reader_->Release();
-        source_reader_ = nullptr;
-        is_recording_ = false;
-        return;
+        Release();
+        return false;
     }
 
     // Begin writing
     hr = sink_writer_->BeginWriting();
     if (FAILED(hr)) {
         std::cerr << "AudioRecorderPlugin: Failed to begin writing: " << std::hex << hr << std::endl;
-        sink_writer_->Release();
-        sink_writer_ = nullptr;
-        source_reader_->Release();
-        source_reader_ = nullptr;
-        is_recording_ = false;
-        return;
+        Release();
+        return false;
     }
 
     std::cout << "AudioRecorderPlugin: Recording loop started" << std::endl;
+    return true;
+}
 
-    // Recording loop
-    while (!stop_requested_) {
-        DWORD dwFlags = 0;
-        LONGLONG llTimestamp = 0;
-        IMFSample* pSample = nullptr;
-
-        hr = source_reader_->ReadSample(
-            static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM),
-            0,
-            nullptr,
-            &dwFlags,
-            &llTimestamp,
-            &pSample);
-
-        if (FAILED(hr)) {
-            std::cerr << "AudioRecorderPlugin: ReadSample failed" << std::endl;
-            break;
-        }
+AudioCaptureBackend::Step MediaFoundationCapture::Read(AudioBlock* block) {
+    DWORD dwFlags = 0;
+    LONGLONG llTimestamp = 0;
+    IMFSample* pSample = nullptr;
 
-        if (dwFlags & MF_SOURCE_READERF_ENDOFSTREAM) {
-            std::cout << "AudioRecorderPlugin: End of stream" << std::endl;
-            break;
-        }
+    HRESULT hr = source_reader_->ReadSample(
+        static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM),
+        0,
+        nullptr,
+        &dwFlags,
+        &llTimestamp,
+        &pSample);
+
+    if (FAILED(hr)) {
+        std::cerr << "AudioRecorderPlugin: ReadSample failed" << std::endl;
+        return Step::kError;
+    }
 
+    if (dwFlags & MF_SOURCE_READERF_ENDOFSTREAM) {
+        std::cout << "AudioRecorderPlugin: End of stream" << std::endl;
         if (pSample) {
-            hr = sink_writer_->WriteSample(streamIndex, pSample);
             pSample->Release();
-
-            if (FAILED(hr)) {
-                std::cerr << "AudioRecorderPlugin: WriteSample failed" << std::endl;
-                break;
-            }
         }
+        return Step::kEndOfStream;
     }
 
-    std::cout << "AudioRecorderPlugin: Recording loop ended" << std::endl;
+    if (!pSample) {
+        return Step::kNoSample;
+    }
+
+    // Media Foundation times are in 100 ns units.
+    LONGLONG duration = 0;
+    pSample->GetSampleDuration(&duration);
+    UINT32 discontinuity = FALSE;
+    pSample->GetUINT32(MFSampleExtension_Discontinuity, &discontinuity);
+    block->timestamp_us = llTimestamp / 10;
+    block->duration_us = duration / 10;
+    block->discontinuity = discontinuity != FALSE;
+    pending_sample_ = pSample;
+    return Step::kBlock;
+}
 
-    // Finalize
+bool MediaFoundationCapture::Write() {
+    HRESULT hr = sink_writer_->WriteSample(stream_index_, pending_sample_);
+    pending_sample_->Release();
+    pending_sample_ = nullptr;
+
+    if (FAILED(hr)) {
+        std::cerr << "AudioRecorderPlugin: WriteSample failed" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void MediaFoundationCapture::Close() {
+    std::cout << "AudioRecorderPlugin: Recording loop ended" << std::endl;
     if (sink_writer_) {
         sink_writer_->Finalize();
+    }
+    Release();
+    std::cout << "AudioRecorderPlugin: Recording thread finished" << std::endl;
+}
+
+void MediaFoundationCapture::Release() {
+    if (pending_sample_) {
+        pending_sample_->Release();
+        pending_sample_ = nullptr;
+    }
+    if (sink_writer_) {
         sink_writer_->Release();
         sink_writer_ = nullptr;
     }
-
     if (source_reader_) {
         source_reader_->Release();
         source_reader_ = nullptr;
     }
-
-    std::cout << "AudioRecorderPlugin: Recording thread finished" << std::endl;
 }
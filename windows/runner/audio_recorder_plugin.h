@@ -12,10 +12,16 @@
 #include <mferror.h>
 #include <mmdeviceapi.h>
 
-#include <string>
+#include <functional>
 #include <memory>
-#include <atomic>
+#include <mutex>
+#include <optional>
+#include <string>
 #include <thread>
+#include <vector>
+
+#include "codec/fast_messages.g.h"
+#include "runner/audio_recorder.h"
 
 #pragma comment(lib, "mfplat.lib")
 #pragma comment(lib, "mfreadwrite.lib")
@@ -23,7 +29,7 @@
 #pragma comment(lib, "ole32.lib")
 #pragma comment(lib, "mf.lib")
 
-class AudioRecorderPlugin {
+class AudioRecorderPlugin : public fast_messages::audio_recorder::Handler {
 public:
     static void RegisterWithRegistrar(FlutterDesktopPluginRegistrarRef registrar);
 
@@ -37,19 +43,48 @@ private:
 
     bool HasPermission();
     bool StartRecording(const std::string& path);
-    std::string StopRecording();
+    // Stops the recording, then moves its index first on a worker thread
+    // and calls |done| back on the platform thread with the path ("" if
+    // nothing was recording) and the recording's stats.
+    void StopRecording(
+        std::function<void(const std::string& path,
+                           const AudioRecorderStats& stats)> done);
     bool IsRecording();
 
-    void RecordingThread();
+    // Runs the callbacks the faststart worker posted to the top-level window.
+    std::optional<LRESULT> HandleWindowMessage(HWND hwnd, UINT message,
+                                               WPARAM wparam, LPARAM lparam);
 
+    // com.silverstone/fast/audio_recorder, the binary fast path for the
+    // same calls.
+    bool HasPermission(const fast_messages::audio_recorder::HasPermissionArgs& args,
+                       fast_messages::audio_recorder::HasPermissionResult* result,
+                       FastError* error) override;
+    bool StartRecording(const fast_messages::audio_recorder::StartRecordingArgs& args,
+                        fast_messages::audio_recorder::StartRecordingResult* result,
+                        FastError* error) override;
+    bool StopRecording(const fast_messages::audio_recorder::StopRecordingArgs& args,
+                       fast_messages::audio_recorder::StopRecordingResult* result,
+                       FastError* error) override;
+    bool IsRecording(const fast_messages::audio_recorder::IsRecordingArgs& args,
+                     fast_messages::audio_recorder::IsRecordingResult* result,
+                     FastError* error) override;
+
+    flutter::PluginRegistrarWindows* registrar_;
     std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> channel_;
-    std::string current_file_path_;
-    std::atomic<bool> is_recording_{false};
-    std::atomic<bool> stop_requested_{false};
-    std::thread recording_thread_;
+    // The capture loop (linux/native/runner) over Media Foundation.
+    AudioRecorder recorder_;
+
+    // Rewrites the last recording; joined before the next one starts.
+    std::thread faststart_thread_;
+    UINT run_tasks_message_ = 0;
+    int window_proc_id_ = 0;
+    std::mutex tasks_mutex_;
+    std::vector<std::function<void()>> platform_tasks_;
 
-    IMFSourceReader* source_reader_ = nullptr;
-    IMFSinkWriter* sink_writer_ = nullptr;
+    // What the stopRecording fast call being answered reports.
+    std::string stopped_path_;
+    AudioRecorderStats stopped_stats_;
 };
 
 #endif  // AUDIO_RECORDER_PLUGIN_H_
@@ -0,0 +1,177 @@
+#include "channel_instrumentation.h"
+
+#include <flutter/standard_method_codec.h>
+#include <windows.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <map>
+
+#include "diagnostics/channel_metrics.h"
+
+namespace {
+
+// How often the platform-thread lag probe fires.
+constexpr UINT kLagProbeIntervalMs = 100;
+
+// How often a summary goes to the debugger output while enabled.
+constexpr UINT kDumpIntervalMs = 60 * 1000;
+
+UINT_PTR g_lag_probe_timer = 0;
+UINT_PTR g_dump_timer = 0;
+std::chrono::steady_clock::time_point g_last_probe;
+
+uint64_t MicrosSince(std::chrono::steady_clock::time_point start) {
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+}
+
+// An in-flight call. The handler may reply before it returns or long
+// after, so whichever of the two happens last records the sample.
+struct InFlightCall {
+  MethodMetrics* method = nullptr;
+  std::chrono::steady_clock::time_point start;
+  bool in_handler = true;
+  bool responded = false;
+  ChannelCallSample sample;
+};
+
+class InstrumentedMessenger : public flutter::BinaryMessenger {
+ public:
+  explicit InstrumentedMessenger(flutter::BinaryMessenger* messenger)
+      : messenger_(messenger) {}
+
+  void Send(const std::string& channel,
+            const uint8_t* message,
+            size_t message_size,
+            flutter::BinaryReply reply) const override {
+    messenger_->Send(channel, message, message_size, std::move(reply));
+  }
+
+  void SetMessageHandler(const std::string& channel,
+                         flutter::BinaryMessageHandler handler) override {
+    if (!handler) {
+      messenger_->SetMessageHandler(channel, nullptr);
+      return;
+    }
+    messenger_->SetMessageHandler(
+        channel, [channel, handler](const uint8_t* message, size_t size,
+                                    flutter::BinaryReply reply) {
+          ChannelMetrics& metrics = ChannelMetrics::Get();
+          if (!metrics.enabled()) {
+            handler(message, size, std::move(reply));
+            return;
+          }
+          auto call = std::make_shared<InFlightCall>();
+          call->method = metrics.ForMessage(channel, message, size);
+          call->start = std::chrono::steady_clock::now();
+          call->sample.request_bytes = size;
+          handler(message, size,
+                  [call, reply](const uint8_t* response, size_t response_size) {
+                    if (!call->responded) {
+                      call->responded = true;
+                      call->sample.response_us = MicrosSince(call->start);
+                      call->sample.response_bytes = response_size;
+                      call->sample.status =
+                          StatusFromResponse(response, response_size);
+                      if (!call->in_handler) {
+                        call->method->Record(call->sample);
+                      }
+                    }
+                    reply(response, response_size);
+                  });
+          call->in_handler = false;
+          call->sample.handler_us = MicrosSince(call->start);
+          if (call->responded) {
+            call->method->Record(call->sample);
+          }
+        });
+  }
+
+ private:
+  flutter::BinaryMessenger* messenger_;
+};
+
+// Measures how late a periodic timer fires on the platform thread. Channel
+// messages are dispatched by the same message loop, so this is the time
+// they spend queued before their handler runs.
+void CALLBACK LagProbeTimerProc(HWND, UINT, UINT_PTR, DWORD) {
+  uint64_t elapsed = MicrosSince(g_last_probe);
+  uint64_t interval = kLagProbeIntervalMs * 1000ull;
+  ChannelMetrics::Get().RecordPlatformLag(
+      elapsed > interval ? elapsed - interval : 0);
+  g_last_probe = std::chrono::steady_clock::now();
+}
+
+void CALLBACK DumpTimerProc(HWND, UINT, UINT_PTR, DWORD) {
+  OutputDebugStringA(ChannelMetrics::Get().Summary().c_str());
+}
+
+void SetEnabled(bool enabled) {
+  ChannelMetrics::Get().SetEnabled(enabled);
+  if (enabled && g_lag_probe_timer == 0) {
+    g_last_probe = std::chrono::steady_clock::now();
+    g_lag_probe_timer =
+        SetTimer(nullptr, 0, kLagProbeIntervalMs, LagProbeTimerProc);
+    g_dump_timer = SetTimer(nullptr, 0, kDumpIntervalMs, DumpTimerProc);
+  } else if (!enabled && g_lag_probe_timer != 0) {
+    KillTimer(nullptr, g_lag_probe_timer);
+    KillTimer(nullptr, g_dump_timer);
+    g_lag_probe_timer = 0;
+    g_dump_timer = 0;
+  }
+}
+
+}  // namespace
+
+flutter::BinaryMessenger* InstrumentedMessengerFor(
+    flutter::BinaryMessenger* messenger) {
+  static auto* decorators =
+      new std::map<flutter::BinaryMessenger*,
+                   std::unique_ptr<InstrumentedMessenger>>();
+  std::unique_ptr<InstrumentedMessenger>& decorator = (*decorators)[messenger];
+  if (!decorator) {
+    decorator = std::make_unique<InstrumentedMessenger>(messenger);
+  }
+  return decorator.get();
+}
+
+std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>
+CreateDiagnosticsChannel(flutter::BinaryMessenger* messenger) {
+  auto channel =
+      std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+          messenger, "com.silverstone/diagnostics",
+          &flutter::StandardMethodCodec::GetInstance());
+
+  channel->SetMethodCallHandler(
+      [](const flutter::MethodCall<flutter::EncodableValue>& call,
+         std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>>
+             result) {
+        if (call.method_name() == "setEnabled") {
+          const auto* enabled = std::get_if<bool>(call.arguments());
+          if (enabled) {
+            SetEnabled(*enabled);
+            result->Success();
+            return;
+          }
+          result->Error("INVALID_ARGS", "Expected boolean argument");
+        } else if (call.method_name() == "getChannelMetrics") {
+          result->Success(
+              flutter::EncodableValue(ChannelMetrics::Get().ToJson()));
+        } else if (call.method_name() == "reset") {
+          ChannelMetrics::Get().Reset();
+          result->Success();
+        } else {
+          result->NotImplemented();
+        }
+      });
+
+  char value[8] = {};
+  if (GetEnvironmentVariableA("SS_CHANNEL_METRICS", value, sizeof(value)) >
+          0 &&
+      std::string(value) == "1") {
+    SetEnabled(true);
+  }
+  return channel;
+}
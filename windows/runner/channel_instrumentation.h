@@ -0,0 +1,29 @@
+#ifndef RUNNER_CHANNEL_INSTRUMENTATION_H_
+#define RUNNER_CHANNEL_INSTRUMENTATION_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/method_channel.h>
+
+#include <memory>
+#include <string>
+
+// Windows side of the platform-channel metrics in
+// linux/native/diagnostics/channel_metrics.h.
+//
+// Handlers registered through the messenger returned here are counted and
+// timed while metrics are enabled; otherwise each message costs one extra
+// branch. Plugins that register through their own registrar (window_manager,
+// screen_capturer) are not visible to the Windows embedding API and are
+// only covered on Linux.
+
+// Returns a decorator of |messenger| that instruments handlers. The
+// decorator lives for the rest of the process.
+flutter::BinaryMessenger* InstrumentedMessengerFor(
+    flutter::BinaryMessenger* messenger);
+
+// Registers "com.silverstone/diagnostics" (setEnabled, getChannelMetrics,
+// reset). Metrics start enabled when SS_CHANNEL_METRICS=1 is set.
+std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>
+CreateDiagnosticsChannel(flutter::BinaryMessenger* messenger);
+
+#endif  // RUNNER_CHANNEL_INSTRUMENTATION_H_
@@ -0,0 +1,34 @@
+#ifndef RUNNER_FAST_CHANNEL_H_
+#define RUNNER_FAST_CHANNEL_H_
+
+#include <flutter/binary_messenger.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "channel_instrumentation.h"
+
+// Serves a binary fast-path channel (linux/native/codec/fast_codec.h) with
+// a dispatcher generated from codec/fast_messages.schema, e.g.
+//
+//   SetFastChannelHandler(messenger, fast_messages::click_through::kChannel,
+//                         handler, &fast_messages::click_through::Dispatch);
+//
+// Calls go through the instrumented messenger, so they show up in channel
+// metrics next to the StandardMethodCodec channels. |handler| must outlive
+// the engine.
+template <typename Handler>
+void SetFastChannelHandler(
+    flutter::BinaryMessenger* messenger,
+    const char* channel,
+    Handler* handler,
+    std::vector<uint8_t> (*dispatch)(Handler*, const uint8_t*, size_t)) {
+  InstrumentedMessengerFor(messenger)->SetMessageHandler(
+      channel, [handler, dispatch](const uint8_t* message, size_t size,
+                                   flutter::BinaryReply reply) {
+        std::vector<uint8_t> response = dispatch(handler, message, size);
+        reply(response.empty() ? nullptr : response.data(), response.size());
+      });
+}
+
+#endif  // RUNNER_FAST_CHANNEL_H_
@@ -5,12 +5,52 @@
 
 #include "flutter/generated_plugin_registrant.h"
 #include "audio_recorder_plugin.h"
+#include "channel_instrumentation.h"
+#include "fast_channel.h"
+
+namespace {
+
+// com.silverstone/fast/click_through; same calls as
+// com.worktracker/click_through.
+class ClickThroughFastHandler : public fast_messages::click_through::Handler {
+ public:
+  explicit ClickThroughFastHandler(FlutterWindow* window) : window_(window) {}
+
+  bool SetClickThroughEnabled(
+      const fast_messages::click_through::SetClickThroughEnabledArgs& args,
+      fast_messages::click_through::SetClickThroughEnabledResult* result,
+      FastError* error) override {
+    window_->SetClickThroughEnabled(args.enabled);
+    return true;
+  }
+
+  bool RestoreNormalWindowStyle(
+      const fast_messages::click_through::RestoreNormalWindowStyleArgs& args,
+      fast_messages::click_through::RestoreNormalWindowStyleResult* result,
+      FastError* error) override {
+    window_->RestoreNormalWindowStyle();
+    return true;
+  }
+
+  bool SetFrameless(
+      const fast_messages::click_through::SetFramelessArgs& args,
+      fast_messages::click_through::SetFramelessResult* result,
+      FastError* error) override {
+    window_->SetFrameless(args.frameless);
+    return true;
+  }
+
+ private:
+  FlutterWindow* window_;
+};
+
+}  // namespace
 
 // Static pointer for method channel callback
 static FlutterWindow* g_flutter_window = nullptr;
 
 FlutterWindow::FlutterWindow(const flutter::DartProject& project)
-    : project_(project) {
+    : project_(project), click_through_(this) {
   g_flutter_window = this;
 }
 
@@ -19,52 +59,68 @@ FlutterWindow::~FlutterWindow() {
 }
 
 void FlutterWindow::SetClickThroughEnabled(bool enabled) {
-  HWND hwnd = GetHandle();
-  if (!hwnd) return;
+  if (!GetHandle()) return;
+  click_through_.SetEnabled(enabled);
+}
 
-  if (enabled) {
-    // Set flag FIRST before starting timer
-    click_through_enabled_ = true;
+void CALLBACK FlutterWindow::MousePollTimerProc(HWND hwnd, UINT uMsg, UINT_PTR idEvent, DWORD dwTime) {
+  if (g_flutter_window) {
+    g_flutter_window->click_through_.Poll();
+  }
+}
 
-    // Reset state tracking
-    is_transparent_ = false;
+bool FlutterWindow::GetCursorPosition(ScreenPoint* point) {
+  POINT pt;
+  if (!GetCursorPos(&pt)) return false;
+  *point = {pt.x, pt.y};
+  return true;
+}
 
-    // Start polling mouse position to toggle transparency based on hover
-    // Only start timer if click-through is still enabled (prevent race conditions)
-    if (mouse_poll_timer_ == 0 && click_through_enabled_) {
-      mouse_poll_timer_ = SetTimer(hwnd, 1, 30, MousePollTimerProc);
-    }
+bool FlutterWindow::GetWindowRect(ScreenRect* rect) {
+  RECT window_rect;
+  if (!::GetWindowRect(GetHandle(), &window_rect)) return false;
+  *rect = {window_rect.left, window_rect.top, window_rect.right,
+           window_rect.bottom};
+  return true;
+}
 
-    // Immediately set transparent state for initial click-through
-    // This ensures clicks pass through immediately on mode switch
-    LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-    SetWindowLongPtr(hwnd, GWL_EXSTYLE, exStyle | WS_EX_LAYERED | WS_EX_TRANSPARENT);
-    is_transparent_ = true;
-  } else {
-    // Set flag to FALSE FIRST to prevent any timer callbacks from running
-    click_through_enabled_ = false;
+bool FlutterWindow::GetClientRect(ScreenRect* rect) {
+  HWND hwnd = GetHandle();
+  RECT client_rect;
+  if (!::GetClientRect(hwnd, &client_rect)) return false;
+  POINT origin = {0, 0};
+  ClientToScreen(hwnd, &origin);
+  *rect = {origin.x, origin.y, origin.x + client_rect.right,
+           origin.y + client_rect.bottom};
+  return true;
+}
 
-    // Stop polling - any pending timer callbacks will be blocked by the flag above
-    if (mouse_poll_timer_ != 0) {
-      KillTimer(hwnd, mouse_poll_timer_);
-      mouse_poll_timer_ = 0;
-    }
+void FlutterWindow::SetTransparent(bool transparent) {
+  HWND hwnd = GetHandle();
+  LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE) | WS_EX_LAYERED;
+  if (transparent) {
+    exStyle |= WS_EX_TRANSPARENT;
+  } else {
+    exStyle &= ~WS_EX_TRANSPARENT;
+  }
+  SetWindowLongPtr(hwnd, GWL_EXSTYLE, exStyle);
+}
 
-    // ALWAYS remove WS_EX_TRANSPARENT when disabling (don't rely on cached state)
-    // This prevents state desync after multiple mode switches
-    LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-    SetWindowLongPtr(hwnd, GWL_EXSTYLE, (exStyle | WS_EX_LAYERED) & ~WS_EX_TRANSPARENT);
-    is_transparent_ = false;
+void FlutterWindow::RefreshFrame() {
+  SetWindowPos(GetHandle(), nullptr, 0, 0, 0, 0,
+               SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_FRAMECHANGED);
+}
 
-    // Force window update to ensure the style change takes effect immediately
-    SetWindowPos(hwnd, nullptr, 0, 0, 0, 0,
-                 SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_FRAMECHANGED);
+void FlutterWindow::StartPolling(int interval_ms) {
+  if (mouse_poll_timer_ == 0) {
+    mouse_poll_timer_ = SetTimer(GetHandle(), 1, interval_ms, MousePollTimerProc);
   }
 }
 
-void CALLBACK FlutterWindow::MousePollTimerProc(HWND hwnd, UINT uMsg, UINT_PTR idEvent, DWORD dwTime) {
-  if (g_flutter_window && g_flutter_window->click_through_enabled_) {
-    g_flutter_window->UpdateTransparencyForMousePosition();
+void FlutterWindow::StopPolling() {
+  if (mouse_poll_timer_ != 0) {
+    KillTimer(GetHandle(), mouse_poll_timer_);
+    mouse_poll_timer_ = 0;
   }
 }
 
@@ -112,58 +168,9 @@ void FlutterWindow::SetFrameless(bool frameless) {
       SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_FRAMECHANGED);
 }
 
-void FlutterWindow::UpdateTransparencyForMousePosition() {
-  HWND hwnd = GetHandle();
-  if (!hwnd || !click_through_enabled_) return;
-
-  // Get mouse position in screen coordinates
-  POINT pt;
-  GetCursorPos(&pt);
-
-  // Get window rect
-  RECT windowRect;
-  GetWindowRect(hwnd, &windowRect);
-
-  // Check if mouse is within window bounds
-  bool mouseInWindow = (pt.x >= windowRect.left && pt.x < windowRect.right &&
-                        pt.y >= windowRect.top && pt.y < windowRect.bottom);
-
-  if (mouseInWindow) {
-    // Convert to client coordinates
-    POINT clientPt = pt;
-    ScreenToClient(hwnd, &clientPt);
-
-    // Get window width
-    RECT clientRect;
-    GetClientRect(hwnd, &clientRect);
-    int windowWidth = clientRect.right - clientRect.left;
-
-    // Visible width when collapsed (85px from right edge)
-    const int visibleWidth = 85;
-    int clickableLeft = windowWidth - visibleWidth;
-
-    // If mouse is in visible area, make window clickable
-    if (clientPt.x >= clickableLeft) {
-      if (is_transparent_) {
-        LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-        SetWindowLongPtr(hwnd, GWL_EXSTYLE, (exStyle | WS_EX_LAYERED) & ~WS_EX_TRANSPARENT);
-        is_transparent_ = false;
-      }
-      return;
-    }
-  }
-
-  // Mouse not in visible area - make transparent
-  if (!is_transparent_) {
-    LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-    SetWindowLongPtr(hwnd, GWL_EXSTYLE, exStyle | WS_EX_LAYERED | WS_EX_TRANSPARENT);
-    is_transparent_ = true;
-  }
-}
-
 void FlutterWindow::SetupMethodChannel() {
   auto channel = std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
-      flutter_controller_->engine()->messenger(),
+      InstrumentedMessengerFor(flutter_controller_->engine()->messenger()),
       "com.worktracker/click_through",
       &flutter::StandardMethodCodec::GetInstance());
 
@@ -193,6 +200,12 @@ void FlutterWindow::SetupMethodChannel() {
           result->NotImplemented();
         }
       });
+
+  fast_click_through_ = std::make_unique<ClickThroughFastHandler>(this);
+  SetFastChannelHandler(flutter_controller_->engine()->messenger(),
+                        fast_messages::click_through::kChannel,
+                        fast_click_through_.get(),
+                        &fast_messages::click_through::Dispatch);
 }
 
 bool FlutterWindow::OnCreate() {
@@ -221,6 +234,10 @@ bool FlutterWindow::OnCreate() {
   // Setup method channel for click-through control
   SetupMethodChannel();
 
+  // Channel call metrics (com.silverstone/diagnostics)
+  diagnostics_channel_ =
+      CreateDiagnosticsChannel(flutter_controller_->engine()->messenger());
+
   flutter_controller_->engine()->SetNextFrameCallback([&]() {
     this->Show();
   });
@@ -235,10 +252,7 @@ bool FlutterWindow::OnCreate() {
 
 void FlutterWindow::OnDestroy() {
   // Clean up timer
-  if (mouse_poll_timer_ != 0) {
-    KillTimer(GetHandle(), mouse_poll_timer_);
-    mouse_poll_timer_ = 0;
-  }
+  StopPolling();
 
   if (flutter_controller_) {
     flutter_controller_ = nullptr;
@@ -8,10 +8,12 @@
 
 #include <memory>
 
+#include "codec/fast_messages.g.h"
+#include "runner/click_through.h"
 #include "win32_window.h"
 
 // A window that does nothing but host a Flutter view.
-class FlutterWindow : public Win32Window {
+class FlutterWindow : public Win32Window, private ClickThroughBackend {
  public:
   // Creates a new FlutterWindow hosting a Flutter view running |project|.
   explicit FlutterWindow(const flutter::DartProject& project);
@@ -40,20 +42,31 @@ class FlutterWindow : public Win32Window {
   // The Flutter instance hosted by this window.
   std::unique_ptr<flutter::FlutterViewController> flutter_controller_;
 
-  // Click-through state
-  bool click_through_enabled_ = false;
+  // Click-through logic (linux/native/runner), with this window as its
+  // backend
+  ClickThroughController click_through_;
 
   // Timer for mouse position polling
   UINT_PTR mouse_poll_timer_ = 0;
 
-  // Track if currently transparent
-  bool is_transparent_ = false;
+  // Binary fast path for the click-through calls
+  std::unique_ptr<fast_messages::click_through::Handler> fast_click_through_;
+
+  // Serves channel metrics to Dart
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>
+      diagnostics_channel_;
 
   // Setup method channel
   void SetupMethodChannel();
 
-  // Update transparency based on mouse position
-  void UpdateTransparencyForMousePosition();
+  // ClickThroughBackend:
+  bool GetCursorPosition(ScreenPoint* point) override;
+  bool GetWindowRect(ScreenRect* rect) override;
+  bool GetClientRect(ScreenRect* rect) override;
+  void SetTransparent(bool transparent) override;
+  void RefreshFrame() override;
+  void StartPolling(int interval_ms) override;
+  void StopPolling() override;
 
   // Static timer callback
   static void CALLBACK MousePollTimerProc(HWND hwnd, UINT uMsg, UINT_PTR idEvent, DWORD dwTime);